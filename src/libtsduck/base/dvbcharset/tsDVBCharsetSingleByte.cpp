@@ -40,6 +40,8 @@ TSDUCK_SOURCE;
 ts::DVBCharsetSingleByte::DVBCharsetSingleByte(const UString& name, uint32_t tableCode, std::initializer_list<uint16_t> init, std::initializer_list<uint8_t> revDiac) :
     DVBCharset(name, tableCode),
     _upperCodePoints(init),
+    _fullCodePoints(),
+    _specialBytes(),
     _bytesMap(),
     _reversedDiacritical()
 {
@@ -70,6 +72,25 @@ ts::DVBCharsetSingleByte::DVBCharsetSingleByte(const UString& name, uint32_t tab
             _reversedDiacritical.set(*it - 0xA0);
         }
     }
+
+    // Build the direct decoding table for all byte values and mark the bytes
+    // which need special handling in decode().
+    for (size_t b = 0; b < 256; b++) {
+        uint16_t cp = 0;
+        if (b >= 0x20 && b <= 0x7E) {
+            cp = uint16_t(b);  // ASCII range = identity
+        }
+        else if (b >= 0xA0) {
+            cp = _upperCodePoints[b - 0xA0];
+        }
+        else if (b == DVB_SINGLE_BYTE_CRLF) {
+            cp = LINE_FEED;
+        }
+        _fullCodePoints[b] = cp;
+        if (cp == 0 || IsCombiningDiacritical(UChar(cp)) || (b >= 0xA0 && _reversedDiacritical.test(b - 0xA0))) {
+            _specialBytes.set(b);
+        }
+    }
 }
 
 
@@ -80,25 +101,37 @@ ts::DVBCharsetSingleByte::DVBCharsetSingleByte(const UString& name, uint32_t tab
 bool ts::DVBCharsetSingleByte::decode(UString& str, const uint8_t* dvb, size_t dvbSize) const
 {
     str.clear();
-    str.reserve(dvbSize);
+    if (dvb == nullptr) {
+        return true;
+    }
+
+    // Fast path: as long as no byte needs special handling (untranslatable
+    // value, diacritical mark, reversal), the whole string is a plain
+    // per-byte table lookup into a buffer allocated once.
+    str.resize(dvbSize);
+    size_t done = 0;
+    while (done < dvbSize && !_specialBytes.test(dvb[done])) {
+        str[done] = UChar(_fullCodePoints[dvb[done]]);
+        done++;
+    }
+    if (done == dvbSize) {
+        return true;
+    }
+
+    // Slow path: resume the generic per-character processing on the rest.
+    // No special byte was seen so far, so there is no pending reversal.
+    str.resize(done);
+    dvb += done;
+    dvbSize -= done;
     bool status = true;
     bool reverseNext = false;  // after decoding next character, it shall be swapped with previous one.
     bool hasDiacritical = false;
 
-    for (; dvb != nullptr && dvbSize > 0; --dvbSize) {
+    for (; dvbSize > 0; --dvbSize) {
         // Get next byte
         const uint8_t b = *dvb++;
         // Convert it to a code point
-        uint16_t cp = 0;
-        if (b >= 0x20 && b <= 0x7E) {
-            cp = b; // ASCII range = identity
-        }
-        else if (b >= 0xA0) {
-            cp = _upperCodePoints[b - 0xA0];
-        }
-        else if (b == DVB_SINGLE_BYTE_CRLF) {
-            cp = LINE_FEED;
-        }
+        const uint16_t cp = _fullCodePoints[b];
         // Add in result if no error.
         if (cp == 0) {
             // Untranslatable character.
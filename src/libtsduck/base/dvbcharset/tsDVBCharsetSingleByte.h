@@ -89,6 +89,15 @@ namespace ts {
         // List of code points for byte values 0xA0-0xFF. Always contain 96 values.
         const std::vector<uint16_t> _upperCodePoints;
 
+        // Direct decoding table for all 256 byte values, zero means unused.
+        // Built in the constructor from the 96-entry table and the fixed ranges.
+        uint16_t _fullCodePoints[256];
+
+        // Bitmap of byte values which need special handling when decoding:
+        // untranslatable bytes, diacritical marks and reversed diacriticals.
+        // Strings without such bytes, the vast majority, decode on a fast path.
+        std::bitset<256> _specialBytes;
+
         // Reverse mapping for complete character set (key = code point, value = byte rep).
         std::map<UChar, uint8_t> _bytesMap;
 
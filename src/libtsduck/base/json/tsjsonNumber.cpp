@@ -47,7 +47,23 @@ bool ts::json::Number::isNumber() const
 
 void ts::json::Number::print(TextFormatter& output) const
 {
-    output << UString::Decimal(_value, 0, true, UString());
+    // Directly format the integer value as ASCII characters. Serializing a
+    // large report prints many numbers and the generic UString formatting,
+    // with its UTF-16 intermediate string, is measurably slower.
+    char buf[24];
+    char* p = buf + sizeof(buf);
+    const bool neg = _value < 0;
+    // Loop on the absolute value. Beware of the most negative value which
+    // has no positive counterpart in int64_t.
+    uint64_t v = neg ? ~uint64_t(_value) + 1 : uint64_t(_value);
+    do {
+        *--p = char('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    if (neg) {
+        *--p = '-';
+    }
+    output.write(p, buf + sizeof(buf) - p);
 }
 
 bool ts::json::Number::toBoolean(bool defaultValue) const
@@ -47,7 +47,36 @@ bool ts::json::String::isString() const
 
 void ts::json::String::print(TextFormatter& output) const
 {
-    output << '"' << _value.toJSON() << '"';
+    // Check if some character needs an escape sequence. Most strings do not
+    // and can be serialized directly as ASCII, without building an escaped
+    // copy and without the UTF-16 to UTF-8 conversion of the generic path.
+    bool clean = true;
+    for (UString::const_iterator it = _value.begin(); clean && it != _value.end(); ++it) {
+        clean = *it >= 0x0020 && *it <= 0x007E && *it != u'"' && *it != u'\\';
+    }
+
+    if (clean) {
+        // Stream the quoted string through a small buffer of ASCII characters.
+        char buf[128];
+        size_t n = 0;
+        buf[n++] = '"';
+        for (UString::const_iterator it = _value.begin(); it != _value.end(); ++it) {
+            if (n >= sizeof(buf)) {
+                output.write(buf, n);
+                n = 0;
+            }
+            buf[n++] = char(*it);
+        }
+        if (n >= sizeof(buf)) {
+            output.write(buf, n);
+            n = 0;
+        }
+        buf[n++] = '"';
+        output.write(buf, n);
+    }
+    else {
+        output << '"' << _value.toJSON() << '"';
+    }
 }
 
 int64_t ts::json::String::toInteger(int64_t defaultValue) const
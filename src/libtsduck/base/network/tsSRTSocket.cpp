@@ -30,6 +30,10 @@
 #include "tsSRTSocket.h"
 #include "tsArgs.h"
 #include "tsFatal.h"
+#include "tsThread.h"
+#include "tsGuardCondition.h"
+#include "tsMemory.h"
+#include "tsTime.h"
 TSDUCK_SOURCE;
 
 
@@ -228,6 +232,31 @@ void ts::SRTSocket::defineArgs(ts::Args& args) const
 
     args.option(u"udp-sndbuf", 0, ts::Args::POSITIVE);
     args.help(u"udp-sndbuf", u"UDP Socket Send Buffer Size.");
+
+    args.option(u"statistics-interval", 0, ts::Args::POSITIVE);
+    args.help(u"statistics-interval", u"milliseconds",
+              u"Activate an internal monitoring thread which samples the SRT connection "
+              u"statistics (RTT, packet loss, retransmissions, estimated bandwidth) at the "
+              u"specified interval in milliseconds. The thread also detects broken "
+              u"connections between data transfers. The sampling is performed outside "
+              u"the packet transmission path and the latest sample is available to the "
+              u"application without lock. By default, no monitoring thread is started.");
+}
+
+
+//----------------------------------------------------------------------------
+// Constructor of the statistics structure.
+//----------------------------------------------------------------------------
+
+ts::SRTSocket::Statistics::Statistics() :
+    timestamp(-1),
+    rtt(0),
+    lost_packets(0),
+    retrans_packets(0),
+    dropped_packets(0),
+    bandwidth_mbps(0.0),
+    broken(false)
+{
 }
 
 
@@ -250,6 +279,7 @@ bool ts::SRTSocket::receive(void* data, size_t max_size, size_t& ret_size, ts::R
 bool ts::SRTSocket::getSockOpt(int optName, const char* optNameStr, void* optval, int& optlen, ts::Report& report) const NOSRT_ERROR
 int  ts::SRTSocket::getSocket() const { return -1; }
 bool ts::SRTSocket::getMessageApi() const { return false; }
+bool ts::SRTSocket::getStatistics(Statistics& stats) const { stats = Statistics(); return false; }
 ts::UString ts::SRTSocket::GetLibraryVersion() { return NOSRT_ERROR_MSG; }
 
 #else
@@ -288,7 +318,7 @@ ts::UString ts::SRTSocket::GetLibraryVersion()
 // Internal representation ("guts")
 //----------------------------------------------------------------------------
 
-class ts::SRTSocket::Guts
+class ts::SRTSocket::Guts: private Thread
 {
      TS_NOCOPY(Guts);
 public:
@@ -305,11 +335,30 @@ public:
      int srtConnect(const SocketAddress& addr, Report& report);
      int srtBind(const SocketAddress& addr, Report& report);
 
+     // Start / stop the statistics monitoring thread.
+     void startMonitor(Report& report);
+     void stopMonitor();
+
      // Socket working data.
      SocketAddress default_address;
      SRTSocketMode mode;
      int           sock;
 
+     // Statistics monitoring thread (option --statistics-interval).
+     MilliSecond      stats_interval;   // Sampling interval, 0 means no monitoring.
+     bool             mon_started;      // The monitoring thread is running.
+     volatile bool    mon_terminate;    // Request the monitoring thread to terminate.
+     Mutex            mon_mutex;        // Protect the termination condition.
+     Condition        mon_wakeup;       // Signalled to wake up the monitoring thread.
+     Report*          mon_report;       // Where the monitoring thread logs samples.
+     Statistics       snapshots[2];     // Double-buffered statistics snapshots.
+     std::atomic<int> snap_index;       // Index of the latest complete snapshot.
+
+private:
+     // Implementation of Thread: the statistics sampling loop.
+     virtual void main() override;
+
+public:
      // Socket options.
      SRT_TRANSTYPE transtype;
      std::string   packet_filter;
@@ -354,6 +403,14 @@ ts::SRTSocket::Guts::Guts() :
     default_address(),
     mode(LISTENER),
     sock(-1),  // do not use TS_SOCKET_T_INVALID, an SRT socket is not a socket, it is always an int
+    stats_interval(0),
+    mon_started(false),
+    mon_terminate(false),
+    mon_mutex(),
+    mon_wakeup(),
+    mon_report(nullptr),
+    snapshots(),
+    snap_index(0),
     transtype(SRTT_INVALID),
     packet_filter(),
     passphrase(),
@@ -432,6 +489,98 @@ bool ts::SRTSocket::getMessageApi() const
 }
 
 
+//----------------------------------------------------------------------------
+// Get the latest connection health statistics sample.
+//----------------------------------------------------------------------------
+
+bool ts::SRTSocket::getStatistics(Statistics& stats) const
+{
+    // Lock-free read of the latest complete snapshot. The monitoring thread
+    // always writes into the other buffer before publishing the index.
+    stats = _guts->snapshots[_guts->snap_index.load(std::memory_order_acquire)];
+    return stats.timestamp >= 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Statistics monitoring thread.
+//----------------------------------------------------------------------------
+
+void ts::SRTSocket::Guts::startMonitor(Report& report)
+{
+    if (!mon_started) {
+        mon_report = &report;
+        mon_terminate = false;
+        snapshots[0] = snapshots[1] = Statistics();
+        snap_index.store(0);
+        mon_started = Thread::start();
+    }
+}
+
+void ts::SRTSocket::Guts::stopMonitor()
+{
+    if (mon_started) {
+        {
+            GuardCondition lock(mon_mutex, mon_wakeup);
+            mon_terminate = true;
+            lock.signal();
+        }
+        waitForTermination();
+        mon_started = false;
+    }
+}
+
+void ts::SRTSocket::Guts::main()
+{
+    for (;;) {
+
+        // Wait until next sampling time or termination request.
+        {
+            GuardCondition lock(mon_mutex, mon_wakeup);
+            if (!mon_terminate) {
+                lock.waitCondition(stats_interval);
+            }
+            if (mon_terminate) {
+                break;
+            }
+        }
+
+        // Collect one sample from libsrt, outside the packet path.
+        Statistics st;
+        const SRT_SOCKSTATUS state = srt_getsockstate(sock);
+        st.broken = state == SRTS_BROKEN || state == SRTS_CLOSING || state == SRTS_CLOSED || state == SRTS_NONEXIST;
+        if (!st.broken) {
+            SRT_TRACEBSTATS perf;
+            TS_ZERO(perf);
+            if (srt_bstats(sock, &perf, 0) == 0) {
+                st.rtt = MicroSecond(perf.msRTT * 1000.0);
+                st.lost_packets = uint64_t(perf.pktSndLossTotal) + uint64_t(perf.pktRcvLossTotal);
+                st.retrans_packets = uint64_t(perf.pktRetransTotal);
+                st.dropped_packets = uint64_t(perf.pktSndDropTotal) + uint64_t(perf.pktRcvDropTotal);
+                st.bandwidth_mbps = perf.mbpsBandwidth;
+            }
+        }
+        st.timestamp = MicroSecond(Time::CurrentUTC() - Time::UnixEpoch) * MicroSecPerMilliSec;
+
+        // Publish the sample: write the inactive buffer, then switch the index.
+        const int next = 1 - snap_index.load(std::memory_order_relaxed);
+        snapshots[next] = st;
+        snap_index.store(next, std::memory_order_release);
+
+        // Log the sample, the report of tsp plugins only displays it in debug mode.
+        if (mon_report != nullptr) {
+            if (st.broken) {
+                mon_report->debug(u"SRT connection broken");
+            }
+            else {
+                mon_report->debug(u"SRT: RTT %'d us, lost %'d, retransmitted %'d, dropped %'d, bandwidth %f Mb/s",
+                                  {st.rtt, st.lost_packets, st.retrans_packets, st.dropped_packets, st.bandwidth_mbps});
+            }
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Set a default destination address and port for outgoing messages.
 // Both address and port are mandatory in socket address.
@@ -520,6 +669,11 @@ bool ts::SRTSocket::open(SRTSocketMode mode,
         goto fail;
     }
 
+    // Start the statistics monitoring thread when a sampling interval was specified.
+    if (_guts->stats_interval > 0) {
+        _guts->startMonitor(report);
+    }
+
     return true;
 
 fail:
@@ -534,6 +688,9 @@ fail:
 
 bool ts::SRTSocket::close(ts::Report& report)
 {
+    // Terminate the monitoring thread first, it samples the socket.
+    _guts->stopMonitor();
+
     if (_guts->sock >= 0) {
         srt_close(_guts->sock);
         _guts->sock = -1;
@@ -585,6 +742,7 @@ bool ts::SRTSocket::loadArgs(ts::DuckContext& duck, ts::Args& args)
     _guts->tlpktdrop = args.present(u"tlpktdrop");
     _guts->udp_rcvbuf = args.intValue<int>(u"udp-rcvbuf", -1);
     _guts->udp_sndbuf = args.intValue<int>(u"udp-sndbuf", -1);
+    _guts->stats_interval = args.intValue<MilliSecond>(u"statistics-interval", 0);
 
     return true;
 }
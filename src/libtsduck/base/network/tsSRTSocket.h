@@ -62,6 +62,29 @@ namespace ts {
     {
         TS_NOCOPY(SRTSocket);
     public:
+        //!
+        //! Connection health statistics.
+        //! When a sampling interval is specified (option --statistics-interval),
+        //! an internal monitoring thread periodically collects the libsrt
+        //! statistics into a snapshot. The latest snapshot is retrieved by the
+        //! application using getStatistics(), without lock and without touching
+        //! the packet path.
+        //!
+        struct TSDUCKDLL Statistics
+        {
+            MicroSecond timestamp;        //!< Sample time in micro-seconds since Unix epoch, -1 when no sample was collected yet.
+            MicroSecond rtt;              //!< Round-trip time in micro-seconds.
+            uint64_t    lost_packets;     //!< Total number of lost packets (sent and received).
+            uint64_t    retrans_packets;  //!< Total number of retransmitted packets.
+            uint64_t    dropped_packets;  //!< Total number of dropped packets (sent and received).
+            double      bandwidth_mbps;   //!< Estimated link bandwidth in megabits per second.
+            bool        broken;           //!< The connection is broken or closed.
+            //!
+            //! Constructor.
+            //!
+            Statistics();
+        };
+
         //!
         //! Constructor.
         //!
@@ -139,6 +162,17 @@ namespace ts {
         //!
         bool getMessageApi() const;
 
+        //!
+        //! Get the latest connection health statistics sample.
+        //! The snapshot is read without lock, the monitoring thread never
+        //! blocks the caller. The monitoring thread is started by open()
+        //! when a sampling interval was specified on the command line.
+        //! @param [out] stats Latest statistics sample.
+        //! @return True if a sample is available, false when monitoring
+        //! is disabled or no sample was collected yet.
+        //!
+        bool getStatistics(Statistics& stats) const;
+
         //!
         //! Get the version of the SRT library.
         //! @return A string describing the SRT library versions (or the lack of SRT support).
@@ -152,6 +152,80 @@ bool ts::TCPConnection::send(const void* buffer, size_t size, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Send data from several non-contiguous parts in one operation.
+//----------------------------------------------------------------------------
+
+bool ts::TCPConnection::sendParts(const DataPart* parts, size_t part_count, Report& report)
+{
+#if defined(TS_WINDOWS)
+
+    // No writev() equivalent on a plain blocking socket, send the parts sequentially.
+    for (size_t i = 0; i < part_count; ++i) {
+        if (parts[i].size > 0 && !send(parts[i].data, parts[i].size, report)) {
+            return false;
+        }
+    }
+    return true;
+
+#else
+
+    // Send the parts by windows of MAX_IOV entries, all parts of a window
+    // in one single writev() system call.
+    const size_t MAX_IOV = 16;
+    size_t next = 0;
+
+    while (next < part_count) {
+
+        // Build the next window of parts, skipping empty ones.
+        ::iovec iov[MAX_IOV];
+        size_t iov_count = 0;
+        size_t remain = 0;
+        while (next < part_count && iov_count < MAX_IOV) {
+            if (parts[next].size > 0) {
+                iov[iov_count].iov_base = const_cast<void*>(parts[next].data);
+                iov[iov_count].iov_len = parts[next].size;
+                remain += parts[next].size;
+                iov_count++;
+            }
+            next++;
+        }
+
+        // Send the complete window, resuming after partial writes.
+        size_t iov_next = 0;
+        while (remain > 0) {
+            const ::ssize_t gone = ::writev(getSocket(), iov + iov_next, int(iov_count - iov_next));
+            if (gone > 0) {
+                assert(size_t(gone) <= remain);
+                remain -= size_t(gone);
+                // Skip the parts which were completely sent and adjust the
+                // first partially sent one.
+                size_t done = size_t(gone);
+                while (done > 0 && done >= iov[iov_next].iov_len) {
+                    done -= iov[iov_next].iov_len;
+                    iov_next++;
+                }
+                if (done > 0) {
+                    iov[iov_next].iov_base = reinterpret_cast<char*>(iov[iov_next].iov_base) + done;
+                    iov[iov_next].iov_len -= done;
+                }
+            }
+            else if (errno == EINTR) {
+                // Ignore signal, retry
+                report.debug(u"writev() interrupted by signal, retrying");
+            }
+            else {
+                report.error(u"error sending data to socket: " + SocketErrorCodeMessage());
+                return false;
+            }
+        }
+    }
+    return true;
+
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Receive data.
 // If abort interface is non-zero, invoke it when I/O is interrupted
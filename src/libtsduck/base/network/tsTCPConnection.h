@@ -160,6 +160,40 @@ namespace ts {
         //!
         bool send(const void* data, size_t size, Report& report = CERR);
 
+        //!
+        //! Description of one part of data in a scatter-gather send operation.
+        //! @see sendParts()
+        //!
+        struct TSDUCKDLL DataPart
+        {
+            const void* data;  //!< Address of this part of the data to send.
+            size_t      size;  //!< Size in bytes of this part.
+
+            //!
+            //! Constructor.
+            //! @param [in] dataAddress Address of this part of the data to send.
+            //! @param [in] dataSize Size in bytes of this part.
+            //!
+            DataPart(const void* dataAddress = nullptr, size_t dataSize = 0) :
+                data(dataAddress), size(dataSize) {}
+        };
+
+        //!
+        //! Send data from several non-contiguous parts in one operation.
+        //!
+        //! On UNIX systems, all parts are passed to the kernel in one single
+        //! writev() system call, so that small pieces (headers, payload,
+        //! trailers) are coalesced into full TCP segments instead of being
+        //! sent in one small packet each. On Windows, the parts are sent
+        //! sequentially.
+        //!
+        //! @param [in] parts Address of an array of descriptions of data parts.
+        //! @param [in] part_count Number of entries in the @a parts array.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool sendParts(const DataPart* parts, size_t part_count, Report& report = CERR);
+
         //!
         //! Receive data.
         //!
@@ -180,6 +180,25 @@ bool ts::TCPSocket::setNoDelay(bool active, Report& report)
 }
 
 
+bool ts::TCPSocket::setCork(bool active, Report& report)
+{
+#if defined(TS_LINUX) || defined(TS_MAC)
+    int cork = int(active); // Actual socket option is an int.
+    report.debug(u"setting socket cork to %'d", {cork});
+#if defined(TS_LINUX)
+    if (::setsockopt(getSocket(), IPPROTO_TCP, TCP_CORK, TS_SOCKOPT_T(&cork), sizeof(cork)) != 0) {
+#else
+    if (::setsockopt(getSocket(), IPPROTO_TCP, TCP_NOPUSH, TS_SOCKOPT_T(&cork), sizeof(cork)) != 0) {
+#endif
+        report.error(u"error setting socket TCP-cork: %s", {SocketErrorCodeMessage()});
+        return false;
+    }
+#endif
+    // No equivalent option on other systems, data are simply sent immediately.
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Bind to a local address and port.
 //----------------------------------------------------------------------------
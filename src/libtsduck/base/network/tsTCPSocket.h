@@ -115,6 +115,20 @@ namespace ts {
         //!
         bool setNoDelay(bool active, Report& report = CERR);
 
+        //!
+        //! Set the "cork" option, coalescing outgoing data.
+        //! @param [in] active If true, outgoing data are retained by the system
+        //! until the option is cleared (or an internal limit is reached), so
+        //! that a burst of small send() operations is coalesced into full
+        //! segments. Clearing the option flushes the retained data. This is
+        //! implemented with TCP_CORK on Linux and TCP_NOPUSH on macOS; on
+        //! systems without an equivalent option, this is a no-operation and
+        //! the data are sent immediately.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool setCork(bool active, Report& report = CERR);
+
         //!
         //! Bind to a local address and port.
         //!
@@ -68,12 +68,15 @@ bool ts::TelnetConnection::send(const UString& str, Report& report)
 
 bool ts::TelnetConnection::sendLine(const std::string& str, Report& report)
 {
-    return send(str, report) && send(EOL, report);
+    // Send the text and the end-of-line sequence in one single operation,
+    // in one single TCP segment when possible.
+    const DataPart parts[] = {DataPart(str.c_str(), str.size()), DataPart(EOL.c_str(), EOL.size())};
+    return sendParts(parts, 2, report);
 }
 
 bool ts::TelnetConnection::sendLine(const UString& str, Report& report)
 {
-    return send(str, report) && send(EOL, report);
+    return sendLine(str.toUTF8(), report);
 }
 
 
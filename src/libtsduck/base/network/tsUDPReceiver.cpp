@@ -31,6 +31,10 @@
 #include "tsArgs.h"
 TSDUCK_SOURCE;
 
+// Number of entries in the duplicate suppression history (option --redundant).
+// Must be a power of two.
+#define MERGE_HISTORY_SIZE 1024
+
 
 //----------------------------------------------------------------------------
 // Constructor.
@@ -51,7 +55,15 @@ ts::UDPReceiver::UDPReceiver(ts::Report& report, bool with_short_options, bool d
     _recv_timeout(-1),
     _use_source(),
     _first_source(),
-    _sources()
+    _sources(),
+    _redundant_addr(),
+    _merge_history(),
+    _reorder_window(0),
+    _reorder_sync(false),
+    _reorder_next(0),
+    _reorder_count(0),
+    _reorder_buffer(),
+    _reorder_slots()
 {
 }
 
@@ -114,6 +126,30 @@ void ts::UDPReceiver::defineArgs(ts::Args& args) const
               u"This timeout applies to each receive operation, individually. "
               u"By default, receive operations wait for data, possibly forever.");
 
+    args.option(u"redundant", 0, Args::STRING);
+    args.help(u"redundant", u"address:port",
+              u"Receive a redundant copy of the same stream from the specified multicast "
+              u"address, in the style of SMPTE 2022-7 seamless protection. The same "
+              u"socket joins both multicast groups and the two feeds are merged on "
+              u"reception: the first received copy of each datagram is delivered and "
+              u"the second one is silently dropped. Duplicates are identified by their "
+              u"RTP sequence number or, for plain UDP streams, by a hash of the "
+              u"datagram content. When one feed fails, the stream seamlessly continues "
+              u"from the other one. The redundant stream must use the same UDP port as "
+              u"the main stream.");
+
+    args.option(u"rtp-reorder", 0, Args::INTEGER, 0, 1, 2, 1024);
+    args.help(u"rtp-reorder", u"count",
+              u"Reorder RTP datagrams which are received out of sequence. The value is "
+              u"the depth of the reordering window, in datagrams. Incoming RTP datagrams "
+              u"are stored in a fixed-size ring buffer which is indexed by their sequence "
+              u"number and they are delivered in sequence order. A datagram which is "
+              u"still missing when the window is exhausted is declared lost, which "
+              u"bounds the latency which is added by the reordering to the specified "
+              u"number of datagrams. Non-RTP datagrams are delivered in arrival order, "
+              u"without reordering. By default, all datagrams are delivered in arrival "
+              u"order.");
+
     args.option(u"source", _with_short_options ? 's' : 0, Args::STRING);
     args.help(u"source", u"address[:port]",
               u"Filter UDP packets based on the specified source address. This option is "
@@ -151,6 +187,7 @@ bool ts::UDPReceiver::loadArgs(DuckContext& duck, Args& args)
     _default_interface = args.present(u"default-interface");
     _use_ssm = args.present(u"ssm");
     _use_first_source = args.present(u"first-source");
+    _reorder_window = args.intValue<size_t>(u"rtp-reorder", 0);
     _recv_bufsize = args.intValue<size_t>(u"buffer-size", 0);
     _recv_timeout = args.intValue<MilliSecond>(u"receive-timeout", _recv_timeout); // preserve previous value
 
@@ -198,6 +235,35 @@ bool ts::UDPReceiver::loadArgs(DuckContext& duck, Args& args)
         return false;
     }
 
+    // Get and resolve the optional redundant stream address.
+    _redundant_addr.clear();
+    if (args.present(u"redundant")) {
+        if (!_redundant_addr.resolve(args.value(u"redundant"), args)) {
+            return false;
+        }
+        if (!_redundant_addr.hasAddress() || !_redundant_addr.isMulticast()) {
+            args.error(u"--redundant address %s is not multicast", {_redundant_addr});
+            return false;
+        }
+        if (!_redundant_addr.hasPort()) {
+            _redundant_addr.setPort(_dest_addr.port());
+        }
+        else if (_redundant_addr.port() != _dest_addr.port()) {
+            // Both feeds are received on the same socket, hence the same port.
+            args.error(u"the --redundant stream must use the same UDP port as the main stream");
+            return false;
+        }
+        if (!_dest_addr.hasAddress()) {
+            args.error(u"--redundant requires a multicast main stream");
+            return false;
+        }
+        if (_use_first_source) {
+            // The two feeds legitimately come from distinct sources.
+            args.error(u"--first-source and --redundant are mutually exclusive");
+            return false;
+        }
+    }
+
     // Get and resolve optional local address.
     if (!args.present(u"local-address")) {
         _local_address.clear();
@@ -286,13 +352,33 @@ bool ts::UDPReceiver::open(ts::Report& report)
     _first_source.clear();
     _sources.clear();
 
+    // Reset the duplicate suppression history of the redundant stream merge.
+    if (_redundant_addr.hasPort()) {
+        _merge_history.assign(MERGE_HISTORY_SIZE, 0xFFFFFFFF);
+    }
+
+    // Allocate the RTP reordering ring, outside the reception path: one slot
+    // per datagram in the window, plus one holding slot for the datagram
+    // being received.
+    _reorder_sync = false;
+    _reorder_count = 0;
+    if (_reorder_window > 0) {
+        _reorder_buffer.resize((_reorder_window + 1) * IP_MAX_PACKET_SIZE);
+        _reorder_slots.assign(_reorder_window + 1, ReorderSlot());
+        for (size_t i = 0; i < _reorder_slots.size(); ++i) {
+            _reorder_slots[i].offset = i * IP_MAX_PACKET_SIZE;
+        }
+    }
+
     // The local socket address to bind is the optional local IP address and the destination port.
     // Except on Linux, macOS and probably most Unix, when listening to a multicast group.
     // In that case, we bind to the multicast group, not the local interface.
     // Note that if _dest_addr has an address, it is a multicast one (checked in load()).
+    // With a redundant stream, two multicast groups are joined on the same
+    // socket and we must bind to the port only, not to one of the groups.
     SocketAddress local_addr(
 #if defined(TS_UNIX)
-        _dest_addr.hasAddress() ? _dest_addr.address() : _local_address,
+        _dest_addr.hasAddress() && !_redundant_addr.hasAddress() ? _dest_addr.address() : _local_address,
 #else
         _local_address,
 #endif
@@ -327,6 +413,19 @@ bool ts::UDPReceiver::open(ts::Report& report)
         }
     }
 
+    // Join the multicast group of the redundant stream on the same socket.
+    if (ok && _redundant_addr.hasAddress()) {
+        if (_default_interface) {
+            ok = addMembershipDefault(_redundant_addr, ssm_source, report);
+        }
+        else if (_local_address.hasAddress()) {
+            ok = addMembership(_redundant_addr, _local_address, ssm_source, report);
+        }
+        else {
+            ok = addMembershipAll(_redundant_addr, ssm_source, report);
+        }
+    }
+
     if (!ok) {
         close(report);
     }
@@ -346,6 +445,11 @@ bool ts::UDPReceiver::receive(void* data,
                               const ts::AbortInterface* abort,
                               ts::Report& report)
 {
+    // With --rtp-reorder, deliver the datagrams in RTP sequence order.
+    if (_reorder_window > 0) {
+        return receiveReordered(data, max_size, ret_size, sender, destination, abort, report);
+    }
+
     // Loop on packet reception until one matching filtering criteria is found.
     for (;;) {
 
@@ -354,75 +458,332 @@ bool ts::UDPReceiver::receive(void* data,
             return false;
         }
 
-        // Debug (level 2) message for each message.
-        if (report.maxSeverity() >= 2) {
-            // Prior report level checking to avoid evaluating parameters when not necessary.
-            report.log(2, u"received UDP packet, source: %s, destination: %s", {sender, destination});
-        }
-
-        // Check the destination address to exclude packets from other streams.
-        // When several multicast streams use the same destination port and several
-        // applications on the same system listen to these distinct streams,
-        // the multicast MAC address management is such that any socket which
-        // is bound to the common port will receive the traffic for all streams.
-        // This is why we need to check the destination address and exclude
-        // packets which are not from the intended stream.
-        //
-        // We accept a packet in any of:
-        // 1) Actual packet destination is unknown. Probably, the system cannot
-        //    report the destination address.
-        // 2) We listen to a multicast address and the actual destination is the same.
-        // 3) If we listen to unicast traffic and the actual destination is unicast.
-        //    In that case, unicast is by definition sent to us.
-
-        if (destination.hasAddress() && ((_dest_addr.hasAddress() && destination != _dest_addr) || (!_dest_addr.hasAddress() && destination.isMulticast()))) {
-            // This is a spurious packet.
-            if (report.maxSeverity() >= Severity::Debug) {
-                // Prior report level checking to avoid evaluating parameters when not necessary.
-                report.debug(u"rejecting packet, destination: %s, expecting: %s", {destination, _dest_addr});
+        // Check if the datagram matches all filtering criteria and is not a
+        // duplicate from the redundant stream.
+        if (checkDatagram(sender, destination, report) &&
+            (!_redundant_addr.hasPort() || !isMergeDuplicate(reinterpret_cast<const uint8_t*>(data), ret_size)))
+        {
+            return true;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a datagram is a duplicate from the redundant stream (--redundant).
+//----------------------------------------------------------------------------
+
+bool ts::UDPReceiver::isMergeDuplicate(const uint8_t* data, size_t size)
+{
+    // Compute the signature of the datagram. The two copies of a datagram
+    // have the same signature, consecutive datagrams of a stream have
+    // distinct ones.
+    uint32_t sig = 0;
+    if (size >= RTP_HEADER_SIZE && (data[0] >> 6) == 2) {
+        // RTP datagram, the sequence number identifies it.
+        sig = GetUInt16(data + 2);
+    }
+    else {
+        // Plain UDP datagram, hash the start of the content (FNV-1a). The
+        // continuity counters in the TS headers make consecutive datagrams
+        // distinct.
+        sig = 0x811C9DC5;
+        const size_t count = std::min<size_t>(size, 64);
+        for (size_t i = 0; i < count; ++i) {
+            sig = (sig ^ data[i]) * 0x01000193;
+        }
+    }
+
+    // Look up the signature in the history. The history is large enough for
+    // an entry to be overwritten many times before the same signature can
+    // legitimately reappear in a continuous stream.
+    const size_t index = sig & (MERGE_HISTORY_SIZE - 1);
+    if (_merge_history[index] == sig) {
+        return true;
+    }
+    _merge_history[index] = sig;
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Receive one datagram in RTP sequence order (option --rtp-reorder).
+//----------------------------------------------------------------------------
+
+bool ts::UDPReceiver::receiveReordered(void* data, size_t max_size, size_t& ret_size, SocketAddress& sender, SocketAddress& destination, const AbortInterface* abort, Report& report)
+{
+    // Datagrams are received into the holding slot, then moved into the ring
+    // slot which is indexed by their RTP sequence number, modulo the window
+    // size. The moves and all sequence comparisons use 16-bit arithmetic
+    // which transparently handles the sequence number wrap-around.
+    ReorderSlot& hold(_reorder_slots[_reorder_window]);
+
+    for (;;) {
+
+        // Deliver the next datagram in sequence order when it is present.
+        if (_reorder_count > 0 && _reorder_slots[_reorder_next % _reorder_window].used) {
+            popReorderSlot(data, max_size, ret_size, sender, destination);
+            return true;
+        }
+
+        // Process a datagram which was previously received in the holding slot.
+        if (hold.used) {
+            if (_reorder_count == 0 && uint16_t(hold.seq - _reorder_next) >= _reorder_window) {
+                // The ring is empty and the datagram is far from the expected
+                // sequence number: the stream restarted, resynchronize on it.
+                report.debug(u"RTP sequence jump, resynchronizing at sequence %d", {hold.seq});
+                _reorder_next = hold.seq;
+            }
+            if (uint16_t(hold.seq - _reorder_next) < _reorder_window) {
+                // The datagram fits in the window, move it into its ring slot.
+                // Only the buffer offsets are swapped, the data are not copied.
+                ReorderSlot& slot(_reorder_slots[hold.seq % _reorder_window]);
+                if (slot.used) {
+                    report.log(2, u"dropping duplicate RTP datagram, sequence %d", {hold.seq});
+                }
+                else {
+                    slot.used = true;
+                    slot.seq = hold.seq;
+                    slot.size = hold.size;
+                    slot.sender = hold.sender;
+                    slot.destination = hold.destination;
+                    std::swap(slot.offset, hold.offset);
+                    _reorder_count++;
+                }
+                hold.used = false;
+            }
+            else {
+                // The datagram is too far ahead of the expected sequence
+                // number: the window is exhausted and the expected datagram
+                // is declared lost. Resynchronize on the oldest datagram in
+                // the ring and loop back to deliver it. The held datagram
+                // remains pending and will be stored later.
+                size_t lost = 0;
+                while (!_reorder_slots[_reorder_next % _reorder_window].used) {
+                    _reorder_next++;
+                    lost++;
+                }
+                report.debug(u"RTP reordering window exhausted, %d datagram(s) lost", {lost});
             }
             continue;
         }
 
-        // Keep track of the first sender address.
-        if (!_first_source.hasAddress()) {
-            // First packet, keep address of the sender.
-            _first_source = sender;
-            _sources.insert(sender);
+        // Receive one more datagram from the network into the holding slot.
+        uint8_t* const buf = _reorder_buffer.data() + hold.offset;
+        size_t insize = 0;
+        SocketAddress src;
+        SocketAddress dst;
+        if (!UDPSocket::receive(buf, IP_MAX_PACKET_SIZE, insize, src, dst, abort, report)) {
+            return false;
+        }
+        if (!checkDatagram(src, dst, report)) {
+            continue;
+        }
 
-            // With option --first-source, use this one to filter packets.
-            if (_use_first_source) {
-                assert(!_use_source.hasAddress());
-                _use_source = sender;
-                report.verbose(u"now filtering on source address %s", {sender});
-            }
+        // Drop duplicates from the redundant stream before they enter the
+        // reordering ring.
+        if (_redundant_addr.hasPort() && isMergeDuplicate(buf, insize)) {
+            continue;
         }
 
-        // Keep track of senders (sources) to detect or filter multiple sources.
-        if (_sources.count(sender) == 0) {
-            // Detected an additional source, warn the user that distinct streams are potentially mixed.
-            // If no source filtering is applied, this is a warning since this may affect the resulting stream.
-            // With source filtering, this is just an informational verbose-level message.
-            const int level = _use_source.hasAddress() ? Severity::Verbose : Severity::Warning;
-            if (_sources.size() == 1) {
-                report.log(level, u"detected multiple sources for the same destination %s with potentially distinct streams", {destination});
-                report.log(level, u"detected source: %s", {_first_source});
-            }
-            report.log(level, u"detected source: %s", {sender});
-            _sources.insert(sender);
+        // Non-RTP datagrams are delivered immediately, in arrival order.
+        if (insize < RTP_HEADER_SIZE || (buf[0] >> 6) != 2) {
+            ret_size = std::min(insize, max_size);
+            ::memcpy(data, buf, ret_size);  // Flawfinder: ignore
+            sender = src;
+            destination = dst;
+            return true;
+        }
+
+        // Synchronize on the first RTP datagram of the stream.
+        const uint16_t seq = GetUInt16(buf + 2);
+        if (!_reorder_sync) {
+            _reorder_sync = true;
+            _reorder_next = seq;
         }
 
-        // Filter packets based on source address if requested.
-        if (!sender.match(_use_source)) {
-            // Not the expected source, this is a spurious packet.
-            if (report.maxSeverity() >= Severity::Debug) {
-                // Prior report level checking to avoid evaluating parameters when not necessary.
-                report.debug(u"rejecting packet, source: %s, expecting: %s", {sender, _use_source});
+        // Drop datagrams behind the expected sequence number, their slot was
+        // already delivered or declared lost. When the ring is empty and the
+        // datagram is far in the past, this is a stream restart, not a late
+        // datagram, and we resynchronize on it.
+        const uint16_t behind = uint16_t(_reorder_next - seq);
+        if (behind > 0 && behind < 0x8000) {
+            if (_reorder_count == 0 && behind > _reorder_window) {
+                report.debug(u"RTP sequence jump, resynchronizing at sequence %d", {seq});
+                _reorder_next = seq;
+            }
+            else {
+                report.log(2, u"dropping late RTP datagram, sequence %d, expected %d", {seq, _reorder_next});
+                continue;
             }
-            continue;
         }
 
-        // Now found a packet matching all criteria.
+        // Keep the datagram in the holding slot, the next iteration stores it.
+        hold.used = true;
+        hold.seq = seq;
+        hold.size = insize;
+        hold.sender = src;
+        hold.destination = dst;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Deliver the datagram with the next expected sequence number.
+//----------------------------------------------------------------------------
+
+void ts::UDPReceiver::popReorderSlot(void* data, size_t max_size, size_t& ret_size, SocketAddress& sender, SocketAddress& destination)
+{
+    ReorderSlot& slot(_reorder_slots[_reorder_next % _reorder_window]);
+    assert(slot.used);
+    ret_size = std::min(slot.size, max_size);
+    ::memcpy(data, _reorder_buffer.data() + slot.offset, ret_size);  // Flawfinder: ignore
+    sender = slot.sender;
+    destination = slot.destination;
+    slot.used = false;
+    _reorder_count--;
+    _reorder_next++;
+}
+
+
+//----------------------------------------------------------------------------
+// Receive several messages in one operation. Override UDPSocket::receiveBatch().
+//----------------------------------------------------------------------------
+
+bool ts::UDPReceiver::receiveBatch(Datagram* datagrams, size_t max_count, size_t& ret_count, const AbortInterface* abort, Report& report)
+{
+    // With --rtp-reorder, the datagrams must be delivered one by one, in
+    // sequence order. The batch degenerates into a single datagram.
+    if (_reorder_window > 0) {
+        Datagram& dg(datagrams[0]);
+        if (!receiveReordered(dg.data, dg.max_size, dg.ret_size, dg.sender, dg.destination, abort, report)) {
+            ret_count = 0;
+            return false;
+        }
+        dg.timestamp = Time::Epoch;
+        ret_count = 1;
         return true;
     }
+
+    // Loop on batch reception until at least one datagram matches the filtering criteria.
+    for (;;) {
+
+        // Wait for a batch of UDP messages from the superclass.
+        size_t count = 0;
+        if (!UDPSocket::receiveBatch(datagrams, max_count, count, abort, report)) {
+            return false;
+        }
+
+        // Keep only the datagrams matching the filtering criteria, compacting the array.
+        ret_count = 0;
+        for (size_t i = 0; i < count; ++i) {
+            Datagram& dg(datagrams[i]);
+
+            // Drop "successful" empty messages coming from nowhere, spurious
+            // packets and duplicates from the redundant stream.
+            if ((dg.ret_size == 0 && !dg.sender.hasAddress()) || !checkDatagram(dg.sender, dg.destination, report)) {
+                continue;
+            }
+            if (_redundant_addr.hasPort() && isMergeDuplicate(reinterpret_cast<const uint8_t*>(dg.data), dg.ret_size)) {
+                continue;
+            }
+
+            // Move the datagram down into the first free slot. Each slot keeps
+            // its own buffer, the message content must be copied.
+            if (ret_count < i) {
+                Datagram& out(datagrams[ret_count]);
+                out.ret_size = std::min(dg.ret_size, out.max_size);
+                ::memmove(out.data, dg.data, out.ret_size);
+                out.sender = dg.sender;
+                out.destination = dg.destination;
+                out.timestamp = dg.timestamp;
+            }
+            ret_count++;
+        }
+
+        // Found at least one datagram matching all criteria.
+        if (ret_count > 0) {
+            return true;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a received datagram matches all filtering criteria.
+//----------------------------------------------------------------------------
+
+bool ts::UDPReceiver::checkDatagram(const SocketAddress& sender, const SocketAddress& destination, Report& report)
+{
+    // Debug (level 2) message for each message.
+    if (report.maxSeverity() >= 2) {
+        // Prior report level checking to avoid evaluating parameters when not necessary.
+        report.log(2, u"received UDP packet, source: %s, destination: %s", {sender, destination});
+    }
+
+    // Check the destination address to exclude packets from other streams.
+    // When several multicast streams use the same destination port and several
+    // applications on the same system listen to these distinct streams,
+    // the multicast MAC address management is such that any socket which
+    // is bound to the common port will receive the traffic for all streams.
+    // This is why we need to check the destination address and exclude
+    // packets which are not from the intended stream.
+    //
+    // We accept a packet in any of:
+    // 1) Actual packet destination is unknown. Probably, the system cannot
+    //    report the destination address.
+    // 2) We listen to a multicast address and the actual destination is the same.
+    // 3) If we listen to unicast traffic and the actual destination is unicast.
+    //    In that case, unicast is by definition sent to us.
+
+    if (destination.hasAddress() && ((_dest_addr.hasAddress() && destination != _dest_addr && destination != _redundant_addr) || (!_dest_addr.hasAddress() && destination.isMulticast()))) {
+        // This is a spurious packet.
+        if (report.maxSeverity() >= Severity::Debug) {
+            // Prior report level checking to avoid evaluating parameters when not necessary.
+            report.debug(u"rejecting packet, destination: %s, expecting: %s", {destination, _dest_addr});
+        }
+        return false;
+    }
+
+    // Keep track of the first sender address.
+    if (!_first_source.hasAddress()) {
+        // First packet, keep address of the sender.
+        _first_source = sender;
+        _sources.insert(sender);
+
+        // With option --first-source, use this one to filter packets.
+        if (_use_first_source) {
+            assert(!_use_source.hasAddress());
+            _use_source = sender;
+            report.verbose(u"now filtering on source address %s", {sender});
+        }
+    }
+
+    // Keep track of senders (sources) to detect or filter multiple sources.
+    if (_sources.count(sender) == 0) {
+        // Detected an additional source, warn the user that distinct streams are potentially mixed.
+        // If no source filtering is applied, this is a warning since this may affect the resulting stream.
+        // With source filtering, this is just an informational verbose-level message.
+        // With a redundant stream, the two feeds legitimately come from distinct sources.
+        const int level = _use_source.hasAddress() || _redundant_addr.hasPort() ? Severity::Verbose : Severity::Warning;
+        if (_sources.size() == 1) {
+            report.log(level, u"detected multiple sources for the same destination %s with potentially distinct streams", {destination});
+            report.log(level, u"detected source: %s", {_first_source});
+        }
+        report.log(level, u"detected source: %s", {sender});
+        _sources.insert(sender);
+    }
+
+    // Filter packets based on source address if requested.
+    if (!sender.match(_use_source)) {
+        // Not the expected source, this is a spurious packet.
+        if (report.maxSeverity() >= Severity::Debug) {
+            // Prior report level checking to avoid evaluating parameters when not necessary.
+            report.debug(u"rejecting packet, source: %s, expecting: %s", {sender, _use_source});
+        }
+        return false;
+    }
+
+    // Now found a packet matching all criteria.
+    return true;
 }
@@ -35,6 +35,7 @@
 #pragma once
 #include "tsUDPSocket.h"
 #include "tsArgsSupplierInterface.h"
+#include "tsByteBlock.h"
 
 namespace ts {
     //!
@@ -66,6 +67,13 @@ namespace ts {
         //!
         bool receiverSpecified() const { return _receiver_specified; }
 
+        //!
+        //! Get the destination address and port of the received UDP stream.
+        //! @return The destination address and port, as specified on the command
+        //! line or by setParameters().
+        //!
+        SocketAddress destination() const { return _dest_addr; }
+
         //!
         //! Set application-specified parameters to receive unicast traffic.
         //! This method is used when command line parameters are not used.
@@ -90,8 +98,27 @@ namespace ts {
                              SocketAddress& destination,
                              const AbortInterface* abort = nullptr,
                              Report& report = CERR) override;
+        virtual bool receiveBatch(Datagram* datagrams,
+                                  size_t max_count,
+                                  size_t& ret_count,
+                                  const AbortInterface* abort = nullptr,
+                                  Report& report = CERR) override;
 
     private:
+        // One datagram slot in the RTP reordering ring (option --rtp-reorder).
+        // The slot does not own its buffer, it points into _reorder_buffer.
+        struct ReorderSlot
+        {
+            bool          used;         // The slot contains a datagram.
+            uint16_t      seq;          // RTP sequence number of the datagram.
+            size_t        size;         // Size in bytes of the datagram.
+            size_t        offset;       // Offset of the datagram in _reorder_buffer.
+            SocketAddress sender;       // Sender of the datagram.
+            SocketAddress destination;  // Destination of the datagram.
+
+            ReorderSlot() : used(false), seq(0), size(0), offset(0), sender(), destination() {}
+        };
+
         bool                    _with_short_options;
         bool                    _dest_as_param;
         bool                    _receiver_specified; // An address is specified.
@@ -106,5 +133,27 @@ namespace ts {
         SocketAddress           _use_source;         // Filter on this socket address of sender (can be a simple filter of an SSM source).
         SocketAddress           _first_source;       // Socket address of first received packet.
         std::set<SocketAddress> _sources;            // Set of all detected packet sources.
+        SocketAddress           _redundant_addr;     // Destination of a redundant copy of the stream (--redundant).
+        std::vector<uint32_t>   _merge_history;      // Signatures of recently delivered datagrams (--redundant).
+        size_t                  _reorder_window;     // RTP reordering window in datagrams (0: no reordering).
+        bool                    _reorder_sync;       // _reorder_next contains a valid sequence number.
+        uint16_t                _reorder_next;       // Next expected RTP sequence number.
+        size_t                  _reorder_count;      // Number of datagrams currently stored in the ring.
+        ByteBlock               _reorder_buffer;     // Storage for _reorder_window ring slots plus one holding slot.
+        std::vector<ReorderSlot> _reorder_slots;     // Ring slots, plus the holding slot at index _reorder_window.
+
+        // Check if a received datagram matches all filtering criteria.
+        // Track the packet sources. Return false on spurious packets.
+        bool checkDatagram(const SocketAddress& sender, const SocketAddress& destination, Report& report);
+
+        // Check if a datagram is a duplicate from the redundant stream (--redundant).
+        // Record the signature of new datagrams. Must not be called twice on the same datagram.
+        bool isMergeDuplicate(const uint8_t* data, size_t size);
+
+        // Receive one datagram in RTP sequence order (option --rtp-reorder).
+        bool receiveReordered(void* data, size_t max_size, size_t& ret_size, SocketAddress& sender, SocketAddress& destination, const AbortInterface* abort, Report& report);
+
+        // Deliver the datagram with the next expected sequence number from its ring slot.
+        void popReorderSlot(void* data, size_t max_size, size_t& ret_size, SocketAddress& sender, SocketAddress& destination);
     };
 }
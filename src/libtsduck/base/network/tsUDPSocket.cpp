@@ -33,8 +33,14 @@
 
 #include "tsUDPSocket.h"
 #include "tsNullReport.h"
+#include "tsTracepoint.h"
 TSDUCK_SOURCE;
 
+#if defined(TS_LINUX)
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+#endif
+
 // Furiously idiotic Windows feature, see comment in receiveOne()
 #if defined(TS_WINDOWS)
 volatile ::LPFN_WSARECVMSG ts::UDPSocket::_wsaRevcMsg = 0;
@@ -50,7 +56,8 @@ ts::UDPSocket::UDPSocket(bool auto_open, Report& report) :
     _local_address(),
     _default_destination(),
     _mcast(),
-    _ssmcast()
+    _ssmcast(),
+    _no_gso(false)
 {
     if (auto_open) {
         // Returned value ignored on purpose, the socket is marked as closed in the object on error.
@@ -90,6 +97,31 @@ bool ts::UDPSocket::open(Report& report)
         return false;
     }
 
+#if defined(TS_LINUX)
+    // Get the reception time of each datagram in ancillary data. Try the
+    // SO_TIMESTAMPING option first: it reports nanosecond-resolution software
+    // time stamps and, when the network interface supports it, time stamps
+    // from the NIC hardware clock, taken before the datagram even enters the
+    // kernel. Fall back to the classical SO_TIMESTAMP on older kernels.
+    // These are best effort options, the reception time is left unset when
+    // none is supported.
+    opt = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE | SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (::setsockopt(getSocket(), SOL_SOCKET, SO_TIMESTAMPING, TS_SOCKOPT_T(&opt), sizeof(opt)) != 0) {
+        report.debug(u"error setting socket SO_TIMESTAMPING option: %s", {SocketErrorCodeMessage()});
+        opt = 1;
+        if (::setsockopt(getSocket(), SOL_SOCKET, SO_TIMESTAMP, TS_SOCKOPT_T(&opt), sizeof(opt)) != 0) {
+            report.debug(u"error setting socket SO_TIMESTAMP option: %s", {SocketErrorCodeMessage()});
+        }
+    }
+#elif defined(TS_UNIX)
+    // Set the SO_TIMESTAMP option to get the kernel reception time of each
+    // datagram in ancillary data. This is a best effort option, some systems
+    // do not support it and the reception time is then left unset.
+    if (::setsockopt(getSocket(), SOL_SOCKET, SO_TIMESTAMP, TS_SOCKOPT_T(&opt), sizeof(opt)) != 0) {
+        report.debug(u"error setting socket SO_TIMESTAMP option: %s", {SocketErrorCodeMessage()});
+    }
+#endif
+
     return true;
 }
 
@@ -403,6 +435,146 @@ bool ts::UDPSocket::send(const void* data, size_t size, const SocketAddress& des
 }
 
 
+//----------------------------------------------------------------------------
+// Send a contiguous buffer as several datagrams in one operation.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::sendSegments(const void* data, size_t size, size_t segment_size, Report& report)
+{
+    // When the buffer fits in one single datagram, use the regular path.
+    if (segment_size == 0 || size <= segment_size) {
+        return size == 0 || send(data, size, report);
+    }
+
+#if defined(TS_LINUX)
+
+    const uint8_t* current = reinterpret_cast<const uint8_t*>(data);
+    size_t remain = size;
+
+    ::sockaddr addr;
+    _default_destination.copy(addr);
+
+#if defined(UDP_SEGMENT)
+    // First try UDP generic segmentation offload (GSO): the kernel splits one
+    // large buffer into datagrams of segment_size bytes each, one system call
+    // and one traversal of the network stack for the whole buffer. The kernel
+    // limits one GSO send to 64 segments and to the maximum UDP payload size.
+    // Older kernels and some network devices do not support GSO, in which case
+    // we permanently fall back to sendmmsg() on this socket.
+    const size_t max_chunk = std::min<size_t>(64, 65507 / segment_size) * segment_size;
+    while (!_no_gso && remain > segment_size) {
+        const size_t chunk = std::min(remain, max_chunk);
+
+        // Build a message with the segment size in ancillary data.
+        ::iovec vec;
+        TS_ZERO(vec);
+        vec.iov_base = const_cast<uint8_t*>(current);
+        vec.iov_len = chunk;
+
+        uint8_t ancil_data[CMSG_SPACE(sizeof(uint16_t))];
+        TS_ZERO(ancil_data);
+
+        ::msghdr hdr;
+        TS_ZERO(hdr);
+        hdr.msg_name = &addr;
+        hdr.msg_namelen = sizeof(addr);
+        hdr.msg_iov = &vec;
+        hdr.msg_iovlen = 1;
+        hdr.msg_control = ancil_data;
+        hdr.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+
+        ::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type = UDP_SEGMENT;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        *reinterpret_cast<uint16_t*>(CMSG_DATA(cmsg)) = uint16_t(segment_size);
+
+        if (::sendmsg(getSocket(), &hdr, 0) >= 0) {
+            current += chunk;
+            remain -= chunk;
+        }
+        else if (errno == EINTR) {
+            // Got a signal, not a user interrupt, will ignore it
+            report.debug(u"signal, not user interrupt");
+        }
+        else if (errno == EIO || errno == EINVAL || errno == EOPNOTSUPP) {
+            // GSO not supported here, use sendmmsg() for the rest of the buffer.
+            report.debug(u"UDP generic segmentation offload not available: %s", {SocketErrorCodeMessage()});
+            _no_gso = true;
+        }
+        else {
+            report.error(u"error sending UDP message: " + SocketErrorCodeMessage());
+            return false;
+        }
+    }
+#endif // UDP_SEGMENT
+
+    // Send the remaining full segments with sendmmsg(), one message per
+    // segment but one single system call per batch of 64 messages.
+    while (remain > segment_size) {
+        const size_t MAX_BATCH = 64;
+        ::mmsghdr msgs[MAX_BATCH];
+        ::iovec vecs[MAX_BATCH];
+        TS_ZERO(msgs);
+        TS_ZERO(vecs);
+
+        size_t count = 0;
+        const uint8_t* next = current;
+        size_t ahead = remain;
+        while (count < MAX_BATCH && ahead > 0) {
+            vecs[count].iov_base = const_cast<uint8_t*>(next);
+            vecs[count].iov_len = std::min(ahead, segment_size);
+            msgs[count].msg_hdr.msg_name = &addr;
+            msgs[count].msg_hdr.msg_namelen = sizeof(addr);
+            msgs[count].msg_hdr.msg_iov = &vecs[count];
+            msgs[count].msg_hdr.msg_iovlen = 1;
+            next += vecs[count].iov_len;
+            ahead -= vecs[count].iov_len;
+            count++;
+        }
+
+        const int sent = ::sendmmsg(getSocket(), msgs, unsigned(count), 0);
+        if (sent > 0) {
+            TS_TRACEPOINT1(udp_send_batch, sent);
+            // Advance past the messages which were accepted, resend the others.
+            for (int i = 0; i < sent; ++i) {
+                const size_t len = std::min(remain, segment_size);
+                current += len;
+                remain -= len;
+            }
+        }
+        else if (errno == EINTR) {
+            // Got a signal, not a user interrupt, will ignore it
+            report.debug(u"signal, not user interrupt");
+        }
+        else {
+            report.error(u"error sending UDP message: " + SocketErrorCodeMessage());
+            return false;
+        }
+    }
+
+    // Send the last segment, shorter than segment_size, if any.
+    return remain == 0 || send(current, remain, report);
+
+#else
+
+    // No batch transmission on this platform, send one datagram at a time.
+    const uint8_t* current = reinterpret_cast<const uint8_t*>(data);
+    size_t remain = size;
+    while (remain > 0) {
+        const size_t chunk = std::min(remain, segment_size);
+        if (!send(current, chunk, report)) {
+            return false;
+        }
+        current += chunk;
+        remain -= chunk;
+    }
+    return true;
+
+#endif // Linux vs. others
+}
+
+
 //----------------------------------------------------------------------------
 // Receive a message.
 // If abort interface is non-zero, invoke it when I/O is interrupted
@@ -419,10 +591,11 @@ bool ts::UDPSocket::receive(void* data,
                             Report& report)
 {
     // Loop on unsollicited interrupts
+    Time timestamp;
     for (;;) {
 
         // Wait for a message.
-        const SocketErrorCode err = receiveOne(data, max_size, ret_size, sender, destination, report);
+        const SocketErrorCode err = receiveOne(data, max_size, ret_size, sender, destination, timestamp, report);
 
         if (abort != nullptr && abort->aborting()) {
             // Aborting, no error message.
@@ -453,16 +626,155 @@ bool ts::UDPSocket::receive(void* data,
 }
 
 
+//----------------------------------------------------------------------------
+// Receive several messages in one operation.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::receiveBatch(Datagram* datagrams, size_t max_count, size_t& ret_count, const AbortInterface* abort, Report& report)
+{
+    ret_count = 0;
+    if (datagrams == nullptr || max_count == 0) {
+        return true;
+    }
+
+#if defined(TS_LINUX)
+
+    // Maximum number of messages per recvmmsg() call. One system call is
+    // enough to drain the kernel queue in most cases, a larger batch would
+    // only waste stack space on the system structures.
+    const size_t MAX_BATCH = 32;
+    const size_t count = std::min(max_count, MAX_BATCH);
+
+    // System structures describing each message.
+    ::mmsghdr msgs[MAX_BATCH];
+    ::iovec vecs[MAX_BATCH];
+    ::sockaddr senders[MAX_BATCH];
+    uint8_t ancil_data[MAX_BATCH][256];
+    TS_ZERO(msgs);
+    TS_ZERO(vecs);
+    TS_ZERO(senders);
+    TS_ZERO(ancil_data);
+
+    for (size_t i = 0; i < count; ++i) {
+        Datagram& dg(datagrams[i]);
+        dg.ret_size = 0;
+        dg.sender.clear();
+        dg.destination.clear();
+        dg.timestamp = Time::Epoch;
+        dg.timestamp_us = -1;
+        dg.timestamp_hw = false;
+        vecs[i].iov_base = dg.data;
+        vecs[i].iov_len = dg.max_size;
+        msgs[i].msg_hdr.msg_name = &senders[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(senders[i]);
+        msgs[i].msg_hdr.msg_iov = &vecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_control = ancil_data[i];
+        msgs[i].msg_hdr.msg_controllen = sizeof(ancil_data[i]);
+    }
+
+    // Loop on unsollicited interrupts.
+    for (;;) {
+
+        // Wait for the first message, then grab all messages which are
+        // already queued in the kernel, without waiting for more.
+        const int got = ::recvmmsg(getSocket(), msgs, unsigned(count), MSG_WAITFORONE, nullptr);
+
+        if (abort != nullptr && abort->aborting()) {
+            // Aborting, no error message.
+            return false;
+        }
+        else if (got > 0) {
+            TS_TRACEPOINT1(udp_receive_batch, got);
+            // Extract the addresses and ancillary data of each message.
+            for (int i = 0; i < got; ++i) {
+                Datagram& dg(datagrams[i]);
+                dg.ret_size = size_t(msgs[i].msg_len);
+                dg.sender = SocketAddress(senders[i]);
+                for (::cmsghdr* cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg)) {
+                    if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO && cmsg->cmsg_len >= sizeof(::in_pktinfo)) {
+                        const ::in_pktinfo* info = reinterpret_cast<const ::in_pktinfo*>(CMSG_DATA(cmsg));
+                        dg.destination = SocketAddress(info->ipi_addr, _local_address.port());
+                    }
+                    else if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMP && cmsg->cmsg_len >= sizeof(::timeval)) {
+                        const ::timeval* tv = reinterpret_cast<const ::timeval*>(CMSG_DATA(cmsg));
+                        dg.timestamp = Time::UnixTimeToUTC(uint64_t(tv->tv_sec)) + MilliSecond(tv->tv_usec / 1000);
+                        dg.timestamp_us = MicroSecond(tv->tv_sec) * MicroSecPerSec + MicroSecond(tv->tv_usec);
+                    }
+                    else if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING && cmsg->cmsg_len >= sizeof(::scm_timestamping)) {
+                        // Index 2 is the raw hardware time stamp from the NIC clock,
+                        // index 0 the software one. Prefer the hardware time stamp.
+                        const ::scm_timestamping* st = reinterpret_cast<const ::scm_timestamping*>(CMSG_DATA(cmsg));
+                        dg.timestamp_hw = st->ts[2].tv_sec != 0 || st->ts[2].tv_nsec != 0;
+                        const ::timespec& t(dg.timestamp_hw ? st->ts[2] : st->ts[0]);
+                        dg.timestamp = Time::UnixTimeToUTC(uint64_t(t.tv_sec)) + MilliSecond(t.tv_nsec / NanoSecPerMilliSec);
+                        dg.timestamp_us = MicroSecond(t.tv_sec) * MicroSecPerSec + MicroSecond(t.tv_nsec / NanoSecPerMicroSec);
+                    }
+                }
+            }
+            ret_count = size_t(got);
+            return true;
+        }
+        else if (LastSocketErrorCode() == EINTR) {
+            // Got a signal, not a user interrupt, will ignore it
+            report.debug(u"signal, not user interrupt");
+        }
+        else {
+            // Abort on non-interrupt errors.
+            report.error(u"error receiving from UDP socket: %s", {SocketErrorCodeMessage()});
+            return false;
+        }
+    }
+
+#else
+
+    // No batch reception system call on this platform, receive one datagram,
+    // using the same loop on unsollicited interrupts as receive().
+    Datagram& dg(datagrams[0]);
+    for (;;) {
+
+        // Wait for a message.
+        const SocketErrorCode err = receiveOne(dg.data, dg.max_size, dg.ret_size, dg.sender, dg.destination, dg.timestamp, report);
+
+        if (abort != nullptr && abort->aborting()) {
+            // Aborting, no error message.
+            return false;
+        }
+        else if (err == SYS_SUCCESS) {
+            // Sometimes, we get "successful" empty message coming from nowhere. Ignore them.
+            if (dg.ret_size > 0 || dg.sender.hasAddress()) {
+                ret_count = 1;
+                return true;
+            }
+        }
+#if !defined(TS_WINDOWS)
+        else if (err == EINTR) {
+            // Got a signal, not a user interrupt, will ignore it
+            report.debug(u"signal, not user interrupt");
+        }
+#endif
+        else {
+            // Abort on non-interrupt errors.
+            report.error(u"error receiving from UDP socket: %s", {SocketErrorCodeMessage(err)});
+            return false;
+        }
+    }
+
+#endif // Linux vs. others
+}
+
+
 //----------------------------------------------------------------------------
 // Perform one receive operation. Hide the system mud.
 //----------------------------------------------------------------------------
 
-ts::SocketErrorCode ts::UDPSocket::receiveOne(void* data, size_t max_size, size_t& ret_size, SocketAddress& sender, SocketAddress& destination, Report& report)
+ts::SocketErrorCode ts::UDPSocket::receiveOne(void* data, size_t max_size, size_t& ret_size, SocketAddress& sender, SocketAddress& destination, Time& timestamp, Report& report)
 {
     // Clear returned values
     ret_size = 0;
     sender.clear();
     destination.clear();
+    timestamp = Time::Epoch;
 
     // Reserve a socket address to receive the sender address.
     ::sockaddr sender_sock;
@@ -568,6 +880,17 @@ ts::SocketErrorCode ts::UDPSocket::receiveOne(void* data, size_t max_size, size_
             const ::in_pktinfo* info = reinterpret_cast<const ::in_pktinfo*>(CMSG_DATA(cmsg));
             destination = SocketAddress(info->ipi_addr, _local_address.port());
         }
+        else if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMP && cmsg->cmsg_len >= sizeof(::timeval)) {
+            const ::timeval* tv = reinterpret_cast<const ::timeval*>(CMSG_DATA(cmsg));
+            timestamp = Time::UnixTimeToUTC(uint64_t(tv->tv_sec)) + MilliSecond(tv->tv_usec / 1000);
+        }
+#if defined(TS_LINUX)
+        else if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING && cmsg->cmsg_len >= sizeof(::scm_timestamping)) {
+            const ::scm_timestamping* st = reinterpret_cast<const ::scm_timestamping*>(CMSG_DATA(cmsg));
+            const ::timespec& t(st->ts[2].tv_sec != 0 || st->ts[2].tv_nsec != 0 ? st->ts[2] : st->ts[0]);
+            timestamp = Time::UnixTimeToUTC(uint64_t(t.tv_sec)) + MilliSecond(t.tv_nsec / NanoSecPerMilliSec);
+        }
+#endif
     }
 
 #endif // Windows vs. UNIX
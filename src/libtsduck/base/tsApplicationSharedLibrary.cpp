@@ -59,14 +59,9 @@ ts::ApplicationSharedLibrary::ApplicationSharedLibrary(const UString& filename,
 
     // If there is no directory in file name, use search rules in specific directories.
     if (!has_directory) {
-        // Get a list of directories from environment variable.
+        // Get the list of directories to search.
         UStringList dirs;
-        if (!library_path.empty()) {
-            GetEnvironmentPath(dirs, library_path);
-        }
-
-        // Then, try in same directory as executable
-        dirs.push_back(DirectoryName(ExecutableFile()));
+        GetSearchPath(dirs, library_path);
 
         // Try in each directory.
         for (UStringList::const_iterator it = dirs.begin(); !isLoaded() && it != dirs.end(); ++it) {
@@ -112,6 +107,22 @@ ts::UString ts::ApplicationSharedLibrary::moduleName() const
 }
 
 
+//----------------------------------------------------------------------------
+// Get the list of directories where plugins are searched.
+//----------------------------------------------------------------------------
+
+void ts::ApplicationSharedLibrary::GetSearchPath(UStringList& directories, const UString& library_path)
+{
+    directories.clear();
+
+    // Get list of directories: search path, then same directory as executable.
+    if (!library_path.empty()) {
+        GetEnvironmentPath(directories, library_path);
+    }
+    directories.push_back(DirectoryName(ExecutableFile()));
+}
+
+
 //----------------------------------------------------------------------------
 // Get a list of plugins.
 //----------------------------------------------------------------------------
@@ -123,10 +134,7 @@ void ts::ApplicationSharedLibrary::GetPluginList(UStringVector& files, const USt
 
     // Get list of directories: search path, then same directory as executable.
     UStringList dirs;
-    if (!library_path.empty()) {
-        GetEnvironmentPath(dirs, library_path);
-    }
-    dirs.push_back(DirectoryName(ExecutableFile()));
+    GetSearchPath(dirs, library_path);
 
     // Try in each directory.
     for (UStringList::const_iterator it = dirs.begin(); it != dirs.end(); ++it) {
@@ -93,6 +93,14 @@ namespace ts {
         //!
         static void GetPluginList(UStringVector& files, const UString& prefix, const UString& library_path = UString());
 
+        //!
+        //! Get the list of directories where plugins are searched.
+        //! @param [out] directories List of directories, in search order: the directories
+        //! of @a library_path first, then the same directory as the executable.
+        //! @param [in] library_path Name of an environment variable, an optional list of directories to search, similar to @c LD_LIBARY_PATH.
+        //!
+        static void GetSearchPath(UStringList& directories, const UString& library_path = UString());
+
     private:
         UString _prefix;
     };
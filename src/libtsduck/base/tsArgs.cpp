@@ -521,6 +521,27 @@ ts::Args& ts::Args::option(const UChar*       name,
 }
 
 
+//----------------------------------------------------------------------------
+// Add the definitions of all options in a static option table.
+//----------------------------------------------------------------------------
+
+ts::Args& ts::Args::options(const OptionDeclaration* table, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        const OptionDeclaration& decl(table[i]);
+        IOption opt(decl.name, decl.short_name, decl.type, decl.min_occur, decl.max_occur, decl.min_value, decl.max_value, decl.decimals, decl.optional ? uint32_t(IOPT_OPTVALUE) : 0);
+        if (decl.syntax != nullptr) {
+            opt.syntax = decl.syntax;
+        }
+        if (decl.help != nullptr) {
+            opt.help = decl.help;
+        }
+        addOption(opt);
+    }
+    return *this;
+}
+
+
 //----------------------------------------------------------------------------
 // Add the help text of an exiting option.
 //----------------------------------------------------------------------------
@@ -389,6 +389,57 @@ namespace ts {
                      size_t              max_occur = 0,
                      bool                optional = false);
 
+        //!
+        //! Declaration of an option in a static option table.
+        //!
+        //! An array of OptionDeclaration is a precompiled equivalent of a
+        //! sequence of option() and help() calls. All fields are plain values
+        //! or pointers to string literals, so a static table costs nothing to
+        //! build at run time and is shared by all instances of a class, while
+        //! each option() and help() pair allocates strings and searches the
+        //! option map again. Options with an Enumeration type cannot be
+        //! declared in a table, declare them with option() in addition.
+        //! @see options()
+        //!
+        struct TSDUCKDLL OptionDeclaration
+        {
+            const UChar* name;        //!< Long name of option. 0 or "" means a parameter, not an option.
+            UChar        short_name;  //!< Optional one letter short name.
+            ArgType      type;        //!< Option or parameter value type.
+            size_t       min_occur;   //!< Minimum number of occurences of this option on the command line.
+            size_t       max_occur;   //!< Maximum number of occurences. 0 means default.
+            int64_t      min_value;   //!< Minimum value, ignored if @a type is not @link INTEGER @endlink.
+            int64_t      max_value;   //!< Maximum value, ignored if @a type is not @link INTEGER @endlink.
+            bool         optional;    //!< When true, the option's value is optional.
+            size_t       decimals;    //!< Reference number of decimal digits.
+            const UChar* syntax;      //!< String to display for the option value, can be null.
+            const UChar* help;        //!< Help text, can be null.
+        };
+
+        //!
+        //! Add the definitions of all options in a static option table.
+        //!
+        //! This method is typically invoked in the constructor of a subclass.
+        //! @param [in] table Address of an array of option declarations.
+        //! @param [in] count Number of elements in @a table.
+        //! @return A reference to this instance.
+        //!
+        Args& options(const OptionDeclaration* table, size_t count);
+
+        //!
+        //! Add the definitions of all options in a static option table.
+        //!
+        //! This method is typically invoked in the constructor of a subclass.
+        //! @tparam N Number of elements in @a table, always deduced.
+        //! @param [in] table An array of option declarations.
+        //! @return A reference to this instance.
+        //!
+        template <size_t N>
+        Args& options(const OptionDeclaration (&table)[N])
+        {
+            return options(table, N);
+        }
+
         //!
         //! Add the help text of an existing option.
         //!
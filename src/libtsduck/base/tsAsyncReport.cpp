@@ -28,8 +28,11 @@
 //----------------------------------------------------------------------------
 
 #include "tsAsyncReport.h"
+#include "tsSysUtils.h"
 TSDUCK_SOURCE;
 
+#define QUEUE_POLL_INTERVAL 20  // Milliseconds, polling interval of the logging thread on an empty queue.
+
 
 //----------------------------------------------------------------------------
 // Default constructor
@@ -38,18 +41,83 @@ TSDUCK_SOURCE;
 ts::AsyncReport::AsyncReport(int max_severity, const AsyncReportArgs& args) :
     Report(max_severity),
     Thread(ThreadAttributes().setPriority(ThreadAttributes::GetMinimumPriority())),
-    _log_queue(args.log_msg_count),
+    _log_queue(),
+    _queue_mask(0),
+    _enqueue_pos(0),
+    _dequeue_pos(0),
     _default_handler(*this),
     _handler(&_default_handler),
     _time_stamp(args.timed_log),
     _synchronous(args.sync_log),
     _terminated(false)
 {
+    // The ring size must be a power of 2, round the requested size up.
+    size_t size = 16;
+    while (size < args.log_msg_count) {
+        size <<= 1;
+    }
+    _log_queue = std::vector<LogSlot>(size);
+    _queue_mask = size - 1;
+
+    // Each slot initially holds its own index as sequence number, meaning "free".
+    for (size_t i = 0; i < size; ++i) {
+        _log_queue[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
     // Start the logging thread
     start ();
 }
 
 
+//----------------------------------------------------------------------------
+// Lock-free bounded MPSC message queue (Vyukov style).
+//----------------------------------------------------------------------------
+
+bool ts::AsyncReport::enqueueMessage(const LogMessage& msg)
+{
+    size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        LogSlot& slot(_log_queue[pos & _queue_mask]);
+        const size_t seq = slot.sequence.load(std::memory_order_acquire);
+        if (seq == pos) {
+            // The slot is free, try to claim it against other producers.
+            if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.msg = msg;
+                // Publish the slot to the consumer.
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+            // Lost the race, pos was reloaded by compare_exchange_weak, retry.
+        }
+        else if (seq < pos) {
+            // The slot still holds an unconsumed message, the queue is full.
+            return false;
+        }
+        else {
+            // Another producer claimed this slot, move to the current position.
+            pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool ts::AsyncReport::dequeueMessage(LogMessage& msg)
+{
+    const size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+    LogSlot& slot(_log_queue[pos & _queue_mask]);
+    const size_t seq = slot.sequence.load(std::memory_order_acquire);
+    if (seq < pos + 1) {
+        // The slot is not yet published, the queue is empty.
+        return false;
+    }
+    msg = slot.msg;
+    // Release the message storage and mark the slot free for the next lap.
+    slot.msg.message.clear();
+    slot.sequence.store(pos + _log_queue.size(), std::memory_order_release);
+    _dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Destructor
 //----------------------------------------------------------------------------
@@ -69,7 +137,11 @@ void ts::AsyncReport::terminate()
     if (!_terminated) {
         // Insert an "end of report" message in the queue.
         // This message will tell the logging thread to terminate.
-        _log_queue.forceEnqueue(new LogMessage(true, 0, UString()));
+        // It must not be dropped, retry until the queue has room.
+        const LogMessage msg(true, 0, UString());
+        while (!enqueueMessage(msg)) {
+            SleepThread(QUEUE_POLL_INTERVAL);
+        }
 
         // Wait for termination of the logging thread
         waitForTermination();
@@ -94,9 +166,13 @@ void ts::AsyncReport::writeLog(int severity, const UString &msg)
 #endif
 
     if (!_terminated) {
-        // Enqueue the message immediately (timeout = 0), drop message on overflow.
-        // On the contrary, in synchronous mode, wait infinitely until the message is queued.
-        _log_queue.enqueue(new LogMessage(false, severity, msg), _synchronous ? Infinite : 0);
+        // Enqueue the message without blocking, drop it on overflow. A message
+        // storm consequently never backpressures the calling thread. On the
+        // contrary, in synchronous mode, wait until the message is queued.
+        const LogMessage message(false, severity, msg);
+        while (!enqueueMessage(message) && _synchronous) {
+            SleepThread(QUEUE_POLL_INTERVAL);
+        }
     }
 }
 
@@ -107,15 +183,24 @@ void ts::AsyncReport::writeLog(int severity, const UString &msg)
 
 void ts::AsyncReport::main()
 {
-    LogMessagePtr msg;
-
-    while (_log_queue.dequeue(msg) && !msg->terminate) {
+    LogMessage msg;
+
+    for (;;) {
+        // The producers never wake us up, poll the queue at a low rate when empty.
+        // This thread runs at the lowest priority, latency is not a concern.
+        if (!dequeueMessage(msg)) {
+            SleepThread(QUEUE_POLL_INTERVAL);
+            continue;
+        }
+        if (msg.terminate) {
+            break;
+        }
 
         // Invoke the report handler
-        _handler->handleMessage(msg->severity, msg->message);
+        _handler->handleMessage(msg.severity, msg.message);
 
         // Abort application on fatal error
-        if (msg->severity == Severity::Fatal) {
+        if (msg.severity == Severity::Fatal) {
             ::exit(EXIT_FAILURE);
         }
     }
@@ -36,8 +36,6 @@
 #include "tsReport.h"
 #include "tsReportHandler.h"
 #include "tsAsyncReportArgs.h"
-#include "tsMessageQueue.h"
-#include "tsNullMutex.h"
 #include "tsThread.h"
 
 namespace ts {
@@ -125,14 +123,31 @@ namespace ts {
         // The application threads send that type of message to the logging thread
         struct LogMessage
         {
+            LogMessage() : terminate(false), severity(0), message() {}
             LogMessage(bool t, int s, const UString& m) : terminate(t), severity(s), message(m) {}
 
             bool    terminate;  // ask the logging thread to terminate
             int     severity;
             UString message;
         };
-        typedef SafePtr <LogMessage, NullMutex> LogMessagePtr;
-        typedef MessageQueue <LogMessage, NullMutex> LogMessageQueue;
+
+        // One slot in the lock-free message queue. The sequence number
+        // arbitrates the slot between producers and the consumer.
+        struct LogSlot
+        {
+            LogSlot() : sequence(0), msg() {}
+
+            std::atomic<size_t> sequence;
+            LogMessage          msg;
+        };
+
+        // Enqueue a message. Lock-free, performed by any application thread.
+        // Return false when the queue is full, the message is then dropped.
+        bool enqueueMessage(const LogMessage& msg);
+
+        // Dequeue one message, performed by the logging thread only.
+        // Return false when the queue is empty.
+        bool dequeueMessage(LogMessage& msg);
 
         // Default report handler:
         class DefaultHandler : public ReportHandler
@@ -146,7 +161,14 @@ namespace ts {
         };
 
         // Private members:
-        LogMessageQueue         _log_queue;
+        // The message queue is a bounded lock-free MPSC ring (Vyukov style):
+        // any number of application threads enqueue without ever blocking, the
+        // logging thread is the only consumer. Per-thread message ordering is
+        // preserved since producers claim sequence numbers in enqueue order.
+        std::vector<LogSlot>    _log_queue;      // Ring of slots, power of 2 size.
+        size_t                  _queue_mask;     // Size of the ring minus one.
+        std::atomic<size_t>     _enqueue_pos;    // Next sequence number to enqueue.
+        std::atomic<size_t>     _dequeue_pos;    // Next sequence number to dequeue.
         DefaultHandler          _default_handler;
         ReportHandler* volatile _handler;
         volatile bool           _time_stamp;
@@ -40,6 +40,17 @@ INT ts::BitStream::read(size_t n, INT def)
     if (_next_bit + n > _end_bit) {
         return def;
     }
+
+    // Fast path: when a full 64-bit word can be loaded at the current
+    // position, extract the field by shift and mask. The slow path below
+    // handles the last bytes of the stream.
+    if (n > 0 && n <= 56 && (_next_bit >> 3) + 8 <= ((_end_bit + 7) >> 3)) {
+        const uint64_t w = GetUInt64(_base + (_next_bit >> 3));
+        const INT val = INT((w << (_next_bit & 0x07)) >> (64 - n));
+        _next_bit += n;
+        return val;
+    }
+
     INT val = 0;
 
     // Read leading bits up to byte boundary
@@ -37,6 +37,74 @@
 #include "tsBCD.h"
 TSDUCK_SOURCE;
 
+// Maximum number of recycled object nodes in the thread-local free list.
+#define BYTEBLOCK_RECYCLE_MAX 128
+
+
+//----------------------------------------------------------------------------
+// Class-specific object allocation and deallocation.
+//----------------------------------------------------------------------------
+
+#if !defined(TS_NO_BYTEBLOCK_RECYCLE)
+namespace {
+    // Freed ByteBlock object nodes are chained through their first bytes.
+    // All nodes have the same size, sizeof(ByteBlock), a perfect fit for a
+    // free list. The list is thread-local: no lock is ever taken.
+    struct FreeNode
+    {
+        FreeNode* next;
+    };
+
+    // The destructor returns the recycled nodes to the heap at thread exit.
+    struct FreeList
+    {
+        FreeNode* head = nullptr;
+        size_t count = 0;
+        ~FreeList()
+        {
+            while (head != nullptr) {
+                FreeNode* const node = head;
+                head = node->next;
+                ::operator delete(node);
+            }
+        }
+    };
+    thread_local FreeList byteBlockFreeList;
+}
+#endif
+
+void* ts::ByteBlock::operator new(std::size_t size)
+{
+#if !defined(TS_NO_BYTEBLOCK_RECYCLE)
+    // Only recycle plain ByteBlock nodes. A larger size means a subclass,
+    // use the global allocator for it.
+    if (size == sizeof(ByteBlock) && byteBlockFreeList.head != nullptr) {
+        FreeNode* const node = byteBlockFreeList.head;
+        byteBlockFreeList.head = node->next;
+        byteBlockFreeList.count--;
+        return node;
+    }
+#endif
+    return ::operator new(size);
+}
+
+void ts::ByteBlock::operator delete(void* addr) noexcept
+{
+    if (addr != nullptr) {
+#if !defined(TS_NO_BYTEBLOCK_RECYCLE)
+        // Keep the free list bounded, long-lived threads shall not hoard memory.
+        if (byteBlockFreeList.count < BYTEBLOCK_RECYCLE_MAX) {
+            FreeNode* const node = reinterpret_cast<FreeNode*>(addr);
+            node->next = byteBlockFreeList.head;
+            byteBlockFreeList.head = node;
+            byteBlockFreeList.count++;
+            return;
+        }
+#endif
+        ::operator delete(addr);
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Default constructor
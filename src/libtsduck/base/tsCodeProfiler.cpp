@@ -0,0 +1,164 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsCodeProfiler.h"
+#include "tsjsonObject.h"
+#include "tsjsonArray.h"
+#include "tsjsonNumber.h"
+#include "tsGuard.h"
+#include "tsMutex.h"
+#include "tsMemory.h"
+TSDUCK_SOURCE;
+
+// Global activation flag for all profilers.
+volatile bool ts::CodeProfiler::_enabled = false;
+
+namespace {
+    // Process-wide registry of profilers. The mutex and the set are
+    // constructed on first use and intentionally never destructed, so
+    // that profilers in static objects can safely unregister at exit.
+    ts::Mutex& RegistryMutex()
+    {
+        static ts::Mutex* mutex = new ts::Mutex;
+        return *mutex;
+    }
+
+    std::set<ts::CodeProfiler*>& Registry()
+    {
+        static std::set<ts::CodeProfiler*>* registry = new std::set<ts::CodeProfiler*>;
+        return *registry;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::CodeProfiler::CodeProfiler(const UString& name) :
+    _name(name),
+    _calls(0),
+    _total(0),
+    _min(0),
+    _max(0),
+    _buckets()
+{
+    TS_ZERO(_buckets);
+    Guard lock(RegistryMutex());
+    Registry().insert(this);
+}
+
+ts::CodeProfiler::~CodeProfiler()
+{
+    Guard lock(RegistryMutex());
+    Registry().erase(this);
+}
+
+
+//----------------------------------------------------------------------------
+// Accumulate one execution of the profiled code section.
+//----------------------------------------------------------------------------
+
+void ts::CodeProfiler::accumulate(NanoSecond duration)
+{
+    const uint64_t ns = uint64_t(std::max<NanoSecond>(0, duration));
+
+    if (_calls == 0 || ns < _min) {
+        _min = ns;
+    }
+    if (ns > _max) {
+        _max = ns;
+    }
+    _calls++;
+    _total += ns;
+
+    // Index of the histogram bucket: number of significant bits of the
+    // duration, ie. floor(log2(ns)), capped to the last bucket.
+    size_t bucket = 0;
+    for (uint64_t n = ns >> 1; n != 0 && bucket < BUCKET_COUNT - 1; n >>= 1) {
+        bucket++;
+    }
+    _buckets[bucket]++;
+}
+
+
+//----------------------------------------------------------------------------
+// Reset the accumulated figures.
+//----------------------------------------------------------------------------
+
+void ts::CodeProfiler::reset()
+{
+    _calls = 0;
+    _total = 0;
+    _min = 0;
+    _max = 0;
+    TS_ZERO(_buckets);
+}
+
+
+//----------------------------------------------------------------------------
+// Build a JSON object with the accumulated figures of this profiler.
+//----------------------------------------------------------------------------
+
+void ts::CodeProfiler::buildJSON(json::Object& obj) const
+{
+    obj.add(u"calls", json::ValuePtr(new json::Number(int64_t(_calls))));
+    obj.add(u"total-ns", json::ValuePtr(new json::Number(int64_t(_total))));
+    obj.add(u"average-ns", json::ValuePtr(new json::Number(averageNanoSeconds())));
+    obj.add(u"min-ns", json::ValuePtr(new json::Number(minimumNanoSeconds())));
+    obj.add(u"max-ns", json::ValuePtr(new json::Number(int64_t(_max))));
+
+    // Histogram of durations, truncated after the last non-empty bucket.
+    // Bucket n counts the durations in the range [2^n, 2^n+1) nano-seconds.
+    size_t count = BUCKET_COUNT;
+    while (count > 0 && _buckets[count - 1] == 0) {
+        count--;
+    }
+    const json::ValuePtr histo(new json::Array);
+    for (size_t i = 0; i < count; ++i) {
+        histo->set(json::ValuePtr(new json::Number(int64_t(_buckets[i]))));
+    }
+    obj.add(u"histogram-log2-ns", histo);
+}
+
+
+//----------------------------------------------------------------------------
+// Collect the figures of all registered profilers of the process.
+//----------------------------------------------------------------------------
+
+void ts::CodeProfiler::GetAllJSON(json::Object& root)
+{
+    Guard lock(RegistryMutex());
+    const std::set<CodeProfiler*>& registry(Registry());
+    for (std::set<CodeProfiler*>::const_iterator it = registry.begin(); it != registry.end(); ++it) {
+        json::Object* const obj = new json::Object;
+        (*it)->buildJSON(*obj);
+        root.add((*it)->name(), json::ValuePtr(obj));
+    }
+}
@@ -0,0 +1,224 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Lightweight execution time profiling of code sections.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsMonotonic.h"
+#include "tsUString.h"
+#include "tsjson.h"
+
+namespace ts {
+
+    namespace json {
+        class Object;
+    }
+
+    //!
+    //! Lightweight execution time profiling of one code section.
+    //! @ingroup cpp
+    //!
+    //! An instance of this class accumulates the execution times of one
+    //! code section, typically one hot function or one part of it. It
+    //! maintains a call count, the total, minimum and maximum durations
+    //! and a logarithmic histogram of the durations, from which outliers
+    //! and rough percentiles can be read.
+    //!
+    //! The easiest way to instrument a code section is a CodeProfiler::Scope
+    //! automatic variable. Profiling is globally disabled by default. When
+    //! disabled, an instrumented section only pays for one boolean test, so
+    //! that the instrumentation can stay in production code. Use
+    //! SetEnabled() to activate the measurements.
+    //!
+    //! All instances register themselves in a process-wide registry. The
+    //! accumulated figures of all profilers can be collected at any time as
+    //! a JSON structure using GetAllJSON(), typically on user signal or at
+    //! end of processing.
+    //!
+    //! An instance is intended to be updated by one thread at a time, like
+    //! most classes in this library. Collecting the figures from another
+    //! thread while the instrumented code is running is permitted but the
+    //! values are indicative only, they are read without synchronization.
+    //!
+    class TSDUCKDLL CodeProfiler
+    {
+        TS_NOBUILD_NOCOPY(CodeProfiler);
+    public:
+        //!
+        //! Number of buckets in the histogram of durations.
+        //! Bucket @e n counts the durations in the range [2^n, 2^n+1) nano-seconds.
+        //! The last bucket also counts all larger durations.
+        //!
+        static const size_t BUCKET_COUNT = 40;
+
+        //!
+        //! Constructor.
+        //! The profiler registers itself in the process-wide registry.
+        //! @param [in] name Name of the profiled code section, as used in reports.
+        //!
+        CodeProfiler(const UString& name);
+
+        //!
+        //! Destructor.
+        //! The profiler removes itself from the process-wide registry.
+        //!
+        ~CodeProfiler();
+
+        //!
+        //! Get the name of the profiled code section.
+        //! @return The name of the profiled code section.
+        //!
+        UString name() const { return _name; }
+
+        //!
+        //! Accumulate one execution of the profiled code section.
+        //! This is the low-level interface, see also class Scope.
+        //! @param [in] duration Execution duration in nano-seconds.
+        //!
+        void accumulate(NanoSecond duration);
+
+        //!
+        //! Get the number of accumulated executions.
+        //! @return The number of accumulated executions.
+        //!
+        uint64_t callCount() const { return _calls; }
+
+        //!
+        //! Get the total accumulated execution time in nano-seconds.
+        //! @return The total accumulated execution time in nano-seconds.
+        //!
+        NanoSecond totalNanoSeconds() const { return _total; }
+
+        //!
+        //! Get the average execution time in nano-seconds.
+        //! @return The average execution time in nano-seconds or zero when
+        //! nothing was accumulated.
+        //!
+        NanoSecond averageNanoSeconds() const { return _calls == 0 ? 0 : NanoSecond(_total / _calls); }
+
+        //!
+        //! Get the minimum execution time in nano-seconds.
+        //! @return The minimum execution time in nano-seconds or zero when
+        //! nothing was accumulated.
+        //!
+        NanoSecond minimumNanoSeconds() const { return _calls == 0 ? 0 : _min; }
+
+        //!
+        //! Get the maximum execution time in nano-seconds.
+        //! @return The maximum execution time in nano-seconds.
+        //!
+        NanoSecond maximumNanoSeconds() const { return _max; }
+
+        //!
+        //! Reset the accumulated figures.
+        //!
+        void reset();
+
+        //!
+        //! Build a JSON object with the accumulated figures of this profiler.
+        //! @param [in,out] obj The JSON object to fill.
+        //!
+        void buildJSON(json::Object& obj) const;
+
+        //!
+        //! Globally enable or disable the profiling measurements.
+        //! Profiling is disabled by default. When disabled, a Scope object
+        //! does not fetch the clock and does not accumulate anything.
+        //! @param [in] on When true, activate the measurements.
+        //!
+        static void SetEnabled(bool on) { _enabled = on; }
+
+        //!
+        //! Check if the profiling measurements are globally enabled.
+        //! @return True when the measurements are enabled.
+        //!
+        static bool GetEnabled() { return _enabled; }
+
+        //!
+        //! Collect the figures of all registered profilers of the process.
+        //! @param [in,out] root A JSON object to fill. One field is added per
+        //! registered profiler, using the profiler name, containing the same
+        //! object as built by buildJSON().
+        //!
+        static void GetAllJSON(json::Object& root);
+
+        //!
+        //! Automatic profiling of one scope of code.
+        //!
+        //! An instance of this class measures the execution time between its
+        //! construction and its destruction and accumulates it into a
+        //! CodeProfiler. Simply declare one as an automatic variable at the
+        //! top of the code section to profile.
+        //!
+        class TSDUCKDLL Scope
+        {
+            TS_NOBUILD_NOCOPY(Scope);
+        public:
+            //!
+            //! Constructor, fetch the start time when profiling is enabled.
+            //! @param [in,out] profiler The profiler where the duration is accumulated.
+            //!
+            Scope(CodeProfiler& profiler) :
+                _profiler(profiler),
+                _active(_enabled),
+                _start(_active ? Monotonic::NanoClock() : 0)
+            {
+            }
+
+            //!
+            //! Destructor, accumulate the duration of the scope.
+            //!
+            ~Scope()
+            {
+                if (_active) {
+                    _profiler.accumulate(Monotonic::NanoClock() - _start);
+                }
+            }
+
+        private:
+            CodeProfiler&    _profiler;
+            const bool       _active;  // Profiling was enabled at construction.
+            const NanoSecond _start;   // Clock value at construction.
+        };
+
+    private:
+        const UString _name;                  // Name of the profiled code section.
+        uint64_t      _calls;                 // Number of accumulated executions.
+        uint64_t      _total;                 // Total execution time (ns).
+        uint64_t      _min;                   // Minimum execution time (ns).
+        uint64_t      _max;                   // Maximum execution time (ns).
+        uint64_t      _buckets[BUCKET_COUNT]; // Logarithmic histogram of execution times.
+
+        // Global activation flag for all profilers.
+        static volatile bool _enabled;
+    };
+}
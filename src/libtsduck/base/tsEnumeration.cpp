@@ -39,12 +39,14 @@ const int ts::Enumeration::UNKNOWN = std::numeric_limits<int>::max();
 //----------------------------------------------------------------------------
 
 ts::Enumeration::Enumeration() :
-    _map()
+    _map(),
+    _lowered()
 {
 }
 
 ts::Enumeration::Enumeration(const std::initializer_list<NameValue> values) :
-    _map()
+    _map(),
+    _lowered()
 {
     for (std::initializer_list<NameValue>::const_iterator it = values.begin(); it != values.end(); ++it) {
         _map.insert(std::make_pair(it->value, it->name));
@@ -73,24 +75,31 @@ bool ts::Enumeration::operator!=(const Enumeration& other) const
 
 int ts::Enumeration::value(const UString& name, bool caseSensitive) const
 {
+    // Build the index of lowered names on first lookup. The iterators in
+    // the index remain valid since add() clears it on each insertion.
+    if (_lowered.empty() && !_map.empty()) {
+        for (EnumMap::const_iterator it = _map.begin(); it != _map.end(); ++it) {
+            _lowered.insert(std::make_pair(it->second.toLower(), it));
+        }
+    }
+
     const UString lcName(name.toLower());
     size_t previousCount = 0;
     int previous = UNKNOWN;
 
-    for (EnumMap::const_iterator it = _map.begin(); it != _map.end(); ++it) {
-        if ((caseSensitive && it->second == name) || (!caseSensitive && it->second.toLower() == lcName)) {
+    // All case-insensitive matches of the name, exact or abbreviated, are in
+    // the contiguous range of index entries starting with the lowered name.
+    for (LoweredNameMap::const_iterator it = _lowered.lower_bound(lcName); it != _lowered.end() && it->first.startWith(lcName); ++it) {
+        const UString& fullName(it->second->second);
+        if (caseSensitive ? fullName == name : it->first == lcName) {
             // Found an exact match
-            return it->first;
+            return it->second->first;
         }
-        else if (it->second.startWith(name, caseSensitive ? CASE_SENSITIVE : CASE_INSENSITIVE)) {
+        else if (!caseSensitive || fullName.startWith(name, CASE_SENSITIVE)) {
             // Found an abbreviated version
             if (++previousCount == 1) {
                 // First abbreviation, remember it and continue searching
-                previous = it->first;
-            }
-            else {
-                // Another abbreviation already found, name is ambiguous
-                break;
+                previous = it->second->first;
             }
         }
     }
@@ -131,6 +131,7 @@ namespace ts {
         void add(const UString& name, int value)
         {
             _map.insert(std::make_pair(value, name));
+            _lowered.clear();
         }
 
         //!
@@ -300,6 +301,14 @@ namespace ts {
 
     private:
         typedef std::multimap<int,UString> EnumMap;
+
+        // Index of lowered names, sorted, pointing into _map. It is built
+        // lazily on the first name lookup and cleared when an entry is added.
+        // Since the index is sorted, all case-insensitive matches of a name,
+        // exact or abbreviated, form a contiguous range.
+        typedef std::multimap<UString, EnumMap::const_iterator> LoweredNameMap;
+
         EnumMap _map;
+        mutable LoweredNameMap _lowered;
     };
 }
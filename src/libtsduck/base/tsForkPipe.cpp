@@ -301,6 +301,23 @@ bool ts::ForkPipe::open(const UString& command, WaitMode wait_mode, size_t buffe
         return false;
     }
 
+#if defined(TS_LINUX) && defined(F_SETPIPE_SZ)
+    // On Linux, enlarge the kernel pipe buffer when a size is requested.
+    // A larger buffer means fewer blocking points and larger data chunks
+    // per read() or write() system call on both sides of the pipe. This is
+    // best effort: the kernel rounds the size up to a power of two pages
+    // and clamps it to /proc/sys/fs/pipe-max-size for unprivileged users.
+    if (_use_pipe && buffer_size > 0) {
+        const int actual_size = ::fcntl(filedes[PIPE_WRITEFD], F_SETPIPE_SZ, int(buffer_size));
+        if (actual_size < 0) {
+            report.debug(u"cannot set pipe buffer size to %'d bytes: %s", {buffer_size, ErrorCodeMessage()});
+        }
+        else {
+            report.debug(u"pipe buffer size set to %'d bytes", {actual_size});
+        }
+    }
+#endif
+
     // Create the forked process
     if (_wait_mode == EXIT_PROCESS) {
         // Don't fork, the parent process will directly call exec().
@@ -98,6 +98,12 @@ void ts::Grid::setLineWidth(size_t lineWidth, size_t marginWidth)
 
 void ts::Grid::openTable()
 {
+    // When the output stream failed (a consumer reading only the start of the
+    // report closed the pipe for instance), give up formatting: the generation
+    // of the rest of the report would be pure lost work.
+    if (!_out) {
+        return;
+    }
     if (!_tableOpen) {
         _out << std::endl << _tableTop << std::endl;
         _lineCount += 2;
@@ -107,6 +113,9 @@ void ts::Grid::openTable()
 
 void ts::Grid::closeTable()
 {
+    if (!_out) {
+        return;
+    }
     if (_tableOpen) {
         _out << _tableBottom << std::endl << std::endl;
         _lineCount += 2;
@@ -117,6 +126,9 @@ void ts::Grid::closeTable()
 
 void ts::Grid::section()
 {
+    if (!_out) {
+        return;
+    }
     if (_tableOpen) {
         _out << _sectionLine << std::endl;
         _lineCount++;
@@ -125,6 +137,9 @@ void ts::Grid::section()
 
 void ts::Grid::subSection()
 {
+    if (!_out) {
+        return;
+    }
     if (_tableOpen) {
         _out << _subSectionLine << std::endl;
         _lineCount++;
@@ -138,12 +153,18 @@ void ts::Grid::subSection()
 
 void ts::Grid::putLine(const UString& line)
 {
+    if (!_out) {
+        return;
+    }
     _out << _leftMargin << line.toJustifiedLeft(_contentWidth, SPACE, true) << _rightMargin << std::endl;
     _lineCount++;
 }
 
 void ts::Grid::putMultiLine(const UString& text)
 {
+    if (!_out) {
+        return;
+    }
     UStringList lines;
     text.splitLines(lines, _contentWidth, UString(), UString(), true);
     for (UStringList::const_iterator it = lines.begin(); it != lines.end(); ++it) {
@@ -157,6 +178,9 @@ void ts::Grid::putMultiLine(const UString& text)
 
 void ts::Grid::putLine(const UString& left, const UString& right, bool oneLine)
 {
+    if (!_out) {
+        return;
+    }
     const size_t leftWidth = left.width();
     const size_t rightWidth = right.width();
 
@@ -353,6 +377,10 @@ void ts::Grid::adjustLayout()
 
 void ts::Grid::putLayout(const std::initializer_list<ColumnText> text)
 {
+    if (!_out) {
+        return;
+    }
+
     // Begin of line.
     _out << _leftMargin;
 
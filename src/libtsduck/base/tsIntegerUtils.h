@@ -104,6 +104,25 @@ namespace ts {
     template <typename INT, typename std::enable_if<std::is_integral<INT>::value && std::is_signed<INT>::value>::type* = nullptr>
     INT SignExtend(INT x, int bits);
 
+    //!
+    //! Compute the number of leading zero bits in a 64-bit value.
+    //! @param [in] x A 64-bit value. Must not be zero (the result would be undefined).
+    //! @return The number of most significant zero bits in @a x, from 0 to 63.
+    //!
+    TSDUCKDLL inline size_t CountLeadingZeroBits64(uint64_t x)
+    {
+#if defined(TS_GCC)
+        return size_t(__builtin_clzll(x));
+#else
+        size_t n = 0;
+        while ((x & TS_UCONST64(0x8000000000000000)) == 0) {
+            x <<= 1;
+            n++;
+        }
+        return n;
+#endif
+    }
+
     //!
     //! Compute the maximum width of the decimal representation of an integer type.
     //! @param [in] typeSize Size of the integer type in bytes (result of @c sizeof).
@@ -56,15 +56,19 @@ bool ts::StartsWith(const void* area, size_t area_size, const void* prefix, size
 
 const void* ts::LocatePattern(const void* area, size_t area_size, const void* pattern, size_t pattern_size)
 {
-    if (pattern_size > 0) {
+    if (pattern_size > 0 && area_size >= pattern_size) {
         const uint8_t* a = reinterpret_cast<const uint8_t*>(area);
-        const uint8_t* p = reinterpret_cast<const uint8_t*>(pattern);
-        while (area_size >= pattern_size) {
-            if (*a == *p && ::memcmp(a, p, pattern_size) == 0) {
+        const uint8_t* const p = reinterpret_cast<const uint8_t*>(pattern);
+        // Last position where the pattern may start.
+        const uint8_t* const last = a + area_size - pattern_size;
+        // Use memchr() to locate candidate positions on the first pattern
+        // byte. The libc implementation scans several bytes per iteration
+        // (SIMD or word-at-a-time), much faster than a byte loop.
+        while (a <= last && (a = reinterpret_cast<const uint8_t*>(::memchr(a, *p, last - a + 1))) != nullptr) {
+            if (pattern_size == 1 || ::memcmp(a + 1, p + 1, pattern_size - 1) == 0) {
                 return a;
             }
             ++a;
-            --area_size;
         }
     }
     return nullptr; // not found
@@ -81,13 +85,10 @@ bool ts::IdenticalBytes(const void * area, size_t area_size)
         return false;
     }
     else {
+        // Comparing the area with itself, shifted by one byte, checks that
+        // all bytes are identical using one vectorized memcmp().
         const uint8_t* d = reinterpret_cast<const uint8_t*>(area);
-        for (size_t i = 0; i < area_size - 1; ++i) {
-            if (d[i] != d[i + 1]) {
-                return false;
-            }
-        }
-        return true;
+        return ::memcmp(d, d + 1, area_size - 1) == 0;
     }
 }
 
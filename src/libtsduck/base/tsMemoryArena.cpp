@@ -0,0 +1,150 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsMemoryArena.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::MemoryArena::DEFAULT_CHUNK_SIZE;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::MemoryArena::MemoryArena(size_t chunkSize) :
+    _chunkSize(std::max<size_t>(chunkSize, 256)),
+    _allocated(0),
+    _current(allocateChunk(nullptr, _chunkSize))
+{
+}
+
+ts::MemoryArena::~MemoryArena()
+{
+    Chunk* chunk = _current;
+    while (chunk != nullptr) {
+        Chunk* const prev = chunk->prev;
+        ::operator delete(chunk);
+        chunk = prev;
+    }
+    _current = nullptr;
+}
+
+
+//----------------------------------------------------------------------------
+// Allocate a raw chunk with the given payload size.
+//----------------------------------------------------------------------------
+
+ts::MemoryArena::Chunk* ts::MemoryArena::allocateChunk(Chunk* prev, size_t size)
+{
+    // The payload follows the chunk header in the same heap allocation.
+    Chunk* const chunk = reinterpret_cast<Chunk*>(::operator new(sizeof(Chunk) + size));
+    chunk->prev = prev;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+
+//----------------------------------------------------------------------------
+// Allocate memory from the arena.
+//----------------------------------------------------------------------------
+
+void* ts::MemoryArena::allocate(size_t size, size_t alignment)
+{
+    // Align the actual address in the payload, not the offset: the payload
+    // starts right after the chunk header and is not maximally aligned.
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    uint8_t* base = reinterpret_cast<uint8_t*>(_current + 1);
+    size_t offset = ((uintptr_t(base) + _current->used + alignment - 1) & ~uintptr_t(alignment - 1)) - uintptr_t(base);
+
+    if (offset + size > _current->size) {
+        // No room in the current chunk. Oversized requests get a chunk of
+        // their own, other requests start a new standard chunk.
+        _current = allocateChunk(_current, std::max(_chunkSize, size + alignment));
+        base = reinterpret_cast<uint8_t*>(_current + 1);
+        offset = ((uintptr_t(base) + alignment - 1) & ~uintptr_t(alignment - 1)) - uintptr_t(base);
+    }
+
+    _allocated += offset - _current->used + size;
+    _current->used = offset + size;
+    return base + offset;
+}
+
+
+//----------------------------------------------------------------------------
+// Reset the arena, release all chunks but the oldest one.
+//----------------------------------------------------------------------------
+
+void ts::MemoryArena::reset()
+{
+    while (_current->prev != nullptr) {
+        Chunk* const prev = _current->prev;
+        ::operator delete(_current);
+        _current = prev;
+    }
+    _current->used = 0;
+    _allocated = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Restore the allocation state which was captured by a Scope.
+//----------------------------------------------------------------------------
+
+void ts::MemoryArena::restore(Chunk* chunk, size_t used)
+{
+    while (_current != chunk) {
+        Chunk* const prev = _current->prev;
+        ::operator delete(_current);
+        _current = prev;
+        assert(_current != nullptr);
+    }
+    _current->used = used;
+}
+
+
+//----------------------------------------------------------------------------
+// Scope which resets the arena on exit.
+//----------------------------------------------------------------------------
+
+ts::MemoryArena::Scope::Scope(MemoryArena& arena) :
+    _arena(arena),
+    _chunk(arena._current),
+    _used(arena._current->used),
+    _allocated(arena._allocated)
+{
+}
+
+ts::MemoryArena::Scope::~Scope()
+{
+    _arena.restore(reinterpret_cast<Chunk*>(_chunk), _used);
+    _arena._allocated = _allocated;
+}
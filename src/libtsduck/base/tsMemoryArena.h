@@ -0,0 +1,221 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Bump memory arena with scope-based reset.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Bump memory arena with scope-based reset.
+    //! @ingroup cpp
+    //!
+    //! A memory arena allocates memory by simply moving a pointer forward in
+    //! large chunks of memory. Individual allocations cannot be freed; the
+    //! complete arena is reset at once, either explicitly with reset() or at
+    //! the end of a Scope. This is the fastest possible allocation strategy
+    //! for groups of short-lived objects with a common lifetime, such as the
+    //! transient structures of one table or one XML document.
+    //!
+    //! A memory arena is not thread-safe. The intended usage is one arena per
+    //! thread or per processing context, which is also what keeps it fast.
+    //!
+    class TSDUCKDLL MemoryArena
+    {
+        TS_NOCOPY(MemoryArena);
+    public:
+        //!
+        //! Default size of a chunk of memory, as allocated from the heap.
+        //!
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+        //!
+        //! Constructor.
+        //! @param [in] chunkSize Size of each chunk of memory which is
+        //! allocated from the heap. Allocations larger than that get a
+        //! dedicated chunk.
+        //!
+        MemoryArena(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+        //!
+        //! Destructor. All memory of the arena is deallocated.
+        //!
+        ~MemoryArena();
+
+        //!
+        //! Allocate memory from the arena.
+        //!
+        //! The returned memory cannot be individually freed. It remains valid
+        //! until the arena is reset (beyond the enclosing Scope, if any) or
+        //! destructed.
+        //!
+        //! @param [in] size Requested size in bytes.
+        //! @param [in] alignment Requested alignment in bytes, a power of two.
+        //! @return Address of the allocated area, never null (the allocation
+        //! of a new chunk may throw std::bad_alloc, like new).
+        //!
+        void* allocate(size_t size, size_t alignment = sizeof(void*));
+
+        //!
+        //! Reset the arena.
+        //!
+        //! All previously allocated memory is released at once. The first
+        //! chunk is kept for reuse, additional chunks are returned to the heap.
+        //!
+        void reset();
+
+        //!
+        //! Get the total number of bytes allocated from the arena since the
+        //! last reset. Alignment padding is included.
+        //! @return The total number of allocated bytes.
+        //!
+        size_t allocatedBytes() const { return _allocated; }
+
+        //!
+        //! A scope which resets the arena on exit.
+        //!
+        //! All memory which is allocated from the arena during the lifetime
+        //! of the Scope object is released by its destructor. Memory which
+        //! was allocated before the Scope was entered is left untouched.
+        //! Scopes may be nested.
+        //!
+        class TSDUCKDLL Scope
+        {
+            TS_NOBUILD_NOCOPY(Scope);
+        public:
+            //!
+            //! Constructor. Record the current allocation state of the arena.
+            //! @param [in,out] arena The arena to reset on destruction.
+            //!
+            Scope(MemoryArena& arena);
+
+            //!
+            //! Destructor. Release all memory which was allocated from the
+            //! arena after the constructor.
+            //!
+            ~Scope();
+
+        private:
+            MemoryArena& _arena;      // the guarded arena
+            void*        _chunk;      // current chunk at construction
+            size_t       _used;       // used bytes in that chunk at construction
+            size_t       _allocated;  // total allocated bytes at construction
+        };
+
+    private:
+        // Chunks of memory are chained, most recent first. The payload
+        // follows the header in the same heap allocation.
+        struct Chunk
+        {
+            Chunk* prev;  // previously filled chunk
+            size_t size;  // usable payload size
+            size_t used;  // allocated payload bytes
+        };
+
+        // Private members:
+        size_t _chunkSize;  // payload size of a standard chunk
+        size_t _allocated;  // total allocated bytes since last reset
+        Chunk* _current;    // most recent chunk, never null
+
+        // Allocate a raw chunk with the given payload size.
+        static Chunk* allocateChunk(Chunk* prev, size_t size);
+
+        // Release the chunks which were allocated after the given one and
+        // restore its fill level.
+        void restore(Chunk* chunk, size_t used);
+    };
+
+    //!
+    //! Standard allocator adapter for ts::MemoryArena.
+    //! @ingroup cpp
+    //!
+    //! Allow standard containers to allocate their internal structures from
+    //! a memory arena. Deallocation is a no-op: the memory is released when
+    //! the arena is reset. The container must be destructed (or cleared and
+    //! shrunk) before the arena is reset.
+    //!
+    //! @tparam T The type of allocated objects.
+    //!
+    template <typename T>
+    class ArenaAllocator
+    {
+    public:
+        //! Standard allocator member: the type of allocated objects.
+        typedef T value_type;
+
+        //!
+        //! Constructor.
+        //! @param [in,out] arena The arena to allocate from. The arena must
+        //! remain valid as long as the allocator or the container using it.
+        //!
+        ArenaAllocator(MemoryArena& arena) noexcept : _arena(&arena) {}
+
+        //!
+        //! Conversion constructor between instantiations, a standard
+        //! requirement on allocators (containers rebind the element
+        //! allocator to their internal node types).
+        //! @tparam U The type of allocated objects of the other allocator.
+        //! @param [in] other The allocator to share the arena with.
+        //!
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept : _arena(other.arena()) {}
+
+        //!
+        //! Standard allocator member: allocate objects from the arena.
+        //! @param [in] n Number of objects to allocate.
+        //! @return Address of the allocated area.
+        //!
+        T* allocate(size_t n) { return reinterpret_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T))); }
+
+        //!
+        //! Standard allocator member: deallocation, a no-op in an arena.
+        //!
+        void deallocate(T*, size_t) noexcept {}
+
+        //!
+        //! Get the memory arena of this allocator.
+        //! @return The address of the memory arena of this allocator.
+        //!
+        MemoryArena* arena() const noexcept { return _arena; }
+
+    private:
+        MemoryArena* _arena;
+    };
+
+    //! @cond nodoxygen
+    template <typename T, typename U>
+    bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept { return a.arena() == b.arena(); }
+    template <typename T, typename U>
+    bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept { return a.arena() != b.arena(); }
+    //! @endcond
+}
@@ -0,0 +1,129 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsMemoryPool.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::MemoryPool::MemoryPool(size_t blockSize, size_t blocksPerChunk) :
+    _blockSize(std::max(((blockSize + sizeof(void*) - 1) / sizeof(void*)) * sizeof(void*), sizeof(FreeNode))),
+    _blocksPerChunk(std::max<size_t>(blocksPerChunk, 1)),
+    _freeList(nullptr),
+    _chunks(nullptr)
+{
+}
+
+ts::MemoryPool::~MemoryPool()
+{
+    // No thread shall use the pool anymore, no need to lock.
+    while (_chunks != nullptr) {
+        Chunk* const prev = _chunks->prev;
+        ::operator delete(_chunks);
+        _chunks = prev;
+    }
+    _freeList = nullptr;
+}
+
+
+//----------------------------------------------------------------------------
+// Carve a new chunk into the free list (with the lock held).
+//----------------------------------------------------------------------------
+
+void ts::MemoryPool::carveChunk()
+{
+    // Allocate and carve the chunk outside the lock: the heap allocation is
+    // the slow part and shall not make other threads spin. The blocks follow
+    // the chunk header in the same heap allocation.
+    Chunk* const chunk = reinterpret_cast<Chunk*>(::operator new(sizeof(Chunk) + _blocksPerChunk * _blockSize));
+
+    // Chain all blocks of the chunk into a local list.
+    FreeNode* head = nullptr;
+    FreeNode* tail = nullptr;
+    uint8_t* block = reinterpret_cast<uint8_t*>(chunk + 1);
+    for (size_t i = 0; i < _blocksPerChunk; ++i) {
+        FreeNode* const node = reinterpret_cast<FreeNode*>(block);
+        node->next = head;
+        head = node;
+        if (tail == nullptr) {
+            tail = node;
+        }
+        block += _blockSize;
+    }
+
+    // Splice the new blocks into the free list.
+    while (_lock.test_and_set(std::memory_order_acquire)) {
+        // Spin, the critical sections are a few instructions only.
+    }
+    chunk->prev = _chunks;
+    _chunks = chunk;
+    tail->next = _freeList;
+    _freeList = head;
+    _lock.clear(std::memory_order_release);
+}
+
+
+//----------------------------------------------------------------------------
+// Allocate and release one block.
+//----------------------------------------------------------------------------
+
+void* ts::MemoryPool::allocate()
+{
+    for (;;) {
+        while (_lock.test_and_set(std::memory_order_acquire)) {
+            // Spin, the critical sections are a few instructions only.
+        }
+        FreeNode* const node = _freeList;
+        if (node != nullptr) {
+            _freeList = node->next;
+            _lock.clear(std::memory_order_release);
+            return node;
+        }
+        _lock.clear(std::memory_order_release);
+
+        // Free list exhausted, feed it with a new chunk and retry.
+        carveChunk();
+    }
+}
+
+void ts::MemoryPool::release(void* block)
+{
+    if (block != nullptr) {
+        FreeNode* const node = reinterpret_cast<FreeNode*>(block);
+        while (_lock.test_and_set(std::memory_order_acquire)) {
+            // Spin, the critical sections are a few instructions only.
+        }
+        node->next = _freeList;
+        _freeList = node;
+        _lock.clear(std::memory_order_release);
+    }
+}
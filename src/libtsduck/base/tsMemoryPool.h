@@ -0,0 +1,200 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Thread-safe pool of fixed-size memory blocks.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Thread-safe pool of fixed-size memory blocks.
+    //! @ingroup cpp
+    //!
+    //! The pool allocates memory in large chunks from the heap and serves
+    //! fixed-size blocks from a free list. Released blocks go back to the
+    //! free list, the heap is never touched after a chunk is carved, and all
+    //! chunks are returned to the heap by the destructor only.
+    //!
+    //! The free list is protected by a spin lock, not a mutex: the critical
+    //! section is a couple of pointer moves and the lock is never held across
+    //! a system call, so contention resolves in a few cycles. (A CAS-only
+    //! free list would be exposed to the classic ABA problem on concurrent
+    //! pops; the spin lock is the simple way to be correct and stays cheap
+    //! at this critical section size.)
+    //!
+    class TSDUCKDLL MemoryPool
+    {
+        TS_NOCOPY(MemoryPool);
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] blockSize Size in bytes of each served block.
+        //! Rounded up to the size of a pointer.
+        //! @param [in] blocksPerChunk Number of blocks in each chunk of
+        //! memory which is allocated from the heap.
+        //!
+        MemoryPool(size_t blockSize, size_t blocksPerChunk = 64);
+
+        //!
+        //! Destructor. All memory of the pool is returned to the heap.
+        //! All blocks must have been released (or be no longer used).
+        //!
+        ~MemoryPool();
+
+        //!
+        //! Allocate one block from the pool.
+        //! @return Address of a block of blockSize() bytes, never null (the
+        //! allocation of a new chunk may throw std::bad_alloc, like new).
+        //!
+        void* allocate();
+
+        //!
+        //! Release one block into the pool free list.
+        //! @param [in] block Address of a block previously returned by
+        //! allocate(). Ignored when null.
+        //!
+        void release(void* block);
+
+        //!
+        //! Get the size of the served blocks.
+        //! @return The size in bytes of the served blocks.
+        //!
+        size_t blockSize() const { return _blockSize; }
+
+    private:
+        // Free blocks are chained through their first bytes.
+        struct FreeNode
+        {
+            FreeNode* next;
+        };
+
+        // Chunks of memory are chained for final deallocation.
+        struct Chunk
+        {
+            Chunk* prev;
+        };
+
+        // Private members:
+        const size_t          _blockSize;       // size of each served block
+        const size_t          _blocksPerChunk;  // blocks per heap allocation
+        std::atomic_flag      _lock = ATOMIC_FLAG_INIT;  // spin lock on the free list
+        FreeNode*             _freeList;        // head of the free block list
+        Chunk*                _chunks;          // all allocated chunks
+
+        // Allocate a new chunk and splice its blocks into the free list.
+        // Must be called without the lock held.
+        void carveChunk();
+    };
+
+    //!
+    //! Standard allocator adapter for ts::MemoryPool.
+    //! @ingroup cpp
+    //!
+    //! Allow node-based standard containers (std::list, std::map...) to
+    //! allocate their nodes from a memory pool. Allocations which do not fit
+    //! in one pool block (arrays, oversized nodes) transparently fall back
+    //! to the global operator new.
+    //!
+    //! @tparam T The type of allocated objects.
+    //!
+    template <typename T>
+    class PoolAllocator
+    {
+    public:
+        //! Standard allocator member: the type of allocated objects.
+        typedef T value_type;
+
+        //!
+        //! Constructor.
+        //! @param [in,out] pool The pool to allocate from. The pool must
+        //! remain valid as long as the allocator or the container using it.
+        //!
+        PoolAllocator(MemoryPool& pool) noexcept : _pool(&pool) {}
+
+        //!
+        //! Conversion constructor between instantiations, a standard
+        //! requirement on allocators (containers rebind the element
+        //! allocator to their internal node types).
+        //! @tparam U The type of allocated objects of the other allocator.
+        //! @param [in] other The allocator to share the pool with.
+        //!
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U>& other) noexcept : _pool(other.pool()) {}
+
+        //!
+        //! Standard allocator member: allocate objects.
+        //! @param [in] n Number of objects to allocate.
+        //! @return Address of the allocated area.
+        //!
+        T* allocate(size_t n)
+        {
+            if (n == 1 && sizeof(T) <= _pool->blockSize()) {
+                return reinterpret_cast<T*>(_pool->allocate());
+            }
+            else {
+                return reinterpret_cast<T*>(::operator new(n * sizeof(T)));
+            }
+        }
+
+        //!
+        //! Standard allocator member: deallocate objects.
+        //! @param [in] p Address of the area to deallocate.
+        //! @param [in] n Number of objects in the area.
+        //!
+        void deallocate(T* p, size_t n) noexcept
+        {
+            if (n == 1 && sizeof(T) <= _pool->blockSize()) {
+                _pool->release(p);
+            }
+            else {
+                ::operator delete(p);
+            }
+        }
+
+        //!
+        //! Get the memory pool of this allocator.
+        //! @return The address of the memory pool of this allocator.
+        //!
+        MemoryPool* pool() const noexcept { return _pool; }
+
+    private:
+        MemoryPool* _pool;
+    };
+
+    //! @cond nodoxygen
+    template <typename T, typename U>
+    bool operator==(const PoolAllocator<T>& a, const PoolAllocator<U>& b) noexcept { return a.pool() == b.pool(); }
+    template <typename T, typename U>
+    bool operator!=(const PoolAllocator<T>& a, const PoolAllocator<U>& b) noexcept { return a.pool() != b.pool(); }
+    //! @endcond
+}
@@ -0,0 +1,234 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Template lock-free multiple-producer single-consumer message queue.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+#include "tsSafePtr.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+#include "tsGuardCondition.h"
+
+namespace ts {
+    //!
+    //! Template lock-free message queue for multiple producers and one consumer.
+    //! @ingroup thread
+    //!
+    //! The ts::MessageMPSCQueue template class implements the same bounded-capacity
+    //! and timeout semantics as ts::MessageQueue but the queue itself is a lock-free
+    //! linked list of atomic pointers. Enqueueing and dequeueing a message never take
+    //! a mutex when the queue is neither full nor empty; the internal mutex and
+    //! conditions are only used to park and wake threads which have to wait.
+    //!
+    //! The restriction, compared to ts::MessageQueue, is the threading model:
+    //! any number of threads may enqueue messages but at most one thread at a
+    //! time may call dequeue(), peek() or clear(). This matches the usual usage
+    //! pattern of the message queue, a funnel into one service thread, as in
+    //! ts::AsyncReport for instance.
+    //!
+    //! @tparam MSG The type of the messages to exchange.
+    //! @tparam MUTEX The type of mutex for synchronization of message pointers (ts::Mutex by default).
+    //!
+    template <typename MSG, class MUTEX = Mutex>
+    class MessageMPSCQueue
+    {
+        TS_NOCOPY(MessageMPSCQueue);
+    public:
+        //!
+        //! Safe pointer to messages.
+        //!
+        //! Since data are copied from the producer thread into the queue and later copied
+        //! again from the queue into the consumer thread, the copied data is always a
+        //! safe-pointer to the actual message content.
+        //!
+        typedef SafePtr<MSG, MUTEX> MessagePtr;
+
+        //!
+        //! Constructor.
+        //!
+        //! @param [in] maxMessages Maximum number of messages in the queue.
+        //! When a thread attempts to enqueue a message and the queue is full,
+        //! the thread waits until at least one message is dequeued.
+        //! If @a maxMessages is 0, the queue is unlimited. In that case,
+        //! the logic of the application must ensure that the queue is
+        //! bounded somehow, otherwise the queue may exhaust all the process
+        //! memory.
+        //!
+        MessageMPSCQueue(size_t maxMessages = 0);
+
+        //!
+        //! Destructor
+        //!
+        ~MessageMPSCQueue();
+
+        //!
+        //! Get the maximum allowed messages in the queue.
+        //!
+        //! @return The maximum allowed messages in the queue (0 means unlimited).
+        //!
+        size_t getMaxMessages() const;
+
+        //!
+        //! Change the maximum allowed messages in the queue.
+        //!
+        //! @param [in] maxMessages Maximum number of messages in the queue.
+        //! When a thread attempts to enqueue a message and the queue is full,
+        //! the thread waits until at least one message is dequeued.
+        //! If @a maxMessages is 0, the queue is unlimited.
+        //!
+        void setMaxMessages(size_t maxMessages);
+
+        //!
+        //! Insert a message in the queue.
+        //!
+        //! If the queue is full, the calling thread waits until some space becomes
+        //! available in the queue or the timeout expires.
+        //!
+        //! @param [in,out] msg The message to enqueue. The ownership of the pointed object
+        //! is transfered to the message queue. Upon return, the @a msg safe pointer becomes
+        //! a null pointer if the message was successfully enqueued (no timeout).
+        //! @param [in] timeout Maximum time to wait in milliseconds.
+        //! @return True on success, false on error (queue still full after timeout).
+        //!
+        bool enqueue(MessagePtr& msg, MilliSecond timeout = Infinite);
+
+        //!
+        //! Insert a message in the queue.
+        //!
+        //! If the queue is full, the calling thread waits until some space becomes
+        //! available in the queue or the timeout expires.
+        //!
+        //! @param [in] msg A pointer to the message to enqueue. This pointer shall not
+        //! be owned by a safe pointer. When the message is successfully enqueued, the
+        //! pointer becomes owned by a safe pointer and will be deallocated when no
+        //! longer used. In case of timeout, the object is not equeued and immediately
+        //! deallocated.
+        //! @param [in] timeout Maximum time to wait in milliseconds.
+        //! @return True on success, false on error (queue still full after timeout).
+        //!
+        bool enqueue(MSG* msg, MilliSecond timeout = Infinite);
+
+        //!
+        //! Insert a message in the queue, even if the queue is full.
+        //!
+        //! This method immediately inserts the message, even if the queue is full.
+        //! This can be used to allow exceptional overflow of the queue with unique messages,
+        //! to enqueue a message to instruct the consumer thread to terminate for instance.
+        //!
+        //! @param [in,out] msg The message to enqueue. The ownership of the pointed object
+        //! is transfered to the message queue. Upon return, the @a msg safe pointer becomes
+        //! a null pointer.
+        //!
+        void forceEnqueue(MessagePtr& msg);
+
+        //!
+        //! Insert a message in the queue, even if the queue is full.
+        //!
+        //! This method immediately inserts the message, even if the queue is full.
+        //! This can be used to allow exceptional overflow of the queue with unique messages,
+        //! to enqueue a message to instruct the consumer thread to terminate for instance.
+        //!
+        //! @param [in] msg A pointer to the message to enqueue. This pointer shall not
+        //! be owned by a safe pointer. When the message is enqueued, the pointer becomes
+        //! owned by a safe pointer and will be deallocated when no longer used.
+        //!
+        void forceEnqueue(MSG* msg);
+
+        //!
+        //! Remove a message from the queue.
+        //!
+        //! Wait until a message is received or the timeout expires.
+        //! This method shall be invoked from the unique consumer thread only.
+        //!
+        //! @param [out] msg Received message.
+        //! @param [in] timeout Maximum time to wait in milliseconds.
+        //! If @a timeout is zero and the queue is empty, return immediately.
+        //! @return True on success, false on error (queue still empty after timeout).
+        //!
+        bool dequeue(MessagePtr& msg, MilliSecond timeout = Infinite);
+
+        //!
+        //! Peek the next message from the queue, without dequeueing it.
+        //!
+        //! This method shall be invoked from the unique consumer thread only.
+        //!
+        //! @return A safe pointer to the first message in the queue or a null pointer
+        //! if the queue is empty.
+        //!
+        MessagePtr peek();
+
+        //!
+        //! Clear the content of the queue.
+        //!
+        //! This method shall be invoked from the unique consumer thread only.
+        //!
+        void clear();
+
+    private:
+        // The queue is a singly linked list of nodes. Producers append at _tail
+        // using an atomic exchange, the consumer follows the links from _head.
+        // The list always contains one "stub" node so that producers never touch
+        // the consumer end: the message of the head node has already been consumed
+        // and the next message to dequeue is in the node after the head.
+        struct Node
+        {
+            std::atomic<Node*> next;
+            MessagePtr message;
+            Node() : next(nullptr), message() {}
+        };
+
+        // Private members. The mutex and conditions are only used to park threads,
+        // never to protect the queue itself.
+        mutable Mutex       _mutex;         //!< Park/wake synchronization only
+        mutable Condition   _enqueued;      //!< Signaled when some message is inserted
+        mutable Condition   _dequeued;      //!< Signaled when some message is removed
+        std::atomic<size_t> _maxMessages;   //!< Max number of messages in the queue
+        std::atomic<size_t> _curMessages;   //!< Current number of messages in the queue
+        std::atomic<size_t> _prodWaiting;   //!< Number of producers waiting for free space
+        std::atomic<bool>   _consWaiting;   //!< The consumer is waiting for a message
+        std::atomic<Node*>  _tail;          //!< Producer end of the list
+        Node*               _head;          //!< Consumer end of the list (stub node)
+
+        // Reserve one slot in the queue, waiting no longer than the timeout.
+        bool reserveSlot(MilliSecond timeout);
+
+        // Append a node at the producer end of the list and wake the consumer.
+        void pushNode(Node* node);
+
+        // Unlink the node after the head, if any, and make it the new stub.
+        // Return the dequeued message in msg. Lock-free, consumer thread only.
+        bool popNode(MessagePtr& msg);
+    };
+}
+
+#include "tsMessageMPSCQueueTemplate.h"
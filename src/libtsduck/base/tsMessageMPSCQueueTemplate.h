@@ -0,0 +1,346 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+#include "tsGuard.h"
+#include "tsTime.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+ts::MessageMPSCQueue<MSG, MUTEX>::MessageMPSCQueue(size_t maxMessages) :
+    _mutex(),
+    _enqueued(),
+    _dequeued(),
+    _maxMessages(maxMessages),
+    _curMessages(0),
+    _prodWaiting(0),
+    _consWaiting(false),
+    _tail(nullptr),
+    _head(new Node)
+{
+    // The list initially contains the stub node only.
+    _tail = _head;
+}
+
+template <typename MSG, class MUTEX>
+ts::MessageMPSCQueue<MSG, MUTEX>::~MessageMPSCQueue()
+{
+    // No thread shall use the queue anymore, delete all remaining nodes.
+    clear();
+    delete _head;
+}
+
+
+//----------------------------------------------------------------------------
+// Access max allowed messages in queue (0 means unlimited)
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+size_t ts::MessageMPSCQueue<MSG, MUTEX>::getMaxMessages() const
+{
+    return _maxMessages;
+}
+
+template <typename MSG, class MUTEX>
+void ts::MessageMPSCQueue<MSG, MUTEX>::setMaxMessages(size_t max)
+{
+    _maxMessages = max;
+}
+
+
+//----------------------------------------------------------------------------
+// Reserve one slot in the queue, waiting no longer than the timeout.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::MessageMPSCQueue<MSG, MUTEX>::reserveSlot(MilliSecond timeout)
+{
+    // Fast path: take a slot with a simple compare-and-swap, no lock.
+    size_t max = _maxMessages;
+    size_t cur = _curMessages;
+    for (;;) {
+        if (max != 0 && cur >= max) {
+            break; // queue full
+        }
+        if (_curMessages.compare_exchange_weak(cur, cur + 1)) {
+            return true;
+        }
+        // Lost the race against another thread, cur was reloaded, try again.
+    }
+
+    // The queue is full. If we cannot wait, this is an immediate failure.
+    if (timeout <= 0) {
+        return false;
+    }
+
+    // Slow path: park the thread until a message is dequeued or the timeout
+    // expires. The waiting-producer counter is modified under the protection
+    // of the mutex: the consumer signals the condition when it sees a non-zero
+    // counter after dequeueing a message.
+    GuardCondition lock(_mutex, _dequeued);
+    _prodWaiting++;
+    bool reserved = false;
+    Time start(Time::CurrentUTC());
+    for (;;) {
+
+        // Retry to take a slot.
+        max = _maxMessages;
+        cur = _curMessages;
+        while (!reserved && (max == 0 || cur < max)) {
+            reserved = _curMessages.compare_exchange_weak(cur, cur + 1);
+        }
+        if (reserved) {
+            break;
+        }
+
+        // Reduce timeout
+        if (timeout != Infinite) {
+            const Time now(Time::CurrentUTC());
+            timeout -= now - start;
+            start = now;
+            if (timeout <= 0) {
+                break; // timeout
+            }
+        }
+
+        // Wait for a message to be dequeued
+        // => temporarily release mutex and wait for dequeued condition.
+        if (!lock.waitCondition(timeout)) {
+            break; // timeout
+        }
+    }
+    _prodWaiting--;
+
+    // Final attempt, some slot may have been freed while timing out.
+    if (!reserved) {
+        max = _maxMessages;
+        cur = _curMessages;
+        while (!reserved && (max == 0 || cur < max)) {
+            reserved = _curMessages.compare_exchange_weak(cur, cur + 1);
+        }
+    }
+    return reserved;
+}
+
+
+//----------------------------------------------------------------------------
+// Append a node at the producer end of the list and wake the consumer.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+void ts::MessageMPSCQueue<MSG, MUTEX>::pushNode(Node* node)
+{
+    // Grab the producer end of the list, then link the previous tail to the
+    // new node. Between the two operations, the node is temporarily invisible
+    // to the consumer; this window closes before we check the waiting flag
+    // below, no wakeup can be lost.
+    Node* const prev = _tail.exchange(node);
+    prev->next = node;
+
+    // Wake the consumer if it is parked on an empty queue. The condition is
+    // signaled under the mutex but this happens only when the consumer waits,
+    // not on the message fast path.
+    if (_consWaiting) {
+        Guard lock(_mutex);
+        _enqueued.signal();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unlink the node after the head, if any, and make it the new stub.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::MessageMPSCQueue<MSG, MUTEX>::popNode(MessagePtr& msg)
+{
+    // The head node is the stub, the next message is in the following node.
+    Node* const next = _head->next.load();
+    if (next == nullptr) {
+        // Queue empty (or a producer has not yet linked its node, in which
+        // case that producer will wake us up right after linking it).
+        return false;
+    }
+
+    // Extract the message and recycle the node as the new stub.
+    msg = next->message;
+    next->message.clear();
+    delete _head;
+    _head = next;
+    _curMessages--;
+
+    // Wake one producer if some are parked on a full queue.
+    if (_prodWaiting != 0) {
+        Guard lock(_mutex);
+        _dequeued.signal();
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Insert a message in the queue with a timeout.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::MessageMPSCQueue<MSG, MUTEX>::enqueue(MessagePtr& msg, MilliSecond timeout)
+{
+    if (!reserveSlot(timeout)) {
+        // Timeout, queue still full.
+        return false;
+    }
+    // Transfer ownership of the pointed object into a new node.
+    Node* const node = new Node;
+    node->message = msg.release();
+    pushNode(node);
+    return true;
+}
+
+template <typename MSG, class MUTEX>
+bool ts::MessageMPSCQueue<MSG, MUTEX>::enqueue(MSG* msg, MilliSecond timeout)
+{
+    if (!reserveSlot(timeout)) {
+        // Timeout, queue still full. Deallocated the message.
+        delete msg;
+        return false;
+    }
+    Node* const node = new Node;
+    node->message = msg;
+    pushNode(node);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Insert a message in the queue, even if the queue is full.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+void ts::MessageMPSCQueue<MSG, MUTEX>::forceEnqueue(MessagePtr& msg)
+{
+    // Take a slot without checking the maximum, allowing a transient overflow.
+    _curMessages++;
+    Node* const node = new Node;
+    node->message = msg.release();
+    pushNode(node);
+}
+
+template <typename MSG, class MUTEX>
+void ts::MessageMPSCQueue<MSG, MUTEX>::forceEnqueue(MSG* msg)
+{
+    _curMessages++;
+    Node* const node = new Node;
+    node->message = msg;
+    pushNode(node);
+}
+
+
+//----------------------------------------------------------------------------
+// Remove a message from the queue.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::MessageMPSCQueue<MSG, MUTEX>::dequeue(MessagePtr& msg, MilliSecond timeout)
+{
+    // Fast path: a message is available, no lock.
+    if (popNode(msg)) {
+        return true;
+    }
+    if (timeout <= 0) {
+        return false;
+    }
+
+    // Slow path: park the thread until a message is enqueued or the timeout
+    // expires. The waiting-consumer flag is set under the protection of the
+    // mutex: a producer signals the condition when it sees the flag set after
+    // enqueueing a message.
+    GuardCondition lock(_mutex, _enqueued);
+    _consWaiting = true;
+    bool found = false;
+    Time start(Time::CurrentUTC());
+    for (;;) {
+
+        // Retry to dequeue a message.
+        if (popNode(msg)) {
+            found = true;
+            break;
+        }
+
+        // Reduce timeout
+        if (timeout != Infinite) {
+            const Time now(Time::CurrentUTC());
+            timeout -= now - start;
+            start = now;
+            if (timeout <= 0) {
+                break; // timeout
+            }
+        }
+
+        // Wait for a message to be enqueued
+        // => temporarily release mutex and wait for enqueued condition.
+        if (!lock.waitCondition(timeout)) {
+            break; // timeout
+        }
+    }
+    _consWaiting = false;
+
+    // Final attempt, a message may have been enqueued while timing out.
+    return found || popNode(msg);
+}
+
+
+//----------------------------------------------------------------------------
+// Peek the next message from the queue, without dequeueing it.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+typename ts::MessageMPSCQueue<MSG, MUTEX>::MessagePtr ts::MessageMPSCQueue<MSG, MUTEX>::peek()
+{
+    Node* const next = _head->next.load();
+    return next == nullptr ? MessagePtr() : next->message;
+}
+
+
+//----------------------------------------------------------------------------
+// Clear the queue.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+void ts::MessageMPSCQueue<MSG, MUTEX>::clear()
+{
+    MessagePtr msg;
+    while (popNode(msg)) {
+        msg.clear();
+    }
+}
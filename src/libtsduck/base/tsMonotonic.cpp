@@ -35,6 +35,10 @@
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
 
+#if defined(TS_LINUX)
+#include <sys/timerfd.h>
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructors and destructors.
@@ -44,6 +48,8 @@ ts::Monotonic::Monotonic(bool systemTime) :
     _value(0)
 #if defined(TS_WINDOWS)
     , _handle(INVALID_HANDLE_VALUE)
+#elif defined(TS_LINUX)
+    , _timerfd(-1)
 #endif
 {
 #if defined(TS_WINDOWS)
@@ -66,6 +72,10 @@ ts::Monotonic::~Monotonic()
 {
 #if defined(TS_WINDOWS)
     ::CloseHandle(_handle);
+#elif defined(TS_LINUX)
+    if (_timerfd >= 0) {
+        ::close(_timerfd);
+    }
 #endif
 }
 
@@ -104,6 +114,69 @@ void ts::Monotonic::getSystemTime()
 }
 
 
+//----------------------------------------------------------------------------
+// Get system time value from the coarse clock.
+//----------------------------------------------------------------------------
+
+void ts::Monotonic::getSystemTimeCoarse()
+{
+#if defined(TS_LINUX) && defined(CLOCK_MONOTONIC_COARSE)
+    // Same epoch as CLOCK_MONOTONIC, tick resolution, no system call.
+    _value = Time::UnixClockNanoSeconds(CLOCK_MONOTONIC_COARSE);
+#else
+    // No coarse clock on this system, use the standard one.
+    getSystemTime();
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Fast high-resolution timestamp, for profiling and performance metrics.
+//----------------------------------------------------------------------------
+
+#if defined(TS_WINDOWS)
+namespace {
+    // Get the frequency of the Windows performance counter.
+    int64_t GetQPCFrequency()
+    {
+        ::LARGE_INTEGER freq;
+        ::QueryPerformanceFrequency(&freq);
+        return int64_t(freq.QuadPart);
+    }
+}
+#endif
+
+ts::NanoSecond ts::Monotonic::NanoClock()
+{
+#if defined(TS_WINDOWS)
+
+    // The performance counter frequency is fixed at boot time, get it once.
+    static const int64_t frequency = GetQPCFrequency();
+
+    ::LARGE_INTEGER counter;
+    ::QueryPerformanceCounter(&counter);
+
+    // Split the conversion to avoid an intermediate overflow: the counter
+    // value times one billion does not fit in 64 bits after a few minutes.
+    const int64_t ticks = int64_t(counter.QuadPart);
+    return NanoSecond(ticks / frequency) * NanoSecPerSec + (NanoSecond(ticks % frequency) * NanoSecPerSec) / frequency;
+
+#elif defined(TS_MAC)
+
+    // Same clock as getSystemTime() on macOS.
+    return Time::UnixClockNanoSeconds(CLOCK_REALTIME);
+
+#elif defined(TS_UNIX)
+
+    // CLOCK_MONOTONIC is read from the vDSO on Linux, no kernel entry.
+    return Time::UnixClockNanoSeconds(CLOCK_MONOTONIC);
+
+#else
+    #error "Unimplemented operating system"
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Wait until the time of the monotonic clock.
 //----------------------------------------------------------------------------
@@ -171,6 +244,53 @@ void ts::Monotonic::wait()
 }
 
 
+//----------------------------------------------------------------------------
+// Arm an OS waitable timer at the time of the monotonic clock.
+//----------------------------------------------------------------------------
+
+#if defined(TS_WINDOWS) || defined(TS_LINUX)
+void ts::Monotonic::armTimer()
+{
+#if defined(TS_WINDOWS)
+
+    // The waitable timer handle is created in the constructor.
+    ::LARGE_INTEGER due_time;
+    due_time.QuadPart = _value;
+    if (::SetWaitableTimer(_handle, &due_time, 0, NULL, NULL, FALSE) == 0) {
+        throw MonotonicError(::GetLastError());
+    }
+
+#else
+
+    // Create the timer file descriptor the first time. It uses the same
+    // CLOCK_MONOTONIC as getSystemTime() and wait(). Non-blocking so that
+    // a spurious read in an event loop never blocks.
+    if (_timerfd < 0 && (_timerfd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0) {
+        throw MonotonicError(u"timerfd_create error", errno);
+    }
+
+    // Absolute due time. A zero itimerspec would disarm the timer, make sure
+    // a due time in the past or at the epoch still fires immediately.
+    ::itimerspec due;
+    due.it_interval.tv_sec = 0;
+    due.it_interval.tv_nsec = 0;
+    if (_value <= 0) {
+        due.it_value.tv_sec = 0;
+        due.it_value.tv_nsec = 1;
+    }
+    else {
+        due.it_value.tv_sec = time_t(_value / NanoSecPerSec);
+        due.it_value.tv_nsec = long(_value % NanoSecPerSec);
+    }
+    if (::timerfd_settime(_timerfd, TFD_TIMER_ABSTIME, &due, nullptr) < 0) {
+        throw MonotonicError(u"timerfd_settime error", errno);
+    }
+
+#endif
+}
+#endif
+
+
 //----------------------------------------------------------------------------
 // This static method requests a minimum resolution, in nano-seconds, for the
 // timers. Return the guaranteed value (can be equal to or greater than the
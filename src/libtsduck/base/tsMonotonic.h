@@ -72,6 +72,34 @@ namespace ts {
         //!
         void getSystemTime();
 
+        //!
+        //! Load this object with the current system time, using the coarse clock.
+        //! On Linux, this reads CLOCK_MONOTONIC_COARSE which is maintained by the
+        //! kernel in a memory page which is shared with the process (vDSO), without
+        //! system call. The resolution is the kernel tick, typically 1 to 4
+        //! milliseconds, instead of a nanosecond, but reading it is much cheaper.
+        //! This is the right clock for timestamping and rate computations which
+        //! are performed once per packet or per packet window. Both clocks share
+        //! the same epoch but, because of the lower resolution, do not use the
+        //! coarse value as a due time for wait() or armTimer(). On systems
+        //! without a coarse clock, this is identical to getSystemTime().
+        //!
+        void getSystemTimeCoarse();
+
+        //!
+        //! Fast high-resolution timestamp, for profiling and performance metrics.
+        //! The returned value is a number of nano-seconds from an arbitrary
+        //! origin, only differences between two values are meaningful. Unlike
+        //! creating a Monotonic instance, no operating system resource is
+        //! allocated (on Windows, each Monotonic object creates a waitable
+        //! timer handle, which is far too expensive per measurement). On Linux,
+        //! the clock is read through the vDSO, without entering the kernel,
+        //! and is based on the TSC when the hardware time stamp counter is
+        //! reliable.
+        //! @return The current value of the high-resolution clock in nano-seconds.
+        //!
+        static NanoSecond NanoClock();
+
         //!
         //! Assigment operator.
         //! @param [in] t Another instance to copy.
@@ -177,6 +205,31 @@ namespace ts {
         //!
         void wait();
 
+#if defined(TS_WINDOWS) || defined(TS_LINUX) || defined(DOXYGEN)
+        //!
+        //! Arm an OS waitable timer at the time of the monotonic clock (Windows and Linux only).
+        //! The handle which is returned by timerHandle() becomes signaled at the due time.
+        //! Unlike wait(), this does not block: the handle can be placed in an event
+        //! loop (WaitForMultipleObjects, poll, epoll) together with sockets or other
+        //! handles. On Linux, the handle is a timerfd: after it becomes readable,
+        //! read 8 bytes from it to clear the expiration before re-arming.
+        //! @see timerHandle()
+        //!
+        void armTimer();
+
+        //!
+        //! Get the OS handle of the waitable timer (Windows and Linux only).
+        //! On Linux, the handle is created by the first call to armTimer() and
+        //! remains invalid (-1) before that.
+        //! @return The OS timer handle, signaled at the due time after armTimer().
+        //!
+#if defined(TS_WINDOWS)
+        ::HANDLE timerHandle() const { return _handle; }
+#else
+        int timerHandle() const { return _timerfd; }
+#endif
+#endif
+
         //!
         //! This static method requests a minimum resolution, in nano-seconds, for the timers.
         //! @param [in] precision Requested minimum resolution in nano-seconds.
@@ -200,6 +253,11 @@ namespace ts {
 #else
         // On POSIX systems, the clock unit is the nanosecond.
         static const int64_t NS_PER_TICK = 1;
+
+#if defined(TS_LINUX)
+        // Pollable timer file descriptor, lazily created by armTimer().
+        int _timerfd;
+#endif
 #endif
     };
 }
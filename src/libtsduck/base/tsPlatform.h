@@ -834,12 +834,15 @@ TS_MSC_NOWARNING(5027)
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/wait.h>
+#include <sys/uio.h>
 #include <sys/socket.h>
 #include <netdb.h>
 #include <net/if.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
 #include <netinet/tcp.h>
 #include <unistd.h>
+#include <poll.h>
 #include <time.h>
 #include <glob.h>
 #include <pthread.h>
@@ -854,6 +857,9 @@ TS_MSC_NOWARNING(5027)
 #if defined(TS_LINUX)
 #include <limits.h>
 #include <sys/mman.h>
+#include <sys/inotify.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
 #include <byteswap.h>
 #include <linux/dvb/version.h>
 #include <linux/dvb/frontend.h>
@@ -863,6 +869,7 @@ TS_MSC_NOWARNING(5027)
 
 #if defined(TS_MAC)
 #include <sys/mman.h>
+#include <sys/event.h>
 #include <libproc.h>
 #endif
 
@@ -892,6 +899,7 @@ TS_MSC_NOWARNING(5027)
 #include <iostream>
 #include <exception>
 #include <typeinfo>
+#include <atomic>
 
 #include <cassert>
 #include <cstdlib>
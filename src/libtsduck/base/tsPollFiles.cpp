@@ -51,11 +51,34 @@ ts::PollFiles::PollFiles(const UString& wildcard,
     _min_stable_delay(min_stable_delay),
     _listener(listener),
     _polled_files(),
-    _notified_files()
+    _notified_files(),
+    _watch_dir()
+#if defined(TS_LINUX)
+    ,
+    _watch_fd(-1),
+    _watch_wd(-1)
+#elif defined(TS_MAC)
+    ,
+    _queue_fd(-1),
+    _dir_fd(-1)
+#elif defined(TS_WINDOWS)
+    ,
+    _watch_handle(INVALID_HANDLE_VALUE)
+#endif
 {
 }
 
 
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+ts::PollFiles::~PollFiles()
+{
+    closeWatch();
+}
+
+
 //----------------------------------------------------------------------------
 // Poll files continuously until the listener asks to terminate.
 //----------------------------------------------------------------------------
@@ -66,9 +89,37 @@ void ts::PollFiles::pollRepeatedly()
 
     // Loop on poll for files.
     while (pollOnce()) {
-        // Wait until next poll
-        SleepThread(_poll_interval);
+
+        // Watch the polled directory for changes. The listener may have
+        // redirected the wildcard to another directory, recreate the watch
+        // in that case.
+        const UString dir(DirectoryName(_files_wildcard));
+        if (dir != _watch_dir) {
+            closeWatch();
+            _watch_dir = dir;
+            openWatch();
+        }
+
+        // When a file waits for its stability delay, rescan after that delay
+        // even without new change notification.
+        MilliSecond timeout = _poll_interval;
+        if (_min_stable_delay < timeout) {
+            for (PolledFileList::const_iterator it = _polled_files.begin(); it != _polled_files.end(); ++it) {
+                if ((*it)->_pending) {
+                    timeout = std::max<MilliSecond>(_min_stable_delay, 1);
+                    break;
+                }
+            }
+        }
+
+        // Wait until next poll. With a native directory watch, an actual
+        // change triggers an immediate rescan and the poll interval is only
+        // a safety net rescan period (notification queues can overflow).
+        waitWatch(timeout);
     }
+
+    closeWatch();
+    _watch_dir.clear();
 }
 
 
@@ -172,3 +223,145 @@ void ts::PollFiles::deleteFile(PolledFileList::iterator& polled)
     _notified_files.push_back(*polled);
     polled = _polled_files.erase(polled);
 }
+
+
+//----------------------------------------------------------------------------
+// Create the native change notification on the polled directory.
+//----------------------------------------------------------------------------
+
+bool ts::PollFiles::openWatch()
+{
+    if (_watch_dir.empty()) {
+        return false;
+    }
+
+#if defined(TS_LINUX)
+
+    if ((_watch_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0) {
+        _report.debug(u"PollFiles: inotify_init failed: %s", {ErrorCodeMessage(LastErrorCode())});
+        return false;
+    }
+    _watch_wd = ::inotify_add_watch(_watch_fd, _watch_dir.toUTF8().c_str(),
+                                    IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_MOVED_TO | IN_MOVED_FROM);
+    if (_watch_wd < 0) {
+        _report.debug(u"PollFiles: cannot watch directory %s: %s", {_watch_dir, ErrorCodeMessage(LastErrorCode())});
+        ::close(_watch_fd);
+        _watch_fd = -1;
+        return false;
+    }
+    _report.debug(u"PollFiles: watching directory %s with inotify", {_watch_dir});
+    return true;
+
+#elif defined(TS_MAC)
+
+    if ((_dir_fd = ::open(_watch_dir.toUTF8().c_str(), O_EVTONLY)) < 0) {  // Flawfinder: ignore
+        _report.debug(u"PollFiles: cannot open directory %s: %s", {_watch_dir, ErrorCodeMessage(LastErrorCode())});
+        return false;
+    }
+    if ((_queue_fd = ::kqueue()) < 0) {
+        _report.debug(u"PollFiles: kqueue failed: %s", {ErrorCodeMessage(LastErrorCode())});
+        ::close(_dir_fd);
+        _dir_fd = -1;
+        return false;
+    }
+    struct kevent ev;
+    EV_SET(&ev, _dir_fd, EVFILT_VNODE, EV_ADD | EV_CLEAR, NOTE_WRITE | NOTE_EXTEND | NOTE_ATTRIB | NOTE_DELETE | NOTE_RENAME, 0, nullptr);
+    if (::kevent(_queue_fd, &ev, 1, nullptr, 0, nullptr) < 0) {
+        _report.debug(u"PollFiles: cannot watch directory %s: %s", {_watch_dir, ErrorCodeMessage(LastErrorCode())});
+        closeWatch();
+        return false;
+    }
+    _report.debug(u"PollFiles: watching directory %s with kqueue", {_watch_dir});
+    return true;
+
+#elif defined(TS_WINDOWS)
+
+    _watch_handle = ::FindFirstChangeNotification(_watch_dir.toUTF8().c_str(), FALSE,
+                                                  FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+    if (_watch_handle == INVALID_HANDLE_VALUE) {
+        _report.debug(u"PollFiles: cannot watch directory %s: %s", {_watch_dir, ErrorCodeMessage(LastErrorCode())});
+        return false;
+    }
+    _report.debug(u"PollFiles: watching directory %s for change notifications", {_watch_dir});
+    return true;
+
+#else
+
+    return false;
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Close the native change notification.
+//----------------------------------------------------------------------------
+
+void ts::PollFiles::closeWatch()
+{
+#if defined(TS_LINUX)
+    if (_watch_fd >= 0) {
+        ::close(_watch_fd);
+        _watch_fd = -1;
+        _watch_wd = -1;
+    }
+#elif defined(TS_MAC)
+    if (_queue_fd >= 0) {
+        ::close(_queue_fd);
+        _queue_fd = -1;
+    }
+    if (_dir_fd >= 0) {
+        ::close(_dir_fd);
+        _dir_fd = -1;
+    }
+#elif defined(TS_WINDOWS)
+    if (_watch_handle != INVALID_HANDLE_VALUE) {
+        ::FindCloseChangeNotification(_watch_handle);
+        _watch_handle = INVALID_HANDLE_VALUE;
+    }
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Wait for a change notification or the timeout.
+//----------------------------------------------------------------------------
+
+void ts::PollFiles::waitWatch(MilliSecond timeout)
+{
+#if defined(TS_LINUX)
+    if (_watch_fd >= 0) {
+        ::pollfd pfd;
+        pfd.fd = _watch_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (::poll(&pfd, 1, int(timeout)) > 0) {
+            // Drain all queued events. Their content does not matter, the
+            // next scan of the directory is the source of truth.
+            char buffer[4096];
+            while (::read(_watch_fd, buffer, sizeof(buffer)) > 0) {  // Flawfinder: ignore
+            }
+        }
+        return;
+    }
+#elif defined(TS_MAC)
+    if (_queue_fd >= 0) {
+        struct kevent ev;
+        struct timespec tmo;
+        tmo.tv_sec = time_t(timeout / MilliSecPerSec);
+        tmo.tv_nsec = long((timeout % MilliSecPerSec) * NanoSecPerMilliSec);
+        ::kevent(_queue_fd, nullptr, 0, &ev, 1, &tmo);
+        return;
+    }
+#elif defined(TS_WINDOWS)
+    if (_watch_handle != INVALID_HANDLE_VALUE) {
+        if (::WaitForSingleObject(_watch_handle, ::DWORD(timeout)) == WAIT_OBJECT_0) {
+            ::FindNextChangeNotification(_watch_handle);
+        }
+        return;
+    }
+#endif
+
+    // No native watch available, sleep until the next periodic scan.
+    SleepThread(timeout);
+}
@@ -74,6 +74,11 @@ namespace ts {
                   MilliSecond min_stable_delay = DEFAULT_MIN_STABLE_DELAY,
                   Report& report = CERR);
 
+        //!
+        //! Destructor.
+        //!
+        ~PollFiles();
+
         //!
         //! Set a new file wildcard specification to poll.
         //! @param [in] wildcard Wildcard specification of files to poll (eg "/path/to/*.dat").
@@ -104,6 +109,12 @@ namespace ts {
         //! Poll files continuously until the listener asks to terminate.
         //! Invoke the listener each time something has changed.
         //! The first time, all files are reported as "added".
+        //! When the system supports it (inotify on Linux, kqueue on macOS,
+        //! directory change notifications on Windows), a watch is set on the
+        //! polled directory and each scan is triggered by an actual change
+        //! instead of waking up and stating every file at each poll interval.
+        //! The poll interval then only acts as a safety net rescan period and
+        //! the notification latency drops to the minimum stability delay.
         //!
         void pollRepeatedly();
 
@@ -122,7 +133,27 @@ namespace ts {
         PolledFileList     _polled_files;   // Updated at each poll, sorted by file name
         PolledFileList     _notified_files; // Modifications to notify
 
+        // Native change notification on the polled directory, used by
+        // pollRepeatedly() to trigger the scans instead of a fixed sleep.
+        UString  _watch_dir;     // Currently watched directory.
+#if defined(TS_LINUX)
+        int      _watch_fd;      // inotify descriptor.
+        int      _watch_wd;      // inotify watch descriptor on the directory.
+#elif defined(TS_MAC)
+        int      _queue_fd;      // kqueue descriptor.
+        int      _dir_fd;        // Watched directory descriptor.
+#elif defined(TS_WINDOWS)
+        ::HANDLE _watch_handle;  // Directory change notification handle.
+#endif
+
         // Mark a file as deleted, move from polled to notified files.
         void deleteFile(PolledFileList::iterator&);
+
+        // Manage the native directory watch. waitWatch() returns after a
+        // change notification or the timeout, or simply sleeps when no
+        // native watch is available.
+        bool openWatch();
+        void closeWatch();
+        void waitWatch(MilliSecond timeout);
     };
 }
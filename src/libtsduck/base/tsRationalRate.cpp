@@ -0,0 +1,98 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsRationalRate.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Clear the rate, the rate is zero.
+//----------------------------------------------------------------------------
+
+void ts::RationalRate::clear()
+{
+    _num = 0;
+    _den = 0;
+    _magic = 0;
+    _shift = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Set the rate and precompute the reciprocal of the denominator.
+//----------------------------------------------------------------------------
+
+void ts::RationalRate::set(int64_t numerator, int64_t denominator)
+{
+    if (numerator < 0 || denominator <= 0) {
+        // Invalid fraction, scale() will return zero.
+        clear();
+        return;
+    }
+
+    _num = numerator;
+    _den = denominator;
+
+    const uint64_t den = uint64_t(denominator);
+    if ((den & (den - 1)) == 0) {
+        // The denominator is one or a power of two, a plain shift is enough.
+        _magic = 0;
+        _shift = 0;
+        while ((TS_UCONST64(1) << _shift) < den) {
+            _shift++;
+        }
+        return;
+    }
+
+    // General case, the classical round-up reciprocal (Granlund-Montgomery).
+    // With l = ceiling(log2(den)), magic = floor(2^(63+l) / den) + 1 and a
+    // right shift of l-1 after the upper multiplication, the result of
+    // scale() is exact for any dividend below 2^63. Since den is not a
+    // power of two, 2^(l-1) < den < 2^l and magic always fits in 64 bits.
+    int l = 1;
+    while ((TS_UCONST64(1) << l) < den) {
+        l++;
+    }
+
+    // Long division of 2^(63+l) by den, bit by bit, to avoid requiring
+    // 128-bit arithmetic. This is done once per rate change only.
+    uint64_t quotient = 0;
+    uint64_t remainder = 1;
+    for (int bit = 0; bit < 63 + l; bit++) {
+        remainder <<= 1;
+        quotient <<= 1;
+        if (remainder >= den) {
+            remainder -= den;
+            quotient |= 1;
+        }
+    }
+
+    _magic = quotient + 1;
+    _shift = l - 1;
+}
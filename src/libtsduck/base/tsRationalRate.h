@@ -0,0 +1,179 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Rational rate with division-free scaling.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+#if defined(TS_MSC)
+#include <intrin.h>
+#endif
+
+namespace ts {
+    //!
+    //! Rational rate with division-free scaling.
+    //! @ingroup cpp
+    //!
+    //! A RationalRate represents a non-negative rate as a fraction
+    //! @e numerator / @e denominator. The typical usage pattern is a rate
+    //! which remains constant over many operations, for instance a bitrate
+    //! which is updated only when a new PCR is received while packets are
+    //! processed at a much higher frequency.
+    //!
+    //! When the fraction is set, the reciprocal of the denominator is
+    //! precomputed as a multiply-and-shift pair. The scale() operation,
+    //! computing @e count * @e numerator / @e denominator, then uses only
+    //! multiplications and shifts, never a division. On processors where
+    //! 64-bit integer division is microcoded (most ARM cores for instance),
+    //! this noticeably reduces the cost of steady-state rate computations.
+    //!
+    //! The result of scale() is mathematically exact, identical to the
+    //! truncating integer division, as long as the product
+    //! @e count * @e numerator fits into a signed 64-bit integer. It is the
+    //! responsibility of the caller to guarantee this range, exactly as with
+    //! a plain division expression.
+    //!
+    class TSDUCKDLL RationalRate
+    {
+    public:
+        //!
+        //! Default constructor, the rate is zero.
+        //!
+        RationalRate() :
+            _num(0),
+            _den(0),
+            _magic(0),
+            _shift(0)
+        {
+        }
+
+        //!
+        //! Constructor from a fraction.
+        //! @param [in] numerator Numerator of the rate.
+        //! @param [in] denominator Denominator of the rate.
+        //! @see set()
+        //!
+        RationalRate(int64_t numerator, int64_t denominator) :
+            RationalRate()
+        {
+            set(numerator, denominator);
+        }
+
+        //!
+        //! Set the rate from a fraction and precompute the reciprocal
+        //! of the denominator.
+        //! When @a numerator is negative or @a denominator is zero or
+        //! negative, the rate is cleared and scale() always returns zero.
+        //! @param [in] numerator Numerator of the rate.
+        //! @param [in] denominator Denominator of the rate.
+        //!
+        void set(int64_t numerator, int64_t denominator);
+
+        //!
+        //! Clear the rate, the rate is zero.
+        //!
+        void clear();
+
+        //!
+        //! Get the numerator of the rate.
+        //! @return The numerator of the rate.
+        //!
+        int64_t numerator() const { return _num; }
+
+        //!
+        //! Get the denominator of the rate.
+        //! @return The denominator of the rate, zero when the rate is cleared.
+        //!
+        int64_t denominator() const { return _den; }
+
+        //!
+        //! Scale a count by the rate, without division.
+        //! @param [in] count Number of units to scale, a non-negative value.
+        //! The product @a count * numerator() must fit into an int64_t.
+        //! @return The value @a count * numerator() / denominator(), with
+        //! truncation, exactly as the equivalent integer division. Return
+        //! zero when @a count is negative or the rate is cleared.
+        //!
+        int64_t scale(int64_t count) const
+        {
+            if (_den == 0 || count <= 0) {
+                return 0;
+            }
+            const uint64_t prod = uint64_t(count) * uint64_t(_num);
+            if (_magic == 0) {
+                // The denominator is one or a power of two.
+                return int64_t(prod >> _shift);
+            }
+            else {
+                return int64_t(mulhi(prod, _magic) >> _shift);
+            }
+        }
+
+        //!
+        //! Get the rate value as an integer.
+        //! @return The value numerator() / denominator(), with truncation.
+        //!
+        int64_t toInt() const { return scale(1); }
+
+    private:
+        int64_t  _num;    // Numerator.
+        int64_t  _den;    // Denominator, zero when the rate is cleared.
+        uint64_t _magic;  // Reciprocal of _den, zero when _den is a power of two.
+        int      _shift;  // Right shift after the multiplication.
+
+        // Upper 64 bits of the product of two unsigned 64-bit integers.
+        static inline uint64_t mulhi(uint64_t a, uint64_t b)
+        {
+#if defined(DOXYGEN)
+            return 0;
+#elif defined(__SIZEOF_INT128__)
+            // GCC and clang, the canonical form which compiles to one
+            // mulh-style instruction on all 64-bit processors. The
+            // __extension__ keyword keeps -Wpedantic quiet about __int128.
+            __extension__ typedef unsigned __int128 uint128_t;
+            return uint64_t((uint128_t(a) * uint128_t(b)) >> 64);
+#elif defined(TS_MSC) && (defined(TS_X86_64) || defined(TS_ARM64))
+            return __umulh(a, b);
+#else
+            // Portable version using 32-bit half-products.
+            const uint64_t al = a & 0xFFFFFFFF;
+            const uint64_t ah = a >> 32;
+            const uint64_t bl = b & 0xFFFFFFFF;
+            const uint64_t bh = b >> 32;
+            const uint64_t mid1 = (ah * bl) + ((al * bl) >> 32);
+            const uint64_t mid2 = (al * bh) + (mid1 & 0xFFFFFFFF);
+            return (ah * bh) + (mid1 >> 32) + (mid2 >> 32);
+#endif
+        }
+    };
+}
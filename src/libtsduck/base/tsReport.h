@@ -339,3 +339,39 @@ namespace ts {
         volatile bool _got_errors;
     };
 }
+
+//!
+//! @hideinitializer
+//! Report a message with an explicit severity, without evaluating disabled arguments.
+//!
+//! With the Report::log() family of methods, the argument expressions are evaluated
+//! and marshalled at the call site before the severity check. This is harmless for
+//! occasional messages but not inside per-packet loops where a disabled debug
+//! statement should cost one comparison only. This macro checks the severity first
+//! and does not evaluate the format and arguments when the message is dropped.
+//!
+//! @param report An expression of class Report (reference or object).
+//! @param severity Message severity.
+//!
+#define TS_LOG(report, severity, ...)                      \
+    do {                                                   \
+        if (int(severity) <= (report).maxSeverity()) {     \
+            (report).log((severity), __VA_ARGS__);         \
+        }                                                  \
+    } while (false)
+
+//!
+//! @hideinitializer
+//! Report a debug message, without evaluating the arguments when debug is disabled.
+//! @param report An expression of class Report (reference or object).
+//! @see TS_LOG()
+//!
+#define TS_DEBUG(report, ...) TS_LOG((report), ts::Severity::Debug, __VA_ARGS__)
+
+//!
+//! @hideinitializer
+//! Report a verbose message, without evaluating the arguments in non-verbose mode.
+//! @param report An expression of class Report (reference or object).
+//! @see TS_LOG()
+//!
+#define TS_VERBOSE(report, ...) TS_LOG((report), ts::Severity::Verbose, __VA_ARGS__)
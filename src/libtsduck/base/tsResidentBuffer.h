@@ -51,8 +51,17 @@ namespace ts {
         //! Abort application if memory allocation fails.
         //! Do not abort if memory locking fails.
         //! @param [in] elem_count Number of @a T elements.
+        //! @param [in] huge_pages Try to allocate the buffer from explicit huge
+        //! pages to reduce TLB misses on very large buffers (Linux only). When
+        //! no huge page can be allocated, silently fall back to transparent
+        //! huge pages when supported and then to normal pages.
+        //! @param [in] extra_bytes Size of an optional extra area which is
+        //! allocated and locked together with the element array, in the same
+        //! memory region, right after the elements. Use extraBase() to locate
+        //! it. This avoids a separate allocation (and a separate locked
+        //! region) for auxiliary per-element data.
         //!
-        ResidentBuffer(size_t elem_count);
+        ResidentBuffer(size_t elem_count, bool huge_pages = false, size_t extra_bytes = 0);
 
         //!
         //! Destructor.
@@ -68,6 +77,15 @@ namespace ts {
             return _is_locked;
         }
 
+        //!
+        //! Check if the buffer is backed by explicit huge pages.
+        //! @return True if the buffer was allocated from explicit huge pages.
+        //!
+        bool isHugePageBacked() const
+        {
+            return _is_huge;
+        }
+
         //!
         //! Get error code when not locked
         //! @return The system error code when locking failed.
@@ -95,14 +113,28 @@ namespace ts {
             return _elem_count;
         }
 
+        //!
+        //! Return the address of the extra area following the elements.
+        //! The extra area is aligned on the size of a pointer.
+        //! @return The address of the extra area or a null pointer when the
+        //! buffer was allocated without extra bytes.
+        //!
+        void* extraBase() const
+        {
+            return _extra_base;
+        }
+
     private:
-        char*     _allocated_base;   // First allocated address
+        char*     _allocated_base;   // First allocated address (nullptr when mmap'ed)
         char*     _locked_base;      // First locked address (mlock, page boundary)
         T*        _base;             // Same as _locked_base with type T*
+        char*     _extra_base;       // Extra area after the elements (or nullptr)
         size_t    _allocated_size;   // Allocated size (ts_malloc)
+        size_t    _mmap_size;        // Mapped size when the buffer is mmap'ed (huge pages)
         size_t    _locked_size;      // Locked size (mlock, multiple of page size)
         size_t    _elem_count;       // Element count in locked region
         bool      _is_locked;        // False if mlock failed.
+        bool      _is_huge;          // Buffer is backed by explicit huge pages.
         ErrorCode _error_code;       // Lock error code
     };
 
@@ -46,19 +46,58 @@
 //----------------------------------------------------------------------------
 
 template <typename T>
-ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
+ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count, bool huge_pages, size_t extra_bytes) :
     _allocated_base(nullptr),
     _locked_base(nullptr),
     _base(nullptr),
+    _extra_base(nullptr),
     _allocated_size(0),
+    _mmap_size(0),
     _locked_size(0),
     _elem_count(elem_count),
     _is_locked(false),
+    _is_huge(false),
     _error_code(SYS_SUCCESS)
 {
-    const size_t requested_size = elem_count * sizeof(T);
+    // The extra area follows the element array, aligned on the pointer size.
+    const size_t elem_size = RoundUp(elem_count * sizeof(T), sizeof(void*));
+    const size_t requested_size = elem_size + extra_bytes;
     const size_t page_size = SysInfo::Instance()->memoryPageSize();
 
+#if defined(TS_LINUX) && defined(MAP_HUGETLB)
+    if (huge_pages) {
+        // Try to allocate the buffer from explicit huge pages. The kernel only
+        // accepts mappings which are a multiple of the huge page size (2 MB by
+        // default). On failure (no reserved huge page, no permission), fall
+        // back to a normal anonymous mapping with transparent huge pages
+        // advised, and then to the standard allocation below.
+        const size_t huge_page_size = 2 * 1024 * 1024;
+        const size_t map_size = RoundUp(requested_size, huge_page_size);
+        void* mem = ::mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mem != MAP_FAILED) {
+            _is_huge = true;
+        }
+        else {
+            mem = ::mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#if defined(MADV_HUGEPAGE)
+            if (mem != MAP_FAILED) {
+                ::madvise(mem, map_size, MADV_HUGEPAGE);
+            }
+#endif
+        }
+        if (mem != MAP_FAILED) {
+            _mmap_size = map_size;
+            _locked_base = char_ptr(mem);
+            _locked_size = map_size;
+            _base = new (_locked_base) T[elem_count];
+            _extra_base = extra_bytes == 0 ? nullptr : _locked_base + elem_size;
+            _is_locked = ::mlock(_locked_base, _locked_size) == 0;
+            _error_code = _is_locked ? SYS_SUCCESS : LastErrorCode();
+            return;
+        }
+    }
+#endif
+
     // Allocate enough space to include memory pages around the requested size
 
     _allocated_size = requested_size + 2 * page_size;
@@ -74,6 +113,7 @@ ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
     _locked_size = RoundUp(requested_size, page_size);
 
     _base = new (_locked_base) T[elem_count];
+    _extra_base = extra_bytes == 0 ? nullptr : _locked_base + elem_size;
 
     // Integrity checks
 
@@ -142,13 +182,21 @@ ts::ResidentBuffer<T>::~ResidentBuffer()
     if (_allocated_base != nullptr) {
         delete[] _allocated_base;
     }
+#if defined(TS_UNIX)
+    else if (_mmap_size != 0) {
+        ::munmap(_locked_base, _mmap_size);
+    }
+#endif
 
     // Reset state (it explicit call of destructor)
     _allocated_base = nullptr;
     _locked_base = nullptr;
     _base = nullptr;
+    _extra_base = nullptr;
     _allocated_size = 0;
+    _mmap_size = 0;
     _locked_size = 0;
     _elem_count = 0;
     _is_locked = false;
+    _is_huge = false;
 }
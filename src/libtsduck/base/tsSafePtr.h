@@ -82,6 +82,11 @@ namespace ts {
     //!  safe pointers in a multi-thread environment, specify an actual
     //!  mutex implementation for the target environment.
     //!
+    //!  In thread-safe instantiations, the reference counter is implemented
+    //!  with an atomic integer: copying or destructing a safe pointer never
+    //!  takes the mutex. The mutex only protects the pointer value itself
+    //!  (release(), reset(), casts).
+    //!
     //!  @tparam T The type of the pointed object. Cannot be an array type.
     //!  @tparam MUTEX A subclass of ts::MutexInterface which is used to
     //!  synchronize access to the safe pointer internal state.
@@ -474,10 +479,17 @@ namespace ts {
         {
             TS_NOBUILD_NOCOPY(SafePtrShared);
         private:
+            // The reference counter does not use the mutex. With a real mutex class,
+            // the counter is an atomic integer: a lock/unlock pair per pointer copy
+            // would be pure overhead. With the default NullMutex, a plain integer is
+            // used, without any synchronization cost. The mutex only protects the
+            // pointer value itself.
+            typedef typename std::conditional<std::is_same<MUTEX,NullMutex>::value, int, std::atomic<int>>::type RefCount;
+
             // Private members:
-            T*    _ptr;        // pointer to actual object
-            int   _ref_count;  // reference counter
-            MUTEX _mutex;      // protect the SafePtrShared
+            T*       _ptr;        // pointer to actual object
+            RefCount _ref_count;  // reference counter
+            MUTEX    _mutex;      // protect the pointer value
 
         public:
             // Constructor. Initial reference count is 1.
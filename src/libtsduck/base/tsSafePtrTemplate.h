@@ -147,7 +147,7 @@ T* ts::SafePtr<T,MUTEX>::SafePtrShared::pointer()
 template <typename T, class MUTEX>
 int ts::SafePtr<T,MUTEX>::SafePtrShared::count()
 {
-    Guard lock(_mutex);
+    // Plain or atomic read, depending on the instantiation, no lock.
     return _ref_count;
 }
 
@@ -171,8 +171,8 @@ bool ts::SafePtr<T,MUTEX>::SafePtrShared::isNull()
 template <typename T, class MUTEX>
 typename ts::SafePtr<T,MUTEX>::SafePtrShared* ts::SafePtr<T,MUTEX>::SafePtrShared::attach()
 {
-    Guard lock(_mutex);
-    _ref_count++;
+    // Plain or atomic increment, depending on the instantiation, no lock.
+    ++_ref_count;
     return this;
 }
 
@@ -185,11 +185,10 @@ typename ts::SafePtr<T,MUTEX>::SafePtrShared* ts::SafePtr<T,MUTEX>::SafePtrShare
 template <typename T, class MUTEX>
 bool ts::SafePtr<T,MUTEX>::SafePtrShared::detach()
 {
-    int refcount;
-    {
-        Guard lock(_mutex);
-        refcount = --_ref_count;
-    }
+    // Plain or atomic decrement, depending on the instantiation, no lock.
+    // With an atomic counter, exactly one thread sees the count drop to zero
+    // and deletes the shared object.
+    const int refcount = --_ref_count;
     if (refcount == 0) {
         delete this;
         return true;
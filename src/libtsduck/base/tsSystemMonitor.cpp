@@ -34,6 +34,7 @@
 #include "tsSystemMonitor.h"
 #include "tsGuardCondition.h"
 #include "tsIntegerUtils.h"
+#include "tsMemory.h"
 #include "tsSysUtils.h"
 #include "tsTime.h"
 TSDUCK_SOURCE;
@@ -41,6 +42,17 @@ TSDUCK_SOURCE;
 // Stack size for the monitor thread
 #define MONITOR_STACK_SIZE (64 * 1024)
 
+// Sampling interval of the binary metrics export, in milliseconds.
+#define METRICS_INTERVAL 1000
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr uint32_t ts::SystemMonitor::METRICS_MAGIC;
+#endif
+
+ts::SystemMonitor::MetricsProvider::~MetricsProvider()
+{
+}
+
 
 //----------------------------------------------------------------------------
 // Monitoring time profile: fast at the beginning, then slower and slower
@@ -88,7 +100,13 @@ ts::SystemMonitor::SystemMonitor(Report* report) :
     _report(report),
     _mutex(),
     _wake_up(),
-    _terminate(false)
+    _terminate(false),
+    _logging(true),
+    _metrics_path(),
+    _provider(nullptr),
+    _metrics_base(nullptr),
+    _metrics_size(0),
+    _values()
 {
 }
 
@@ -107,6 +125,105 @@ ts::SystemMonitor::~SystemMonitor()
         lock.signal();
     }
     waitForTermination();
+    closeMetricsExport();
+}
+
+
+//----------------------------------------------------------------------------
+// Create the metrics export file and map it in the address space.
+//----------------------------------------------------------------------------
+
+void ts::SystemMonitor::openMetricsExport()
+{
+    if (_metrics_path.empty()) {
+        return;
+    }
+
+#if defined(TS_UNIX)
+    // Ask the provider for one set of counters, this fixes the sample size.
+    _values.clear();
+    if (_provider != nullptr) {
+        _provider->getMetrics(_values);
+    }
+    _metrics_size = sizeof(MetricsHeader) + _values.size() * sizeof(int64_t);
+
+    // Create the file and map it. The mapping keeps its own reference on the
+    // file, the descriptor can be closed immediately.
+    const int fd = ::open(_metrics_path.toUTF8().c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0 || ::ftruncate(fd, off_t(_metrics_size)) != 0) {
+        _report->error(u"error creating metrics file %s: %s", {_metrics_path, ErrorCodeMessage(LastErrorCode())});
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return;
+    }
+    void* const base = ::mmap(nullptr, _metrics_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        _report->error(u"error mapping metrics file %s: %s", {_metrics_path, ErrorCodeMessage(LastErrorCode())});
+        return;
+    }
+    _metrics_base = reinterpret_cast<uint8_t*>(base);
+
+    // Initialize the constant part of the header.
+    MetricsHeader* const head = reinterpret_cast<MetricsHeader*>(_metrics_base);
+    TS_ZERO(*head);
+    head->magic = METRICS_MAGIC;
+    head->version = 1;
+    head->pid = uint32_t(::getpid());
+    head->count = uint32_t(_values.size());
+#else
+    _report->error(u"metrics export is not supported on this system");
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Unmap and close the metrics export file.
+//----------------------------------------------------------------------------
+
+void ts::SystemMonitor::closeMetricsExport()
+{
+#if defined(TS_UNIX)
+    if (_metrics_base != nullptr) {
+        ::munmap(_metrics_base, _metrics_size);
+        _metrics_base = nullptr;
+        _metrics_size = 0;
+    }
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Publish one binary sample into the metrics export file.
+//----------------------------------------------------------------------------
+
+void ts::SystemMonitor::publishMetrics(const ProcessMetrics& metrics)
+{
+    MetricsHeader* const head = reinterpret_cast<MetricsHeader*>(_metrics_base);
+
+    // Collect the application counters.
+    _values.clear();
+    if (_provider != nullptr) {
+        _provider->getMetrics(_values);
+    }
+
+    // Seqlock write side: the sequence is odd while the sample is being
+    // updated, a reader which observes an odd or changing sequence retries.
+    // No lock is shared with the collector process.
+    head->sequence++;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    head->timestamp_us = MicroSecond(Time::CurrentUTC() - Time::UnixEpoch) * MicroSecPerMilliSec;
+    head->vmem_size = uint64_t(metrics.vmem_size);
+    head->cpu_time_ms = metrics.cpu_time;
+    const size_t count = std::min<size_t>(head->count, _values.size());
+    if (count > 0) {
+        ::memcpy(_metrics_base + sizeof(MetricsHeader), _values.data(), count * sizeof(int64_t));
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    head->sequence++;
 }
 
 
@@ -124,8 +241,14 @@ void ts::SystemMonitor::main()
     Time last_time(start_time);                 // Last report time
     Time vsize_uptime(start_time);              // Time of last vsize increase
     size_t vsize_max(start_metrics.vmem_size);  // Maximum vsize
+    Time next_log(start_time + time_profile->interval);  // Next textual report time
+
+    // Create the metrics export file, if requested.
+    openMetricsExport();
 
-    _report->info(u"%sresource monitoring started", {MonPrefix(Time::CurrentLocalTime())});
+    if (_logging) {
+        _report->info(u"%sresource monitoring started", {MonPrefix(Time::CurrentLocalTime())});
+    }
 
     // Loop on monitoring intervals
 
@@ -137,12 +260,14 @@ void ts::SystemMonitor::main()
             time_profile++;
         }
 
-        // Wait until due time or termination request
+        // Wait until due time or termination request. When exporting binary
+        // samples, wake up at the fast fixed sampling rate, the textual
+        // report keeps its own adaptive schedule.
 
         {
             GuardCondition lock(_mutex, _wake_up);
             if (!_terminate) {
-                lock.waitCondition(time_profile->interval);
+                lock.waitCondition(_metrics_base != nullptr ? std::min<MilliSecond>(METRICS_INTERVAL, time_profile->interval) : time_profile->interval);
             }
             if (_terminate) {
                 break;
@@ -155,6 +280,19 @@ void ts::SystemMonitor::main()
         ProcessMetrics metrics;
         GetProcessMetrics(metrics);
 
+        // Publish a binary sample for the telemetry collector.
+
+        if (_metrics_base != nullptr) {
+            publishMetrics(metrics);
+        }
+
+        // Check if a textual report is due.
+
+        if (!_logging || current_time < next_log) {
+            continue;
+        }
+        next_log = current_time + time_profile->interval;
+
         // Format virtual memory size status
 
         UString message(MonPrefix(current_time) + u"VM:" + UString::HumanSize(metrics.vmem_size));
@@ -192,5 +330,7 @@ void ts::SystemMonitor::main()
         last_metrics = metrics;
     }
 
-    _report->info(u"%sresource monitoring terminated", {MonPrefix(Time::CurrentLocalTime())});
+    if (_logging) {
+        _report->info(u"%sresource monitoring terminated", {MonPrefix(Time::CurrentLocalTime())});
+    }
 }
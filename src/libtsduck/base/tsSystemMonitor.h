@@ -38,6 +38,7 @@
 #include "tsCondition.h"
 #include "tsTime.h"
 #include "tsReport.h"
+#include "tsSysUtils.h"
 
 namespace ts {
     //!
@@ -74,16 +75,105 @@ namespace ts {
         //!
         virtual ~SystemMonitor();
 
+        //!
+        //! Interface of applications which publish their own counters
+        //! through the monitor (see setMetricsExport()).
+        //!
+        class TSDUCKDLL MetricsProvider
+        {
+        public:
+            //!
+            //! Provide the application counter values for one monitoring sample.
+            //! This method is invoked in the context of the monitor thread, once
+            //! per sample. The implementation must be fast and must not block.
+            //! It must always return the same number of counters, in the same
+            //! order, the binary layout of the samples is fixed at start time.
+            //! @param [in,out] values The counter values to append.
+            //!
+            virtual void getMetrics(std::vector<int64_t>& values) = 0;
+
+            //!
+            //! Virtual destructor.
+            //!
+            virtual ~MetricsProvider();
+        };
+
+        //!
+        //! Binary layout of the header of an exported monitoring sample.
+        //! All fields are in the native byte order of the host. The header is
+        //! immediately followed by @a count application counter values, each
+        //! one an int64_t. Each sample overwrites the previous one in place.
+        //! The @a sequence field is a seqlock: it is odd while the sample is
+        //! being updated; a reader shall load it before and after reading the
+        //! sample and retry when the two values differ or are odd.
+        //!
+        struct TSDUCKDLL MetricsHeader
+        {
+            uint32_t magic;         //!< Magic number, always METRICS_MAGIC.
+            uint32_t version;       //!< Layout version, currently 1.
+            uint32_t pid;           //!< Process id of the publishing process.
+            uint32_t count;         //!< Number of application counters after the header.
+            uint64_t sequence;      //!< Sample sequence number, odd while the sample is being updated.
+            int64_t  timestamp_us;  //!< Sample time in microseconds since the Unix epoch.
+            uint64_t vmem_size;     //!< Virtual memory size of the process in bytes.
+            int64_t  cpu_time_ms;   //!< Cumulated CPU time of the process in milliseconds.
+        };
+
+        //!
+        //! Magic number in the header of an exported monitoring sample ("TSMN").
+        //!
+        static constexpr uint32_t METRICS_MAGIC = 0x54534D4E;
+
+        //!
+        //! Continuously export monitoring samples to a memory-mapped binary file (UNIX only).
+        //! Every second, the monitor thread overwrites the file in place with one
+        //! fixed-size sample (see MetricsHeader), a telemetry collector maps the
+        //! same file and reads the current sample at any time, without text parsing
+        //! and without waking up this process. Place the file in a memory file
+        //! system such as /dev/shm to avoid any disk activity.
+        //! Must be called before starting the monitor thread.
+        //! @param [in] path Name of the file to create.
+        //! @param [in] provider Optional provider of application counters which
+        //! are appended to each sample. Must remain valid during the life of the
+        //! monitor thread.
+        //!
+        void setMetricsExport(const UString& path, MetricsProvider* provider = nullptr)
+        {
+            _metrics_path = path;
+            _provider = provider;
+        }
+
+        //!
+        //! Enable or disable the periodic textual resource report (the default).
+        //! When disabled, the monitor thread only exports binary samples.
+        //! @param [in] on When true, periodically log the resource usage as text.
+        //!
+        void setResourceLogging(bool on)
+        {
+            _logging = on;
+        }
+
     private:
         // Private members
         Report*   _report;
         Mutex     _mutex;
-        Condition _wake_up;    // accessed under mutex
-        bool      _terminate;  // accessed under mutex
+        Condition _wake_up;       // accessed under mutex
+        bool      _terminate;     // accessed under mutex
+        bool      _logging;       // periodically log the resource usage as text
+        UString   _metrics_path;  // name of the metrics export file, empty when unused
+        MetricsProvider* _provider;      // application counters for exported samples
+        uint8_t*  _metrics_base;  // base address of the mapped metrics file
+        size_t    _metrics_size;  // size of the mapped metrics file
+        std::vector<int64_t> _values;    // reusable buffer for application counters
 
         // Inherited from Thread
         virtual void main() override;
 
+        // Manage the metrics export file.
+        void openMetricsExport();
+        void closeMetricsExport();
+        void publishMetrics(const ProcessMetrics& metrics);
+
         // Prefix strings for all monitor messages
         static UString MonPrefix(const ts::Time& date);
     };
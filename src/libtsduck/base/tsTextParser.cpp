@@ -284,6 +284,58 @@ bool ts::TextParser::parseXMLName(UString& name)
     return true;
 }
 
+bool ts::TextParser::parseXMLName(Token& name)
+{
+    name._data = nullptr;
+    name._size = 0;
+
+    // Check that the next character is valid to start a name.
+    if (!isAtXMLNameStart()) {
+        return false;
+    }
+
+    // Delimit the name in the current line, without copying it.
+    const UString& line(*_pos._curLine);
+    const size_t start = _pos._curIndex;
+    while (_pos._curIndex < line.length() && isXMLNameChar(line[_pos._curIndex])) {
+        _pos._curIndex++;
+    }
+    name._data = line.data() + start;
+    name._size = _pos._curIndex - start;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a token is "similar" to a string, without materializing it.
+//----------------------------------------------------------------------------
+
+bool ts::TextParser::Token::similar(const UString& other) const
+{
+    // Same semantics as UString::similar(): spaces are ignored and the
+    // comparison is case-insensitive.
+    const size_t alen = _size;
+    const size_t blen = other.length();
+    size_t ai = 0;
+    size_t bi = 0;
+
+    for (;;) {
+        // Skip spaces
+        while (ai < alen && IsSpace(_data[ai])) {
+            ai++;
+        }
+        while (bi < blen && IsSpace(other.at(bi))) {
+            bi++;
+        }
+        if (ai >= alen && bi >= blen) {
+            return true;
+        }
+        if (ai >= alen || bi >= blen || ToLower(_data[ai++]) != ToLower(other.at(bi++))) {
+            return false;
+        }
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Check if the parser is at the start of a number (digit or minus sign).
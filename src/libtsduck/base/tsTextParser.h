@@ -154,6 +154,55 @@ namespace ts {
             size_t                      _curIndex;
         };
 
+        //!
+        //! A read-only view over a range of characters in the loaded document.
+        //!
+        //! A token does not copy the characters, it points into the text which
+        //! is loaded in the parser and remains valid as long as this text is
+        //! loaded. It is materialized into a UString on demand only. Use it for
+        //! tokens which are compared and discarded, such as closing tag names,
+        //! to avoid one string allocation per token.
+        //!
+        class Token
+        {
+        public:
+            //!
+            //! Constructor, build an empty token.
+            //!
+            Token() : _data(nullptr), _size(0) {}
+
+            //!
+            //! Check if the token is empty.
+            //! @return True when the token is empty.
+            //!
+            bool empty() const { return _size == 0; }
+
+            //!
+            //! Get the number of characters in the token.
+            //! @return The number of characters in the token.
+            //!
+            size_t size() const { return _size; }
+
+            //!
+            //! Materialize the token into a string.
+            //! @return The token characters as a UString.
+            //!
+            UString toString() const { return _data == nullptr ? UString() : UString(_data, _size); }
+
+            //!
+            //! Check if the token is "similar" to a string, in the sense of UString::similar(),
+            //! without materializing the token.
+            //! @param [in] other The string to compare with.
+            //! @return True when the token and @a other are case-insensitively identical.
+            //!
+            bool similar(const UString& other) const;
+
+        private:
+            friend class TextParser;
+            const UChar* _data;
+            size_t       _size;
+        };
+
         //!
         //! Save the position in the document.
         //! @return The current position in the document.
@@ -234,6 +283,14 @@ namespace ts {
         //!
         virtual bool parseXMLName(UString& name);
 
+        //!
+        //! Parse an XML name as a zero-copy token.
+        //! @param [out] name Returned token, a view over the parsed name in the document.
+        //! The token is valid as long as the document remains loaded in the parser.
+        //! @return True on success, false if no name was not found.
+        //!
+        virtual bool parseXMLName(Token& name);
+
         //!
         //! Check if the parser is at the start of a number (digit or minus sign).
         //! @return True if the parser is at the start of a number.
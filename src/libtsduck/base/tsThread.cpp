@@ -221,13 +221,24 @@ bool ts::Thread::start()
         return false;
     }
 
-    // Set the thread priority
-    ::BOOL status = ::SetThreadPriority(_handle, ThreadAttributes::Win32Priority(_attributes._priority));
+    // Set the thread priority. Real-time scheduling maps to TIME_CRITICAL.
+    ::BOOL status = ::SetThreadPriority(_handle, _attributes._realTime ? THREAD_PRIORITY_TIME_CRITICAL : ThreadAttributes::Win32Priority(_attributes._priority));
     if (status == 0) {
         ::CloseHandle(_handle);
         return false;
     }
 
+    // Set the CPU affinity when one is specified (ignore CPU's above 63, mask limitation).
+    if (!_attributes._cpuSet.empty()) {
+        ::DWORD_PTR mask = 0;
+        for (auto it = _attributes._cpuSet.begin(); it != _attributes._cpuSet.end(); ++it) {
+            if (*it < 8 * sizeof(mask)) {
+                mask |= ::DWORD_PTR(1) << *it;
+            }
+        }
+        ::SetThreadAffinityMask(_handle, mask);
+    }
+
     // Release the thread
     if (::ResumeThread(_handle) == ::DWORD(-1)) {
         ::CloseHandle(_handle);
@@ -254,16 +265,23 @@ bool ts::Thread::start()
         }
     }
 
-    // Set scheduling policy identical as current process.
-    if (::pthread_attr_setschedpolicy(&attr, ThreadAttributes::PthreadSchedulingPolicy()) != 0) {
+    // Set scheduling policy and priority. By default, the policy is identical
+    // to the one of the current process. When real-time scheduling is
+    // requested, use the FIFO policy with the real-time priority, clamped
+    // into the priority range of that policy.
+    int policy = ThreadAttributes::PthreadSchedulingPolicy();
+    int priority = _attributes._priority;
+    if (_attributes._realTime) {
+        policy = SCHED_FIFO;
+        priority = std::max(::sched_get_priority_min(SCHED_FIFO), std::min(::sched_get_priority_max(SCHED_FIFO), _attributes._rtPriority));
+    }
+    if (::pthread_attr_setschedpolicy(&attr, policy) != 0) {
         ::pthread_attr_destroy(&attr);
         return false;
     }
-
-    // Set scheduling priority.
     ::sched_param sparam;
     TS_ZERO(sparam);
-    sparam.sched_priority = _attributes._priority;
+    sparam.sched_priority = priority;
     if (::pthread_attr_setschedparam(&attr, &sparam) != 0) {
         ::pthread_attr_destroy(&attr);
         return false;
@@ -275,10 +293,36 @@ bool ts::Thread::start()
         return false;
     }
 
+#if defined(TS_LINUX)
+    // Set the CPU affinity when one is specified. Not available on macOS.
+    if (!_attributes._cpuSet.empty()) {
+        ::cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (auto it = _attributes._cpuSet.begin(); it != _attributes._cpuSet.end(); ++it) {
+            CPU_SET(int(*it), &cpus);
+        }
+        if (::pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus) != 0) {
+            ::pthread_attr_destroy(&attr);
+            return false;
+        }
+    }
+#endif
+
     // Create the thread
     if (::pthread_create(&_pthread, &attr, Thread::ThreadProc, this) != 0) {
-        ::pthread_attr_destroy(&attr);
-        return false;
+        // Real-time scheduling is typically denied to unprivileged processes
+        // (EPERM). Gracefully degrade to the process scheduling policy.
+        bool created = false;
+        if (_attributes._realTime) {
+            sparam.sched_priority = _attributes._priority;
+            created = ::pthread_attr_setschedpolicy(&attr, ThreadAttributes::PthreadSchedulingPolicy()) == 0 &&
+                      ::pthread_attr_setschedparam(&attr, &sparam) == 0 &&
+                      ::pthread_create(&_pthread, &attr, Thread::ThreadProc, this) == 0;
+        }
+        if (!created) {
+            ::pthread_attr_destroy(&attr);
+            return false;
+        }
     }
 
     // Destroy thread attributes
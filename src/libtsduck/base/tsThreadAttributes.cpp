@@ -154,7 +154,10 @@ int ts::ThreadAttributes::Win32Priority(int priority)
 ts::ThreadAttributes::ThreadAttributes() :
     _stackSize(0),
     _deleteWhenTerminated(false),
-    _priority(0)
+    _priority(0),
+    _realTime(false),
+    _rtPriority(1),
+    _cpuSet()
 {
     if (!_priorityInitialized) {
         InitializePriorities();
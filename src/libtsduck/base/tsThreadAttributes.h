@@ -184,6 +184,122 @@ namespace ts {
             return _priority;
         }
 
+        //!
+        //! Request real-time scheduling for the thread.
+        //!
+        //! When this attribute is set, the thread is created under the
+        //! real-time FIFO scheduling policy of the operating system
+        //! (@c SCHED_FIFO on UNIX systems, the <i>TIME_CRITICAL</i> priority
+        //! on Microsoft Windows), regardless of the scheduling policy of the
+        //! process. A real-time thread always preempts all time-sharing
+        //! threads and is never time-sliced; use it only for threads which
+        //! block on I/O or events, never for compute loops.
+        //!
+        //! Real-time scheduling usually requires privileges (on Linux, root
+        //! or a non-zero @c RLIMIT_RTPRIO limit). This is an advisory
+        //! attribute: when the operating system denies the real-time policy,
+        //! the thread is silently created under the default scheduling
+        //! policy, using the priority from setPriority().
+        //!
+        //! @param [in] rt Real-time scheduling flag for the thread.
+        //! @return A reference to this object.
+        //! @see setRealTimePriority()
+        //!
+        ThreadAttributes& setRealTime(bool rt = true)
+        {
+            _realTime = rt;
+            return *this;
+        }
+
+        //!
+        //! Get the real-time scheduling flag for the thread.
+        //!
+        //! @return The real-time scheduling flag for the thread.
+        //! @see setRealTime()
+        //!
+        bool getRealTime() const
+        {
+            return _realTime;
+        }
+
+        //!
+        //! Set the real-time priority for the thread.
+        //!
+        //! Unlike setPriority(), this priority is expressed in the priority
+        //! range of the real-time FIFO scheduling policy, not in the range
+        //! of the process scheduling policy. It is used only when real-time
+        //! scheduling is requested with setRealTime() and it is clamped into
+        //! the valid range of the real-time policy when the thread is
+        //! created. The default is 1, the lowest real-time priority, which
+        //! is already above all time-sharing threads in the system.
+        //!
+        //! @param [in] priority The real-time priority for the thread.
+        //! @return A reference to this object.
+        //! @see setRealTime()
+        //!
+        ThreadAttributes& setRealTimePriority(int priority)
+        {
+            _rtPriority = priority;
+            return *this;
+        }
+
+        //!
+        //! Get the real-time priority for the thread.
+        //!
+        //! @return The real-time priority for the thread.
+        //! @see setRealTimePriority()
+        //!
+        int getRealTimePriority() const
+        {
+            return _rtPriority;
+        }
+
+        //!
+        //! Set the CPU affinity for the thread.
+        //!
+        //! When the set is not empty, the thread is restricted to execute on
+        //! the specified CPU's only. CPU's are numbered from 0, as seen by the
+        //! operating system. On NUMA systems, pinning a thread on the CPU's of
+        //! one node keeps its memory accesses local to that node. An empty set
+        //! (the default) means no restriction.
+        //!
+        //! This is an advisory attribute. On systems without thread affinity
+        //! support, it is ignored.
+        //!
+        //! @param [in] cpus Set of CPU indexes on which the thread may execute.
+        //! @return A reference to this object.
+        //!
+        ThreadAttributes& setCPUSet(const std::set<size_t>& cpus)
+        {
+            _cpuSet = cpus;
+            return *this;
+        }
+
+        //!
+        //! Add one CPU in the affinity set for the thread.
+        //!
+        //! @param [in] cpu Index of a CPU on which the thread may execute.
+        //! @return A reference to this object.
+        //! @see setCPUSet()
+        //!
+        ThreadAttributes& addCPU(size_t cpu)
+        {
+            _cpuSet.insert(cpu);
+            return *this;
+        }
+
+        //!
+        //! Get the CPU affinity set for the thread.
+        //!
+        //! @return The set of CPU indexes on which the thread may execute.
+        //! An empty set means no restriction.
+        //! @see setCPUSet()
+        //!
+        const std::set<size_t>& getCPUSet() const
+        {
+            return _cpuSet;
+        }
+
         //!
         //! Get the minimum priority for a thread in this context of the operating system.
         //! @return The minimum priority for a thread.
@@ -241,6 +357,9 @@ namespace ts {
         size_t _stackSize;
         bool _deleteWhenTerminated;
         int _priority;
+        bool _realTime;
+        int _rtPriority;
+        std::set<size_t> _cpuSet;
 
         //
         // These fields describe the operating system priority range.
@@ -0,0 +1,299 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsThreadPool.h"
+#include "tsThread.h"
+#include "tsGuard.h"
+#include "tsFatal.h"
+TSDUCK_SOURCE;
+
+TS_DEFINE_SINGLETON(ts::ThreadPool);
+
+
+//----------------------------------------------------------------------------
+// The worker threads of the pool.
+//----------------------------------------------------------------------------
+
+class ts::ThreadPool::Worker : public Thread
+{
+    TS_NOBUILD_NOCOPY(Worker);
+private:
+    ThreadPool* _pool;
+public:
+    Worker(ThreadPool* pool, const ThreadAttributes& attributes) :
+        Thread(attributes),
+        _pool(pool)
+    {
+    }
+
+    // Thread code: execute tasks until the pool terminates.
+    virtual void main() override
+    {
+        ThreadPoolTaskInterface* task = nullptr;
+        while ((task = _pool->waitTask()) != nullptr) {
+            task->run();
+        }
+    }
+};
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::ThreadPool::ThreadPool() :
+    _mutex(),
+    _enqueued(),
+    _attributes(),
+    _threadCount(DefaultThreadCount()),
+    _terminate(false),
+    _workers(),
+    _queues()
+{
+}
+
+ts::ThreadPool::~ThreadPool()
+{
+    // Wake up all worker threads. Each of them signals the condition again
+    // before exiting, so that all workers eventually get the termination.
+    {
+        Guard lock(_mutex);
+        _terminate = true;
+        _enqueued.signal();
+    }
+
+    // Wait for all worker threads to complete their current task and exit.
+    for (std::vector<Worker*>::iterator it = _workers.begin(); it != _workers.end(); ++it) {
+        (*it)->waitForTermination();
+        delete *it;
+    }
+    _workers.clear();
+
+    // Pending tasks are not executed and remain the property of their submitter.
+    _queues[NORMAL].clear();
+    _queues[HIGH].clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Get the default number of worker threads.
+//----------------------------------------------------------------------------
+
+size_t ts::ThreadPool::DefaultThreadCount()
+{
+#if defined(TS_WINDOWS)
+    ::SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    return std::max<size_t>(1, size_t(info.dwNumberOfProcessors));
+#else
+    const long count = ::sysconf(_SC_NPROCESSORS_ONLN);
+    return count < 1 ? 1 : size_t(count);
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Pool configuration, before the worker threads are started.
+//----------------------------------------------------------------------------
+
+size_t ts::ThreadPool::threadCount() const
+{
+    Guard lock(_mutex);
+    return _threadCount;
+}
+
+bool ts::ThreadPool::setThreadCount(size_t count)
+{
+    Guard lock(_mutex);
+    if (!_workers.empty() || count == 0) {
+        return false;
+    }
+    _threadCount = count;
+    return true;
+}
+
+bool ts::ThreadPool::setWorkerAttributes(const ThreadAttributes& attributes)
+{
+    Guard lock(_mutex);
+    if (!_workers.empty()) {
+        return false;
+    }
+    _attributes = attributes;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Start the worker threads if not already done (with the mutex held).
+//----------------------------------------------------------------------------
+
+void ts::ThreadPool::startWorkers()
+{
+    if (_workers.empty() && !_terminate) {
+        // Worker threads never terminate on their own, do not delete them
+        // when main() completes, the pool destructor joins and deletes them.
+        ThreadAttributes attributes(_attributes);
+        attributes.setDeleteWhenTerminated(false);
+        _workers.reserve(_threadCount);
+        for (size_t i = 0; i < _threadCount; ++i) {
+            Worker* const worker = new Worker(this, attributes);
+            CheckNonNull(worker);
+            _workers.push_back(worker);
+            worker->start();
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Wait for a task to execute (invoked by the worker threads).
+//----------------------------------------------------------------------------
+
+ts::ThreadPoolTaskInterface* ts::ThreadPool::waitTask()
+{
+    GuardCondition lock(_mutex, _enqueued);
+    for (;;) {
+        // The high priority lane is always served first.
+        if (!_queues[HIGH].empty()) {
+            ThreadPoolTaskInterface* const task = _queues[HIGH].front();
+            _queues[HIGH].pop_front();
+            return task;
+        }
+        if (!_queues[NORMAL].empty()) {
+            ThreadPoolTaskInterface* const task = _queues[NORMAL].front();
+            _queues[NORMAL].pop_front();
+            return task;
+        }
+        if (_terminate) {
+            // Propagate the wakeup to the next waiting worker.
+            lock.signal();
+            return nullptr;
+        }
+        lock.waitCondition();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Submit a task for asynchronous execution on some worker thread.
+//----------------------------------------------------------------------------
+
+bool ts::ThreadPool::enqueue(ThreadPoolTaskInterface* task, Lane lane)
+{
+    GuardCondition lock(_mutex, _enqueued);
+    if (task == nullptr || _terminate) {
+        return false;
+    }
+    startWorkers();
+    _queues[lane].push_back(task);
+    lock.signal();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Execute one task concurrently on several threads and wait for completion.
+//----------------------------------------------------------------------------
+
+void ts::ThreadPool::executeShared(ThreadPoolTaskInterface& task, size_t copies)
+{
+    // Completion synchronization for the helper executions. The wrapper task
+    // is enqueued several times; each execution runs the user's task and
+    // reports its completion.
+    Mutex doneMutex;
+    Condition doneCondition;
+    size_t remaining = 0;
+
+    class SharedRun : public ThreadPoolTaskInterface
+    {
+        TS_NOBUILD_NOCOPY(SharedRun);
+    private:
+        ThreadPoolTaskInterface& _task;
+        Mutex&                   _doneMutex;
+        Condition&               _doneCondition;
+        size_t&                  _remaining;
+    public:
+        SharedRun(ThreadPoolTaskInterface& task1, Mutex& mutex1, Condition& condition1, size_t& remaining1) :
+            _task(task1),
+            _doneMutex(mutex1),
+            _doneCondition(condition1),
+            _remaining(remaining1)
+        {
+        }
+        virtual void run() override
+        {
+            _task.run();
+            Guard lock(_doneMutex);
+            if (--_remaining == 0) {
+                _doneCondition.signal();
+            }
+        }
+    };
+    SharedRun shared(task, doneMutex, doneCondition, remaining);
+
+    // Enqueue the helper executions on the high priority lane.
+    if (copies > 0) {
+        GuardCondition lock(_mutex, _enqueued);
+        if (!_terminate) {
+            startWorkers();
+            // More copies than workers would only queue useless executions.
+            copies = std::min(copies, _workers.size());
+            remaining = copies;
+            for (size_t i = 0; i < copies; ++i) {
+                _queues[HIGH].push_back(&shared);
+                lock.signal();
+            }
+        }
+    }
+
+    // The calling thread always participates in the work.
+    task.run();
+
+    // Withdraw the helper executions which no worker has started yet: the
+    // work is done, an idle pool or a recursive call shall not hang here.
+    {
+        Guard lock(_mutex);
+        for (std::list<ThreadPoolTaskInterface*>::iterator it = _queues[HIGH].begin(); it != _queues[HIGH].end();) {
+            if (*it == &shared) {
+                it = _queues[HIGH].erase(it);
+                Guard done(doneMutex);
+                --remaining;
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
+    // Wait for the completion of the helper executions which did start.
+    GuardCondition done(doneMutex, doneCondition);
+    while (remaining > 0) {
+        done.waitCondition();
+    }
+}
@@ -0,0 +1,192 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Shared pool of worker threads.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsThreadPoolTaskInterface.h"
+#include "tsThreadAttributes.h"
+#include "tsSingletonManager.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+#include "tsGuardCondition.h"
+
+namespace ts {
+    //!
+    //! Shared pool of worker threads.
+    //! @ingroup thread
+    //!
+    //! The thread pool is a singleton. It owns a set of worker threads which
+    //! execute submitted tasks. The worker threads are created on the first
+    //! submitted task, not before: applications which never use the pool do
+    //! not pay for it.
+    //!
+    //! Tasks are dispatched from two lanes. Tasks from the high priority lane
+    //! are always executed before tasks from the normal lane. The high lane is
+    //! used internally by parallelFor(): a thread which splits a loop over the
+    //! pool is actively waiting for the chunks, they should not queue behind
+    //! background work.
+    //!
+    //! The parallelFor() method is the typical way of using the pool:
+    //!
+    //! @code
+    //! ThreadPool::Instance()->parallelFor(0, count, 0, [&](size_t begin, size_t end) {
+    //!     for (size_t i = begin; i < end; ++i) {
+    //!         // process item i
+    //!     }
+    //! });
+    //! @endcode
+    //!
+    class TSDUCKDLL ThreadPool
+    {
+        TS_DECLARE_SINGLETON(ThreadPool);
+    public:
+        //!
+        //! Priority lanes for submitted tasks.
+        //!
+        enum Lane {
+            NORMAL = 0,  //!< Default lane for background tasks.
+            HIGH   = 1   //!< Executed before all normal tasks.
+        };
+
+        //!
+        //! Get the number of worker threads in the pool.
+        //! @return The number of worker threads in the pool.
+        //!
+        size_t threadCount() const;
+
+        //!
+        //! Change the number of worker threads in the pool.
+        //!
+        //! The default number of worker threads is the number of logical
+        //! processors in the system.
+        //!
+        //! @param [in] count New number of worker threads, at least one.
+        //! @return True on success, false if the worker threads were already
+        //! started (ie. some task was already submitted).
+        //!
+        bool setThreadCount(size_t count);
+
+        //!
+        //! Set the attributes of the worker threads (stack size, priority).
+        //!
+        //! @param [in] attributes The attributes to apply to all worker threads.
+        //! @return True on success, false if the worker threads were already
+        //! started (ie. some task was already submitted).
+        //!
+        bool setWorkerAttributes(const ThreadAttributes& attributes);
+
+        //!
+        //! Submit a task for asynchronous execution on some worker thread.
+        //!
+        //! The pool does not take ownership of the task object. The caller
+        //! shall ensure that the object remains valid until its run() method
+        //! has completed (a task may delete itself at the end of run() for
+        //! fire-and-forget submissions).
+        //!
+        //! @param [in] task The task to execute. Must remain valid until executed.
+        //! @param [in] lane The priority lane of the task.
+        //! @return True on success, false if the pool is terminating.
+        //!
+        bool enqueue(ThreadPoolTaskInterface* task, Lane lane = NORMAL);
+
+        //!
+        //! Execute one task concurrently on several threads and wait for completion.
+        //!
+        //! The run() method of @a task is executed once in the context of the
+        //! calling thread and up to @a copies more times, concurrently, on
+        //! worker threads (fewer when the workers are busy, the calling thread
+        //! never blocks on busy workers). The run() method must consequently
+        //! be reentrant, typically fetching work items from a shared atomic
+        //! counter. Return when all executions of run() have completed.
+        //!
+        //! @param [in,out] task The task to execute concurrently.
+        //! @param [in] copies Maximum number of additional executions of the
+        //! task on worker threads.
+        //!
+        void executeShared(ThreadPoolTaskInterface& task, size_t copies);
+
+        //!
+        //! Execute the iterations of a loop in parallel on the pool.
+        //!
+        //! The range [@a first, @a last) is split into chunks and the chunks
+        //! are processed concurrently by the calling thread and the worker
+        //! threads. Return when the complete range has been processed.
+        //! The @a body must not depend on the processing order of the chunks
+        //! and must synchronize its access to shared data.
+        //!
+        //! @tparam FUNC A callable profile taking two size_t parameters.
+        //! @param [in] first First index of the range to process.
+        //! @param [in] last First index past the range to process.
+        //! @param [in] chunk Maximum number of iterations to process per task.
+        //! When zero, a chunk size is automatically selected from the range
+        //! size and the number of worker threads.
+        //! @param [in] body The loop body. Invoked as @a body (begin, end) and
+        //! shall process indexes in the range [begin, end). Possibly invoked
+        //! concurrently, on distinct chunks, from distinct threads.
+        //!
+        template <typename FUNC>
+        void parallelFor(size_t first, size_t last, size_t chunk, FUNC&& body);
+
+        //!
+        //! Get the default number of worker threads.
+        //! @return The number of logical processors in the system, at least one.
+        //!
+        static size_t DefaultThreadCount();
+
+    private:
+        // The worker threads, implementation in the .cpp file.
+        class Worker;
+        friend class Worker;
+
+        // Private members. The two task lanes are indexed by the Lane values.
+        mutable Mutex        _mutex;        //!< Protect access to all private members
+        Condition            _enqueued;     //!< Signaled when a task is enqueued or on termination
+        ThreadAttributes     _attributes;   //!< Attributes of the worker threads
+        size_t               _threadCount;  //!< Number of worker threads
+        bool                 _terminate;    //!< The pool is being destructed
+        std::vector<Worker*> _workers;      //!< Worker threads, empty until the first task
+        std::list<ThreadPoolTaskInterface*> _queues[2];  //!< One task queue per lane
+
+        // Destructor, invoked through the singleton cleanup at process exit.
+        ~ThreadPool();
+
+        // Start the worker threads if not already done. Must be called with the mutex held.
+        void startWorkers();
+
+        // Wait for a task to execute. Invoked by the worker threads.
+        // Return nullptr when the pool terminates.
+        ThreadPoolTaskInterface* waitTask();
+    };
+}
+
+#include "tsThreadPoolTemplate.h"
@@ -0,0 +1,82 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+
+//----------------------------------------------------------------------------
+// Execute the iterations of a loop in parallel on the pool.
+//----------------------------------------------------------------------------
+
+template <typename FUNC>
+void ts::ThreadPool::parallelFor(size_t first, size_t last, size_t chunk, FUNC&& body)
+{
+    if (first >= last) {
+        return;
+    }
+
+    // Automatic chunk size: a few chunks per thread, so that uneven chunk
+    // durations balance out, but not so many that dispatch dominates.
+    if (chunk == 0) {
+        chunk = std::max<size_t>(1, (last - first) / (4 * threadCount()));
+    }
+
+    // The shared task: all threads fetch the next chunk from an atomic index.
+    class Runner : public ThreadPoolTaskInterface
+    {
+    private:
+        std::atomic<size_t> _next;
+        const size_t _last;
+        const size_t _chunk;
+        typename std::remove_reference<FUNC>::type& _body;
+    public:
+        Runner(size_t first1, size_t last1, size_t chunk1, typename std::remove_reference<FUNC>::type& body1) :
+            _next(first1),
+            _last(last1),
+            _chunk(chunk1),
+            _body(body1)
+        {
+        }
+        virtual void run() override
+        {
+            for (;;) {
+                const size_t index = _next.fetch_add(_chunk);
+                if (index >= _last) {
+                    break;
+                }
+                _body(index, std::min(index + _chunk, _last));
+            }
+        }
+    };
+    Runner runner(first, last, chunk, body);
+
+    // One helper thread per chunk beyond the one the calling thread processes.
+    const size_t chunks = (last - first + chunk - 1) / chunk;
+    executeShared(runner, chunks - 1);
+}
@@ -395,6 +395,31 @@ ts::Time ts::Time::CurrentUTC()
 }
 
 
+//----------------------------------------------------------------------------
+// This static routine returns the current UTC time from the coarse clock.
+//----------------------------------------------------------------------------
+
+ts::Time ts::Time::CurrentUTCCoarse()
+{
+#if defined(TS_LINUX) && defined(CLOCK_REALTIME_COARSE)
+
+    // Kernel tick resolution, read from the vDSO without system call.
+    ::timespec result;
+    if (::clock_gettime(CLOCK_REALTIME_COARSE, &result) != 0) {
+        throw TimeError(u"clock_gettime error", errno);
+    }
+    return Time(int64_t(result.tv_nsec) / 1000 + 1000000 * int64_t(result.tv_sec));
+
+#else
+
+    // No coarse clock on this system. On Windows, GetSystemTimeAsFileTime
+    // is already a cheap read of a shared memory page.
+    return CurrentUTC();
+
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // This static routine converts a Win32 FILETIME to MilliSecond
 //----------------------------------------------------------------------------
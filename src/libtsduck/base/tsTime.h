@@ -348,6 +348,19 @@ namespace ts {
         //!
         static Time CurrentUTC();
 
+        //!
+        //! Static method returning the current UTC time from the coarse clock.
+        //! On Linux, this reads CLOCK_REALTIME_COARSE from the vDSO, without
+        //! system call. The resolution is the kernel tick, typically 1 to 4
+        //! milliseconds, which is sufficient for timestamping and bitrate
+        //! evaluation and much cheaper when the time is fetched for each
+        //! datagram or each window of packets. On systems without a coarse
+        //! clock, this is identical to CurrentUTC().
+        //! @return The current UTC time.
+        //! @throw ts::Time::TimeError In case of operating system time error.
+        //!
+        static Time CurrentUTCCoarse();
+
         //!
         //! Static method returning the current local time.
         //! @return The current local time.
@@ -0,0 +1,109 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Compiled-in static tracepoints for external tracing tools.
+//!
+//!  On Linux, when the SystemTap development header sys/sdt.h is available
+//!  at build time, the TS_TRACEPOINT macros compile to USDT probes under
+//!  the provider name @c tsduck. A probe is a single nop instruction until
+//!  a tracing tool (perf, bpftrace, SystemTap) attaches to it, so the
+//!  tracepoints can stay in production builds at zero cost. They are
+//!  placed at the boundaries of the packet processing pipeline and carry
+//!  packet counts and PID's as arguments, which makes production stalls
+//!  observable without enabling any internal instrumentation.
+//!
+//!  List the probes of a binary with: tplist -l tsduck.so (bcc) or
+//!  readelf -n, and trace them with for instance:
+//!  bpftrace -e 'usdt:*:tsduck:tsp_pass_packets { @ = hist(arg0); }'
+//!
+//!  On other systems, or when sys/sdt.h is not installed, or when
+//!  @c TS_NO_USDT is defined, the macros expand to nothing.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+//
+// Check the availability of USDT probes. The __has_include extension is
+// supported by all versions of gcc and clang which are able to build this
+// project.
+//
+#if !defined(TS_USDT) && !defined(TS_NO_USDT) && defined(TS_LINUX) && defined(__has_include)
+    #if __has_include(<sys/sdt.h>)
+        //!
+        //! Defined when the TS_TRACEPOINT macros generate real USDT probes.
+        //!
+        #define TS_USDT 1
+    #endif
+#endif
+
+#if defined(TS_USDT)
+    #include <sys/sdt.h>
+    #define TS_TRACEPOINT(name)              DTRACE_PROBE(tsduck, name)
+    #define TS_TRACEPOINT1(name, a1)         DTRACE_PROBE1(tsduck, name, a1)
+    #define TS_TRACEPOINT2(name, a1, a2)     DTRACE_PROBE2(tsduck, name, a1, a2)
+    #define TS_TRACEPOINT3(name, a1, a2, a3) DTRACE_PROBE3(tsduck, name, a1, a2, a3)
+#elif defined(DOXYGEN)
+    //!
+    //! Static tracepoint without argument.
+    //! @param name Probe name, an identifier, not a string.
+    //!
+    #define TS_TRACEPOINT(name)
+    //!
+    //! Static tracepoint with one argument.
+    //! @param name Probe name, an identifier, not a string.
+    //! @param a1 First probe argument, an integral value.
+    //!
+    #define TS_TRACEPOINT1(name, a1)
+    //!
+    //! Static tracepoint with two arguments.
+    //! @param name Probe name, an identifier, not a string.
+    //! @param a1 First probe argument, an integral value.
+    //! @param a2 Second probe argument, an integral value.
+    //!
+    #define TS_TRACEPOINT2(name, a1, a2)
+    //!
+    //! Static tracepoint with three arguments.
+    //! @param name Probe name, an identifier, not a string.
+    //! @param a1 First probe argument, an integral value.
+    //! @param a2 Second probe argument, an integral value.
+    //! @param a3 Third probe argument, an integral value.
+    //!
+    #define TS_TRACEPOINT3(name, a1, a2, a3)
+#else
+    //! @cond nodoxygen
+    // The arguments are not evaluated at all, they shall have no side effect.
+    #define TS_TRACEPOINT(name)              do {} while (false)
+    #define TS_TRACEPOINT1(name, a1)         do {} while (false)
+    #define TS_TRACEPOINT2(name, a1, a2)     do {} while (false)
+    #define TS_TRACEPOINT3(name, a1, a2, a3) do {} while (false)
+    //! @endcond
+#endif
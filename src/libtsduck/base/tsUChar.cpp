@@ -1918,11 +1918,86 @@ namespace {
     }) {}
 }
 
+//----------------------------------------------------------------------------
+// Flat per-code-point tables for the hot classification and case-conversion
+// functions. The maps above are convenient to maintain but one map lookup
+// per character is too slow for string comparisons. The tables are built
+// once, on first use, from the maps and the standard C library.
+//----------------------------------------------------------------------------
+
+namespace {
+    class CharTables
+    {
+        TS_DECLARE_SINGLETON(CharTables);
+    public:
+        // Flags for the case classification table.
+        static const uint8_t IS_LOWER = 0x01;
+        static const uint8_t IS_UPPER = 0x02;
+
+        // Flat tables, indexed by code point.
+        uint32_t characteristics[0x10000];
+        UChar    lower[0x10000];
+        UChar    upper[0x10000];
+        uint8_t  flags[0x10000];
+    };
+    TS_DEFINE_SINGLETON(CharTables);
+
+    CharTables::CharTables() :
+        characteristics(),
+        lower(),
+        upper(),
+        flags()
+    {
+        const CharChar* cc = CharChar::Instance();
+        const UpperLower* ul = UpperLower::Instance();
+        const LowerUpper* lu = LowerUpper::Instance();
+
+        for (uint32_t i = 0; i < 0x10000; ++i) {
+            const UChar c = UChar(i);
+
+            // Characteristics of the character.
+            const CharChar::const_iterator cit(cc->find(c));
+            characteristics[i] = cit == cc->end() ? 0 : cit->second;
+
+            // Lowercase conversion: the standard function first, then our
+            // additional translations, same logic as the previous per-call
+            // implementation.
+            UChar low = UChar(std::towlower(wint_t(c)));
+            if (low == c) {
+                const UpperLower::const_iterator it(ul->find(c));
+                if (it != ul->end()) {
+                    low = it->second;
+                }
+            }
+            lower[i] = low;
+
+            // Uppercase conversion, same logic.
+            UChar up = UChar(std::towupper(wint_t(c)));
+            if (up == c) {
+                const LowerUpper::const_iterator it(lu->find(c));
+                if (it != lu->end()) {
+                    up = it->second;
+                }
+            }
+            upper[i] = up;
+
+            // Case classification: the standard functions plus our known
+            // lowercase and uppercase letters.
+            uint8_t f = 0;
+            if (std::iswlower(wint_t(c)) != 0 || lu->find(c) != lu->end()) {
+                f |= IS_LOWER;
+            }
+            if (std::iswupper(wint_t(c)) != 0 || ul->find(c) != ul->end()) {
+                f |= IS_UPPER;
+            }
+            flags[i] = f;
+        }
+    }
+}
+
 uint32_t ts::UCharacteristics(UChar c)
 {
-    const CharChar* ll = CharChar::Instance();
-    const CharChar::const_iterator it(ll->find(c));
-    return it == ll->end() ? 0 : it->second;
+    return CharTables::Instance()->characteristics[c];
 }
 
 
@@ -1947,58 +2022,22 @@ int ts::ToDigit(UChar c, int base, int defaultValue)
 
 bool ts::IsLower(UChar c)
 {
-    if (std::iswlower(wint_t(c)) != 0) {
-        // The standard function says it is lower.
-        return true;
-    }
-    else {
-        // Check if it is a known lowercase for us.
-        const LowerUpper* lu = LowerUpper::Instance();
-        return lu->find(c) != lu->end();
-    }
+    return (CharTables::Instance()->flags[c] & CharTables::IS_LOWER) != 0;
 }
 
 bool ts::IsUpper(UChar c)
 {
-    if (std::iswupper(wint_t(c)) != 0) {
-        // The standard function says it is upper.
-        return true;
-    }
-    else {
-        // Check if it is a known uppercase for us.
-        const UpperLower* ul = UpperLower::Instance();
-        return ul->find(c) != ul->end();
-    }
+    return (CharTables::Instance()->flags[c] & CharTables::IS_UPPER) != 0;
 }
 
 ts::UChar ts::ToLower(UChar c)
 {
-    const UChar result = UChar(std::towlower(wint_t(c)));
-    if (result != c) {
-        // The standard function has found a translation.
-        return result;
-    }
-    else {
-        // Search for an additional translation, if any.
-        const UpperLower* ul = UpperLower::Instance();
-        const UpperLower::const_iterator it(ul->find(c));
-        return it == ul->end() ? c : it->second;
-    }
+    return CharTables::Instance()->lower[c];
 }
 
 ts::UChar ts::ToUpper(UChar c)
 {
-    const UChar result = UChar(std::towupper(wint_t(c)));
-    if (result != c) {
-        // The standard function has found a translation.
-        return result;
-    }
-    else {
-        // Search for an additional translation, if any.
-        const LowerUpper* lu = LowerUpper::Instance();
-        const LowerUpper::const_iterator it(lu->find(c));
-        return it == lu->end() ? c : it->second;
-    }
+    return CharTables::Instance()->upper[c];
 }
 
 bool ts::IsAccented(UChar c)
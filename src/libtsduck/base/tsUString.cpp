@@ -106,6 +106,26 @@ void ts::UString::ConvertUTF16ToUTF8(const UChar*& inStart, const UChar* inEnd,
 
     while (inStart < inEnd && outStart < outEnd) {
 
+        // Fast path for runs of ASCII characters, the vast majority of strings
+        // in practice. Check 4 input characters at a time using one 64-bit load.
+        while (inStart + 4 <= inEnd && outStart + 4 <= outEnd) {
+            uint64_t quad;
+            ::memcpy(&quad, inStart, sizeof(quad));
+            if ((quad & TS_UCONST64(0xFF80FF80FF80FF80)) != 0) {
+                // At least one non-ASCII character, use the generic path.
+                break;
+            }
+            outStart[0] = char(inStart[0]);
+            outStart[1] = char(inStart[1]);
+            outStart[2] = char(inStart[2]);
+            outStart[3] = char(inStart[3]);
+            inStart += 4;
+            outStart += 4;
+        }
+        if (inStart >= inEnd || outStart >= outEnd) {
+            break;
+        }
+
         // Get current code point as 16-bit value.
         code = *inStart++;
 
@@ -217,6 +237,25 @@ void ts::UString::ConvertUTF8ToUTF16(const char*& inStart, const char* inEnd, UC
 
     while (inStart < inEnd && outStart < outEnd) {
 
+        // Fast path for runs of ASCII bytes, the vast majority of strings in
+        // practice. Check 8 input bytes at a time using one 64-bit load.
+        while (inStart + 8 <= inEnd && outStart + 8 <= outEnd) {
+            uint64_t bytes;
+            ::memcpy(&bytes, inStart, sizeof(bytes));
+            if ((bytes & TS_UCONST64(0x8080808080808080)) != 0) {
+                // At least one non-ASCII byte, use the generic path.
+                break;
+            }
+            for (size_t i = 0; i < 8; ++i) {
+                outStart[i] = UChar(uint8_t(inStart[i]));
+            }
+            inStart += 8;
+            outStart += 8;
+        }
+        if (inStart >= inEnd || outStart >= outEnd) {
+            break;
+        }
+
         // Get current code point at 8-bit value.
         code = *inStart++ & 0xFF;
 
@@ -1299,6 +1338,23 @@ bool ts::UString::similar(const UString& other) const
     size_type bi = 0;
 
     for (;;) {
+        // Fast path: compare runs where both characters are plain ASCII,
+        // above space, without any function call or table lookup. This is
+        // the vastly dominant case (option names, XML tags, etc.)
+        while (ai < alen && bi < blen) {
+            const UChar a = at(ai);
+            const UChar b = other.at(bi);
+            if (a <= SPACE || a >= 0x007F || b <= SPACE || b >= 0x007F) {
+                break; // space, control or non-ASCII character, use the general path
+            }
+            const UChar la = a >= u'A' && a <= u'Z' ? UChar(a + 0x0020) : a;
+            const UChar lb = b >= u'A' && b <= u'Z' ? UChar(b + 0x0020) : b;
+            if (la != lb) {
+                return false;
+            }
+            ai++;
+            bi++;
+        }
         // Skip spaces
         while (ai < alen && IsSpace(at(ai))) {
             ai++;
@@ -70,6 +70,12 @@ ts::WebRequest::WebRequest(Report& report) :
     _dlData(nullptr),
     _dlFile(),
     _dlHandler(nullptr),
+    _transferOpen(false),
+    _transferEnded(false),
+    _recvBuffer(nullptr),
+    _recvBufferSize(0),
+    _recvBufferCount(0),
+    _leftoverData(),
     _interrupted(false),
     _guts(nullptr)
 {
@@ -84,6 +90,9 @@ ts::WebRequest::WebRequest(Report& report) :
 
 ts::WebRequest::~WebRequest()
 {
+    if (_transferOpen) {
+        closeTransfer();
+    }
     if (_guts != nullptr) {
         deleteGuts();
         _guts = nullptr;
@@ -325,6 +334,22 @@ void ts::WebRequest::processReponseHeaders(const UString& text)
 
 bool ts::WebRequest::copyData(const void* addr, size_t size)
 {
+    // In pull mode, store data directly into the receive buffer of the
+    // application. Excess bytes are kept aside for the next receive operation.
+    if (_transferOpen) {
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(addr);
+        const size_t direct = _recvBuffer == nullptr ? 0 : std::min(size, _recvBufferSize - _recvBufferCount);
+        if (direct > 0) {
+            ::memcpy(_recvBuffer + _recvBufferCount, data, direct);  // Flawfinder: ignore
+            _recvBufferCount += direct;
+        }
+        if (direct < size) {
+            _leftoverData.append(data + direct, size - direct);
+        }
+        _contentSize += size;
+        return true;
+    }
+
     // Copy data in memory buffer if there is one.
     if (_dlData != nullptr) {
         // Check maximum buffer size.
@@ -422,6 +447,11 @@ bool ts::WebRequest::clearTransferResults()
     _finalURL = _originalURL;
     _dlData = nullptr;
     _dlHandler = nullptr;
+    _transferEnded = false;
+    _recvBuffer = nullptr;
+    _recvBufferSize = 0;
+    _recvBufferCount = 0;
+    _leftoverData.clear();
 
     // Close spurious file (should not happen).
     if (_dlFile.is_open()) {
@@ -529,3 +559,89 @@ bool ts::WebRequest::downloadToApplication(WebRequestHandlerInterface* handler)
 
     return ok;
 }
+
+
+//----------------------------------------------------------------------------
+// Start a new transfer in pull mode.
+//----------------------------------------------------------------------------
+
+bool ts::WebRequest::startTransfer()
+{
+    if (_transferOpen) {
+        _report.error(u"transfer already started, try again later");
+        return false;
+    }
+
+    _interrupted = false;
+
+    // Transfer initialization.
+    if (!clearTransferResults() || !downloadInitialize() || !downloadStart()) {
+        downloadClose();
+        return false;
+    }
+
+    _transferOpen = true;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Receive data from a transfer which was started by startTransfer().
+//----------------------------------------------------------------------------
+
+bool ts::WebRequest::receive(void* buffer, size_t maxSize, size_t& retSize)
+{
+    retSize = 0;
+
+    if (!_transferOpen) {
+        _report.error(u"no transfer started, cannot receive data");
+        return false;
+    }
+
+    // First, serve data which were already received but could not fit in the
+    // buffer of a previous receive operation.
+    if (!_leftoverData.empty()) {
+        retSize = std::min(maxSize, _leftoverData.size());
+        ::memcpy(buffer, _leftoverData.data(), retSize);  // Flawfinder: ignore
+        _leftoverData.erase(0, retSize);
+        return true;
+    }
+
+    // A returned size of zero means end of transfer.
+    if (_transferEnded) {
+        return true;
+    }
+
+    // Let the system-specific part fill the application buffer.
+    // Loop until some data are present or the transfer completes.
+    _recvBuffer = reinterpret_cast<uint8_t*>(buffer);
+    _recvBufferSize = maxSize;
+    _recvBufferCount = 0;
+
+    bool ok = true;
+    while (ok && _recvBufferCount == 0 && !_transferEnded) {
+        ok = downloadReceive();
+    }
+
+    retSize = _recvBufferCount;
+    _recvBuffer = nullptr;
+    _recvBufferSize = 0;
+    _recvBufferCount = 0;
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Terminate a transfer which was started by startTransfer().
+//----------------------------------------------------------------------------
+
+bool ts::WebRequest::closeTransfer()
+{
+    if (_transferOpen) {
+        downloadClose();
+        _transferOpen = false;
+        _transferEnded = false;
+        _leftoverData.clear();
+    }
+    return true;
+}
@@ -241,6 +241,45 @@ namespace ts {
         //!
         bool downloadToApplication(WebRequestHandlerInterface* handler);
 
+        //!
+        //! Start a new transfer in pull mode.
+        //!
+        //! In pull mode, the application drives the transfer and reads the
+        //! content at its own pace using receive(). The downloaded data are
+        //! written directly into the buffers which are supplied by the
+        //! application, without intermediate copy. The transfer shall be
+        //! terminated using closeTransfer().
+        //!
+        //! @return True on success, false on error.
+        //!
+        bool startTransfer();
+
+        //!
+        //! Receive data from a transfer which was started by startTransfer().
+        //! The method blocks until some data are available.
+        //! @param [out] buffer Address of the buffer for the received data.
+        //! @param [in] maxSize Size in bytes of the reception buffer.
+        //! @param [out] retSize Size in bytes of the received data. A size of
+        //! zero with a @e true returned value means the end of the transfer.
+        //! @return True on success, false on error.
+        //!
+        bool receive(void* buffer, size_t maxSize, size_t& retSize);
+
+        //!
+        //! Check if a transfer which was started by startTransfer() is open.
+        //! @return True if a pull mode transfer is in progress.
+        //!
+        bool transferOpen() const
+        {
+            return _transferOpen;
+        }
+
+        //!
+        //! Terminate a transfer which was started by startTransfer().
+        //! @return True on success, false on error.
+        //!
+        bool closeTransfer();
+
         //!
         //! Representation of request or reponse headers.
         //! The keys of the map are the header names.
@@ -278,6 +317,16 @@ namespace ts {
             return _contentSize;
         }
 
+        //!
+        //! Get the size in bytes of the content, as announced in the response headers.
+        //! @return Size in bytes of the content, as announced by the server.
+        //! Zero when the server did not announce a content size.
+        //!
+        size_t announcedContentSize() const
+        {
+            return _headerContentSize;
+        }
+
         //!
         //! Get the HTTP status code (200, 404, etc).
         //! @return The HTTP status code.
@@ -319,6 +368,12 @@ namespace ts {
         ByteBlock*    _dlData;                   // download data buffer
         std::ofstream _dlFile;                   // download file
         WebRequestHandlerInterface* _dlHandler;  // application-defined handler
+        bool          _transferOpen;             // pull mode transfer in progress
+        bool          _transferEnded;            // end of transfer data was received
+        uint8_t*      _recvBuffer;               // pull mode receive buffer (owned by the application)
+        size_t        _recvBufferSize;           // size of _recvBuffer
+        size_t        _recvBufferCount;          // number of received bytes in _recvBuffer
+        ByteBlock     _leftoverData;             // data in excess of _recvBuffer, for next receive operation
         volatile bool _interrupted;              // interrupted by application-defined handler
         SystemGuts*   _guts;                     // system-specific data
 
@@ -340,6 +395,13 @@ namespace ts {
         // Perform actual download.
         bool download();
 
+        // Start an initialized download in pull mode.
+        bool downloadStart();
+
+        // Receive some data in pull mode. The data are stored into _recvBuffer
+        // or _leftoverData. Set _transferEnded at the end of the transfer.
+        bool downloadReceive();
+
         // Process a list of response headers. Header lines are terminated by LF or CRLF.
         void processReponseHeaders(const UString& text);
 
@@ -33,6 +33,7 @@
 
 #include "tsWebRequest.h"
 #include "tsSingletonManager.h"
+#include "tsMutex.h"
 TSDUCK_SOURCE;
 
 
@@ -50,6 +51,8 @@ void ts::WebRequest::deleteGuts() { delete _guts; }
 bool ts::WebRequest::downloadInitialize() { _report.error(TS_NO_CURL_MESSAGE); return false; }
 void ts::WebRequest::downloadClose() {}
 bool ts::WebRequest::download() { _report.error(TS_NO_CURL_MESSAGE); return false; }
+bool ts::WebRequest::downloadStart() { _report.error(TS_NO_CURL_MESSAGE); return false; }
+bool ts::WebRequest::downloadReceive() { _report.error(TS_NO_CURL_MESSAGE); return false; }
 ts::UString ts::WebRequest::GetLibraryVersion() { return UString(); }
 
 #else
@@ -106,6 +109,101 @@ namespace {
 }
 
 
+//----------------------------------------------------------------------------
+// Process-wide libcurl "share handle" using a singleton.
+//
+// All easy handles are attached to this share handle and share their DNS
+// cache, their TLS sessions and, when libcurl is recent enough, their
+// connection cache. Sequential requests to the same origin then reuse an
+// established connection (keep-alive) instead of paying a TCP and TLS
+// setup per request, even when each request uses a new WebRequest object.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    class LibCurlShare
+    {
+        TS_DECLARE_SINGLETON(LibCurlShare);
+    public:
+        // Destructor.
+        ~LibCurlShare();
+
+        // Get the share handle, null on initialization error.
+        ::CURLSH* handle() const { return _share; }
+
+    private:
+        ::CURLSH* _share;
+        ts::Mutex _mutexes[CURL_LOCK_DATA_LAST];  // one mutex per shared data type
+
+        // Libcurl locking callbacks, the userptr points to this object.
+        static void lockCallback(::CURL* curl, ::curl_lock_data data, ::curl_lock_access access, void* userptr);
+        static void unlockCallback(::CURL* curl, ::curl_lock_data data, void* userptr);
+    };
+
+    TS_DEFINE_SINGLETON(LibCurlShare);
+
+    // Constructor of the shared libcurl state.
+    LibCurlShare::LibCurlShare() :
+        _share(::curl_share_init()),
+        _mutexes()
+    {
+        if (_share != nullptr) {
+            // The shared data are accessed from multiple threads, locking is required.
+            ::CURLSHcode status = ::curl_share_setopt(_share, CURLSHOPT_LOCKFUNC, &LibCurlShare::lockCallback);
+            if (status == ::CURLSHE_OK) {
+                status = ::curl_share_setopt(_share, CURLSHOPT_UNLOCKFUNC, &LibCurlShare::unlockCallback);
+            }
+            if (status == ::CURLSHE_OK) {
+                status = ::curl_share_setopt(_share, CURLSHOPT_USERDATA, this);
+            }
+            if (status == ::CURLSHE_OK) {
+                status = ::curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            }
+            if (status == ::CURLSHE_OK) {
+                status = ::curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            }
+#if LIBCURL_VERSION_NUM >= 0x073900
+            // Sharing the connection cache is honored since libcurl 7.57.0.
+            if (status == ::CURLSHE_OK) {
+                status = ::curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+            }
+#endif
+            if (status != ::CURLSHE_OK) {
+                // Sharing is an optimization only, silently proceed without it.
+                ::curl_share_cleanup(_share);
+                _share = nullptr;
+            }
+        }
+    }
+
+    // Destructor of the shared libcurl state.
+    LibCurlShare::~LibCurlShare()
+    {
+        if (_share != nullptr) {
+            ::curl_share_cleanup(_share);
+            _share = nullptr;
+        }
+    }
+
+    // Libcurl locking callbacks.
+    void LibCurlShare::lockCallback(::CURL* curl, ::curl_lock_data data, ::curl_lock_access access, void* userptr)
+    {
+        LibCurlShare* obj = reinterpret_cast<LibCurlShare*>(userptr);
+        if (obj != nullptr && size_t(data) < size_t(CURL_LOCK_DATA_LAST)) {
+            obj->_mutexes[data].acquire();
+        }
+    }
+
+    void LibCurlShare::unlockCallback(::CURL* curl, ::curl_lock_data data, void* userptr)
+    {
+        LibCurlShare* obj = reinterpret_cast<LibCurlShare*>(userptr);
+        if (obj != nullptr && size_t(data) < size_t(CURL_LOCK_DATA_LAST)) {
+            obj->_mutexes[data].release();
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // System-specific parts are stored in a private structure.
 //----------------------------------------------------------------------------
@@ -125,12 +223,17 @@ public:
     void clear();
     bool start();
 
+    // Start and drive a pull mode transfer using CURL Multi.
+    bool startTransfer();
+    bool receiveData();
+
     // Build an error message from libcurl.
     UString message(const UString& title, ::CURLcode = ::CURLE_OK);
 
 private:
     WebRequest&   _request;
     ::CURL*       _curl;
+    ::CURLM*      _multi;                   // Used in pull mode only.
     ::curl_slist* _headers;
     char          _error[CURL_ERROR_SIZE];  // Error message buffer for libcurl.
 
@@ -149,6 +252,7 @@ private:
 ts::WebRequest::SystemGuts::SystemGuts(WebRequest& request) :
     _request(request),
     _curl(nullptr),
+    _multi(nullptr),
     _headers(nullptr),
     _error{0}
 {
@@ -197,6 +301,12 @@ bool ts::WebRequest::SystemGuts::init()
         status = ::curl_easy_setopt(_curl, CURLOPT_USERAGENT, _request._userAgent.toUTF8().c_str());
     }
 
+    // Attach the process-wide share handle: reuse DNS entries, TLS sessions
+    // and established connections across requests to the same origin.
+    if (status == ::CURLE_OK && LibCurlShare::Instance()->handle() != nullptr) {
+        status = ::curl_easy_setopt(_curl, CURLOPT_SHARE, LibCurlShare::Instance()->handle());
+    }
+
     // Set the starting URL.
     if (status == ::CURLE_OK) {
         status = ::curl_easy_setopt(_curl, CURLOPT_URL, _request._originalURL.toUTF8().c_str());
@@ -309,6 +419,15 @@ void ts::WebRequest::SystemGuts::clear()
         _headers = nullptr;
     }
 
+    // Detach and delete the CURL Multi which may have been used in pull mode.
+    if (_multi != nullptr) {
+        if (_curl != nullptr) {
+            ::curl_multi_remove_handle(_multi, _curl);
+        }
+        ::curl_multi_cleanup(_multi);
+        _multi = nullptr;
+    }
+
     // Make sure the CURL Easy is clean.
     if (_curl != nullptr) {
         ::curl_easy_cleanup(_curl);
@@ -340,6 +459,81 @@ bool ts::WebRequest::SystemGuts::start()
 }
 
 
+//----------------------------------------------------------------------------
+// Start a pull mode transfer.
+//----------------------------------------------------------------------------
+
+bool ts::WebRequest::SystemGuts::startTransfer()
+{
+    assert(_curl != nullptr);
+    assert(_multi == nullptr);
+
+    // In pull mode, the easy handle is driven by a "multi" handle so that the
+    // transfer can be advanced step by step, without blocking until completion.
+    if ((_multi = ::curl_multi_init()) == nullptr) {
+        _request._report.error(u"libcurl 'curl multi' initialization error");
+        return false;
+    }
+
+    const ::CURLMcode status = ::curl_multi_add_handle(_multi, _curl);
+    if (status != ::CURLM_OK) {
+        _request._report.error(u"libcurl error: %s", {UString::FromUTF8(::curl_multi_strerror(status))});
+        return false;
+    }
+
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Drive a pull mode transfer until some data are received.
+//----------------------------------------------------------------------------
+
+bool ts::WebRequest::SystemGuts::receiveData()
+{
+    assert(_multi != nullptr);
+
+    // Advance the transfer. The received data, if any, are passed to the
+    // write callback and land directly into the application buffer.
+    int running = 0;
+    ::CURLMcode status = ::curl_multi_perform(_multi, &running);
+    if (status != ::CURLM_OK) {
+        _request._report.error(u"libcurl error: %s", {UString::FromUTF8(::curl_multi_strerror(status))});
+        return false;
+    }
+
+    // When no easy transfer remains running, the transfer is completed.
+    if (running == 0) {
+        bool ok = true;
+        int remain = 0;
+        ::CURLMsg* msg = nullptr;
+        while ((msg = ::curl_multi_info_read(_multi, &remain)) != nullptr) {
+            if (msg->msg == CURLMSG_DONE && msg->easy_handle == _curl && msg->data.result != ::CURLE_OK) {
+                if (!_request._interrupted) {
+                    _request._report.error(message(u"download error", msg->data.result));
+                }
+                ok = false;
+            }
+        }
+        _request._transferEnded = true;
+        return ok;
+    }
+
+    // The transfer is still running. If nothing was received, wait for some
+    // network activity to avoid a busy loop. The actual receive timeout is
+    // enforced by the easy handle (see the "low speed" options in init()).
+    if (_request._recvBufferCount == 0) {
+        status = ::curl_multi_wait(_multi, nullptr, 0, 500, nullptr); // milliseconds
+        if (status != ::CURLM_OK) {
+            _request._report.error(u"libcurl error: %s", {UString::FromUTF8(::curl_multi_strerror(status))});
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Build an error message from libcurl.
 //----------------------------------------------------------------------------
@@ -403,6 +597,21 @@ bool ts::WebRequest::download()
 }
 
 
+//----------------------------------------------------------------------------
+// Start and drive a download in pull mode.
+//----------------------------------------------------------------------------
+
+bool ts::WebRequest::downloadStart()
+{
+    return _guts->startTransfer();
+}
+
+bool ts::WebRequest::downloadReceive()
+{
+    return _guts->receiveData();
+}
+
+
 //----------------------------------------------------------------------------
 // Libcurl callback for response headers.
 //----------------------------------------------------------------------------
@@ -69,6 +69,9 @@ public:
     void clear();
     bool start();
 
+    // Receive one chunk of data in a pull mode transfer.
+    bool receiveData();
+
     // Report an error message.
     void error(const UChar* message, ::DWORD code = ::GetLastError());
 
@@ -131,6 +134,17 @@ bool ts::WebRequest::download()
     return _guts->start();
 }
 
+bool ts::WebRequest::downloadStart()
+{
+    // The URL is already open and the headers were received in init().
+    return true;
+}
+
+bool ts::WebRequest::downloadReceive()
+{
+    return _guts->receiveData();
+}
+
 
 //----------------------------------------------------------------------------
 // Report an error message.
@@ -333,6 +347,31 @@ bool ts::WebRequest::SystemGuts::start()
 }
 
 
+//----------------------------------------------------------------------------
+// Receive one chunk of data in a pull mode transfer.
+//----------------------------------------------------------------------------
+
+bool ts::WebRequest::SystemGuts::receiveData()
+{
+    // Read directly into the buffer which is supplied by the application.
+    // Wininet is naturally "pull oriented", no intermediate buffer is needed.
+    ::DWORD gotSize = 0;
+    if (!::InternetReadFile(_url, _request._recvBuffer + _request._recvBufferCount, ::DWORD(_request._recvBufferSize - _request._recvBufferCount), &gotSize)) {
+        error(u"download error");
+        return false;
+    }
+    else if (gotSize == 0) {
+        // Successfully reading zero bytes means end of file.
+        _request._transferEnded = true;
+    }
+    else {
+        _request._recvBufferCount += size_t(gotSize);
+        _request._contentSize += size_t(gotSize);
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Transmit response headers to the WebRequest.
 //----------------------------------------------------------------------------
@@ -711,6 +711,46 @@ void ts::xml::Element::printClose(TextFormatter& output, size_t levels) const
 
 bool ts::xml::Element::parseNode(TextParser& parser, const Node* parent)
 {
+    // Parse the start tag: name and attributes.
+    bool selfClosed = false;
+    if (!parseTag(parser, selfClosed)) {
+        return false;
+    }
+    if (selfClosed) {
+        // Standalone tag, without children, the element is complete.
+        return true;
+    }
+
+    // End of tag, swallow all children.
+    if (!parseChildren(parser)) {
+        return false;
+    }
+
+    // We now must be at "</tag>".
+    bool ok = parser.match(u"</", true);
+    if (ok) {
+        // The closing tag name is only compared and discarded, use a zero-copy token.
+        TextParser::Token endTag;
+        ok = parser.skipWhiteSpace() && parser.parseXMLName(endTag) && parser.skipWhiteSpace() && endTag.similar(_value);
+        ok = parser.match(u">", true) && ok;
+    }
+
+    if (!ok) {
+        _report.error(u"line %d: parsing error, expected </%s> to match <%s> at line %d", {parser.lineNumber(), _value, _value, lineNumber()});
+    }
+
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Parse the start tag of the element: tag name and attributes.
+//----------------------------------------------------------------------------
+
+bool ts::xml::Element::parseTag(TextParser& parser, bool& selfClosed)
+{
+    selfClosed = false;
+
     // We just read the "<". Skip spaces and read the tag name.
     parser.skipWhiteSpace();
     if (!parser.parseXMLName(_value)) {
@@ -733,6 +773,7 @@ bool ts::xml::Element::parseNode(TextParser& parser, const Node* parent)
         }
         else if (parser.match(u"/>", true)) {
             // Found end of standalone tag, without children.
+            selfClosed = true;
             return true;
         }
         else if (parser.parseXMLName(name)) {
@@ -783,25 +824,6 @@ bool ts::xml::Element::parseNode(TextParser& parser, const Node* parent)
     if (!ok) {
         UString ignored;
         parser.parseText(ignored, u">", true, false);
-        return false;
-    }
-
-    // End of tag, swallow all children.
-    if (!parseChildren(parser)) {
-        return false;
     }
-
-    // We now must be at "</tag>".
-    ok = parser.match(u"</", true);
-    if (ok) {
-        UString endTag;
-        ok = parser.skipWhiteSpace() && parser.parseXMLName(endTag) && parser.skipWhiteSpace() && endTag.similar(_value);
-        ok = parser.match(u">", true) && ok;
-    }
-
-    if (!ok) {
-        _report.error(u"line %d: parsing error, expected </%s> to match <%s> at line %d", {parser.lineNumber(), _value, _value, lineNumber()});
-    }
-
     return ok;
 }
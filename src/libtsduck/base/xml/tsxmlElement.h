@@ -668,7 +668,20 @@ namespace ts {
             // Inherited from xml::Node.
             virtual bool parseNode(TextParser& parser, const Node* parent) override;
 
+            //!
+            //! Parse the start tag of the element: tag name and attributes.
+            //! The parser must be located just after the initial "&lt;". On success,
+            //! the parser is located just after the "&gt;" or "/&gt;" which closes the tag.
+            //! @param [in,out] parser The document parser.
+            //! @param [out] selfClosed Set to true when the tag was self-closed ("/&gt;"),
+            //! meaning that the element is complete and has no children.
+            //! @return True on success, false on error.
+            //!
+            bool parseTag(TextParser& parser, bool& selfClosed);
+
         private:
+            friend class PullParser;
+
             CaseSensitivity _attributeCase;  //!< For attribute names.
             AttributeMap    _attributes;     //!< Map of attributes.
 
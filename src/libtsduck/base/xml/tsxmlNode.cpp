@@ -36,8 +36,106 @@
 #include "tsxmlUnknown.h"
 #include "tsTextFormatter.h"
 #include "tsNullReport.h"
+#include "tsMutex.h"
+#include "tsGuard.h"
 TSDUCK_SOURCE;
 
+#define POOL_GRAIN 64                         // Pooled block sizes are multiples of this value.
+#define POOL_BUCKETS 8                        // Number of size buckets, max pooled size is POOL_GRAIN * POOL_BUCKETS.
+#define POOL_MAX_RETAINED (2 * 1024 * 1024)   // Maximum number of bytes retained in the pool.
+
+
+//----------------------------------------------------------------------------
+// Memory pool for XML nodes.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // Freed node memory blocks are kept in per-size free lists and reused by
+    // subsequent allocations. Each block is preceded by a small header which
+    // records its rounded size. Parsing a document allocates each node
+    // individually but deleting the document returns all blocks here, so the
+    // next document (or the next table in a pull parser) reuses them instead
+    // of hitting the heap.
+    class NodeMemoryPool
+    {
+        TS_NOCOPY(NodeMemoryPool);
+    public:
+        NodeMemoryPool() : _mutex(), _retained(0), _free() {}
+
+        void* allocate(size_t size)
+        {
+            // Total size to allocate, including header, rounded to the pool grain.
+            const size_t total = POOL_GRAIN * ((sizeof(Header) + size + POOL_GRAIN - 1) / POOL_GRAIN);
+            const size_t bucket = (total / POOL_GRAIN) - 1;
+            Header* head = nullptr;
+            if (bucket < POOL_BUCKETS) {
+                ts::Guard lock(_mutex);
+                head = _free[bucket];
+                if (head != nullptr) {
+                    _free[bucket] = head->next;
+                    _retained -= total;
+                    // The link overwrote the size in the header, restore it.
+                    head->size = total;
+                }
+            }
+            if (head == nullptr) {
+                head = reinterpret_cast<Header*>(::operator new(total));
+                head->size = total;
+            }
+            return head + 1;
+        }
+
+        void deallocate(void* ptr)
+        {
+            Header* const head = reinterpret_cast<Header*>(ptr) - 1;
+            const size_t total = head->size;
+            const size_t bucket = (total / POOL_GRAIN) - 1;
+            if (bucket < POOL_BUCKETS) {
+                ts::Guard lock(_mutex);
+                if (_retained + total <= POOL_MAX_RETAINED) {
+                    head->next = _free[bucket];
+                    _free[bucket] = head;
+                    _retained += total;
+                    return;
+                }
+            }
+            ::operator delete(head);
+        }
+
+        // The pool instance is created on first use and never destructed, so
+        // that nodes in static objects can still be deleted during exit.
+        static NodeMemoryPool& Instance()
+        {
+            static NodeMemoryPool* const pool = new NodeMemoryPool;
+            return *pool;
+        }
+
+    private:
+        // Block header. In a free block, the header links to the next free block instead.
+        union Header {
+            size_t  size;  // Rounded total size of the block, including the header.
+            Header* next;  // Next free block in the same bucket.
+        };
+
+        ts::Mutex _mutex;                 // Protect the free lists.
+        size_t    _retained;              // Number of bytes currently retained in the pool.
+        Header*   _free[POOL_BUCKETS];    // Free list heads, per size bucket.
+    };
+}
+
+void* ts::xml::Node::operator new(size_t size)
+{
+    return NodeMemoryPool::Instance().allocate(size);
+}
+
+void ts::xml::Node::operator delete(void* ptr)
+{
+    if (ptr != nullptr) {
+        NodeMemoryPool::Instance().deallocate(ptr);
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Constructors and destructors.
@@ -55,6 +55,25 @@ namespace ts {
         {
             TS_NOBUILD_NOCOPY(Node);
         public:
+            //!
+            //! Allocate memory for a node.
+            //! XML nodes are allocated from a pool of recycled memory blocks instead of
+            //! the global heap. Parsing a large document performs millions of small node
+            //! allocations and deallocating a document returns all blocks to the pool,
+            //! where the next document reuses them. The pool is thread-safe and its
+            //! retained memory is bounded.
+            //! @param [in] size Requested size in bytes.
+            //! @return Address of the allocated memory.
+            //!
+            static void* operator new(size_t size);
+
+            //!
+            //! Free memory for a node.
+            //! The memory block is recycled into the node pool.
+            //! @param [in] ptr Address of the memory to free.
+            //!
+            static void operator delete(void* ptr);
+
             //!
             //! Get the line number in input document.
             //! @return The line number in input document, zero if the node was built programmatically.
@@ -322,6 +341,9 @@ namespace ts {
             UString                  _value;        //!< Value of the node, depend on the node type.
 
         private:
+            // The pull parser drives the node parsing methods from outside the class hierarchy.
+            friend class PullParser;
+
             Node*   _parent;        //!< Parent node, null for a document.
             Node*   _firstChild;    //!< First child, can be null, other children are linked through the RingNode.
             size_t  _inputLineNum;  //!< Line number in input document, zero if build programmatically.
@@ -0,0 +1,224 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsxmlPullParser.h"
+#include "tsxmlComment.h"
+#include "tsxmlDeclaration.h"
+#include "tsxmlUnknown.h"
+#include "tsSysUtils.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::xml::PullParser::PullParser(Report& report) :
+    _report(report),
+    _parser(report),
+    _doc(report),
+    _root(nullptr),
+    _done(false),
+    _ok(true)
+{
+}
+
+ts::xml::PullParser::~PullParser()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Close the parser and release the document text.
+//----------------------------------------------------------------------------
+
+void ts::xml::PullParser::close()
+{
+    if (_root != nullptr) {
+        delete _root;
+        _root = nullptr;
+    }
+    _parser.clear();
+    _done = false;
+    _ok = true;
+}
+
+
+//----------------------------------------------------------------------------
+// Start parsing an XML document from various sources.
+//----------------------------------------------------------------------------
+
+bool ts::xml::PullParser::parse(const UString& text)
+{
+    close();
+    _parser.loadDocument(text);
+    return parseProlog();
+}
+
+bool ts::xml::PullParser::open(std::istream& strm)
+{
+    close();
+    return _parser.loadStream(strm) && parseProlog();
+}
+
+bool ts::xml::PullParser::open(const UString& fileName, bool search)
+{
+    close();
+
+    // Actual file name to load after optional search in directories.
+    const UString actualFileName(search ? SearchConfigurationFile(fileName) : fileName);
+
+    // Eliminate non-existent files.
+    if (actualFileName.empty()) {
+        _report.error(u"file not found: %s", {fileName});
+        return _ok = false;
+    }
+
+    return _parser.loadFile(actualFileName) && parseProlog();
+}
+
+
+//----------------------------------------------------------------------------
+// Parse the document prolog and the root start tag.
+//----------------------------------------------------------------------------
+
+bool ts::xml::PullParser::parseProlog()
+{
+    // Skip leading declarations, comments and unknown DTD until the root element.
+    for (;;) {
+        Node* const node = _doc.identifyNextNode(_parser);
+        if (node == nullptr) {
+            // End of document or "</" before any element.
+            _report.error(u"invalid XML document, no root element found");
+            return _ok = false;
+        }
+        Element* const elem = dynamic_cast<Element*>(node);
+        if (elem == nullptr) {
+            // Not the root element, parse and discard it.
+            const bool parsed = node->parseNode(_parser, &_doc);
+            delete node;
+            if (!parsed) {
+                return _ok = false;
+            }
+        }
+        else {
+            // Root element, parse the start tag only, the children will be pulled one by one.
+            bool selfClosed = false;
+            if (!elem->parseTag(_parser, selfClosed)) {
+                delete elem;
+                return _ok = false;
+            }
+            _root = elem;
+            if (selfClosed) {
+                // Empty root element, there is nothing to pull.
+                _done = true;
+                _ok = parseEpilog();
+            }
+            return _ok;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the next child element of the root.
+//----------------------------------------------------------------------------
+
+ts::xml::Element* ts::xml::PullParser::nextElement()
+{
+    while (_ok && !_done) {
+        Node* const node = _doc.identifyNextNode(_parser);
+        if (node == nullptr) {
+            // End of document or root end tag.
+            _done = true;
+            // We now must be at "</root>".
+            _ok = _parser.match(u"</", true);
+            if (_ok) {
+                TextParser::Token endTag;
+                _ok = _parser.skipWhiteSpace() && _parser.parseXMLName(endTag) && _parser.skipWhiteSpace() && endTag.similar(_root->name());
+                _ok = _parser.match(u">", true) && _ok;
+            }
+            if (!_ok) {
+                _report.error(u"line %d: parsing error, expected </%s> to match <%s> at line %d", {_parser.lineNumber(), _root->name(), _root->name(), _root->lineNumber()});
+            }
+            else {
+                _ok = parseEpilog();
+            }
+        }
+        else if (dynamic_cast<Element*>(node) != nullptr) {
+            // A child element, parse its complete subtree and hand it to the caller.
+            if (node->parseNode(_parser, _root)) {
+                return dynamic_cast<Element*>(node);
+            }
+            delete node;
+            _ok = false;
+        }
+        else {
+            // Comment or text between children, parse and discard it.
+            const bool parsed = node->parseNode(_parser, _root);
+            delete node;
+            _ok = parsed;
+        }
+    }
+    return nullptr;
+}
+
+
+//----------------------------------------------------------------------------
+// Parse the document epilog, after the root element.
+//----------------------------------------------------------------------------
+
+bool ts::xml::PullParser::parseEpilog()
+{
+    // Only comments (and unknown DTD) are allowed after the root element.
+    for (;;) {
+        Node* const node = _doc.identifyNextNode(_parser);
+        if (node == nullptr) {
+            break;
+        }
+        const bool allowed = dynamic_cast<Comment*>(node) != nullptr || dynamic_cast<Unknown*>(node) != nullptr;
+        const bool parsed = node->parseNode(_parser, &_doc);
+        if (!allowed) {
+            _report.error(u"line %d: trailing %s, invalid XML document, need one single root element", {node->lineNumber(), node->typeName()});
+        }
+        delete node;
+        if (!allowed || !parsed) {
+            return false;
+        }
+    }
+
+    // We must have reached the end of document.
+    _parser.skipWhiteSpace();
+    if (!_parser.eof()) {
+        _report.error(u"line %d: trailing character sequence, invalid XML document", {_parser.lineNumber()});
+        return false;
+    }
+    return true;
+}
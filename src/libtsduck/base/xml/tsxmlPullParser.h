@@ -0,0 +1,140 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Pull-mode parser for XML documents.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsxmlDocument.h"
+#include "tsxmlElement.h"
+#include "tsTextParser.h"
+
+namespace ts {
+    namespace xml {
+        //!
+        //! Pull-mode parser for XML documents.
+        //! @ingroup xml
+        //!
+        //! This parser shares the tokenizer (ts::TextParser) and the element parsing
+        //! code of the DOM classes but does not build a tree for the whole document.
+        //! The document must be structured as a root element containing a list of
+        //! child elements, the usual layout of TSDuck XML files (tables, channels,
+        //! splice information). The parser reads the prolog and the root start tag,
+        //! then returns the children of the root one by one, each of them being a
+        //! fully parsed subtree. Consumers which map each child to some binary
+        //! structure can consequently process arbitrarily large documents with a
+        //! memory footprint which is bounded by the largest child element.
+        //!
+        class TSDUCKDLL PullParser
+        {
+            TS_NOBUILD_NOCOPY(PullParser);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in,out] report Where to report errors.
+            //!
+            explicit PullParser(Report& report);
+
+            //!
+            //! Destructor.
+            //!
+            ~PullParser();
+
+            //!
+            //! Start parsing an XML document from a string.
+            //! The prolog and the root start tag are parsed.
+            //! @param [in] text The XML document.
+            //! @return True on success, false on error.
+            //!
+            bool parse(const UString& text);
+
+            //!
+            //! Start parsing an XML document from a file.
+            //! The prolog and the root start tag are parsed.
+            //! @param [in] fileName Name of the XML file to load.
+            //! @param [in] search If true, use the same search algorithm as xml::Document::load().
+            //! @return True on success, false on error.
+            //!
+            bool open(const UString& fileName, bool search = true);
+
+            //!
+            //! Start parsing an XML document from a text stream.
+            //! The prolog and the root start tag are parsed.
+            //! @param [in,out] strm A standard text stream in input mode.
+            //! @return True on success, false on error.
+            //!
+            bool open(std::istream& strm);
+
+            //!
+            //! Get the root element of the document.
+            //! Only the start tag of the root is parsed: the returned element has
+            //! a name and attributes but no children.
+            //! @return The root element or zero if no document is open.
+            //!
+            const Element* rootElement() const { return _root; }
+
+            //!
+            //! Get the next child element of the root.
+            //! The returned element is a complete subtree, including its own children.
+            //! Comments and text nodes between child elements are silently discarded.
+            //! @return Address of the next child element or zero when the end of the
+            //! document or an error is reached (check success() to distinguish).
+            //! The caller owns the returned element and shall delete it after use.
+            //!
+            Element* nextElement();
+
+            //!
+            //! Check if the document was completely and successfully parsed.
+            //! @return True when the end of the document was reached without error.
+            //!
+            bool success() const { return _ok && _done; }
+
+            //!
+            //! Close the parser and release the document text.
+            //!
+            void close();
+
+        private:
+            Report&    _report;   // Where to report errors.
+            TextParser _parser;   // Tokenizer, owns the document text.
+            Document   _doc;      // Empty document, used as parsing context and parent.
+            Element*   _root;     // Root element, start tag only, no children.
+            bool       _done;     // The root end tag was reached.
+            bool       _ok;       // No parsing error so far.
+
+            // Parse the document prolog and the root start tag. Return success.
+            bool parseProlog();
+
+            // Parse the root end tag and the document epilog. Return success.
+            bool parseEpilog();
+        };
+    }
+}
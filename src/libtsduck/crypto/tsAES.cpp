@@ -16,6 +16,121 @@
 #include "tsAES.h"
 TSDUCK_SOURCE;
 
+// The hardware-accelerated backend uses the AES-NI instructions on x86.
+// The functions are compiled with a specific target attribute and are only
+// invoked after a runtime check of the CPU features.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define TS_AES_NI 1
+    #include <x86intrin.h>
+#endif
+
+#if defined(TS_AES_NI)
+namespace {
+
+    // Runtime check for AES-NI support.
+    bool aesHasNI()
+    {
+        static const bool supported = __builtin_cpu_supports("aes") && __builtin_cpu_supports("sse2");
+        return supported;
+    }
+
+    // Build the decryption round keys from the serialized encryption round
+    // keys: same keys in reverse order, transformed through AESIMC for the
+    // equivalent inverse cipher, except the first and last ones.
+    __attribute__((target("aes,sse2")))
+    void aesNISetDecryptKeys(const uint8_t* ekb, uint8_t* dkb, int Nr)
+    {
+        const __m128i* ek = reinterpret_cast<const __m128i*>(ekb);
+        __m128i* dk = reinterpret_cast<__m128i*>(dkb);
+        _mm_storeu_si128(dk, _mm_loadu_si128(ek + Nr));
+        for (int i = 1; i < Nr; ++i) {
+            _mm_storeu_si128(dk + i, _mm_aesimc_si128(_mm_loadu_si128(ek + Nr - i)));
+        }
+        _mm_storeu_si128(dk + Nr, _mm_loadu_si128(ek));
+    }
+
+    // Encrypt blocks in ECB mode, four blocks pipelined per iteration.
+    __attribute__((target("aes,sse2")))
+    void aesNIEncrypt(const uint8_t* ekb, int Nr, const uint8_t* pt, uint8_t* ct, size_t blocks)
+    {
+        const __m128i* rkp = reinterpret_cast<const __m128i*>(ekb);
+        const __m128i* in = reinterpret_cast<const __m128i*>(pt);
+        __m128i* out = reinterpret_cast<__m128i*>(ct);
+        __m128i rk[15];
+        for (int r = 0; r <= Nr; ++r) {
+            rk[r] = _mm_loadu_si128(rkp + r);
+        }
+        while (blocks >= 4) {
+            __m128i b0 = _mm_xor_si128(_mm_loadu_si128(in),     rk[0]);
+            __m128i b1 = _mm_xor_si128(_mm_loadu_si128(in + 1), rk[0]);
+            __m128i b2 = _mm_xor_si128(_mm_loadu_si128(in + 2), rk[0]);
+            __m128i b3 = _mm_xor_si128(_mm_loadu_si128(in + 3), rk[0]);
+            for (int r = 1; r < Nr; ++r) {
+                b0 = _mm_aesenc_si128(b0, rk[r]);
+                b1 = _mm_aesenc_si128(b1, rk[r]);
+                b2 = _mm_aesenc_si128(b2, rk[r]);
+                b3 = _mm_aesenc_si128(b3, rk[r]);
+            }
+            _mm_storeu_si128(out,     _mm_aesenclast_si128(b0, rk[Nr]));
+            _mm_storeu_si128(out + 1, _mm_aesenclast_si128(b1, rk[Nr]));
+            _mm_storeu_si128(out + 2, _mm_aesenclast_si128(b2, rk[Nr]));
+            _mm_storeu_si128(out + 3, _mm_aesenclast_si128(b3, rk[Nr]));
+            in += 4;
+            out += 4;
+            blocks -= 4;
+        }
+        while (blocks > 0) {
+            __m128i b = _mm_xor_si128(_mm_loadu_si128(in++), rk[0]);
+            for (int r = 1; r < Nr; ++r) {
+                b = _mm_aesenc_si128(b, rk[r]);
+            }
+            _mm_storeu_si128(out++, _mm_aesenclast_si128(b, rk[Nr]));
+            blocks--;
+        }
+    }
+
+    // Decrypt blocks in ECB mode, four blocks pipelined per iteration.
+    __attribute__((target("aes,sse2")))
+    void aesNIDecrypt(const uint8_t* dkb, int Nr, const uint8_t* ct, uint8_t* pt, size_t blocks)
+    {
+        const __m128i* rkp = reinterpret_cast<const __m128i*>(dkb);
+        const __m128i* in = reinterpret_cast<const __m128i*>(ct);
+        __m128i* out = reinterpret_cast<__m128i*>(pt);
+        __m128i rk[15];
+        for (int r = 0; r <= Nr; ++r) {
+            rk[r] = _mm_loadu_si128(rkp + r);
+        }
+        while (blocks >= 4) {
+            __m128i b0 = _mm_xor_si128(_mm_loadu_si128(in),     rk[0]);
+            __m128i b1 = _mm_xor_si128(_mm_loadu_si128(in + 1), rk[0]);
+            __m128i b2 = _mm_xor_si128(_mm_loadu_si128(in + 2), rk[0]);
+            __m128i b3 = _mm_xor_si128(_mm_loadu_si128(in + 3), rk[0]);
+            for (int r = 1; r < Nr; ++r) {
+                b0 = _mm_aesdec_si128(b0, rk[r]);
+                b1 = _mm_aesdec_si128(b1, rk[r]);
+                b2 = _mm_aesdec_si128(b2, rk[r]);
+                b3 = _mm_aesdec_si128(b3, rk[r]);
+            }
+            _mm_storeu_si128(out,     _mm_aesdeclast_si128(b0, rk[Nr]));
+            _mm_storeu_si128(out + 1, _mm_aesdeclast_si128(b1, rk[Nr]));
+            _mm_storeu_si128(out + 2, _mm_aesdeclast_si128(b2, rk[Nr]));
+            _mm_storeu_si128(out + 3, _mm_aesdeclast_si128(b3, rk[Nr]));
+            in += 4;
+            out += 4;
+            blocks -= 4;
+        }
+        while (blocks > 0) {
+            __m128i b = _mm_xor_si128(_mm_loadu_si128(in++), rk[0]);
+            for (int r = 1; r < Nr; ++r) {
+                b = _mm_aesdec_si128(b, rk[r]);
+            }
+            _mm_storeu_si128(out++, _mm_aesdeclast_si128(b, rk[Nr]));
+            blocks--;
+        }
+    }
+}
+#endif // TS_AES_NI
+
 #define BYTE(x,n) (((x) >> (8 * (n))) & 255)
 
 namespace {
@@ -1164,6 +1279,19 @@ bool ts::AES::setKeyImpl(const void* key_, size_t key_length, size_t rounds)
     *rk++ = *rrk++;
     *rk   = *rrk;
 
+#if defined(TS_AES_NI)
+    // Serialize the round keys for the hardware-accelerated backend.
+    // The big-endian serialization of _eK is exactly the standard FIPS-197
+    // expanded key, as expected by the AES instructions.
+    _hw = aesHasNI();
+    if (_hw) {
+        for (i = 0; i < j; i++) {
+            PutUInt32(_eKb + 4 * i, _eK[i]);
+        }
+        aesNISetDecryptKeys(_eKb, _dKb, _Nr);
+    }
+#endif
+
     return true;
 }
 
@@ -1174,120 +1302,133 @@ bool ts::AES::setKeyImpl(const void* key_, size_t key_length, size_t rounds)
 
 bool ts::AES::encryptImpl(const void* plain, size_t plain_length, void* cipher, size_t cipher_maxsize, size_t* cipher_length)
 {
-    if (plain_length != BLOCK_SIZE || cipher_maxsize < BLOCK_SIZE) {
+    // Any multiple of the block size is accepted (ECB mode).
+    if (plain_length == 0 || plain_length % BLOCK_SIZE != 0 || cipher_maxsize < plain_length) {
         return false;
     }
+    if (cipher_length != nullptr) {
+        *cipher_length = plain_length;
+    }
 
     const uint8_t* pt = reinterpret_cast<const uint8_t*> (plain);
     uint8_t* ct = reinterpret_cast<uint8_t*> (cipher);
+    size_t blocks = plain_length / BLOCK_SIZE;
+
+#if defined(TS_AES_NI)
+    if (_hw) {
+        aesNIEncrypt(_eKb, _Nr, pt, ct, blocks);
+        return true;
+    }
+#endif
 
     uint32_t s0, s1, s2, s3, t0, t1, t2, t3, *rk;
     int Nr, r;
 
-    Nr = _Nr;
-    rk = _eK;
+    do {
+        Nr = _Nr;
+        rk = _eK;
 
-    // Map byte array block to cipher state and add initial round key:
-
-    s0 = GetUInt32 (pt      ); s0 ^= rk[0];
-    s1 = GetUInt32 (pt  +  4); s1 ^= rk[1];
-    s2 = GetUInt32 (pt  +  8); s2 ^= rk[2];
-    s3 = GetUInt32 (pt  + 12); s3 ^= rk[3];
-
-    // Nr - 1 full rounds:
-
-    r = Nr >> 1;
-    for (;;) {
-        t0 =
-            Te0(BYTE (s0, 3)) ^
-            Te1(BYTE (s1, 2)) ^
-            Te2(BYTE (s2, 1)) ^
-            Te3(BYTE (s3, 0)) ^
-            rk[4];
-        t1 =
-            Te0(BYTE (s1, 3)) ^
-            Te1(BYTE (s2, 2)) ^
-            Te2(BYTE (s3, 1)) ^
-            Te3(BYTE (s0, 0)) ^
-            rk[5];
-        t2 =
-            Te0(BYTE (s2, 3)) ^
-            Te1(BYTE (s3, 2)) ^
-            Te2(BYTE (s0, 1)) ^
-            Te3(BYTE (s1, 0)) ^
-            rk[6];
-        t3 =
-            Te0(BYTE (s3, 3)) ^
-            Te1(BYTE (s0, 2)) ^
-            Te2(BYTE (s1, 1)) ^
-            Te3(BYTE (s2, 0)) ^
-            rk[7];
-
-        rk += 8;
-        if (--r == 0) {
-            break;
+        // Map byte array block to cipher state and add initial round key:
+
+        s0 = GetUInt32 (pt      ); s0 ^= rk[0];
+        s1 = GetUInt32 (pt  +  4); s1 ^= rk[1];
+        s2 = GetUInt32 (pt  +  8); s2 ^= rk[2];
+        s3 = GetUInt32 (pt  + 12); s3 ^= rk[3];
+
+        // Nr - 1 full rounds:
+
+        r = Nr >> 1;
+        for (;;) {
+            t0 =
+                Te0(BYTE (s0, 3)) ^
+                Te1(BYTE (s1, 2)) ^
+                Te2(BYTE (s2, 1)) ^
+                Te3(BYTE (s3, 0)) ^
+                rk[4];
+            t1 =
+                Te0(BYTE (s1, 3)) ^
+                Te1(BYTE (s2, 2)) ^
+                Te2(BYTE (s3, 1)) ^
+                Te3(BYTE (s0, 0)) ^
+                rk[5];
+            t2 =
+                Te0(BYTE (s2, 3)) ^
+                Te1(BYTE (s3, 2)) ^
+                Te2(BYTE (s0, 1)) ^
+                Te3(BYTE (s1, 0)) ^
+                rk[6];
+            t3 =
+                Te0(BYTE (s3, 3)) ^
+                Te1(BYTE (s0, 2)) ^
+                Te2(BYTE (s1, 1)) ^
+                Te3(BYTE (s2, 0)) ^
+                rk[7];
+
+            rk += 8;
+            if (--r == 0) {
+                break;
+            }
+
+            s0 =
+                Te0(BYTE (t0, 3)) ^
+                Te1(BYTE (t1, 2)) ^
+                Te2(BYTE (t2, 1)) ^
+                Te3(BYTE (t3, 0)) ^
+                rk[0];
+            s1 =
+                Te0(BYTE (t1, 3)) ^
+                Te1(BYTE (t2, 2)) ^
+                Te2(BYTE (t3, 1)) ^
+                Te3(BYTE (t0, 0)) ^
+                rk[1];
+            s2 =
+                Te0(BYTE (t2, 3)) ^
+                Te1(BYTE (t3, 2)) ^
+                Te2(BYTE (t0, 1)) ^
+                Te3(BYTE (t1, 0)) ^
+                rk[2];
+            s3 =
+                Te0(BYTE (t3, 3)) ^
+                Te1(BYTE (t0, 2)) ^
+                Te2(BYTE (t1, 1)) ^
+                Te3(BYTE (t2, 0)) ^
+                rk[3];
         }
 
+        // Apply last round and map cipher state to byte array block:
+
         s0 =
-            Te0(BYTE (t0, 3)) ^
-            Te1(BYTE (t1, 2)) ^
-            Te2(BYTE (t2, 1)) ^
-            Te3(BYTE (t3, 0)) ^
+            (Te4_3[BYTE (t0, 3)]) ^
+            (Te4_2[BYTE (t1, 2)]) ^
+            (Te4_1[BYTE (t2, 1)]) ^
+            (Te4_0[BYTE (t3, 0)]) ^
             rk[0];
+        PutUInt32 (ct, s0);
         s1 =
-            Te0(BYTE (t1, 3)) ^
-            Te1(BYTE (t2, 2)) ^
-            Te2(BYTE (t3, 1)) ^
-            Te3(BYTE (t0, 0)) ^
+            (Te4_3[BYTE (t1, 3)]) ^
+            (Te4_2[BYTE (t2, 2)]) ^
+            (Te4_1[BYTE (t3, 1)]) ^
+            (Te4_0[BYTE (t0, 0)]) ^
             rk[1];
+        PutUInt32 (ct+4, s1);
         s2 =
-            Te0(BYTE (t2, 3)) ^
-            Te1(BYTE (t3, 2)) ^
-            Te2(BYTE (t0, 1)) ^
-            Te3(BYTE (t1, 0)) ^
+            (Te4_3[BYTE (t2, 3)]) ^
+            (Te4_2[BYTE (t3, 2)]) ^
+            (Te4_1[BYTE (t0, 1)]) ^
+            (Te4_0[BYTE (t1, 0)]) ^
             rk[2];
+        PutUInt32 (ct+8, s2);
         s3 =
-            Te0(BYTE (t3, 3)) ^
-            Te1(BYTE (t0, 2)) ^
-            Te2(BYTE (t1, 1)) ^
-            Te3(BYTE (t2, 0)) ^
+            (Te4_3[BYTE (t3, 3)]) ^
+            (Te4_2[BYTE (t0, 2)]) ^
+            (Te4_1[BYTE (t1, 1)]) ^
+            (Te4_0[BYTE (t2, 0)]) ^
             rk[3];
-    }
+        PutUInt32 (ct+12, s3);
 
-    // Apply last round and map cipher state to byte array block:
-
-    s0 =
-        (Te4_3[BYTE (t0, 3)]) ^
-        (Te4_2[BYTE (t1, 2)]) ^
-        (Te4_1[BYTE (t2, 1)]) ^
-        (Te4_0[BYTE (t3, 0)]) ^
-        rk[0];
-    PutUInt32 (ct, s0);
-    s1 =
-        (Te4_3[BYTE (t1, 3)]) ^
-        (Te4_2[BYTE (t2, 2)]) ^
-        (Te4_1[BYTE (t3, 1)]) ^
-        (Te4_0[BYTE (t0, 0)]) ^
-        rk[1];
-    PutUInt32 (ct+4, s1);
-    s2 =
-        (Te4_3[BYTE (t2, 3)]) ^
-        (Te4_2[BYTE (t3, 2)]) ^
-        (Te4_1[BYTE (t0, 1)]) ^
-        (Te4_0[BYTE (t1, 0)]) ^
-        rk[2];
-    PutUInt32 (ct+8, s2);
-    s3 =
-        (Te4_3[BYTE (t3, 3)]) ^
-        (Te4_2[BYTE (t0, 2)]) ^
-        (Te4_1[BYTE (t1, 1)]) ^
-        (Te4_0[BYTE (t2, 0)]) ^
-        rk[3];
-    PutUInt32 (ct+12, s3);
-
-    if (cipher_length != nullptr) {
-        *cipher_length = BLOCK_SIZE;
-    }
+        pt += BLOCK_SIZE;
+        ct += BLOCK_SIZE;
+    } while (--blocks != 0);
 
     return true;
 }
@@ -1299,121 +1440,134 @@ bool ts::AES::encryptImpl(const void* plain, size_t plain_length, void* cipher,
 
 bool ts::AES::decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length)
 {
-    if (cipher_length != BLOCK_SIZE || plain_maxsize < BLOCK_SIZE) {
+    // Any multiple of the block size is accepted (ECB mode).
+    if (cipher_length == 0 || cipher_length % BLOCK_SIZE != 0 || plain_maxsize < cipher_length) {
         return false;
     }
+    if (plain_length != nullptr) {
+        *plain_length = cipher_length;
+    }
 
     const uint8_t* ct = reinterpret_cast<const uint8_t*> (cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*> (plain);
+    size_t blocks = cipher_length / BLOCK_SIZE;
+
+#if defined(TS_AES_NI)
+    if (_hw) {
+        aesNIDecrypt(_dKb, _Nr, ct, pt, blocks);
+        return true;
+    }
+#endif
 
     uint32_t s0, s1, s2, s3, t0, t1, t2, t3, *rk;
     int Nr, r;
 
-    Nr = _Nr;
-    rk = _dK;
-
-    // Map byte array block to cipher state and add initial round key:
-
-    s0 = GetUInt32 (ct      ); s0 ^= rk[0];
-    s1 = GetUInt32 (ct  +  4); s1 ^= rk[1];
-    s2 = GetUInt32 (ct  +  8); s2 ^= rk[2];
-    s3 = GetUInt32 (ct  + 12); s3 ^= rk[3];
-
-    // Nr - 1 full rounds:
-
-    r = Nr >> 1;
-    for (;;) {
-
-        t0 =
-            Td0(BYTE (s0, 3)) ^
-            Td1(BYTE (s3, 2)) ^
-            Td2(BYTE (s2, 1)) ^
-            Td3(BYTE (s1, 0)) ^
-            rk[4];
-        t1 =
-            Td0(BYTE (s1, 3)) ^
-            Td1(BYTE (s0, 2)) ^
-            Td2(BYTE (s3, 1)) ^
-            Td3(BYTE (s2, 0)) ^
-            rk[5];
-        t2 =
-            Td0(BYTE (s2, 3)) ^
-            Td1(BYTE (s1, 2)) ^
-            Td2(BYTE (s0, 1)) ^
-            Td3(BYTE (s3, 0)) ^
-            rk[6];
-        t3 =
-            Td0(BYTE (s3, 3)) ^
-            Td1(BYTE (s2, 2)) ^
-            Td2(BYTE (s1, 1)) ^
-            Td3(BYTE (s0, 0)) ^
-            rk[7];
-
-        rk += 8;
-        if (--r == 0) {
-            break;
+    do {
+        Nr = _Nr;
+        rk = _dK;
+
+        // Map byte array block to cipher state and add initial round key:
+
+        s0 = GetUInt32 (ct      ); s0 ^= rk[0];
+        s1 = GetUInt32 (ct  +  4); s1 ^= rk[1];
+        s2 = GetUInt32 (ct  +  8); s2 ^= rk[2];
+        s3 = GetUInt32 (ct  + 12); s3 ^= rk[3];
+
+        // Nr - 1 full rounds:
+
+        r = Nr >> 1;
+        for (;;) {
+
+            t0 =
+                Td0(BYTE (s0, 3)) ^
+                Td1(BYTE (s3, 2)) ^
+                Td2(BYTE (s2, 1)) ^
+                Td3(BYTE (s1, 0)) ^
+                rk[4];
+            t1 =
+                Td0(BYTE (s1, 3)) ^
+                Td1(BYTE (s0, 2)) ^
+                Td2(BYTE (s3, 1)) ^
+                Td3(BYTE (s2, 0)) ^
+                rk[5];
+            t2 =
+                Td0(BYTE (s2, 3)) ^
+                Td1(BYTE (s1, 2)) ^
+                Td2(BYTE (s0, 1)) ^
+                Td3(BYTE (s3, 0)) ^
+                rk[6];
+            t3 =
+                Td0(BYTE (s3, 3)) ^
+                Td1(BYTE (s2, 2)) ^
+                Td2(BYTE (s1, 1)) ^
+                Td3(BYTE (s0, 0)) ^
+                rk[7];
+
+            rk += 8;
+            if (--r == 0) {
+                break;
+            }
+
+            s0 =
+                Td0(BYTE (t0, 3)) ^
+                Td1(BYTE (t3, 2)) ^
+                Td2(BYTE (t2, 1)) ^
+                Td3(BYTE (t1, 0)) ^
+                rk[0];
+            s1 =
+                Td0(BYTE (t1, 3)) ^
+                Td1(BYTE (t0, 2)) ^
+                Td2(BYTE (t3, 1)) ^
+                Td3(BYTE (t2, 0)) ^
+                rk[1];
+            s2 =
+                Td0(BYTE (t2, 3)) ^
+                Td1(BYTE (t1, 2)) ^
+                Td2(BYTE (t0, 1)) ^
+                Td3(BYTE (t3, 0)) ^
+                rk[2];
+            s3 =
+                Td0(BYTE (t3, 3)) ^
+                Td1(BYTE (t2, 2)) ^
+                Td2(BYTE (t1, 1)) ^
+                Td3(BYTE (t0, 0)) ^
+                rk[3];
         }
 
+        // Apply last round and map cipher state to byte array block:
+
         s0 =
-            Td0(BYTE (t0, 3)) ^
-            Td1(BYTE (t3, 2)) ^
-            Td2(BYTE (t2, 1)) ^
-            Td3(BYTE (t1, 0)) ^
+            (Td4[BYTE (t0, 3)] & 0xff000000) ^
+            (Td4[BYTE (t3, 2)] & 0x00ff0000) ^
+            (Td4[BYTE (t2, 1)] & 0x0000ff00) ^
+            (Td4[BYTE (t1, 0)] & 0x000000ff) ^
             rk[0];
+        PutUInt32 (pt, s0);
         s1 =
-            Td0(BYTE (t1, 3)) ^
-            Td1(BYTE (t0, 2)) ^
-            Td2(BYTE (t3, 1)) ^
-            Td3(BYTE (t2, 0)) ^
+            (Td4[BYTE (t1, 3)] & 0xff000000) ^
+            (Td4[BYTE (t0, 2)] & 0x00ff0000) ^
+            (Td4[BYTE (t3, 1)] & 0x0000ff00) ^
+            (Td4[BYTE (t2, 0)] & 0x000000ff) ^
             rk[1];
+        PutUInt32 (pt+4, s1);
         s2 =
-            Td0(BYTE (t2, 3)) ^
-            Td1(BYTE (t1, 2)) ^
-            Td2(BYTE (t0, 1)) ^
-            Td3(BYTE (t3, 0)) ^
+            (Td4[BYTE (t2, 3)] & 0xff000000) ^
+            (Td4[BYTE (t1, 2)] & 0x00ff0000) ^
+            (Td4[BYTE (t0, 1)] & 0x0000ff00) ^
+            (Td4[BYTE (t3, 0)] & 0x000000ff) ^
             rk[2];
+        PutUInt32 (pt+8, s2);
         s3 =
-            Td0(BYTE (t3, 3)) ^
-            Td1(BYTE (t2, 2)) ^
-            Td2(BYTE (t1, 1)) ^
-            Td3(BYTE (t0, 0)) ^
+            (Td4[BYTE (t3, 3)] & 0xff000000) ^
+            (Td4[BYTE (t2, 2)] & 0x00ff0000) ^
+            (Td4[BYTE (t1, 1)] & 0x0000ff00) ^
+            (Td4[BYTE (t0, 0)] & 0x000000ff) ^
             rk[3];
-    }
+        PutUInt32 (pt+12, s3);
 
-    // Apply last round and map cipher state to byte array block:
-
-    s0 =
-        (Td4[BYTE (t0, 3)] & 0xff000000) ^
-        (Td4[BYTE (t3, 2)] & 0x00ff0000) ^
-        (Td4[BYTE (t2, 1)] & 0x0000ff00) ^
-        (Td4[BYTE (t1, 0)] & 0x000000ff) ^
-        rk[0];
-    PutUInt32 (pt, s0);
-    s1 =
-        (Td4[BYTE (t1, 3)] & 0xff000000) ^
-        (Td4[BYTE (t0, 2)] & 0x00ff0000) ^
-        (Td4[BYTE (t3, 1)] & 0x0000ff00) ^
-        (Td4[BYTE (t2, 0)] & 0x000000ff) ^
-        rk[1];
-    PutUInt32 (pt+4, s1);
-    s2 =
-        (Td4[BYTE (t2, 3)] & 0xff000000) ^
-        (Td4[BYTE (t1, 2)] & 0x00ff0000) ^
-        (Td4[BYTE (t0, 1)] & 0x0000ff00) ^
-        (Td4[BYTE (t3, 0)] & 0x000000ff) ^
-        rk[2];
-    PutUInt32 (pt+8, s2);
-    s3 =
-        (Td4[BYTE (t3, 3)] & 0xff000000) ^
-        (Td4[BYTE (t2, 2)] & 0x00ff0000) ^
-        (Td4[BYTE (t1, 1)] & 0x0000ff00) ^
-        (Td4[BYTE (t0, 0)] & 0x000000ff) ^
-        rk[3];
-    PutUInt32 (pt+12, s3);
-
-    if (plain_length != nullptr) {
-        *plain_length = BLOCK_SIZE;
-    }
+        ct += BLOCK_SIZE;
+        pt += BLOCK_SIZE;
+    } while (--blocks != 0);
 
     return true;
 }
@@ -1426,7 +1580,10 @@ bool ts::AES::decryptImpl(const void* cipher, size_t cipher_length, void* plain,
 ts::AES::AES() :
     _Nr(0),
     _eK(),
-    _dK()
+    _dK(),
+    _hw(false),
+    _eKb(),
+    _dKb()
 {
 }
 
@@ -1467,3 +1624,7 @@ size_t ts::AES::defaultRounds() const
 {
     return DEFAULT_ROUNDS;
 }
+bool ts::AES::supportsMultipleBlocks() const
+{
+    return true;
+}
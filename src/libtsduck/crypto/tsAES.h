@@ -61,6 +61,7 @@ namespace ts {
         virtual size_t minRounds() const override;
         virtual size_t maxRounds() const override;
         virtual size_t defaultRounds() const override;
+        virtual bool supportsMultipleBlocks() const override;
 
     protected:
         // Implementation of BlockCipher interface:
@@ -72,5 +73,8 @@ namespace ts {
         int      _Nr;     //!< Number of rounds
         uint32_t _eK[60]; //!< Scheduled encryption keys
         uint32_t _dK[60]; //!< Scheduled decryption keys
+        bool     _hw;     //!< Use the hardware-accelerated backend (runtime detection).
+        uint8_t  _eKb[16 * (MAX_ROUNDS + 1)]; //!< Serialized encryption round keys for the hardware backend.
+        uint8_t  _dKb[16 * (MAX_ROUNDS + 1)]; //!< Serialized decryption round keys for the hardware backend.
     };
 }
@@ -53,6 +53,16 @@ ts::BlockCipher::~BlockCipher()
 }
 
 
+//----------------------------------------------------------------------------
+// Check if the implementation accepts several blocks per call.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::supportsMultipleBlocks() const
+{
+    return false;
+}
+
+
 //----------------------------------------------------------------------------
 // Get the current key.
 //----------------------------------------------------------------------------
@@ -186,3 +196,50 @@ bool ts::BlockCipher::decryptInPlaceImpl(void* data, size_t data_length, size_t*
     const size_t plain_max_size = max_actual_length != nullptr ? *max_actual_length : data_length;
     return decryptImpl(cipher.data(), cipher.size(), data, plain_max_size, max_actual_length);
 }
+
+
+//----------------------------------------------------------------------------
+// Encrypt / decrypt a batch of scattered data fragments in place.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::encryptBatch(const CipherFragment* frag, size_t count)
+{
+    // Check and count the key usage once per fragment, as with individual calls.
+    for (size_t i = 0; i < count; ++i) {
+        if (!allowEncrypt()) {
+            return false;
+        }
+    }
+    return count == 0 || encryptBatchImpl(frag, count);
+}
+
+bool ts::BlockCipher::encryptBatchImpl(const CipherFragment* frag, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (!encryptInPlaceImpl(frag[i].data, frag[i].length, nullptr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ts::BlockCipher::decryptBatch(const CipherFragment* frag, size_t count)
+{
+    // Check and count the key usage once per fragment, as with individual calls.
+    for (size_t i = 0; i < count; ++i) {
+        if (!allowDecrypt()) {
+            return false;
+        }
+    }
+    return count == 0 || decryptBatchImpl(frag, count);
+}
+
+bool ts::BlockCipher::decryptBatchImpl(const CipherFragment* frag, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (!decryptInPlaceImpl(frag[i].data, frag[i].length, nullptr)) {
+            return false;
+        }
+    }
+    return true;
+}
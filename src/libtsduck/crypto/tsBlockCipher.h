@@ -40,6 +40,18 @@ namespace ts {
 
     class BlockCipherAlertInterface;
 
+    //!
+    //! Description of one data fragment in a scatter-gather cipher batch.
+    //! @ingroup crypto
+    //! @see ts::BlockCipher::encryptBatch()
+    //! @see ts::BlockCipher::decryptBatch()
+    //!
+    struct TSDUCKDLL CipherFragment
+    {
+        void*  data;    //!< Address of the fragment, ciphered in place.
+        size_t length;  //!< Fragment length in bytes.
+    };
+
     //!
     //! Abstract interface of block ciphers.
     //! @ingroup crypto
@@ -107,6 +119,16 @@ namespace ts {
         //!
         virtual size_t defaultRounds() const = 0;
 
+        //!
+        //! Check if the implementation accepts several blocks in one encrypt() or decrypt() call.
+        //! When true, the data size can be any multiple of the block size and the blocks are
+        //! processed independently, in ECB fashion. When false, exactly one block is processed
+        //! per call. Chaining modes use this to amortize the per-call overhead on runs of blocks.
+        //! @return True if several blocks are accepted per call. The default implementation
+        //! returns false.
+        //!
+        virtual bool supportsMultipleBlocks() const;
+
         //!
         //! Schedule a new key.
         //! @param [in] key Address of key value.
@@ -189,6 +211,35 @@ namespace ts {
         //!
         bool decryptInPlace(void* data, size_t data_length, size_t* max_actual_length = nullptr);
 
+        //!
+        //! Encrypt a batch of scattered data fragments in place.
+        //!
+        //! Each fragment is ciphered independently, with the same result as one call
+        //! to encryptInPlace() per fragment, but the whole batch is processed with
+        //! one single virtual dispatch. Typical use case: the payloads of a run of
+        //! transport stream packets, scattered across the packet buffer. The ciphered
+        //! data keep the size of the original fragments.
+        //!
+        //! @param [in] frag Address of an array of fragment descriptions.
+        //! @param [in] count Number of fragments in @a frag.
+        //! @return True on success, false on error.
+        //!
+        bool encryptBatch(const CipherFragment* frag, size_t count);
+
+        //!
+        //! Decrypt a batch of scattered data fragments in place.
+        //!
+        //! Each fragment is deciphered independently, with the same result as one call
+        //! to decryptInPlace() per fragment, but the whole batch is processed with
+        //! one single virtual dispatch. The deciphered data keep the size of the
+        //! original fragments.
+        //!
+        //! @param [in] frag Address of an array of fragment descriptions.
+        //! @param [in] count Number of fragments in @a frag.
+        //! @return True on success, false on error.
+        //!
+        bool decryptBatch(const CipherFragment* frag, size_t count);
+
         //!
         //! Get the number of times the current key was used for encryption.
         //! @return The number of times the current key was used for encryption.
@@ -314,6 +365,26 @@ namespace ts {
         //!
         virtual bool decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length);
 
+        //!
+        //! Encrypt a batch of scattered data fragments (implementation of algorithm-specific part).
+        //! The default implementation processes each fragment with encryptInPlaceImpl().
+        //! A subclass may provide a more efficient implementation.
+        //! @param [in] frag Address of an array of fragment descriptions.
+        //! @param [in] count Number of fragments in @a frag.
+        //! @return True on success, false on error.
+        //!
+        virtual bool encryptBatchImpl(const CipherFragment* frag, size_t count);
+
+        //!
+        //! Decrypt a batch of scattered data fragments (implementation of algorithm-specific part).
+        //! The default implementation processes each fragment with decryptInPlaceImpl().
+        //! A subclass may provide a more efficient implementation.
+        //! @param [in] frag Address of an array of fragment descriptions.
+        //! @param [in] count Number of fragments in @a frag.
+        //! @return True on success, false on error.
+        //!
+        virtual bool decryptBatchImpl(const CipherFragment* frag, size_t count);
+
     private:
         bool      _key_set;                // Current key successfully set.
         int       _cipher_id;              // Cipher identity (from application).
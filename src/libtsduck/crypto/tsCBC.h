@@ -50,10 +50,20 @@ namespace ts {
     {
         TS_NOCOPY(CBC);
     public:
+        //!
+        //! Number of blocks per chunk in multi-block decryption.
+        //! CBC decryption, unlike encryption, is parallelizable across blocks. When the
+        //! underlying cipher accepts several blocks per call (e.g. hardware-accelerated
+        //! AES), decryption is performed on chunks of this many blocks at a time.
+        //!
+        static constexpr size_t DECRYPT_CHUNK_BLOCKS = 8;
+
         //!
         //! Constructor.
+        //! The work buffer holds one decryption chunk plus two spare blocks
+        //! for the in-place decryption of overlapping buffers.
         //!
-        CBC() : CipherChainingTemplate<CIPHER>(1, 1, 1) {}
+        CBC() : CipherChainingTemplate<CIPHER>(1, 1, DECRYPT_CHUNK_BLOCKS + 2) {}
 
         // Implementation of BlockCipher and CipherChaining interfaces.
         // For some reason, doxygen is unable to automatically inherit the
@@ -75,6 +85,15 @@ namespace ts {
 
         //! @copydoc ts::BlockCipher::decryptImpl()
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
+
+        //! @copydoc ts::BlockCipher::decryptInPlaceImpl()
+        virtual bool decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length) override;
+
+        //! @copydoc ts::BlockCipher::encryptBatchImpl()
+        virtual bool encryptBatchImpl(const CipherFragment* frag, size_t count) override;
+
+        //! @copydoc ts::BlockCipher::decryptBatchImpl()
+        virtual bool decryptBatchImpl(const CipherFragment* frag, size_t count) override;
     };
 }
 
@@ -102,23 +102,128 @@ bool ts::CBC<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
     const uint8_t* ct = reinterpret_cast<const uint8_t*> (cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*> (plain);
 
+    // Unlike encryption, CBC decryption is parallelizable across blocks.
+    // When the underlying cipher accepts several blocks per call (e.g.
+    // hardware-accelerated AES), decrypt whole chunks at once and XOR each
+    // decrypted block with the preceding cipher-text block afterwards.
+    const size_t chunk_max =
+        this->algo->supportsMultipleBlocks() && this->work.size() >= DECRYPT_CHUNK_BLOCKS * this->block_size ?
+        DECRYPT_CHUNK_BLOCKS * this->block_size :
+        this->block_size;
+
     while (cipher_length > 0) {
-        // work = decrypt (cipher-text)
-        if (!this->algo->decrypt(ct, this->block_size, this->work.data(), this->block_size)) {
+        const size_t chunk = cipher_length < chunk_max ? cipher_length : chunk_max;
+        // work = decrypt (cipher-text blocks)
+        if (!this->algo->decrypt(ct, chunk, this->work.data(), chunk)) {
             return false;
         }
         // plain-text = previous-cipher XOR work
-        for (size_t i = 0; i < this->block_size; ++i) {
-            pt[i] = previous[i] ^ this->work[i];
+        for (size_t offset = 0; offset < chunk; offset += this->block_size) {
+            for (size_t i = 0; i < this->block_size; ++i) {
+                pt[offset + i] = previous[i] ^ this->work[offset + i];
+            }
+            // previous-cipher = cipher-text
+            previous = ct + offset;
         }
-        // previous-cipher = cipher-text
-        previous = ct;
-        // advance one block
-        ct += this->block_size;
-        pt += this->block_size;
-        cipher_length -= this->block_size;
+        // advance one chunk
+        ct += chunk;
+        pt += chunk;
+        cipher_length -= chunk;
+    }
+
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Decryption in CBC mode, in place.
+//----------------------------------------------------------------------------
+
+template<class CIPHER>
+bool ts::CBC<CIPHER>::decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length)
+{
+    // The two spare blocks at the end of the work buffer hold the "previous
+    // cipher-text block", which is overwritten by the decrypted data.
+    if (this->work.size() < (DECRYPT_CHUNK_BLOCKS + 2) * this->block_size) {
+        // Subclass with a smaller work buffer, use the default copy-based implementation.
+        return BlockCipher::decryptInPlaceImpl(data, data_length, max_actual_length);
     }
+    if (this->algo == nullptr ||
+        this->iv.size() != this->block_size ||
+        data_length % this->block_size != 0)
+    {
+        return false;
+    }
+    if (max_actual_length != nullptr) {
+        *max_actual_length = data_length;
+    }
+
+    uint8_t* ct = reinterpret_cast<uint8_t*>(data);
+    uint8_t* const prev = this->work.data() + DECRYPT_CHUNK_BLOCKS * this->block_size;
+    uint8_t* const next_prev = prev + this->block_size;
+    ::memcpy(prev, this->iv.data(), this->block_size);
+
+    const size_t chunk_max =
+        this->algo->supportsMultipleBlocks() ? DECRYPT_CHUNK_BLOCKS * this->block_size : this->block_size;
 
+    while (data_length > 0) {
+        const size_t chunk = data_length < chunk_max ? data_length : chunk_max;
+        // work = decrypt (cipher-text blocks)
+        if (!this->algo->decrypt(ct, chunk, this->work.data(), chunk)) {
+            return false;
+        }
+        // Save the last cipher-text block of the chunk before overwriting it.
+        ::memcpy(next_prev, ct + chunk - this->block_size, this->block_size);
+        // XOR the blocks from last to first so that each previous cipher-text
+        // block is still intact when it is needed.
+        size_t offset = chunk - this->block_size;
+        for (;;) {
+            const uint8_t* previous = offset == 0 ? prev : ct + offset - this->block_size;
+            for (size_t i = 0; i < this->block_size; ++i) {
+                ct[offset + i] = previous[i] ^ this->work[offset + i];
+            }
+            if (offset == 0) {
+                break;
+            }
+            offset -= this->block_size;
+        }
+        // previous-cipher = last cipher-text of the chunk
+        ::memcpy(prev, next_prev, this->block_size);
+        // advance one chunk
+        ct += chunk;
+        data_length -= chunk;
+    }
+
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Scatter-gather batches in CBC mode.
+//----------------------------------------------------------------------------
+
+template<class CIPHER>
+bool ts::CBC<CIPHER>::encryptBatchImpl(const CipherFragment* frag, size_t count)
+{
+    // CBC encryption copies each plain-text block into the work buffer before
+    // ciphering it, so a fragment can be ciphered onto itself without the
+    // temporary copy of the default implementation.
+    for (size_t f = 0; f < count; ++f) {
+        if (!this->encryptImpl(frag[f].data, frag[f].length, frag[f].data, frag[f].length, nullptr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<class CIPHER>
+bool ts::CBC<CIPHER>::decryptBatchImpl(const CipherFragment* frag, size_t count)
+{
+    for (size_t f = 0; f < count; ++f) {
+        if (!this->decryptInPlaceImpl(frag[f].data, frag[f].length, nullptr)) {
+            return false;
+        }
+    }
     return true;
 }
 
@@ -172,3 +172,30 @@ bool ts::CTR<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
     // With CTR, the encryption and decryption are identical operations.
     return this->encryptImpl(cipher, cipher_length, plain, plain_maxsize, plain_length);
 }
+
+
+//----------------------------------------------------------------------------
+// Scatter-gather batches in CTR mode.
+//----------------------------------------------------------------------------
+
+template<class CIPHER>
+bool ts::CTR<CIPHER>::encryptBatchImpl(const CipherFragment* frag, size_t count)
+{
+    // CTR mode XORs the key stream into the data byte by byte, each input byte
+    // is read before the corresponding output byte is written, so a fragment
+    // can be ciphered onto itself without the temporary copy of the default
+    // implementation.
+    for (size_t f = 0; f < count; ++f) {
+        if (!this->encryptImpl(frag[f].data, frag[f].length, frag[f].data, frag[f].length, nullptr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<class CIPHER>
+bool ts::CTR<CIPHER>::decryptBatchImpl(const CipherFragment* frag, size_t count)
+{
+    // With CTR, the encryption and decryption are identical operations.
+    return this->encryptBatchImpl(frag, count);
+}
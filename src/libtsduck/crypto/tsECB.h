@@ -66,6 +66,8 @@ namespace ts {
         // Implementation of BlockCipher interface.
         virtual bool encryptImpl(const void* plain, size_t plain_length, void* cipher, size_t cipher_maxsize, size_t* cipher_length) override;
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
+        virtual bool encryptBatchImpl(const CipherFragment* frag, size_t count) override;
+        virtual bool decryptBatchImpl(const CipherFragment* frag, size_t count) override;
     };
 }
 
@@ -52,6 +52,12 @@ bool ts::ECB<CIPHER>::encryptImpl(const void* plain, size_t plain_length, void*
     const uint8_t* pt = reinterpret_cast<const uint8_t*>(plain);
     uint8_t* ct = reinterpret_cast<uint8_t*>(cipher);
 
+    // When the underlying cipher accepts several blocks per call (e.g.
+    // hardware-accelerated AES), pass the whole run of blocks at once.
+    if (plain_length > 0 && this->algo->supportsMultipleBlocks()) {
+        return this->algo->encrypt(pt, plain_length, ct, plain_length);
+    }
+
     while (plain_length > 0) {
         if (!this->algo->encrypt(pt, this->block_size, ct, this->block_size)) {
             return false;
@@ -82,6 +88,12 @@ bool ts::ECB<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
     const uint8_t* ct = reinterpret_cast<const uint8_t*>(cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*>(plain);
 
+    // When the underlying cipher accepts several blocks per call (e.g.
+    // hardware-accelerated AES), pass the whole run of blocks at once.
+    if (cipher_length > 0 && this->algo->supportsMultipleBlocks()) {
+        return this->algo->decrypt(ct, cipher_length, pt, cipher_length);
+    }
+
     while (cipher_length > 0) {
         if (!this->algo->decrypt(ct, this->block_size, pt, this->block_size)) {
             return false;
@@ -95,6 +107,36 @@ bool ts::ECB<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
 }
 
 
+//----------------------------------------------------------------------------
+// Scatter-gather batches in ECB mode.
+//----------------------------------------------------------------------------
+
+template<class CIPHER>
+bool ts::ECB<CIPHER>::encryptBatchImpl(const CipherFragment* frag, size_t count)
+{
+    // The block ciphers in this library read each block entirely before
+    // writing it, so a fragment can be ciphered onto itself without the
+    // temporary copy of the default implementation.
+    for (size_t f = 0; f < count; ++f) {
+        if (!this->encryptImpl(frag[f].data, frag[f].length, frag[f].data, frag[f].length, nullptr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<class CIPHER>
+bool ts::ECB<CIPHER>::decryptBatchImpl(const CipherFragment* frag, size_t count)
+{
+    for (size_t f = 0; f < count; ++f) {
+        if (!this->decryptImpl(frag[f].data, frag[f].length, frag[f].data, frag[f].length, nullptr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Simple virtual methods.
 //----------------------------------------------------------------------------
@@ -17,6 +17,203 @@
 #include "tsMemory.h"
 TSDUCK_SOURCE;
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define TS_SHA_NI 1
+    #include <x86intrin.h>
+#endif
+
+#if defined(TS_SHA_NI)
+namespace {
+    // Runtime detection of the SHA extensions, evaluated once.
+    bool shaHasNI()
+    {
+        static const bool supported = __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+        return supported;
+    }
+
+    // Compress whole 64-byte blocks with the SHA-1 instructions.
+    __attribute__((target("sha,sse4.1")))
+    void sha1NICompress(uint32_t* state, const uint8_t* buf, size_t blocks)
+    {
+        __m128i abcd, e0, e1;
+        __m128i m0, m1, m2, m3;
+        __m128i abcd_save, e_save;
+        const __m128i mask = _mm_set_epi64x(0x0001020304050607, 0x08090A0B0C0D0E0F);
+
+        // Load the state: ABCD in one register (reversed), E alone.
+        abcd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+        abcd = _mm_shuffle_epi32(abcd, 0x1B);
+        e0 = _mm_set_epi32(int32_t(state[4]), 0, 0, 0);
+
+        while (blocks-- > 0) {
+            abcd_save = abcd;
+            e_save = e0;
+
+            // Rounds 0-3
+            m0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0)), mask);
+            e0 = _mm_add_epi32(e0, m0);
+            e1 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+            // Rounds 4-7
+            m1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 16)), mask);
+            e1 = _mm_sha1nexte_epu32(e1, m1);
+            e0 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+            m0 = _mm_sha1msg1_epu32(m0, m1);
+
+            // Rounds 8-11
+            m2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 32)), mask);
+            e0 = _mm_sha1nexte_epu32(e0, m2);
+            e1 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+            m1 = _mm_sha1msg1_epu32(m1, m2);
+            m0 = _mm_xor_si128(m0, m2);
+
+            // Rounds 12-15
+            m3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 48)), mask);
+            e1 = _mm_sha1nexte_epu32(e1, m3);
+            e0 = abcd;
+            m0 = _mm_sha1msg2_epu32(m0, m3);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+            m2 = _mm_sha1msg1_epu32(m2, m3);
+            m1 = _mm_xor_si128(m1, m3);
+
+            // Rounds 16-19
+            e0 = _mm_sha1nexte_epu32(e0, m0);
+            e1 = abcd;
+            m1 = _mm_sha1msg2_epu32(m1, m0);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+            m3 = _mm_sha1msg1_epu32(m3, m0);
+            m2 = _mm_xor_si128(m2, m0);
+
+            // Rounds 20-23
+            e1 = _mm_sha1nexte_epu32(e1, m1);
+            e0 = abcd;
+            m2 = _mm_sha1msg2_epu32(m2, m1);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 1);
+            m0 = _mm_sha1msg1_epu32(m0, m1);
+            m3 = _mm_xor_si128(m3, m1);
+
+            // Rounds 24-27
+            e0 = _mm_sha1nexte_epu32(e0, m2);
+            e1 = abcd;
+            m3 = _mm_sha1msg2_epu32(m3, m2);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 1);
+            m1 = _mm_sha1msg1_epu32(m1, m2);
+            m0 = _mm_xor_si128(m0, m2);
+
+            // Rounds 28-31
+            e1 = _mm_sha1nexte_epu32(e1, m3);
+            e0 = abcd;
+            m0 = _mm_sha1msg2_epu32(m0, m3);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 1);
+            m2 = _mm_sha1msg1_epu32(m2, m3);
+            m1 = _mm_xor_si128(m1, m3);
+
+            // Rounds 32-35
+            e0 = _mm_sha1nexte_epu32(e0, m0);
+            e1 = abcd;
+            m1 = _mm_sha1msg2_epu32(m1, m0);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 1);
+            m3 = _mm_sha1msg1_epu32(m3, m0);
+            m2 = _mm_xor_si128(m2, m0);
+
+            // Rounds 36-39
+            e1 = _mm_sha1nexte_epu32(e1, m1);
+            e0 = abcd;
+            m2 = _mm_sha1msg2_epu32(m2, m1);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 1);
+            m0 = _mm_sha1msg1_epu32(m0, m1);
+            m3 = _mm_xor_si128(m3, m1);
+
+            // Rounds 40-43
+            e0 = _mm_sha1nexte_epu32(e0, m2);
+            e1 = abcd;
+            m3 = _mm_sha1msg2_epu32(m3, m2);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 2);
+            m1 = _mm_sha1msg1_epu32(m1, m2);
+            m0 = _mm_xor_si128(m0, m2);
+
+            // Rounds 44-47
+            e1 = _mm_sha1nexte_epu32(e1, m3);
+            e0 = abcd;
+            m0 = _mm_sha1msg2_epu32(m0, m3);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 2);
+            m2 = _mm_sha1msg1_epu32(m2, m3);
+            m1 = _mm_xor_si128(m1, m3);
+
+            // Rounds 48-51
+            e0 = _mm_sha1nexte_epu32(e0, m0);
+            e1 = abcd;
+            m1 = _mm_sha1msg2_epu32(m1, m0);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 2);
+            m3 = _mm_sha1msg1_epu32(m3, m0);
+            m2 = _mm_xor_si128(m2, m0);
+
+            // Rounds 52-55
+            e1 = _mm_sha1nexte_epu32(e1, m1);
+            e0 = abcd;
+            m2 = _mm_sha1msg2_epu32(m2, m1);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 2);
+            m0 = _mm_sha1msg1_epu32(m0, m1);
+            m3 = _mm_xor_si128(m3, m1);
+
+            // Rounds 56-59
+            e0 = _mm_sha1nexte_epu32(e0, m2);
+            e1 = abcd;
+            m3 = _mm_sha1msg2_epu32(m3, m2);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 2);
+            m1 = _mm_sha1msg1_epu32(m1, m2);
+            m0 = _mm_xor_si128(m0, m2);
+
+            // Rounds 60-63
+            e1 = _mm_sha1nexte_epu32(e1, m3);
+            e0 = abcd;
+            m0 = _mm_sha1msg2_epu32(m0, m3);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+            m2 = _mm_sha1msg1_epu32(m2, m3);
+            m1 = _mm_xor_si128(m1, m3);
+
+            // Rounds 64-67
+            e0 = _mm_sha1nexte_epu32(e0, m0);
+            e1 = abcd;
+            m1 = _mm_sha1msg2_epu32(m1, m0);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 3);
+            m3 = _mm_sha1msg1_epu32(m3, m0);
+            m2 = _mm_xor_si128(m2, m0);
+
+            // Rounds 68-71
+            e1 = _mm_sha1nexte_epu32(e1, m1);
+            e0 = abcd;
+            m2 = _mm_sha1msg2_epu32(m2, m1);
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+            m3 = _mm_xor_si128(m3, m1);
+
+            // Rounds 72-75
+            e0 = _mm_sha1nexte_epu32(e0, m2);
+            e1 = abcd;
+            m3 = _mm_sha1msg2_epu32(m3, m2);
+            abcd = _mm_sha1rnds4_epu32(abcd, e0, 3);
+
+            // Rounds 76-79
+            e1 = _mm_sha1nexte_epu32(e1, m3);
+            e0 = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+
+            e0 = _mm_sha1nexte_epu32(e0, e_save);
+            abcd = _mm_add_epi32(abcd, abcd_save);
+            buf += 64;
+        }
+
+        // Store the state back.
+        abcd = _mm_shuffle_epi32(abcd, 0x1B);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state), abcd);
+        state[4] = uint32_t(_mm_extract_epi32(e0, 3));
+    }
+}
+#endif // TS_SHA_NI
+
 #define F0(x,y,z)  (z ^ (x & (y ^ z)))
 #define F1(x,y,z)  (x ^ y ^ z)
 #define F2(x,y,z)  ((x & y) | (z & (x | y)))
@@ -59,6 +256,13 @@ bool ts::SHA1::init()
 
 void ts::SHA1::compress(const uint8_t* buf)
 {
+#if defined(TS_SHA_NI)
+    if (shaHasNI()) {
+        sha1NICompress(_state, buf, 1);
+        return;
+    }
+#endif
+
     uint32_t a,b,c,d,e,W[80],i;
 
     // Copy the state into 512-bits into W[0..15]
@@ -149,6 +353,17 @@ bool ts::SHA1::add(const void* data, size_t size)
     }
     while (size > 0) {
         if (_curlen == 0 && size >= BLOCK_SIZE) {
+#if defined(TS_SHA_NI)
+            if (shaHasNI()) {
+                // One call for all complete blocks, the state stays in registers.
+                const size_t blocks = size / BLOCK_SIZE;
+                sha1NICompress(_state, in, blocks);
+                _length += blocks * BLOCK_SIZE * 8;
+                in += blocks * BLOCK_SIZE;
+                size -= blocks * BLOCK_SIZE;
+                continue;
+            }
+#endif
             compress (in);
             _length += BLOCK_SIZE * 8;
             in += BLOCK_SIZE;
@@ -17,6 +17,206 @@
 #include "tsMemory.h"
 TSDUCK_SOURCE;
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define TS_SHA_NI 1
+    #include <x86intrin.h>
+#endif
+
+#if defined(TS_SHA_NI)
+namespace {
+    // Runtime detection of the SHA extensions, evaluated once.
+    bool shaHasNI()
+    {
+        static const bool supported = __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+        return supported;
+    }
+
+    // Compress whole 64-byte blocks with the SHA-256 instructions.
+    __attribute__((target("sha,sse4.1")))
+    void sha256NICompress(uint32_t* state, const uint8_t* buf, size_t blocks)
+    {
+        __m128i state0, state1, msg, tmp;
+        __m128i m0, m1, m2, m3;
+        __m128i abef_save, cdgh_save;
+        const __m128i mask = _mm_set_epi64x(0x0C0D0E0F08090A0B, 0x0405060700010203);
+
+        // Load the state and swap the words into the ABEF / CDGH layout
+        // expected by the SHA instructions.
+        tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+        state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4));
+        tmp = _mm_shuffle_epi32(tmp, 0xB1);          // CDAB
+        state1 = _mm_shuffle_epi32(state1, 0x1B);    // EFGH
+        state0 = _mm_alignr_epi8(tmp, state1, 8);    // ABEF
+        state1 = _mm_blend_epi16(state1, tmp, 0xF0); // CDGH
+
+        while (blocks-- > 0) {
+            abef_save = state0;
+            cdgh_save = state1;
+
+            // Rounds 0-3
+            m0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0)), mask);
+            msg = _mm_add_epi32(m0, _mm_set_epi64x(0xE9B5DBA5B5C0FBCF, 0x71374491428A2F98));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+
+            // Rounds 4-7
+            m1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 16)), mask);
+            msg = _mm_add_epi32(m1, _mm_set_epi64x(0xAB1C5ED5923F82A4, 0x59F111F13956C25B));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+            m0 = _mm_sha256msg1_epu32(m0, m1);
+
+            // Rounds 8-11
+            m2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 32)), mask);
+            msg = _mm_add_epi32(m2, _mm_set_epi64x(0x550C7DC3243185BE, 0x12835B01D807AA98));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+            m1 = _mm_sha256msg1_epu32(m1, m2);
+
+            // Rounds 12-15
+            m3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 48)), mask);
+            msg = _mm_add_epi32(m3, _mm_set_epi64x(0xC19BF1749BDC06A7, 0x80DEB1FE72BE5D74));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(m3, m2, 4);
+            m0 = _mm_add_epi32(m0, tmp);
+            m0 = _mm_sha256msg2_epu32(m0, m3);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+            m2 = _mm_sha256msg1_epu32(m2, m3);
+
+            // Rounds 16-19
+            msg = _mm_add_epi32(m0, _mm_set_epi64x(0x240CA1CC0FC19DC6, 0xEFBE4786E49B69C1));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(m0, m3, 4);
+            m1 = _mm_add_epi32(m1, tmp);
+            m1 = _mm_sha256msg2_epu32(m1, m0);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+            m3 = _mm_sha256msg1_epu32(m3, m0);
+
+            // Rounds 20-23
+            msg = _mm_add_epi32(m1, _mm_set_epi64x(0x76F988DA5CB0A9DC, 0x4A7484AA2DE92C6F));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(m1, m0, 4);
+            m2 = _mm_add_epi32(m2, tmp);
+            m2 = _mm_sha256msg2_epu32(m2, m1);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+            m0 = _mm_sha256msg1_epu32(m0, m1);
+
+            // Rounds 24-27
+            msg = _mm_add_epi32(m2, _mm_set_epi64x(0xBF597FC7B00327C8, 0xA831C66D983E5152));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(m2, m1, 4);
+            m3 = _mm_add_epi32(m3, tmp);
+            m3 = _mm_sha256msg2_epu32(m3, m2);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+            m1 = _mm_sha256msg1_epu32(m1, m2);
+
+            // Rounds 28-31
+            msg = _mm_add_epi32(m3, _mm_set_epi64x(0x1429296706CA6351, 0xD5A79147C6E00BF3));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(m3, m2, 4);
+            m0 = _mm_add_epi32(m0, tmp);
+            m0 = _mm_sha256msg2_epu32(m0, m3);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+            m2 = _mm_sha256msg1_epu32(m2, m3);
+
+            // Rounds 32-35
+            msg = _mm_add_epi32(m0, _mm_set_epi64x(0x53380D134D2C6DFC, 0x2E1B213827B70A85));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(m0, m3, 4);
+            m1 = _mm_add_epi32(m1, tmp);
+            m1 = _mm_sha256msg2_epu32(m1, m0);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+            m3 = _mm_sha256msg1_epu32(m3, m0);
+
+            // Rounds 36-39
+            msg = _mm_add_epi32(m1, _mm_set_epi64x(0x92722C8581C2C92E, 0x766A0ABB650A7354));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(m1, m0, 4);
+            m2 = _mm_add_epi32(m2, tmp);
+            m2 = _mm_sha256msg2_epu32(m2, m1);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+            m0 = _mm_sha256msg1_epu32(m0, m1);
+
+            // Rounds 40-43
+            msg = _mm_add_epi32(m2, _mm_set_epi64x(0xC76C51A3C24B8B70, 0xA81A664BA2BFE8A1));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(m2, m1, 4);
+            m3 = _mm_add_epi32(m3, tmp);
+            m3 = _mm_sha256msg2_epu32(m3, m2);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+            m1 = _mm_sha256msg1_epu32(m1, m2);
+
+            // Rounds 44-47
+            msg = _mm_add_epi32(m3, _mm_set_epi64x(0x106AA070F40E3585, 0xD6990624D192E819));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(m3, m2, 4);
+            m0 = _mm_add_epi32(m0, tmp);
+            m0 = _mm_sha256msg2_epu32(m0, m3);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+            m2 = _mm_sha256msg1_epu32(m2, m3);
+
+            // Rounds 48-51
+            msg = _mm_add_epi32(m0, _mm_set_epi64x(0x34B0BCB52748774C, 0x1E376C0819A4C116));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(m0, m3, 4);
+            m1 = _mm_add_epi32(m1, tmp);
+            m1 = _mm_sha256msg2_epu32(m1, m0);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+            m3 = _mm_sha256msg1_epu32(m3, m0);
+
+            // Rounds 52-55
+            msg = _mm_add_epi32(m1, _mm_set_epi64x(0x682E6FF35B9CCA4F, 0x4ED8AA4A391C0CB3));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(m1, m0, 4);
+            m2 = _mm_add_epi32(m2, tmp);
+            m2 = _mm_sha256msg2_epu32(m2, m1);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+
+            // Rounds 56-59
+            msg = _mm_add_epi32(m2, _mm_set_epi64x(0x8CC7020884C87814, 0x78A5636F748F82EE));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            tmp = _mm_alignr_epi8(m2, m1, 4);
+            m3 = _mm_add_epi32(m3, tmp);
+            m3 = _mm_sha256msg2_epu32(m3, m2);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+
+            // Rounds 60-63
+            msg = _mm_add_epi32(m3, _mm_set_epi64x(0xC67178F2BEF9A3F7, 0xA4506CEB90BEFFFA));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            msg = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+
+            state0 = _mm_add_epi32(state0, abef_save);
+            state1 = _mm_add_epi32(state1, cdgh_save);
+            buf += 64;
+        }
+
+        // Swap the words back and store the state.
+        tmp = _mm_shuffle_epi32(state0, 0x1B);       // FEBA
+        state1 = _mm_shuffle_epi32(state1, 0xB1);    // DCHG
+        state0 = _mm_blend_epi16(tmp, state1, 0xF0); // DCBA
+        state1 = _mm_alignr_epi8(state1, tmp, 8);    // HGFE
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+    }
+}
+#endif // TS_SHA_NI
+
 #define Ch(x,y,z)  (z ^ (x & (y ^ z)))
 #define Maj(x,y,z) (((x | y) & z) | (x & y))
 #define S(x, n)    (RORc ((x),(n)))
@@ -66,6 +266,13 @@ bool ts::SHA256::init()
 
 void ts::SHA256::compress (const uint8_t* buf)
 {
+#if defined(TS_SHA_NI)
+    if (shaHasNI()) {
+        sha256NICompress(_state, buf, 1);
+        return;
+    }
+#endif
+
     uint32_t S[8], W[64], t0, t1;
 
     /* copy state into S */
@@ -179,6 +386,17 @@ bool ts::SHA256::add (const void* data, size_t size)
     }
     while (size > 0) {
         if (_curlen == 0 && size >= BLOCK_SIZE) {
+#if defined(TS_SHA_NI)
+            if (shaHasNI()) {
+                // Compress all complete blocks in one call, the state stays in registers.
+                const size_t blocks = size / BLOCK_SIZE;
+                sha256NICompress(_state, in, blocks);
+                _length += blocks * BLOCK_SIZE * 8;
+                in += blocks * BLOCK_SIZE;
+                size -= blocks * BLOCK_SIZE;
+                continue;
+            }
+#endif
             compress (in);
             _length += BLOCK_SIZE * 8;
             in += BLOCK_SIZE;
@@ -33,6 +33,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsSystemRandomGenerator.h"
+#include "tsGuard.h"
 TSDUCK_SOURCE;
 
 
@@ -42,10 +43,13 @@ TSDUCK_SOURCE;
 
 ts::SystemRandomGenerator::SystemRandomGenerator() :
 #if defined(TS_WINDOWS)
-    _prov(0)
+    _prov(0),
 #else
-    _fd(-1)
+    _fd(-1),
 #endif
+    _mutex(),
+    _pool_next(POOL_SIZE),  // pool is empty, will be filled on first use
+    _pool()
 {
 #if defined(TS_WINDOWS)
     if (!::CryptAcquireContext(&_prov, NULL, MS_DEF_PROV, PROV_RSA_FULL, CRYPT_VERIFYCONTEXT | CRYPT_MACHINE_KEYSET) &&
@@ -124,6 +128,34 @@ bool ts::SystemRandomGenerator::read(void* buffer, size_t size)
         return true;
     }
 
+    // Large requests bypass the pool and go directly to the system PRNG.
+    if (size > MAX_POOLED_SIZE) {
+        return readSystem(buffer, size);
+    }
+
+    // Small requests (typically control words) are served from the pool
+    // which is refilled in large blocks, one system call per POOL_SIZE bytes.
+    Guard lock(_mutex);
+    if (_pool_next + size > POOL_SIZE) {
+        if (!readSystem(_pool, POOL_SIZE)) {
+            return false;
+        }
+        _pool_next = 0;
+    }
+    ::memcpy(buffer, _pool + _pool_next, size);  // Flawfinder: ignore: memcpy()
+    // Wipe the consumed bytes, do not keep delivered random data in memory.
+    ::memset(_pool + _pool_next, 0, size);
+    _pool_next += size;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Read the system PRNG, without pooling.
+//----------------------------------------------------------------------------
+
+bool ts::SystemRandomGenerator::readSystem(void* buffer, size_t size)
+{
 #if defined(TS_WINDOWS)
     return _prov != 0 && ::CryptGenRandom(_prov, ::DWORD(size), reinterpret_cast<::BYTE*>(buffer));
 #else
@@ -35,6 +35,7 @@
 
 #pragma once
 #include "tsRandomGenerator.h"
+#include "tsMutex.h"
 
 namespace ts {
     //!
@@ -42,6 +43,11 @@ namespace ts {
     //! Usually not the best PRNG on earth, but fine for most usages.
     //! @ingroup crypto
     //!
+    //! Each call to the system PRNG implies a system call (a read on a
+    //! device on UNIX systems). To amortize this cost on hot paths such
+    //! as control word generation, small requests are served from an
+    //! internal pool which is refilled in large blocks.
+    //!
     class TSDUCKDLL SystemRandomGenerator: public RandomGenerator
     {
         TS_NOCOPY(SystemRandomGenerator);
@@ -63,10 +69,21 @@ namespace ts {
         virtual ~SystemRandomGenerator();
 
     private:
+        // Size of the entropy pool. Requests larger than MAX_POOLED_SIZE
+        // bypass the pool and directly query the system PRNG.
+        static const size_t POOL_SIZE = 4096;
+        static const size_t MAX_POOLED_SIZE = 256;
+
+        // Read the system PRNG, without pooling.
+        bool readSystem(void* buffer, size_t size);
+
 #if defined(TS_WINDOWS)
         ::HCRYPTPROV _prov;
 #else
         int _fd;
 #endif
+        Mutex   _mutex;            // Exclusive access to the pool.
+        size_t  _pool_next;        // Index of next unused byte in _pool.
+        uint8_t _pool[POOL_SIZE];  // Pooled entropy, refilled in large blocks.
     };
 }
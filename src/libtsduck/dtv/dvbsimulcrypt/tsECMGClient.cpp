@@ -41,6 +41,7 @@ TSDUCK_SOURCE;
 const size_t ts::ECMGClient::RECEIVER_STACK_SIZE;
 const size_t ts::ECMGClient::RESPONSE_QUEUE_SIZE;
 const ts::MilliSecond ts::ECMGClient::RESPONSE_TIMEOUT;
+const ts::MilliSecond ts::ECMGClient::CONNECTION_TIMEOUT;
 #endif
 
 
@@ -54,10 +55,13 @@ ts::ECMGClient::ECMGClient(size_t extra_handler_stack_size) :
     _abort(nullptr),
     _logger(),
     _connection(ecmgscs::Protocol::Instance(), true, 3),
+    _args(),
     _channel_status(),
     _stream_status(),
+    _streams(),
     _mutex(),
     _work_to_do(),
+    _state_change(),
     _async_requests(),
     _response_queue(RESPONSE_QUEUE_SIZE)
 {
@@ -82,6 +86,7 @@ ts::ECMGClient::~ECMGClient()
         // Notify receiver thread to terminate
         _state = DESTRUCTING;
         lock.signal();
+        _state_change.signal();
     }
     waitForTermination();
 }
@@ -99,9 +104,11 @@ bool ts::ECMGClient::abortConnection(const UString& message)
 
     GuardCondition lock(_mutex, _work_to_do);
     _state = DISCONNECTED;
+    _streams.clear();
     _connection.disconnect(_logger.report());
     _connection.close(_logger.report());
     lock.signal();
+    _state_change.signal();
 
     _logger.setReport(NullReport::Instance());
     return false;
@@ -118,88 +125,167 @@ bool ts::ECMGClient::connect(const ECMGClientArgs& args,
                              const AbortInterface* abort,
                              const tlv::Logger& logger)
 {
-    // Initial state check
+    return beginConnect(args, abort, logger) &&
+        waitForConnection(CONNECTION_TIMEOUT, channel_status, stream_status);
+}
+
+
+//----------------------------------------------------------------------------
+// Start connecting to a remote ECMG without waiting.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGClient::beginConnect(const ECMGClientArgs& args, const AbortInterface* abort, const tlv::Logger& logger)
+{
+    GuardCondition lock(_mutex, _work_to_do);
+
+    // Start receiver thread if first time
+    if (_state == INITIAL) {
+        _state = DISCONNECTED;
+        Thread::start();
+    }
+    if (_state != DISCONNECTED) {
+        tlv::Logger log(logger);
+        log.report().error(u"ECMG client already connected");
+        return false;
+    }
+
+    // The complete connection sequence, TCP connection and channel and
+    // stream negotiation, is executed by the receiver thread.
+    _args = args;
+    _abort = abort;
+    _logger = logger;
+    _streams.clear();
+    _state = START_CONNECT;
+    lock.signal();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Wait for the completion of a connection started by beginConnect().
+//----------------------------------------------------------------------------
+
+bool ts::ECMGClient::waitForConnection(MilliSecond timeout,
+                                       ecmgscs::ChannelStatus& channel_status,
+                                       ecmgscs::StreamStatus& stream_status)
+{
     {
-        Guard lock(_mutex);
-        // Start receiver thread if first time
-        if (_state == INITIAL) {
-            _state = DISCONNECTED;
-            Thread::start();
+        GuardCondition lock(_mutex, _state_change);
+        while ((_state == START_CONNECT || _state == CONNECTING) && lock.waitCondition(timeout)) {
+        }
+        if (_state == CONNECTED) {
+            channel_status = _channel_status;
+            stream_status = _stream_status;
+            return true;
         }
-        if (_state != DISCONNECTED) {
-            tlv::Logger log(logger);
-            log.report().error(u"ECMG client already connected");
+        if (_state != START_CONNECT && _state != CONNECTING) {
+            // The connection sequence failed and was already aborted.
             return false;
         }
-        _abort = abort;
-        _logger = logger;
     }
 
-    // Perform TCP connection to ECMG server
-    // Flawfinder: ignore: this is our open(), not ::open().
-    if (!_connection.open(_logger.report())) {
-        return false;
-    }
-    if (!_connection.connect(args.ecmg_address, _logger.report())) {
-        _connection.close(_logger.report());
-        return false;
-    }
+    // Still connecting after the timeout, abort the connection attempt.
+    return abortConnection(u"ECMG connection timeout");
+}
 
-    // Send a channel_setup message to ECMG
-    ecmgscs::ChannelSetup channel_setup;
-    channel_setup.channel_id = args.ecm_channel_id;
-    channel_setup.Super_CAS_id = args.super_cas_id;
-    if (!_connection.send(channel_setup, _logger)) {
-        return abortConnection();
+
+//----------------------------------------------------------------------------
+// Receive one message during connection setup, replying to test messages.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGClient::setupReceive(tlv::MessagePtr& resp, const AbortInterface* abort)
+{
+    for (;;) {
+        if (!_connection.receive(resp, abort, _logger)) {
+            return false;
+        }
+        if (resp->tag() == ecmgscs::Tags::channel_test) {
+            // Automatic reply to channel_test
+            if (!_connection.send(_channel_status, _logger)) {
+                return false;
+            }
+        }
+        else {
+            return true;
+        }
     }
+}
 
-    // Tell the receiver thread to start listening for incoming messages
+
+//----------------------------------------------------------------------------
+// Perform the connection sequence, executed in the receiver thread.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGClient::performConnect()
+{
+    const AbortInterface* abort = nullptr;
     {
-        GuardCondition lock(_mutex, _work_to_do);
+        Guard lock(_mutex);
         _state = CONNECTING;
-        lock.signal();
+        abort = _abort;
     }
 
-    // Wait for a channel_status from the ECMG
-    tlv::MessagePtr msg;
-    if (!_response_queue.dequeue(msg, RESPONSE_TIMEOUT)) {
-        return abortConnection(u"ECMG channel_setup response timeout");
-    }
-    if (msg->tag() != ecmgscs::Tags::channel_status) {
-        return abortConnection(u"unexpected response from ECMG (expected channel_status):\n" + msg->dump(4));
-    }
-    ecmgscs::ChannelStatus* const csp = dynamic_cast<ecmgscs::ChannelStatus*>(msg.pointer());
-    assert(csp != nullptr);
-    channel_status = _channel_status = *csp;
+    // Perform TCP connection to ECMG server
+    // Flawfinder: ignore: this is our open(), not ::open().
+    bool ok = _connection.open(_logger.report()) &&
+        _connection.connect(_args.ecmg_address, _logger.report());
 
-    // Send a stream_setup message to ECMG
-    ecmgscs::StreamSetup stream_setup;
-    stream_setup.channel_id = args.ecm_channel_id;
-    stream_setup.stream_id = args.ecm_stream_id;
-    stream_setup.ECM_id = args.ecm_id;
-    stream_setup.nominal_CP_duration = uint16_t(args.cp_duration / 100); // unit is 1/10 second
-    if (!_connection.send(stream_setup, _logger)) {
-        return abortConnection();
+    // Send a channel_setup message to ECMG and wait for a channel_status
+    if (ok) {
+        ecmgscs::ChannelSetup channel_setup;
+        channel_setup.channel_id = _args.ecm_channel_id;
+        channel_setup.Super_CAS_id = _args.super_cas_id;
+        tlv::MessagePtr resp;
+        ok = _connection.send(channel_setup, _logger) && setupReceive(resp, abort);
+        if (ok && resp->tag() != ecmgscs::Tags::channel_status) {
+            _logger.report().error(u"unexpected response from ECMG (expected channel_status):\n" + resp->dump(4));
+            ok = false;
+        }
+        if (ok) {
+            ecmgscs::ChannelStatus* const csp = dynamic_cast<ecmgscs::ChannelStatus*>(resp.pointer());
+            assert(csp != nullptr);
+            Guard lock(_mutex);
+            _channel_status = *csp;
+        }
     }
 
-    // Wait for a stream_status from the ECMG
-    if (!_response_queue.dequeue(msg, RESPONSE_TIMEOUT)) {
-        return abortConnection(u"ECMG stream_setup response timeout");
-    }
-    if (msg->tag() != ecmgscs::Tags::stream_status) {
-        return abortConnection(u"unexpected response from ECMG (expected stream_status):\n" + msg->dump(4));
+    // Send a stream_setup message for the initial stream and wait for a stream_status
+    if (ok) {
+        ecmgscs::StreamSetup stream_setup;
+        stream_setup.channel_id = _args.ecm_channel_id;
+        stream_setup.stream_id = _args.ecm_stream_id;
+        stream_setup.ECM_id = _args.ecm_id;
+        stream_setup.nominal_CP_duration = uint16_t(_args.cp_duration / 100); // unit is 1/10 second
+        tlv::MessagePtr resp;
+        ok = _connection.send(stream_setup, _logger) && setupReceive(resp, abort);
+        if (ok && resp->tag() != ecmgscs::Tags::stream_status) {
+            _logger.report().error(u"unexpected response from ECMG (expected stream_status):\n" + resp->dump(4));
+            ok = false;
+        }
+        if (ok) {
+            ecmgscs::StreamStatus* const ssp = dynamic_cast<ecmgscs::StreamStatus*>(resp.pointer());
+            assert(ssp != nullptr);
+            Guard lock(_mutex);
+            _stream_status = *ssp;
+            _streams[_args.ecm_stream_id] = *ssp;
+        }
     }
-    ecmgscs::StreamStatus* const ssp = dynamic_cast<ecmgscs::StreamStatus*>(msg.pointer());
-    assert(ssp != nullptr);
-    stream_status = _stream_status = *ssp;
 
-    // ECM stream now established
-    {
-        Guard lock(_mutex);
+    // Report the new state to application threads.
+    GuardCondition lock(_mutex, _state_change);
+    if (_state == DESTRUCTING) {
+        return false;
+    }
+    if (ok) {
         _state = CONNECTED;
     }
-
-    return true;
+    else {
+        _state = DISCONNECTED;
+        _connection.disconnect(NULLREP);
+        _connection.close(NULLREP);
+    }
+    lock.signal();
+    return ok;
 }
 
 
@@ -222,17 +308,26 @@ bool ts::ECMGClient::disconnect()
     // Disconnection sequence
     bool ok = previous_state == CONNECTED;
     if (ok) {
-        // Politely send a stream_close_request
+        // Get the list of established streams.
+        std::list<uint16_t> stream_ids;
+        {
+            Guard lock(_mutex);
+            for (StreamStatusMap::const_iterator it = _streams.begin(); it != _streams.end(); ++it) {
+                stream_ids.push_back(it->first);
+            }
+        }
+        // Politely send a stream_close_request for each established stream
+        // and wait for the corresponding stream_close_response.
         ecmgscs::StreamCloseRequest req;
-        req.channel_id = _stream_status.channel_id;
-        req.stream_id = _stream_status.stream_id;
-        tlv::MessagePtr resp;
-        // Politely send a stream_close_request
-        // and wait for a stream_close_response
-        ok = _connection.send(req, _logger) &&
-            _response_queue.dequeue(resp, RESPONSE_TIMEOUT) &&
-            resp->tag() == ecmgscs::Tags::stream_close_response;
-        // If we get a polite reply, send a channel_close
+        req.channel_id = _channel_status.channel_id;
+        for (std::list<uint16_t>::const_iterator it = stream_ids.begin(); ok && it != stream_ids.end(); ++it) {
+            req.stream_id = *it;
+            tlv::MessagePtr resp;
+            ok = _connection.send(req, _logger) &&
+                _response_queue.dequeue(resp, RESPONSE_TIMEOUT) &&
+                resp->tag() == ecmgscs::Tags::stream_close_response;
+        }
+        // If we get polite replies, send a channel_close
         if (ok) {
             ecmgscs::ChannelClose cc;
             cc.channel_id = _channel_status.channel_id;
@@ -242,6 +337,7 @@ bool ts::ECMGClient::disconnect()
 
     // TCP disconnection
     GuardCondition lock(_mutex, _work_to_do);
+    _streams.clear();
     if (previous_state == CONNECTING || previous_state == CONNECTED) {
         _state = DISCONNECTED;
         ok = _connection.disconnect(_logger.report()) && ok;
@@ -253,19 +349,101 @@ bool ts::ECMGClient::disconnect()
 }
 
 
+//----------------------------------------------------------------------------
+// Set up an additional ECM stream on the same channel.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGClient::addStream(uint16_t stream_id, uint16_t ecm_id, MilliSecond cp_duration, ecmgscs::StreamStatus& stream_status)
+{
+    uint16_t channel_id = 0;
+    {
+        Guard lock(_mutex);
+        if (_state != CONNECTED) {
+            _logger.report().error(u"ECMG client not connected");
+            return false;
+        }
+        if (_streams.find(stream_id) != _streams.end()) {
+            _logger.report().error(u"ECM stream id %d already established", {stream_id});
+            return false;
+        }
+        channel_id = _channel_status.channel_id;
+    }
+
+    // Send a stream_setup message to ECMG
+    ecmgscs::StreamSetup stream_setup;
+    stream_setup.channel_id = channel_id;
+    stream_setup.stream_id = stream_id;
+    stream_setup.ECM_id = ecm_id;
+    stream_setup.nominal_CP_duration = uint16_t(cp_duration / 100); // unit is 1/10 second
+    if (!_connection.send(stream_setup, _logger)) {
+        return false;
+    }
+
+    // Wait for a stream_status from the ECMG
+    tlv::MessagePtr msg;
+    if (!_response_queue.dequeue(msg, RESPONSE_TIMEOUT)) {
+        _logger.report().error(u"ECMG stream_setup response timeout");
+        return false;
+    }
+    if (msg->tag() != ecmgscs::Tags::stream_status) {
+        _logger.report().error(u"unexpected response from ECMG (expected stream_status):\n" + msg->dump(4));
+        return false;
+    }
+    ecmgscs::StreamStatus* const ssp = dynamic_cast<ecmgscs::StreamStatus*>(msg.pointer());
+    assert(ssp != nullptr);
+    stream_status = *ssp;
+
+    Guard lock(_mutex);
+    _streams[stream_id] = *ssp;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Close one ECM stream, keeping the channel and the connection open.
+//----------------------------------------------------------------------------
+
+bool ts::ECMGClient::removeStream(uint16_t stream_id)
+{
+    uint16_t channel_id = 0;
+    {
+        Guard lock(_mutex);
+        if (_state != CONNECTED || _streams.find(stream_id) == _streams.end()) {
+            _logger.report().error(u"unknown ECM stream id %d", {stream_id});
+            return false;
+        }
+        channel_id = _channel_status.channel_id;
+    }
+
+    // Politely send a stream_close_request and wait for a stream_close_response.
+    ecmgscs::StreamCloseRequest req;
+    req.channel_id = channel_id;
+    req.stream_id = stream_id;
+    tlv::MessagePtr resp;
+    const bool ok = _connection.send(req, _logger) &&
+        _response_queue.dequeue(resp, RESPONSE_TIMEOUT) &&
+        resp->tag() == ecmgscs::Tags::stream_close_response;
+
+    Guard lock(_mutex);
+    _streams.erase(stream_id);
+    return ok;
+}
+
+
 //----------------------------------------------------------------------------
 // Build a CW_provision message.
 //----------------------------------------------------------------------------
 
 void ts::ECMGClient::buildCWProvision(ecmgscs::CWProvision& msg,
+                                      uint16_t stream_id,
                                       uint16_t cp_number,
                                       const ByteBlock& current_cw,
                                       const ByteBlock& next_cw,
                                       const ByteBlock& ac,
                                       uint16_t cp_duration)
 {
-    msg.channel_id = _stream_status.channel_id;
-    msg.stream_id = _stream_status.stream_id;
+    msg.channel_id = _channel_status.channel_id;
+    msg.stream_id = stream_id;
     msg.CP_number = cp_number;
     msg.has_CW_encryption = false;
     msg.has_CP_duration = cp_duration != 0;
@@ -293,10 +471,21 @@ bool ts::ECMGClient::generateECM(uint16_t cp_number,
                                  const ByteBlock& ac,
                                  uint16_t cp_duration,
                                  ecmgscs::ECMResponse& ecm_response)
+{
+    return generateECM(_stream_status.stream_id, cp_number, current_cw, next_cw, ac, cp_duration, ecm_response);
+}
+
+bool ts::ECMGClient::generateECM(uint16_t stream_id,
+                                 uint16_t cp_number,
+                                 const ByteBlock& current_cw,
+                                 const ByteBlock& next_cw,
+                                 const ByteBlock& ac,
+                                 uint16_t cp_duration,
+                                 ecmgscs::ECMResponse& ecm_response)
 {
     // Build a CW_provision message
     ecmgscs::CWProvision msg;
-    buildCWProvision(msg, cp_number, current_cw, next_cw, ac, cp_duration);
+    buildCWProvision(msg, stream_id, cp_number, current_cw, next_cw, ac, cp_duration);
 
     // Send the CW_provision message
     if (!_connection.send(msg, _logger)) {
@@ -315,7 +504,7 @@ bool ts::ECMGClient::generateECM(uint16_t cp_number,
     if (resp->tag() == ecmgscs::Tags::ECM_response) {
         ecmgscs::ECMResponse* const ep = dynamic_cast <ecmgscs::ECMResponse*>(resp.pointer());
         assert(ep != nullptr);
-        if (ep->CP_number == cp_number) {
+        if (ep->stream_id == stream_id && ep->CP_number == cp_number) {
             // This is our ECM
             ecm_response = *ep;
             return true;
@@ -341,15 +530,26 @@ bool ts::ECMGClient::submitECM(uint16_t cp_number,
                                const ByteBlock& ac,
                                uint16_t cp_duration,
                                ECMGClientHandlerInterface* ecm_handler)
+{
+    return submitECM(_stream_status.stream_id, cp_number, current_cw, next_cw, ac, cp_duration, ecm_handler);
+}
+
+bool ts::ECMGClient::submitECM(uint16_t stream_id,
+                               uint16_t cp_number,
+                               const ByteBlock& current_cw,
+                               const ByteBlock& next_cw,
+                               const ByteBlock& ac,
+                               uint16_t cp_duration,
+                               ECMGClientHandlerInterface* ecm_handler)
 {
     // Build a CW_provision message
     ecmgscs::CWProvision msg;
-    buildCWProvision(msg, cp_number, current_cw, next_cw, ac, cp_duration);
+    buildCWProvision(msg, stream_id, cp_number, current_cw, next_cw, ac, cp_duration);
 
     // Register an asynchronous request
     {
         Guard lock(_mutex);
-        _async_requests.insert(std::make_pair(cp_number, ecm_handler));
+        _async_requests.insert(std::make_pair(AsyncKey(stream_id, cp_number), ecm_handler));
     }
 
     // Send the CW_provision message
@@ -358,7 +558,7 @@ bool ts::ECMGClient::submitECM(uint16_t cp_number,
     // Clear asynchronous request on error
     if (!ok) {
         Guard lock(_mutex);
-        _async_requests.erase(cp_number);
+        _async_requests.erase(AsyncKey(stream_id, cp_number));
     }
 
     return ok;
@@ -375,6 +575,7 @@ void ts::ECMGClient::main()
     for (;;) {
 
         const AbortInterface* abort = nullptr;
+        bool start_connect = false;
 
         // Wait for a connection to be managed
         {
@@ -391,9 +592,16 @@ void ts::ECMGClient::main()
             }
             // Get abort handler
             abort = _abort;
+            start_connect = _state == START_CONNECT;
             // Automatically release mutex
         }
 
+        // Perform the connection sequence if an asynchronous connection was requested.
+        if (start_connect && !performConnect()) {
+            // Connection failed or object being destructed, reevaluate the state.
+            continue;
+        }
+
         // Loop on message reception
         tlv::MessagePtr msg;
         bool ok = true;
@@ -405,8 +613,18 @@ void ts::ECMGClient::main()
                     break;
                 }
                 case ecmgscs::Tags::stream_test: {
-                    // Automatic reply to stream_test
-                    ok = _connection.send(_stream_status, _logger);
+                    // Automatic reply to stream_test with the status of that stream
+                    ecmgscs::StreamTest* const st = dynamic_cast <ecmgscs::StreamTest*>(msg.pointer());
+                    assert(st != nullptr);
+                    ecmgscs::StreamStatus status(_stream_status);
+                    {
+                        Guard lock(_mutex);
+                        StreamStatusMap::const_iterator it = _streams.find(st->stream_id);
+                        if (it != _streams.end()) {
+                            status = it->second;
+                        }
+                    }
+                    ok = _connection.send(status, _logger);
                     break;
                 }
                 case ecmgscs::Tags::ECM_response: {
@@ -416,10 +634,10 @@ void ts::ECMGClient::main()
                     ECMGClientHandlerInterface* handler = nullptr;
                     {
                         Guard lock(_mutex);
-                        AsyncRequests::iterator it = _async_requests.find(resp->CP_number);
+                        AsyncRequests::iterator it = _async_requests.find(AsyncKey(resp->stream_id, resp->CP_number));
                         if (it != _async_requests.end()) {
                             handler = it->second;
-                            _async_requests.erase(resp->CP_number);
+                            _async_requests.erase(it);
                         }
                     }
                     if (handler == nullptr) {
@@ -88,6 +88,58 @@ namespace ts {
                      const AbortInterface* abort,
                      const tlv::Logger& logger);
 
+        //!
+        //! Start connecting to a remote ECMG without waiting.
+        //! The TCP connection and the channel and stream negotiation are performed
+        //! by the internal thread and this method returns immediately. The
+        //! application can proceed (typically scrambling with clear packets or
+        //! pre-provisioned control words) and later check the outcome of the
+        //! connection using waitForConnection() or isConnected().
+        //!
+        //! @param [in] args Set of ECMG parameters.
+        //! @param [in] abort An interface to check if the application is interrupted.
+        //! @param [in] logger Where to report errors and messages.
+        //! @return True if the connection was initiated, false on error.
+        //!
+        bool beginConnect(const ECMGClientArgs& args, const AbortInterface* abort, const tlv::Logger& logger);
+
+        //!
+        //! Wait for the completion of a connection which was started by beginConnect().
+        //!
+        //! @param [in] timeout Maximum time to wait in milliseconds.
+        //! On timeout, the connection is aborted.
+        //! @param [out] channel_status Initial response to channel_setup.
+        //! @param [out] stream_status Initial response to stream_setup.
+        //! @return True when the connection is established, false on error or timeout.
+        //!
+        bool waitForConnection(MilliSecond timeout,
+                               ecmgscs::ChannelStatus& channel_status,
+                               ecmgscs::StreamStatus& stream_status);
+
+        //!
+        //! Set up an additional ECM stream on the same channel.
+        //! One ECMG client, with one TCP connection and one receiver thread,
+        //! can serve several ECM streams, one per scrambled service for
+        //! instance. The initial stream is set up by connect() from the
+        //! ECMGClientArgs, additional streams are multiplexed on the same
+        //! channel using this method.
+        //!
+        //! @param [in] stream_id Id of the new stream, unique within the channel.
+        //! @param [in] ecm_id ECM id of the new stream.
+        //! @param [in] cp_duration Crypto-period duration in milliseconds.
+        //! @param [out] stream_status Response to stream_setup.
+        //! @return True on success, false on error.
+        //!
+        bool addStream(uint16_t stream_id, uint16_t ecm_id, MilliSecond cp_duration, ecmgscs::StreamStatus& stream_status);
+
+        //!
+        //! Close one ECM stream, keeping the channel and the connection open.
+        //! The initial stream from connect() can be closed the same way.
+        //! @param [in] stream_id Id of the stream to close.
+        //! @return True on success, false on error.
+        //!
+        bool removeStream(uint16_t stream_id);
+
         //!
         //! Synchronously generate an ECM.
         //!
@@ -107,6 +159,30 @@ namespace ts {
                          uint16_t cp_duration,
                          ecmgscs::ECMResponse& response);
 
+        //!
+        //! Synchronously generate an ECM on a specific stream.
+        //! With several multiplexed streams, synchronous requests shall be
+        //! issued from one single application thread; use submitECM() when
+        //! several threads request ECM's concurrently.
+        //!
+        //! @param [in] stream_id Id of the stream, as set up by connect() or addStream().
+        //! @param [in] cp_number Current crypto-period number.
+        //! @param [in] current_cw Control word for current crypto-period.
+        //! @param [in] next_cw Control word for next crypto-period.
+        //! If empty, the ECMG must work with CW_per_msg = 1.
+        //! @param [in] ac Access criteria, can be empty.
+        //! @param [in] cp_duration Crypto-period in 100 ms units, unspecified if zero.
+        //! @param [out] response Returned ECM.
+        //! @return True on success, false on error.
+        //!
+        bool generateECM(uint16_t stream_id,
+                         uint16_t cp_number,
+                         const ByteBlock& current_cw,
+                         const ByteBlock& next_cw,
+                         const ByteBlock& ac,
+                         uint16_t cp_duration,
+                         ecmgscs::ECMResponse& response);
+
         //!
         //! Asynchronously generate an ECM.
         //! Submit the ECM request and return immediately.
@@ -128,6 +204,29 @@ namespace ts {
                        uint16_t cp_duration,
                        ECMGClientHandlerInterface* handler);
 
+        //!
+        //! Asynchronously generate an ECM on a specific stream.
+        //! Submit the ECM request and return immediately.
+        //! The notification of the ECM generation or error is performed through the specified handler.
+        //!
+        //! @param [in] stream_id Id of the stream, as set up by connect() or addStream().
+        //! @param [in] cp_number Current crypto-period number.
+        //! @param [in] current_cw Control word for current crypto-period.
+        //! @param [in] next_cw Control word for next crypto-period.
+        //! If empty, the ECMG must work with CW_per_msg = 1.
+        //! @param [in] ac Access criteria, can be empty.
+        //! @param [in] cp_duration Crypto-period in 100 ms units, unspecified if zero.
+        //! @param [in] handler Object which will be notified of the returned ECM.
+        //! @return True on success, false on error.
+        //!
+        bool submitECM(uint16_t stream_id,
+                       uint16_t cp_number,
+                       const ByteBlock& current_cw,
+                       const ByteBlock& next_cw,
+                       const ByteBlock& ac,
+                       uint16_t cp_duration,
+                       ECMGClientHandlerInterface* handler);
+
         //!
         //! Disconnect from remote ECMG.
         //! Close stream and channel.
@@ -146,6 +245,7 @@ namespace ts {
         enum State {
             INITIAL,         // initial state, receiver thread not started
             DISCONNECTED,    // no TCP connection
+            START_CONNECT,   // connection requested, not yet processed by receiver thread
             CONNECTING,      // opening channel and stream
             CONNECTED,       // stream established
             DISCONNECTING,   // closing stream and channel
@@ -161,23 +261,39 @@ namespace ts {
         // Timeout for responses from ECMG (except ECM generation)
         static const MilliSecond RESPONSE_TIMEOUT = 5000;
 
-        // List of asynchronous ECM requests: key=cp_number, value=handler
-        typedef std::map <uint16_t, ECMGClientHandlerInterface*> AsyncRequests;
+        // Timeout for the complete connection sequence in synchronous connect()
+        static const MilliSecond CONNECTION_TIMEOUT = 30000;
+
+        // List of asynchronous ECM requests: key=(stream_id,cp_number), value=handler
+        typedef std::map <uint32_t, ECMGClientHandlerInterface*> AsyncRequests;
+
+        // Status of the established streams: key=stream_id
+        typedef std::map <uint16_t, ecmgscs::StreamStatus> StreamStatusMap;
+
+        // Build the key of an asynchronous ECM request.
+        static uint32_t AsyncKey(uint16_t stream_id, uint16_t cp_number)
+        {
+            return (uint32_t(stream_id) << 16) | cp_number;
+        }
 
         // Private members
         State                   _state;
         const AbortInterface*   _abort;
         tlv::Logger             _logger;
         tlv::Connection <Mutex> _connection;     // connection with ECMG server
+        ECMGClientArgs          _args;           // connection parameters
         ecmgscs::ChannelStatus  _channel_status; // initial response to channel_setup
         ecmgscs::StreamStatus   _stream_status;  // initial response to stream_setup
+        StreamStatusMap         _streams;        // status of all established streams
         Mutex                   _mutex;          // exclusive access to protected fields
         Condition               _work_to_do;     // notify receiver thread to do some work
+        Condition               _state_change;   // notify application threads of state changes
         AsyncRequests           _async_requests;
         MessageQueue <tlv::Message, NullMutex> _response_queue;
 
         // Build a CW_provision message.
         void buildCWProvision(ecmgscs::CWProvision& msg,
+                              uint16_t stream_id,
                               uint16_t cp_number,
                               const ByteBlock& current_cw,
                               const ByteBlock& next_cw,
@@ -187,6 +303,12 @@ namespace ts {
         // Receiver thread main code
         virtual void main() override;
 
+        // Perform the connection sequence, executed in the receiver thread.
+        bool performConnect();
+
+        // Receive one message during connection setup, replying to test messages.
+        bool setupReceive(tlv::MessagePtr& resp, const AbortInterface* abort);
+
         // Report specified error message if not empty, abort connection and return false
         bool abortConnection(const UString& = UString());
     };
@@ -451,6 +451,68 @@ bool ts::EMMGClient::dataProvision(const std::vector<ByteBlockPtr>& data)
 }
 
 
+//----------------------------------------------------------------------------
+// Send a batch of data provision messages.
+//----------------------------------------------------------------------------
+
+bool ts::EMMGClient::dataProvisionBatch(const std::vector<ByteBlockPtr>& data)
+{
+    // Build one data_provision message per chunk of data. The vector is
+    // reserved first, the messages are not reallocated while their addresses
+    // are collected for the batch send.
+    std::vector<emmgmux::DataProvision> requests;
+    std::vector<const tlv::Message*> msgs;
+    requests.reserve(data.size());
+    msgs.reserve(data.size());
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        if (!data[i].isNull()) {
+            requests.resize(requests.size() + 1);
+            emmgmux::DataProvision& request(requests.back());
+            request.channel_id = _stream_status.channel_id;
+            request.stream_id = _stream_status.stream_id;
+            request.client_id = _stream_status.client_id;
+            request.data_id = _stream_status.data_id;
+            request.datagram.push_back(data[i]);
+            _total_bytes += data[i]->size();
+        }
+    }
+    for (size_t i = 0; i < requests.size(); ++i) {
+        msgs.push_back(&requests[i]);
+    }
+
+    // Nothing to send is a success.
+    if (msgs.empty()) {
+        return true;
+    }
+
+    // Send the messages.
+    if (_udp_address.hasPort()) {
+        // Send data_provision messages using UDP, one datagram per message.
+        // We need to separately check if the TCP connection is still active.
+        if (!isConnected()) {
+            _logger.report().error(u"MUX is disconnected");
+            return false;
+        }
+        bool ok = true;
+        ByteBlockPtr bbp(new ByteBlock);
+        for (size_t i = 0; i < requests.size(); ++i) {
+            bbp->clear();
+            tlv::Serializer serial(bbp);
+            requests[i].serialize(serial);
+            _logger.log(requests[i], u"sending UDP message to " + _udp_address.toString());
+            ok = _udp_socket.send(bbp->data(), bbp->size(), _udp_address, _logger.report()) && ok;
+        }
+        return ok;
+    }
+    else {
+        // With TCP, the whole batch is serialized in one buffer and sent in
+        // one socket write by the tlv::Connection object.
+        return _connection.send(msgs, _logger);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Send data provision in section format.
 //----------------------------------------------------------------------------
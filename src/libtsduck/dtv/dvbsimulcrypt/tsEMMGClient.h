@@ -139,6 +139,20 @@ namespace ts {
         //!
         bool dataProvision(const std::vector<ByteBlockPtr>& data);
 
+        //!
+        //! Send a batch of data provision messages.
+        //!
+        //! Each element of @a data is sent as one separate data_provision
+        //! message. With TCP, all messages of the batch are serialized in one
+        //! buffer and sent in one single socket write, which is much more
+        //! efficient than one dataProvision() call per message when messages
+        //! are small and frequent.
+        //!
+        //! @param [in] data Data to send, one data_provision message per element.
+        //! @return True on success, false on error.
+        //!
+        bool dataProvisionBatch(const std::vector<ByteBlockPtr>& data);
+
         //!
         //! Send data provision.
         //!
@@ -89,6 +89,26 @@ namespace ts {
             //!
             bool send(const Message& msg, Logger& logger);
 
+            //!
+            //! Serialize and send several TLV messages in one operation.
+            //! All messages are serialized back to back in one buffer and
+            //! sent in one single socket write. Null pointers are ignored.
+            //! @param [in] msgs The messages to send.
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success, false on error.
+            //!
+            bool send(const std::vector<const Message*>& msgs, Report& report);
+
+            //!
+            //! Serialize and send several TLV messages in one operation.
+            //! All messages are serialized back to back in one buffer and
+            //! sent in one single socket write. Null pointers are ignored.
+            //! @param [in] msgs The messages to send.
+            //! @param [in,out] logger Where to report errors and messages.
+            //! @return True on success, false on error.
+            //!
+            bool send(const std::vector<const Message*>& msgs, Logger& logger);
+
             //!
             //! Receive a TLV message.
             //! Wait for the message, deserialize it and validate it.
@@ -113,6 +133,36 @@ namespace ts {
             //!
             bool receive(MessagePtr& msg, const AbortInterface* abort, Logger& logger);
 
+            //!
+            //! Receive a TLV message and analyze it in place.
+            //! Unlike the MessagePtr variants, no message object is rebuilt
+            //! and no copy of the parameters is made: the factory provides
+            //! views into the internal reception buffer. The analysis remains
+            //! valid until the next receive operation on this connection;
+            //! this variant is therefore reserved to applications with one
+            //! single receiver thread per connection.
+            //! Process invalid messages and loop until a valid message is received.
+            //! @param [in,out] mf A message factory, constructed with the same
+            //! protocol as this connection, reloaded with the received message.
+            //! @param [in] abort If non-zero, invoked when I/O is interrupted
+            //! (in case of user-interrupt, return, otherwise retry).
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success, false on error.
+            //!
+            bool receive(MessageFactory& mf, const AbortInterface* abort, Report& report);
+
+            //!
+            //! Receive a TLV message and analyze it in place.
+            //! @param [in,out] mf A message factory, constructed with the same
+            //! protocol as this connection, reloaded with the received message.
+            //! @param [in] abort If non-zero, invoked when I/O is interrupted
+            //! (in case of user-interrupt, return, otherwise retry).
+            //! @param [in,out] logger Where to report errors and messages.
+            //! @return True on success, false on error.
+            //! @see receive(MessageFactory&, const AbortInterface*, Report&)
+            //!
+            bool receive(MessageFactory& mf, const AbortInterface* abort, Logger& logger);
+
             //!
             //! Get invalid incoming messages processing.
             //! @return True if, when an invalid message is received, the corresponding
@@ -153,8 +203,18 @@ namespace ts {
             bool            _auto_error_response;
             size_t          _max_invalid_msg;
             size_t          _invalid_msg_count;
+            ByteBlockPtr    _send_buffer;     // Serialization buffer, the capacity is retained between messages.
+            ByteBlockPtr    _receive_buffer;  // Reception buffer, the capacity is retained between messages.
             MUTEX           _send_mutex;
             MUTEX           _receive_mutex;
+
+            // Receive one complete message (header and payload) into the
+            // reception buffer. Must be called with the receive mutex held.
+            bool receiveMessageData(const AbortInterface* abort, Logger& logger);
+
+            // Handle an invalid received message. Return false when the
+            // connection must be dropped.
+            bool handleInvalidMessage(const MessageFactory& mf, Logger& logger);
         };
     }
 }
@@ -45,6 +45,8 @@ ts::tlv::Connection<MUTEX>::Connection(const Protocol* protocol, bool auto_error
     _auto_error_response(auto_error_response),
     _max_invalid_msg(max_invalid_msg),
     _invalid_msg_count(0),
+    _send_buffer(new ByteBlock),
+    _receive_buffer(new ByteBlock),
     _send_mutex(),
     _receive_mutex()
 {
@@ -86,12 +88,45 @@ bool ts::tlv::Connection<MUTEX>::send(const Message& msg, Logger& logger)
 {
     logger.log(msg, u"sending message to " + peerName());
 
-    ByteBlockPtr bbp(new ByteBlock);
-    Serializer serial(bbp);
+    // Serialize into the reusable buffer, under the protection of the send
+    // mutex. The buffer capacity is retained from one message to the next,
+    // avoiding one allocation per message.
+    Guard lock(_send_mutex);
+    _send_buffer->clear();
+    Serializer serial(_send_buffer);
     msg.serialize(serial);
 
+    return SuperClass::send(_send_buffer->data(), _send_buffer->size(), logger.report());
+}
+
+
+//----------------------------------------------------------------------------
+// Serialize and send several TLV messages in one operation.
+//----------------------------------------------------------------------------
+
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::send(const std::vector<const Message*>& msgs, Report& report)
+{
+    tlv::Logger logger(Severity::Debug, &report);
+    return send(msgs, logger);
+}
+
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::send(const std::vector<const Message*>& msgs, Logger& logger)
+{
+    // Serialize all messages back to back in the reusable buffer and send
+    // them in one single socket write.
     Guard lock(_send_mutex);
-    return SuperClass::send(bbp->data(), bbp->size(), logger.report());
+    _send_buffer->clear();
+    for (size_t i = 0; i < msgs.size(); ++i) {
+        if (msgs[i] != nullptr) {
+            logger.log(*msgs[i], u"sending message to " + peerName());
+            Serializer serial(_send_buffer);
+            msgs[i]->serialize(serial);
+        }
+    }
+
+    return _send_buffer->empty() || SuperClass::send(_send_buffer->data(), _send_buffer->size(), logger.report());
 }
 
 
@@ -109,33 +144,16 @@ bool ts::tlv::Connection<MUTEX>::receive(MessagePtr& msg, const AbortInterface*
 template <class MUTEX>
 bool ts::tlv::Connection<MUTEX>::receive(MessagePtr& msg, const AbortInterface* abort, Logger& logger)
 {
-    const bool has_version(_protocol->hasVersion());
-    const size_t header_size(has_version ? 5 : 4);
-    const size_t length_offset(has_version ? 3 : 2);
-
     // Loop until a valid message is received
     for (;;) {
-        ByteBlock bb(header_size);
-
-        // Receive complete message
-        {
-            Guard lock(_receive_mutex);
-
-            // Read message header
-            if (!SuperClass::receive(bb.data(), header_size, abort, logger.report())) {
-                return false;
-            }
-
-            // Get message length and read message payload
-            const size_t length = GetUInt16(bb.data() + length_offset);
-            bb.resize(header_size + length);
-            if (!SuperClass::receive(bb.data() + header_size, length, abort, logger.report())) {
-                return false;
-            }
+        // Receive and analyze the message. The reception buffer is reused
+        // from one message to the next, it must remain under the protection
+        // of the receive mutex until the message object is rebuilt.
+        Guard lock(_receive_mutex);
+        if (!receiveMessageData(abort, logger)) {
+            return false;
         }
-
-        // Analyze the message
-        MessageFactory mf(bb.data(), bb.size(), _protocol);
+        MessageFactory mf(_receive_buffer->data(), _receive_buffer->size(), _protocol);
         if (mf.errorStatus() == tlv::OK) {
             _invalid_msg_count = 0;
             mf.factory(msg);
@@ -146,22 +164,98 @@ bool ts::tlv::Connection<MUTEX>::receive(MessagePtr& msg, const AbortInterface*
         }
 
         // Received an invalid message
-        _invalid_msg_count++;
+        if (!handleInvalidMessage(mf, logger)) {
+            return false;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Receive a TLV message and analyze it in place.
+//----------------------------------------------------------------------------
+
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::receive(MessageFactory& mf, const AbortInterface* abort, Report& report)
+{
+    tlv::Logger logger(Severity::Debug, &report);
+    return receive(mf, abort, logger);
+}
 
-        // Send back an error message if necessary
-        if (_auto_error_response) {
-            MessagePtr resp;
-            mf.buildErrorResponse(resp);
-            if (!send(*resp, logger.report())) {
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::receive(MessageFactory& mf, const AbortInterface* abort, Logger& logger)
+{
+    // Loop until a valid message is received
+    for (;;) {
+        // Receive the message and analyze it in place over the reception
+        // buffer. The analysis is valid until the next receive operation.
+        {
+            Guard lock(_receive_mutex);
+            if (!receiveMessageData(abort, logger)) {
                 return false;
             }
+            mf.reload(_receive_buffer->data(), _receive_buffer->size());
         }
+        if (mf.errorStatus() == tlv::OK) {
+            _invalid_msg_count = 0;
+            return true;
+        }
+
+        // Received an invalid message
+        if (!handleInvalidMessage(mf, logger)) {
+            return false;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Receive one complete message into the reception buffer.
+//----------------------------------------------------------------------------
 
-        // If invalid message max has been reached, break the connection
-        if (_max_invalid_msg > 0 && _invalid_msg_count >= _max_invalid_msg) {
-            logger.report().error(u"too many invalid messages from %s, disconnecting", {peerName()});
-            disconnect(logger.report());
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::receiveMessageData(const AbortInterface* abort, Logger& logger)
+{
+    const bool has_version(_protocol->hasVersion());
+    const size_t header_size(has_version ? 5 : 4);
+    const size_t length_offset(has_version ? 3 : 2);
+
+    // Read message header
+    _receive_buffer->resize(header_size);
+    if (!SuperClass::receive(_receive_buffer->data(), header_size, abort, logger.report())) {
+        return false;
+    }
+
+    // Get message length and read message payload
+    const size_t length = GetUInt16(_receive_buffer->data() + length_offset);
+    _receive_buffer->resize(header_size + length);
+    return SuperClass::receive(_receive_buffer->data() + header_size, length, abort, logger.report());
+}
+
+
+//----------------------------------------------------------------------------
+// Handle an invalid received message.
+//----------------------------------------------------------------------------
+
+template <class MUTEX>
+bool ts::tlv::Connection<MUTEX>::handleInvalidMessage(const MessageFactory& mf, Logger& logger)
+{
+    _invalid_msg_count++;
+
+    // Send back an error message if necessary
+    if (_auto_error_response) {
+        MessagePtr resp;
+        mf.buildErrorResponse(resp);
+        if (!send(*resp, logger.report())) {
             return false;
         }
     }
+
+    // If invalid message max has been reached, break the connection
+    if (_max_invalid_msg > 0 && _invalid_msg_count >= _max_invalid_msg) {
+        logger.report().error(u"too many invalid messages from %s, disconnecting", {peerName()});
+        disconnect(logger.report());
+        return false;
+    }
+    return true;
 }
@@ -68,6 +68,37 @@ ts::tlv::MessageFactory::MessageFactory(const ByteBlock &bb, const Protocol* pro
     analyzeMessage();
 }
 
+ts::tlv::MessageFactory::MessageFactory(const Protocol* protocol) :
+    _msg_base(nullptr),
+    _msg_length(0),
+    _protocol(protocol),
+    _error_status(InvalidMessage),
+    _error_info(0),
+    _error_info_is_offset(false),
+    _protocol_version(0),
+    _command_tag(0),
+    _params()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Analyze a new TLV message in memory, in place.
+//----------------------------------------------------------------------------
+
+void ts::tlv::MessageFactory::reload(const void* addr, size_t size)
+{
+    _msg_base = reinterpret_cast<const uint8_t*>(addr);
+    _msg_length = size;
+    _error_status = OK;
+    _error_info = 0;
+    _error_info_is_offset = false;
+    _protocol_version = 0;
+    _command_tag = 0;
+    _params.clear();
+    analyzeMessage();
+}
+
 
 //----------------------------------------------------------------------------
 // Message factory
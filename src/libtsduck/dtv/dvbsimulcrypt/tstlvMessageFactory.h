@@ -102,6 +102,27 @@ namespace ts {
             //!
             MessageFactory(const ByteBlock &bb, const Protocol* protocol);
 
+            //!
+            //! Constructor: Build an empty factory, to be loaded later.
+            //! Until reload() is invoked, errorStatus() is InvalidMessage.
+            //! An empty factory is typically pooled, one per connection, and
+            //! reloaded in place for each received message.
+            //! @param [in] protocol Received messages are validated according to this protocol.
+            //!
+            MessageFactory(const Protocol* protocol);
+
+            //!
+            //! Analyze a new TLV message in memory, in place.
+            //! The previous analysis, if any, is discarded and the internal
+            //! structures are reused, avoiding one factory allocation per
+            //! message. All parameter locations point into the new message
+            //! buffer which shall remain unmodified as long as the analysis
+            //! is used.
+            //! @param [in] addr Address of a binary TLV message.
+            //! @param [in] size Size in bytes of the message.
+            //!
+            void reload(const void* addr, size_t size);
+
             //!
             //! Get the "error status" resulting from the analysis of the message.
             //! @return The error status. If not OK, there is no valid message.
@@ -31,8 +31,12 @@
 #include "tsDuckContext.h"
 #include "tsxmlElement.h"
 #include "tsTablesDisplay.h"
+#include "tsMutex.h"
+#include "tsGuard.h"
 TSDUCK_SOURCE;
 
+#define DEFAULT_DECODE_CACHE_SIZE 1024  // Default max number of cached decoded structures.
+
 // Set of encoding modes which directly encode Unicode points.
 const std::set<uint8_t> ts::ATSCMultipleString::_unicode_modes({
     0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
@@ -434,6 +438,115 @@ bool ts::ATSCMultipleString::lengthDeserialize(DuckContext& duck, const uint8_t*
 }
 
 
+//----------------------------------------------------------------------------
+// Process-wide cache of decoded multiple_string_structures.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // FNV-1a hash of a byte sequence, used as cache key with the size.
+    uint64_t HashBytes(const uint8_t* data, size_t size)
+    {
+        uint64_t hash = TS_UCONST64(0xCBF29CE484222325);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ data[i]) * TS_UCONST64(0x00000100000001B3);
+        }
+        return hash;
+    }
+
+    // The cache maps (hash, size) to the raw bytes and the decoded object.
+    // The raw bytes are kept to eliminate hash collisions. The cache is
+    // shared by the whole process and protected by a mutex.
+    class StringCache
+    {
+        TS_NOCOPY(StringCache);
+    public:
+        StringCache() : _mutex(), _max_entries(DEFAULT_DECODE_CACHE_SIZE), _entries() {}
+
+        // Get the process-wide instance of the cache.
+        static StringCache& Instance()
+        {
+            static StringCache cache;
+            return cache;
+        }
+
+        // Search a decoded structure. Return true when found.
+        bool lookup(const uint8_t* data, size_t size, ts::ATSCMultipleString& value)
+        {
+            ts::Guard lock(_mutex);
+            if (_max_entries == 0) {
+                return false;
+            }
+            const auto it(_entries.find(std::make_pair(HashBytes(data, size), size)));
+            if (it == _entries.end() || ::memcmp(it->second.bytes.data(), data, size) != 0) {
+                return false;
+            }
+            value = it->second.value;
+            return true;
+        }
+
+        // Store a decoded structure. In the rare case of a hash collision,
+        // keep the previous entry.
+        void store(const uint8_t* data, size_t size, const ts::ATSCMultipleString& value)
+        {
+            ts::Guard lock(_mutex);
+            if (_max_entries == 0) {
+                return;
+            }
+            // Simple flush when full, no LRU bookkeeping on the hot path.
+            if (_entries.size() >= _max_entries) {
+                _entries.clear();
+            }
+            Entry& entry(_entries[std::make_pair(HashBytes(data, size), size)]);
+            if (entry.bytes.empty()) {
+                entry.bytes.copy(data, size);
+                entry.value = value;
+            }
+        }
+
+        // Resize or disable (zero) the cache.
+        void setMaxEntries(size_t max_entries)
+        {
+            ts::Guard lock(_mutex);
+            _max_entries = max_entries;
+            if (_entries.size() >= _max_entries) {
+                _entries.clear();
+            }
+        }
+
+        // Clear the cache.
+        void clear()
+        {
+            ts::Guard lock(_mutex);
+            _entries.clear();
+        }
+
+    private:
+        class Entry
+        {
+        public:
+            Entry() : bytes(), value() {}
+            ts::ByteBlock bytes;             // Raw binary structure.
+            ts::ATSCMultipleString value;    // Decoded structure.
+        };
+
+        ts::Mutex _mutex;
+        size_t _max_entries;
+        std::map<std::pair<uint64_t, size_t>, Entry> _entries;
+    };
+}
+
+void ts::ATSCMultipleString::SetDecodeCacheSize(size_t max_entries)
+{
+    StringCache::Instance().setMaxEntries(max_entries);
+}
+
+void ts::ATSCMultipleString::ClearDecodeCache()
+{
+    StringCache::Instance().clear();
+}
+
+
 //----------------------------------------------------------------------------
 // Decode a string element.
 //----------------------------------------------------------------------------
@@ -482,14 +595,17 @@ bool ts::ATSCMultipleString::DecodeSegment(UString& segment, const uint8_t*& dat
     if (compression == 0) {
         // Uncompressed segment.
         if (_unicode_modes.find(mode) != _unicode_modes.end()) {
-            // One byte per char.
+            // One byte per char. Reserve the target size upfront, the
+            // appending loop then never reallocates.
             const UChar base = UChar(uint16_t(mode) << 8);
+            segment.reserve(segment.size() + nbytes);
             for (size_t i = 0; i < nbytes; ++i) {
                 segment.push_back(base | data[i]);
             }
         }
         else if (mode == MODE_UTF16) {
             // Two bytes per char.
+            segment.reserve(segment.size() + nbytes / 2);
             for (size_t i = 0; i + 1 < nbytes; i += 2) {
                 segment.push_back(UChar(GetUInt16(data + i)));
             }
@@ -524,6 +640,19 @@ bool ts::ATSCMultipleString::deserialize(DuckContext& duck, const uint8_t*& buff
     if (buffer == nullptr || buffer_size == 0 || mss_size == 0) {
         return false;
     }
+
+    // When the exact structure size is known, the same raw bytes always
+    // decode to the same strings and consume exactly mss_size bytes, so
+    // the decode cache applies. EIT and ETT harvesting decodes the same
+    // titles and texts over and over across table repetitions.
+    const bool cacheable = mss_size != NPOS && mss_size <= buffer_size;
+    const size_t full_size = mss_size;
+    if (cacheable && StringCache::Instance().lookup(buffer, full_size, *this)) {
+        buffer += full_size;
+        buffer_size -= full_size;
+        return true;
+    }
+    const uint8_t* const start = buffer;
     size_t num_strings = *buffer++;
     buffer_size--; mss_size--;
     _strings.reserve(num_strings);
@@ -545,6 +674,11 @@ bool ts::ATSCMultipleString::deserialize(DuckContext& duck, const uint8_t*& buff
         buffer_size -= mss_size;
     }
 
+    // Feed the decode cache for the next occurrence of the same bytes.
+    if (cacheable && size_t(buffer - start) == full_size) {
+        StringCache::Instance().store(start, full_size, *this);
+    }
+
     return true;
 }
 
@@ -284,6 +284,26 @@ namespace ts {
         //!
         static void Display(TablesDisplay& display, const UString& title, int indent, const uint8_t*& buffer, size_t& buffer_size, size_t mss_size = NPOS);
 
+        //!
+        //! Set the maximum number of entries in the decode cache.
+        //!
+        //! Identical binary structures are repeated over and over in ATSC
+        //! streams: the same event titles and descriptions come back with
+        //! each repetition of the EIT's and ETT's. To avoid decoding the
+        //! same bytes again and again, deserialize() keeps a process-wide
+        //! cache of decoded structures, keyed on a hash of the raw bytes.
+        //! The cache is flushed when it reaches its maximum size.
+        //! @param [in] max_entries Maximum number of cached structures.
+        //! Use zero to disable the cache. The default is 1024 entries.
+        //!
+        static void SetDecodeCacheSize(size_t max_entries);
+
+        //!
+        //! Clear the process-wide decode cache.
+        //! @see SetDecodeCacheSize()
+        //!
+        static void ClearDecodeCache();
+
     private:
         class StringElement
         {
@@ -34,6 +34,8 @@
 
 #pragma once
 #include "tsPlatform.h"
+#include "tsMemory.h"
+#include "tsIntegerUtils.h"
 
 namespace ts {
     //!
@@ -207,6 +209,16 @@ namespace ts {
         // Advance pointer to next byte boundary.
         void nextByte();
 
+        // Check if a 64-bit word, as loaded from the bitstream, contains at
+        // least one byte with value 0x03. An emulation prevention byte may
+        // then be present in the word, the word-at-a-time fast paths cannot
+        // be used and the byte loops handle it.
+        static bool maybeEPB(uint64_t w)
+        {
+            const uint64_t x = w ^ TS_UCONST64(0x0303030303030303);
+            return ((x - TS_UCONST64(0x0101010101010101)) & ~x & TS_UCONST64(0x8080808080808080)) != 0;
+        }
+
         // Advance pointer by one bit and return the bit value
         uint8_t nextBit();
 
@@ -66,6 +66,20 @@ bool ts::AVCParser::readBits(INT& val, size_t n)
         return false;
     }
 
+    // Fast path: when a full 64-bit word of lookahead is available and
+    // cannot contain an emulation prevention byte, extract the field by
+    // shift and mask. The byte loops below handle the rest.
+    if (n > 0 && n <= 56 && size_t(_end - _byte) >= 8) {
+        const uint64_t w = GetUInt64(_byte);
+        if (!maybeEPB(w)) {
+            val = INT((w << _bit) >> (64 - n));
+            _bit += n;
+            _byte += _bit >> 3;
+            _bit &= 7;
+            return true;
+        }
+    }
+
     // Read leading bits up to byte boundary
     while (n > 0 && _bit != 0) {
         val = INT(val << 1) | nextBit();
@@ -98,6 +112,30 @@ bool ts::AVCParser::expColomb(INT& val)
 {
     ts_avcparser_assert_consistent();
 
+    // Fast path: when a full 64-bit word of lookahead is available and
+    // cannot contain an emulation prevention byte, decode the complete
+    // Exp-Golomb code from the word: count the leading zero bits, the code
+    // uses twice that number of bits plus one.
+    if (size_t(_end - _byte) >= 8) {
+        const uint64_t w = GetUInt64(_byte);
+        if (!maybeEPB(w)) {
+            const uint64_t bits = w << _bit;
+            if (bits != 0) {
+                // The code must end strictly inside the loaded word so that
+                // the new position stays in the bytes checked against
+                // emulation prevention.
+                const size_t len = 2 * CountLeadingZeroBits64(bits) + 1;
+                if (len + _bit < 64) {
+                    val = INT((bits >> (64 - len)) - 1);
+                    _bit += len;
+                    _byte += _bit >> 3;
+                    _bit &= 7;
+                    return true;
+                }
+            }
+        }
+    }
+
     // See ISO/IEC 14496-10 section 9.1
     val = 0;
     int leading_zero_bits = -1;
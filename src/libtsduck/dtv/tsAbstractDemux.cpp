@@ -150,6 +150,15 @@ void ts::AbstractDemux::feedPacket(const TSPacket& pkt)
     _packet_count++;
 }
 
+void ts::AbstractDemux::feedPackets(const TSPacket* pkt, size_t count)
+{
+    // Default implementation, one virtual invocation per packet.
+    // Subclasses override it with a native batched version.
+    for (size_t i = 0; i < count; ++i) {
+        feedPacket(pkt[i]);
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Helpers for subclasses, protecting the invocation to handlers.
@@ -56,6 +56,16 @@ namespace ts {
         //!
         virtual void feedPacket(const TSPacket& pkt);
 
+        //!
+        //! The following method feeds the demux with a batch of contiguous TS packets.
+        //! The default implementation invokes feedPacket() on each packet.
+        //! Subclasses override it to process the batch natively, without
+        //! one virtual method invocation per packet.
+        //! @param [in] pkt Address of the first TS packet in the batch.
+        //! @param [in] count Number of TS packets in the batch.
+        //!
+        virtual void feedPackets(const TSPacket* pkt, size_t count);
+
         //!
         //! Replace the list of PID's to filter.
         //! The method resetPID() is invoked on each removed PID.
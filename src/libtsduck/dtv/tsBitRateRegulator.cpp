@@ -31,6 +31,9 @@
 #include "tsNullReport.h"
 TSDUCK_SOURCE;
 
+#define REQUESTED_PRECISION_NS         2000000  // Requested timer precision (2 milliseconds).
+#define REQUESTED_PRECISE_PRECISION_NS  100000  // Requested timer precision in precise mode (100 microseconds).
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -41,12 +44,16 @@ ts::BitRateRegulator::BitRateRegulator(Report* report, int log_level) :
     _log_level(log_level),
     _state(INITIAL),
     _opt_bitrate(0),
+    _opt_precise(false),
     _cur_bitrate(0),
     _opt_burst(0),
     _burst_pkt_max(0),
     _burst_pkt_cnt(0),
     _burst_min(0),
     _burst_duration(0),
+    _pkts_to_ns(),
+    _ns_to_pkts(),
+    _ms_to_pkts(),
     _burst_end(),
     _bitrate_start(),
     _bitrate_pkt_cnt(0)
@@ -76,9 +83,12 @@ void ts::BitRateRegulator::start()
     // wait on durations lower than the minimum, this will introduce
     // latencies which mess up the regulation. We try to request 2
     // milliseconds as time precision and we keep what the operating
-    // system gives.
+    // system gives. In precise mode, we request a much finer precision
+    // and the residual wake-up jitter is absorbed by a bounded spin on
+    // the monotonic clock at the end of each wait, which allows smaller
+    // bursts and a lower emission jitter.
 
-    _burst_min = Monotonic::SetPrecision(2000000); // 2 milliseconds in nanoseconds
+    _burst_min = Monotonic::SetPrecision(_opt_precise ? REQUESTED_PRECISE_PRECISION_NS : REQUESTED_PRECISION_NS);
 
     _report->log(_log_level, u"minimum packet burst duration is %'d nano-seconds", {_burst_min});
 
@@ -100,15 +110,22 @@ void ts::BitRateRegulator::handleNewBitrate()
     // Assume that the packets/burst is the one specified on the command line.
     _burst_pkt_max = _opt_burst == 0 ? 1 : _opt_burst;
 
-    // Compute corresponding duration (in nano-seconds) between two bursts.
+    // Precompute the conversion rates for the new bitrate. All steady-state
+    // conversions between packets and durations then use multiplications
+    // only, the divisions are performed here, once per bitrate change.
     assert(_cur_bitrate > 0);
-    _burst_duration = (NanoSecPerSec * PKT_SIZE * 8 * _burst_pkt_max) / _cur_bitrate;
+    _pkts_to_ns.set(NanoSecPerSec * PKT_SIZE * 8, int64_t(_cur_bitrate));
+    _ns_to_pkts.set(int64_t(_cur_bitrate), NanoSecPerSec * PKT_SIZE * 8);
+    _ms_to_pkts.set(int64_t(_cur_bitrate), MilliSecPerSec * PKT_SIZE * 8);
+
+    // Compute corresponding duration (in nano-seconds) between two bursts.
+    _burst_duration = _pkts_to_ns.scale(int64_t(_burst_pkt_max));
 
     // If the result is too small for the time precision of the operating
     // system, recompute a larger burst duration
     if (_burst_duration < _burst_min) {
         _burst_duration = _burst_min;
-        _burst_pkt_max = (_burst_duration * _cur_bitrate) / (NanoSecPerSec * PKT_SIZE * 8);
+        _burst_pkt_max = PacketCounter(_ns_to_pkts.scale(_burst_duration));
     }
 
     _report->debug(u"new regulation, burst: %'d nano-seconds, %'d packets", {_burst_duration, _burst_pkt_max});
@@ -131,8 +148,9 @@ void ts::BitRateRegulator::regulatePacket(bool& flush, bool smoothen)
         // Because of rounding, we tend to pass slightly less packets than requested.
         // See if we need to add some packets from time to time.
         const Monotonic now(true);
-        // Number of packets we should have passed since beginning of sequence of this bitrate:
-        const PacketCounter expected = PacketDistance(_cur_bitrate, (now - _bitrate_start) / NanoSecPerMilliSec);
+        // Number of packets we should have passed since beginning of sequence of this bitrate.
+        // Division-free steady-state computation, the rate was precomputed on bitrate change.
+        const PacketCounter expected = PacketCounter(_ms_to_pkts.scale((now - _bitrate_start) / NanoSecPerMilliSec));
         if (expected > _bitrate_pkt_cnt) {
             // We should have passed more than we did, increase this burst size.
             _burst_pkt_cnt = expected - _bitrate_pkt_cnt;
@@ -141,8 +159,20 @@ void ts::BitRateRegulator::regulatePacket(bool& flush, bool smoothen)
 
     // Recheck end of burst, just in case we added some more packets to smoothen.
     if (_burst_pkt_cnt == 0) {
-        // Wait until scheduled end of burst.
-        _burst_end.wait();
+        if (_opt_precise) {
+            // Coarse sleep until close to the scheduled end of burst, then
+            // spin on the monotonic clock down to the exact deadline. The
+            // spin is bounded by the timer precision.
+            Monotonic coarse(_burst_end);
+            coarse -= _burst_min;
+            coarse.wait();
+            while (Monotonic(true) < _burst_end) {
+            }
+        }
+        else {
+            // Wait until scheduled end of burst.
+            _burst_end.wait();
+        }
         // Restart a new burst, use monotonic time
         _burst_pkt_cnt = _burst_pkt_max;
         _burst_end += _burst_duration;
@@ -263,7 +293,7 @@ void ts::BitRateRegulator::regulate(ts::BitRate current_bitrate, bool& flush, bo
                     // Compute haw many packets we should pass for the remaining time,
                     // based on the new bitrate.
                     _burst_end += _burst_min;
-                    _burst_pkt_cnt = ((_burst_min - elapsed) * _cur_bitrate) / (NanoSecPerSec * PKT_SIZE * 8);
+                    _burst_pkt_cnt = PacketCounter(_ns_to_pkts.scale(_burst_min - elapsed));
                 }
                 // Report that the bitrate has changed
                 bitrate_changed = true;
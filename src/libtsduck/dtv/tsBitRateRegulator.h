@@ -36,6 +36,7 @@
 #include "tsMPEG.h"
 #include "tsReport.h"
 #include "tsMonotonic.h"
+#include "tsRationalRate.h"
 
 namespace ts {
     //!
@@ -79,6 +80,20 @@ namespace ts {
             _opt_bitrate = bitrate;
         }
 
+        //!
+        //! Set the precise output mode.
+        //! In precise mode, the regulator requests a finer timer precision from
+        //! the operating system, emits smaller bursts and performs a short spin
+        //! on the monotonic clock, bounded by the timer precision, at the end of
+        //! each wait. This reduces the emission jitter at high bitrates at the
+        //! expense of some CPU load. Must be called before start().
+        //! @param [in] on When true, activate the precise output mode.
+        //!
+        void setPreciseMode(bool on)
+        {
+            _opt_precise = on;
+        }
+
         //!
         //! Start regulation, initialize all timers.
         //!
@@ -109,12 +124,16 @@ namespace ts {
         int           _log_level;
         State         _state;           // Current regulation state
         BitRate       _opt_bitrate;     // Bitrate option, zero means use input
+        bool          _opt_precise;     // Precise output mode (sleep then bounded spin)
         BitRate       _cur_bitrate;     // Current bitrate
         PacketCounter _opt_burst;       // Number of packets to burst at a time
         PacketCounter _burst_pkt_max;   // Total packets in current burst
         PacketCounter _burst_pkt_cnt;   // Countdown of packets in current burst
         NanoSecond    _burst_min;       // Minimum delay between two bursts (ns)
         NanoSecond    _burst_duration;  // Delay between two bursts (nano-seconds)
+        RationalRate  _pkts_to_ns;      // Packets to nanoseconds at the current bitrate
+        RationalRate  _ns_to_pkts;      // Nanoseconds to packets, for burst-scale durations
+        RationalRate  _ms_to_pkts;      // Milliseconds to packets, for long elapsed times
         Monotonic     _burst_end;       // End of current burst
         Monotonic     _bitrate_start;   // Time of last bitrate change
         PacketCounter _bitrate_pkt_cnt; // Passed packets since last bitrate change
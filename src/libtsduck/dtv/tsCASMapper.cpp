@@ -45,8 +45,10 @@ TSDUCK_SOURCE;
 
 ts::CASMapper::CASMapper(DuckContext& duck) :
     TableHandlerInterface(),
+    SignalizationHandlerInterface(),
     _duck(duck),
     _demux(_duck, this),
+    _state(nullptr),
     _pids()
 {
     // Specify the PID filters
@@ -54,6 +56,45 @@ ts::CASMapper::CASMapper(DuckContext& duck) :
     _demux.addPID(PID_CAT);
 }
 
+ts::CASMapper::CASMapper(DuckContext& duck, SignalizationState& state) :
+    TableHandlerInterface(),
+    SignalizationHandlerInterface(),
+    _duck(duck),
+    _demux(_duck, this),
+    _state(&state),
+    _pids()
+{
+    // The internal demux is left unused, the tables come from the shared state.
+    _state->addTableId(TID_CAT);
+    _state->addTableId(TID_PMT);
+    _state->subscribe(this);
+
+    // Process the tables which were received before we subscribed.
+    if (_state->hasCAT()) {
+        handleCAT(_state->lastCAT(), PID_CAT);
+    }
+    std::set<uint16_t> service_ids;
+    _state->getServiceIds(service_ids);
+    for (auto it = service_ids.begin(); it != service_ids.end(); ++it) {
+        PMT pmt;
+        if (_state->getPMT(*it, pmt)) {
+            handlePMT(pmt, PID_NULL);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+ts::CASMapper::~CASMapper()
+{
+    if (_state != nullptr) {
+        _state->unsubscribe(this);
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Reset the CAS mapper.
@@ -86,20 +127,14 @@ void ts::CASMapper::handleTable(SectionDemux&, const BinaryTable& table)
         case TID_CAT: {
             const CAT cat(_duck, table);
             if (cat.isValid()) {
-                // Identify all EMM PID's.
-                analyzeCADescriptors(cat.descs, false);
+                handleCAT(cat, table.sourcePID());
             }
             break;
         }
         case TID_PMT: {
             const PMT pmt(_duck, table);
             if (pmt.isValid()) {
-                // Identify all ECM PID's at program level.
-                analyzeCADescriptors(pmt.descs, true);
-                // Identify all ECM PID's at stream level.
-                for (PMT::StreamMap::const_iterator it = pmt.streams.begin(); it != pmt.streams.end(); ++it) {
-                    analyzeCADescriptors(it->second.descs, true);
-                }
+                handlePMT(pmt, table.sourcePID());
             }
             break;
         }
@@ -110,6 +145,28 @@ void ts::CASMapper::handleTable(SectionDemux&, const BinaryTable& table)
     }
 }
 
+//----------------------------------------------------------------------------
+// Process a CAT or a PMT, either from the internal demux or from the
+// shared signalization state.
+//----------------------------------------------------------------------------
+
+void ts::CASMapper::handleCAT(const CAT& cat, PID)
+{
+    // Identify all EMM PID's.
+    analyzeCADescriptors(cat.descs, false);
+}
+
+void ts::CASMapper::handlePMT(const PMT& pmt, PID)
+{
+    // Identify all ECM PID's at program level.
+    analyzeCADescriptors(pmt.descs, true);
+    // Identify all ECM PID's at stream level.
+    for (PMT::StreamMap::const_iterator it = pmt.streams.begin(); it != pmt.streams.end(); ++it) {
+        analyzeCADescriptors(it->second.descs, true);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Explore a descriptor list and record EMM and ECM PID's.
 //----------------------------------------------------------------------------
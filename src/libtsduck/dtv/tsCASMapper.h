@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsSectionDemux.h"
+#include "tsSignalizationState.h"
 #include "tsCADescriptor.h"
 
 namespace ts {
@@ -44,7 +45,7 @@ namespace ts {
     //! All packets are passed through this object. It tracks the location of all
     //! EMM and ECM PID's and records the corresponding CAS attributes.
     //!
-    class TSDUCKDLL CASMapper : private TableHandlerInterface
+    class TSDUCKDLL CASMapper : private TableHandlerInterface, private SignalizationHandlerInterface
     {
         TS_NOBUILD_NOCOPY(CASMapper);
     public:
@@ -54,6 +55,22 @@ namespace ts {
         //!
         CASMapper(DuckContext& duck);
 
+        //!
+        //! Constructor using a shared signalization state.
+        //! The mapper does not run its own demux, it subscribes to @a state
+        //! and gets the CAT and the PMT's from there. In this mode, do not
+        //! feed the mapper with packets, the owner of the shared state feeds
+        //! it once for all its consumers.
+        //! @param [in,out] duck TSDuck execution context. The reference is kept inside this object.
+        //! @param [in,out] state Shared signalization state. The reference is kept inside this object.
+        //!
+        CASMapper(DuckContext& duck, SignalizationState& state);
+
+        //!
+        //! Destructor.
+        //!
+        virtual ~CASMapper();
+
         //!
         //! Reset the CAS mapper.
         //!
@@ -61,11 +78,15 @@ namespace ts {
 
         //!
         //! This method feeds the CAS mapper with a TS packet.
+        //! When the mapper is attached to a shared signalization state, this
+        //! method does nothing, the shared state is fed by its owner.
         //! @param [in] pkt A new transport stream packet.
         //!
         void feedPacket(const TSPacket& pkt)
         {
-            _demux.feedPacket(pkt);
+            if (_state == nullptr) {
+                _demux.feedPacket(pkt);
+            }
         }
 
         //!
@@ -141,11 +162,16 @@ namespace ts {
         void analyzeCADescriptors(const DescriptorList& descs, bool is_ecm);
 
         // CAMapper private fields.
-        DuckContext&      _duck;
-        SectionDemux      _demux;
-        PIDDescriptionMap _pids;
+        DuckContext&        _duck;
+        SectionDemux        _demux;   // Internal demux, unused when attached to a shared state.
+        SignalizationState* _state;   // Shared signalization state, or null.
+        PIDDescriptionMap   _pids;
 
-        // Implementation of TableHandlerInterface
+        // Implementation of TableHandlerInterface (internal demux mode).
         virtual void handleTable(SectionDemux&, const BinaryTable&) override;
+
+        // Implementation of SignalizationHandlerInterface (shared state mode).
+        virtual void handleCAT(const CAT&, PID) override;
+        virtual void handlePMT(const PMT&, PID) override;
     };
 }
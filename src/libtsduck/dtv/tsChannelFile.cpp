@@ -31,8 +31,19 @@
 #include "tsModulation.h"
 #include "tsxmlElement.h"
 #include "tsSysUtils.h"
+#include "tsMemory.h"
+#include "tsVersion.h"
 TSDUCK_SOURCE;
 
+// Format version of the binary cache files. Increment on format change.
+#define CACHE_FORMAT_VERSION 1
+
+// Magic number at the beginning of binary cache files ("TCHN").
+#define CACHE_MAGIC 0x5443484E
+
+// Maximum size of a loaded binary cache file (sanity check).
+#define CACHE_MAX_SIZE (64 * 1024 * 1024)
+
 
 //----------------------------------------------------------------------------
 // Constructors and destructors.
@@ -41,7 +52,8 @@ TSDUCK_SOURCE;
 ts::ChannelFile::ChannelFile() :
     _networks(),
     _xmlTweaks(),
-    _fileName()
+    _fileName(),
+    _useCache(true)
 {
 }
 
@@ -366,9 +378,30 @@ bool ts::ChannelFile::load(const UString& fileName, Report& report)
 {
     clear();
     _fileName = fileName.empty() ? DefaultFileName() : fileName;
+
+    // Characteristics of the XML file, used to validate the binary cache.
+    const UString cacheName(BinaryCacheName(_fileName));
+    const int64_t xmlSize = GetFileSize(_fileName);
+    const MilliSecond xmlTime = GetFileModificationTimeUTC(_fileName) - Time::Epoch;
+
+    // Try the binary cache first, a much faster alternative to parsing the
+    // XML text. The cache is used only when it matches the XML file.
+    if (_useCache && loadBinaryCache(cacheName, xmlTime, xmlSize, report)) {
+        return true;
+    }
+
+    // No usable cache, parse the XML file.
     xml::Document doc(report);
     doc.setTweaks(_xmlTweaks);
-    return doc.load(_fileName, false) && parseDocument(doc);
+    if (!doc.load(_fileName, false) || !parseDocument(doc)) {
+        return false;
+    }
+
+    // Transparently regenerate the cache (best effort, ignore errors).
+    if (_useCache) {
+        saveBinaryCache(cacheName, xmlTime, xmlSize, report);
+    }
+    return true;
 }
 
 bool ts::ChannelFile::load(std::istream& strm, Report& report)
@@ -390,6 +423,286 @@ bool ts::ChannelFile::parse(const UString& text, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Binary serialization helpers for the cache file.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // Serialize a string as a 16-bit byte count followed by its UTF-8 encoding.
+    void PutString(ts::ByteBlock& bb, const ts::UString& str)
+    {
+        const std::string utf8(str.toUTF8());
+        const size_t len = std::min<size_t>(utf8.size(), 0xFFFF);
+        bb.appendUInt16(uint16_t(len));
+        bb.append(utf8.data(), len);
+    }
+
+    // Serialize an optional value as a presence byte, followed by the value,
+    // cast to the integer type INT, when present.
+    template <typename INT, typename T>
+    void PutVar(ts::ByteBlock& bb, const ts::Variable<T>& var)
+    {
+        bb.appendUInt8(var.set() ? 1 : 0);
+        if (var.set()) {
+            bb.append<INT>(INT(var.value()));
+        }
+    }
+
+    // Serialize the modulation parameters which may appear in a channel file.
+    void PutTune(ts::ByteBlock& bb, const ts::ModulationArgs& mod)
+    {
+        PutVar<uint32_t>(bb, mod.delivery_system);
+        PutVar<uint64_t>(bb, mod.frequency);
+        PutVar<uint8_t>(bb, mod.polarity);
+        PutVar<uint8_t>(bb, mod.inversion);
+        PutVar<uint32_t>(bb, mod.symbol_rate);
+        PutVar<uint8_t>(bb, mod.inner_fec);
+        PutVar<uint8_t>(bb, mod.satellite_number);
+        PutVar<uint8_t>(bb, mod.modulation);
+        PutVar<uint32_t>(bb, mod.bandwidth);
+        PutVar<uint8_t>(bb, mod.fec_hp);
+        PutVar<uint8_t>(bb, mod.fec_lp);
+        PutVar<uint8_t>(bb, mod.transmission_mode);
+        PutVar<uint8_t>(bb, mod.guard_interval);
+        PutVar<uint8_t>(bb, mod.hierarchy);
+        PutVar<uint8_t>(bb, mod.pilots);
+        PutVar<uint8_t>(bb, mod.roll_off);
+        PutVar<uint32_t>(bb, mod.plp);
+        PutVar<uint32_t>(bb, mod.isi);
+        PutVar<uint32_t>(bb, mod.pls_code);
+        PutVar<uint8_t>(bb, mod.pls_mode);
+    }
+
+    // A sequential reader over the content of a cache file with bounds checking.
+    // When an inconsistency is found, the reader becomes invalid and all
+    // subsequent reads return zero or empty values.
+    class CacheReader
+    {
+    public:
+        CacheReader(const ts::ByteBlock& bb) : _data(bb.data()), _remain(bb.size()), _valid(true) {}
+
+        bool valid() const { return _valid; }
+        bool atEnd() const { return _remain == 0; }
+
+        // Read a fixed size integer.
+        template <typename INT>
+        INT getInt()
+        {
+            const uint8_t* const p = fetch(sizeof(INT));
+            return p == nullptr ? INT(0) : ts::GetInt<INT>(p);
+        }
+
+        // Read a string (16-bit byte count followed by UTF-8 encoding).
+        ts::UString getString()
+        {
+            const size_t len = getInt<uint16_t>();
+            const uint8_t* const p = fetch(len);
+            return p == nullptr ? ts::UString() : ts::UString::FromUTF8(reinterpret_cast<const char*>(p), len);
+        }
+
+        // Read an optional value (presence byte, then value as integer type INT).
+        template <typename INT, typename T>
+        void getVar(ts::Variable<T>& var)
+        {
+            if (getInt<uint8_t>() != 0) {
+                var = T(getInt<INT>());
+            }
+            else {
+                var.reset();
+            }
+        }
+
+        // Read the modulation parameters, symmetrically with PutTune().
+        void getTune(ts::ModulationArgs& mod)
+        {
+            mod.reset();
+            getVar<uint32_t>(mod.delivery_system);
+            getVar<uint64_t>(mod.frequency);
+            getVar<uint8_t>(mod.polarity);
+            getVar<uint8_t>(mod.inversion);
+            getVar<uint32_t>(mod.symbol_rate);
+            getVar<uint8_t>(mod.inner_fec);
+            getVar<uint8_t>(mod.satellite_number);
+            getVar<uint8_t>(mod.modulation);
+            getVar<uint32_t>(mod.bandwidth);
+            getVar<uint8_t>(mod.fec_hp);
+            getVar<uint8_t>(mod.fec_lp);
+            getVar<uint8_t>(mod.transmission_mode);
+            getVar<uint8_t>(mod.guard_interval);
+            getVar<uint8_t>(mod.hierarchy);
+            getVar<uint8_t>(mod.pilots);
+            getVar<uint8_t>(mod.roll_off);
+            getVar<uint32_t>(mod.plp);
+            getVar<uint32_t>(mod.isi);
+            getVar<uint32_t>(mod.pls_code);
+            getVar<uint8_t>(mod.pls_mode);
+        }
+
+    private:
+        const uint8_t* _data;
+        size_t         _remain;
+        bool           _valid;
+
+        // Get the address of the next size bytes, null when out of bounds.
+        const uint8_t* fetch(size_t size)
+        {
+            if (!_valid || _remain < size) {
+                _valid = false;
+                return nullptr;
+            }
+            const uint8_t* const p = _data;
+            _data += size;
+            _remain -= size;
+            return p;
+        }
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Load the binary cache of the XML file.
+//----------------------------------------------------------------------------
+
+bool ts::ChannelFile::loadBinaryCache(const UString& cacheName, MilliSecond xmlTime, int64_t xmlSize, Report& report)
+{
+    // Silently give up when the cache file cannot be read.
+    ByteBlock data;
+    if (!data.loadFromFile(cacheName, CACHE_MAX_SIZE, nullptr)) {
+        return false;
+    }
+
+    // Check the header: magic, format, TSDuck version, XML file size and time.
+    // A mismatch simply means that the cache is stale and must be regenerated.
+    CacheReader in(data);
+    if (in.getInt<uint32_t>() != CACHE_MAGIC ||
+        in.getInt<uint16_t>() != CACHE_FORMAT_VERSION ||
+        in.getInt<uint16_t>() != TS_VERSION_MAJOR ||
+        in.getInt<uint16_t>() != TS_VERSION_MINOR ||
+        in.getInt<uint32_t>() != TS_COMMIT ||
+        in.getInt<int64_t>() != xmlTime ||
+        in.getInt<int64_t>() != xmlSize)
+    {
+        report.debug(u"binary cache %s is stale or invalid, parsing XML file", {cacheName});
+        return false;
+    }
+
+    // Load all networks.
+    const size_t netCount = in.getInt<uint32_t>();
+    for (size_t inet = 0; in.valid() && inet < netCount; ++inet) {
+        // Read the fields in named locals: as function arguments, the two
+        // reads would be unsequenced and could be evaluated in any order.
+        const uint16_t netId = in.getInt<uint16_t>();
+        const TunerType netType = TunerType(in.getInt<uint8_t>());
+        const NetworkPtr net(new Network(netId, netType));
+        CheckNonNull(net.pointer());
+        _networks.push_back(net);
+
+        // Load all transport streams in the network.
+        const size_t tsCount = in.getInt<uint32_t>();
+        for (size_t its = 0; in.valid() && its < tsCount; ++its) {
+            const TransportStreamPtr ts(net->tsGetOrCreate(in.getInt<uint16_t>()));
+            ts->onid = in.getInt<uint16_t>();
+            if (in.getInt<uint8_t>() != 0) {
+                in.getTune(ts->tune);
+            }
+
+            // Load all services in the transport stream.
+            const size_t srvCount = in.getInt<uint32_t>();
+            for (size_t isrv = 0; in.valid() && isrv < srvCount; ++isrv) {
+                const ServicePtr srv(new Service(in.getInt<uint16_t>()));
+                CheckNonNull(srv.pointer());
+                srv->name = in.getString();
+                srv->provider = in.getString();
+                in.getVar<uint16_t>(srv->lcn);
+                in.getVar<uint16_t>(srv->pmtPID);
+                in.getVar<uint8_t>(srv->type);
+                in.getVar<uint8_t>(srv->cas);
+                in.getVar<uint8_t>(srv->atscType);
+                in.getVar<uint16_t>(srv->atscMajorId);
+                in.getVar<uint16_t>(srv->atscMinorId);
+                ts->addService(srv, SHARE, true);
+            }
+        }
+    }
+
+    // The complete content must have been read, no more, no less.
+    if (!in.valid() || !in.atEnd()) {
+        report.debug(u"binary cache %s is corrupted, parsing XML file", {cacheName});
+        clear();
+        return false;
+    }
+
+    report.debug(u"loaded channel database from binary cache %s", {cacheName});
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Regenerate the binary cache of the XML file.
+//----------------------------------------------------------------------------
+
+void ts::ChannelFile::saveBinaryCache(const UString& cacheName, MilliSecond xmlTime, int64_t xmlSize, Report& report) const
+{
+    // Header: magic, format, TSDuck version, XML file size and time.
+    ByteBlock data;
+    data.appendUInt32(CACHE_MAGIC);
+    data.appendUInt16(CACHE_FORMAT_VERSION);
+    data.appendUInt16(TS_VERSION_MAJOR);
+    data.appendUInt16(TS_VERSION_MINOR);
+    data.appendUInt32(TS_COMMIT);
+    data.appendInt64(xmlTime);
+    data.appendInt64(xmlSize);
+
+    // Serialize all networks.
+    data.appendUInt32(uint32_t(_networks.size()));
+    for (auto itnet = _networks.begin(); itnet != _networks.end(); ++itnet) {
+        const NetworkPtr& net(*itnet);
+        assert(!net.isNull());
+        data.appendUInt16(net->id);
+        data.appendUInt8(uint8_t(net->type));
+
+        // Serialize all transport streams in the network.
+        data.appendUInt32(uint32_t(net->tsCount()));
+        for (size_t its = 0; its < net->tsCount(); ++its) {
+            const TransportStreamPtr& ts(net->tsByIndex(its));
+            assert(!ts.isNull());
+            data.appendUInt16(ts->id);
+            data.appendUInt16(ts->onid);
+            data.appendUInt8(ts->tune.hasModulationArgs() ? 1 : 0);
+            if (ts->tune.hasModulationArgs()) {
+                PutTune(data, ts->tune);
+            }
+
+            // Serialize all services in the transport stream.
+            data.appendUInt32(uint32_t(ts->serviceCount()));
+            for (size_t isrv = 0; isrv < ts->serviceCount(); ++isrv) {
+                const ServicePtr& srv(ts->serviceByIndex(isrv));
+                assert(!srv.isNull());
+                data.appendUInt16(srv->id);
+                PutString(data, srv->name);
+                PutString(data, srv->provider);
+                PutVar<uint16_t>(data, srv->lcn);
+                PutVar<uint16_t>(data, srv->pmtPID);
+                PutVar<uint8_t>(data, srv->type);
+                PutVar<uint8_t>(data, srv->cas);
+                PutVar<uint8_t>(data, srv->atscType);
+                PutVar<uint16_t>(data, srv->atscMajorId);
+                PutVar<uint16_t>(data, srv->atscMinorId);
+            }
+        }
+    }
+
+    // Write the cache file, best effort only.
+    if (data.saveToFile(cacheName, nullptr)) {
+        report.debug(u"regenerated binary cache %s", {cacheName});
+    }
+    else {
+        report.debug(u"error writing binary cache %s", {cacheName});
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Parse an XML document.
 //----------------------------------------------------------------------------
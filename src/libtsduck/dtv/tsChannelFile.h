@@ -70,6 +70,25 @@ namespace ts {
         //!
         void setTweaks(const xml::Tweaks& tweaks) { _xmlTweaks = tweaks; }
 
+        //!
+        //! Enable or disable the binary cache of the XML file.
+        //! When the cache is enabled (the default), loading an XML file first
+        //! looks for a sidecar binary file which contains a pre-parsed copy of
+        //! the channel database. The cache is used when it matches the size and
+        //! modification time of the XML file and is transparently regenerated
+        //! after parsing the XML file otherwise. Loading the cache is much
+        //! faster than parsing the XML text.
+        //! @param [in] enable True to enable the binary cache, false to always parse the XML file.
+        //!
+        void setBinaryCache(bool enable) { _useCache = enable; }
+
+        //!
+        //! Get the name of the binary cache file for a given XML file.
+        //! @param [in] xmlFileName XML file name.
+        //! @return The name of the sidecar binary cache file.
+        //!
+        static UString BinaryCacheName(const UString& xmlFileName) { return xmlFileName + u".bin"; }
+
         //!
         //! Clear all networks.
         //!
@@ -389,6 +408,16 @@ namespace ts {
         NetworkVector _networks;    // List of networks in the configuration.
         xml::Tweaks   _xmlTweaks;   // XML formatting and parsing tweaks.
         UString       _fileName;    // Name of loaded file.
+        bool          _useCache;    // Use the binary cache of the XML file.
+
+        // Load the binary cache of the XML file. The cache is used only when it
+        // was generated by the same version of TSDuck from an XML file with the
+        // same size and modification time. Return false when the cache is absent,
+        // stale or invalid (the XML file shall then be parsed).
+        bool loadBinaryCache(const UString& cacheName, MilliSecond xmlTime, int64_t xmlSize, Report& report);
+
+        // Regenerate the binary cache of the XML file (best effort, no error).
+        void saveBinaryCache(const UString& cacheName, MilliSecond xmlTime, int64_t xmlSize, Report& report) const;
 
         // Parse an XML document and load the content into this object.
         bool parseDocument(const xml::Document& doc);
@@ -29,6 +29,7 @@
 
 #include "tsContinuityAnalyzer.h"
 #include "tsNullReport.h"
+#include "tsMemory.h"
 TSDUCK_SOURCE;
 
 
@@ -50,6 +51,12 @@ ts::ContinuityAnalyzer::ContinuityAnalyzer(const PIDSet& pid_filter, Report* rep
     _pid_filter(pid_filter),
     _pid_states()
 {
+    TS_ZERO(_pid_states);
+}
+
+ts::ContinuityAnalyzer::~ContinuityAnalyzer()
+{
+    reset();
 }
 
 ts::ContinuityAnalyzer::PIDState::PIDState() :
@@ -81,7 +88,13 @@ void ts::ContinuityAnalyzer::reset()
     _processed_packets = 0;
     _fix_count = 0;
     _error_count = 0;
-    _pid_states.clear();
+
+    for (size_t i = 0; i < PID_MAX; ++i) {
+        if (_pid_states[i] != nullptr) {
+            delete _pid_states[i];
+            _pid_states[i] = nullptr;
+        }
+    }
 }
 
 
@@ -100,8 +113,9 @@ void ts::ContinuityAnalyzer::setPIDFilter(const PIDSet& pids)
     // Reset context of all removed PID's
     if (removed_pids.any()) {
         for (PID pid = 0; pid < PID_MAX; ++pid) {
-            if (removed_pids[pid]) {
-                _pid_states.erase(pid);
+            if (removed_pids[pid] && _pid_states[pid] != nullptr) {
+                delete _pid_states[pid];
+                _pid_states[pid] = nullptr;
             }
         }
     }
@@ -123,7 +137,10 @@ void ts::ContinuityAnalyzer::removePID(PID pid)
 {
     if (pid < _pid_filter.size() && _pid_filter[pid]) {
         _pid_filter.reset(pid);
-        _pid_states.erase(pid);
+        if (_pid_states[pid] != nullptr) {
+            delete _pid_states[pid];
+            _pid_states[pid] = nullptr;
+        }
     }
 }
 
@@ -139,14 +156,12 @@ bool ts::ContinuityAnalyzer::hasPID(PID pid) const
 
 uint8_t ts::ContinuityAnalyzer::firstCC(PID pid) const
 {
-    auto it = _pid_states.find(pid);
-    return it == _pid_states.end() ? INVALID_CC : it->second.first_cc;
+    return pid >= PID_MAX || _pid_states[pid] == nullptr ? INVALID_CC : _pid_states[pid]->first_cc;
 }
 
 uint8_t ts::ContinuityAnalyzer::lastCC(PID pid) const
 {
-    auto it = _pid_states.find(pid);
-    return it == _pid_states.end() ? INVALID_CC : it->second.last_cc_out;
+    return pid >= PID_MAX || _pid_states[pid] == nullptr ? INVALID_CC : _pid_states[pid]->last_cc_out;
 }
 
 
@@ -170,6 +185,33 @@ ts::UString ts::ContinuityAnalyzer::linePrefix(PID pid) const
 }
 
 
+//----------------------------------------------------------------------------
+// Process batches of packets.
+//----------------------------------------------------------------------------
+
+size_t ts::ContinuityAnalyzer::feedPackets(const TSPacket* pkt, size_t count)
+{
+    size_t errors = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!feedPacketInternal(const_cast<TSPacket*>(pkt + i), false)) {
+            errors++;
+        }
+    }
+    return errors;
+}
+
+size_t ts::ContinuityAnalyzer::feedPackets(TSPacket* pkt, size_t count)
+{
+    size_t errors = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!feedPacketInternal(pkt + i, true)) {
+            errors++;
+        }
+    }
+    return errors;
+}
+
+
 //----------------------------------------------------------------------------
 // Detect / fix error on packet.
 //----------------------------------------------------------------------------
@@ -177,21 +219,29 @@ ts::UString ts::ContinuityAnalyzer::linePrefix(PID pid) const
 bool ts::ContinuityAnalyzer::feedPacketInternal(TSPacket* pkt, bool update)
 {
     assert(pkt != nullptr);
-    const PID pid = pkt->getPID();
+
+    // Parse the packet header once, all criteria below use the same fields.
+    TSPacket::Header header;
+    pkt->parseHeader(header);
+
+    const PID pid = header.pid;
     bool result = true;
 
     // The null PID is never eligible for CC processing.
     if (pid != PID_NULL && _pid_filter.test(pid)) {
 
-        // Get or create PID context.
-        PIDState& state(_pid_states[pid]);
+        // Get or create PID context, direct index in a flat array, no map lookup.
+        if (_pid_states[pid] == nullptr) {
+            _pid_states[pid] = new PIDState;
+        }
+        PIDState& state(*_pid_states[pid]);
         const bool new_pid = state.first_cc == INVALID_CC;
 
         // Remember initial characteristics of the input packet.
         const uint8_t last_cc_in = new_pid ? INVALID_CC : state.last_pkt_in.getCC();
-        const uint8_t cc = pkt->getCC();
-        const bool has_payload = pkt->hasPayload();
-        const bool has_discontinuity = pkt->getDiscontinuityIndicator();
+        const uint8_t cc = header.cc;
+        const bool has_payload = header.payload;
+        const bool has_discontinuity = (header.af_flags & 0x80) != 0;
         const bool duplicated = !new_pid && !has_discontinuity && pkt->isDuplicate(state.last_pkt_in);
 
         // Save input packet as originally received.
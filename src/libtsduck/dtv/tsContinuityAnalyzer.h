@@ -53,6 +53,11 @@ namespace ts {
         //!
         explicit ContinuityAnalyzer(const PIDSet& pid_filter = NoPID, Report* report = nullptr);
 
+        //!
+        //! Destructor.
+        //!
+        ~ContinuityAnalyzer();
+
         //!
         //! Reset all collected information.
         //! Do not change processing options (display and/or fix errors).
@@ -76,6 +81,24 @@ namespace ts {
         //!
         bool feedPacket(TSPacket& pkt) { return feedPacketInternal(&pkt, true); }
 
+        //!
+        //! Process a batch of constant TS packets.
+        //! Can be used only to report discontinuity errors.
+        //! @param [in] pkt Address of the first transport stream packet.
+        //! @param [in] count Number of packets in the batch.
+        //! @return The number of packets with a discontinuity error.
+        //!
+        size_t feedPackets(const TSPacket* pkt, size_t count);
+
+        //!
+        //! Process or modify a batch of TS packets.
+        //! @param [in,out] pkt Address of the first transport stream packet.
+        //! The packets can be modified only when error fixing or generator mode is activated.
+        //! @param [in] count Number of packets in the batch.
+        //! @return The number of packets with a discontinuity error or a modification.
+        //!
+        size_t feedPackets(TSPacket* pkt, size_t count);
+
         //!
         //! Get the total number of TS packets.
         //! @return The total number of TS packets.
@@ -214,9 +237,6 @@ namespace ts {
             TSPacket last_pkt_in;  // Last input packet (before modification, if any).
         };
 
-        // A map of PID state, indexed by PID.
-        typedef std::map<PID,PIDState> PIDStateMap;
-
         // Private members.
         Report*       _report;            // Where to report errors, never null.
         int           _severity;          // Severity level for error messages.
@@ -229,7 +249,7 @@ namespace ts {
         PacketCounter _fix_count;         // Number of fixed (modified) packets.
         PacketCounter _error_count;       // Number of discontinuity errors.
         PIDSet        _pid_filter;        // Current set of filtered PID's.
-        PIDStateMap   _pid_states;        // State of all PID's.
+        PIDState*     _pid_states[PID_MAX]; // Per-PID state, direct index, created on demand.
 
         // Internal version of feedPacket.
         // The packet is modified only is update is true.
@@ -33,6 +33,7 @@
 
 #include "tsCyclingPacketizer.h"
 #include "tsNames.h"
+#include "tsFatal.h"
 TSDUCK_SOURCE;
 
 
@@ -50,7 +51,9 @@ ts::CyclingPacketizer::CyclingPacketizer(PID pid, StuffingPolicy stuffing, BitRa
     _sched_packets(0),
     _current_cycle(1),
     _remain_in_cycle(0),
-    _cycle_end(UNDEFINED)
+    _cycle_end(UNDEFINED),
+    _run_image(),
+    _run_next(0)
 {
 }
 
@@ -214,6 +217,8 @@ void ts::CyclingPacketizer::removeAll()
 void ts::CyclingPacketizer::reset()
 {
     removeAll();
+    _run_image.clear();
+    _run_next = 0;
     Packetizer::reset();
 }
 
@@ -284,6 +289,22 @@ void ts::CyclingPacketizer::setBitRate(BitRate new_bitrate)
 //----------------------------------------------------------------------------
 
 void ts::CyclingPacketizer::provideSection(SectionCounter counter, SectionPtr& sect)
+{
+    const SectionDescPtr sp(selectSection(counter));
+    if (sp.isNull()) {
+        sect.clear();
+    }
+    else {
+        sect = sp->section;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Select the next section to packetize and update the cycle bookkeeping.
+//----------------------------------------------------------------------------
+
+ts::CyclingPacketizer::SectionDescPtr ts::CyclingPacketizer::selectSection(SectionCounter counter)
 {
     const PacketCounter current_packet(packetCount());
     SectionDescPtr sp(nullptr);
@@ -324,13 +345,7 @@ void ts::CyclingPacketizer::provideSection(SectionCounter counter, SectionPtr& s
         _other_sections.push_back(sp);
     }
 
-    if (sp.isNull()) {
-        // No section to provide
-        sect.clear();
-    }
-    else {
-        // Provide this section
-        sect = sp->section;
+    if (!sp.isNull()) {
         // Remember packet index for this section
         sp->last_packet = current_packet;
         // Remember cycle index for this section
@@ -346,6 +361,109 @@ void ts::CyclingPacketizer::provideSection(SectionCounter counter, SectionPtr& s
             }
         }
     }
+    return sp;
+}
+
+
+//----------------------------------------------------------------------------
+// Packetize a section once into its cached packet images.
+//----------------------------------------------------------------------------
+
+void ts::CyclingPacketizer::BuildPacketImages(SectionDesc& desc)
+{
+    const Section& sect(*desc.section);
+    const size_t count = size_t(sect.packetCount());
+
+    desc.images = new ByteBlock(count * PKT_SIZE);
+    CheckNonNull(desc.images.pointer());
+
+    const uint8_t* content = sect.content();
+    size_t remain = sect.size();
+    uint8_t* data = desc.images->data();
+    bool first = true;
+
+    for (size_t i = 0; i < count; ++i) {
+        // TS header. The PID and continuity counter are patched at replay time.
+        data[0] = SYNC_BYTE;
+        PutUInt16(data + 1, first ? 0x4000 : 0x0000);  // payload_unit_start_indicator on first packet
+        data[3] = 0x10;  // no adaptation field, has payload
+
+        uint8_t* payload = data + 4;
+        size_t room = PKT_SIZE - 4;
+        if (first) {
+            // The section starts immediately after the pointer field.
+            *payload++ = 0x00;
+            room--;
+            first = false;
+        }
+
+        const size_t length = std::min(remain, room);
+        ::memcpy(payload, content, length);  // Flawfinder: ignore: memcpy()
+        if (length < room) {
+            ::memset(payload + length, 0xFF, room - length);
+        }
+        content += length;
+        remain -= length;
+        data += PKT_SIZE;
+    }
+    assert(remain == 0);
+}
+
+
+//----------------------------------------------------------------------------
+// Build the next MPEG packet for the list of sections.
+//----------------------------------------------------------------------------
+
+bool ts::CyclingPacketizer::getNextPacket(TSPacket& pkt)
+{
+    // Replay path: when stuffing is always applied, each section occupies its
+    // own run of TS packets, starting on a packet boundary and stuffed at the
+    // end. The packet images of such a run are identical at each cycle, except
+    // for the PID and the continuity counters. Packetize each section once,
+    // then replay the cached images with a simple header patch.
+    if (_run_image.isNull() && _stuffing == ALWAYS && Packetizer::atSectionBoundary()) {
+        const SectionDescPtr sp(selectSection(_section_in_count));
+        if (!sp.isNull()) {
+            _section_in_count++;
+            if (sp->images.isNull()) {
+                BuildPacketImages(*sp);
+            }
+            _run_image = sp->images;
+            _run_next = 0;
+        }
+    }
+
+    if (!_run_image.isNull()) {
+        // Replay one cached packet image.
+        _packet_count++;
+        ::memcpy(pkt.b, _run_image->data() + _run_next, PKT_SIZE);  // Flawfinder: ignore: memcpy()
+        pkt.setPID(getPID());
+        pkt.setCC(_continuity);
+        _continuity = (_continuity + 1) & 0x0F;
+        _run_next += PKT_SIZE;
+        if (_run_next >= _run_image->size()) {
+            // End of the section run.
+            _run_image.clear();
+            _run_next = 0;
+            _section_out_count++;
+        }
+        return true;
+    }
+
+    // General path, using the generic packetization engine.
+    return Packetizer::getNextPacket(pkt);
+}
+
+
+//----------------------------------------------------------------------------
+// Check if the packet stream is exactly at a section boundary.
+//----------------------------------------------------------------------------
+
+bool ts::CyclingPacketizer::atSectionBoundary() const
+{
+    // In the middle of a replayed run of cached packet images, the generic
+    // packetization engine is idle and believes it is at a section boundary.
+    return _run_image.isNull() && Packetizer::atSectionBoundary();
 }
 
 
@@ -208,6 +208,8 @@ namespace ts {
         bool atCycleBoundary() const;
 
         // Inherited from Packetizer.
+        virtual bool atSectionBoundary() const override;
+        virtual bool getNextPacket(TSPacket& packet) override;
         virtual void reset() override;
         virtual std::ostream& display(std::ostream& strm) const override;
 
@@ -222,10 +224,11 @@ namespace ts {
             PacketCounter  last_packet; // Packet index of last time the section was sent
             PacketCounter  due_packet;  // Packet index of next time
             SectionCounter last_cycle;  // Cycle index of last time the section was sent
+            ByteBlockPtr   images;      // Cached TS packet images of the section, lazily built
 
             // Constructor
             SectionDesc(const SectionPtr& sec, MilliSecond rep) :
-                section(sec), repetition(rep), last_packet(0), due_packet(0), last_cycle(0)
+                section(sec), repetition(rep), last_packet(0), due_packet(0), last_cycle(0), images()
             {
             }
 
@@ -249,6 +252,8 @@ namespace ts {
         SectionCounter  _current_cycle;   // Cycle number (start at 1, always increasing)
         size_t          _remain_in_cycle; // Number of unsent sections in this cycle
         SectionCounter  _cycle_end;       // At end of cycle, contains the index of last section
+        ByteBlockPtr    _run_image;       // Cached packet images of the section being replayed
+        size_t          _run_next;        // Offset of next packet image in _run_image
 
         static const SectionCounter UNDEFINED = ~SectionCounter(0);
 
@@ -256,6 +261,14 @@ namespace ts {
         // after other sections with the same due_packet.
         void addScheduledSection(const SectionDescPtr&);
 
+        // Select the next section to packetize and update the cycle bookkeeping.
+        // Return a null pointer when no section is available.
+        SectionDescPtr selectSection(SectionCounter counter);
+
+        // Packetize a section once into its cached packet images.
+        // The PID and continuity counters are patched at replay time.
+        static void BuildPacketImages(SectionDesc& desc);
+
         // Remove all sections with the specified tid/tid_ext in the specified list.
         void removeSections(SectionDescList&, TID, uint16_t tid_ext, bool use_tid_ext, bool scheduled);
 
@@ -336,3 +336,31 @@ bool ts::Descriptor::fromXML(DuckContext& duck, const xml::Element* node, TID ti
     // The XML element name was not valid.
     return false;
 }
+
+
+//----------------------------------------------------------------------------
+// Lightweight non-owning view over a serialized descriptor loop.
+//----------------------------------------------------------------------------
+
+ts::DescriptorLoopView::DescriptorLoopView(const void* data, size_t size) :
+    _data(reinterpret_cast<const uint8_t*>(data)),
+    _remain(data == nullptr ? 0 : size),
+    _tag(0),
+    _payload(nullptr),
+    _length(0)
+{
+}
+
+bool ts::DescriptorLoopView::next()
+{
+    // Stop at end of loop or on a truncated trailing descriptor.
+    if (_remain < 2 || size_t(_data[1]) + 2 > _remain) {
+        return false;
+    }
+    _tag = DID(_data[0]);
+    _length = size_t(_data[1]);
+    _payload = _data + 2;
+    _data += 2 + _length;
+    _remain -= 2 + _length;
+    return true;
+}
@@ -281,4 +281,71 @@ namespace ts {
         // Private fields
         ByteBlockPtr _data; // full binary content of the descriptor
     };
+
+    //!
+    //! Lightweight non-owning view over a serialized descriptor loop.
+    //! @ingroup mpeg
+    //!
+    //! An instance of this class iterates over the (tag, payload) pairs of
+    //! a serialized descriptor loop, directly on the binary area of a
+    //! section, without materializing Descriptor objects and without
+    //! copying payloads. This is intended for scanning hot paths which
+    //! only look for a few tags and discard everything else.
+    //!
+    //! The view does not own the memory area. The caller must ensure that
+    //! the section data remain valid and unmodified while the view is used.
+    //!
+    //! Typical usage:
+    //! @code
+    //! ts::DescriptorLoopView view(data, size);
+    //! while (view.next()) {
+    //!     if (view.tag() == ts::DID_CA) {
+    //!         // process view.payload() / view.payloadSize()
+    //!     }
+    //! }
+    //! @endcode
+    //!
+    class TSDUCKDLL DescriptorLoopView
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] data Address of the serialized descriptor loop.
+        //! @param [in] size Size in bytes of the descriptor loop.
+        //!
+        DescriptorLoopView(const void* data, size_t size);
+
+        //!
+        //! Advance to the next descriptor in the loop.
+        //! Must be called once before accessing the first descriptor.
+        //! @return True if a complete descriptor is available, false when
+        //! the loop is exhausted or ends with a truncated descriptor.
+        //!
+        bool next();
+
+        //!
+        //! Get the tag of the current descriptor.
+        //! @return The tag of the current descriptor.
+        //!
+        DID tag() const { return _tag; }
+
+        //!
+        //! Get the address of the payload of the current descriptor.
+        //! @return Address of the payload of the current descriptor.
+        //!
+        const uint8_t* payload() const { return _payload; }
+
+        //!
+        //! Get the size in bytes of the payload of the current descriptor.
+        //! @return Size in bytes of the payload of the current descriptor.
+        //!
+        size_t payloadSize() const { return _length; }
+
+    private:
+        const uint8_t* _data;     // Next unparsed byte in the loop.
+        size_t         _remain;   // Remaining bytes in the loop.
+        DID            _tag;      // Tag of the current descriptor.
+        const uint8_t* _payload;  // Payload of the current descriptor.
+        size_t         _length;   // Payload size of the current descriptor.
+    };
 }
@@ -34,6 +34,7 @@
 #include "tsCerrReport.h"
 #include "tsDVBCharset.h"
 #include "tsArgs.h"
+#include "tsDuckExtensionRepository.h"
 TSDUCK_SOURCE;
 
 
@@ -63,6 +64,10 @@ ts::DuckContext::DuckContext(Report* report, std::ostream* output) :
                     {CASID_VIACCESS_MIN,   u"viaccess"},
                     {CASID_WIDEVINE_MIN,   u"widevine"}}
 {
+    // Creating a TSDuck context is the sign that the application will process
+    // PSI/SI or plugins. Make sure the extensions are loaded (lazy, done once)
+    // so that the tables and descriptors they register become visible.
+    DuckExtensionRepository::Instance();
 }
 
 
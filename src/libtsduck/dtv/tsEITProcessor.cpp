@@ -29,11 +29,14 @@
 
 #include "tsEITProcessor.h"
 #include "tsSection.h"
+#include "tsCRC32.h"
 #include "tsTime.h"
 #include "tsMJD.h"
 #include "tsFatal.h"
 TSDUCK_SOURCE;
 
+#define MAX_CACHED_SECTIONS 5000  // Maximum number of sections in the transformation cache.
+
 
 //----------------------------------------------------------------------------
 // Constructor.
@@ -51,7 +54,8 @@ ts::EITProcessor::EITProcessor(DuckContext& duck, PID pid) :
     _removed_tids(),
     _removed(),
     _kept(),
-    _renamed()
+    _renamed(),
+    _cache()
 {
     _input_pids.set(pid);
     _demux.addPID(pid);
@@ -68,6 +72,7 @@ void ts::EITProcessor::reset()
     _removed.clear();
     _kept.clear();
     _renamed.clear();
+    _cache.clear();
 }
 
 
@@ -164,6 +169,7 @@ void ts::EITProcessor::removeTS(uint16_t ts_id)
     Service srv;
     srv.setTSId(ts_id);
     _removed.push_back(srv);
+    _cache.clear();
 }
 
 void ts::EITProcessor::removeTS(const TransportStreamId& ts)
@@ -172,6 +178,7 @@ void ts::EITProcessor::removeTS(const TransportStreamId& ts)
     srv.setTSId(ts.transport_stream_id);
     srv.setONId(ts.original_network_id);
     _removed.push_back(srv);
+    _cache.clear();
 }
 
 
@@ -185,6 +192,7 @@ void ts::EITProcessor::renameTS(uint16_t old_ts_id, uint16_t new_ts_id)
     old_srv.setTSId(old_ts_id);
     new_srv.setTSId(new_ts_id);
     _renamed.push_back(std::make_pair(old_srv, new_srv));
+    _cache.clear();
 }
 
 void ts::EITProcessor::renameTS(const TransportStreamId& old_ts, const TransportStreamId& new_ts)
@@ -195,6 +203,7 @@ void ts::EITProcessor::renameTS(const TransportStreamId& old_ts, const Transport
     new_srv.setTSId(new_ts.transport_stream_id);
     new_srv.setONId(new_ts.original_network_id);
     _renamed.push_back(std::make_pair(old_srv, new_srv));
+    _cache.clear();
 }
 
 
@@ -205,21 +214,25 @@ void ts::EITProcessor::renameTS(const TransportStreamId& old_ts, const Transport
 void ts::EITProcessor::keepService(uint16_t service_id)
 {
     _kept.push_back(Service(service_id));
+    _cache.clear();
 }
 
 void ts::EITProcessor::keepService(const Service& service)
 {
     _kept.push_back(service);
+    _cache.clear();
 }
 
 void ts::EITProcessor::removeService(uint16_t service_id)
 {
     _removed.push_back(Service(service_id));
+    _cache.clear();
 }
 
 void ts::EITProcessor::removeService(const Service& service)
 {
     _removed.push_back(service);
+    _cache.clear();
 }
 
 
@@ -230,6 +243,7 @@ void ts::EITProcessor::removeService(const Service& service)
 void ts::EITProcessor::renameService(const Service& old_service, const Service& new_service)
 {
     _renamed.push_back(std::make_pair(old_service, new_service));
+    _cache.clear();
 }
 
 
@@ -240,6 +254,7 @@ void ts::EITProcessor::renameService(const Service& old_service, const Service&
 void ts::EITProcessor::removeTableIds(const std::initializer_list<TID>& tids)
 {
     _removed_tids.insert(tids);
+    _cache.clear();
 }
 
 void ts::EITProcessor::removeOther()
@@ -248,6 +263,7 @@ void ts::EITProcessor::removeOther()
     for (TID tid = TID_EIT_S_OTH_MIN; tid <= TID_EIT_S_OTH_MAX; ++tid) {
         _removed_tids.insert(tid);
     }
+    _cache.clear();
 }
 
 void ts::EITProcessor::removeActual()
@@ -256,6 +272,7 @@ void ts::EITProcessor::removeActual()
     for (TID tid = TID_EIT_S_ACT_MIN; tid <= TID_EIT_S_ACT_MAX; ++tid) {
         _removed_tids.insert(tid);
     }
+    _cache.clear();
 }
 
 void ts::EITProcessor::removeSchedule()
@@ -266,11 +283,13 @@ void ts::EITProcessor::removeSchedule()
     for (TID tid = TID_EIT_S_OTH_MIN; tid <= TID_EIT_S_OTH_MAX; ++tid) {
         _removed_tids.insert(tid);
     }
+    _cache.clear();
 }
 
 void ts::EITProcessor::removePresentFollowing()
 {
     _removed_tids.insert({TID_EIT_PF_ACT, TID_EIT_PF_OTH});
+    _cache.clear();
 }
 
 
@@ -282,6 +301,7 @@ void ts::EITProcessor::addStartTimeOffet(MilliSecond offset, bool date_only)
 {
     _start_time_offset = offset;
     _date_only = date_only;
+    _cache.clear();
 }
 
 
@@ -299,11 +319,68 @@ bool ts::EITProcessor::Match(const Service& srv, uint16_t srv_id, uint16_t ts_id
 }
 
 
+//----------------------------------------------------------------------------
+// Compute the cache key for a section, a hash of its binary content.
+//----------------------------------------------------------------------------
+
+uint64_t ts::EITProcessor::SectionHash(const Section& section)
+{
+    CRC32 crc;
+    crc.add(section.content(), section.size());
+    return (uint64_t(crc.value()) << 32) | uint64_t(section.size());
+}
+
+
 //----------------------------------------------------------------------------
 // Implementation of SectionHandlerInterface.
 //----------------------------------------------------------------------------
 
 void ts::EITProcessor::handleSection(SectionDemux& demux, const Section& section)
+{
+    // Look for a previous occurrence of the exact same section content.
+    // A section which did not change since its last occurrence (same bytes,
+    // hence same version) replays its cached transformed image, or its cached
+    // removal decision, without re-applying the transformations. Continuity
+    // counters are regenerated by the packetizer on output in all cases.
+    const uint64_t hash = SectionHash(section);
+    const auto hit = _cache.find(hash);
+    if (hit != _cache.end() &&
+        hit->second.original->size() == section.size() &&
+        ::memcmp(hit->second.original->data(), section.content(), section.size()) == 0)
+    {
+        if (!hit->second.result.isNull()) {
+            _sections.push_back(hit->second.result);
+        }
+        return;
+    }
+
+    // New or modified section, apply the transformations and cache the result.
+    // Avoid unbounded growth when the EIT content constantly changes.
+    if (_cache.size() >= MAX_CACHED_SECTIONS) {
+        _cache.clear();
+    }
+    CachedSection& entry(_cache[hash]);
+    entry.original = new ByteBlock(section.content(), section.size());
+    CheckNonNull(entry.original.pointer());
+    entry.result = transformSection(section);
+
+    if (!entry.result.isNull()) {
+        // Now insert the section in the queue for the packetizer.
+        // The queue shall never grow much because we replace packet by packet on one PID.
+        // However, we still may collect many small sections while serializing a very big one.
+        // But it should stay within some finite limits. These limits are difficult to anticipate.
+        // Just check that the queue does not become crazy.
+        assert(_sections.size() < 1000);
+        _sections.push_back(entry.result);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Apply all transformations on a section.
+//----------------------------------------------------------------------------
+
+ts::SectionPtr ts::EITProcessor::transformSection(const Section& section)
 {
     const TID tid = section.tableId();
     const size_t pl_size = section.payloadSize();
@@ -311,7 +388,7 @@ void ts::EITProcessor::handleSection(SectionDemux& demux, const Section& section
     // Eliminate sections by table id.
     if (_removed_tids.find(tid) != _removed_tids.end()) {
         // This table id is part of tables to be removed.
-        return;
+        return SectionPtr();
     }
 
     // Check if the table is an EIT. Use the fact that all EIT ids are contiguous.
@@ -319,7 +396,7 @@ void ts::EITProcessor::handleSection(SectionDemux& demux, const Section& section
 
     // The minimal payload size for EIT's is 6 bytes. Eliminate invalid EIT's.
     if (is_eit && pl_size < 6) {
-        return;
+        return SectionPtr();
     }
 
     // Get EIT's characteristics.
@@ -346,7 +423,7 @@ void ts::EITProcessor::handleSection(SectionDemux& demux, const Section& section
         }
         if (!keep) {
             // Ignore all EIT's for services to remove.
-            return;
+            return SectionPtr();
         }
     }
 
@@ -408,11 +485,5 @@ void ts::EITProcessor::handleSection(SectionDemux& demux, const Section& section
         }
     }
 
-    // Now insert the section in the queue for the packetizer.
-    // The queue shall never grow much because we replace packet by packet on one PID.
-    // However, we still may collect many small sections while serializing a very big one.
-    // But it should stay within some finite limits. These limits are difficult to anticipate.
-    // Just check that the queue does not become crazy.
-    assert(_sections.size() < 1000);
-    _sections.push_back(sp);
+    return sp;
 }
@@ -212,6 +212,17 @@ namespace ts {
         void addStartTimeOffet(MilliSecond offset, bool date_only = false);
 
     private:
+        // One entry in the transformation cache. The key is a hash of the original
+        // section content, the original bytes are kept to eliminate hash collisions.
+        // A null result means that the section is dropped by the transformations.
+        class CachedSection
+        {
+        public:
+            ByteBlockPtr original;  // Original binary content of the section.
+            SectionPtr   result;    // Transformed section, null when dropped.
+            CachedSection() : original(), result() {}
+        };
+
         DuckContext&          _duck;
         PIDSet                _input_pids;
         PID                   _output_pid;
@@ -224,11 +235,19 @@ namespace ts {
         std::list<Service>    _removed;
         std::list<Service>    _kept;
         std::list<std::pair<Service,Service>> _renamed;
+        std::map<uint64_t,CachedSection> _cache;
 
         // Check if a service matches a DVB triplet.
         // The service must have at least a service id or transport id.
         static bool Match(const Service& srv, uint16_t srv_id, uint16_t ts_id, uint16_t net_id);
 
+        // Compute the cache key for a section, a hash of its binary content.
+        static uint64_t SectionHash(const Section& section);
+
+        // Apply all transformations on a section. Return a null pointer when
+        // the section shall be dropped.
+        SectionPtr transformSection(const Section& section);
+
         // Implementation of SectionHandlerInterface.
         virtual void handleSection(SectionDemux& demux, const Section& section) override;
 
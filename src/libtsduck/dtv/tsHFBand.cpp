@@ -30,11 +30,77 @@
 #include "tsHFBand.h"
 #include "tsDuckConfigFile.h"
 #include "tsGuard.h"
+#include "tsSysUtils.h"
 #include "tsxmlDocument.h"
 #include "tsxmlElement.h"
 TSDUCK_SOURCE;
 
 
+//----------------------------------------------------------------------------
+// Compiled-in standard band definitions.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // One range of channels in a built-in band definition.
+    struct BuiltinRange
+    {
+        uint32_t first_channel;
+        uint32_t last_channel;
+        uint64_t base_frequency;
+        uint64_t channel_width;
+        int32_t  first_offset;
+        int32_t  last_offset;
+        uint64_t offset_width;
+    };
+
+    // One built-in band definition.
+    struct BuiltinBand
+    {
+        ts::HFBand::BandType        type;
+        const ts::UChar* const*     regions;      // Null-terminated list of regions.
+        const BuiltinRange*         ranges;       // In order of channel numbers.
+        size_t                      range_count;
+    };
+
+    // Standard band layouts. These tables are the compiled-in equivalent of
+    // the historical tsduck.hfbands.xml file. An optional XML file can still
+    // add or override band definitions, see HFBandRepository::load().
+    constexpr ts::UChar const* EUROPE_REGIONS[]   = {u"europe", u"uk", u"france", nullptr};
+    constexpr ts::UChar const* US_UHF_REGIONS[]   = {u"usa", u"us", nullptr};
+    constexpr ts::UChar const* AMERICAS_REGIONS[] = {u"americas", u"usa", u"us", u"korea", u"taiwan", u"philippines", nullptr};
+    constexpr ts::UChar const* JAPAN_REGIONS[]    = {u"japan", nullptr};
+
+    constexpr BuiltinRange EUROPE_UHF_RANGES[] = {
+        {21, 69, TS_UCONST64(474000000), TS_UCONST64(8000000), -1, 3, TS_UCONST64(166666)},
+    };
+    constexpr BuiltinRange EUROPE_VHF_RANGES[] = {
+        {5, 12, TS_UCONST64(177500000), TS_UCONST64(7000000), -1, 3, TS_UCONST64(166666)},
+    };
+    constexpr BuiltinRange US_UHF_RANGES[] = {
+        {14, 69, TS_UCONST64(473000000), TS_UCONST64(6000000), 0, 0, 0},
+    };
+    constexpr BuiltinRange AMERICAS_VHF_RANGES[] = {
+        {1,  1,  TS_UCONST64(47000000),  TS_UCONST64(6000000), 0, 0, 0},
+        {2,  4,  TS_UCONST64(57000000),  TS_UCONST64(6000000), 0, 0, 0},
+        {5,  6,  TS_UCONST64(79000000),  TS_UCONST64(6000000), 0, 0, 0},
+        {7,  13, TS_UCONST64(177000000), TS_UCONST64(6000000), 0, 0, 0},
+    };
+    constexpr BuiltinRange JAPAN_VHF_RANGES[] = {
+        {1,  3,  TS_UCONST64(93000000),  TS_UCONST64(6000000), 0, 0, 0},
+        {4,  12, TS_UCONST64(173000000), TS_UCONST64(6000000), 0, 0, 0},
+    };
+
+    constexpr BuiltinBand BUILTIN_BANDS[] = {
+        {ts::HFBand::UHF, EUROPE_REGIONS,   EUROPE_UHF_RANGES,   1},
+        {ts::HFBand::VHF, EUROPE_REGIONS,   EUROPE_VHF_RANGES,   1},
+        {ts::HFBand::UHF, US_UHF_REGIONS,   US_UHF_RANGES,       1},
+        {ts::HFBand::VHF, AMERICAS_REGIONS, AMERICAS_VHF_RANGES, 4},
+        {ts::HFBand::VHF, JAPAN_REGIONS,    JAPAN_VHF_RANGES,    2},
+    };
+}
+
+
 //----------------------------------------------------------------------------
 // Constructors and destructors
 //----------------------------------------------------------------------------
@@ -437,6 +503,7 @@ TS_DEFINE_SINGLETON(ts::HFBand::HFBandRepository);
 ts::HFBand::HFBandRepository::HFBandRepository() :
     bandTypeEnum({{u"VHF", ts::HFBand::VHF}, {u"UHF", ts::HFBand::UHF}}),
     _mutex(),
+    _loaded(false),
     _default_region(),
     _objects(),
     _allRegions(),
@@ -451,11 +518,16 @@ ts::HFBand::HFBandRepository::HFBandRepository() :
 
 bool ts::HFBand::HFBandRepository::load(Report& report)
 {
+    // Fast path: the repository is immutable once loaded.
+    if (_loaded.load(std::memory_order_acquire)) {
+        return true;
+    }
+
     // Lock access to the repository.
     Guard lock(_mutex);
 
     // If already loaded, fine.
-    if (!_objects.empty()) {
+    if (_loaded.load(std::memory_order_relaxed)) {
         return true;
     }
 
@@ -465,9 +537,63 @@ bool ts::HFBand::HFBandRepository::load(Report& report)
     // A set of region names (to build a list of unique names).
     std::set<UString> regionSet;
 
-    // Load the repository XML file. Search it in TSDuck directory.
+    // Build the standard bands from the compiled-in tables. No I/O, no XML
+    // parsing, this is the common case.
+    for (size_t ib = 0; ib < sizeof(BUILTIN_BANDS) / sizeof(BUILTIN_BANDS[0]); ++ib) {
+        const BuiltinBand& bb(BUILTIN_BANDS[ib]);
+        HFBandPtr hf(new HFBand(bb.type));
+        CheckNonNull(hf.pointer());
+        for (const UChar* const* reg = bb.regions; *reg != nullptr; ++reg) {
+            hf->_regions.push_back(*reg);
+        }
+        for (size_t ir = 0; ir < bb.range_count; ++ir) {
+            const BuiltinRange& br(bb.ranges[ir]);
+            ChannelsRange chan;
+            chan.first_channel = br.first_channel;
+            chan.last_channel = br.last_channel;
+            chan.base_frequency = br.base_frequency;
+            chan.channel_width = br.channel_width;
+            chan.first_offset = br.first_offset;
+            chan.last_offset = br.last_offset;
+            chan.offset_width = br.offset_width;
+            // The built-in tables are in order of channel numbers.
+            hf->_channels.push_back(chan);
+            hf->_channel_count += chan.last_channel + 1 - chan.first_channel;
+        }
+        for (auto it = hf->_regions.begin(); it != hf->_regions.end(); ++it) {
+            regionSet.insert(*it);
+            _objects[HFBandIndex(hf->_type, *it)] = hf;
+        }
+    }
+
+    // Apply an optional XML file on top of the built-in definitions. The file
+    // may add new regions or override the standard bands.
+    bool success = true;
+    const UString xmlFile(SearchConfigurationFile(u"tsduck.hfbands.xml"));
+    if (!xmlFile.empty()) {
+        success = loadXML(xmlFile, regionSet, report);
+    }
+
+    // Build a sorted list of region names.
+    for (auto it = regionSet.begin(); it != regionSet.end(); ++it) {
+        _allRegions.push_back(*it);
+    }
+
+    // The repository is now immutable, lookups no longer need the lock.
+    _loaded.store(true, std::memory_order_release);
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Load an XML file with band definition additions or overrides.
+//----------------------------------------------------------------------------
+
+bool ts::HFBand::HFBandRepository::loadXML(const UString& fileName, std::set<UString>& regionSet, Report& report)
+{
+    // Load the XML file.
     xml::Document doc(report);
-    if (!doc.load(u"tsduck.hfbands.xml", true)) {
+    if (!doc.load(fileName, false)) {
         return false;
     }
 
@@ -486,6 +612,10 @@ bool ts::HFBand::HFBandRepository::load(Report& report)
     // Get the root in the document. Should be ok since we validated the document.
     const xml::Element* root = doc.rootElement();
 
+    // Indexes which were loaded from this file (to detect duplicates in the
+    // file itself, overriding a built-in band is legitimate).
+    std::set<HFBandIndex> xmlIndexes;
+
     // Analyze all <hfband> in the document.
     bool success = true;
     for (const xml::Element* node = root == nullptr ? nullptr : root->firstChildElement(); node != nullptr; node = node->nextSiblingElement()) {
@@ -501,7 +631,7 @@ bool ts::HFBand::HFBandRepository::load(Report& report)
                 const HFBandIndex index(hf->_type, *it);
                 // Build a set of unique entries for region names.
                 regionSet.insert(*it);
-                if (_objects.find(index) != _objects.end()) {
+                if (!xmlIndexes.insert(index).second) {
                     report.error(u"duplicate definition for %s, line %d", {index, node->lineNumber()});
                     success = false;
                 }
@@ -511,12 +641,6 @@ bool ts::HFBand::HFBandRepository::load(Report& report)
             }
         }
     }
-
-    // Build a sorted list of region names.
-    for (auto it = regionSet.begin(); it != regionSet.end(); ++it) {
-        _allRegions.push_back(*it);
-    }
-
     return success;
 }
 
@@ -545,10 +669,9 @@ void ts::HFBand::HFBandRepository::setDefaultRegion(const UString& region)
 
 const ts::HFBand* ts::HFBand::HFBandRepository::get(BandType type, const UString& region, Report& report) const
 {
-    // Lock access to the repository.
-    Guard lock(_mutex);
-
-    const HFBandIndex index(type, region.empty() ? _default_region : region);
+    // The repository is immutable after load(), the lookup needs no lock.
+    // Only the default region remains mutable and has its own guarded accessor.
+    const HFBandIndex index(type, region.empty() ? defaultRegion() : region);
     const auto it = _objects.find(index);
     if (it != _objects.end()) {
         return it->second.pointer();
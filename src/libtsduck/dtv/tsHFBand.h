@@ -49,8 +49,9 @@ namespace ts {
     //! @ingroup hardware
     //!
     //! There is a repository of known UHF and VHF bands layout per country or region.
-    //! This repository is read from an XML file. There is only one instance of HFBand
-    //! per country or region.
+    //! The standard band definitions are compiled in the TSDuck library. An optional
+    //! XML file can add or override band definitions. There is only one instance of
+    //! HFBand per country or region.
     //! @see ts::HFBand::GetBand()
     //!
     class TSDUCKDLL HFBand
@@ -312,9 +313,12 @@ namespace ts {
             TS_DECLARE_SINGLETON(HFBandRepository);
         public:
             // Load the repository if not already done. Return false on error.
+            // The standard bands are built from compiled-in tables. An optional
+            // XML file can add or override band definitions.
             bool load(Report&);
 
             // Get an object from the repository.
+            // The repository is immutable after load(), the lookup is lock-free.
             const HFBand* get(BandType type, const UString& region, Report& report) const;
 
             // Get/set the default region.
@@ -328,11 +332,15 @@ namespace ts {
             const UStringList& allRegions() const { return _allRegions; }
 
         private:
-            mutable Mutex _mutex;
-            UString       _default_region;
-            HFBandMap     _objects;
-            UStringList   _allRegions;
-            HFBandPtr     _voidBand;
+            mutable Mutex     _mutex;
+            std::atomic<bool> _loaded;
+            UString           _default_region;
+            HFBandMap         _objects;
+            UStringList       _allRegions;
+            HFBandPtr         _voidBand;
+
+            // Load an XML file with band definition additions or overrides.
+            bool loadXML(const UString& fileName, std::set<UString>& regionSet, Report& report);
         };
     };
 }
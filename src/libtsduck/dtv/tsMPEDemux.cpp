@@ -34,6 +34,9 @@
 #include "tsIPMACStreamLocationDescriptor.h"
 TSDUCK_SOURCE;
 
+// Maximum number of MPE packets in one batch.
+#define MAX_MPE_BATCH 32
+
 
 //----------------------------------------------------------------------------
 // Constructors and destructors.
@@ -46,7 +49,10 @@ ts::MPEDemux::MPEDemux(DuckContext& duck, MPEHandlerInterface* mpe_handler, cons
     _ts_id(0),
     _pmts(),
     _new_pids(),
-    _int_tags()
+    _int_tags(),
+    _mpe_pool(),
+    _mpe_count(0),
+    _mpe_pid(PID_NULL)
 {
     immediateReset();
 }
@@ -97,6 +103,9 @@ void ts::MPEDemux::immediateReset()
     _new_pids.reset();
     _int_tags.clear();
 
+    // Discard undelivered MPE packets (the pool itself is kept).
+    _mpe_count = 0;
+
     // To get PID's with MPE, we need to analyze the PMT's.
     // To get the PMT PID's, we need to analyze the PAT.
     _psi_demux.addPID(PID_PAT);
@@ -114,6 +123,20 @@ void ts::MPEDemux::feedPacket(const TSPacket& pkt)
 
     // Submit the packet to the PSI handler to detect MPE streams.
     _psi_demux.feedPacket(pkt);
+
+    // Deliver the MPE packets which were built from this TS packet.
+    flushMPEBatch();
+}
+
+void ts::MPEDemux::feedPackets(const TSPacket* pkt, size_t count)
+{
+    // Process the packets in sequence but deliver the extracted MPE packets
+    // in batches covering the whole chunk, not one batch per TS packet.
+    for (size_t i = 0; i < count; ++i) {
+        SuperClass::feedPacket(pkt[i]);
+        _psi_demux.feedPacket(pkt[i]);
+    }
+    flushMPEBatch();
 }
 
 
@@ -128,27 +151,65 @@ void ts::MPEDemux::handleSection(SectionDemux& demux, const Section& section)
     // So, we need to carefully filter the sections. This must be a
     // DSM-CC Private Data section and it must come from a PID we filter.
 
-    if (section.tableId() == TID_DSMCC_PD && _pid_filter.test(section.sourcePID())) {
+    if (section.tableId() == TID_DSMCC_PD && _pid_filter.test(section.sourcePID()) && _handler != nullptr) {
 
-        // Build the corresponding MPE packet.
-        MPEPacket mpe(section);
-        if (mpe.isValid() && _handler != nullptr) {
+        // Deliver the pending packets first when the batch is full or when
+        // the source PID changes, so that a batch comes from one single PID.
+        if (_mpe_count >= MAX_MPE_BATCH || (_mpe_count > 0 && section.sourcePID() != _mpe_pid)) {
+            flushMPEBatch();
+        }
 
-            // Send the MPE packet to the application.
-            beforeCallingHandler(section.sourcePID());
-            try {
-                _handler->handleMPEPacket(*this, mpe);
-            }
-            catch (...) {
-                afterCallingHandler(false);
-                throw;
-            }
-            afterCallingHandler(true);
+        // Build the corresponding MPE packet in a pooled object. The packet
+        // is a non-owning view into the section buffer: the datagram is not
+        // copied and the view remains valid until the section demux reuses
+        // the section, after the handler returns. Handlers which retain a
+        // packet must copy it, as documented in MPEHandlerInterface.
+        if (_mpe_count >= _mpe_pool.size()) {
+            _mpe_pool.push_back(MPEPacketPtr(new MPEPacket));
+        }
+        MPEPacket& mpe(*_mpe_pool[_mpe_count]);
+        mpe.reference(section);
+        if (mpe.isValid()) {
+            _mpe_pid = section.sourcePID();
+            _mpe_count++;
         }
     }
 }
 
 
+//----------------------------------------------------------------------------
+// Deliver all pending MPE packets to the application handler.
+//----------------------------------------------------------------------------
+
+void ts::MPEDemux::flushMPEBatch()
+{
+    if (_mpe_count > 0 && _handler != nullptr) {
+
+        // Collect the addresses of the pending packets.
+        const MPEPacket* batch[MAX_MPE_BATCH];
+        const size_t count = _mpe_count;
+        for (size_t i = 0; i < count; ++i) {
+            batch[i] = _mpe_pool[i].pointer();
+        }
+
+        // Mark the batch as delivered before invoking the handler.
+        _mpe_count = 0;
+
+        // Send the batch of MPE packets to the application.
+        beforeCallingHandler(_mpe_pid);
+        try {
+            _handler->handleMPEBatch(*this, batch, count);
+        }
+        catch (...) {
+            afterCallingHandler(false);
+            throw;
+        }
+        afterCallingHandler(true);
+    }
+    _mpe_count = 0;
+}
+
+
 //----------------------------------------------------------------------------
 // Invoked by the PSI demux when a complete table is available.
 //----------------------------------------------------------------------------
@@ -295,6 +356,9 @@ void ts::MPEDemux::processMPEDiscovery(const PMT& pmt, PID pid)
     // Don't signal the same PID twice.
     if (!_new_pids.test(pid) && _handler != nullptr) {
 
+        // Deliver pending MPE packets first to preserve the delivery order.
+        flushMPEBatch();
+
         // Remember we signalled this PID.
         _new_pids.set(pid);
 
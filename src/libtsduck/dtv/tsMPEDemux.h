@@ -37,6 +37,7 @@
 #include "tsSectionDemux.h"
 #include "tsPMT.h"
 #include "tsINT.h"
+#include "tsMPEPacket.h"
 #include "tsMPEHandlerInterface.h"
 
 namespace ts {
@@ -75,6 +76,7 @@ namespace ts {
 
         // Inherited methods from AbstractDemux.
         virtual void feedPacket(const TSPacket& pkt) override;
+        virtual void feedPackets(const TSPacket* pkt, size_t count) override;
         virtual void addPID(PID pid) override;
         virtual void addPIDs(const PIDSet& pids) override;
         virtual void removePID(PID pid) override;
@@ -101,6 +103,9 @@ namespace ts {
         typedef SafePtr<PMT> PMTPtr;
         typedef std::map<uint16_t, PMTPtr> PMTMap;
 
+        // Pool of reusable MPE packets for batch delivery.
+        typedef SafePtr<MPEPacket> MPEPacketPtr;
+
         // We record here all MPE PID's from the IP/MAC Notification Table (INT).
         // In the INT, an MPE PID is defined by a 16-bit service id and an 8-bit component tag.
         // We pack the two values in 32-bit.
@@ -121,6 +126,9 @@ namespace ts {
         // Process the discovery of a new MPE PID.
         void processMPEDiscovery(const PMT& pmt, PID pid);
 
+        // Deliver all pending MPE packets to the application handler.
+        void flushMPEBatch();
+
         // Private members:
         MPEHandlerInterface* _handler;    // Application-defined handler
         SectionDemux         _psi_demux;  // Demux for PSI parsing.
@@ -128,5 +136,8 @@ namespace ts {
         PMTMap               _pmts;       // Map of all PMT's in the TS.
         PIDSet               _new_pids;   // New MPE PID's which where signalled to the application.
         std::set<uint32_t>   _int_tags;   // Set of service_id / component_tag from the INT.
+        std::vector<MPEPacketPtr> _mpe_pool;   // Pool of reusable MPE packets.
+        size_t                    _mpe_count;  // Number of pending MPE packets in the pool.
+        PID                       _mpe_pid;    // PID of the pending MPE packets.
     };
 }
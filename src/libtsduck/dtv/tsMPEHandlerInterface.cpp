@@ -30,6 +30,13 @@
 #include "tsMPEHandlerInterface.h"
 TSDUCK_SOURCE;
 
+void ts::MPEHandlerInterface::handleMPEBatch(MPEDemux& demux, const MPEPacket* const* mpe, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        handleMPEPacket(demux, *mpe[i]);
+    }
+}
+
 ts::MPEHandlerInterface::~MPEHandlerInterface()
 {
 }
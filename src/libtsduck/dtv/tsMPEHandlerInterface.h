@@ -66,6 +66,19 @@ namespace ts {
         //!
         virtual void handleMPEPacket(MPEDemux& demux, const MPEPacket& mpe) = 0;
 
+        //!
+        //! This hook is invoked when a batch of MPE packets is available.
+        //! The default implementation invokes handleMPEPacket() once per packet.
+        //! Applications which can process datagrams in bulk (forwarding them
+        //! with one system call per batch for instance) should override it.
+        //! The MPE packets are owned by the demux and are reused after the
+        //! hook returns; keep copies of the packets which must be retained.
+        //! @param [in,out] demux A reference to the MPE demux.
+        //! @param [in] mpe Address of an array of pointers to MPE packets.
+        //! @param [in] count Number of MPE packets in the batch.
+        //!
+        virtual void handleMPEBatch(MPEDemux& demux, const MPEPacket* const* mpe, size_t count);
+
         //!
         //! Virtual destructor.
         //!
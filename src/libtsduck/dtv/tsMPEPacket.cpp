@@ -47,7 +47,10 @@ ts::MPEPacket::MPEPacket() :
     _is_valid(false),
     _source_pid(PID_NULL),
     _dest_mac(),
-    _datagram()
+    _datagram(),
+    _view_buffer(),
+    _view_data(nullptr),
+    _view_size(0)
 {
 }
 
@@ -55,15 +58,23 @@ ts::MPEPacket::MPEPacket(const MPEPacket& other, CopyShare mode) :
     _is_valid(other._is_valid),
     _source_pid(other._source_pid),
     _dest_mac(other._dest_mac),
-    _datagram()
+    _datagram(),
+    _view_buffer(),
+    _view_data(nullptr),
+    _view_size(0)
 {
     switch (mode) {
         case SHARE:
+            // When the other instance is a view, this instance becomes
+            // another view into the same external buffer.
             _datagram = other._datagram;
+            _view_buffer = other._view_buffer;
+            _view_data = other._view_data;
+            _view_size = other._view_size;
             break;
         case COPY:
             if (other._is_valid) {
-                _datagram = new ByteBlock(*other._datagram);
+                _datagram = new ByteBlock(other.dgData(), other.dgSize());
             }
             break;
         default:
@@ -76,7 +87,10 @@ ts::MPEPacket::MPEPacket(MPEPacket&& other) noexcept :
     _is_valid(other._is_valid),
     _source_pid(other._source_pid),
     _dest_mac(other._dest_mac),
-    _datagram(std::move(other._datagram))
+    _datagram(std::move(other._datagram)),
+    _view_buffer(std::move(other._view_buffer)),
+    _view_data(other._view_data),
+    _view_size(other._view_size)
 {
 }
 
@@ -84,7 +98,10 @@ ts::MPEPacket::MPEPacket(ByteBlockPtr datagram, CopyShare mode, const MACAddress
     _is_valid(!datagram.isNull() && FindUDP(datagram->data(), datagram->size())),
     _source_pid(pid),
     _dest_mac(mac),
-    _datagram()
+    _datagram(),
+    _view_buffer(),
+    _view_data(nullptr),
+    _view_size(0)
 {
     if (_is_valid) {
         switch (mode) {
@@ -114,15 +131,32 @@ ts::MPEPacket::MPEPacket(const Section& section) :
 
 bool ts::MPEPacket::findUDP(const uint8_t** udpHeader, const uint8_t** udpAddress, size_t* udpSize) const
 {
-    return _is_valid && FindUDP(_datagram->data(), _datagram->size(), udpHeader, udpAddress, udpSize);
+    return _is_valid && FindUDP(dgData(), dgSize(), udpHeader, udpAddress, udpSize);
 }
 
 bool ts::MPEPacket::findUDP(uint8_t** udpHeader, uint8_t** udpAddress, size_t* udpSize)
 {
+    // The returned pointers are writeable, get a private copy of a view.
+    materialize();
     return _is_valid && FindUDP(_datagram->data(), _datagram->size(), const_cast<const uint8_t**>(udpHeader), const_cast<const uint8_t**>(udpAddress), udpSize);
 }
 
 
+//----------------------------------------------------------------------------
+// Duplicate a referenced datagram into a private buffer (view mode only).
+//----------------------------------------------------------------------------
+
+void ts::MPEPacket::materialize()
+{
+    if (_datagram.isNull() && _view_data != nullptr) {
+        _datagram = new ByteBlock(_view_data, _view_size);
+        _view_buffer.clear();
+        _view_data = nullptr;
+        _view_size = 0;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Locate UDP payload and size in a datagram.
 //----------------------------------------------------------------------------
@@ -176,6 +210,9 @@ void ts::MPEPacket::clear()
     _source_pid = PID_NULL;
     _dest_mac.clear();
     _datagram.clear();
+    _view_buffer.clear();
+    _view_data = nullptr;
+    _view_size = 0;
 }
 
 
@@ -190,6 +227,9 @@ ts::MPEPacket& ts::MPEPacket::operator=(const MPEPacket& other)
         _source_pid = other._source_pid;
         _dest_mac = other._dest_mac;
         _datagram = other._datagram;
+        _view_buffer = other._view_buffer;
+        _view_data = other._view_data;
+        _view_size = other._view_size;
     }
     return *this;
 }
@@ -201,6 +241,9 @@ ts::MPEPacket& ts::MPEPacket::operator=(MPEPacket&& other) noexcept
         _source_pid = other._source_pid;
         _dest_mac = other._dest_mac;
         _datagram = std::move(other._datagram);
+        _view_buffer = std::move(other._view_buffer);
+        _view_data = other._view_data;
+        _view_size = other._view_size;
     }
     return *this;
 }
@@ -211,25 +254,35 @@ ts::MPEPacket& ts::MPEPacket::copy(const MPEPacket& other)
         _is_valid = other._is_valid;
         _source_pid = other._source_pid;
         _dest_mac = other._dest_mac;
-        _datagram = other._is_valid ? new ByteBlock(*other._datagram) : nullptr;
+        _datagram = other._is_valid ? new ByteBlock(other.dgData(), other.dgSize()) : nullptr;
+        _view_buffer.clear();
+        _view_data = nullptr;
+        _view_size = 0;
     }
     return *this;
 }
 
 
 //----------------------------------------------------------------------------
-// Copy content from a DSM-CC MPE section.
+// Analyze a DSM-CC MPE section, locate the datagram inside the section.
 // See ETSI EN 301 192, section 7.1.
 //----------------------------------------------------------------------------
 
-ts::MPEPacket& ts::MPEPacket::copy(const Section& section)
+bool ts::MPEPacket::analyzeSection(const Section& section, const uint8_t*& data, size_t& size)
 {
-    // Clear previous content.
-    clear();
+    // Clear previous content but keep the allocated datagram buffer.
+    // When this object is reused for successive sections (as done by the
+    // MPE demux), the buffer can be recycled without reallocation.
+    _is_valid = false;
+    _source_pid = PID_NULL;
+    _dest_mac.clear();
+    _view_buffer.clear();
+    _view_data = nullptr;
+    _view_size = 0;
 
     // Locate the section content, including header.
-    const uint8_t* data = section.content();
-    size_t size = section.size();
+    data = section.content();
+    size = section.size();
 
     // We need a DSM-CC private data section.
     // The fixed part of the section is 12 bytes.
@@ -238,7 +291,7 @@ ts::MPEPacket& ts::MPEPacket::copy(const Section& section)
     // We do not support scrambled or LLC/SNAP encapsulated datagrams.
     if (!section.isValid() || section.tableId() != TID_DSMCC_PD || size < 16 || section.version() != 0) {
         // Invalid section for MPE.
-        return *this;
+        return false;
     }
 
     // Get source PID.
@@ -248,9 +301,37 @@ ts::MPEPacket& ts::MPEPacket::copy(const Section& section)
     // The two least significant bytes are in fact the table id extension.
     _dest_mac.setAddress(data[11], data[10], data[9], data[8], data[4], data[3]);
 
-    // Get the datagram from the rest of the section.
-    // Do not include trailing 4 bytes (checksum or CRC32).
-    _datagram = new ByteBlock(data + 12, size - 16);
+    // The datagram is the rest of the section, excluding the 12-byte fixed
+    // part and the trailing 4 bytes (checksum or CRC32).
+    data += 12;
+    size -= 16;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Copy content from a DSM-CC MPE section.
+//----------------------------------------------------------------------------
+
+ts::MPEPacket& ts::MPEPacket::copy(const Section& section)
+{
+    // Analyze the section and locate the datagram inside it.
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    if (!analyzeSection(section, data, size)) {
+        // Invalid section for MPE.
+        return *this;
+    }
+
+    // Get a copy of the datagram.
+    // Reuse the previous buffer when this object holds the only reference
+    // to it, meaning that no one kept the content of the previous datagram.
+    if (!_datagram.isNull() && _datagram.count() == 1) {
+        _datagram->copy(data, size);
+    }
+    else {
+        _datagram = new ByteBlock(data, size);
+    }
 
     // Check that the datagram contains a UDP/IP packet.
     _is_valid = true;
@@ -261,6 +342,36 @@ ts::MPEPacket& ts::MPEPacket::copy(const Section& section)
 }
 
 
+//----------------------------------------------------------------------------
+// Reference content from a DSM-CC MPE section, without copy.
+//----------------------------------------------------------------------------
+
+ts::MPEPacket& ts::MPEPacket::reference(const Section& section)
+{
+    // Analyze the section and locate the datagram inside it.
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    if (!analyzeSection(section, data, size)) {
+        // Invalid section for MPE.
+        return *this;
+    }
+
+    // Point into the section payload, do not copy the datagram. Sharing
+    // the section buffer keeps it alive as long as the view exists. The
+    // owned buffer, if any, is dropped: dgData() uses the view.
+    _datagram.clear();
+    _view_buffer = section.contentPtr();
+    _view_data = data;
+    _view_size = size;
+
+    // Check that the datagram contains a UDP/IP packet.
+    _is_valid = FindUDP(data, size);
+
+    // Finally got an MPE packet.
+    return *this;
+}
+
+
 //----------------------------------------------------------------------------
 // Create a DSM-CC MPE section containing the MPE packet.
 //----------------------------------------------------------------------------
@@ -294,7 +405,7 @@ void ts::MPEPacket::createSection(Section& section) const
     data[7] = 0;
 
     // Append datagram.
-    data.append(*_datagram);
+    data.append(dgData(), dgSize());
 
     // Reserve 4 bytes for the CRC32.
     data.enlarge(4);
@@ -314,6 +425,9 @@ void ts::MPEPacket::createSection(Section& section) const
 
 void ts::MPEPacket::configureUDP(bool force, size_t udpSize)
 {
+    // The datagram is about to be modified, get a private copy of a view.
+    materialize();
+
     if (force || !_is_valid) {
         // Recreate a new datagram.
         const size_t totalSize = IPv4_MIN_HEADER_SIZE + UDP_HEADER_SIZE + udpSize;
@@ -355,9 +469,9 @@ ts::IPAddress ts::MPEPacket::sourceIPAddress() const
 {
     IPAddress addr;
     if (_is_valid) {
-        assert(!_datagram.isNull());
-        assert(_datagram->size() >= IPv4_MIN_HEADER_SIZE);
-        addr.setAddress(GetUInt32(_datagram->data() +  IPv4_SRC_ADDR_OFFSET));
+        assert(dgData() != nullptr);
+        assert(dgSize() >= IPv4_MIN_HEADER_SIZE);
+        addr.setAddress(GetUInt32(dgData() + IPv4_SRC_ADDR_OFFSET));
     }
     return addr;
 }
@@ -385,9 +499,9 @@ ts::IPAddress ts::MPEPacket::destinationIPAddress() const
 {
     IPAddress addr;
     if (_is_valid) {
-        assert(!_datagram.isNull());
-        assert(_datagram->size() >= IPv4_MIN_HEADER_SIZE);
-        addr.setAddress(GetUInt32(_datagram->data() +  IPv4_DEST_ADDR_OFFSET));
+        assert(dgData() != nullptr);
+        assert(dgSize() >= IPv4_MIN_HEADER_SIZE);
+        addr.setAddress(GetUInt32(dgData() + IPv4_DEST_ADDR_OFFSET));
     }
     return addr;
 }
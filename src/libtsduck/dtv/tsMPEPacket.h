@@ -127,6 +127,19 @@ namespace ts {
         //!
         MPEPacket& copy(const Section& section);
 
+        //!
+        //! Reference content from a DSM-CC MPE section, without copy.
+        //! Unlike copy(), the datagram is not duplicated. This object becomes
+        //! a read-only view into the section payload. The section buffer is
+        //! shared and remains alive as long as this object, or any copy of
+        //! it, references it. Invoking any modification method on this object
+        //! first duplicates the datagram into a private buffer, after which
+        //! the object no longer depends on the section buffer.
+        //! @param [in] section A binary DSM-CC MPE section.
+        //! @return A reference to this object.
+        //!
+        MPEPacket& reference(const Section& section);
+
         //!
         //! Create a DSM-CC MPE section containing the MPE packet.
         //! @param [out] section A binary DSM-CC MPE section to create.
@@ -255,13 +268,13 @@ namespace ts {
         //! @return Address of the binary content of the complete network datagram.
         //! May be invalidated after modification in section.
         //!
-        const uint8_t* datagram() const { return _is_valid && !_datagram.isNull() ? _datagram->data() : nullptr; }
+        const uint8_t* datagram() const { return _is_valid ? dgData() : nullptr; }
 
         //!
         //! Size of the binary content of the complete network datagram.
         //! @return Size of the binary content of the complete network datagram.
         //!
-        size_t datagramSize() const { return _is_valid && !_datagram.isNull() ? _datagram->size() : 0; }
+        size_t datagramSize() const { return _is_valid ? dgSize() : 0; }
 
         //!
         //! Replace the binary content of the UDP message.
@@ -274,10 +287,26 @@ namespace ts {
 
     private:
         // Private fields
-        bool         _is_valid;    // A valid datagram is present.
-        PID          _source_pid;  // Source PID (informational).
-        MACAddress   _dest_mac;    // Destination MAC address (in DSM-CC section).
-        ByteBlockPtr _datagram;    // Full binary content of the datagram.
+        bool           _is_valid;     // A valid datagram is present.
+        PID            _source_pid;   // Source PID (informational).
+        MACAddress     _dest_mac;     // Destination MAC address (in DSM-CC section).
+        ByteBlockPtr   _datagram;     // Full binary content of the datagram (owned mode).
+        ByteBlockPtr   _view_buffer;  // Shared section buffer (view mode, see reference()).
+        const uint8_t* _view_data;    // Address of the datagram inside the view buffer.
+        size_t         _view_size;    // Size of the datagram in view mode.
+
+        // Address and size of the datagram, in owned or view mode.
+        const uint8_t* dgData() const { return _datagram.isNull() ? _view_data : _datagram->data(); }
+        size_t dgSize() const { return _datagram.isNull() ? _view_size : _datagram->size(); }
+
+        // Analyze a DSM-CC MPE section, fill the packet fields other than
+        // the datagram. Return the address and size of the datagram in the
+        // section or false when the section is not a valid MPE section.
+        bool analyzeSection(const Section& section, const uint8_t*& data, size_t& size);
+
+        // In view mode, duplicate the referenced datagram into a private
+        // buffer. Must be called before modifying the datagram.
+        void materialize();
 
         // Locate UDP payload and size in a datagram.
         // Output parameters are optional. Return false on error.
@@ -31,6 +31,7 @@
 #include "tsMPEG.h"
 #include "tsSysUtils.h"
 #include "tsFatal.h"
+#include "tsGuard.h"
 #include "tsCerrReport.h"
 #include "tsTablesFactory.h"
 TSDUCK_SOURCE;
@@ -327,6 +328,7 @@ ts::Names::Names(const UString& fileName, bool mergeExtensions) :
     _log(CERR),
     _configFile(SearchConfigurationFile(fileName)),
     _configErrors(0),
+    _lock(),
     _sections()
 {
     // Locate the configuration file.
@@ -399,8 +401,8 @@ void ts::Names::loadFile(const UString& fileName)
                 _sections.insert(std::make_pair(line, section));
             }
         }
-        else if (!decodeDefinition(line, section)) {
-            // Invalid line.
+        else if (section == nullptr) {
+            // Definition line before the first section.
             _log.error(u"%s: invalid line %d: %s", {fileName, lineNumber, line});
             if (++_configErrors >= 20) {
                 // Give up after that number of errors
@@ -408,6 +410,10 @@ void ts::Names::loadFile(const UString& fileName)
                 break;
             }
         }
+        else {
+            // Definition line, keep it for decoding on first query of the section.
+            section->rawLines.push_back(RawLine(fileName, lineNumber, line));
+        }
     }
     strm.close();
 }
@@ -417,7 +423,7 @@ void ts::Names::loadFile(const UString& fileName)
 // Decode a line as "first[-last] = name". Return true on success.
 //----------------------------------------------------------------------------
 
-bool ts::Names::decodeDefinition(const UString& line, ConfigSection* section)
+bool ts::Names::decodeDefinition(const UString& line, ConfigSection* section) const
 {
     // Check the presence of the '=' and in a valid section.
     const size_t equal = line.find(UChar('='));
@@ -465,6 +471,34 @@ bool ts::Names::decodeDefinition(const UString& line, ConfigSection* section)
 }
 
 
+//----------------------------------------------------------------------------
+// Decode all pending definition lines of a section, if any.
+//----------------------------------------------------------------------------
+
+void ts::Names::demandSection(ConfigSection* section) const
+{
+    // Fast path: once a section is decoded, readers only pay one atomic load
+    // and never serialize. Concurrent demux threads can resolve names freely.
+    if (section == nullptr || section->decoded.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // Slow path: serialize the first queries of a section and recheck.
+    Guard lock(_lock);
+    if (!section->decoded.load(std::memory_order_relaxed)) {
+        for (std::vector<RawLine>::const_iterator it = section->rawLines.begin(); it != section->rawLines.end(); ++it) {
+            if (!decodeDefinition(it->text, section)) {
+                _log.error(u"%s: invalid line %d: %s", {it->file, it->number, it->text});
+                ++_configErrors;
+            }
+        }
+        section->rawLines.clear();
+        // Publish the decoded entries to lock-free readers.
+        section->decoded.store(true, std::memory_order_release);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Destructor: free all resources.
 //----------------------------------------------------------------------------
@@ -494,9 +528,18 @@ ts::Names::ConfigEntry::ConfigEntry(Value l, const UString& n) :
 // Configuration section.
 //----------------------------------------------------------------------------
 
+ts::Names::RawLine::RawLine(const UString& f, size_t n, const UString& t) :
+    file(f),
+    number(n),
+    text(t)
+{
+}
+
 ts::Names::ConfigSection::ConfigSection() :
+    decoded(false),
     bits(0),
-    entries()
+    entries(),
+    rawLines()
 {
 }
 
@@ -664,7 +707,11 @@ bool ts::Names::nameExists(const UString& sectionName, Value value) const
 {
     // Get the section, normalize the section name.
     ConfigSectionMap::const_iterator it = _sections.find(sectionName.toTrimmed().toLower());
-    return it != _sections.end() && !it->second->getName(value).empty();
+    if (it == _sections.end()) {
+        return false;
+    }
+    demandSection(it->second);
+    return !it->second->getName(value).empty();
 }
 
 
@@ -676,7 +723,8 @@ ts::UString ts::Names::nameFromSection(const UString& sectionName, Value value,
 {
     // Get the section, normalize the section name.
     ConfigSectionMap::const_iterator it = _sections.find(sectionName.toTrimmed().toLower());
-    const ConfigSection* section = it == _sections.end() ? nullptr : it->second;
+    ConfigSection* const section = it == _sections.end() ? nullptr : it->second;
+    demandSection(section);
 
     if (section == nullptr) {
         // Non-existent section, no name.
@@ -696,7 +744,8 @@ ts::UString ts::Names::nameFromSectionWithFallback(const UString& sectionName, V
 {
     // Get the section, normalize the section name.
     ConfigSectionMap::const_iterator it = _sections.find(sectionName.toTrimmed().toLower());
-    const ConfigSection* section = it == _sections.end() ? nullptr : it->second;
+    ConfigSection* const section = it == _sections.end() ? nullptr : it->second;
+    demandSection(section);
 
     if (section == nullptr) {
         // Non-existent section, no name.
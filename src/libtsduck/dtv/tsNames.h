@@ -39,6 +39,7 @@
 #include "tsMPEG.h"
 #include "tsReport.h"
 #include "tsSingletonManager.h"
+#include "tsMutex.h"
 
 namespace ts {
     //!
@@ -446,13 +447,30 @@ namespace ts {
         // Map of configuration entries, indexed by first value of the range.
         typedef std::map<Value, ConfigEntry*> ConfigEntryMap;
 
+        // One definition line of a section, pending decoding.
+        class RawLine
+        {
+        public:
+            UString file;    // Source file name (for error messages).
+            size_t  number;  // Line number in the source file.
+            UString text;    // Line content.
+
+            RawLine(const UString& f = UString(), size_t n = 0, const UString& t = UString());
+        };
+
         // Description of a configuration section.
         // The name of the section is the key in a map.
+        // The definition lines of a section are collected at load time but
+        // decoded only when the section is first queried. Loading the names
+        // files consequently costs one pass of line splitting only, the
+        // decoding cost is paid per section, on demand.
         class ConfigSection
         {
         public:
-            size_t          bits;     // Number of significant bits in values of the type.
-            ConfigEntryMap  entries;  // All entries, indexed by names.
+            std::atomic<bool>    decoded;   // The definition lines have been decoded.
+            size_t               bits;      // Number of significant bits in values of the type.
+            ConfigEntryMap       entries;   // All entries, indexed by names.
+            std::vector<RawLine> rawLines;  // Definition lines, pending decoding.
 
             ConfigSection();
             ~ConfigSection();
@@ -471,7 +489,10 @@ namespace ts {
         typedef std::map<UString, ConfigSection*> ConfigSectionMap;
 
         // Decode a line as "first[-last] = name". Return true on success, false on error.
-        bool decodeDefinition(const UString& line, ConfigSection* section);
+        bool decodeDefinition(const UString& line, ConfigSection* section) const;
+
+        // Decode all pending definition lines of a section, if any.
+        void demandSection(ConfigSection* section) const;
 
         // Compute a number of hexa digits.
         static int HexaDigits(size_t bits);
@@ -483,9 +504,13 @@ namespace ts {
         void loadFile(const UString& fileName);
 
         // Names private fields.
+        // The map of sections is built once at load time and then read-only.
+        // Only the demand-decoding of a section mutates shared state; it is
+        // serialized by the mutex while decoded readers stay lock-free.
         Report&          _log;           // Error logger.
         const UString    _configFile;    // Configuration file path.
-        size_t           _configErrors;  // Number of errors in configuration file.
+        mutable size_t   _configErrors;  // Number of errors in configuration file.
+        mutable Mutex    _lock;          // Serialize the demand-decoding of sections.
         ConfigSectionMap _sections;      // Configuration sections.
     };
 
@@ -0,0 +1,83 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsNullPacketRun.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The preformed run, page-aligned, filled with null packets on first use.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    struct NullRun
+    {
+        alignas(4096) uint8_t data[ts::NULL_PACKET_RUN_SIZE * ts::PKT_SIZE];
+        NullRun()
+        {
+            for (size_t i = 0; i < sizeof(data); i += ts::PKT_SIZE) {
+                ::memcpy(data + i, ts::NullPacket.b, ts::PKT_SIZE);
+            }
+        }
+    };
+
+    const NullRun& TheNullRun()
+    {
+        // Thread-safe lazy initialization (C++11 static).
+        static const NullRun run;
+        return run;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the address of the preformed run of null packets.
+//----------------------------------------------------------------------------
+
+const ts::TSPacket* ts::NullPacketRun()
+{
+    return reinterpret_cast<const TSPacket*>(TheNullRun().data);
+}
+
+
+//----------------------------------------------------------------------------
+// Fill a buffer with null packets.
+//----------------------------------------------------------------------------
+
+void ts::FillNullPackets(TSPacket* buffer, size_t packet_count)
+{
+    const uint8_t* const run = TheNullRun().data;
+    while (packet_count > 0) {
+        const size_t chunk = std::min(packet_count, NULL_PACKET_RUN_SIZE);
+        ::memcpy(buffer->b, run, chunk * PKT_SIZE);
+        buffer += chunk;
+        packet_count -= chunk;
+    }
+}
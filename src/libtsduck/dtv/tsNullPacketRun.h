@@ -0,0 +1,67 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Preformed run of null packets for fast stuffing generation.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+
+namespace ts {
+    //!
+    //! Number of TS packets in the preformed run of null packets.
+    //! The run is a whole number of memory pages (188 x 1024 bytes is
+    //! exactly 47 pages of 4 kB).
+    //!
+    const size_t NULL_PACKET_RUN_SIZE = 1024;
+
+    //!
+    //! Get the address of a preformed run of null packets.
+    //! The run contains @link NULL_PACKET_RUN_SIZE @endlink contiguous
+    //! null packets in a page-aligned read-only buffer. Since the null PID
+    //! ignores continuity counters, the packets are all identical and any
+    //! range of the run can be directly written to an output device or
+    //! copied into a packet buffer, without per-packet generation.
+    //! @return Address of the first packet of the run.
+    //! @ingroup mpeg
+    //!
+    TSDUCKDLL const TSPacket* NullPacketRun();
+
+    //!
+    //! Fill a buffer with null packets.
+    //! The buffer is filled by large copies of the preformed run, not
+    //! packet by packet.
+    //! @param [out] buffer Address of the packet buffer to fill.
+    //! @param [in] packet_count Number of packets to fill in the buffer.
+    //! @ingroup mpeg
+    //!
+    TSDUCKDLL void FillNullPackets(TSPacket* buffer, size_t packet_count);
+}
@@ -76,6 +76,12 @@ namespace ts {
     private:
         // Hide these methods
         void setStuffingPolicy(StuffingPolicy) = delete;
-        bool getNextPacket(TSPacket&) = delete;
+
+        // A virtual method cannot be deleted in a subclass, make it private.
+        // One-shot packetizers use getPackets() only.
+        virtual bool getNextPacket(TSPacket& packet) override
+        {
+            return CyclingPacketizer::getNextPacket(packet);
+        }
     };
 }
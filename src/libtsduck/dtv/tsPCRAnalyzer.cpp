@@ -53,13 +53,15 @@ ts::PCRAnalyzer::PCRAnalyzer(size_t min_pid, size_t min_pcr) :
     _ts_bitrate_188(0),
     _ts_bitrate_204(0),
     _ts_bitrate_cnt(0),
-    _inst_ts_bitrate_188(0),
-    _inst_ts_bitrate_204(0),
+    _ts_rate_188(),
+    _ts_rate_204(),
     _completed_pids(0),
     _pcr_pids(0),
     _discontinuities(0),
     _pid(),
-    _packet_pcr_index_map()
+    _pcr_window(),
+    _pcr_win_first(0),
+    _pcr_win_count(0)
 {
     TS_ZERO(_pid);
 }
@@ -148,10 +150,12 @@ void ts::PCRAnalyzer::reset()
     _ts_bitrate_188 = 0;
     _ts_bitrate_204 = 0;
     _ts_bitrate_cnt = 0;
+    _ts_rate_188.clear();
+    _ts_rate_204.clear();
     _completed_pids = 0;
     _pcr_pids = 0;
-    _inst_ts_bitrate_188 = 0;
-    _inst_ts_bitrate_204 = 0;
+    _pcr_win_first = 0;
+    _pcr_win_count = 0;
 
     for (size_t i = 0; i < PID_MAX; ++i) {
         if (_pid[i] != nullptr) {
@@ -159,8 +163,6 @@ void ts::PCRAnalyzer::reset()
             _pid[i] = nullptr;
         }
     }
-
-    _packet_pcr_index_map.clear();
 }
 
 
@@ -200,7 +202,8 @@ void ts::PCRAnalyzer::processDiscontinuity()
             _pid[i]->last_pcr_value = INVALID_PCR;
         }
     }
-    _packet_pcr_index_map.clear();
+    _pcr_win_first = 0;
+    _pcr_win_count = 0;
 }
 
 
@@ -211,22 +214,43 @@ void ts::PCRAnalyzer::processDiscontinuity()
 
 ts::BitRate ts::PCRAnalyzer::bitrate188() const
 {
-    return _ts_bitrate_cnt == 0 ? 0 : BitRate(_ts_bitrate_188 / _ts_bitrate_cnt);
+    // Division-free, the reciprocal was precomputed on the last PCR.
+    return BitRate(_ts_rate_188.toInt());
 }
 
 ts::BitRate ts::PCRAnalyzer::bitrate204() const
 {
-    return _ts_bitrate_cnt == 0 ? 0 : BitRate(_ts_bitrate_204 / _ts_bitrate_cnt);
+    return BitRate(_ts_rate_204.toInt());
 }
 
 ts::BitRate ts::PCRAnalyzer::instantaneousBitrate188() const
 {
-    return BitRate(_inst_ts_bitrate_188);
+    // Evaluated on demand from the boundaries of the sliding window.
+    if (_pcr_win_count < 2) {
+        return 0;
+    }
+    const PCRSample& first(_pcr_window[_pcr_win_first]);
+    const PCRSample& last(_pcr_window[(_pcr_win_first + _pcr_win_count - 1) % PCR_WINDOW_SIZE]);
+    const uint64_t diff_values = _use_dts ?
+        DiffPTS(first.pcr_dts, last.pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
+        DiffPCR(first.pcr_dts, last.pcr_dts);
+    return diff_values == 0 ? 0 :
+        BitRate(((last.packet_index - first.packet_index) * SYSTEM_CLOCK_FREQ * PKT_SIZE * 8) / diff_values);
 }
 
 ts::BitRate ts::PCRAnalyzer::instantaneousBitrate204() const
 {
-    return BitRate(_inst_ts_bitrate_204);
+    // Evaluated on demand from the boundaries of the sliding window.
+    if (_pcr_win_count < 2) {
+        return 0;
+    }
+    const PCRSample& first(_pcr_window[_pcr_win_first]);
+    const PCRSample& last(_pcr_window[(_pcr_win_first + _pcr_win_count - 1) % PCR_WINDOW_SIZE]);
+    const uint64_t diff_values = _use_dts ?
+        DiffPTS(first.pcr_dts, last.pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
+        DiffPCR(first.pcr_dts, last.pcr_dts);
+    return diff_values == 0 ? 0 :
+        BitRate(((last.packet_index - first.packet_index) * SYSTEM_CLOCK_FREQ * PKT_RS_SIZE * 8) / diff_values);
 }
 
 
@@ -292,8 +316,13 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
         return _bitrate_valid;
     }
 
+    // Parse the packet header once instead of re-walking the adaptation
+    // field in each individual accessor.
+    TSPacket::Header header;
+    pkt.parseHeader(header);
+
     // Find PID context
-    const PID pid = pkt.getPID();
+    const PID pid = header.pid;
     assert(pid < PID_MAX);
 
     PIDAnalysis* ps = _pid[pid];
@@ -313,17 +342,17 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
     // the PCR calculation across this packet is not valid.
     if (!_ignore_errors) {
         bool broken_rate = false;
-        uint8_t continuity_cnt = pkt.getCC();
+        uint8_t continuity_cnt = header.cc;
 
         if (ps->ts_pkt_cnt == 1) {
             // First packet on this PID, initialize continuity
             ps->cur_continuity = continuity_cnt;
         }
-        else if (pkt.getDiscontinuityIndicator()) {
+        else if ((header.af_flags & 0x80) != 0) {
             // Expected discontinuity
             broken_rate = true;
         }
-        else if (pkt.hasPayload()) {
+        else if (header.payload) {
             // Packet has payload. Compute next continuity counter.
             uint8_t next_cont((ps->cur_continuity + 1) & 0x0F);
             // The countinuity counter must be either identical to previous one
@@ -343,10 +372,10 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
     }
 
     // Process PCR (or DTS)
-    if ((_use_dts && pkt.hasDTS()) || (!_use_dts && pkt.hasPCR())) {
+    if ((_use_dts && pkt.hasDTS()) || (!_use_dts && (header.af_flags & 0x10) != 0)) {
 
         // Get PCR value (or DTS)
-        const uint64_t pcr_dts = _use_dts ? pkt.getDTS() : pkt.getPCR();
+        const uint64_t pcr_dts = _use_dts ? pkt.getDTS() : header.pcr;
 
         // If last PCR/DTS valid, compute transport rate between the two
         if (ps->last_pcr_value != INVALID_PCR && ps->last_pcr_value != pcr_dts) {
@@ -361,24 +390,6 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
             uint64_t ts_bitrate_204 = diff_values == 0 ? 0 :
                 ((_ts_pkt_cnt - ps->last_pcr_packet) * SYSTEM_CLOCK_FREQ * PKT_RS_SIZE * 8) / diff_values;
 
-            // Clear out values older than 1 second from _packet_pcr_index_map.
-            // Note that this is a map that covers PCR/DTS packets across all PIDs
-            // as long as the clocks used to generate the PCR/DTS values for different
-            // programs is the same clock, there should be no issue, but if the PCR/DTS values
-            // across the two programs are wildly different, then the following approach won't work.
-            while (!_packet_pcr_index_map.empty()) {
-                const uint64_t earliestPCR_DTS = _packet_pcr_index_map.begin()->first;
-                diff_values = _use_dts ?
-                    DiffPTS(earliestPCR_DTS, pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
-                    DiffPCR(earliestPCR_DTS, pcr_dts);
-                if (diff_values > SYSTEM_CLOCK_FREQ) {
-                    _packet_pcr_index_map.erase(_packet_pcr_index_map.begin());
-                }
-                else {
-                    break;
-                }
-            }
-
             // Per-PID statistics:
             ps->ts_bitrate_188 += ts_bitrate_188;
             ps->ts_bitrate_204 += ts_bitrate_204;
@@ -393,17 +404,11 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
             _ts_bitrate_204 += ts_bitrate_204;
             _ts_bitrate_cnt++;
 
-            // Transport stream instantaneous statistics.
-            // For instantaneous bit rates, these are the actual bit rates, and it doesn't use the "count" approach.
-            if (!_packet_pcr_index_map.empty()) {
-                diff_values = _use_dts ?
-                    DiffPTS(_packet_pcr_index_map.begin()->first, pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
-                    DiffPCR(_packet_pcr_index_map.begin()->first, pcr_dts);
-                _inst_ts_bitrate_188 = diff_values == 0 ? 0 :
-                    ((_ts_pkt_cnt - _packet_pcr_index_map.begin()->second) * SYSTEM_CLOCK_FREQ * PKT_SIZE * 8) / diff_values;
-                _inst_ts_bitrate_204 = diff_values == 0 ? 0 :
-                    ((_ts_pkt_cnt - _packet_pcr_index_map.begin()->second) * SYSTEM_CLOCK_FREQ * PKT_RS_SIZE * 8) / diff_values;
-            }
+            // Update the average bitrates as reciprocal rates. The accessors
+            // are typically polled on every packet while the sums above
+            // change on PCR's only, so the division is performed here.
+            _ts_rate_188.set(int64_t(_ts_bitrate_188), int64_t(_ts_bitrate_cnt));
+            _ts_rate_204.set(int64_t(_ts_bitrate_204), int64_t(_ts_bitrate_cnt));
 
             // Check if we got enough values for this PID
             if (ps->ts_bitrate_cnt == _min_pcr) {
@@ -417,14 +422,37 @@ bool ts::PCRAnalyzer::feedPacket(const TSPacket& pkt)
             ps->last_pcr_value = pcr_dts;
             ps->last_pcr_packet = _ts_pkt_cnt;
 
-            // Also add PCR (or DTS)/packet index combo to map for use in instantaneous bit rate calculations.
-            _packet_pcr_index_map[pcr_dts] = _ts_pkt_cnt;
+            // Trim samples older than one second from the sliding window.
+            // Note that the window covers PCR/DTS values across all PIDs. As
+            // long as the clocks used to generate them derive from the same
+            // reference, there is no issue, but if the values across programs
+            // are wildly different, then this approach won't work. This loop
+            // is amortized O(1) per sample and uses subtractions only.
+            while (_pcr_win_count > 0) {
+                const uint64_t oldest = _pcr_window[_pcr_win_first].pcr_dts;
+                const uint64_t age = _use_dts ?
+                    DiffPTS(oldest, pcr_dts) * SYSTEM_CLOCK_SUBFACTOR :
+                    DiffPCR(oldest, pcr_dts);
+                if (age > SYSTEM_CLOCK_FREQ) {
+                    _pcr_win_first = (_pcr_win_first + 1) % PCR_WINDOW_SIZE;
+                    _pcr_win_count--;
+                }
+                else {
+                    break;
+                }
+            }
 
-            // Make sure that some crazy TS does not accumulate thousands of PCR values in the same second range.
-            while (_packet_pcr_index_map.size() > FOOLPROOF_MAP_LIMIT) {
-                // Erase older entries.
-                _packet_pcr_index_map.erase(_packet_pcr_index_map.begin());
+            // Add the sample at the end of the window. When some crazy TS
+            // accumulates more samples than the ring size in the same second
+            // range, the oldest one is overwritten.
+            if (_pcr_win_count == PCR_WINDOW_SIZE) {
+                _pcr_win_first = (_pcr_win_first + 1) % PCR_WINDOW_SIZE;
+                _pcr_win_count--;
             }
+            PCRSample& sample(_pcr_window[(_pcr_win_first + _pcr_win_count) % PCR_WINDOW_SIZE]);
+            sample.pcr_dts = pcr_dts;
+            sample.packet_index = _ts_pkt_cnt;
+            _pcr_win_count++;
         }
     }
 
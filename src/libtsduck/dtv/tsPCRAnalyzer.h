@@ -35,6 +35,7 @@
 #pragma once
 #include "tsMPEG.h"
 #include "tsTSPacket.h"
+#include "tsRationalRate.h"
 #include "tsStringifyInterface.h"
 
 namespace ts {
@@ -216,6 +217,13 @@ namespace ts {
             uint64_t ts_bitrate_cnt;   // Count of computed TS bitrates
         };
 
+        // One PCR/DTS sample in the sliding window.
+        struct PCRSample
+        {
+            uint64_t pcr_dts;       // PCR/DTS value
+            uint64_t packet_index;  // Index of the packet holding the value
+        };
+
         // Private members:
         bool     _use_dts;             // Use DTS instead of PCR
         bool     _ignore_errors;       // Ignore TS errors such as discontinuities.
@@ -226,13 +234,20 @@ namespace ts {
         uint64_t _ts_bitrate_188;      // Sum of all computed TS bitrates (188-byte)
         uint64_t _ts_bitrate_204;      // Sum of all computed TS bitrates (204-byte)
         uint64_t _ts_bitrate_cnt;      // Count of computed bitrates
-        uint64_t _inst_ts_bitrate_188; // Sum of all computed TS bitrates (188-byte) for last second
-        uint64_t _inst_ts_bitrate_204; // Sum of all computed TS bitrates (204-byte) for last second
+        RationalRate _ts_rate_188;     // Average TS bitrate (188-byte), division precomputed on PCR
+        RationalRate _ts_rate_204;     // Average TS bitrate (204-byte), division precomputed on PCR
         size_t   _completed_pids;      // Number of PIDs with enough PCRs
         size_t   _pcr_pids;            // Number of PIDs with PCRs
         size_t   _discontinuities;     // Number of discontinuities
         PIDAnalysis* _pid[PID_MAX];    // Per-PID stats
-        std::map<uint64_t, uint64_t> _packet_pcr_index_map; // Map of PCR/DTS to packet index across entire TS
-        static constexpr size_t FOOLPROOF_MAP_LIMIT = 1000; // Max number of entries in the PCR map
+
+        // Sliding window of PCR/DTS samples across all PIDs, in arrival order,
+        // kept in a fixed-size ring buffer and trimmed to the last second.
+        // The instantaneous bitrates are evaluated on demand from the window
+        // boundaries, there is no arithmetic on the packet path for them.
+        static constexpr size_t PCR_WINDOW_SIZE = 1000; // Max number of samples in the window
+        PCRSample _pcr_window[PCR_WINDOW_SIZE];         // Ring buffer of samples
+        size_t    _pcr_win_first;                       // Index of the oldest sample in the ring
+        size_t    _pcr_win_count;                       // Number of samples in the ring
     };
 }
@@ -31,6 +31,16 @@
 #include "tsNullReport.h"
 TSDUCK_SOURCE;
 
+namespace {
+    // Process-wide epoch of the wake-up grid, set on first use.
+    // All regulators of the process align their grid on this epoch.
+    const ts::Monotonic& GridEpoch()
+    {
+        static const ts::Monotonic epoch(true);
+        return epoch;
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -44,6 +54,7 @@ ts::PCRRegulator::PCRRegulator(Report* report, int log_level) :
     _opt_burst(0),
     _burst_pkt_cnt(0),
     _wait_min(0),
+    _grid_quantum(0),
     _started(false),
     _pcr_first(0),
     _pcr_last(0),
@@ -181,6 +192,16 @@ bool ts::PCRRegulator::regulate(const TSPacket& pkt)
             Monotonic clock_due(_clock_first);
             clock_due += ns;
 
+            // When a wake-up grid is defined, round the deadline up to the
+            // next process-wide grid tick so that all regulators of the
+            // process wake up together and release their packets in batches.
+            if (_grid_quantum > 0) {
+                const NanoSecond phase = (clock_due - GridEpoch()) % _grid_quantum;
+                if (phase != 0) {
+                    clock_due += _grid_quantum - phase;
+                }
+            }
+
             // Do not wait less than the user-specified minimum.
             if (clock_due - _clock_last >= _wait_min) {
                 // Wait until system time for current PCR.
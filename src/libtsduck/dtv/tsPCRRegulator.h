@@ -94,6 +94,22 @@ namespace ts {
         //!
         void setMinimimWait(NanoSecond ns = DEFAULT_MIN_WAIT_NS);
 
+        //!
+        //! Set the wake-up grid quantum.
+        //! When non-zero, the wait deadlines are aligned on a process-wide
+        //! time grid with this quantum. All regulators of the same process
+        //! which use the same quantum consequently wake up on common ticks
+        //! and release their packets in batches per tick. This consolidates
+        //! timer wake-ups when many regulated streams run in one process,
+        //! at the expense of up to one quantum of release jitter per stream.
+        //! @param [in] quantum Grid quantum in nano-seconds. Zero (the default)
+        //! disables the grid alignment.
+        //!
+        void setWakeupGrid(NanoSecond quantum)
+        {
+            _grid_quantum = quantum;
+        }
+
         //!
         //! Re-initialize state.
         //!
@@ -115,6 +131,7 @@ namespace ts {
         PacketCounter _opt_burst;       // Number of packets to burst at a time
         PacketCounter _burst_pkt_cnt;   // Number of packets in current burst
         NanoSecond    _wait_min;        // Minimum delay between two waits (ns)
+        NanoSecond    _grid_quantum;    // Wake-up grid quantum (ns), zero means no grid
         bool          _started;         // First PCR found, regulation started.
         uint64_t      _pcr_first;       // First PCR value.
         uint64_t      _pcr_last;        // Last PCR value.
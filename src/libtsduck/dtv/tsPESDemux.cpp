@@ -91,6 +91,8 @@ ts::PESDemux::PIDContext::PIDContext() :
     audio(),
     video(),
     avc(),
+    avc_sps(),
+    avc_sps_pending(false),
     ac3(),
     ac3_count(0)
 {
@@ -150,7 +152,17 @@ void ts::PESDemux::getVideoAttributes(PID pid, VideoAttributes& va) const
 void ts::PESDemux::getAVCAttributes(PID pid, AVCAttributes& va) const
 {
     PIDContextMap::const_iterator pci = _pids.find(pid);
-    if (pci == _pids.end() || !pci->second.avc.isValid()) {
+    if (pci == _pids.end()) {
+        va.invalidate();
+        return;
+    }
+    // SPS parsing is deferred when no handler needs the attributes.
+    // Recompute them now if an unparsed SPS is pending. This is a cache
+    // refresh, the object is logically unmodified.
+    if (pci->second.avc_sps_pending) {
+        const_cast<PESDemux*>(this)->updateAVCAttributes(const_cast<PIDContext&>(pci->second), nullptr);
+    }
+    if (!pci->second.avc.isValid()) {
         va.invalidate();
     }
     else {
@@ -194,6 +206,18 @@ void ts::PESDemux::feedPacket(const TSPacket& pkt)
     SuperClass::feedPacket(pkt);
 }
 
+void ts::PESDemux::feedPackets(const TSPacket* pkt, size_t count)
+{
+    // Same processing as feedPacket() but without virtual dispatch per packet.
+    for (size_t i = 0; i < count; ++i) {
+        _section_demux.feedPacket(pkt[i]);
+        if (_pid_filter[pkt[i].getPID()]) {
+            processPacket(pkt[i]);
+        }
+        SuperClass::feedPacket(pkt[i]);
+    }
+}
+
 void ts::PESDemux::processPacket(const TSPacket& pkt)
 {
     // Reject invalid packets
@@ -361,6 +385,19 @@ void ts::PESDemux::handlePESPacket(const PESPacket& packet)
 }
 
 
+//----------------------------------------------------------------------------
+// Recompute the AVC attributes of a PID from its pending SPS NALunit.
+//----------------------------------------------------------------------------
+
+void ts::PESDemux::updateAVCAttributes(PIDContext& pc, const PESPacket* pp)
+{
+    pc.avc_sps_pending = false;
+    if (pc.avc.moreBinaryData(pc.avc_sps.data(), pc.avc_sps.size()) && pp != nullptr && _pes_handler != nullptr) {
+        _pes_handler->handleNewAVCAttributes(*this, *pp, pc.avc);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Process a complete PES packet
 //----------------------------------------------------------------------------
@@ -461,8 +498,9 @@ void ts::PESDemux::processPESPacket(PID pid, PIDContext& pc)
                     _pes_handler->handleAVCAccessUnit(*this, pp, nalunit_type, offset, nalunit_size);
                 }
 
-                // If the NALunit is an SEI, locate it.
-                if (nalunit_type == AVC_AUT_SEI) {
+                // If the NALunit is an SEI, locate it. SEI's are only
+                // reported through the handler, skip them otherwise.
+                if (nalunit_type == AVC_AUT_SEI && _pes_handler != nullptr) {
                     // See H.264 section 7.3.2.3.1, "Supplemental enhancement information message syntax".
                     // Point after nalunit type:
                     const uint8_t* p = pdata + offset + 1;
@@ -494,10 +532,20 @@ void ts::PESDemux::processPESPacket(PID pid, PIDContext& pc)
                     }
                 }
 
-                // Accumulate info from access units to extract video attributes.
-                // If new attributes were found, invoke handler.
-                if (pc.avc.moreBinaryData(pdata + offset, nalunit_size) && _pes_handler != nullptr) {
-                    _pes_handler->handleNewAVCAttributes(*this, pp, pc.avc);
+                // Video attributes are extracted from the SPS ("sequence
+                // parameter set") only. Capture the raw SPS bytes here, the
+                // expensive Exp-Golomb parsing runs only when the SPS bytes
+                // actually changed and only when someone needs the result:
+                // right away when a handler is registered, lazily from
+                // getAVCAttributes() otherwise.
+                if (nalunit_type == AVC_AUT_SEQPARAMS &&
+                    (pc.avc_sps.size() != nalunit_size || ::memcmp(pc.avc_sps.data(), pdata + offset, nalunit_size) != 0))
+                {
+                    pc.avc_sps.copy(pdata + offset, nalunit_size);
+                    pc.avc_sps_pending = true;
+                }
+                if (pc.avc_sps_pending && _pes_handler != nullptr) {
+                    updateAVCAttributes(pc, &pp);
                 }
 
                 // Move to next start code
@@ -71,6 +71,7 @@ namespace ts {
 
         // Inherited methods
         virtual void feedPacket(const TSPacket& pkt) override;
+        virtual void feedPackets(const TSPacket* pkt, size_t count) override;
 
         //!
         //! Replace the PES packet handler.
@@ -149,6 +150,8 @@ namespace ts {
             AudioAttributes audio;       // Current audio attributes
             VideoAttributes video;       // Current video attributes (MPEG-1, MPEG-2)
             AVCAttributes   avc;         // Current AVC attributes
+            ByteBlock       avc_sps;     // Raw SPS NALunit bytes for current or pending AVC attributes
+            bool            avc_sps_pending; // The SPS changed, AVC attributes not yet recomputed
             AC3Attributes   ac3;         // Current AC-3 attributes
             PacketCounter   ac3_count;   // Number of PES packets with contents which looks like AC-3
 
@@ -173,6 +176,10 @@ namespace ts {
         // Process a complete PES packet
         void processPESPacket(PID, PIDContext&);
 
+        // Recompute the AVC attributes of a PID from its pending SPS NALunit.
+        // When pp is not null, the handler is notified of new attributes.
+        void updateAVCAttributes(PIDContext&, const PESPacket* pp);
+
         // Implementation of TableHandlerInterface.
         virtual void handleTable(SectionDemux& demux, const BinaryTable& table) override;
 
@@ -34,6 +34,7 @@
 #include "tsPSILogger.h"
 #include "tsNames.h"
 #include "tsPAT.h"
+#include "tsPMT.h"
 TSDUCK_SOURCE;
 
 #define MIN_CLEAR_PACKETS 100000
@@ -59,6 +60,7 @@ ts::PSILogger::PSILogger(TablesDisplay& display) :
     _abort(false),
     _pat_ok(_cat_only),
     _cat_ok(_clear),
+    _ca_found(false),
     _sdt_ok(_cat_only),
     _bat_ok(false),
     _mgt_ok(false),
@@ -263,11 +265,23 @@ void ts::PSILogger::handleTable(SectionDemux&, const BinaryTable& table)
 
         case TID_NIT_ACT:  // NIT and PMT are processed identically.
         case TID_PMT: {
+            // Look for CA descriptors in the PMT, at program level and at elementary stream level.
+            if (tid == TID_PMT && !_cat_ok && !_ca_found) {
+                const PMT pmt(_duck, table);
+                if (pmt.isValid()) {
+                    _ca_found = pmt.descs.search(DID_CA) < pmt.descs.count();
+                    for (PMT::StreamMap::const_iterator it = pmt.streams.begin(); !_ca_found && it != pmt.streams.end(); ++it) {
+                        _ca_found = it->second.descs.search(DID_CA) < it->second.descs.count();
+                    }
+                }
+            }
             // Stop filtering this PID if we don't need all versions.
             if (!_all_versions) {
                 _demux.removePID(pid);
                 _received_pmt++;
             }
+            // The PAT closure may now be complete, maybe no CAT will ever come.
+            checkCATExpectation();
             _display.displayTable(table);
             strm << std::endl;
             break;
@@ -374,6 +388,27 @@ void ts::PSILogger::handleTable(SectionDemux&, const BinaryTable& table)
 }
 
 
+//----------------------------------------------------------------------------
+// Check if a CAT can still be expected on the stream.
+//----------------------------------------------------------------------------
+
+void ts::PSILogger::checkCATExpectation()
+{
+    // When the PAT and all PMT's are collected without a single CA descriptor
+    // and without a single scrambled packet, the stream is effectively clear
+    // and no CAT will ever come. Stop waiting for one. This is the same
+    // decision as the packet-count timeout in feedPacket() but it is taken
+    // as soon as the PAT closure is complete, typically much earlier.
+    if (!_cat_ok && _pat_ok && _received_pmt >= _expected_pmt && !_ca_found && _scrambled_packets_cnt == 0) {
+        _duck.report().debug(u"PAT closure complete without CA descriptor or scrambled packet, no longer expecting a CAT");
+        _cat_ok = true;
+        if (!_all_versions) {
+            _demux.removePID(PID_CAT);
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // This hook is invoked when a complete section is available.
 // Only used with option --all-sections
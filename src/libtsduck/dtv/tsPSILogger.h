@@ -121,6 +121,7 @@ namespace ts {
         bool             _abort;
         bool             _pat_ok;        // Got a PAT
         bool             _cat_ok;        // Got a CAT or not interested in CAT
+        bool             _ca_found;      // Found a CA descriptor in a PMT
         bool             _sdt_ok;        // Got an SDT
         bool             _bat_ok;        // Got a BAT
         bool             _mgt_ok;        // Got an MGT
@@ -134,6 +135,11 @@ namespace ts {
         // Implementations of TableHandlerInterface and SectionHandlerInterface.
         virtual void handleTable(SectionDemux&, const BinaryTable&) override;
         virtual void handleSection(SectionDemux&, const Section&) override;
+
+        // When the PAT closure (PAT and all PMT's) is complete without any hint of
+        // scrambling, stop expecting a CAT. This is a completion-driven decision,
+        // much faster than the fixed packet-count timeout on short captures.
+        void checkCATExpectation();
     };
 
     //!
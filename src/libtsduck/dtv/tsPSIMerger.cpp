@@ -61,7 +61,8 @@ ts::PSIMerger::PSIMerger(DuckContext& duck, Options options, Report& report) :
     _main_bats(),
     _merge_bats(),
     _eits(),
-    _max_eits(128) // hard-coded for now
+    _max_eits(128), // hard-coded for now
+    _eit_cache()
 {
     reset();
 }
@@ -171,6 +172,7 @@ void ts::PSIMerger::reset(Options options)
     _main_bats.clear();
     _merge_bats.clear();
     _eits.clear();
+    _eit_cache.clear();
 }
 
 
@@ -402,21 +404,33 @@ void ts::PSIMerger::handleSection(SectionDemux& demux, const Section& section)
 
     // Enqueue EIT's from main and merged stream.
     if (is_eit && (_options & MERGE_EIT) != 0) {
-
-        // Create a copy of the section object (shared section data).
-        const SectionPtr sp(new Section(section, SHARE));
-        CheckNonNull(sp.pointer());
-
         if (demux.demuxId() != DEMUX_MERGE_EIT || !is_actual) {
-            // Not an EIT-Actual from the merge stream, pass section without modification.
+            // Not an EIT-Actual from the merge stream, pass section without modification (shared section data).
+            const SectionPtr sp(new Section(section, SHARE));
+            CheckNonNull(sp.pointer());
             _eits.push_back(sp);
         }
-        else if (sp->payloadSize() >= 2 && _main_tsid.set()) {
+        else if (section.payloadSize() >= 2 && _main_tsid.set()) {
             // This is an EIT-Actual from merged stream and we know the main TS id.
-            // Patch the EIT with new TS id before enqueueing.
-            // The TSid is in the first two bytes of the EIT payload.
-            sp->setUInt16(0, _main_tsid.value(), true);
-            _eits.push_back(sp);
+            // The EIT must be patched with the new TS id, in the first two bytes
+            // of the EIT payload. Patching means recomputing the CRC32 of the
+            // section, which is expensive on each repetition of a large EIT
+            // schedule. So, we keep a cache of patched section images and
+            // regenerate a section only when its source version changed.
+            const uint32_t index = (uint32_t(tid) << 24) | (uint32_t(section.tableIdExtension()) << 8) | section.sectionNumber();
+            const auto cached = _eit_cache.find(index);
+            if (cached != _eit_cache.end() && cached->second->version() == section.version() && GetUInt16(cached->second->payload()) == _main_tsid.value()) {
+                // Same source version and same main TS id, reuse the patched image.
+                _eits.push_back(cached->second);
+            }
+            else {
+                // New or modified section, patch a private copy and cache it.
+                const SectionPtr sp(new Section(section, COPY));
+                CheckNonNull(sp.pointer());
+                sp->setUInt16(0, _main_tsid.value(), true);
+                _eit_cache[index] = sp;
+                _eits.push_back(sp);
+            }
         }
     }
 }
@@ -152,6 +152,7 @@ namespace ts {
         std::map<uint16_t, BAT> _merge_bats;  // Map of last input BAT/bouquet_it from merged TS.
         std::list<SectionPtr>   _eits;        // List of EIT sections to insert.
         size_t                  _max_eits;    // Maximum number of buffered EIT sections.
+        std::map<uint32_t, SectionPtr> _eit_cache;  // Cache of patched EIT-Actual sections from the merged TS, indexed by TID / service id / section number.
 
         static constexpr int DEMUX_MAIN      = 1; // Id of the demux from the main TS.
         static constexpr int DEMUX_MAIN_EIT  = 2; // Id of the demux from the main TS for EIT's.
@@ -41,7 +41,11 @@ ts::PacketDecapsulation::PacketDecapsulation(PID pid) :
     _ccInput(0),
     _nextIndex(1),
     _nextPacket(),
-    _lastError()
+    _lastError(),
+    _inputCount(0),
+    _outputCount(0),
+    _syncLosses(0),
+    _discardedBytes(0)
 {
     // There is always implicitely one sync byte in decapsulated packets.
     _nextPacket.b[0] = SYNC_BYTE;
@@ -58,6 +62,10 @@ void ts::PacketDecapsulation::reset(PID pid)
     _synchronized = false;
     _nextIndex = 1; // after sync byte
     _lastError.clear();
+    _inputCount = 0;
+    _outputCount = 0;
+    _syncLosses = 0;
+    _discardedBytes = 0;
 }
 
 
@@ -67,6 +75,10 @@ void ts::PacketDecapsulation::reset(PID pid)
 
 bool ts::PacketDecapsulation::lostSync(const UString& error)
 {
+    // Account for the loss and for the partially reassembled bytes we drop.
+    _syncLosses++;
+    _discardedBytes += _nextIndex - 1;
+
     _synchronized = false;
     _nextIndex = 1;  // after sync byte
     _lastError = error;
@@ -90,6 +102,7 @@ bool ts::PacketDecapsulation::processPacket(ts::TSPacket& pkt)
     if (_pidInput == PID_NULL || pkt.getPID() != _pidInput) {
         return true;
     }
+    _inputCount++;
 
     // Where to look at in input packet. Start at beginning of payload.
     size_t pktIndex = pkt.getHeaderSize();
@@ -268,6 +281,7 @@ bool ts::PacketDecapsulation::processPacket(ts::TSPacket& pkt)
 
     if (_nextIndex == PKT_SIZE) {
         // Next packet is full, return it.
+        _outputCount++;
         const TSPacket tmp(pkt);
         pkt = _nextPacket;
         // Copy start of next packet.
@@ -92,13 +92,45 @@ namespace ts {
         //!
         PID inputPID() const { return _pidInput; }
 
+        //!
+        //! Get the number of packets processed on the input PID.
+        //! @return The number of packets which were processed on the input PID.
+        //!
+        PacketCounter inputPacketCount() const { return _inputCount; }
+
+        //!
+        //! Get the number of decapsulated packets.
+        //! @return The number of complete packets which were decapsulated.
+        //!
+        PacketCounter outputPacketCount() const { return _outputCount; }
+
+        //!
+        //! Get the number of synchronization losses.
+        //! Synchronization is lost on malformed encapsulated data or on
+        //! discontinuities in the input PID.
+        //! @return The number of synchronization losses.
+        //!
+        PacketCounter syncLossCount() const { return _syncLosses; }
+
+        //!
+        //! Get the number of discarded bytes.
+        //! These are bytes of partially reassembled packets which were dropped
+        //! when the synchronization was lost.
+        //! @return The number of discarded bytes.
+        //!
+        uint64_t discardedByteCount() const { return _discardedBytes; }
+
     private:
-        PID      _pidInput;      // Input PID.
-        bool     _synchronized;  // Input PID fully synchronized.
-        uint8_t  _ccInput;       // Continuity counter in input PID.
-        size_t   _nextIndex;     // Current size of _nextIndex (not full yet).
-        TSPacket _nextPacket;    // Next packet, partially decapsulated.
-        UString  _lastError;     // Last error message.
+        PID           _pidInput;        // Input PID.
+        bool          _synchronized;    // Input PID fully synchronized.
+        uint8_t       _ccInput;         // Continuity counter in input PID.
+        size_t        _nextIndex;       // Current size of _nextIndex (not full yet).
+        TSPacket      _nextPacket;      // Next packet, partially decapsulated.
+        UString       _lastError;       // Last error message.
+        PacketCounter _inputCount;      // Number of packets processed on the input PID.
+        PacketCounter _outputCount;     // Number of complete decapsulated packets.
+        PacketCounter _syncLosses;      // Number of synchronization losses.
+        uint64_t      _discardedBytes;  // Partially reassembled bytes dropped on sync losses.
 
         // Loose synchronization, return false.
         bool lostSync(const UString& error);
@@ -61,7 +61,9 @@ ts::PacketEncapsulation::PacketEncapsulation(PID pidOutput, const PIDSet& pidInp
     _lateDistance(0),
     _lateMaxPackets(DEFAULT_MAX_BUFFERED_PACKETS),
     _lateIndex(0),
-    _latePackets()
+    _lateBuffer(),
+    _lateHead(0),
+    _lateCount(0)
 {
 }
 
@@ -86,7 +88,8 @@ void ts::PacketEncapsulation::reset(PID pidOutput, const PIDSet& pidInput, PID p
     _lastCC.clear();
     _lateDistance = 0;
     _lateIndex = 0;
-    _latePackets.clear();
+    _lateHead = 0;
+    _lateCount = 0;
     resetPCR();
 }
 
@@ -105,7 +108,8 @@ void ts::PacketEncapsulation::setOutputPID(PID pid)
         _lastCC.clear();
         _lateDistance = 0;
         _lateIndex = 0;
-        _latePackets.clear();
+        _lateHead = 0;
+        _lateCount = 0;
     }
 }
 
@@ -238,15 +242,15 @@ bool ts::PacketEncapsulation::processPacket(TSPacket& pkt)
     // is empty because no input packet can fit into an output packet. At least
     // a few bytes need to be queued.
     if (_pidInput.test(pid) && _pidOutput != PID_NULL) {
-        if (_latePackets.size() > _lateMaxPackets) {
+        if (_lateCount > _lateMaxPackets) {
             _lastError.assign(u"buffered packets overflow, insufficient null packets in input stream");
             status = false;
         }
         else {
             // Enqueue the packet.
-            _latePackets.push_back(new TSPacket(pkt));
+            latePush(pkt);
             // If this is the first packet in the queue, point to the first byte after 0x47.
-            if (_latePackets.size() == 1) {
+            if (_lateCount == 1) {
                 _lateIndex = 1;
             }
         }
@@ -261,13 +265,13 @@ bool ts::PacketEncapsulation::processPacket(TSPacket& pkt)
     }
 
     // Replace input or null packets.
-    if (pid == PID_NULL && !_latePackets.empty()) {
+    if (pid == PID_NULL && _lateCount > 0) {
 
         // Do we need to add a PCR in this packet?
         const bool addPCR = _insertPCR && _bitrate != 0 && _pcrLastPacket != INVALID_PACKET_COUNTER && _pcrLastValue != INVALID_PCR;
 
         // How many bytes do we have in the queue (at least).
-        const size_t addBytes = (PKT_SIZE - _lateIndex) + (_latePackets.size() > 1 ? PKT_SIZE : 0);
+        const size_t addBytes = (PKT_SIZE - _lateIndex) + (_lateCount > 1 ? PKT_SIZE : 0);
 
         // Depending on packing option, we may decide to not insert an outer packet which is not full.
         // Available size in outer packet:
@@ -330,7 +334,7 @@ bool ts::PacketEncapsulation::processPacket(TSPacket& pkt)
             // If there are less "late" bytes than the output payload size, enlarge the adaptation field
             // with stuffing. Note that if there is so few bytes in the only "late" packet, this cannot
             // be the beginning of a packet and there will be no pointer field.
-            if (_latePackets.size() == 1 && _lateIndex > (pes_header + pkt.getHeaderSize())) {
+            if (_lateCount == 1 && _lateIndex > (pes_header + pkt.getHeaderSize())) {
                 pkt.setPayloadSize(PKT_SIZE - _lateIndex + pes_header);
             }
 
@@ -467,7 +471,7 @@ bool ts::PacketEncapsulation::processPacket(TSPacket& pkt)
                 }
                 pkt.b[pktIndex++] = 0; // pointer field
             }
-            else if (_lateIndex > pktIndex + 1 && _latePackets.size() > 1) {
+            else if (_lateIndex > pktIndex + 1 && _lateCount > 1) {
                 // The remaining bytes in the first packet are less than the output payload,
                 // we will start a new packet in this payload.
                 if (_pesMode != DISABLED) {
@@ -498,26 +502,64 @@ bool ts::PacketEncapsulation::processPacket(TSPacket& pkt)
 }
 
 
+//----------------------------------------------------------------------------
+// Ring of preallocated slots for buffered packets.
+//----------------------------------------------------------------------------
+
+void ts::PacketEncapsulation::latePush(const TSPacket& pkt)
+{
+    // The ring must hold one more packet than the maximum since the overflow
+    // is detected only when the maximum is already exceeded.
+    if (_lateBuffer.size() < _lateMaxPackets + 1) {
+        if (_lateCount == 0) {
+            // Empty ring, (re)allocate it in place.
+            _lateBuffer.resize(_lateMaxPackets + 1);
+            _lateHead = 0;
+        }
+        else {
+            // The maximum was raised while packets are buffered (rare).
+            // Linearize the ring into a larger one.
+            std::vector<TSPacket> buffer(_lateMaxPackets + 1);
+            for (size_t i = 0; i < _lateCount; ++i) {
+                buffer[i] = _lateBuffer[(_lateHead + i) % _lateBuffer.size()];
+            }
+            _lateBuffer.swap(buffer);
+            _lateHead = 0;
+        }
+    }
+
+    // Copy the packet into its preallocated slot.
+    _lateBuffer[(_lateHead + _lateCount) % _lateBuffer.size()] = pkt;
+    _lateCount++;
+}
+
+void ts::PacketEncapsulation::latePop()
+{
+    assert(_lateCount > 0);
+    _lateHead = (_lateHead + 1) % _lateBuffer.size();
+    _lateCount--;
+}
+
+
 //----------------------------------------------------------------------------
 // Fill packet payload with data from the first queued packet.
 //----------------------------------------------------------------------------
 
 void ts::PacketEncapsulation::fillPacket(ts::TSPacket& pkt, size_t& pktIndex)
 {
-    assert(!_latePackets.empty());
-    assert(!_latePackets.front().isNull());
+    assert(_lateCount > 0);
     assert(_lateIndex < PKT_SIZE);
     assert(pktIndex < PKT_SIZE);
 
     // Copy part of output payload from the first queued packet.
     const size_t size = std::min(PKT_SIZE - pktIndex, PKT_SIZE - _lateIndex);
-    ::memcpy(pkt.b + pktIndex, _latePackets.front()->b + _lateIndex, size);
+    ::memcpy(pkt.b + pktIndex, lateFront().b + _lateIndex, size);
     pktIndex += size;
     _lateIndex += size;
 
     // If the first queued packet if fully encapsulated, remove it.
     if (_lateIndex >= PKT_SIZE) {
-        _latePackets.pop_front();
+        latePop();
         _lateIndex = 1;  // skip 0x47 in next packet
     }
 }
@@ -35,7 +35,6 @@
 #pragma once
 #include "tsMPEG.h"
 #include "tsTSPacket.h"
-#include "tsSafePtr.h"
 
 namespace ts {
     //!
@@ -305,9 +304,11 @@ namespace ts {
 
     private:
         typedef std::map<PID,uint8_t> PIDCCMap;  // map of continuity counters, indexed by PID
-        typedef SafePtr<TSPacket> TSPacketPtr;
-        typedef std::deque<TSPacketPtr> TSPacketPtrQueue;
 
+        // The buffered inner packets are stored in a ring of preallocated
+        // slots, not in a queue of heap-allocated copies. Each inner packet
+        // is copied once into its slot on arrival and once into its final
+        // position in an outer packet, without intermediate allocation.
         bool             _packing;         // Packing mode.
         size_t           _packDistance;    // Maximum distance between inner packets.
         PESMode          _pesMode;         // PES mode selected.
@@ -326,9 +327,20 @@ namespace ts {
         uint8_t          _ccPES;           // Continuity counter in PES ASYNC mode.
         PIDCCMap         _lastCC;          // Continuity counter by PID.
         size_t           _lateDistance;    // Distance from the last packet.
-        size_t           _lateMaxPackets;  // Maximum number of packets in _latePackets.
+        size_t           _lateMaxPackets;  // Maximum number of buffered packets.
         size_t           _lateIndex;       // Index in first late packet.
-        TSPacketPtrQueue _latePackets;     // Packets to insert later.
+        std::vector<TSPacket> _lateBuffer; // Ring of preallocated slots for buffered packets.
+        size_t           _lateHead;        // Index of the oldest buffered packet in the ring.
+        size_t           _lateCount;       // Number of buffered packets in the ring.
+
+        // Access the oldest buffered packet.
+        TSPacket& lateFront() { return _lateBuffer[_lateHead]; }
+
+        // Append a packet at the end of the ring, allocating or growing the ring when needed.
+        void latePush(const TSPacket& pkt);
+
+        // Remove the oldest packet from the ring.
+        void latePop();
 
         // Reset PCR information, lost synchronization.
         void resetPCR();
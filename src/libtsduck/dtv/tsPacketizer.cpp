@@ -41,14 +41,14 @@ TSDUCK_SOURCE;
 //----------------------------------------------------------------------------
 
 ts::Packetizer::Packetizer(PID pid, SectionProviderInterface* provider) :
-    _provider(provider),
     _pid(pid),
     _continuity(0),
-    _section(nullptr),
-    _next_byte(0),
     _packet_count(0),
     _section_out_count(0),
-    _section_in_count(0)
+    _section_in_count(0),
+    _provider(provider),
+    _section(nullptr),
+    _next_byte(0)
 {
 }
 
@@ -216,6 +216,52 @@ bool ts::Packetizer::getNextPacket(TSPacket& pkt)
 }
 
 
+//----------------------------------------------------------------------------
+// Build the next MPEG packets for the list of sections.
+//----------------------------------------------------------------------------
+
+size_t ts::Packetizer::getPackets(TSPacket* pkt, size_t count)
+{
+    size_t real_count = 0;
+
+    for (size_t i = 0; i < count; ) {
+
+        // Fast path: a section is already started and more than one full
+        // payload remains. The packets are pure section continuation, no
+        // new section can start inside them and the section provider does
+        // not need to be queried. Build them in one single tight loop.
+        if (!_section.isNull() && _next_byte > 0) {
+            const uint8_t* const content = _section->content();
+            size_t remain_in_section = _section->size() - _next_byte;
+            while (i < count && remain_in_section > PKT_SIZE - 4) {
+                TSPacket& p(pkt[i]);
+                p.b[0] = SYNC_BYTE;
+                PutUInt16(p.b + 1, _pid);       // no payload_unit_start_indicator
+                p.b[3] = 0x10 | _continuity;    // no adaptation field, has payload
+                _continuity = (_continuity + 1) & 0x0F;
+                ::memcpy(p.b + 4, content + _next_byte, PKT_SIZE - 4);  // Flawfinder: ignore: memcpy()
+                _next_byte += PKT_SIZE - 4;
+                remain_in_section -= PKT_SIZE - 4;
+                _packet_count++;
+                real_count++;
+                i++;
+            }
+            if (i >= count) {
+                break;
+            }
+        }
+
+        // General path: packets at section boundaries (start of section,
+        // end of section, possible start of next section in the middle).
+        if (getNextPacket(pkt[i])) {
+            real_count++;
+        }
+        i++;
+    }
+    return real_count;
+}
+
+
 //----------------------------------------------------------------------------
 // Display the internal state of the packetizer, mainly for debug
 //----------------------------------------------------------------------------
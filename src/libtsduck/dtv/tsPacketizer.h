@@ -123,7 +123,7 @@ namespace ts {
         //! @return True if the last returned packet contained
         //! the end of a section and no unfinished section.
         //!
-        bool atSectionBoundary() const
+        virtual bool atSectionBoundary() const
         {
             return _next_byte == 0;
         }
@@ -134,7 +134,21 @@ namespace ts {
         //! @param [out] packet The next TS packet.
         //! @return True if a real packet is returned, false if a null packet was returned.
         //!
-        bool getNextPacket(TSPacket& packet);
+        virtual bool getNextPacket(TSPacket& packet);
+
+        //!
+        //! Build the next MPEG packets for the list of sections.
+        //! This is equivalent to @a count invocations of getNextPacket() but
+        //! the packets in the middle of a large section are built in one
+        //! single pass, with one continuity counter sweep and full-payload
+        //! copies, without rechecking the section provider per packet.
+        //! @param [out] packet Address of an array of TS packets to build.
+        //! @param [in] count Number of TS packets in @a packet.
+        //! @return The number of real packets which were returned. When there
+        //! is no more section to packetize, the array is completed with null
+        //! packets, just like getNextPacket().
+        //!
+        size_t getPackets(TSPacket* packet, size_t count);
 
         //!
         //! Get the number of generated packets so far.
@@ -168,15 +182,19 @@ namespace ts {
         //!
         virtual std::ostream& display(std::ostream& strm) const;
 
+    protected:
+        // These fields are accessible to subclasses which override getNextPacket()
+        // and generate some packets outside the generic packetization engine.
+        PID            _pid;               //!< PID for generated TS packets.
+        uint8_t        _continuity;        //!< Continuity counter for next packet.
+        PacketCounter  _packet_count;      //!< Number of generated packets.
+        SectionCounter _section_out_count; //!< Number of output (packetized) sections.
+        SectionCounter _section_in_count;  //!< Number of input (provided) sections.
+
     private:
         SectionProviderInterface* _provider;
-        PID            _pid;
-        uint8_t        _continuity;        // Continuity counter for next packet
         SectionPtr     _section;           // Current section to insert
         size_t         _next_byte;         // Next byte to insert in current section
-        PacketCounter  _packet_count;      // Number of generated packets
-        SectionCounter _section_out_count; // Number of output (packetized) sections
-        SectionCounter _section_in_count;  // Number of input (provided) sections
     };
 }
 
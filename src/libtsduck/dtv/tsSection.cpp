@@ -49,7 +49,8 @@ ts::Section::Section() :
     _source_pid(PID_NULL),
     _first_pkt(0),
     _last_pkt(0),
-    _data()
+    _data(),
+    _hash(0)
 {
 }
 
@@ -63,7 +64,8 @@ ts::Section::Section(const Section& sect, CopyShare mode) :
     _source_pid(sect._source_pid),
     _first_pkt(sect._first_pkt),
     _last_pkt(sect._last_pkt),
-    _data()
+    _data(),
+    _hash(sect._hash)
 {
     switch (mode) {
         case SHARE:
@@ -78,6 +80,16 @@ ts::Section::Section(const Section& sect, CopyShare mode) :
     }
 }
 
+ts::Section::Section(Section&& sect) noexcept :
+    _is_valid(sect._is_valid),
+    _source_pid(sect._source_pid),
+    _first_pkt(sect._first_pkt),
+    _last_pkt(sect._last_pkt),
+    _data(std::move(sect._data)),
+    _hash(sect._hash)
+{
+}
+
 
 //----------------------------------------------------------------------------
 // Constructor from full binary content.
@@ -91,7 +103,8 @@ ts::Section::Section(const void* content,
     _source_pid(source_pid),
     _first_pkt(0),
     _last_pkt(0),
-    _data()
+    _data(),
+    _hash(0)
 {
     initialize(new ByteBlock(content, content_size), source_pid, crc_op);
 }
@@ -108,7 +121,8 @@ ts::Section::Section(const ByteBlock& content,
     _source_pid(source_pid),
     _first_pkt(0),
     _last_pkt(0),
-    _data()
+    _data(),
+    _hash(0)
 {
     initialize(new ByteBlock(content), source_pid, crc_op);
 }
@@ -125,7 +139,8 @@ ts::Section::Section(const ByteBlockPtr& content_ptr,
     _source_pid(source_pid),
     _first_pkt(0),
     _last_pkt(0),
-    _data()
+    _data(),
+    _hash(0)
 {
     initialize(content_ptr, source_pid, crc_op);
 }
@@ -144,7 +159,8 @@ ts::Section::Section(TID tid,
     _source_pid(source_pid),
     _first_pkt(0),
     _last_pkt(0),
-    _data()
+    _data(),
+    _hash(0)
 {
     reload(tid, is_private_section, payload, payload_size, source_pid);
 }
@@ -168,7 +184,8 @@ ts::Section::Section(TID tid,
     _source_pid(source_pid),
     _first_pkt(0),
     _last_pkt(0),
-    _data()
+    _data(),
+    _hash(0)
 {
     reload(tid, is_private_section, tid_ext, version, is_current,
            section_number, last_section_number,
@@ -240,6 +257,7 @@ void ts::Section::initialize(PID pid)
     _first_pkt = 0;
     _last_pkt = 0;
     _data = nullptr;
+    _hash = 0;
 }
 
 
@@ -315,6 +333,20 @@ ts::Section& ts::Section::operator=(const Section& sect)
         _first_pkt = sect._first_pkt;
         _last_pkt = sect._last_pkt;
         _data = sect._data;
+        _hash = sect._hash;
+    }
+    return *this;
+}
+
+ts::Section& ts::Section::operator=(Section&& sect) noexcept
+{
+    if (&sect != this) {
+        _is_valid = sect._is_valid;
+        _source_pid = sect._source_pid;
+        _first_pkt = sect._first_pkt;
+        _last_pkt = sect._last_pkt;
+        _data = std::move(sect._data);
+        _hash = sect._hash;
     }
     return *this;
 }
@@ -333,6 +365,7 @@ ts::Section& ts::Section::copy(const Section& sect)
         _first_pkt = sect._first_pkt;
         _last_pkt = sect._last_pkt;
         _data = sect._is_valid ? new ByteBlock(*sect._data) : nullptr;
+        _hash = sect._hash;
     }
     return *this;
 }
@@ -357,6 +390,7 @@ void ts::Section::recomputeCRC()
     if (isLongSection()) {
         const size_t size = _data->size() - 4;
         PutUInt32(_data->data() + size, CRC32(_data->data(), size).value());
+        _hash = 0;
     }
 }
 
@@ -385,6 +419,29 @@ bool ts::Section::StartLongSection(const uint8_t* data, size_t size)
 }
 
 
+//----------------------------------------------------------------------------
+// Get a 64-bit hash of the binary content of the section.
+//----------------------------------------------------------------------------
+
+uint64_t ts::Section::hash() const
+{
+    // The hash is computed once and cached, zero means not yet computed.
+    if (_hash == 0) {
+        // 64-bit FNV-1a, a fast non-cryptographic hash.
+        uint64_t h = TS_UCONST64(0xCBF29CE484222325);
+        if (!_data.isNull()) {
+            const uint8_t* p = _data->data();
+            for (size_t n = _data->size(); n > 0; --n) {
+                h = (h ^ *p++) * TS_UCONST64(0x00000100000001B3);
+            }
+        }
+        // Zero is reserved as the "not computed" marker.
+        _hash = h != 0 ? h : 1;
+    }
+    return _hash;
+}
+
+
 //----------------------------------------------------------------------------
 // Check if the section has a "diversified" payload.
 //----------------------------------------------------------------------------
@@ -403,6 +460,7 @@ void ts::Section::setTableIdExtension(uint16_t tid_ext, bool recompute_crc)
 {
     if (isLongSection()) {
         PutUInt16(_data->data() + 3, tid_ext);
+        _hash = 0;
         if (recompute_crc) {
             recomputeCRC();
         }
@@ -413,6 +471,7 @@ void ts::Section::setVersion(uint8_t version, bool recompute_crc)
 {
     if (isLongSection()) {
         (*_data)[5] = ((*_data)[5] & 0xC1) | uint8_t((version & 0x1F) << 1);
+        _hash = 0;
         if (recompute_crc) {
             recomputeCRC();
         }
@@ -423,6 +482,7 @@ void ts::Section::setIsCurrent(bool is_current, bool recompute_crc)
 {
     if (isLongSection()) {
         (*_data)[5] = ((*_data)[5] & 0xFE) | (is_current ? 0x01 : 0x00);
+        _hash = 0;
         if (recompute_crc) {
             recomputeCRC();
         }
@@ -433,6 +493,7 @@ void ts::Section::setSectionNumber(uint8_t num, bool recompute_crc)
 {
     if (isLongSection()) {
         (*_data)[6] = num;
+        _hash = 0;
         if (recompute_crc) {
             recomputeCRC();
         }
@@ -443,6 +504,7 @@ void ts::Section::setLastSectionNumber(uint8_t num, bool recompute_crc)
 {
     if (isLongSection()) {
         (*_data)[7] = num;
+        _hash = 0;
         if (recompute_crc) {
             recomputeCRC();
         }
@@ -453,6 +515,7 @@ void ts::Section::setUInt8(size_t offset, uint8_t value, bool recompute_crc)
 {
     if (_is_valid && offset < payloadSize()) {
         PutUInt8(_data->data() + headerSize() + offset, value);
+        _hash = 0;
         if (recompute_crc) {
             recomputeCRC();
         }
@@ -463,6 +526,7 @@ void ts::Section::setUInt16(size_t offset, uint16_t value, bool recompute_crc)
 {
     if (_is_valid && offset + 1 < payloadSize()) {
         PutUInt16(_data->data() + headerSize() + offset, value);
+        _hash = 0;
         if (recompute_crc) {
             recomputeCRC();
         }
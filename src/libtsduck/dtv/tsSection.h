@@ -73,6 +73,12 @@ namespace ts {
         //!
         Section(const Section& other, CopyShare mode);
 
+        //!
+        //! Move constructor.
+        //! @param [in,out] other Another instance to move.
+        //!
+        Section(Section&& other) noexcept;
+
         //!
         //! Constructor from full binary content.
         //! The content is copied into the section if valid.
@@ -255,6 +261,15 @@ namespace ts {
         //!
         Section& operator=(const Section& other);
 
+        //!
+        //! Move assignment operator.
+        //! The content of the other section is moved into this object,
+        //! without copy or reference counting update.
+        //! @param [in,out] other Other section to move into this object.
+        //! @return A reference to this object.
+        //!
+        Section& operator=(Section&& other) noexcept;
+
         //!
         //! Duplication.
         //! Similar to assignment but the sections are duplicated.
@@ -420,6 +435,19 @@ namespace ts {
             return _data->data();
         }
 
+        //!
+        //! Access to the shared binary content of the section.
+        //! Do not modify content.
+        //! Unlike content(), holding the returned safe pointer keeps the
+        //! binary content alive, even after this section object is reused
+        //! or deleted.
+        //! @return A safe pointer to the full binary content of the section.
+        //!
+        ByteBlockPtr contentPtr() const
+        {
+            return _data;
+        }
+
         //!
         //! Size of the binary content of the section.
         //! @return Size of the binary content of the section.
@@ -429,6 +457,16 @@ namespace ts {
             return _data->size();
         }
 
+        //!
+        //! Get a 64-bit hash of the binary content of the section.
+        //! This is a fast non-cryptographic hash (64-bit FNV-1a), suitable
+        //! for duplicate detection without byte comparison. The hash is
+        //! computed once, cached in the section object, and invalidated
+        //! when the content of the section is modified.
+        //! @return A 64-bit hash of the full binary content of the section.
+        //!
+        uint64_t hash() const;
+
         //!
         //! Size of the section header.
         //! @return Size of the section header.
@@ -648,6 +686,7 @@ namespace ts {
         PacketCounter _first_pkt;   // Index of first packet in stream (informational)
         PacketCounter _last_pkt;    // Index of last packet in stream (informational)
         ByteBlockPtr  _data;        // Full binary content of the section
+        mutable uint64_t _hash;     // Cached content hash (0 means not yet computed)
 
         // Helpers for constructors
         void initialize(PID);
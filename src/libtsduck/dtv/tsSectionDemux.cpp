@@ -34,8 +34,14 @@
 #include "tsSectionDemux.h"
 #include "tsTablesFactory.h"
 #include "tsEIT.h"
+#include "tsTracepoint.h"
 TSDUCK_SOURCE;
 
+// Maximum number of pooled section buffers or Section objects per PID.
+// Entries above this limit are allocated but not recycled, this bounds
+// both the pool scan time and the retained memory per PID.
+#define MAX_SECTION_POOL 16
+
 
 //----------------------------------------------------------------------------
 // Demux status information.
@@ -184,7 +190,9 @@ ts::SectionDemux::PIDContext::PIDContext() :
     continuity(0),
     sync(false),
     ts(),
-    tids()
+    tids(),
+    slabs(),
+    recycle()
 {
 }
 
@@ -195,6 +203,48 @@ void ts::SectionDemux::PIDContext::syncLost()
     ts.clear();
 }
 
+// Build a section from the arena of this PID.
+ts::SectionPtr ts::SectionDemux::PIDContext::allocSection(const void* data, size_t size, PID pid)
+{
+    // Locate a data slab without external reference. A slab is shared with
+    // the Section which was built on it, a reference count of one means
+    // that this section and all its users are gone.
+    ByteBlockPtr bb;
+    for (auto it = slabs.begin(); bb.isNull() && it != slabs.end(); ++it) {
+        if (it->count() == 1) {
+            bb = *it;
+        }
+    }
+    if (bb.isNull()) {
+        bb = new ByteBlock(data, size);
+        if (slabs.size() < MAX_SECTION_POOL) {
+            slabs.push_back(bb);
+        }
+    }
+    else {
+        // Copy the section content in place, reusing the slab capacity.
+        bb->copy(data, size);
+    }
+
+    // Locate a recyclable Section object the same way.
+    SectionPtr sp;
+    for (auto it = recycle.begin(); sp.isNull() && it != recycle.end(); ++it) {
+        if (it->count() == 1) {
+            sp = *it;
+        }
+    }
+    if (sp.isNull()) {
+        sp = new Section(bb, pid, CRC32::CHECK);
+        if (recycle.size() < MAX_SECTION_POOL) {
+            recycle.push_back(sp);
+        }
+    }
+    else {
+        sp->reload(bb, pid, CRC32::CHECK);
+    }
+    return sp;
+}
+
 
 //----------------------------------------------------------------------------
 // SectionDemux constructor and destructor.
@@ -241,6 +291,16 @@ void ts::SectionDemux::feedPacket(const TSPacket& pkt)
     SuperClass::feedPacket(pkt);
 }
 
+void ts::SectionDemux::feedPackets(const TSPacket* pkt, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (_pid_filter[pkt[i].getPID()]) {
+            processPacket(pkt[i]);
+        }
+        SuperClass::feedPacket(pkt[i]);
+    }
+}
+
 void ts::SectionDemux::processPacket(const TSPacket& pkt)
 {
     // Reject invalid packets
@@ -493,7 +553,7 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
             SectionPtr sect_ptr;
 
             if (section_ok && (_section_handler != nullptr || (tc != nullptr && tc->sects[section_number].isNull()))) {
-                sect_ptr = new Section(ts_start, section_length, pid, CRC32::CHECK);
+                sect_ptr = pc.allocSection(ts_start, section_length, pid);
                 sect_ptr->setFirstTSPacketIndex(pusi_pkt_index);
                 sect_ptr->setLastTSPacketIndex(_packet_count);
                 if (!sect_ptr->isValid()) {
@@ -502,6 +562,11 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
                 }
             }
 
+            // Static tracepoint on each complete section, even without handler.
+            if (section_ok) {
+                TS_TRACEPOINT3(demux_section, pid, ts_start[0], section_length);
+            }
+
             // Mark that we are in the context of a table or section handler.
             // This is used to prevent the destruction of PID contexts during
             // the execution of a handler.
@@ -72,6 +72,7 @@ namespace ts {
 
         // Inherited methods
         virtual void feedPacket(const TSPacket& pkt) override;
+        virtual void feedPackets(const TSPacket* pkt, size_t count) override;
 
         //!
         //! Pack sections in all incomplete tables and notify these rebuilt tables.
@@ -240,12 +241,19 @@ namespace ts {
             bool          sync;               // We are synchronous in this PID
             ByteBlock     ts;                 // TS payload buffer
             std::map<ETID,ETIDContext> tids;  // TID analysis contexts
+            std::vector<ByteBlockPtr> slabs;  // Arena of section data blocks, reused when unreferenced
+            SectionPtrVector recycle;         // Arena of Section objects, reused when unreferenced
 
             // Default constructor.
             PIDContext();
 
             // Called when packet synchronization is lost on the pid.
             void syncLost();
+
+            // Build a section from the arena of this PID. A pooled data slab
+            // and Section object are reused when no external reference remains
+            // on them, new ones are allocated and pooled otherwise.
+            SectionPtr allocSection(const void* data, size_t size, PID pid);
         };
 
         // Notify the application if the table is complete.
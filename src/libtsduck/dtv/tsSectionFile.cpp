@@ -291,6 +291,76 @@ bool ts::SectionFile::loadBinary(std::istream& strm, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Streaming reader for binary section files.
+//----------------------------------------------------------------------------
+
+ts::SectionFile::BinaryReader::BinaryReader(CRC32::Validation crc_op) :
+    _crc_op(crc_op),
+    _file(),
+    _strm(nullptr),
+    _file_name(),
+    _success(true)
+{
+}
+
+bool ts::SectionFile::BinaryReader::open(const UString& file_name, Report& report)
+{
+    close();
+    _file.open(file_name.toUTF8().c_str(), std::ios::in | std::ios::binary);
+    if (!_file.is_open()) {
+        report.error(u"cannot open %s", {file_name});
+        _success = false;
+        return false;
+    }
+    _file_name = file_name;
+    _strm = &_file;
+    return true;
+}
+
+void ts::SectionFile::BinaryReader::open(std::istream& strm)
+{
+    close();
+    _strm = &strm;
+}
+
+bool ts::SectionFile::BinaryReader::readSection(SectionPtr& section, Report& report)
+{
+    section.clear();
+    if (_strm == nullptr || !*_strm) {
+        return false;
+    }
+
+    const SectionPtr sp(new Section);
+    if (_file_name.empty()) {
+        sp->read(*_strm, _crc_op, report);
+    }
+    else {
+        ReportWithPrefix report_internal(report, _file_name + u": ");
+        sp->read(*_strm, _crc_op, report_internal);
+    }
+
+    if (!*_strm) {
+        // End of file or error. Same criteria as loadBinary(): EOF is a success.
+        _success = _strm->eof();
+        return false;
+    }
+    section = sp;
+    return true;
+}
+
+void ts::SectionFile::BinaryReader::close()
+{
+    if (_file.is_open()) {
+        _file.close();
+        _file.clear();
+    }
+    _strm = nullptr;
+    _file_name.clear();
+    _success = true;
+}
+
+
 //----------------------------------------------------------------------------
 // Save a binary section file.
 //----------------------------------------------------------------------------
@@ -128,6 +128,69 @@ namespace ts {
             XML,          //!< XML section file.
         };
 
+        //!
+        //! A class which reads a binary section file one section at a time.
+        //!
+        //! Unlike loadBinary(), the file is never loaded in memory as a whole.
+        //! Arbitrarily large section dumps (long continuous captures for
+        //! instance) are processed with a constant memory footprint: only the
+        //! current section is held in memory.
+        //!
+        class TSDUCKDLL BinaryReader
+        {
+            TS_NOCOPY(BinaryReader);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] crc_op How to process the CRC32 of the input sections.
+            //!
+            BinaryReader(CRC32::Validation crc_op = CRC32::IGNORE);
+
+            //!
+            //! Open a binary section file.
+            //! @param [in] file_name Binary file name.
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success, false on error.
+            //!
+            bool open(const UString& file_name, Report& report = CERR);
+
+            //!
+            //! Use an already open binary stream, such as the standard input.
+            //! @param [in,out] strm A standard stream in input mode (binary mode).
+            //! The stream must remain valid as long as sections are read.
+            //!
+            void open(std::istream& strm);
+
+            //!
+            //! Read the next section from the file.
+            //! @param [out] section The next section, a null pointer at end of file.
+            //! @param [in,out] report Where to report errors.
+            //! @return True when a section was read, false at end of file or on error.
+            //!
+            bool readSection(SectionPtr& section, Report& report = CERR);
+
+            //!
+            //! Check if the file was completely and successfully read.
+            //! @return True if the end of file was reached without error.
+            //!
+            bool success() const
+            {
+                return _success;
+            }
+
+            //!
+            //! Close the file or forget the stream.
+            //!
+            void close();
+
+        private:
+            CRC32::Validation _crc_op;     // How to process the CRC32 of the input sections.
+            std::ifstream     _file;       // File stream when open() was called with a file name.
+            std::istream*     _strm;       // Input stream, points to _file or a user stream.
+            UString           _file_name;  // File name, for error messages.
+            bool              _success;    // No error occurred so far.
+        };
+
         //!
         //! Clear the list of loaded tables and sections.
         //!
@@ -180,6 +180,72 @@ uint32_t ts::Service::getFields() const
 }
 
 
+//----------------------------------------------------------------------------
+// List of fields which differ between two Services
+//----------------------------------------------------------------------------
+
+namespace {
+    // Check if two optional fields differ: set in only one of the two
+    // objects or set in both with distinct values.
+    template <typename T>
+    inline bool Differ(const ts::Variable<T>& a, const ts::Variable<T>& b)
+    {
+        return (a.set() || b.set()) && !(a == b);
+    }
+}
+
+uint32_t ts::Service::diffFields(const Service& other) const
+{
+    uint32_t fields = 0;
+    if (Differ(_id, other._id)) {
+        fields |= ID;
+    }
+    if (Differ(_tsid, other._tsid)) {
+        fields |= TSID;
+    }
+    if (Differ(_onid, other._onid)) {
+        fields |= ONID;
+    }
+    if (Differ(_pmt_pid, other._pmt_pid)) {
+        fields |= PMT_PID;
+    }
+    if (Differ(_lcn, other._lcn)) {
+        fields |= LCN;
+    }
+    if (Differ(_type_dvb, other._type_dvb)) {
+        fields |= TYPE_DVB;
+    }
+    if (Differ(_type_atsc, other._type_atsc)) {
+        fields |= TYPE_ATSC;
+    }
+    if (Differ(_name, other._name)) {
+        fields |= NAME;
+    }
+    if (Differ(_provider, other._provider)) {
+        fields |= PROVIDER;
+    }
+    if (Differ(_eits_present, other._eits_present)) {
+        fields |= EITS;
+    }
+    if (Differ(_eitpf_present, other._eitpf_present)) {
+        fields |= EITPF;
+    }
+    if (Differ(_ca_controlled, other._ca_controlled)) {
+        fields |= CA;
+    }
+    if (Differ(_running_status, other._running_status)) {
+        fields |= RUNNING;
+    }
+    if (Differ(_major_id_atsc, other._major_id_atsc)) {
+        fields |= MAJORID_ATSC;
+    }
+    if (Differ(_minor_id_atsc, other._minor_id_atsc)) {
+        fields |= MINORID_ATSC;
+    }
+    return fields;
+}
+
+
 //----------------------------------------------------------------------------
 // Implementation of StringifyInterface.
 //----------------------------------------------------------------------------
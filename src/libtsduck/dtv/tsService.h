@@ -198,6 +198,16 @@ namespace ts {
         //!
         uint32_t getFields() const;
 
+        //!
+        //! Compare the fields of two Service objects.
+        //! A field differs when it is set in only one of the two objects
+        //! or when it is set in both objects with distinct values.
+        //! @param [in] other Other instance to compare.
+        //! @return The list of fields which differ between this object and
+        //! @a other as an or'ed mask of ServiceField values.
+        //!
+        uint32_t diffFields(const Service& other) const;
+
         //!
         //! Sorting criterion method, used by std::sort().
         //! Sort order: LCN, ONId, TSId, Id, name, provider, type, PMT PID.
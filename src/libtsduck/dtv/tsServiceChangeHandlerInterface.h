@@ -0,0 +1,68 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Service change handler interface.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+
+    class ServiceDiscovery;
+
+    //!
+    //! Service change handler interface.
+    //! @ingroup mpeg
+    //!
+    //! This abstract interface must be implemented by classes which need to be
+    //! notified of changes in a service description by a ServiceDiscovery.
+    //! The handler receives a mask of the fields which actually changed, so
+    //! that the application can react only to what it is interested in.
+    //! The default implementation of the handler is to do nothing.
+    //!
+    class TSDUCKDLL ServiceChangeHandlerInterface
+    {
+    public:
+        //!
+        //! This hook is invoked when the description of the service changed.
+        //! @param [in,out] service The service discovery object which changed.
+        //! @param [in] changes The list of fields which changed, an or'ed mask of
+        //! Service::ServiceField and ServiceDiscovery::PMTChange values.
+        //!
+        virtual void handleServiceChange(ServiceDiscovery& service, uint32_t changes);
+
+        //!
+        //! Virtual destructor.
+        //!
+        virtual ~ServiceChangeHandlerInterface();
+    };
+}
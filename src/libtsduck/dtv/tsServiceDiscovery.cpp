@@ -40,6 +40,8 @@ ts::ServiceDiscovery::ServiceDiscovery(DuckContext& duck, SignalizationHandlerIn
     _duck(duck),
     _notFound(false),
     _pmtHandler(pmtHandler),
+    _changeHandler(nullptr),
+    _pmt_changes(0),
     _pmt(),
     _demux(duck, this)
 {
@@ -105,6 +107,10 @@ void ts::ServiceDiscovery::clear()
 
 void ts::ServiceDiscovery::handleTable(SectionDemux& demux, const BinaryTable& table)
 {
+    // Snapshot the service fields to detect changes after processing the table.
+    const Service previous(*this);
+    _pmt_changes = 0;
+
     switch (table.tableId()) {
         case TID_PAT: {
             if (table.sourcePID() == PID_PAT) {
@@ -156,6 +162,14 @@ void ts::ServiceDiscovery::handleTable(SectionDemux& demux, const BinaryTable& t
             break;
         }
     }
+
+    // Notify the application of the fields which actually changed, if any.
+    if (_changeHandler != nullptr) {
+        const uint32_t changes = diffFields(previous) | _pmt_changes;
+        if (changes != 0) {
+            _changeHandler->handleServiceChange(*this, changes);
+        }
+    }
 }
 
 
@@ -364,6 +378,26 @@ void ts::ServiceDiscovery::processPAT(const PAT& pat)
 
 void ts::ServiceDiscovery::processPMT(const PMT& pmt, PID pid)
 {
+    // Compare with the previous PMT to report field-level changes.
+    if (!_pmt.isValid()) {
+        // First PMT for the service, everything is new.
+        _pmt_changes = PMT_COMPONENTS | PMT_UPDATE;
+    }
+    else {
+        // Compare the sets of elementary streams (PID and stream type).
+        bool same_streams = _pmt.streams.size() == pmt.streams.size();
+        for (auto it = pmt.streams.begin(); same_streams && it != pmt.streams.end(); ++it) {
+            const auto old_it = _pmt.streams.find(it->first);
+            same_streams = old_it != _pmt.streams.end() && old_it->second.stream_type == it->second.stream_type;
+        }
+        if (!same_streams) {
+            _pmt_changes |= PMT_COMPONENTS;
+        }
+        if (_pmt.version != pmt.version || _pmt.pcr_pid != pmt.pcr_pid) {
+            _pmt_changes |= PMT_UPDATE;
+        }
+    }
+
     // Store the new PMT.
     _pmt = pmt;
 
@@ -37,6 +37,7 @@
 #include "tsSectionDemux.h"
 #include "tsNullReport.h"
 #include "tsSignalizationHandlerInterface.h"
+#include "tsServiceChangeHandlerInterface.h"
 #include "tsPAT.h"
 #include "tsSDT.h"
 #include "tsMGT.h"
@@ -55,6 +56,17 @@ namespace ts {
     {
         TS_NOBUILD_NOCOPY(ServiceDiscovery);
     public:
+        //!
+        //! PMT-level change indicators.
+        //! These values complement Service::ServiceField in the change masks
+        //! which are reported to a ServiceChangeHandlerInterface. They use
+        //! distinct bits so that both sets of values can be or'ed together.
+        //!
+        enum PMTChange : uint32_t {
+            PMT_COMPONENTS = 0x00010000,  //!< The list of elementary streams changed (PID or stream type).
+            PMT_UPDATE     = 0x00020000,  //!< Another characteristic of the PMT changed (version, PCR PID, descriptors).
+        };
+
         //!
         //! Default constructor.
         //! @param [in,out] duck TSDuck execution context. The reference is kept inside the demux.
@@ -88,6 +100,14 @@ namespace ts {
         //!
         void setPMTHandler(SignalizationHandlerInterface* h) { _pmtHandler = h; }
 
+        //!
+        //! Replace the service change handler.
+        //! The handler is notified after each table which modifies the service
+        //! description, with the mask of fields which actually changed.
+        //! @param [in] h The new handler.
+        //!
+        void setServiceChangeHandler(ServiceChangeHandlerInterface* h) { _changeHandler = h; }
+
         //!
         //! Check if the PMT of the service is known.
         //! @return True if the PMT is present.
@@ -111,6 +131,8 @@ namespace ts {
         DuckContext& _duck;
         bool         _notFound;    // Set when service does not exist.
         SignalizationHandlerInterface* _pmtHandler;  // Handler to call for each new PMT.
+        ServiceChangeHandlerInterface* _changeHandler;  // Handler to call with field-level changes.
+        uint32_t     _pmt_changes; // PMTChange bits collected while processing a PMT.
         PMT          _pmt;         // Last valid PMT for the service.
         SectionDemux _demux;       // PSI demux for service discovery.
 
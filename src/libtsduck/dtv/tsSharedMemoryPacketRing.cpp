@@ -0,0 +1,364 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedMemoryPacketRing.h"
+#include "tsSysUtils.h"
+#include "tsNullReport.h"
+TSDUCK_SOURCE;
+
+// Magic number and layout version in the control block.
+#define RING_MAGIC   0x54535052  // "TSPR"
+#define RING_VERSION 1
+
+// The packet area starts at a page-aligned offset after the control block.
+#define RING_HEADER_SIZE 4096
+
+
+//----------------------------------------------------------------------------
+// Constructor / destructor
+//----------------------------------------------------------------------------
+
+ts::SharedMemoryPacketRing::SharedMemoryPacketRing() :
+    _name(),
+    _creator(false),
+    _size(0),
+    _map_size(0),
+    _header(nullptr),
+    _packets(nullptr),
+#if defined(TS_WINDOWS)
+    _handle(INVALID_HANDLE_VALUE)
+#else
+    _fd(-1)
+#endif
+{
+}
+
+ts::SharedMemoryPacketRing::~SharedMemoryPacketRing()
+{
+    close(NULLREP);
+}
+
+
+//----------------------------------------------------------------------------
+// Map the segment in our address space, common to create() and open().
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryPacketRing::map(size_t map_size, Report& report)
+{
+    void* base = nullptr;
+
+#if defined(TS_WINDOWS)
+    base = ::MapViewOfFile(_handle, FILE_MAP_WRITE, 0, 0, map_size);
+    if (base == nullptr) {
+        report.error(u"error mapping shared memory %s: %s", {_name, ErrorCodeMessage()});
+        return false;
+    }
+#else
+    base = ::mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (base == MAP_FAILED) {
+        report.error(u"error mapping shared memory %s: %s", {_name, ErrorCodeMessage()});
+        return false;
+    }
+#endif
+
+    _map_size = map_size;
+    _header = reinterpret_cast<Header*>(base);
+    _packets = reinterpret_cast<TSPacket*>(reinterpret_cast<uint8_t*>(base) + RING_HEADER_SIZE);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Create the shared memory segment and initialize the ring (producer side).
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryPacketRing::create(const UString& name, size_t packet_count, Report& report)
+{
+    if (isOpen()) {
+        report.error(u"shared memory ring is already open");
+        return false;
+    }
+    if (packet_count == 0) {
+        report.error(u"invalid shared memory ring size");
+        return false;
+    }
+
+    const size_t map_size = RING_HEADER_SIZE + packet_count * PKT_SIZE;
+
+#if defined(TS_WINDOWS)
+    // On Windows, a named file mapping backed by the page file.
+    _name = name;
+    _handle = ::CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, ::DWORD(uint64_t(map_size) >> 32), ::DWORD(map_size), _name.wc_str());
+    if (_handle == nullptr) {
+        _handle = INVALID_HANDLE_VALUE;
+        report.error(u"error creating shared memory %s: %s", {_name, ErrorCodeMessage()});
+        return false;
+    }
+#else
+    // On UNIX, a POSIX shared memory object. The name must start with a slash.
+    _name = name.startWith(u"/") ? name : u"/" + name;
+    _fd = ::shm_open(_name.toUTF8().c_str(), O_RDWR | O_CREAT, 0666);
+    if (_fd < 0) {
+        report.error(u"error creating shared memory %s: %s", {_name, ErrorCodeMessage()});
+        return false;
+    }
+    if (::ftruncate(_fd, off_t(map_size)) < 0) {
+        report.error(u"error resizing shared memory %s: %s", {_name, ErrorCodeMessage()});
+        ::close(_fd);
+        _fd = -1;
+        ::shm_unlink(_name.toUTF8().c_str());
+        return false;
+    }
+#endif
+
+    _creator = true;
+    if (!map(map_size, report)) {
+        close(NULLREP);
+        return false;
+    }
+
+    // Initialize the control block. The magic number is written last so that
+    // a consumer polling for the segment never sees a half-built ring.
+    _size = packet_count;
+    _header->version = RING_VERSION;
+    _header->ring_size = uint64_t(packet_count);
+    _header->read_index.store(0);
+    _header->write_index.store(0);
+    _header->end_of_stream.store(0);
+    std::atomic_thread_fence(std::memory_order_release);
+    _header->magic = RING_MAGIC;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Open an existing shared memory segment (consumer side).
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryPacketRing::open(const UString& name, Report& report)
+{
+    if (isOpen()) {
+        report.error(u"shared memory ring is already open");
+        return false;
+    }
+
+#if defined(TS_WINDOWS)
+    _name = name;
+    _handle = ::OpenFileMappingW(FILE_MAP_WRITE, FALSE, _name.wc_str());
+    if (_handle == nullptr) {
+        _handle = INVALID_HANDLE_VALUE;
+        report.debug(u"cannot open shared memory %s: %s", {_name, ErrorCodeMessage()});
+        return false;
+    }
+#else
+    _name = name.startWith(u"/") ? name : u"/" + name;
+    _fd = ::shm_open(_name.toUTF8().c_str(), O_RDWR, 0666);
+    if (_fd < 0) {
+        report.debug(u"cannot open shared memory %s: %s", {_name, ErrorCodeMessage()});
+        return false;
+    }
+    // Get the size of the segment as created by the producer.
+    struct stat st;
+    if (::fstat(_fd, &st) < 0) {
+        report.error(u"error checking shared memory %s: %s", {_name, ErrorCodeMessage()});
+        ::close(_fd);
+        _fd = -1;
+        return false;
+    }
+    if (size_t(st.st_size) <= RING_HEADER_SIZE) {
+        report.debug(u"shared memory %s not yet initialized", {_name});
+        ::close(_fd);
+        _fd = -1;
+        return false;
+    }
+#endif
+
+    _creator = false;
+
+#if defined(TS_WINDOWS)
+    // On Windows, map the control block first to get the ring size.
+    if (!map(RING_HEADER_SIZE, report)) {
+        close(NULLREP);
+        return false;
+    }
+    if (_header->magic != RING_MAGIC || _header->version != RING_VERSION) {
+        report.debug(u"shared memory %s not yet initialized", {_name});
+        close(NULLREP);
+        return false;
+    }
+    const size_t packet_count = size_t(_header->ring_size);
+    ::UnmapViewOfFile(_header);
+    _header = nullptr;
+    _packets = nullptr;
+    if (!map(RING_HEADER_SIZE + packet_count * PKT_SIZE, report)) {
+        close(NULLREP);
+        return false;
+    }
+#else
+    if (!map(size_t(st.st_size), report)) {
+        close(NULLREP);
+        return false;
+    }
+#endif
+
+    // Check that the producer completed the initialization.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (_header->magic != RING_MAGIC || _header->version != RING_VERSION) {
+        report.debug(u"shared memory %s not yet initialized", {_name});
+        close(NULLREP);
+        return false;
+    }
+    _size = size_t(_header->ring_size);
+    if (_size == 0 || RING_HEADER_SIZE + _size * PKT_SIZE > _map_size) {
+        report.error(u"invalid shared memory ring %s", {_name});
+        close(NULLREP);
+        return false;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Write TS packets into the ring (producer side), without blocking.
+//----------------------------------------------------------------------------
+
+size_t ts::SharedMemoryPacketRing::writePackets(const TSPacket* buffer, size_t packet_count)
+{
+    if (_header == nullptr) {
+        return 0;
+    }
+
+    // The indexes are free-running packet counts, the used size never exceeds the ring size.
+    const uint64_t rd = _header->read_index.load(std::memory_order_acquire);
+    const uint64_t wr = _header->write_index.load(std::memory_order_relaxed);
+    assert(wr - rd <= uint64_t(_size));
+    packet_count = std::min(packet_count, _size - size_t(wr - rd));
+
+    // Copy in at most two contiguous chunks around the end of the ring.
+    const size_t start = size_t(wr % uint64_t(_size));
+    const size_t chunk = std::min(packet_count, _size - start);
+    TSPacket::Copy(_packets + start, buffer, chunk);
+    if (packet_count > chunk) {
+        TSPacket::Copy(_packets, buffer + chunk, packet_count - chunk);
+    }
+
+    // Publish the packets to the consumer.
+    _header->write_index.store(wr + packet_count, std::memory_order_release);
+    return packet_count;
+}
+
+
+//----------------------------------------------------------------------------
+// Read TS packets from the ring (consumer side), without blocking.
+//----------------------------------------------------------------------------
+
+size_t ts::SharedMemoryPacketRing::readPackets(TSPacket* buffer, size_t max_count)
+{
+    if (_header == nullptr) {
+        return 0;
+    }
+
+    const uint64_t wr = _header->write_index.load(std::memory_order_acquire);
+    const uint64_t rd = _header->read_index.load(std::memory_order_relaxed);
+    assert(wr - rd <= uint64_t(_size));
+    max_count = std::min(max_count, size_t(wr - rd));
+
+    const size_t start = size_t(rd % uint64_t(_size));
+    const size_t chunk = std::min(max_count, _size - start);
+    TSPacket::Copy(buffer, _packets + start, chunk);
+    if (max_count > chunk) {
+        TSPacket::Copy(buffer + chunk, _packets, max_count - chunk);
+    }
+
+    // Release the ring slots to the producer.
+    _header->read_index.store(rd + max_count, std::memory_order_release);
+    return max_count;
+}
+
+
+//----------------------------------------------------------------------------
+// End of stream handling.
+//----------------------------------------------------------------------------
+
+void ts::SharedMemoryPacketRing::setEndOfStream()
+{
+    if (_header != nullptr) {
+        _header->end_of_stream.store(1, std::memory_order_release);
+    }
+}
+
+bool ts::SharedMemoryPacketRing::endOfStream() const
+{
+    return _header != nullptr &&
+        _header->end_of_stream.load(std::memory_order_acquire) != 0 &&
+        _header->write_index.load(std::memory_order_acquire) == _header->read_index.load(std::memory_order_relaxed);
+}
+
+
+//----------------------------------------------------------------------------
+// Close the ring, unmap the shared memory.
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemoryPacketRing::close(Report& report)
+{
+    bool result = true;
+
+#if defined(TS_WINDOWS)
+    if (_header != nullptr && ::UnmapViewOfFile(_header) == 0) {
+        report.error(u"error unmapping shared memory %s: %s", {_name, ErrorCodeMessage()});
+        result = false;
+    }
+    if (_handle != INVALID_HANDLE_VALUE) {
+        ::CloseHandle(_handle);
+        _handle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (_header != nullptr && ::munmap(_header, _map_size) < 0) {
+        report.error(u"error unmapping shared memory %s: %s", {_name, ErrorCodeMessage()});
+        result = false;
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+    // The creator removes the segment name from the system. The mapping
+    // remains valid in the consumer until it unmaps it.
+    if (_creator && !_name.empty() && ::shm_unlink(_name.toUTF8().c_str()) < 0) {
+        report.error(u"error removing shared memory %s: %s", {_name, ErrorCodeMessage()});
+        result = false;
+    }
+#endif
+
+    _creator = false;
+    _size = 0;
+    _map_size = 0;
+    _header = nullptr;
+    _packets = nullptr;
+    return result;
+}
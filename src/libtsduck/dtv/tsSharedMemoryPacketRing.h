@@ -0,0 +1,163 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Ring buffer of TS packets in shared memory, between two processes.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+#include "tsUString.h"
+#include "tsReport.h"
+
+namespace ts {
+    //!
+    //! Ring buffer of TS packets in shared memory, between two processes.
+    //! @ingroup mpeg
+    //!
+    //! One process creates the ring in a named shared memory segment and
+    //! writes packets into it, another process opens the same segment by
+    //! name and reads the packets. The hand-off is lock-free: a single
+    //! producer and a single consumer synchronize through atomic read and
+    //! write indexes in the shared segment, without any system call on
+    //! the data path. Read and write operations are non-blocking, the
+    //! caller decides how to wait when the ring is full or empty.
+    //!
+    class TSDUCKDLL SharedMemoryPacketRing
+    {
+        TS_NOCOPY(SharedMemoryPacketRing);
+    public:
+        //!
+        //! Default constructor.
+        //!
+        SharedMemoryPacketRing();
+
+        //!
+        //! Destructor.
+        //!
+        ~SharedMemoryPacketRing();
+
+        //!
+        //! Create the shared memory segment and initialize the ring (producer side).
+        //! @param [in] name Name of the shared memory segment.
+        //! @param [in] packet_count Size of the ring in TS packets.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool create(const UString& name, size_t packet_count, Report& report);
+
+        //!
+        //! Open an existing shared memory segment (consumer side).
+        //! Fail if the segment does not exist or is not yet initialized.
+        //! @param [in] name Name of the shared memory segment.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(const UString& name, Report& report);
+
+        //!
+        //! Check if the ring is open.
+        //! @return True if the ring is open.
+        //!
+        bool isOpen() const { return _header != nullptr; }
+
+        //!
+        //! Get the size of the ring.
+        //! @return The size of the ring in TS packets.
+        //!
+        size_t ringSize() const { return _size; }
+
+        //!
+        //! Write TS packets into the ring (producer side), without blocking.
+        //! @param [in] buffer Address of the packets to write.
+        //! @param [in] packet_count Number of packets to write.
+        //! @return Number of packets actually written, less than
+        //! @a packet_count when the ring is full.
+        //!
+        size_t writePackets(const TSPacket* buffer, size_t packet_count);
+
+        //!
+        //! Read TS packets from the ring (consumer side), without blocking.
+        //! @param [out] buffer Address of the buffer for the incoming packets.
+        //! @param [in] max_count Maximum number of packets to read.
+        //! @return Number of packets actually read, zero when the ring is empty.
+        //!
+        size_t readPackets(TSPacket* buffer, size_t max_count);
+
+        //!
+        //! Signal the end of stream (producer side).
+        //! The consumer still reads the remaining packets in the ring.
+        //!
+        void setEndOfStream();
+
+        //!
+        //! Check if the end of stream is reached (consumer side).
+        //! @return True when the producer signaled the end of stream and
+        //! all packets in the ring have been read.
+        //!
+        bool endOfStream() const;
+
+        //!
+        //! Close the ring, unmap the shared memory.
+        //! The creator of the segment also removes it from the system.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool close(Report& report);
+
+    private:
+        // Layout of the control block at the beginning of the shared segment.
+        // The packets are stored after the control block, at a page-aligned offset.
+        struct Header
+        {
+            uint32_t magic;                      // Magic number, the segment is initialized.
+            uint32_t version;                    // Layout version.
+            uint64_t ring_size;                  // Size of the ring in packets.
+            std::atomic<uint64_t> read_index;    // Total number of packets read (free-running).
+            std::atomic<uint64_t> write_index;   // Total number of packets written (free-running).
+            std::atomic<uint32_t> end_of_stream; // The producer terminated.
+        };
+
+        UString   _name;      // System name of the shared memory segment.
+        bool      _creator;   // This instance created the segment.
+        size_t    _size;      // Size of the ring in packets.
+        size_t    _map_size;  // Total size of the mapping in bytes.
+        Header*   _header;    // Control block in shared memory.
+        TSPacket* _packets;   // Packet area in shared memory.
+#if defined(TS_WINDOWS)
+        ::HANDLE  _handle;    // File mapping handle.
+#else
+        int       _fd;        // Shared memory file descriptor.
+#endif
+
+        // Map the segment in our address space, common to create() and open().
+        bool map(size_t map_size, Report& report);
+    };
+}
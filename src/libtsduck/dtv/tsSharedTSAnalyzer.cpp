@@ -0,0 +1,102 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedTSAnalyzer.h"
+#include "tsGuard.h"
+#include "tsFatal.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Registry of named sessions.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    typedef std::map<ts::UString, ts::SharedTSAnalyzerPtr> SessionMap;
+
+    // The registry and its mutex are created on first use and never destructed
+    // so that sessions can still be released during process exit.
+    ts::Mutex& RegistryMutex()
+    {
+        static ts::Mutex* const mutex = new ts::Mutex;
+        return *mutex;
+    }
+
+    SessionMap& Registry()
+    {
+        static SessionMap* const sessions = new SessionMap;
+        return *sessions;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::SharedTSAnalyzer::SharedTSAnalyzer(DuckContext& duck) :
+    _mutex(),
+    _analyzer(duck),
+    _next_index(0)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Get or create a shared analysis session.
+//----------------------------------------------------------------------------
+
+ts::SharedTSAnalyzerPtr ts::SharedTSAnalyzer::Acquire(const UString& name, DuckContext& duck)
+{
+    Guard lock(RegistryMutex());
+    SharedTSAnalyzerPtr& session(Registry()[name]);
+    if (session.isNull()) {
+        session = new SharedTSAnalyzer(duck);
+        CheckNonNull(session.pointer());
+    }
+    return session;
+}
+
+
+//----------------------------------------------------------------------------
+// Feed the analyzer with one packet, at most once per stream position.
+//----------------------------------------------------------------------------
+
+bool ts::SharedTSAnalyzer::feedPacket(PacketCounter index, const TSPacket& pkt)
+{
+    Guard lock(_mutex);
+    if (index < _next_index) {
+        // This stream position was already fed by another subscriber.
+        return false;
+    }
+    _next_index = index + 1;
+    _analyzer.feedPacket(pkt);
+    return true;
+}
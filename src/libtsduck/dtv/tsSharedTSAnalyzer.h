@@ -0,0 +1,110 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  A transport stream analysis session which can be shared by several plugins.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSAnalyzerReport.h"
+#include "tsMutex.h"
+#include "tsSafePtr.h"
+
+namespace ts {
+
+    class SharedTSAnalyzer;
+
+    //!
+    //! Safe pointer for SharedTSAnalyzer (thread-safe).
+    //!
+    typedef SafePtr<SharedTSAnalyzer, Mutex> SharedTSAnalyzerPtr;
+
+    //!
+    //! A transport stream analysis session which can be shared by several plugins.
+    //! @ingroup mpeg
+    //!
+    //! Several observer plugins in one processing chain often re-derive the same
+    //! per-PID state from identical packets. A shared session deduplicates this
+    //! work: each subscriber submits the packets it sees together with their
+    //! index in the stream and only the first submission of a given index
+    //! reaches the analyzer, later submissions of the same position are ignored.
+    //! The packet indexes of the subscribers must be aligned, which is the case
+    //! in a plugin chain as long as no plugin in between drops packets.
+    //!
+    //! Subscribers access the analyzer state under the session mutex.
+    //!
+    class TSDUCKDLL SharedTSAnalyzer
+    {
+        TS_NOBUILD_NOCOPY(SharedTSAnalyzer);
+    public:
+        //!
+        //! Get or create a shared analysis session.
+        //! Sessions are identified by name: plugins using the same session name
+        //! in the same process share the same analyzer. Sessions remain alive
+        //! until the end of the process.
+        //! @param [in] name Session name.
+        //! @param [in,out] duck TSDuck execution context, used when the session is created.
+        //! @return A safe pointer to the session.
+        //!
+        static SharedTSAnalyzerPtr Acquire(const UString& name, DuckContext& duck);
+
+        //!
+        //! Feed the analyzer with one packet, at most once per stream position.
+        //! @param [in] index Index of the packet in the stream, for instance
+        //! TSP::pluginPackets() in a plugin.
+        //! @param [in] pkt The packet value.
+        //! @return True when the packet was analyzed, false when this stream
+        //! position was already fed by another subscriber.
+        //!
+        bool feedPacket(PacketCounter index, const TSPacket& pkt);
+
+        //!
+        //! Get a reference to the session mutex.
+        //! The mutex must be held while accessing the analyzer.
+        //! @return A reference to the session mutex.
+        //!
+        Mutex& mutex() { return _mutex; }
+
+        //!
+        //! Get a reference to the analyzer of the session.
+        //! The session mutex must be held while using it.
+        //! @return A reference to the shared analyzer.
+        //!
+        TSAnalyzerReport& analyzer() { return _analyzer; }
+
+    private:
+        // Sessions are created through Acquire() only.
+        SharedTSAnalyzer(DuckContext& duck);
+
+        Mutex            _mutex;       // Protect the analyzer and the feed position.
+        TSAnalyzerReport _analyzer;    // The shared analyzer.
+        PacketCounter    _next_index;  // Next stream position to accept.
+    };
+}
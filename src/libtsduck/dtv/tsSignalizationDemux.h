@@ -67,6 +67,13 @@ namespace ts {
         //!
         void feedPacket(const TSPacket& pkt) { _demux.feedPacket(pkt); }
 
+        //!
+        //! This method feeds the demux with a batch of contiguous TS packets.
+        //! @param [in] pkt Address of the first TS packet in the batch.
+        //! @param [in] count Number of TS packets in the batch.
+        //!
+        void feedPackets(const TSPacket* pkt, size_t count) { _demux.feedPackets(pkt, count); }
+
         //!
         //! Replace the signalization handler.
         //! @param [in] handler The new handler.
@@ -0,0 +1,263 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSignalizationState.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::SignalizationState::SignalizationState(DuckContext& duck, std::initializer_list<TID> tids) :
+    _duck(duck),
+    _demux(duck, this),
+    _subscribers(),
+    _initial_tids(tids),
+    _generation(0),
+    _pat(),
+    _cat(),
+    _sdt(),
+    _pmts()
+{
+    clearSnapshot();
+    for (auto it = _initial_tids.begin(); it != _initial_tids.end(); ++it) {
+        _demux.addTableId(*it);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Invalidate the snapshot.
+//----------------------------------------------------------------------------
+
+void ts::SignalizationState::clearSnapshot()
+{
+    _pat.invalidate();
+    _cat.invalidate();
+    _sdt.invalidate();
+    _pmts.clear();
+    _generation++;
+}
+
+
+//----------------------------------------------------------------------------
+// Reset the demux and the snapshot.
+//----------------------------------------------------------------------------
+
+void ts::SignalizationState::reset()
+{
+    _demux.reset();
+    clearSnapshot();
+    for (auto it = _initial_tids.begin(); it != _initial_tids.end(); ++it) {
+        _demux.addTableId(*it);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Subscription of the consumers.
+//----------------------------------------------------------------------------
+
+void ts::SignalizationState::subscribe(SignalizationHandlerInterface* handler)
+{
+    if (handler != nullptr && std::find(_subscribers.begin(), _subscribers.end(), handler) == _subscribers.end()) {
+        _subscribers.push_back(handler);
+    }
+}
+
+void ts::SignalizationState::unsubscribe(SignalizationHandlerInterface* handler)
+{
+    _subscribers.remove(handler);
+}
+
+
+//----------------------------------------------------------------------------
+// Access to the snapshot.
+//----------------------------------------------------------------------------
+
+bool ts::SignalizationState::getPMT(uint16_t service_id, PMT& pmt) const
+{
+    const auto it(_pmts.find(service_id));
+    if (it == _pmts.end()) {
+        return false;
+    }
+    else {
+        pmt = it->second;
+        return true;
+    }
+}
+
+void ts::SignalizationState::getServiceIds(std::set<uint16_t>& service_ids) const
+{
+    service_ids.clear();
+    for (auto it = _pmts.begin(); it != _pmts.end(); ++it) {
+        service_ids.insert(it->first);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Implementation of SignalizationHandlerInterface.
+// Update the snapshot when applicable, forward to the subscribers.
+// The subscribers are kept in a std::list, so subscribing from within a
+// handler is safe; unsubscribing from within a handler is not supported.
+//----------------------------------------------------------------------------
+
+void ts::SignalizationState::handlePAT(const PAT& table, PID pid)
+{
+    // Drop the PMT's of the services which are no longer in the PAT.
+    for (auto it = _pmts.begin(); it != _pmts.end(); ) {
+        if (table.pmts.find(it->first) == table.pmts.end()) {
+            it = _pmts.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    _pat = table;
+    _generation++;
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handlePAT(table, pid);
+    }
+}
+
+void ts::SignalizationState::handleCAT(const CAT& table, PID pid)
+{
+    _cat = table;
+    _generation++;
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handleCAT(table, pid);
+    }
+}
+
+void ts::SignalizationState::handlePMT(const PMT& table, PID pid)
+{
+    _pmts[table.service_id] = table;
+    _generation++;
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handlePMT(table, pid);
+    }
+}
+
+void ts::SignalizationState::handleSDT(const SDT& table, PID pid)
+{
+    // Only the SDT of the actual TS is part of the snapshot.
+    if (table.isActual()) {
+        _sdt = table;
+        _generation++;
+    }
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handleSDT(table, pid);
+    }
+}
+
+void ts::SignalizationState::handleTSDT(const TSDT& table, PID pid)
+{
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handleTSDT(table, pid);
+    }
+}
+
+void ts::SignalizationState::handleNIT(const NIT& table, PID pid)
+{
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handleNIT(table, pid);
+    }
+}
+
+void ts::SignalizationState::handleBAT(const BAT& table, PID pid)
+{
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handleBAT(table, pid);
+    }
+}
+
+void ts::SignalizationState::handleRST(const RST& table, PID pid)
+{
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handleRST(table, pid);
+    }
+}
+
+void ts::SignalizationState::handleTDT(const TDT& table, PID pid)
+{
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handleTDT(table, pid);
+    }
+}
+
+void ts::SignalizationState::handleTOT(const TOT& table, PID pid)
+{
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handleTOT(table, pid);
+    }
+}
+
+void ts::SignalizationState::handleMGT(const MGT& table, PID pid)
+{
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handleMGT(table, pid);
+    }
+}
+
+void ts::SignalizationState::handleVCT(const VCT& table, PID pid)
+{
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handleVCT(table, pid);
+    }
+}
+
+void ts::SignalizationState::handleCVCT(const CVCT& table, PID pid)
+{
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handleCVCT(table, pid);
+    }
+}
+
+void ts::SignalizationState::handleTVCT(const TVCT& table, PID pid)
+{
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handleTVCT(table, pid);
+    }
+}
+
+void ts::SignalizationState::handleRRT(const RRT& table, PID pid)
+{
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handleRRT(table, pid);
+    }
+}
+
+void ts::SignalizationState::handleSTT(const STT& table, PID pid)
+{
+    for (auto it = _subscribers.begin(); it != _subscribers.end(); ++it) {
+        (*it)->handleSTT(table, pid);
+    }
+}
@@ -0,0 +1,205 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Shared signalization state, one demux serving several consumers.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsSignalizationDemux.h"
+
+namespace ts {
+    //!
+    //! Shared signalization state, one demux serving several consumers.
+    //! @ingroup mpeg
+    //!
+    //! Several classes in the same application often need the same PSI/SI
+    //! tables. When each of them runs its own SectionDemux, the same PSI
+    //! packets are demuxed several times. A SignalizationState runs a single
+    //! SignalizationDemux, maintains a snapshot of the last received
+    //! PAT, CAT, SDT and PMT's and redistributes each new table to any
+    //! number of subscribers.
+    //!
+    //! The owner of the SignalizationState feeds it with the TS packets,
+    //! exactly once. The consumers either subscribe a
+    //! SignalizationHandlerInterface to be notified of each new table or
+    //! poll the snapshot. The snapshot has a generation number which is
+    //! incremented each time a table of the snapshot is updated, so a
+    //! consumer can cheaply detect that nothing changed.
+    //!
+    class TSDUCKDLL SignalizationState : private SignalizationHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(SignalizationState);
+    public:
+        //!
+        //! Constructor.
+        //! @param [in,out] duck TSDuck execution context. The reference is kept inside this object.
+        //! @param [in] tids The initial set of table ids to demux.
+        //! By default, demux the tables of the snapshot: PAT, CAT, all PMT's
+        //! and the SDT of the actual TS. More table ids can be added later,
+        //! they are redistributed to the subscribers but not part of the
+        //! snapshot.
+        //!
+        explicit SignalizationState(DuckContext& duck, std::initializer_list<TID> tids = {TID_PAT, TID_CAT, TID_PMT, TID_SDT_ACT});
+
+        //!
+        //! This method feeds the shared demux with a TS packet.
+        //! To be called by the owner of the state only, each packet shall be fed exactly once.
+        //! @param [in] pkt A TS packet.
+        //!
+        void feedPacket(const TSPacket& pkt) { _demux.feedPacket(pkt); }
+
+        //!
+        //! This method feeds the shared demux with a batch of contiguous TS packets.
+        //! To be called by the owner of the state only, each packet shall be fed exactly once.
+        //! @param [in] pkt Address of the first TS packet in the batch.
+        //! @param [in] count Number of TS packets in the batch.
+        //!
+        void feedPackets(const TSPacket* pkt, size_t count) { _demux.feedPackets(pkt, count); }
+
+        //!
+        //! Reset the demux and the snapshot.
+        //! The table ids to demux are restored to the initial set of the
+        //! constructor. The subscribers remain subscribed.
+        //!
+        void reset();
+
+        //!
+        //! Add a signalization table id to demux.
+        //! @param [in] tid The table id to add. Unsupported table ids are ignored.
+        //! @return True if the table id is filtered, false if this table id is not supported.
+        //!
+        bool addTableId(TID tid) { return _demux.addTableId(tid); }
+
+        //!
+        //! Subscribe a handler which is notified of each new table.
+        //! @param [in] handler The handler to subscribe. Subscribing an
+        //! already subscribed handler has no effect.
+        //!
+        void subscribe(SignalizationHandlerInterface* handler);
+
+        //!
+        //! Unsubscribe a previously subscribed handler.
+        //! @param [in] handler The handler to unsubscribe.
+        //!
+        void unsubscribe(SignalizationHandlerInterface* handler);
+
+        //!
+        //! Get the generation number of the snapshot.
+        //! The generation is incremented each time a table of the snapshot
+        //! (PAT, CAT, SDT actual, a PMT) is updated.
+        //! @return The current generation number.
+        //!
+        uint64_t generation() const { return _generation; }
+
+        //!
+        //! Check if a PAT has been received.
+        //! @return True if a PAT has been received, false otherwise.
+        //!
+        bool hasPAT() const { return _pat.isValid(); }
+
+        //!
+        //! Return a constant reference to the last PAT which has been received.
+        //! @return A constant reference to the last PAT.
+        //!
+        const PAT& lastPAT() const { return _pat; }
+
+        //!
+        //! Check if a CAT has been received.
+        //! @return True if a CAT has been received, false otherwise.
+        //!
+        bool hasCAT() const { return _cat.isValid(); }
+
+        //!
+        //! Return a constant reference to the last CAT which has been received.
+        //! @return A constant reference to the last CAT.
+        //!
+        const CAT& lastCAT() const { return _cat; }
+
+        //!
+        //! Check if an SDT for the actual TS has been received.
+        //! @return True if an SDT Actual has been received, false otherwise.
+        //!
+        bool hasSDT() const { return _sdt.isValid(); }
+
+        //!
+        //! Return a constant reference to the last SDT Actual which has been received.
+        //! @return A constant reference to the last SDT Actual.
+        //!
+        const SDT& lastSDT() const { return _sdt; }
+
+        //!
+        //! Get the last PMT of a service.
+        //! @param [in] service_id The service id to look for.
+        //! @param [out] pmt The last PMT of the service.
+        //! @return True if a PMT was received for this service, false otherwise.
+        //!
+        bool getPMT(uint16_t service_id, PMT& pmt) const;
+
+        //!
+        //! Get the ids of all services with a PMT in the snapshot.
+        //! @param [out] service_ids The set of service ids.
+        //!
+        void getServiceIds(std::set<uint16_t>& service_ids) const;
+
+    private:
+        DuckContext&       _duck;
+        SignalizationDemux _demux;
+        std::list<SignalizationHandlerInterface*> _subscribers;
+        std::set<TID>      _initial_tids;  // Table ids from the constructor, restored on reset().
+        uint64_t           _generation;    // Generation number of the snapshot.
+        PAT                _pat;           // Last received PAT.
+        CAT                _cat;           // Last received CAT.
+        SDT                _sdt;           // Last received SDT Actual.
+        std::map<uint16_t, PMT> _pmts;     // Last received PMT of each service.
+
+        // Invalidate the snapshot.
+        void clearSnapshot();
+
+        // Implementation of SignalizationHandlerInterface. Each hook updates
+        // the snapshot when applicable and forwards the table to the subscribers.
+        virtual void handlePAT(const PAT& table, PID pid) override;
+        virtual void handleCAT(const CAT& table, PID pid) override;
+        virtual void handlePMT(const PMT& table, PID pid) override;
+        virtual void handleTSDT(const TSDT& table, PID pid) override;
+        virtual void handleNIT(const NIT& table, PID pid) override;
+        virtual void handleSDT(const SDT& table, PID pid) override;
+        virtual void handleBAT(const BAT& table, PID pid) override;
+        virtual void handleRST(const RST& table, PID pid) override;
+        virtual void handleTDT(const TDT& table, PID pid) override;
+        virtual void handleTOT(const TOT& table, PID pid) override;
+        virtual void handleMGT(const MGT& table, PID pid) override;
+        virtual void handleVCT(const VCT& table, PID pid) override;
+        virtual void handleCVCT(const CVCT& table, PID pid) override;
+        virtual void handleTVCT(const TVCT& table, PID pid) override;
+        virtual void handleRRT(const RRT& table, PID pid) override;
+        virtual void handleSTT(const STT& table, PID pid) override;
+    };
+}
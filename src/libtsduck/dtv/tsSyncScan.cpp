@@ -0,0 +1,143 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSyncScan.h"
+TSDUCK_SOURCE;
+
+// Architecture-specific intrinsics for the vectorized scan. These headers are
+// conditional on the target instruction set, they cannot be centralized in
+// tsPlatform.h.
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+
+//----------------------------------------------------------------------------
+// Find the first occurrence of the TS sync byte in a raw buffer.
+//----------------------------------------------------------------------------
+
+size_t ts::FindSyncByte(const uint8_t* data, size_t size)
+{
+    const uint8_t* p = data;
+    const uint8_t* const end = data + size;
+
+#if defined(__SSE2__)
+
+    // Compare 16 bytes at a time, the comparison result is condensed in a
+    // 16-bit mask, one bit per byte.
+    const __m128i ref = _mm_set1_epi8(char(SYNC_BYTE));
+    while (end - p >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, ref));
+        if (mask != 0) {
+            return size_t(p - data) + size_t(__builtin_ctz(unsigned(mask)));
+        }
+        p += 16;
+    }
+
+#elif defined(__ARM_NEON)
+
+    // Compare 16 bytes at a time. The comparison result is reduced on two
+    // 64-bit lanes, a scalar scan locates the byte in a matching chunk.
+    const uint8x16_t ref = vdupq_n_u8(SYNC_BYTE);
+    while (end - p >= 16) {
+        const uint8x16_t eq = vceqq_u8(vld1q_u8(p), ref);
+        const uint64x2_t lanes = vreinterpretq_u64_u8(eq);
+        if (vgetq_lane_u64(lanes, 0) != 0 || vgetq_lane_u64(lanes, 1) != 0) {
+            break; // the sync byte is in this chunk, find it below.
+        }
+        p += 16;
+    }
+
+#endif
+
+    // Scalar scan of the remaining bytes.
+    while (p < end) {
+        if (*p == SYNC_BYTE) {
+            return size_t(p - data);
+        }
+        ++p;
+    }
+    return NPOS;
+}
+
+
+//----------------------------------------------------------------------------
+// Check that a raw buffer contains a cadence of TS packets.
+//----------------------------------------------------------------------------
+
+bool ts::CheckSyncCadence(const uint8_t* data, size_t size, size_t packet_size, size_t header_size)
+{
+    if (packet_size < header_size + PKT_SIZE || size < packet_size) {
+        return false;
+    }
+
+    // Check the sync byte of all complete packets.
+    const uint8_t* p = data + header_size;
+    const uint8_t* const end = data + size - packet_size + header_size + 1;
+    while (p < end) {
+        if (*p != SYNC_BYTE) {
+            return false;
+        }
+        p += packet_size;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Find the start of a cadence of TS packets in a raw buffer.
+//----------------------------------------------------------------------------
+
+size_t ts::FindPacketCadence(const uint8_t* data, size_t size, size_t window_size, size_t packet_size, size_t header_size)
+{
+    if (packet_size < header_size + PKT_SIZE || window_size > size || window_size < packet_size) {
+        return NPOS;
+    }
+
+    // Last acceptable index for the start of the cadence.
+    const size_t last = size - window_size;
+
+    // Jump from sync byte to sync byte, all other offsets cannot start a packet.
+    size_t index = 0;
+    while (index <= last) {
+        const size_t next = FindSyncByte(data + index + header_size, last - index + 1);
+        if (next == NPOS) {
+            return NPOS;
+        }
+        index += next;
+        if (CheckSyncCadence(data + index, window_size, packet_size, header_size)) {
+            return index;
+        }
+        index++;
+    }
+    return NPOS;
+}
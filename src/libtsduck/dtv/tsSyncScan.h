@@ -0,0 +1,81 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Fast scan for TS packet synchronization in raw buffers.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsMPEG.h"
+
+namespace ts {
+    //!
+    //! Find the first occurrence of the TS sync byte (0x47) in a raw buffer.
+    //! The scan is vectorized (SSE2 or NEON) when the target supports it,
+    //! 16 bytes are tested at a time.
+    //! @param [in] data Address of the buffer.
+    //! @param [in] size Size in bytes of the buffer.
+    //! @return Index of the first sync byte in the buffer or NPOS if there is none.
+    //! @ingroup mpeg
+    //!
+    TSDUCKDLL size_t FindSyncByte(const uint8_t* data, size_t size);
+
+    //!
+    //! Check that a raw buffer contains a cadence of TS packets.
+    //! A sync byte (0x47) is expected at offset @a header_size of each packet,
+    //! every @a packet_size bytes. Only complete packets are checked, trailing
+    //! bytes which do not fit in a packet are ignored.
+    //! @param [in] data Address of the buffer, on a packet boundary.
+    //! @param [in] size Size in bytes of the buffer.
+    //! @param [in] packet_size Size in bytes of each packet (at least 188 + @a header_size).
+    //! @param [in] header_size Size in bytes of an optional header before each packet
+    //! (for instance 4 for the M2TS timestamp).
+    //! @return True when a sync byte was found at the start of all complete packets.
+    //! @ingroup mpeg
+    //!
+    TSDUCKDLL bool CheckSyncCadence(const uint8_t* data, size_t size, size_t packet_size, size_t header_size = 0);
+
+    //!
+    //! Find the start of a cadence of TS packets in a raw buffer.
+    //! Locate the first index in the buffer such that a sync byte is found at the
+    //! start of all complete packets in the next @a window_size bytes. Candidate
+    //! positions are located with FindSyncByte(), all other offsets are skipped.
+    //! @param [in] data Address of the buffer.
+    //! @param [in] size Size in bytes of the buffer.
+    //! @param [in] window_size Number of bytes over which the packet cadence must
+    //! be verified. Must be less than or equal to @a size.
+    //! @param [in] packet_size Size in bytes of each packet (at least 188 + @a header_size).
+    //! @param [in] header_size Size in bytes of an optional header before each packet.
+    //! @return Index of the first byte of the packet cadence (the header when
+    //! @a header_size is not zero) or NPOS when no cadence was found.
+    //! @ingroup mpeg
+    //!
+    TSDUCKDLL size_t FindPacketCadence(const uint8_t* data, size_t size, size_t window_size, size_t packet_size, size_t header_size = 0);
+}
@@ -49,6 +49,7 @@ ts::T2MIDemux::PIDContext::PIDContext() :
     continuity(0),
     sync(false),
     t2mi(),
+    slab(),
     plps()
 {
 }
@@ -161,6 +162,14 @@ void ts::T2MIDemux::feedPacket(const TSPacket& pkt)
     }
 }
 
+void ts::T2MIDemux::feedPackets(const TSPacket* pkt, size_t count)
+{
+    // The qualified invocation avoids one virtual dispatch per packet.
+    for (size_t i = 0; i < count; ++i) {
+        T2MIDemux::feedPacket(pkt[i]);
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Reset PID context after lost of synchronization.
@@ -200,8 +209,20 @@ void ts::T2MIDemux::processT2MI(PID pid, PIDContext& pc)
                 break;
             }
 
-            // Build a T2-MI packet.
-            T2MIPacket pkt(pc.t2mi.data() + start, packet_size, pid);
+            // Build a T2-MI packet. The packet data buffer of the PID is
+            // reused when no previous packet still references it, avoiding
+            // one allocation per T2-MI packet.
+            ByteBlockPtr bb;
+            if (!pc.slab.isNull() && pc.slab.count() == 1) {
+                bb = pc.slab;
+                bb->copy(pc.t2mi.data() + start, packet_size);
+            }
+            else {
+                bb = new ByteBlock(pc.t2mi.data() + start, packet_size);
+                CheckNonNull(bb.pointer());
+                pc.slab = bb;
+            }
+            T2MIPacket pkt(bb, pid);
             if (pkt.isValid()) {
 
                 // Notify the application.
@@ -301,28 +322,61 @@ void ts::T2MIDemux::demuxTS(PID pid, PIDContext& pc, const T2MIPacket& pkt)
         data += syncd;
         dfl -= syncd;
 
-        // Process subsequent complete packets.
-        while (dfl >= PKT_SIZE - 1) {
-            plpp->ts.append(SYNC_BYTE);
-            plpp->ts.append(data, PKT_SIZE - 1);
-            data += PKT_SIZE - 1;
-            dfl -= PKT_SIZE - 1;
+        // Deliver the TS packets which were completed by the start of this data field.
+        flushStagedTS(*plpp, pkt);
+
+        if (plpp->ts.empty()) {
+            // The staging buffer is fully consumed, the common case on an
+            // undisturbed stream. Rebuild complete packets directly from the
+            // baseband frame, without the intermediate copy in the staging
+            // buffer.
+            TSPacket tsPkt;
+            tsPkt.b[0] = SYNC_BYTE;
+            while (dfl >= PKT_SIZE - 1) {
+                ::memcpy(tsPkt.b + 1, data, PKT_SIZE - 1);
+                if (_handler != nullptr) {
+                    _handler->handleTSPacket(*this, pkt, tsPkt);
+                }
+                data += PKT_SIZE - 1;
+                dfl -= PKT_SIZE - 1;
+            }
+        }
+        else {
+            // An incomplete packet remains in the staging buffer (anomalous
+            // synchronization distance), keep accumulating behind it.
+            while (dfl >= PKT_SIZE - 1) {
+                plpp->ts.append(SYNC_BYTE);
+                plpp->ts.append(data, PKT_SIZE - 1);
+                data += PKT_SIZE - 1;
+                dfl -= PKT_SIZE - 1;
+            }
         }
 
-        // Process optional trailing truncated packet.
+        // Stage the optional trailing truncated packet.
         if (dfl > 0) {
             plpp->ts.append(SYNC_BYTE);
             plpp->ts.append(data, dfl);
         }
     }
 
-    // Now process each complete TS packet.
-    while (plpp->ts_next + PKT_SIZE <= plpp->ts.size()) {
+    // Deliver the TS packets which are now complete in the staging buffer.
+    flushStagedTS(*plpp, pkt);
+}
+
+
+//----------------------------------------------------------------------------
+// Deliver the complete TS packets from the staging buffer of a PLP.
+//----------------------------------------------------------------------------
+
+void ts::T2MIDemux::flushStagedTS(PLPContext& plp, const T2MIPacket& pkt)
+{
+    // Process each complete TS packet in the buffer.
+    while (plp.ts_next + PKT_SIZE <= plp.ts.size()) {
 
         // Build the TS packet.
         TSPacket tsPkt;
-        ::memcpy(tsPkt.b, &plpp->ts[plpp->ts_next], PKT_SIZE);
-        plpp->ts_next += PKT_SIZE;
+        ::memcpy(tsPkt.b, &plp.ts[plp.ts_next], PKT_SIZE);
+        plp.ts_next += PKT_SIZE;
 
         // Notify the application. Note that we are already in a protected section.
         if (_handler != nullptr) {
@@ -331,15 +385,15 @@ void ts::T2MIDemux::demuxTS(PID pid, PIDContext& pc, const T2MIPacket& pkt)
     }
 
     // Compress or cleanup the TS buffer.
-    if (plpp->ts_next >= plpp->ts.size()) {
+    if (plp.ts_next >= plp.ts.size()) {
         // No more packet to output, cleanup.
-        plpp->ts.clear();
-        plpp->ts_next = 0;
+        plp.ts.clear();
+        plp.ts_next = 0;
     }
-    else if (plpp->ts_next >= 100 * PKT_SIZE) {
+    else if (plp.ts_next >= 100 * PKT_SIZE) {
         // TS buffer has many unused packets, compress it.
-        plpp->ts.erase(0, plpp->ts_next);
-        plpp->ts_next = 0;
+        plp.ts.erase(0, plp.ts_next);
+        plp.ts_next = 0;
     }
 }
 
@@ -77,6 +77,7 @@ namespace ts {
 
         // Inherited methods from AbstractDemux.
         virtual void feedPacket(const TSPacket& pkt) override;
+        virtual void feedPackets(const TSPacket* pkt, size_t count) override;
 
         //!
         //! Replace the T2-MI handler.
@@ -114,6 +115,7 @@ namespace ts {
             uint8_t       continuity;  // Last continuity counter
             bool          sync;        // We are synchronous in this PID
             ByteBlock     t2mi;        // Buffer containing the T2-MI data.
+            ByteBlockPtr  slab;        // Recycled data buffer for T2-MI packets, reused when unreferenced.
             PLPContextMap plps;        // Map of PLP context per PID.
 
             // Default constructor
@@ -136,6 +138,10 @@ namespace ts {
         // Demux all encapsulated TS packets from a T2-MI packet.
         void demuxTS(PID pid, PIDContext& pc, const T2MIPacket& pkt);
 
+        // Deliver the complete TS packets from the staging buffer of a PLP
+        // and compress or cleanup the buffer.
+        void flushStagedTS(PLPContext& plp, const T2MIPacket& pkt);
+
         // Process a PMT.
         void processPMT(const PMT& pmt);
 
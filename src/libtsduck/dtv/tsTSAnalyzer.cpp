@@ -89,6 +89,7 @@ ts::TSAnalyzer::TSAnalyzer(DuckContext& duck, BitRate bitrate_hint) :
     _pids(),
     _services(),
     _modified(false),
+    _counters_modified(false),
     _ts_bitrate_sum(0),
     _ts_bitrate_cnt(0),
     _preceding_errors(0),
@@ -120,6 +121,7 @@ ts::TSAnalyzer::~TSAnalyzer()
 void ts::TSAnalyzer::reset()
 {
     _modified = false;
+    _counters_modified = false;
     _ts_id = 0;
     _ts_id_valid = false;
     _ts_pkt_cnt = 0;
@@ -604,6 +606,10 @@ void ts::TSAnalyzer::handleTable(SectionDemux&, const BinaryTable& table)
     const PID pid = table.sourcePID();
     const TID tid = table.tableId();
 
+    // Tables may modify the classification of PID's (references, services).
+    // The aggregated counters must be fully rebuilt on next report.
+    _modified = true;
+
     // Trace all table ids to identify missing tables
     _tid_present.set(tid);
 
@@ -1367,6 +1373,9 @@ void ts::TSAnalyzer::handleNewAVCAttributes(PESDemux&, const PESPacket& pkt, con
 
 void ts::TSAnalyzer::handleT2MINewPID(T2MIDemux& demux, const PMT& pmt, PID pid, const T2MIDescriptor& desc)
 {
+    // The classification of the PID changes, rebuild the aggregated counters.
+    _modified = true;
+
     // Identify this service as T2-MI, if not yet identified.
     ServiceContextPtr svp(getService(pmt.service_id));
     svp->carry_t2mi = true;
@@ -1436,8 +1445,10 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
         _first_local = Time::CurrentLocalTime();
     }
 
-    // Each new packet leads to various modifications
-    _modified = true;
+    // Each new packet modifies the counters. The aggregated counters are
+    // incrementally maintained below; the derived ratios (bitrates, crypto
+    // periods) are refreshed on next call to recomputeStatistics().
+    _counters_modified = true;
 
     // Count TS packets
     _ts_pkt_cnt++;
@@ -1483,6 +1494,33 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
     PIDContextPtr ps(getPID(pkt.getPID()));
     ps->ts_pkt_cnt++;
 
+    // Incrementally update the aggregated packet counters, based on the
+    // current classification of the PID. When the classification changes
+    // (first packet of a PID, new reference from a table, scrambling), the
+    // _modified flag is set and the next recomputeStatistics() rebuilds all
+    // aggregated counters from the per-PID counters, after which the
+    // incremental updates restart from a consistent state.
+    if (ps->ts_pkt_cnt == 1) {
+        // First packet of this PID, the counts of PID's change.
+        _modified = true;
+    }
+    if (ps->services.empty()) {
+        if (ps->referenced) {
+            _global_pkt_cnt++;
+        }
+        if (ps->pid <= PID_DVB_LAST) {
+            _psisi_pkt_cnt++;
+        }
+    }
+    else {
+        for (ServiceIdSet::const_iterator it = ps->services.begin(); it != ps->services.end(); ++it) {
+            getService(*it)->ts_pkt_cnt++;
+        }
+    }
+    if (!ps->referenced) {
+        _unref_pkt_cnt++;
+    }
+
     // Accumulate stat from packet
     if (pkt.hasAF()) {
         ps->ts_af_cnt++;
@@ -1498,6 +1536,8 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
     if (pkt.getScrambling() != SC_CLEAR && !ps->scrambled) {
         ps->scrambled = true;
         _scrambled_pid_cnt++;
+        // The classification of the PID changes, rebuild the aggregated counters.
+        _modified = true;
     }
     if (pkt.getScrambling() == SC_DVB_RESERVED) {
         ps->inv_ts_sc_cnt++;
@@ -1637,7 +1677,8 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
 void ts::TSAnalyzer::setBitrateHint(BitRate bitrate)
 {
     _ts_user_bitrate = bitrate;
-    _modified = true;
+    // Only the derived bitrates change, no need to rebuild the aggregated counters.
+    _counters_modified = true;
 }
 
 
@@ -1648,7 +1689,7 @@ void ts::TSAnalyzer::setBitrateHint(BitRate bitrate)
 void ts::TSAnalyzer::recomputeStatistics()
 {
     // Don't do anything if not necessary
-    if (!_modified) {
+    if (!_modified && !_counters_modified) {
         return;
     }
 
@@ -1662,25 +1703,85 @@ void ts::TSAnalyzer::recomputeStatistics()
     _ts_bitrate = _ts_user_bitrate != 0 ? _ts_user_bitrate : _ts_pcr_bitrate_188;
     _duration = _ts_bitrate == 0 ? 0 : (8000 * PKT_SIZE * uint64_t(_ts_pkt_cnt)) / _ts_bitrate;
 
-    // Reinitialize all service information that will be updated PID by PID
-    for (ServiceContextMap::iterator it = _services.begin(); it != _services.end(); ++it) {
-        it->second->pid_cnt = 0;
-        it->second->ts_pkt_cnt = 0;
-        it->second->scrambled_pid_cnt = 0;
-    }
+    // Rebuild the aggregated counters only when the structure of the analysis
+    // was modified (new PID, new reference, scrambling change). When only
+    // packet counters were updated, the aggregated counters were already
+    // incrementally maintained on the packet path (see feedPacket()).
+    if (_modified) {
+
+        // Reinitialize all service information that will be updated PID by PID
+        for (ServiceContextMap::iterator it = _services.begin(); it != _services.end(); ++it) {
+            it->second->pid_cnt = 0;
+            it->second->ts_pkt_cnt = 0;
+            it->second->scrambled_pid_cnt = 0;
+        }
 
-    // Complete all PID information
+        // Complete all PID information
+
+        _pid_cnt = 0;
+        _global_pid_cnt = 0;
+        _global_pkt_cnt = 0;
+        _global_scr_pids = 0;
+        _psisi_pid_cnt = 0;
+        _psisi_pkt_cnt = 0;
+        _psisi_scr_pids = 0;
+        _unref_pid_cnt = 0;
+        _unref_pkt_cnt = 0;
+        _unref_scr_pids = 0;
+
+        for (PIDContextMap::iterator pci = _pids.begin(); pci != _pids.end(); ++pci) {
+            PIDContext& pc(*pci->second);
+
+            // If the PID belongs to some services, update services info.
+            for (ServiceIdSet::iterator it = pc.services.begin(); it != pc.services.end(); ++it) {
+                ServiceContextPtr scp(getService(*it));
+                scp->pid_cnt++;
+                scp->ts_pkt_cnt += pc.ts_pkt_cnt;
+                if (pc.scrambled) {
+                    scp->scrambled_pid_cnt++;
+                }
+            }
 
-    _pid_cnt = 0;
-    _global_pid_cnt = 0;
-    _global_pkt_cnt = 0;
-    _global_scr_pids = 0;
-    _psisi_pid_cnt = 0;
-    _psisi_pkt_cnt = 0;
-    _psisi_scr_pids = 0;
-    _unref_pid_cnt = 0;
-    _unref_pkt_cnt = 0;
-    _unref_scr_pids = 0;
+            // Enforce PES when carrying audio or video
+            pc.carry_pes = pc.carry_pes || pc.carry_audio || pc.carry_video;
+
+            // Count non-empty PID's
+            if (pc.ts_pkt_cnt != 0) {
+                _pid_cnt++;
+            }
+
+            // Count unreferenced PID's
+            if (!pc.referenced && pc.ts_pkt_cnt != 0) {
+                _unref_pid_cnt++;
+                _unref_pkt_cnt += pc.ts_pkt_cnt;
+                if (pc.scrambled) {
+                    _unref_scr_pids++;
+                }
+            }
+
+            // Count global PID's
+            if (pc.referenced && pc.services.size() == 0 && pc.ts_pkt_cnt != 0) {
+                _global_pid_cnt++;
+                _global_pkt_cnt += pc.ts_pkt_cnt;
+                if (pc.scrambled) {
+                    _global_scr_pids++;
+                }
+            }
+
+            // Count global PSI/SI PID's
+            if (pc.pid <= PID_DVB_LAST && pc.services.size() == 0 && pc.ts_pkt_cnt != 0) {
+                _psisi_pid_cnt++;
+                _psisi_pkt_cnt += pc.ts_pkt_cnt;
+                if (pc.scrambled) {
+                    _psisi_scr_pids++;
+                }
+            }
+        }
+    }
+
+    // The values below are ratios involving the TS bitrate and the total
+    // packet count. They change with each packet and are refreshed on each
+    // pass, whether the aggregated counters were rebuilt or not.
 
     for (PIDContextMap::iterator pci = _pids.begin(); pci != _pids.end(); ++pci) {
         PIDContext& pc(*pci->second);
@@ -1700,51 +1801,6 @@ void ts::TSAnalyzer::recomputeStatistics()
         if (pc.cryptop_cnt > 1) {
             pc.crypto_period = pc.cryptop_ts_cnt / (pc.cryptop_cnt - 1);
         }
-
-        // If the PID belongs to some services, update services info.
-        for (ServiceIdSet::iterator it = pc.services.begin(); it != pc.services.end(); ++it) {
-            ServiceContextPtr scp(getService(*it));
-            scp->pid_cnt++;
-            scp->ts_pkt_cnt += pc.ts_pkt_cnt;
-            if (pc.scrambled) {
-                scp->scrambled_pid_cnt++;
-            }
-        }
-
-        // Enforce PES when carrying audio or video
-        pc.carry_pes = pc.carry_pes || pc.carry_audio || pc.carry_video;
-
-        // Count non-empty PID's
-        if (pc.ts_pkt_cnt != 0) {
-            _pid_cnt++;
-        }
-
-        // Count unreferenced PID's
-        if (!pc.referenced && pc.ts_pkt_cnt != 0) {
-            _unref_pid_cnt++;
-            _unref_pkt_cnt += pc.ts_pkt_cnt;
-            if (pc.scrambled) {
-                _unref_scr_pids++;
-            }
-        }
-
-        // Count global PID's
-        if (pc.referenced && pc.services.size() == 0 && pc.ts_pkt_cnt != 0) {
-            _global_pid_cnt++;
-            _global_pkt_cnt += pc.ts_pkt_cnt;
-            if (pc.scrambled) {
-                _global_scr_pids++;
-            }
-        }
-
-        // Count global PSI/SI PID's
-        if (pc.pid <= PID_DVB_LAST && pc.services.size() == 0 && pc.ts_pkt_cnt != 0) {
-            _psisi_pid_cnt++;
-            _psisi_pkt_cnt += pc.ts_pkt_cnt;
-            if (pc.scrambled) {
-                _psisi_scr_pids++;
-            }
-        }
     }
 
     // Complete unreferenced and global PID's bitrates
@@ -1775,6 +1831,7 @@ void ts::TSAnalyzer::recomputeStatistics()
 
     // Don't redo this unless the analyzer is modified
     _modified = false;
+    _counters_modified = false;
 }
 
 
@@ -510,7 +510,8 @@ namespace ts {
         virtual void handleTSPacket(T2MIDemux& demux, const T2MIPacket& t2mi, const TSPacket& ts) override;
 
         // TSAnalyzer private members (state data, used during analysis):
-        bool              _modified;                  // Internal data modified, need recomputeStatistics
+        bool              _modified;                  // Structure modified (PID, reference, scrambling), need a full recomputeStatistics
+        bool              _counters_modified;         // Only packet counters modified, derived ratios need a refresh
         uint64_t          _ts_bitrate_sum;            // Sum of all computed TS bitrates
         uint64_t          _ts_bitrate_cnt;            // Number of computed TS bitrates
         uint64_t          _preceding_errors;          // Number of contiguous invalid packets before current packet
@@ -157,21 +157,23 @@ void ts::TSAnalyzerReport::report(std::ostream& stm, const TSAnalyzerOptions& op
     Grid grid(stm);
     grid.setLineWidth(opt.wide ? WIDE_WIDTH : DEF_WIDTH, 2);
 
-    if (opt.ts_analysis) {
+    // Each section checks the stream state first: when the consumer stopped
+    // reading (broken pipe), do not pay for the generation of the next sections.
+    if (opt.ts_analysis && stm) {
         reportTS(grid, opt.title);
     }
-    if (opt.service_analysis) {
+    if (opt.service_analysis && stm) {
         reportServices(grid, opt.title);
     }
-    if (opt.pid_analysis) {
+    if (opt.pid_analysis && stm) {
         reportPIDs(grid, opt.title);
     }
-    if (opt.table_analysis) {
+    if (opt.table_analysis && stm) {
         reportTables(grid, opt.title);
     }
 
     // Error reports in free format.
-    if (opt.error_analysis) {
+    if (opt.error_analysis && stm) {
         reportErrors(stm, opt.title);
     }
 
@@ -179,6 +181,11 @@ void ts::TSAnalyzerReport::report(std::ostream& stm, const TSAnalyzerOptions& op
     if (opt.normalized) {
         reportNormalized(stm, opt.title);
     }
+
+    // JSON report.
+    if (opt.json) {
+        reportJSON(stm, opt.title);
+    }
 }
 
 
@@ -392,7 +399,7 @@ void ts::TSAnalyzerReport::reportServices(Grid& grid, const UString& title)
 
     // Display list of services
 
-    for (ServiceContextMap::const_iterator it = _services.begin(); it != _services.end(); ++it) {
+    for (ServiceContextMap::const_iterator it = _services.begin(); it != _services.end() && grid.stream(); ++it) {
 
         const ServiceContext& sv(*it->second);
         grid.section();
@@ -449,8 +456,8 @@ void ts::TSAnalyzerReport::reportPIDs(Grid& grid, const UString& title)
     grid.openTable();
     grid.putLine(u"PIDS ANALYSIS REPORT", title);
 
-    // Loop on all analyzed PID's.
-    for (PIDContextMap::const_iterator it = _pids.begin(); it != _pids.end(); ++it) {
+    // Loop on all analyzed PID's, as long as the consumer reads the report.
+    for (PIDContextMap::const_iterator it = _pids.begin(); it != _pids.end() && grid.stream(); ++it) {
 
         // Get PID description, ignore if no packet was found.
         // A PID can be declared, in a PMT for instance, but has no traffic on it.
@@ -556,8 +563,8 @@ void ts::TSAnalyzerReport::reportTables(Grid& grid, const UString& title)
     grid.openTable();
     grid.putLine(u"TABLES & SECTIONS ANALYSIS REPORT", title);
 
-    // Loop on all PID's
-    for (PIDContextMap::const_iterator pci = _pids.begin(); pci != _pids.end(); ++pci) {
+    // Loop on all PID's, as long as the consumer reads the report.
+    for (PIDContextMap::const_iterator pci = _pids.begin(); pci != _pids.end() && grid.stream(); ++pci) {
 
         // Get PID description, ignore if PID without sections
         const PIDContext& pc(*pci->second);
@@ -1055,3 +1062,178 @@ void ts::TSAnalyzerReport::reportNormalized(std::ostream& stm, const UString& ti
         }
     }
 }
+
+
+//----------------------------------------------------------------------------
+// This methods displays a JSON report.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzerReport::reportJSON(std::ostream& stm, const UString& title)
+{
+    // Update the global statistics value if internal data were modified.
+
+    recomputeStatistics();
+
+    // One JSON object is emitted per line (NDJSON). The objects are written
+    // directly on the stream, no JSON tree is built in memory, so that this
+    // report can be produced repeatedly on a live stream at a fixed cost.
+
+    // Print one object with the transport stream description.
+
+    stm << "{\"type\":\"ts\"";
+    if (!title.empty()) {
+        stm << ",\"title\":\"" << title.toJSON() << "\"";
+    }
+    if (_ts_id_valid) {
+        stm << ",\"id\":" << _ts_id;
+    }
+    stm << ",\"services\":" << _services.size()
+        << ",\"clear-services\":" << (_services.size() - _scrambled_services_cnt)
+        << ",\"scrambled-services\":" << _scrambled_services_cnt
+        << ",\"pids\":" << _pid_cnt
+        << ",\"clear-pids\":" << (_pid_cnt - _scrambled_pid_cnt)
+        << ",\"scrambled-pids\":" << _scrambled_pid_cnt
+        << ",\"pcr-pids\":" << _pcr_pid_cnt
+        << ",\"unreferenced-pids\":" << _unref_pid_cnt
+        << ",\"packets\":" << _ts_pkt_cnt
+        << ",\"invalid-syncs\":" << _invalid_sync
+        << ",\"transport-errors\":" << _transport_errors
+        << ",\"suspect-ignored\":" << _suspect_ignored
+        << ",\"bytes\":" << (PKT_SIZE * _ts_pkt_cnt)
+        << ",\"bitrate\":" << _ts_bitrate
+        << ",\"bitrate-204\":" << ToBitrate204(_ts_bitrate)
+        << ",\"user-bitrate\":" << _ts_user_bitrate
+        << ",\"pcr-bitrate\":" << _ts_pcr_bitrate_188
+        << ",\"duration-ms\":" << _duration;
+    if (!_country_code.empty()) {
+        stm << ",\"country\":\"" << _country_code.toJSON() << "\"";
+    }
+    stm << "}" << std::endl;
+
+    // Print one object for global PIDs and one for unreferenced PIDs.
+
+    stm << "{\"type\":\"global\""
+        << ",\"pids\":" << _global_pid_cnt
+        << ",\"clear-pids\":" << (_global_pid_cnt - _global_scr_pids)
+        << ",\"scrambled-pids\":" << _global_scr_pids
+        << ",\"packets\":" << _global_pkt_cnt
+        << ",\"bitrate\":" << _global_bitrate
+        << "}" << std::endl;
+
+    stm << "{\"type\":\"unreferenced\""
+        << ",\"pids\":" << _unref_pid_cnt
+        << ",\"clear-pids\":" << (_unref_pid_cnt - _unref_scr_pids)
+        << ",\"scrambled-pids\":" << _unref_scr_pids
+        << ",\"packets\":" << _unref_pkt_cnt
+        << ",\"bitrate\":" << _unref_bitrate
+        << "}" << std::endl;
+
+    // Print one object per service.
+
+    for (ServiceContextMap::const_iterator it = _services.begin(); it != _services.end(); ++it) {
+        const ServiceContext& sv(*it->second);
+        stm << "{\"type\":\"service\""
+            << ",\"id\":" << sv.service_id
+            << ",\"tsid\":" << _ts_id
+            << ",\"original-network-id\":" << sv.orig_netw_id
+            << ",\"name\":\"" << sv.getName().toJSON() << "\""
+            << ",\"provider\":\"" << sv.getProvider().toJSON() << "\""
+            << ",\"scrambled\":" << (sv.scrambled_pid_cnt > 0 ? "true" : "false")
+            << ",\"service-type\":" << int(sv.service_type)
+            << ",\"pids\":" << sv.pid_cnt
+            << ",\"clear-pids\":" << (sv.pid_cnt - sv.scrambled_pid_cnt)
+            << ",\"scrambled-pids\":" << sv.scrambled_pid_cnt
+            << ",\"packets\":" << sv.ts_pkt_cnt
+            << ",\"bitrate\":" << sv.bitrate;
+        if (sv.pmt_pid != 0) {
+            stm << ",\"pmt-pid\":" << sv.pmt_pid;
+        }
+        if (sv.pcr_pid != 0 && sv.pcr_pid != PID_NULL) {
+            stm << ",\"pcr-pid\":" << sv.pcr_pid;
+        }
+        stm << ",\"pid-list\":[";
+        bool first = true;
+        for (PIDContextMap::const_iterator it_pid = _pids.begin(); it_pid != _pids.end(); ++it_pid) {
+            if (it_pid->second->services.count(sv.service_id) != 0) {
+                stm << (first ? "" : ",") << it_pid->first;
+                first = false;
+            }
+        }
+        stm << "]}" << std::endl;
+    }
+
+    // Print one object per PID.
+
+    for (PIDContextMap::const_iterator it = _pids.begin(); it != _pids.end(); ++it) {
+        const PIDContext& pc(*it->second);
+        if (pc.ts_pkt_cnt == 0 && pc.optional) {
+            continue;
+        }
+        stm << "{\"type\":\"pid\""
+            << ",\"pid\":" << pc.pid
+            << ",\"description\":\"" << pc.fullDescription(true).toJSON() << "\""
+            << ",\"scrambled\":" << (pc.scrambled ? "true" : "false")
+            << ",\"audio\":" << (pc.carry_audio ? "true" : "false")
+            << ",\"video\":" << (pc.carry_video ? "true" : "false")
+            << ",\"referenced\":" << (pc.referenced ? "true" : "false");
+        if (!pc.language.empty()) {
+            stm << ",\"language\":\"" << pc.language.toJSON() << "\"";
+        }
+        if (pc.cas_id != 0) {
+            stm << ",\"cas\":" << pc.cas_id;
+        }
+        if (pc.same_stream_id) {
+            stm << ",\"stream-id\":" << int(pc.pes_stream_id);
+        }
+        stm << ",\"service-list\":[";
+        bool first = true;
+        for (ServiceIdSet::const_iterator it1 = pc.services.begin(); it1 != pc.services.end(); ++it1) {
+            stm << (first ? "" : ",") << *it1;
+            first = false;
+        }
+        stm << "]"
+            << ",\"bitrate\":" << pc.bitrate
+            << ",\"packets\":" << pc.ts_pkt_cnt
+            << ",\"clear\":" << (pc.ts_pkt_cnt - pc.ts_sc_cnt - pc.inv_ts_sc_cnt)
+            << ",\"scrambled-packets\":" << pc.ts_sc_cnt
+            << ",\"invalid-scrambling\":" << pc.inv_ts_sc_cnt
+            << ",\"af\":" << pc.ts_af_cnt
+            << ",\"pcr\":" << pc.pcr_cnt
+            << ",\"discontinuities\":" << pc.unexp_discont
+            << ",\"duplicated\":" << pc.duplicated;
+        if (pc.carry_pes) {
+            stm << ",\"pes\":" << pc.pl_start_cnt
+                << ",\"invalid-pes-prefix\":" << pc.inv_pes_start;
+        }
+        else {
+            stm << ",\"unit-start\":" << pc.unit_start_cnt;
+        }
+        stm << "}" << std::endl;
+    }
+
+    // Print one object per table.
+
+    for (PIDContextMap::const_iterator pci = _pids.begin(); pci != _pids.end(); ++pci) {
+        const PIDContext& pc(*pci->second);
+        for (ETIDContextMap::const_iterator it = pc.sections.begin(); it != pc.sections.end(); ++it) {
+            const ETIDContext& etc(*it->second);
+            stm << "{\"type\":\"table\""
+                << ",\"pid\":" << pc.pid
+                << ",\"tid\":" << int(etc.etid.tid());
+            if (etc.etid.isLongSection()) {
+                stm << ",\"tid-ext\":" << etc.etid.tidExt();
+            }
+            stm << ",\"tables\":" << etc.table_count
+                << ",\"sections\":" << etc.section_count
+                << ",\"repetition-pkt\":" << etc.repetition_ts
+                << ",\"min-repetition-pkt\":" << etc.min_repetition_ts
+                << ",\"max-repetition-pkt\":" << etc.max_repetition_ts;
+            if (_ts_bitrate != 0) {
+                stm << ",\"repetition-ms\":" << PacketInterval(_ts_bitrate, etc.repetition_ts)
+                    << ",\"min-repetition-ms\":" << PacketInterval(_ts_bitrate, etc.min_repetition_ts)
+                    << ",\"max-repetition-ms\":" << PacketInterval(_ts_bitrate, etc.max_repetition_ts);
+            }
+            stm << "}" << std::endl;
+        }
+    }
+}
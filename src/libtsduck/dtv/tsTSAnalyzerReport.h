@@ -124,6 +124,17 @@ namespace ts {
         //!
         void reportNormalized(std::ostream& strm, const UString& title = UString());
 
+        //!
+        //! This methods displays a JSON report.
+        //! One JSON object is emitted per line (NDJSON). The objects are
+        //! directly written on the stream, the complete report is never
+        //! built in memory, so the report size does not depend on the
+        //! duration of the analyzed stream.
+        //! @param [in,out] strm Output text stream.
+        //! @param [in] title Title string to display.
+        //!
+        void reportJSON(std::ostream& strm, const UString& title = UString());
+
     private:
         // Display header of a service PID list.
         void reportServiceHeader(Grid& grid, const UString& usage, bool scrambled, BitRate bitrate, BitRate ts_bitrate, bool wide) const;
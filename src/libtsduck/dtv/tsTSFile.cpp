@@ -30,8 +30,18 @@
 #include "tsTSFile.h"
 #include "tsNullReport.h"
 #include "tsSysUtils.h"
+#include "tsMemory.h"
 TSDUCK_SOURCE;
 
+// Magic of the elided capture file format (not a valid TS packet start).
+const uint8_t ts::TSFile::ELIDED_MAGIC[8] = {0x54, 0x53, 0x44, 0x45, 0x4C, 0x46, 0x31, 0x0A}; // "TSDELF1\n"
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const uint8_t ts::TSFile::ELIDED_NULL_RUN;
+const uint8_t ts::TSFile::ELIDED_STORED;
+const size_t ts::TSFile::ELIDED_MAX_COUNT;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Default constructor.
@@ -50,8 +60,25 @@ ts::TSFile::TSFile() :
     _at_eof(false),
     _aborted(false),
     _rewindable(false),
+    _direct_io(false),
+    _direct_eof(false),
+    _direct_buffer(),
+    _direct_base(nullptr),
+    _direct_size(0),
+    _direct_next(0),
+    _mmap_io(false),
+    _mmap_base(nullptr),
+    _mmap_size(0),
+    _mmap_next(0),
+    _elided_io(false),
+    _peek(),
+    _peek_size(0),
+    _run_null(0),
+    _run_stored(0),
+    _null_run(0),
 #if defined(TS_WINDOWS)
-    _handle(INVALID_HANDLE_VALUE)
+    _handle(INVALID_HANDLE_VALUE),
+    _map_handle(INVALID_HANDLE_VALUE)
 #else
     _fd(-1)
 #endif
@@ -76,8 +103,25 @@ ts::TSFile::TSFile(const TSFile& other) :
     _at_eof(false),
     _aborted(false),
     _rewindable(false),
+    _direct_io(other._direct_io),
+    _direct_eof(false),
+    _direct_buffer(),
+    _direct_base(nullptr),
+    _direct_size(0),
+    _direct_next(0),
+    _mmap_io(other._mmap_io),
+    _mmap_base(nullptr),
+    _mmap_size(0),
+    _mmap_next(0),
+    _elided_io(other._elided_io),
+    _peek(),
+    _peek_size(0),
+    _run_null(0),
+    _run_stored(0),
+    _null_run(0),
 #if defined(TS_WINDOWS)
-    _handle(INVALID_HANDLE_VALUE)
+    _handle(INVALID_HANDLE_VALUE),
+    _map_handle(INVALID_HANDLE_VALUE)
 #else
     _fd(-1)
 #endif
@@ -102,16 +146,37 @@ ts::TSFile::TSFile(TSFile&& other) noexcept :
     _at_eof(other._at_eof),
     _aborted(other._aborted),
     _rewindable(other._rewindable),
+    _direct_io(other._direct_io),
+    _direct_eof(other._direct_eof),
+    _direct_buffer(std::move(other._direct_buffer)),
+    _direct_base(other._direct_base),  // still valid, the heap storage moved with the ByteBlock
+    _direct_size(other._direct_size),
+    _direct_next(other._direct_next),
+    _mmap_io(other._mmap_io),
+    _mmap_base(other._mmap_base),
+    _mmap_size(other._mmap_size),
+    _mmap_next(other._mmap_next),
+    _elided_io(other._elided_io),
+    _peek(),
+    _peek_size(other._peek_size),
+    _run_null(other._run_null),
+    _run_stored(other._run_stored),
+    _null_run(other._null_run),
 #if defined(TS_WINDOWS)
-    _handle(other._handle)
+    _handle(other._handle),
+    _map_handle(other._map_handle)
 #else
     _fd(other._fd)
 #endif
 {
+    ::memcpy(_peek, other._peek, sizeof(_peek));  // Flawfinder: ignore: memcpy()
+
     // Mark other object as closed, just in case.
     other._is_open = false;
+    other._mmap_base = nullptr;
 #if defined(TS_WINDOWS)
     other._handle = INVALID_HANDLE_VALUE;
+    other._map_handle = INVALID_HANDLE_VALUE;
 #else
     other._fd = -1;
 #endif
@@ -243,11 +308,66 @@ bool ts::TSFile::openInternal(Report& report)
     const bool keep_file = (_flags & KEEP) != 0;
     const bool temporary = (_flags & TEMPORARY) != 0;
 
+    // Direct I/O can be requested with the open flag or with setDirectIO().
+    const bool direct_io = _direct_io || (_flags & DIRECT) != 0;
+    if (direct_io) {
+        if (_filename.empty()) {
+            report.log(_severity, u"direct I/O requires a named file, not the standard input or output");
+            return false;
+        }
+        if (_start_offset % DIRECT_ALIGNMENT != 0) {
+            report.log(_severity, u"direct I/O requires a start offset multiple of %'d bytes", {DIRECT_ALIGNMENT});
+            return false;
+        }
+        // Normalize the flags so that the other methods only check DIRECT.
+        _flags |= DIRECT;
+    }
+
+    // Memory map can be requested with the open flag or with setMemoryMap().
+    const bool mapped = _mmap_io || (_flags & MAPPED) != 0;
+    if (mapped) {
+        if (_filename.empty()) {
+            report.log(_severity, u"memory map requires a named file, not the standard input");
+            return false;
+        }
+        if (!read_only) {
+            report.log(_severity, u"memory map is only available for read-only files");
+            return false;
+        }
+        if (direct_io) {
+            report.log(_severity, u"memory map and direct I/O are mutually exclusive");
+            return false;
+        }
+        // Normalize the flags so that the other methods only check MAPPED.
+        _flags |= MAPPED;
+    }
+
+    // The elided capture format can be requested with the open flag or setElidedFormat().
+    // On read-only files, it is also automatically detected from the file magic (see below).
+    const bool elided = _elided_io || (_flags & ELIDED) != 0;
+    if (elided) {
+        if (direct_io || mapped) {
+            report.log(_severity, u"the elided capture format is incompatible with direct I/O and memory map");
+            return false;
+        }
+        if (read_access && write_access) {
+            report.log(_severity, u"the elided capture format is not available in read-write mode");
+            return false;
+        }
+        if (append_access) {
+            report.log(_severity, u"cannot append to a file in elided capture format");
+            return false;
+        }
+        // Normalize the flags so that the other methods only check ELIDED.
+        _flags |= ELIDED;
+    }
+
 #if defined(TS_WINDOWS)
 
     // Windows implementation
     const ::DWORD access = (read_access ? GENERIC_READ : 0) | (write_access ? GENERIC_WRITE : 0);
-    const ::DWORD attrib = temporary ? (FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE) : FILE_ATTRIBUTE_NORMAL;
+    const ::DWORD attrib = (temporary ? (FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE) : FILE_ATTRIBUTE_NORMAL) |
+                           (direct_io ? FILE_FLAG_NO_BUFFERING : 0);
     const ::DWORD shared = read_only || (_flags & SHARE) != 0 ? FILE_SHARE_READ : 0;
     ::DWORD winflags = 0;
 
@@ -327,6 +447,11 @@ bool ts::TSFile::openInternal(Report& report)
     if (write_access && keep_file) {
         uflags |= O_EXCL;
     }
+#if defined(O_DIRECT)
+    if (direct_io) {
+        uflags |= O_DIRECT;
+    }
+#endif
 
     if (_filename.empty()) {
         // File name is empty means standard input or output. No need to open.
@@ -351,6 +476,21 @@ bool ts::TSFile::openInternal(Report& report)
             // It remains accessible as long as the file is open and is deleted on close.
             ::unlink(_filename.toUTF8().c_str());
         }
+#if defined(TS_MAC)
+        // There is no O_DIRECT on macOS, the cache is bypassed using F_NOCACHE.
+        if (direct_io && ::fcntl(_fd, F_NOCACHE, 1) < 0) {
+            const ErrorCode err = LastErrorCode();
+            report.log(_severity, u"cannot set F_NOCACHE on %s: %s", {getDisplayFileName(), ErrorCodeMessage(err)});
+            ::close(_fd);
+            return false;
+        }
+#endif
+#if defined(TS_LINUX)
+        // With buffered linear reads, hint the kernel to perform aggressive readahead.
+        if (read_only && !direct_io) {
+            ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        }
+#endif
     }
 
     // If a repeat count or initial offset is specified, the input file must be a regular file
@@ -385,6 +525,107 @@ bool ts::TSFile::openInternal(Report& report)
 
 #endif
 
+    // In memory-mapped mode, map the complete file in virtual memory.
+    if (mapped) {
+#if defined(TS_WINDOWS)
+        ::LARGE_INTEGER size;
+        if (::GetFileSizeEx(_handle, &size) == 0) {
+            const ErrorCode err = LastErrorCode();
+            report.log(_severity, u"cannot get size of %s: %s", {getDisplayFileName(), ErrorCodeMessage(err)});
+            ::CloseHandle(_handle);
+            return false;
+        }
+        _mmap_size = uint64_t(size.QuadPart);
+        if (_mmap_size > 0) {
+            _map_handle = ::CreateFileMapping(_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+            _mmap_base = _map_handle == NULL ? nullptr : reinterpret_cast<uint8_t*>(::MapViewOfFile(_map_handle, FILE_MAP_READ, 0, 0, 0));
+            if (_mmap_base == nullptr) {
+                const ErrorCode err = LastErrorCode();
+                report.log(_severity, u"cannot map %s in memory: %s", {getDisplayFileName(), ErrorCodeMessage(err)});
+                if (_map_handle != NULL) {
+                    ::CloseHandle(_map_handle);
+                    _map_handle = INVALID_HANDLE_VALUE;
+                }
+                ::CloseHandle(_handle);
+                return false;
+            }
+        }
+#else
+        struct stat st;
+        if (::fstat(_fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+            report.log(_severity, u"memory map requires a regular file, cannot map %s", {getDisplayFileName()});
+            ::close(_fd);
+            return false;
+        }
+        _mmap_size = uint64_t(st.st_size);
+        if (_mmap_size > 0) {
+            void* base = ::mmap(nullptr, size_t(_mmap_size), PROT_READ, MAP_PRIVATE, _fd, 0);
+            if (base == MAP_FAILED) {
+                const ErrorCode err = LastErrorCode();
+                report.log(_severity, u"cannot map %s in memory: %s", {getDisplayFileName(), ErrorCodeMessage(err)});
+                ::close(_fd);
+                return false;
+            }
+            _mmap_base = reinterpret_cast<uint8_t*>(base);
+            // Hint the kernel: linear access, start paging in now.
+            ::posix_madvise(base, size_t(_mmap_size), POSIX_MADV_SEQUENTIAL);
+            ::posix_madvise(base, size_t(_mmap_size), POSIX_MADV_WILLNEED);
+        }
+#endif
+        _mmap_next = 0;
+    }
+
+    // Allocate the aligned exchange buffer for direct I/O.
+    if (direct_io) {
+        _direct_buffer.resize(DIRECT_BUFFER_SIZE + DIRECT_ALIGNMENT);
+        const size_t misalign = size_t(reinterpret_cast<uintptr_t>(_direct_buffer.data()) % DIRECT_ALIGNMENT);
+        _direct_base = _direct_buffer.data() + (misalign == 0 ? 0 : DIRECT_ALIGNMENT - misalign);
+        _direct_size = 0;
+        _direct_next = 0;
+        _direct_eof = false;
+    }
+
+    // In elided capture format, write the file magic on output or detect it on input.
+    _peek_size = 0;
+    _run_null = _run_stored = 0;
+    _null_run = 0;
+    if (write_access && elided) {
+        if (!writeBytes(ELIDED_MAGIC, sizeof(ELIDED_MAGIC), report)) {
+            if (!_filename.empty()) {
+#if defined(TS_WINDOWS)
+                ::CloseHandle(_handle);
+#else
+                ::close(_fd);
+#endif
+            }
+            return false;
+        }
+    }
+    else if (read_only && !mapped && !direct_io) {
+        // Peek the first bytes of the file to detect the elided format magic.
+        // When the file is in plain TS format, these bytes are delivered back
+        // on the first read().
+        const size_t got = readBytes(_peek, sizeof(_peek), report);
+        if (got == sizeof(_peek) && ::memcmp(_peek, ELIDED_MAGIC, sizeof(_peek)) == 0) {
+            _flags |= ELIDED;
+        }
+        else if (elided) {
+            // The format was explicitly requested but the magic is not there.
+            report.log(_severity, u"file %s is not in elided capture format", {getDisplayFileName()});
+            if (!_filename.empty()) {
+#if defined(TS_WINDOWS)
+                ::CloseHandle(_handle);
+#else
+                ::close(_fd);
+#endif
+            }
+            return false;
+        }
+        else {
+            _peek_size = got;
+        }
+    }
+
     _total_read = _total_write = 0;
     _at_eof = _aborted = false;
     _is_open = true;
@@ -398,6 +639,36 @@ bool ts::TSFile::openInternal(Report& report)
 
 bool ts::TSFile::seekInternal(uint64_t index, Report& report)
 {
+    // In memory-mapped mode, a seek is simple pointer arithmetic.
+    if ((_flags & MAPPED) != 0) {
+        _mmap_next = index;
+        _at_eof = false;
+        return true;
+    }
+
+    // In elided capture format, a packet index has no byte equivalent in the
+    // file. Only a rewind to the beginning is possible, just after the magic.
+    if ((_flags & ELIDED) != 0) {
+        if (index != 0 || (_flags & WRITE) != 0) {
+            report.log(_severity, u"cannot seek in elided capture format file %s", {getDisplayFileName()});
+            return false;
+        }
+        _run_null = _run_stored = 0;
+        index = sizeof(ELIDED_MAGIC);
+    }
+
+    // In direct I/O mode, the system only accepts aligned offsets and the
+    // internal buffer content no longer matches the new file position.
+    if ((_flags & DIRECT) != 0) {
+        if ((_start_offset + index) % DIRECT_ALIGNMENT != 0) {
+            report.log(_severity, u"direct I/O on %s: seek offsets must be multiples of %'d bytes", {getDisplayFileName(), DIRECT_ALIGNMENT});
+            return false;
+        }
+        _direct_size = 0;
+        _direct_next = 0;
+        _direct_eof = false;
+    }
+
 #if defined(TS_WINDOWS)
     // In Win32, LARGE_INTEGER is a 64-bit structure, not an integer type
     uint64_t where = _start_offset + index;
@@ -437,6 +708,37 @@ bool ts::TSFile::seek(PacketCounter packet_index, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Directly reposition a read file on a packet index (for subclasses).
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::seekRead(PacketCounter packet_index, Report& report)
+{
+    if (!_is_open) {
+        report.log(_severity, u"not open");
+        return false;
+    }
+    else if ((_flags & READ) == 0) {
+        report.log(_severity, u"file %s is not open for read", {getDisplayFileName()});
+        return false;
+    }
+    else if (_counter > 0) {
+        // The file already repeated at least once, the mapping between a
+        // packet index and a file offset is no longer unique.
+        report.log(_severity, u"cannot seek in file %s after it repeated", {getDisplayFileName()});
+        return false;
+    }
+    else if (!seekInternal(packet_index * PKT_SIZE, report)) {
+        return false;
+    }
+    else {
+        // Keep the read packet count consistent with the new position.
+        _total_read = packet_index;
+        return true;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Close file.
 //----------------------------------------------------------------------------
@@ -448,6 +750,20 @@ bool ts::TSFile::close(Report& report)
         return false;
     }
 
+    // In direct I/O write mode, flush the unaligned tail of the file.
+    bool success = true;
+    if ((_flags & DIRECT) != 0 && (_flags & WRITE) != 0 && !_aborted) {
+        success = flushDirect(report);
+    }
+
+    // In elided format write mode, flush the pending run of null packets.
+    if ((_flags & ELIDED) != 0 && (_flags & WRITE) != 0 && !_aborted) {
+        success = flushNullRun(report) && success;
+    }
+
+    // Unmap the file in memory-mapped mode.
+    unmap();
+
     if (!_filename.empty()) {
 #if defined(TS_WINDOWS)
         ::CloseHandle(_handle);
@@ -460,8 +776,16 @@ bool ts::TSFile::close(Report& report)
     _total_read = _total_write = 0;
     _flags = NONE;
     _filename.clear();
-
-    return true;
+    _direct_buffer.clear();
+    _direct_base = nullptr;
+    _direct_size = _direct_next = 0;
+    _direct_eof = false;
+    _mmap_next = 0;
+    _peek_size = 0;
+    _run_null = _run_stored = 0;
+    _null_run = 0;
+
+    return success;
 }
 
 
@@ -482,6 +806,15 @@ size_t ts::TSFile::read(TSPacket* buffer, size_t max_packets, Report& report)
     else if (_aborted || _at_eof) {
         return 0;
     }
+    else if ((_flags & MAPPED) != 0) {
+        return readMapped(buffer, max_packets, report);
+    }
+    else if ((_flags & DIRECT) != 0) {
+        return readDirect(buffer, max_packets, report);
+    }
+    else if ((_flags & ELIDED) != 0) {
+        return readElided(buffer, max_packets, report);
+    }
 
     char* data = reinterpret_cast<char*>(buffer);
     const size_t req_size = max_packets * PKT_SIZE;
@@ -489,6 +822,14 @@ size_t ts::TSFile::read(TSPacket* buffer, size_t max_packets, Report& report)
     bool got_error = false;
     ErrorCode error_code = 0;
 
+    // Deliver the bytes which were read ahead during format auto-detection.
+    // They are always shorter than one packet, any non-zero request holds them.
+    if (_peek_size > 0 && _peek_size <= req_size) {
+        ::memcpy(data, _peek, _peek_size);  // Flawfinder: ignore: memcpy()
+        got_size = _peek_size;
+        _peek_size = 0;
+    }
+
     // Loop on read until we get enough
     while (got_size < req_size && !_at_eof && !got_error) {
 
@@ -565,6 +906,12 @@ bool ts::TSFile::write(const TSPacket* buffer, size_t packet_count, Report& repo
     else if (_aborted) {
         return false;
     }
+    else if ((_flags & DIRECT) != 0) {
+        return writeDirect(buffer, packet_count, report);
+    }
+    else if ((_flags & ELIDED) != 0) {
+        return writeElided(buffer, packet_count, report);
+    }
 
     // Loop on write until everything is gone
     bool got_error = false;
@@ -635,6 +982,624 @@ bool ts::TSFile::write(const TSPacket* buffer, size_t packet_count, Report& repo
 }
 
 
+//----------------------------------------------------------------------------
+// Write several discontiguous segments of TS packets to the file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::writeSegments(const PacketSegment* segments, size_t segment_count, Report& report)
+{
+    if (!_is_open) {
+        report.log(_severity, u"not open");
+        return false;
+    }
+    else if ((_flags & (WRITE | APPEND)) == 0) {
+        report.log(_severity, u"file %s is not open for write", {getDisplayFileName()});
+        return false;
+    }
+    else if (_aborted) {
+        return false;
+    }
+
+#if defined(TS_WINDOWS)
+
+    // WriteFileGather() requires page-aligned sector-sized buffers on an
+    // overlapped handle, which arbitrary packet buffers cannot satisfy.
+    // Write the segments sequentially.
+    for (size_t seg = 0; seg < segment_count; ++seg) {
+        if (segments[seg].count > 0 && !write(segments[seg].packets, segments[seg].count, report)) {
+            return false;
+        }
+    }
+    return true;
+
+#else
+
+    // In direct I/O mode, the data are accumulated in the aligned exchange
+    // buffer anyway, writing the segments in sequence is already gather-style.
+    if ((_flags & DIRECT) != 0) {
+        for (size_t seg = 0; seg < segment_count; ++seg) {
+            if (segments[seg].count > 0 && !writeDirect(segments[seg].packets, segments[seg].count, report)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // UNIX implementation: write all segments of a window in one writev().
+    // POSIX only guarantees 16 entries per call (_XOPEN_IOV_MAX).
+    const size_t MAX_IOV = 16;
+    ::iovec iov[MAX_IOV];
+
+    for (size_t seg = 0; seg < segment_count; ) {
+
+        // Build the next window of non-empty segments.
+        size_t iov_count = 0;
+        while (seg < segment_count && iov_count < MAX_IOV) {
+            if (segments[seg].count > 0) {
+                iov[iov_count].iov_base = segments[seg].packets;
+                iov[iov_count].iov_len = segments[seg].count * PKT_SIZE;
+                iov_count++;
+            }
+            seg++;
+        }
+
+        // Write the complete window, looping on partial writes.
+        size_t first = 0;
+        size_t written = 0;
+        bool got_error = false;
+        ErrorCode error_code = SYS_SUCCESS;
+
+        while (first < iov_count && !got_error) {
+            const ssize_t outsize = ::writev(_fd, &iov[first], int(iov_count - first));
+            if (outsize > 0) {
+                // Normal case, some data were written.
+                // Pop the fully written segments, adjust a partially written one.
+                written += size_t(outsize);
+                size_t remain = size_t(outsize);
+                while (first < iov_count && remain >= iov[first].iov_len) {
+                    remain -= iov[first].iov_len;
+                    first++;
+                }
+                if (first < iov_count && remain > 0) {
+                    iov[first].iov_base = reinterpret_cast<char*>(iov[first].iov_base) + remain;
+                    iov[first].iov_len -= remain;
+                }
+            }
+            else if ((error_code = LastErrorCode()) != EINTR) {
+                // Actual error (not an interrupt)
+                report.debug(u"write error on %s, fd=%d, error_code=%d", {getDisplayFileName(), _fd, error_code});
+                got_error = true;
+                if (error_code == EPIPE) {
+                    // Broken pipe: keep the error state but don't report error.
+                    error_code = SYS_SUCCESS;
+                }
+            }
+        }
+
+        _total_write += written / PKT_SIZE;
+        if (got_error) {
+            if (error_code != SYS_SUCCESS) {
+                report.log(_severity, u"error writing %s: %s (%d)", {getDisplayFileName(), ErrorCodeMessage(error_code), error_code});
+            }
+            return false;
+        }
+    }
+    return true;
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Read raw bytes from the file. Return the number of read bytes.
+// Used by the elided capture format. Short read means end of file.
+//----------------------------------------------------------------------------
+
+size_t ts::TSFile::readBytes(void* addr, size_t size, Report& report)
+{
+    char* data = reinterpret_cast<char*>(addr);
+    size_t got = 0;
+
+#if defined(TS_WINDOWS)
+    while (got < size) {
+        ::DWORD insize = 0;
+        if (::ReadFile(_handle, data + got, ::DWORD(size - got), &insize, NULL)) {
+            if (insize == 0) {
+                break; // end of file
+            }
+            got += size_t(insize);
+        }
+        else {
+            const ErrorCode error_code = LastErrorCode();
+            if (error_code != ERROR_HANDLE_EOF && error_code != ERROR_BROKEN_PIPE) {
+                report.log(_severity, u"error reading file %s: %s (%d)", {_filename, ErrorCodeMessage(error_code), error_code});
+            }
+            break;
+        }
+    }
+#else
+    while (got < size) {
+        const ssize_t insize = ::read(_fd, data + got, size - got);
+        if (insize > 0) {
+            got += size_t(insize);
+        }
+        else if (insize == 0) {
+            break; // end of file
+        }
+        else if (LastErrorCode() != EINTR) {
+            const ErrorCode error_code = LastErrorCode();
+            report.log(_severity, u"error reading file %s: %s (%d)", {_filename, ErrorCodeMessage(error_code), error_code});
+            break;
+        }
+    }
+#endif
+
+    return got;
+}
+
+
+//----------------------------------------------------------------------------
+// Write raw bytes to the file. Used by the elided capture format.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::writeBytes(const void* addr, size_t size, Report& report)
+{
+    const char* data = reinterpret_cast<const char*>(addr);
+    size_t remain = size;
+
+#if defined(TS_WINDOWS)
+    while (remain > 0) {
+        ::DWORD outsize = 0;
+        if (::WriteFile(_handle, data, ::DWORD(remain), &outsize, NULL) == 0) {
+            const ErrorCode error_code = LastErrorCode();
+            report.log(_severity, u"error writing %s: %s (%d)", {getDisplayFileName(), ErrorCodeMessage(error_code), error_code});
+            return false;
+        }
+        outsize = std::min(outsize, ::DWORD(remain));
+        data += outsize;
+        remain -= size_t(outsize);
+    }
+#else
+    while (remain > 0) {
+        const ssize_t outsize = ::write(_fd, data, remain);
+        if (outsize > 0) {
+            assert(size_t(outsize) <= remain);
+            data += outsize;
+            remain -= size_t(outsize);
+        }
+        else if (LastErrorCode() != EINTR) {
+            const ErrorCode error_code = LastErrorCode();
+            report.log(_severity, u"error writing %s: %s (%d)", {getDisplayFileName(), ErrorCodeMessage(error_code), error_code});
+            return false;
+        }
+    }
+#endif
+
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Read TS packets in elided capture format.
+//----------------------------------------------------------------------------
+
+size_t ts::TSFile::readElided(TSPacket* buffer, size_t max_packets, Report& report)
+{
+    size_t count = 0;
+
+    while (count < max_packets && !_at_eof) {
+        if (_run_null > 0) {
+            // Regenerate one elided null packet.
+            buffer[count++] = NullPacket;
+            _run_null--;
+        }
+        else if (_run_stored > 0) {
+            // Read stored packets from the current record.
+            const size_t request = std::min(max_packets - count, _run_stored);
+            const size_t insize = readBytes(buffer + count, request * PKT_SIZE, report);
+            const size_t got = insize / PKT_SIZE;
+            count += got;
+            _run_stored -= got;
+            if (insize < request * PKT_SIZE) {
+                if (insize % PKT_SIZE != 0) {
+                    report.log(_severity, u"truncated packet in elided capture file %s", {getDisplayFileName()});
+                }
+                _at_eof = true;
+            }
+        }
+        else {
+            // Read the next record header.
+            uint8_t header[4];
+            const size_t insize = readBytes(header, sizeof(header), report);
+            if (insize == 0) {
+                // Clean end of file.
+                _at_eof = true;
+            }
+            else if (insize < sizeof(header)) {
+                report.log(_severity, u"truncated record in elided capture file %s", {getDisplayFileName()});
+                _at_eof = true;
+            }
+            else {
+                const size_t value = GetUInt24BE(header + 1);
+                if (header[0] == ELIDED_NULL_RUN) {
+                    _run_null = value;
+                }
+                else if (header[0] == ELIDED_STORED) {
+                    _run_stored = value;
+                }
+                else {
+                    // Reserved record type, the count is a payload size in bytes, skip it.
+                    uint8_t scratch[512];
+                    size_t remain = value;
+                    while (remain > 0) {
+                        const size_t skipped = readBytes(scratch, std::min(remain, sizeof(scratch)), report);
+                        if (skipped == 0) {
+                            _at_eof = true;
+                            break;
+                        }
+                        remain -= skipped;
+                    }
+                }
+            }
+        }
+
+        // At end of file, if the file must be repeated a finite number of times,
+        // check if this was the last time. If the file must be repeated again,
+        // rewind just after the magic.
+        if (_at_eof && (_repeat == 0 || ++_counter < _repeat) && !seekInternal(0, report)) {
+            return 0; // rewind error
+        }
+    }
+
+    _total_read += count;
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Write TS packets in elided capture format.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::writeElided(const TSPacket* buffer, size_t packet_count, Report& report)
+{
+    size_t next = 0;
+
+    while (next < packet_count) {
+        if (buffer[next].getPID() == PID_NULL) {
+            // Extend the pending run of null packets. It is written when a
+            // non-null packet shows up or when the file is closed.
+            size_t run = 1;
+            while (next + run < packet_count && buffer[next + run].getPID() == PID_NULL) {
+                run++;
+            }
+            _null_run += run;
+            next += run;
+        }
+        else {
+            // Terminate the pending run of null packets, if any.
+            if (!flushNullRun(report)) {
+                return false;
+            }
+            // Store the contiguous burst of non-null packets in one record.
+            size_t burst = 1;
+            while (next + burst < packet_count && burst < ELIDED_MAX_COUNT && buffer[next + burst].getPID() != PID_NULL) {
+                burst++;
+            }
+            uint8_t header[4];
+            header[0] = ELIDED_STORED;
+            PutUInt24BE(header + 1, uint32_t(burst));
+            if (!writeBytes(header, sizeof(header), report) || !writeBytes(buffer + next, burst * PKT_SIZE, report)) {
+                return false;
+            }
+            next += burst;
+        }
+    }
+
+    _total_write += packet_count;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Write the pending run of null packets in elided capture format.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::flushNullRun(Report& report)
+{
+    while (_null_run > 0) {
+        const size_t count = size_t(std::min<uint64_t>(_null_run, ELIDED_MAX_COUNT));
+        uint8_t header[4];
+        header[0] = ELIDED_NULL_RUN;
+        PutUInt24BE(header + 1, uint32_t(count));
+        if (!writeBytes(header, sizeof(header), report)) {
+            return false;
+        }
+        _null_run -= count;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Read TS packets in memory-mapped mode, by copy from the mapping.
+//----------------------------------------------------------------------------
+
+size_t ts::TSFile::readMapped(TSPacket* buffer, size_t max_packets, Report& report)
+{
+    char* data = reinterpret_cast<char*>(buffer);
+    const size_t req_size = max_packets * PKT_SIZE;
+    size_t got_size = 0;
+
+    // Size in bytes of the complete packets in the file, after the start offset.
+    uint64_t region_size = _mmap_size > _start_offset ? _mmap_size - _start_offset : 0;
+    region_size -= region_size % PKT_SIZE;
+
+    while (got_size < req_size && !_at_eof) {
+        const uint64_t avail = region_size > _mmap_next ? region_size - _mmap_next : 0;
+        if (avail == 0) {
+            // End of file. Rewind if the file must be repeated again.
+            if (_repeat == 0 || ++_counter < _repeat) {
+                _mmap_next = 0;
+                continue;
+            }
+            _at_eof = true;
+            break;
+        }
+        const size_t chunk = size_t(std::min<uint64_t>(req_size - got_size, avail));
+        ::memcpy(data + got_size, _mmap_base + _start_offset + _mmap_next, chunk);  // Flawfinder: ignore: memcpy()
+        _mmap_next += chunk;
+        got_size += chunk;
+    }
+
+    const size_t count = got_size / PKT_SIZE;
+    _total_read += count;
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Get a direct view of the packets of a memory-mapped file.
+//----------------------------------------------------------------------------
+
+const ts::TSPacket* ts::TSFile::mappedPackets(PacketCounter& packet_count) const
+{
+    if ((_flags & MAPPED) == 0 || _mmap_base == nullptr || _mmap_size <= _start_offset) {
+        packet_count = 0;
+        return nullptr;
+    }
+    packet_count = PacketCounter((_mmap_size - _start_offset) / PKT_SIZE);
+    return reinterpret_cast<const TSPacket*>(_mmap_base + _start_offset);
+}
+
+
+//----------------------------------------------------------------------------
+// Unmap the file in memory-mapped mode.
+//----------------------------------------------------------------------------
+
+void ts::TSFile::unmap()
+{
+    if (_mmap_base != nullptr) {
+#if defined(TS_WINDOWS)
+        ::UnmapViewOfFile(_mmap_base);
+        if (_map_handle != INVALID_HANDLE_VALUE && _map_handle != NULL) {
+            ::CloseHandle(_map_handle);
+        }
+        _map_handle = INVALID_HANDLE_VALUE;
+#else
+        ::munmap(_mmap_base, size_t(_mmap_size));
+#endif
+        _mmap_base = nullptr;
+    }
+    _mmap_size = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Read TS packets in direct I/O mode, through the aligned buffer.
+//----------------------------------------------------------------------------
+
+size_t ts::TSFile::readDirect(TSPacket* buffer, size_t max_packets, Report& report)
+{
+    char* data = reinterpret_cast<char*>(buffer);
+    const size_t req_size = max_packets * PKT_SIZE;
+    size_t got_size = 0;
+
+    while (got_size < req_size && !_at_eof) {
+
+        // First, drain the data which are already in the aligned buffer.
+        if (_direct_next < _direct_size) {
+            const size_t chunk = std::min(req_size - got_size, _direct_size - _direct_next);
+            ::memcpy(data + got_size, _direct_base + _direct_next, chunk);  // Flawfinder: ignore: memcpy()
+            _direct_next += chunk;
+            got_size += chunk;
+            continue;
+        }
+
+        // The buffer is empty. If the end of file was already detected, do not
+        // try to read again: after a short (unaligned) read, the file offset is
+        // no longer aligned and a direct read would fail.
+        if (_direct_eof) {
+            if (_repeat == 0 || ++_counter < _repeat) {
+                // Repeat the file again, rewind to the start offset.
+                if (!seekInternal(0, report)) {
+                    return 0;
+                }
+                continue;
+            }
+            _at_eof = true;
+            // Truncate a trailing partial packet, as in buffered mode.
+            got_size -= got_size % PKT_SIZE;
+            break;
+        }
+
+        // Refill the aligned buffer with one large direct read.
+        size_t insize = 0;
+#if defined(TS_WINDOWS)
+        ::DWORD gotsize = 0;
+        if (::ReadFile(_handle, _direct_base, ::DWORD(DIRECT_BUFFER_SIZE), &gotsize, NULL)) {
+            insize = size_t(gotsize);
+        }
+        else {
+            const ErrorCode error_code = LastErrorCode();
+            if (error_code != ERROR_HANDLE_EOF && error_code != ERROR_BROKEN_PIPE) {
+                report.log(_severity, u"error reading file %s: %s (%d)", {_filename, ErrorCodeMessage(error_code), error_code});
+                return 0;
+            }
+        }
+#else
+        ssize_t gotsize = 0;
+        for (;;) {
+            gotsize = ::read(_fd, _direct_base, DIRECT_BUFFER_SIZE);
+            if (gotsize >= 0 || LastErrorCode() != EINTR) {
+                break;
+            }
+        }
+        if (gotsize < 0) {
+            const ErrorCode error_code = LastErrorCode();
+            report.log(_severity, u"error reading file %s: %s (%d)", {_filename, ErrorCodeMessage(error_code), error_code});
+            return 0;
+        }
+        insize = size_t(gotsize);
+#endif
+        _direct_size = insize;
+        _direct_next = 0;
+        // A short or unaligned read means that the end of file was reached.
+        if (insize == 0 || insize % DIRECT_ALIGNMENT != 0) {
+            _direct_eof = true;
+        }
+    }
+
+    const size_t count = got_size / PKT_SIZE;
+    _total_read += count;
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Write TS packets in direct I/O mode, through the aligned buffer.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::writeDirect(const TSPacket* buffer, size_t packet_count, Report& report)
+{
+    const char* data = reinterpret_cast<const char*>(buffer);
+    size_t remain = packet_count * PKT_SIZE;
+
+    while (remain > 0) {
+        // Accumulate data in the aligned buffer.
+        const size_t chunk = std::min(remain, DIRECT_BUFFER_SIZE - _direct_size);
+        ::memcpy(_direct_base + _direct_size, data, chunk);  // Flawfinder: ignore: memcpy()
+        _direct_size += chunk;
+        data += chunk;
+        remain -= chunk;
+        // Write the buffer when full. Its size is a multiple of the alignment.
+        if (_direct_size == DIRECT_BUFFER_SIZE && !writeDirectChunk(DIRECT_BUFFER_SIZE, report)) {
+            return false;
+        }
+    }
+
+    _total_write += packet_count;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Write the first bytes of the aligned buffer and reset it.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::writeDirectChunk(size_t size, Report& report)
+{
+    const char* data = reinterpret_cast<const char*>(_direct_base);
+    size_t remain = size;
+
+#if defined(TS_WINDOWS)
+    while (remain > 0) {
+        ::DWORD outsize = 0;
+        if (::WriteFile(_handle, data, ::DWORD(remain), &outsize, NULL) == 0) {
+            const ErrorCode error_code = LastErrorCode();
+            report.log(_severity, u"error writing %s: %s (%d)", {getDisplayFileName(), ErrorCodeMessage(error_code), error_code});
+            return false;
+        }
+        outsize = std::min(outsize, ::DWORD(remain));
+        data += outsize;
+        remain -= size_t(outsize);
+    }
+#else
+    while (remain > 0) {
+        const ssize_t outsize = ::write(_fd, data, remain);
+        if (outsize > 0) {
+            assert(size_t(outsize) <= remain);
+            data += outsize;
+            remain -= size_t(outsize);
+        }
+        else if (LastErrorCode() != EINTR) {
+            const ErrorCode error_code = LastErrorCode();
+            report.log(_severity, u"error writing %s: %s (%d)", {getDisplayFileName(), ErrorCodeMessage(error_code), error_code});
+            return false;
+        }
+    }
+#endif
+
+    _direct_size = 0;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Flush the unaligned tail of the aligned buffer, on close in write mode.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::flushDirect(Report& report)
+{
+    if (_direct_size == 0) {
+        return true;
+    }
+
+#if defined(TS_WINDOWS)
+
+    // The system refuses unaligned writes. Remember the current position,
+    // pad the tail with zeroes up to the alignment, write it, then truncate
+    // the file back to its real size.
+    const size_t tail = _direct_size;
+    const size_t padded = ((tail + DIRECT_ALIGNMENT - 1) / DIRECT_ALIGNMENT) * DIRECT_ALIGNMENT;
+    ::LARGE_INTEGER zero;
+    ::LARGE_INTEGER position;
+    zero.QuadPart = 0;
+    if (::SetFilePointerEx(_handle, zero, &position, FILE_CURRENT) == 0) {
+        const ErrorCode error_code = LastErrorCode();
+        report.log(_severity, u"error seeking file %s: %s", {getDisplayFileName(), ErrorCodeMessage(error_code)});
+        return false;
+    }
+    ::memset(_direct_base + tail, 0, padded - tail);
+    if (!writeDirectChunk(padded, report)) {
+        return false;
+    }
+    position.QuadPart += ::LONGLONG(tail);
+    if (::SetFilePointerEx(_handle, position, NULL, FILE_BEGIN) == 0 || ::SetEndOfFile(_handle) == 0) {
+        const ErrorCode error_code = LastErrorCode();
+        report.log(_severity, u"error truncating file %s: %s", {getDisplayFileName(), ErrorCodeMessage(error_code)});
+        return false;
+    }
+    return true;
+
+#else
+
+#if defined(O_DIRECT)
+    // Drop O_DIRECT on the descriptor, the final unaligned write goes
+    // through the page cache like a regular write.
+    const int fl = ::fcntl(_fd, F_GETFL);
+    if (fl < 0 || ::fcntl(_fd, F_SETFL, fl & ~O_DIRECT) < 0) {
+        const ErrorCode error_code = LastErrorCode();
+        report.log(_severity, u"error flushing file %s: %s", {getDisplayFileName(), ErrorCodeMessage(error_code)});
+        return false;
+    }
+#endif
+    // With F_NOCACHE (macOS), unaligned writes are accepted, just slower.
+    return writeDirectChunk(_direct_size, report);
+
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Abort any currenly read/write operation in progress.
 //----------------------------------------------------------------------------
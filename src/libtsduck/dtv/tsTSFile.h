@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsTSPacket.h"
+#include "tsByteBlock.h"
 #include "tsReport.h"
 
 namespace ts {
@@ -107,6 +108,9 @@ namespace ts {
             KEEP      = 0x0008,   //!< Keep previous file with same name. Fail if it already exists.
             SHARED    = 0x0010,   //!< Write open with shared read for other processes. Windows only. Always shared on Unix.
             TEMPORARY = 0x0020,   //!< Temporary file, deleted on close, not always visible in the file system.
+            DIRECT    = 0x0040,   //!< Use direct I/O, bypassing the system file cache. @see setDirectIO()
+            MAPPED    = 0x0080,   //!< Memory-map the file for reading. @see setMemoryMap()
+            ELIDED    = 0x0100,   //!< Use the TSDuck elided capture file format. @see setElidedFormat()
         };
 
         //!
@@ -126,6 +130,67 @@ namespace ts {
         //!
         bool isOpen() const { return _is_open; }
 
+        //!
+        //! Activate direct I/O on the file, bypassing the system file cache
+        //! (O_DIRECT on Linux, F_NOCACHE on macOS, FILE_FLAG_NO_BUFFERING on
+        //! Windows). This avoids evicting the page cache of other processes
+        //! when linearly reading or writing very large files. The aligned
+        //! buffering which is required by the operating system is handled
+        //! internally. Direct I/O requires a named file (not a pipe, not the
+        //! standard input or output) and seek operations are restricted to
+        //! offsets which are multiple of the alignment (4 kB). Must be called
+        //! before opening the file. Equivalent to the open flag DIRECT.
+        //! @param [in] on When true, the next open uses direct I/O.
+        //!
+        void setDirectIO(bool on) { _direct_io = on; }
+
+        //!
+        //! Memory-map the file for reading on the next open.
+        //! The complete file is mapped in virtual memory and read() copies the
+        //! packets out of the mapping, without any read system call. Seek
+        //! operations are simple pointer arithmetic. When the same large
+        //! capture is analyzed several times, the pages remain in the system
+        //! cache and subsequent passes avoid all disk reads. The mapping is
+        //! advised as sequential to the operating system. Memory map requires
+        //! a named regular file, open for read only, and is incompatible with
+        //! direct I/O. Must be called before opening the file. Equivalent to
+        //! the open flag MAPPED.
+        //! @param [in] on When true, the next open maps the file in memory.
+        //! @see mappedPackets()
+        //!
+        void setMemoryMap(bool on) { _mmap_io = on; }
+
+        //!
+        //! Get a direct view of the packets of a memory-mapped file.
+        //! This is a zero-copy access path: the returned address points inside
+        //! the file mapping and remains valid until the file is closed. It is
+        //! independent from the current read position.
+        //! @param [out] packet_count Number of complete packets in the file,
+        //! after the start offset.
+        //! @return The address of the first packet in the mapping, or the null
+        //! pointer if the file is not open in memory-mapped mode.
+        //!
+        const TSPacket* mappedPackets(PacketCounter& packet_count) const;
+
+        //!
+        //! Use the TSDuck elided capture file format on the next open.
+        //! In this format, runs of null packets are stored as a 4-byte
+        //! run-length record instead of 188 bytes each. Since muxes commonly
+        //! contain 30% or more stuffing, this proportionally reduces the size
+        //! of archived captures. The file starts with an 8-byte magic, followed
+        //! by records: a one-byte type and a 24-bit count, optionally followed
+        //! by a payload (the stored packets). The null packet test on output
+        //! is a simple PID comparison and reading regenerates standard null
+        //! packets in place, so the original stream structure is preserved.
+        //! On input, the format is automatically detected from the magic on
+        //! any read-only file, this method is not needed. The format is
+        //! incompatible with direct I/O, memory map, read-write and append
+        //! modes, and the file is not seekable (except rewind). Must be called
+        //! before opening the file. Equivalent to the open flag ELIDED.
+        //! @param [in] on When true, the next open uses the elided format.
+        //!
+        void setElidedFormat(bool on) { _elided_io = on; }
+
         //!
         //! Get the severity level for error reporting.
         //! @return The severity level for error reporting.
@@ -179,6 +244,37 @@ namespace ts {
         //!
         bool write(const TSPacket* buffer, size_t packet_count, Report& report);
 
+        //!
+        //! A contiguous segment of TS packets, for vectored I/O.
+        //! @see writeSegments()
+        //!
+        struct TSDUCKDLL PacketSegment
+        {
+            TSPacket* packets;  //!< Address of the first packet in the segment.
+            size_t    count;    //!< Number of packets in the segment.
+
+            //!
+            //! Constructor.
+            //! @param [in] pkt Address of the first packet in the segment.
+            //! @param [in] cnt Number of packets in the segment.
+            //!
+            PacketSegment(TSPacket* pkt = nullptr, size_t cnt = 0) : packets(pkt), count(cnt) {}
+        };
+
+        //!
+        //! Write several discontiguous segments of TS packets to the file.
+        //! On UNIX systems, all segments of a window are written with a single
+        //! writev() system call. This is typically used to flush a circular
+        //! buffer whose content wraps around, without copying the packets into
+        //! a contiguous buffer first. On Windows and in direct I/O mode, the
+        //! segments are written sequentially.
+        //! @param [in] segments Address of the first segment descriptor.
+        //! @param [in] segment_count Number of segments. Empty segments are allowed.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool writeSegments(const PacketSegment* segments, size_t segment_count, Report& report);
+
         //!
         //! Abort any currenly read/write operation in progress.
         //! The file is left in a broken state and can be only closed.
@@ -222,7 +318,34 @@ namespace ts {
         PacketCounter _total_read;      //!< Total read packets.
         PacketCounter _total_write;     //!< Total written packets.
 
+        //!
+        //! Directly reposition a read file on a packet index (for subclasses).
+        //! Unlike seek(), this does not require the rewindable mode but the
+        //! underlying file must be seekable and must not have repeated yet.
+        //! The read packet count is adjusted to the new position.
+        //! @param [in] packet_index Seek the file to this specified packet index
+        //! (plus the specified @a start_offset from open()).
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool seekRead(PacketCounter packet_index, Report& report);
+
     private:
+        // Alignment constraint and internal buffer size for direct I/O.
+        static const size_t DIRECT_ALIGNMENT = 4096;
+        static const size_t DIRECT_BUFFER_SIZE = 512 * 1024;
+
+        // Elided capture file format. The file starts with an 8-byte magic,
+        // followed by records. Each record starts with a one-byte type and a
+        // 24-bit big-endian count. Type ELIDED_NULL_RUN: run of count elided
+        // null packets, no payload. Type ELIDED_STORED: count stored packets
+        // follow. Other types are reserved, the count is the size in bytes of
+        // a payload to skip (forward compatibility).
+        static const uint8_t ELIDED_MAGIC[8];
+        static const uint8_t ELIDED_NULL_RUN = 0x00;
+        static const uint8_t ELIDED_STORED = 0x01;
+        static const size_t ELIDED_MAX_COUNT = 0x00FFFFFF;
+
         size_t        _repeat;        //!< Repeat count (0 means infinite)
         size_t        _counter;       //!< Current repeat count
         uint64_t      _start_offset;  //!< Initial byte offset in file
@@ -232,8 +355,25 @@ namespace ts {
         volatile bool _at_eof;        //!< End of file has been reached
         volatile bool _aborted;       //!< Operation has been aborted, no operation available
         bool          _rewindable;    //!< Opened in rewindable mode
+        bool          _direct_io;     //!< Use direct I/O on next open
+        bool          _direct_eof;    //!< Direct I/O: end of file reached, buffer may still hold data
+        ByteBlock     _direct_buffer; //!< Direct I/O: internal exchange buffer
+        uint8_t*      _direct_base;   //!< Direct I/O: aligned base address inside _direct_buffer
+        size_t        _direct_size;   //!< Direct I/O: valid data bytes in the aligned buffer
+        size_t        _direct_next;   //!< Direct I/O: next byte to consume in read mode
+        bool          _mmap_io;       //!< Memory-map the file on next open
+        uint8_t*      _mmap_base;     //!< Memory map: base address of the mapping
+        uint64_t      _mmap_size;     //!< Memory map: size in bytes of the mapping (file size)
+        uint64_t      _mmap_next;     //!< Memory map: next byte to read, after the start offset
+        bool          _elided_io;     //!< Use the elided capture format on next open
+        uint8_t       _peek[8];       //!< Bytes read ahead during format auto-detection
+        size_t        _peek_size;     //!< Number of pending bytes in _peek
+        size_t        _run_null;      //!< Elided read: remaining null packets in current record
+        size_t        _run_stored;    //!< Elided read: remaining stored packets in current record
+        uint64_t      _null_run;      //!< Elided write: pending null packets, not yet written
 #if defined(TS_WINDOWS)
         ::HANDLE      _handle;        //!< File handle
+        ::HANDLE      _map_handle;    //!< File mapping object in memory-mapped mode
 #else
         int           _fd;            //!< File descriptor
 #endif
@@ -242,6 +382,25 @@ namespace ts {
         bool openInternal(Report& report);
         bool seekInternal(uint64_t index, Report& report);
 
+        // Read / write through the aligned buffer in direct I/O mode.
+        size_t readDirect(TSPacket* buffer, size_t max_packets, Report& report);
+        bool writeDirect(const TSPacket* buffer, size_t packet_count, Report& report);
+        bool writeDirectChunk(size_t size, Report& report);
+        bool flushDirect(Report& report);
+
+        // Read from the mapping in memory-mapped mode. Unmap the file.
+        size_t readMapped(TSPacket* buffer, size_t max_packets, Report& report);
+        void unmap();
+
+        // Raw byte-level I/O, used by the elided capture format.
+        size_t readBytes(void* addr, size_t size, Report& report);
+        bool writeBytes(const void* addr, size_t size, Report& report);
+
+        // Read / write in elided capture format.
+        size_t readElided(TSPacket* buffer, size_t max_packets, Report& report);
+        bool writeElided(const TSPacket* buffer, size_t packet_count, Report& report);
+        bool flushNullRun(Report& report);
+
         // Inaccessible operations.
         TSFile& operator=(TSFile&) = delete;
         TSFile& operator=(TSFile&&) = delete;
@@ -28,6 +28,9 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSFileInputBuffered.h"
+#include "tsGuard.h"
+#include "tsGuardCondition.h"
+#include "tsNullReport.h"
 TSDUCK_SOURCE;
 
 #if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
@@ -44,7 +47,17 @@ ts::TSFileInputBuffered::TSFileInputBuffered(size_t buffer_size) :
     _buffer(std::max(buffer_size, MIN_BUFFER_SIZE)),
     _first_index(0),
     _current_offset(0),
-    _total_count(0)
+    _total_count(0),
+    _ra_enabled(false),
+    _ra_started(false),
+    _ra_eof(false),
+    _ra_stop(false),
+    _ra_read_count(0),
+    _ra_report(nullptr),
+    _mutex(),
+    _got_data(),
+    _got_space(),
+    _prefetcher(this)
 {
 }
 
@@ -55,6 +68,9 @@ ts::TSFileInputBuffered::TSFileInputBuffered(size_t buffer_size) :
 
 ts::TSFileInputBuffered::~TSFileInputBuffered()
 {
+    if (_ra_started) {
+        close(NULLREP);
+    }
 }
 
 
@@ -89,7 +105,98 @@ bool ts::TSFileInputBuffered::openRead(const UString& filename, size_t repeat_co
         _first_index = 0;
         _current_offset = 0;
         _total_count = 0;
-        return TSFile::openRead(filename, repeat_count, start_offset, report);
+        if (!TSFile::openRead(filename, repeat_count, start_offset, report)) {
+            return false;
+        }
+        // Start the read-ahead thread when requested.
+        if (_ra_enabled) {
+            _ra_eof = false;
+            _ra_stop = false;
+            _ra_read_count = 0;
+            _ra_report = &report;
+            _ra_started = _prefetcher.start();
+            if (!_ra_started) {
+                report.error(u"cannot start the read-ahead thread");
+                TSFile::close(report);
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Close file. Override TSFile::close().
+//----------------------------------------------------------------------------
+
+bool ts::TSFileInputBuffered::close(Report& report)
+{
+    // Terminate the read-ahead thread first.
+    if (_ra_started) {
+        {
+            GuardCondition lock(_mutex, _got_space);
+            _ra_stop = true;
+            lock.signal();
+        }
+        _prefetcher.waitForTermination();
+        _ra_started = false;
+    }
+    return TSFile::close(report);
+}
+
+
+//----------------------------------------------------------------------------
+// Internal read-ahead thread.
+//----------------------------------------------------------------------------
+
+ts::TSFileInputBuffered::Prefetcher::Prefetcher(TSFileInputBuffered* file) :
+    _file(file)
+{
+}
+
+ts::TSFileInputBuffered::Prefetcher::~Prefetcher()
+{
+    waitForTermination();
+}
+
+void ts::TSFileInputBuffered::Prefetcher::main()
+{
+    const size_t buffer_size = _file->_buffer.size();
+    bool more = true;
+
+    while (more) {
+        // Wait for free space in the buffer and reserve a contiguous area.
+        size_t index = 0;
+        size_t count = 0;
+        {
+            GuardCondition lock(_file->_mutex, _file->_got_space);
+            while (!_file->_ra_stop && _file->_total_count >= buffer_size) {
+                lock.waitCondition();
+            }
+            if (_file->_ra_stop) {
+                break;
+            }
+            index = (_file->_first_index + _file->_total_count) % buffer_size;
+            count = std::min(buffer_size - _file->_total_count, buffer_size - index);
+        }
+
+        // Read from the file outside the lock. This is safe: the reserved
+        // area is free space which the reader thread never accesses.
+        const size_t got = _file->TSFile::read(&_file->_buffer[index], count, *_file->_ra_report);
+
+        // Publish the new packets.
+        GuardCondition lock(_file->_mutex, _file->_got_data);
+        if (got == 0) {
+            // End of file (or end of all repetitions) or read error.
+            _file->_ra_eof = true;
+            more = false;
+        }
+        else {
+            _file->_total_count += got;
+            _file->_ra_read_count += got;
+        }
+        lock.signal();
     }
 }
 
@@ -111,8 +218,19 @@ bool ts::TSFileInputBuffered::open(const UString& filename, OpenFlags flags, Rep
 
 ts::PacketCounter ts::TSFileInputBuffered::getReadCount() const
 {
-    // Make sure we do not report packets twice.
-    return isOpen() ? TSFile::getReadCount() - (_total_count - _current_offset) : 0;
+    // Make sure we do not report packets twice. With read-ahead, use the
+    // counter which is maintained under the mutex, not TSFile::getReadCount()
+    // which is updated by the read-ahead thread without synchronization.
+    if (!isOpen()) {
+        return 0;
+    }
+    else if (_ra_enabled) {
+        Guard lock(_mutex);
+        return _ra_read_count - (_total_count - _current_offset);
+    }
+    else {
+        return TSFile::getReadCount() - (_total_count - _current_offset);
+    }
 }
 
 
@@ -123,6 +241,8 @@ ts::PacketCounter ts::TSFileInputBuffered::getReadCount() const
 
 bool ts::TSFileInputBuffered::canSeek(PacketCounter pos) const
 {
+    // The mutex is recursive, the nested lock in getReadCount() is fine.
+    Guard lock(_mutex);
     const int64_t rel = int64_t(pos) - int64_t(getReadCount());
     return isOpen() &&
         ((rel >= 0 && uint64_t(_current_offset) + uint64_t(rel) <= uint64_t(_total_count)) ||
@@ -136,14 +256,38 @@ bool ts::TSFileInputBuffered::canSeek(PacketCounter pos) const
 
 bool ts::TSFileInputBuffered::seek(PacketCounter pos, Report& report)
 {
+    Guard lock(_mutex);
     if (canSeek(pos)) {
         _current_offset = size_t(int64_t(_current_offset) + int64_t(pos) - int64_t(getReadCount()));
         return true;
     }
-    else {
+    else if (_ra_started || !isOpen()) {
         report.error(u"trying to seek buffered TS input file outside input buffer");
         return false;
     }
+    else {
+        // Outside the buffer, directly reposition the underlying file.
+        return seekDirect(pos, report);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Directly reposition the underlying file outside the buffered range.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileInputBuffered::seekDirect(PacketCounter position, Report& report)
+{
+    // TS packets have a fixed size: the target byte offset is a plain
+    // multiplication, no index of the file content is needed.
+    if (!seekRead(position, report)) {
+        return false;
+    }
+    // The buffer content is now unrelated to the file position, drop it.
+    _first_index = 0;
+    _current_offset = 0;
+    _total_count = 0;
+    return true;
 }
 
 
@@ -153,34 +297,44 @@ bool ts::TSFileInputBuffered::seek(PacketCounter pos, Report& report)
 
 bool ts::TSFileInputBuffered::seekBackward(size_t packet_count, Report& report)
 {
+    Guard lock(_mutex);
     if (!isOpen()) {
         report.error(u"file not open");
         return false;
     }
-    else if (packet_count > _current_offset) {
+    else if (packet_count <= _current_offset) {
+        _current_offset -= packet_count;
+        return true;
+    }
+    else if (_ra_started || packet_count > getReadCount()) {
         report.error(u"trying to seek TS input file backward too far");
         return false;
     }
     else {
-        _current_offset -= packet_count;
-        return true;
+        // Beyond the buffered history, directly reposition the underlying file.
+        return seekDirect(getReadCount() - packet_count, report);
     }
 }
 
 
 bool ts::TSFileInputBuffered::seekForward(size_t packet_count, Report& report)
 {
+    Guard lock(_mutex);
     if (!isOpen()) {
         report.error(u"file not open");
         return false;
     }
-    else if (_current_offset + packet_count > _total_count) {
+    else if (_current_offset + packet_count <= _total_count) {
+        _current_offset += packet_count;
+        return true;
+    }
+    else if (_ra_started) {
         report.error(u"trying to seek TS input file forward too far");
         return false;
     }
     else {
-        _current_offset += packet_count;
-        return true;
+        // Beyond the buffered data, directly reposition the underlying file.
+        return seekDirect(getReadCount() + packet_count, report);
     }
 }
 
@@ -196,6 +350,40 @@ size_t ts::TSFileInputBuffered::read(TSPacket* user_buffer, size_t max_packets,
         return false;
     }
 
+    // With read-ahead, always serve the caller from the buffer which the
+    // prefetcher keeps topped up. The oldest history is evicted as we go,
+    // keeping half of the buffer backward-seekable.
+    if (_ra_enabled) {
+        const size_t buffer_size = _buffer.size();
+        const size_t reserve = buffer_size / 2;
+        size_t in_packets = 0;
+        while (max_packets > 0) {
+            GuardCondition lock(_mutex, _got_data);
+            while (_current_offset == _total_count && !_ra_eof) {
+                lock.waitCondition();
+            }
+            if (_current_offset == _total_count) {
+                break;  // end of file
+            }
+            const size_t current_index = (_first_index + _current_offset) % buffer_size;
+            const size_t count = std::min(std::min(max_packets, _total_count - _current_offset), buffer_size - current_index);
+            TSPacket::Copy(user_buffer, &_buffer[current_index], count);
+            user_buffer += count;
+            max_packets -= count;
+            _current_offset += count;
+            in_packets += count;
+            // Evict the oldest history beyond the reserve, making room for the prefetcher.
+            if (_current_offset > reserve) {
+                const size_t evict = _current_offset - reserve;
+                _first_index = (_first_index + evict) % buffer_size;
+                _current_offset -= evict;
+                _total_count -= evict;
+            }
+            _got_space.signal();
+        }
+        return in_packets;
+    }
+
     const size_t buffer_size = _buffer.size();
 
     assert(_first_index < buffer_size);
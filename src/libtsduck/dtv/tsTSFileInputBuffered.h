@@ -34,6 +34,9 @@
 
 #pragma once
 #include "tsTSFile.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
 
 namespace ts {
     //!
@@ -73,6 +76,26 @@ namespace ts {
         //!
         bool setBufferSize(size_t buffer_size, Report& report);
 
+        //!
+        //! Activate background read-ahead on the next open.
+        //! An internal thread keeps the buffer topped up ahead of the reader,
+        //! so that read() never waits for a disk read as long as the thread
+        //! keeps up. In this mode, the oldest packets are evicted as the
+        //! buffer is refilled and the guaranteed backward seekable distance
+        //! is reduced to half of the buffer size. Must be called before
+        //! opening the file.
+        //! @param [in] on When true, the next open starts a read-ahead thread.
+        //!
+        void setReadAhead(bool on) { _ra_enabled = on; }
+
+        //!
+        //! Close the file.
+        //! Override TSFile::close(). Terminate the read-ahead thread, if any.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool close(Report& report);
+
         //!
         //! Get the buffer size.
         //! @return The buffer size in number of TS packets.
@@ -136,6 +159,9 @@ namespace ts {
 
         //!
         //! Seek the file backward the specified number of packets.
+        //! When the target position is outside the buffer and the underlying
+        //! file is seekable, the file is directly repositioned and the buffer
+        //! content is dropped (not available with read-ahead).
         //! @param [in] packet_count The number of packets to seek
         //! backward from the current position.
         //! @param [in,out] report Where to report errors.
@@ -145,6 +171,9 @@ namespace ts {
 
         //!
         //! Seek the file forward the specified number of packets.
+        //! When the target position is outside the buffer and the underlying
+        //! file is seekable, the file is directly repositioned and the buffer
+        //! content is dropped (not available with read-ahead).
         //! @param [in] packet_count The number of packets to seek
         //! forward from the current position.
         //! @param [in,out] report Where to report errors.
@@ -167,7 +196,11 @@ namespace ts {
         bool canSeek(PacketCounter position) const;
 
         //!
-        //! Seek to the specified absolute position, if it is inside the buffer.
+        //! Seek to the specified absolute position.
+        //! When the position is inside the buffer, no I/O is performed.
+        //! Otherwise, if the underlying file is seekable, the file is directly
+        //! repositioned and the buffer content is dropped (not available with
+        //! read-ahead).
         //! @param [in] position Absolute packet index in the file.
         //! @param [in,out] report Where to report errors.
         //! @return True on success, false on error.
@@ -175,14 +208,39 @@ namespace ts {
         bool seek(PacketCounter position, Report& report);
 
     private:
+        // Internal thread which keeps the buffer topped up with read-ahead.
+        class Prefetcher: public Thread
+        {
+            TS_NOBUILD_NOCOPY(Prefetcher);
+        public:
+            Prefetcher(TSFileInputBuffered* file);
+            virtual ~Prefetcher();
+            virtual void main() override;
+        private:
+            TSFileInputBuffered* _file;
+        };
+
         TSPacketVector _buffer;         // Seekable packet circular buffer.
         size_t         _first_index;    // Index of first packet in buffer.
         size_t         _current_offset; // Offset from _first_index of "current" readable packet
         size_t         _total_count;    // Total count of valid packets in buffer.
+        bool           _ra_enabled;     // Start a read-ahead thread on next open.
+        bool           _ra_started;     // The read-ahead thread is started.
+        bool           _ra_eof;         // The read-ahead thread reached the end of file.
+        volatile bool  _ra_stop;        // Ask the read-ahead thread to terminate.
+        PacketCounter  _ra_read_count;  // Packets read from the file by the read-ahead thread.
+        Report*        _ra_report;      // Where the read-ahead thread reports errors.
+        mutable Mutex  _mutex;          // Protect the buffer state with read-ahead.
+        Condition      _got_data;       // Signaled when the read-ahead thread adds packets.
+        Condition      _got_space;      // Signaled when the reader frees buffer space.
+        Prefetcher     _prefetcher;     // The read-ahead thread.
 
         // Make sure that the generic open() returns an error.
         virtual bool open(const UString& filename, OpenFlags flags, Report& report) override;
 
+        // Directly reposition the underlying file outside the buffered range.
+        bool seekDirect(PacketCounter position, Report& report);
+
         // Make rewind inaccessible.
         bool rewind(Report&) = delete;
     };
@@ -89,6 +89,24 @@ bool ts::TSFileOutputResync::write(TSPacket* buffer, size_t packet_count, Report
 }
 
 
+//----------------------------------------------------------------------------
+// Write discontiguous segments of packets, update their continuity counters
+//----------------------------------------------------------------------------
+
+bool ts::TSFileOutputResync::writeSegments(const PacketSegment* segments, size_t segment_count, Report& report)
+{
+    // Update continuity counters in all segments, in stream order.
+    for (size_t seg = 0; seg < segment_count; ++seg) {
+        for (size_t n = 0; n < segments[seg].count; ++n) {
+            _ccFixer.feedPacket(segments[seg].packets[n]);
+        }
+    }
+
+    // Invoke superclass for one vectored write.
+    return TSFile::writeSegments(segments, segment_count, report);
+}
+
+
 //----------------------------------------------------------------------------
 // Write packets, force PID value
 //----------------------------------------------------------------------------
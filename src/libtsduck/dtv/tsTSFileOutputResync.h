@@ -83,6 +83,20 @@ namespace ts {
         //!
         bool write(TSPacket* buffer, size_t packet_count, PID pid, Report& report);
 
+        //!
+        //! Write several discontiguous segments of TS packets to the file.
+        //! The continuity counters of all packets are modified, then all
+        //! segments are written in one vectored operation when the system
+        //! supports it. This is typically used to flush a circular buffer
+        //! whose content wraps around, without copying the packets first.
+        //! @param [in] segments Address of the first segment descriptor.
+        //! The packets in all segments are modified.
+        //! @param [in] segment_count Number of segments.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool writeSegments(const PacketSegment* segments, size_t segment_count, Report& report);
+
     private:
         ContinuityAnalyzer _ccFixer;
 
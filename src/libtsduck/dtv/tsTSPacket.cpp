@@ -605,6 +605,33 @@ bool ts::TSPacket::setPrivateData(const void* data, size_t size, bool shift_payl
     return true;
 }
 
+//----------------------------------------------------------------------------
+// Parse the TS packet header in one pass.
+//----------------------------------------------------------------------------
+
+void ts::TSPacket::parseHeader(Header& h) const
+{
+    // All intermediate values are computed with arithmetic instead of tests.
+    // Reading b[4] and b[5] unconditionally is always safe in the 188-byte
+    // packet, the flags select whether the values are meaningful or masked out.
+    const size_t has_af = (b[3] >> 5) & 1;
+    const size_t af_size = has_af * (size_t(b[4]) + 1);
+    const size_t header_size = std::min<size_t>(4 + af_size, PKT_SIZE);
+    const size_t has_pl = (b[3] >> 4) & 1;
+
+    h.pid = GetUInt16(b + 1) & 0x1FFF;
+    h.cc = b[3] & 0x0F;
+    h.af_flags = uint8_t(size_t(af_size > 1) * b[5]);
+    h.header_size = uint8_t(header_size);
+    h.payload_size = uint8_t(has_pl * (PKT_SIZE - header_size));
+    h.payload = has_pl != 0;
+    h.pusi = (b[1] & 0x40) != 0;
+    h.scrambled = (b[3] & 0xC0) != 0;
+
+    // Same validity rule as PCROffset(): the AF must contain the 6 PCR bytes.
+    h.pcr = (h.af_flags & 0x10) != 0 && af_size >= 8 ? GetPCR(b + 6) : INVALID_PCR;
+}
+
 //----------------------------------------------------------------------------
 // Get PCR or OPCR - 42 bits
 // Return 0 if not found.
@@ -951,6 +978,38 @@ bool ts::TSPacket::Locate(const uint8_t* buffer, size_t buffer_size, size_t& sta
 }
 
 
+//----------------------------------------------------------------------------
+// Locate all packets with an adaptation_field or a PCR in an array.
+//----------------------------------------------------------------------------
+
+size_t ts::TSPacket::LocateAF(const TSPacket* packets, size_t count, std::vector<size_t>& indexes)
+{
+    indexes.clear();
+    for (size_t i = 0; i < count; ++i) {
+        // Only test the adaptation_field_control flag, at a fixed offset.
+        if ((packets[i].b[3] & 0x20) != 0) {
+            indexes.push_back(i);
+        }
+    }
+    return indexes.size();
+}
+
+size_t ts::TSPacket::LocatePCR(const TSPacket* packets, size_t count, std::vector<size_t>& indexes)
+{
+    indexes.clear();
+    for (size_t i = 0; i < count; ++i) {
+        // Equivalent to hasPCR(), expanded on fixed offsets: an adaptation
+        // field is present, is not empty and has the PCR flag set. Only
+        // three header bytes of each packet are touched.
+        const uint8_t* const b = packets[i].b;
+        if ((b[3] & 0x20) != 0 && b[4] != 0 && (b[5] & 0x10) != 0) {
+            indexes.push_back(i);
+        }
+    }
+    return indexes.size();
+}
+
+
 //----------------------------------------------------------------------------
 // Error message fragment indicating the number of packets previously
 // read in a binary file
@@ -367,6 +367,36 @@ namespace ts {
             return hasPayload() ? PKT_SIZE - getHeaderSize() : 0;
         }
 
+        //!
+        //! Summary of the TS packet header, as filled in one pass by parseHeader().
+        //! All fields which depend on the adaptation field are already validated:
+        //! @a af_flags is zero when there is no flags byte and @a pcr is INVALID_PCR
+        //! when the adaptation field is too short to contain a PCR.
+        //!
+        struct TSDUCKDLL Header
+        {
+            uint64_t pcr;           //!< PCR value, INVALID_PCR when absent.
+            PID      pid;           //!< PID value.
+            uint8_t  cc;            //!< Value of the continuity_counter field.
+            uint8_t  af_flags;      //!< Adaptation field flags byte, zero when absent.
+            uint8_t  header_size;   //!< TS header size in bytes, also the payload offset.
+            uint8_t  payload_size;  //!< Payload size in bytes.
+            bool     payload;       //!< Value of the payload flag.
+            bool     pusi;          //!< Value of the payload_unit_start_indicator field.
+            bool     scrambled;     //!< The packet is scrambled (transport_scrambling_control != 0).
+        };
+
+        //!
+        //! Parse the TS packet header in one pass.
+        //! The individual accessors (getPID(), getCC(), getPayloadSize(), hasPCR(), etc.)
+        //! are convenient but each of them rechecks the adaptation field. Code which
+        //! inspects several fields per packet in a tight loop should parse the header
+        //! once and then use the fields of the resulting descriptor. The computation
+        //! is essentially branchless, the only conditional part is the PCR extraction.
+        //! @param [out] h Description of the packet header.
+        //!
+        void parseHeader(Header& h) const;
+
         //!
         //! Set the payload size.
         //! If the payload shall be shrunk, the adaptation field is enlarged
@@ -872,6 +902,39 @@ namespace ts {
         //!
         static bool Locate(const uint8_t* buffer, size_t buffer_size, size_t& start_index, size_t& packet_count);
 
+        //!
+        //! Locate all packets with an adaptation_field in a contiguous array of TS packets.
+        //!
+        //! This static method is a batch scanning kernel for processing
+        //! chains which work on windows of packets. The scan only touches
+        //! the fixed-offset header flags of each packet, so that the callers
+        //! can then restrict their per-packet processing to the returned
+        //! sparse index list.
+        //!
+        //! @param [in] packets Address of the first contiguous TS packet.
+        //! @param [in] count Number of TS packets in the array.
+        //! @param [out] indexes Indexes in the array of all packets with an
+        //! adaptation_field, in increasing order.
+        //! @return The number of packets with an adaptation_field.
+        //!
+        static size_t LocateAF(const TSPacket* packets, size_t count, std::vector<size_t>& indexes);
+
+        //!
+        //! Locate all packets with a Program Clock Reference (PCR) in a contiguous array of TS packets.
+        //!
+        //! This static method is a batch scanning kernel, see LocateAF().
+        //! Since PCR's are typically present in a small fraction of the
+        //! packets, PCR-centric processing chains can use the returned
+        //! index list to skip the vast majority of the window.
+        //!
+        //! @param [in] packets Address of the first contiguous TS packet.
+        //! @param [in] count Number of TS packets in the array.
+        //! @param [out] indexes Indexes in the array of all packets with a
+        //! PCR, in increasing order.
+        //! @return The number of packets with a PCR.
+        //!
+        static size_t LocatePCR(const TSPacket* packets, size_t count, std::vector<size_t>& indexes);
+
         //!
         //! Sanity check routine.
         //! Ensure that the TSPacket structure can
@@ -43,12 +43,15 @@ ts::TSPacketQueue::TSPacketQueue(size_t size) :
     _mutex(),
     _enqueued(),
     _dequeued(),
-    _buffer(size),
+    _buffer(std::max<size_t>(size, 1)),
+    _mdata(_buffer.size()),
     _pcr(1, 12),
-    _inCount(0),
-    _readIndex(0),
-    _writeIndex(0),
-    _bitrate(0)
+    _readCount(0),
+    _writeCount(0),
+    _readerWaiting(false),
+    _writerWaiting(false),
+    _bitrate(0),
+    _pcrBitrate(0)
 {
 }
 
@@ -65,14 +68,16 @@ void ts::TSPacketQueue::reset(size_t size)
     if (size != NPOS) {
         // Refuse to shrink too much. Keep at least one packet.
         _buffer.resize(std::max<size_t>(size, 1));
+        _mdata.resize(_buffer.size());
     }
 
     _eof = false;
     _stopped = false;
-    _inCount = 0;
-    _readIndex = 0;
-    _writeIndex = 0;
+    _readCount = 0;
+    _writeCount = 0;
     _bitrate = 0;
+    _pcrBitrate = 0;
+    _pcr.reset();
 }
 
 
@@ -93,36 +98,96 @@ size_t ts::TSPacketQueue::bufferSize() const
 
 bool ts::TSPacketQueue::lockWriteBuffer(TSPacket*& buffer, size_t& buffer_size, size_t min_size)
 {
-    GuardCondition lock(_mutex, _dequeued);
+    // Reset the metadata of the write window so that readers which use the
+    // metadata variants get default values when the writer does not provide any.
+    TSPacketMetadata* mdata = nullptr;
+    const bool ok = lockWriteBuffer(buffer, mdata, buffer_size, min_size);
+    for (size_t i = 0; i < buffer_size; ++i) {
+        mdata[i].reset();
+    }
+    return ok;
+}
 
-    // Maximum size we can allocate to the write window.
-    assert(_readIndex < _buffer.size());
-    assert(_writeIndex < _buffer.size());
-    const size_t max_size = _buffer.size() - _writeIndex;
+bool ts::TSPacketQueue::lockWriteBuffer(TSPacket*& buffer, TSPacketMetadata*& mdata, size_t& buffer_size, size_t min_size)
+{
+    const size_t size = _buffer.size();
+    const size_t windex = _writeCount.load() % size;
 
     // We cannot ask for more than the distance to the end of the buffer.
     // But we also need to wait for at least one packet.
+    const size_t max_size = size - windex;
     min_size = std::max<size_t>(1, std::min(min_size, max_size));
 
-    // Wait until we get enough free space.
-    while (!_stopped && _buffer.size() - _inCount < min_size) {
-        lock.waitCondition();
+    // Wait until we get enough free space. The fast path is lock-free, the
+    // mutex is only taken to sleep when the buffer is too full.
+    while (!_stopped && size - (_writeCount.load() - _readCount.load()) < min_size) {
+        GuardCondition lock(_mutex, _dequeued);
+        _writerWaiting = true;
+        if (!_stopped && size - (_writeCount.load() - _readCount.load()) < min_size) {
+            lock.waitCondition();
+        }
+        _writerWaiting = false;
     }
 
     // Return the write window.
-    buffer = &_buffer[_writeIndex];
+    buffer = &_buffer[windex];
+    mdata = &_mdata[windex];
     if (_stopped) {
         // The reader thread has reported a stop condition, we can no longer write into the buffer.
         buffer_size = 0;
     }
-    else if (_readIndex > _writeIndex) {
-        // The write window extends up to the read index (where packets were not yet consumed).
-        buffer_size = _readIndex - _writeIndex;
+    else {
+        // Return the contiguous part of the free space, up to the end of the buffer.
+        buffer_size = std::min(size - (_writeCount.load() - _readCount.load()), max_size);
+    }
+
+    // A write buffer is returned only when the reader thread does not want to terminate.
+    return !_stopped;
+}
+
+
+//----------------------------------------------------------------------------
+// Called by the writer thread to reserve the free space as two regions.
+//----------------------------------------------------------------------------
+
+bool ts::TSPacketQueue::lockWriteBuffer(TSPacket*& buffer1, TSPacketMetadata*& mdata1, size_t& size1,
+                                        TSPacket*& buffer2, TSPacketMetadata*& mdata2, size_t& size2,
+                                        size_t min_size)
+{
+    const size_t size = _buffer.size();
+    const size_t windex = _writeCount.load() % size;
+
+    // With two regions, the complete free space can be reserved,
+    // regardless of the position in the circular buffer.
+    min_size = std::max<size_t>(1, std::min(min_size, size));
+
+    // Wait until we get enough free space. The fast path is lock-free, the
+    // mutex is only taken to sleep when the buffer is too full.
+    while (!_stopped && size - (_writeCount.load() - _readCount.load()) < min_size) {
+        GuardCondition lock(_mutex, _dequeued);
+        _writerWaiting = true;
+        if (!_stopped && size - (_writeCount.load() - _readCount.load()) < min_size) {
+            lock.waitCondition();
+        }
+        _writerWaiting = false;
+    }
+
+    // First region: from the write index up to the end of the buffer.
+    // Second region: wrap up at the beginning of the buffer.
+    buffer1 = &_buffer[windex];
+    mdata1 = &_mdata[windex];
+    if (_stopped) {
+        // The reader thread has reported a stop condition, we can no longer write into the buffer.
+        buffer2 = nullptr;
+        mdata2 = nullptr;
+        size1 = size2 = 0;
     }
     else {
-        // The write window wraps up at the end of the buffer.
-        // Return only the first contiguous part of the write window.
-        buffer_size = max_size;
+        const size_t free_size = size - (_writeCount.load() - _readCount.load());
+        size1 = std::min(free_size, size - windex);
+        size2 = free_size - size1;
+        buffer2 = size2 > 0 ? &_buffer[0] : nullptr;
+        mdata2 = size2 > 0 ? &_mdata[0] : nullptr;
     }
 
     // A write buffer is returned only when the reader thread does not want to terminate.
@@ -136,12 +201,14 @@ bool ts::TSPacketQueue::lockWriteBuffer(TSPacket*& buffer, size_t& buffer_size,
 
 void ts::TSPacketQueue::releaseWriteBuffer(size_t count)
 {
-    GuardCondition lock(_mutex, _enqueued);
+    const size_t size = _buffer.size();
+    const size_t wcount = _writeCount.load();
+    const size_t windex = wcount % size;
 
-    // Verify that the specified size is compatible with the current write window.
-    assert(_readIndex < _buffer.size());
-    assert(_writeIndex < _buffer.size());
-    const size_t max_count = (_readIndex > _writeIndex ? _readIndex : _buffer.size()) - _writeIndex;
+    // Verify that the specified size is compatible with the free space.
+    // The committed packets may wrap up at the end of the circular buffer
+    // when the two-region variant of lockWriteBuffer() was used.
+    const size_t max_count = size - (wcount - _readCount.load());
 
     // This is a bug in the application to specify more than the max size.
     assert(count <= max_count);
@@ -152,18 +219,25 @@ void ts::TSPacketQueue::releaseWriteBuffer(size_t count)
     }
 
     // When the writer thread did not specify a bitrate, analyze PCR's.
-    if (_bitrate == 0) {
+    // The PCR analyzer belongs to the writer thread, only the resulting
+    // bitrate is published to the reader thread.
+    if (_bitrate.load() == 0) {
         for (size_t i = 0; i < count; ++i) {
-            _pcr.feedPacket(_buffer[_writeIndex + i]);
+            _pcr.feedPacket(_buffer[(windex + i) % size]);
+        }
+        if (_pcr.bitrateIsValid()) {
+            _pcrBitrate = _pcr.bitrate188();
         }
     }
 
-    // Mark written packets as part of the buffer.
-    _inCount += count;
-    _writeIndex = (_writeIndex + count) % _buffer.size();
+    // Publish the written packets to the reader thread.
+    _writeCount = wcount + count;
 
-    // Signal that packets have been enqueued
-    lock.signal();
+    // Wake up the reader thread if it sleeps on an empty buffer.
+    if (_readerWaiting.load()) {
+        GuardCondition lock(_mutex, _enqueued);
+        lock.signal();
+    }
 }
 
 
@@ -173,14 +247,13 @@ void ts::TSPacketQueue::releaseWriteBuffer(size_t count)
 
 void ts::TSPacketQueue::setBitrate(BitRate bitrate)
 {
-    Guard lock(_mutex);
-
     // Remember the bitrate value.
     _bitrate = bitrate;
 
     // If a specific value is given, reset PCR analysis.
     if (bitrate > 0) {
         _pcr.reset();
+        _pcrBitrate = 0;
     }
 }
 
@@ -191,8 +264,7 @@ void ts::TSPacketQueue::setBitrate(BitRate bitrate)
 
 bool ts::TSPacketQueue::eof() const
 {
-    Guard lock(_mutex);
-    return _eof && _inCount == 0;
+    return _eof && _writeCount.load() == _readCount.load();
 }
 
 
@@ -202,29 +274,22 @@ bool ts::TSPacketQueue::eof() const
 
 void ts::TSPacketQueue::setEOF()
 {
-    GuardCondition lock(_mutex, _enqueued);
     _eof = true;
 
     // We did not really enqueue packets but if a reader thread is waiting we need to wake it up.
+    GuardCondition lock(_mutex, _enqueued);
     lock.signal();
 }
 
 
 //----------------------------------------------------------------------------
-// Get bitrate, must be called with mutex held.
+// Get bitrate, called by the reader thread.
 //----------------------------------------------------------------------------
 
 ts::BitRate ts::TSPacketQueue::getBitrate() const
 {
-    if (_bitrate != 0) {
-        return _bitrate;
-    }
-    else if (_pcr.bitrateIsValid()) {
-        return _pcr.bitrate188();
-    }
-    else {
-        return 0;
-    }
+    const BitRate bitrate = _bitrate.load();
+    return bitrate != 0 ? bitrate : _pcrBitrate.load();
 }
 
 
@@ -234,27 +299,34 @@ ts::BitRate ts::TSPacketQueue::getBitrate() const
 
 bool ts::TSPacketQueue::getPacket(TSPacket& packet, BitRate& bitrate)
 {
-    GuardCondition lock(_mutex, _dequeued);
+    TSPacketMetadata mdata;
+    return getPacket(packet, mdata, bitrate);
+}
 
+bool ts::TSPacketQueue::getPacket(TSPacket& packet, TSPacketMetadata& mdata, BitRate& bitrate)
+{
     // Get bitrate, either from reader thread or from PCR analysis.
     bitrate = getBitrate();
 
-    // Get packet when available.
-    if (_inCount == 0) {
+    // Get packet when available. This path is lock-free.
+    const size_t rcount = _readCount.load();
+    if (_writeCount.load() == rcount) {
         // No packet available.
         return false;
     }
-    else {
-        // Return next packet.
-        packet = _buffer[_readIndex];
-        _readIndex = (_readIndex + 1) % _buffer.size();
-        _inCount--;
 
-        // Signal the condition that a packet was freed.
-        lock.signal();
+    // Return next packet.
+    const size_t rindex = rcount % _buffer.size();
+    packet = _buffer[rindex];
+    mdata = _mdata[rindex];
+    _readCount = rcount + 1;
 
-        return true;
+    // Wake up the writer thread if it sleeps on a full buffer.
+    if (_writerWaiting.load()) {
+        GuardCondition lock(_mutex, _dequeued);
+        lock.signal();
     }
+    return true;
 }
 
 
@@ -263,30 +335,51 @@ bool ts::TSPacketQueue::getPacket(TSPacket& packet, BitRate& bitrate)
 //----------------------------------------------------------------------------
 
 bool ts::TSPacketQueue::waitPackets(TSPacket* buffer, size_t buffer_count, size_t& actual_count, BitRate& bitrate)
+{
+    return waitPackets(buffer, nullptr, buffer_count, actual_count, bitrate);
+}
+
+bool ts::TSPacketQueue::waitPackets(TSPacket* buffer, TSPacketMetadata* mdata, size_t buffer_count, size_t& actual_count, BitRate& bitrate)
 {
     // Clear out params.
     actual_count = 0;
 
-    // Wait until there is some packet in the buffer.
-    GuardCondition lock(_mutex, _enqueued);
-    while (!_eof && !_stopped && _inCount == 0) {
-        lock.waitCondition();
+    const size_t size = _buffer.size();
+    size_t rcount = _readCount.load();
+
+    // Wait until there is some packet in the buffer. The mutex is only taken
+    // to sleep when the buffer is empty.
+    while (!_eof && !_stopped && _writeCount.load() == rcount) {
+        GuardCondition lock(_mutex, _enqueued);
+        _readerWaiting = true;
+        if (!_eof && !_stopped && _writeCount.load() == rcount) {
+            lock.waitCondition();
+        }
+        _readerWaiting = false;
     }
 
     // Return as many packets as we can. Ignore eof for now.
-    while (_inCount > 0 && buffer_count > 0) {
-        *buffer++ = _buffer[_readIndex];
+    const size_t wcount = _writeCount.load();
+    while (rcount < wcount && buffer_count > 0) {
+        const size_t rindex = rcount % size;
+        *buffer++ = _buffer[rindex];
+        if (mdata != nullptr) {
+            *mdata++ = _mdata[rindex];
+        }
+        rcount++;
         buffer_count--;
         actual_count++;
-        _readIndex = (_readIndex + 1) % _buffer.size();
-        _inCount--;
     }
+    _readCount = rcount;
 
     // Get bitrate, either from reader thread or from PCR analysis.
     bitrate = getBitrate();
 
-    // Signal that packets were freed.
-    _dequeued.signal();
+    // Wake up the writer thread if it sleeps on a full buffer.
+    if (actual_count > 0 && _writerWaiting.load()) {
+        GuardCondition lock(_mutex, _dequeued);
+        lock.signal();
+    }
 
     // Return false when no packet is returned. Do not return false immediately
     // when _eof is true, wait for all enqueued packets to be returned.
@@ -300,12 +393,10 @@ bool ts::TSPacketQueue::waitPackets(TSPacket* buffer, size_t buffer_count, size_
 
 void ts::TSPacketQueue::stop()
 {
-    GuardCondition lock(_mutex, _dequeued);
-
     // Report a stop condition.
     _stopped = true;
 
-    // Signal the condition that a packet was freed. This is not really freeing
-    // a packet but it means that the writer thread should wake up.
+    // Wake up the writer thread if it sleeps on a full buffer.
+    GuardCondition lock(_mutex, _dequeued);
     lock.signal();
 }
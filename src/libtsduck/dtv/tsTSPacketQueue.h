@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsTSPacket.h"
+#include "tsTSPacketMetadata.h"
 #include "tsPCRAnalyzer.h"
 #include "tsMutex.h"
 #include "tsCondition.h"
@@ -58,6 +59,18 @@ namespace ts {
     //!
     //! Termination conditions can be triggered on both sides.
     //!
+    //! The queue is strictly single-producer single-consumer and the packet
+    //! hand-off path is lock-free: the two threads communicate through atomic
+    //! packet counts over the circular buffer. The internal mutex and condition
+    //! variables are only used to suspend a thread when the buffer is empty or
+    //! full, never on the hand-off path.
+    //!
+    //! Packet metadata (such as input timestamps) can optionally be transmitted
+    //! along with the packets. The writer thread uses the variants of
+    //! lockWriteBuffer() which return metadata pointers and the reader thread
+    //! uses the corresponding variants of getPacket() and waitPackets(). When
+    //! the writer does not provide metadata, the reader gets default values.
+    //!
     class TSDUCKDLL TSPacketQueue
     {
         TS_NOCOPY(TSPacketQueue);
@@ -102,10 +115,45 @@ namespace ts {
         //!
         bool lockWriteBuffer(TSPacket*& buffer, size_t& buffer_size, size_t min_size = 1);
 
+        //!
+        //! Called by the writer thread to get a write buffer with its metadata.
+        //! This is the same as lockWriteBuffer() with additional access to the
+        //! metadata of the packets in the write window.
+        //! @param [out] buffer Address of the write buffer.
+        //! @param [out] mdata Address of the metadata for the packets in @a buffer.
+        //! @param [out] buffer_size Size in packets of the write buffer.
+        //! @param [in] min_size Minimum number of free packets to get. This is just a hint.
+        //! @return True when the write buffer is correctly available.
+        //! False when the reader thread has signalled a stop condition.
+        //!
+        bool lockWriteBuffer(TSPacket*& buffer, TSPacketMetadata*& mdata, size_t& buffer_size, size_t min_size = 1);
+
+        //!
+        //! Called by the writer thread to reserve the complete free space as two regions.
+        //! When the free space of the circular buffer wraps up at the end of the buffer,
+        //! it is returned as two distinct regions. This way, a complete batch of packets
+        //! can be written with one single reserve / commit sequence, even when it does
+        //! not fit in the contiguous part of the buffer.
+        //! @param [out] buffer1 Address of the first region of the write buffer.
+        //! @param [out] mdata1 Address of the metadata for the packets in @a buffer1.
+        //! @param [out] size1 Size in packets of the first region.
+        //! @param [out] buffer2 Address of the second region (start of the circular buffer).
+        //! Null pointer when the free space does not wrap up.
+        //! @param [out] mdata2 Address of the metadata for the packets in @a buffer2.
+        //! @param [out] size2 Size in packets of the second region. Can be zero.
+        //! @param [in] min_size Minimum total number of free packets to get. This is just a hint.
+        //! @return True when the write buffer is correctly available.
+        //! False when the reader thread has signalled a stop condition.
+        //!
+        bool lockWriteBuffer(TSPacket*& buffer1, TSPacketMetadata*& mdata1, size_t& size1,
+                             TSPacket*& buffer2, TSPacketMetadata*& mdata2, size_t& size2,
+                             size_t min_size = 1);
+
         //!
         //! Called by the writer thread to release the write buffer.
         //! The packets were written by the writer thread at the address which
-        //! was returned by lockWriteBuffer().
+        //! was returned by lockWriteBuffer(). The reader thread is notified
+        //! once for the whole batch of packets.
         //! @param [in] count Number of packets which were written in the buffer.
         //! Must be no greater than the size which was returned by lockWriteBuffer().
         //!
@@ -139,6 +187,16 @@ namespace ts {
         //!
         bool getPacket(TSPacket& packet, BitRate& bitrate);
 
+        //!
+        //! Called by the reader thread to get the next packet and its metadata without waiting.
+        //! @param [out] packet The returned packet. Unmodified when no packet is available.
+        //! @param [out] mdata The returned packet metadata. Unmodified when no packet is available.
+        //! @param [out] bitrate Input bitrate or zero if unknown.
+        //! @return True if a packet was returned in @a packet. False if none was available
+        //! or an end of file occured.
+        //!
+        bool getPacket(TSPacket& packet, TSPacketMetadata& mdata, BitRate& bitrate);
+
         //!
         //! Called by the reader thread to wait for packets.
         //! The reader thread is suspended until at least one packet is available.
@@ -150,6 +208,19 @@ namespace ts {
         //!
         bool waitPackets(TSPacket* buffer, size_t buffer_count, size_t& actual_count, BitRate& bitrate);
 
+        //!
+        //! Called by the reader thread to wait for packets and their metadata.
+        //! The reader thread is suspended until at least one packet is available.
+        //! @param [out] buffer Address of packet buffer.
+        //! @param [out] mdata Address of packet metadata buffer, same number of elements
+        //! as @a buffer. Can be a null pointer when the metadata are not needed.
+        //! @param [in] buffer_count Size of @a buffer in number of packets.
+        //! @param [out] actual_count Number of returned packets in @a buffer.
+        //! @param [out] bitrate Input bitrate or zero if unknown.
+        //! @return True if a packets were returned in @a buffer. False on error or end of file.
+        //!
+        bool waitPackets(TSPacket* buffer, TSPacketMetadata* mdata, size_t buffer_count, size_t& actual_count, BitRate& bitrate);
+
         //!
         //! Check if the writer thread has reported an end of file condition.
         //! @return True if the writer thread has reported an end of file condition.
@@ -162,19 +233,27 @@ namespace ts {
         void stop();
 
     private:
-        volatile bool     _eof;         // The writer thread has reported an end of file.
-        volatile bool     _stopped;     // The read thread has reported a stop condition.
-        mutable Mutex     _mutex;       // Protect access to shared data.
-        mutable Condition _enqueued;    // Signaled when packets are inserted.
-        mutable Condition _dequeued;    // Signaled when packets were freed.
-        TSPacketVector    _buffer;      // The packet buffer.
-        PCRAnalyzer       _pcr;         // PCR analyzer to get the bitrate.
-        size_t            _inCount;     // Number of packets currently inside the buffer.
-        size_t            _readIndex;   // Index of next packet to read.
-        size_t            _writeIndex;  // Index of next packet to write.
-        BitRate           _bitrate;     // Bitrate as set by the writer thread.
-
-        // Get bitrate, must be called with mutex held.
+        // The reader and writer threads communicate through monotonic atomic
+        // packet counts: _writeCount is incremented by the writer thread only,
+        // _readCount by the reader thread only. The difference is the number
+        // of packets in the buffer and the indexes in the circular buffer are
+        // the counts modulo the buffer size.
+        volatile bool     _eof;           // The writer thread has reported an end of file.
+        volatile bool     _stopped;       // The read thread has reported a stop condition.
+        mutable Mutex     _mutex;         // Used to suspend and wake up threads only.
+        mutable Condition _enqueued;      // Signaled when packets are inserted.
+        mutable Condition _dequeued;      // Signaled when packets were freed.
+        TSPacketVector    _buffer;        // The packet buffer.
+        TSPacketMetadataVector _mdata;    // The packet metadata, same indexes as _buffer.
+        PCRAnalyzer       _pcr;           // PCR analyzer, used by the writer thread only.
+        std::atomic<size_t>  _readCount;     // Total number of packets read from the queue.
+        std::atomic<size_t>  _writeCount;    // Total number of packets written to the queue.
+        std::atomic<bool>    _readerWaiting; // The reader thread sleeps on _enqueued.
+        std::atomic<bool>    _writerWaiting; // The writer thread sleeps on _dequeued.
+        std::atomic<BitRate> _bitrate;       // Bitrate as set by the writer thread.
+        std::atomic<BitRate> _pcrBitrate;    // Bitrate computed from PCR's by the writer thread.
+
+        // Get bitrate, called by the reader thread.
         BitRate getBitrate() const;
     };
 }
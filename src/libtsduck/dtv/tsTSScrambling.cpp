@@ -30,8 +30,13 @@
 #include "tsTSScrambling.h"
 #include "tsNames.h"
 #include "tsArgs.h"
+#include "tsGuardCondition.h"
+#include "tsTracepoint.h"
 TSDUCK_SOURCE;
 
+// Minimum number of packets per worker to engage the worker pool.
+#define MIN_PACKETS_PER_WORKER 8
+
 
 //----------------------------------------------------------------------------
 // Constructors.
@@ -45,6 +50,7 @@ ts::TSScrambling::TSScrambling(Report& report, uint8_t scrambling) :
     _out_cw_file(),
     _cw_list(),
     _next_cw(_cw_list.end()),
+    _prescheduled_parity(-1),
     _encrypt_scv(SC_CLEAR),
     _decrypt_scv(SC_CLEAR),
     _dvbcsa(),
@@ -52,7 +58,9 @@ ts::TSScrambling::TSScrambling(Report& report, uint8_t scrambling) :
     _idsa(),
     _aescbc(),
     _aesctr(),
-    _scrambler{nullptr, nullptr}
+    _scrambler{nullptr, nullptr},
+    _worker_count(0),
+    _workers()
 {
     setScramblingType(scrambling);
 }
@@ -65,6 +73,7 @@ ts::TSScrambling::TSScrambling(const TSScrambling& other) :
     _out_cw_file(),
     _cw_list(other._cw_list),
     _next_cw(_cw_list.end()),
+    _prescheduled_parity(-1),
     _encrypt_scv(SC_CLEAR),
     _decrypt_scv(SC_CLEAR),
     _dvbcsa(),
@@ -72,7 +81,9 @@ ts::TSScrambling::TSScrambling(const TSScrambling& other) :
     _idsa(),
     _aescbc(),
     _aesctr(),
-    _scrambler{nullptr, nullptr}
+    _scrambler{nullptr, nullptr},
+    _worker_count(other._worker_count),
+    _workers()
 {
     setScramblingType(_scrambling_type);
     _dvbcsa[0].setEntropyMode(other._dvbcsa[0].entropyMode());
@@ -87,6 +98,7 @@ ts::TSScrambling::TSScrambling(TSScrambling&& other) :
     _out_cw_file(),
     _cw_list(other._cw_list),
     _next_cw(_cw_list.end()),
+    _prescheduled_parity(-1),
     _encrypt_scv(SC_CLEAR),
     _decrypt_scv(SC_CLEAR),
     _dvbcsa(),
@@ -94,7 +106,9 @@ ts::TSScrambling::TSScrambling(TSScrambling&& other) :
     _idsa(),
     _aescbc(),
     _aesctr(),
-    _scrambler{nullptr, nullptr}
+    _scrambler{nullptr, nullptr},
+    _worker_count(other._worker_count),
+    _workers()
 {
     setScramblingType(_scrambling_type);
     _dvbcsa[0].setEntropyMode(other._dvbcsa[0].entropyMode());
@@ -102,6 +116,33 @@ ts::TSScrambling::TSScrambling(TSScrambling&& other) :
 }
 
 
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+ts::TSScrambling::~TSScrambling()
+{
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        _workers[i]->terminate();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Set the number of internal worker threads for window operations.
+//----------------------------------------------------------------------------
+
+void ts::TSScrambling::setWorkerCount(size_t count)
+{
+    // Terminate previous workers. New ones are created on the next window.
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        _workers[i]->terminate();
+    }
+    _workers.clear();
+    _worker_count = count;
+}
+
+
 //----------------------------------------------------------------------------
 // Force the usage of a specific algorithm.
 //----------------------------------------------------------------------------
@@ -155,6 +196,11 @@ bool ts::TSScrambling::setScramblingType(uint8_t scrambling, bool overrideExplic
     _scrambler[1]->setAlertHandler(this);
     _scrambler[0]->setCipherId(0);
     _scrambler[1]->setCipherId(1);
+
+    // Propagate the new type to the private context of the worker threads.
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        _workers[i]->scrambling->setScramblingType(scrambling, overrideExplicit);
+    }
     return true;
 }
 
@@ -162,6 +208,9 @@ void ts::TSScrambling::setEntropyMode(DVBCSA2::EntropyMode mode)
 {
     _dvbcsa[0].setEntropyMode(mode);
     _dvbcsa[1].setEntropyMode(mode);
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        _workers[i]->scrambling->setEntropyMode(mode);
+    }
 }
 
 
@@ -360,6 +409,7 @@ bool ts::TSScrambling::start()
 
     // Point next CW to end of list. Will loop to first one.
     _next_cw = _cw_list.end();
+    _prescheduled_parity = -1;
 
     // Create the output file for control words.
     if (!_out_cw_name.empty()) {
@@ -426,6 +476,7 @@ bool ts::TSScrambling::handleBlockCipherAlert(BlockCipher& cipher, AlertReason r
 void ts::TSScrambling::rewindFixedCW()
 {
     _next_cw = _cw_list.end();
+    _prescheduled_parity = -1;
     _encrypt_scv = SC_CLEAR;
     _decrypt_scv = SC_CLEAR;
 }
@@ -435,6 +486,17 @@ void ts::TSScrambling::rewindFixedCW()
 // Set the next fixed control word as scrambling key.
 //----------------------------------------------------------------------------
 
+void ts::TSScrambling::advanceFixedCW()
+{
+    if (_next_cw != _cw_list.end()) {
+        ++_next_cw;
+    }
+    if (_next_cw == _cw_list.end()) {
+        _next_cw = _cw_list.begin();
+    }
+    assert(_next_cw != _cw_list.end());
+}
+
 bool ts::TSScrambling::setNextFixedCW(int parity)
 {
     // Error if no fixed control word were provided on the command line.
@@ -443,17 +505,26 @@ bool ts::TSScrambling::setNextFixedCW(int parity)
         return false;
     }
 
-    // Point to next CW.
-    if (_next_cw != _cw_list.end()) {
-        ++_next_cw;
-    }
-    if (_next_cw == _cw_list.end()) {
-        _next_cw = _cw_list.begin();
+    const int p = parity & 1;
+    bool ok = true;
+
+    // Set the key in the cipher context of this parity, unless the key was
+    // already pre-scheduled there on the previous parity switch. In the
+    // latter case, the key schedule already ran, there is nothing to do.
+    if (_prescheduled_parity != p) {
+        advanceFixedCW();
+        ok = setCW(*_next_cw, p);
     }
-    assert(_next_cw != _cw_list.end());
 
-    // Set the key in the descrambler.
-    return setCW(*_next_cw, parity);
+    // Pre-schedule the next control word in the cipher context of the other
+    // parity. The key schedule runs now, in the middle of the crypto-period,
+    // and the next parity switch finds a ready-to-use context.
+    if (ok) {
+        advanceFixedCW();
+        ok = setCW(*_next_cw, p ^ 1);
+    }
+    _prescheduled_parity = ok ? (p ^ 1) : -1;
+    return ok;
 }
 
 
@@ -467,6 +538,10 @@ bool ts::TSScrambling::setCW(const ByteBlock& cw, int parity)
     assert(algo != nullptr);
 
     if (algo->setKey(cw.data(), cw.size())) {
+        // Propagate the key to the private context of the worker threads.
+        for (size_t i = 0; i < _workers.size(); ++i) {
+            _workers[i]->scrambling->_scrambler[parity & 1]->setKey(cw.data(), cw.size());
+        }
         _report.debug(u"using scrambling key: " + UString::Dump(cw, UString::SINGLE_LINE));
         return true;
     }
@@ -498,6 +573,9 @@ bool ts::TSScrambling::setEncryptParity(int parity)
 
 bool ts::TSScrambling::encrypt(TSPacket& pkt)
 {
+    // Static tracepoint on each scrambling operation.
+    TS_TRACEPOINT1(scrambling_encrypt, pkt.getPID());
+
     // Filter out encrypted packets.
     if (pkt.isScrambled()) {
         _report.error(u"try to scramble an already scrambled packet");
@@ -545,6 +623,9 @@ bool ts::TSScrambling::encrypt(TSPacket& pkt)
 
 bool ts::TSScrambling::decrypt(TSPacket& pkt)
 {
+    // Static tracepoint on each descrambling operation.
+    TS_TRACEPOINT1(scrambling_decrypt, pkt.getPID());
+
     // Clear or invalid packets are silently accepted.
     const uint8_t scv = pkt.getScrambling();
     if (scv != SC_EVEN_KEY && scv != SC_ODD_KEY) {
@@ -582,3 +663,208 @@ bool ts::TSScrambling::decrypt(TSPacket& pkt)
     }
     return ok;
 }
+
+
+//----------------------------------------------------------------------------
+// Encrypt / decrypt a contiguous window of TS packets.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::encrypt(TSPacket* pkt, size_t count)
+{
+    // Use the worker pool on large windows. With fixed control words, key
+    // switching is a sequential process and the window is processed inline.
+    if (_worker_count > 0 && !hasFixedCW() && count >= MIN_PACKETS_PER_WORKER * _worker_count && startWorkers()) {
+        return processWindow(pkt, count, true);
+    }
+    bool ok = true;
+    for (size_t i = 0; i < count; ++i) {
+        ok = encrypt(pkt[i]) && ok;
+    }
+    return ok;
+}
+
+bool ts::TSScrambling::decrypt(TSPacket* pkt, size_t count)
+{
+    // Same policy as the encryption of a window, see above.
+    if (_worker_count > 0 && !hasFixedCW() && count >= MIN_PACKETS_PER_WORKER * _worker_count && startWorkers()) {
+        return processWindow(pkt, count, false);
+    }
+    bool ok = true;
+    for (size_t i = 0; i < count; ++i) {
+        ok = decrypt(pkt[i]) && ok;
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Start the worker threads on first use.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::startWorkers()
+{
+    if (_workers.empty()) {
+        for (size_t i = 0; i < _worker_count; ++i) {
+            const ScramblingWorkerPtr worker(new ScramblingWorker(*this));
+            // A worker context never starts its own pool.
+            worker->scrambling->_worker_count = 0;
+            // Copy the current keys into the private context of the worker.
+            for (int parity = 0; parity < 2; ++parity) {
+                ByteBlock key;
+                _scrambler[parity]->getKey(key);
+                if (!key.empty()) {
+                    worker->scrambling->_scrambler[parity]->setKey(key.data(), key.size());
+                }
+            }
+            if (!worker->start()) {
+                // Cannot start the pool, revert to inline processing.
+                _report.error(u"error starting scrambling worker thread");
+                for (size_t w = 0; w < _workers.size(); ++w) {
+                    _workers[w]->terminate();
+                }
+                _workers.clear();
+                _worker_count = 0;
+                return false;
+            }
+            _workers.push_back(worker);
+        }
+    }
+    return !_workers.empty();
+}
+
+
+//----------------------------------------------------------------------------
+// Process a window of packets with the worker pool.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::processWindow(TSPacket* pkt, size_t count, bool encrypt)
+{
+    assert(!_workers.empty());
+
+    // Make sure the initial encryption parity is set before splitting the work.
+    if (encrypt && _encrypt_scv == SC_CLEAR && !setEncryptParity(SC_EVEN_KEY)) {
+        return false;
+    }
+
+    // Track the scrambling control value of the last scrambled packet, like
+    // the sequential path does. Must be done before the payloads are
+    // descrambled and the scrambling control values are cleared.
+    uint8_t last_scv = _decrypt_scv;
+    if (!encrypt) {
+        for (size_t i = count; i > 0; --i) {
+            const uint8_t scv = pkt[i-1].getScrambling();
+            if (scv == SC_EVEN_KEY || scv == SC_ODD_KEY) {
+                last_scv = scv;
+                break;
+            }
+        }
+    }
+
+    // Distribute disjoint ranges of the window over the workers.
+    const size_t chunk = (count + _workers.size() - 1) / _workers.size();
+    size_t submitted = 0;
+    for (size_t start = 0; start < count; start += chunk) {
+        ScramblingWorker& worker(*_workers[submitted++]);
+        worker.scrambling->_encrypt_scv = _encrypt_scv;
+        worker.scrambling->_decrypt_scv = _decrypt_scv;
+        worker.submit(pkt + start, std::min(chunk, count - start), encrypt);
+    }
+
+    // Wait for the completion of all ranges and collect the status.
+    bool ok = true;
+    for (size_t i = 0; i < submitted; ++i) {
+        ok = _workers[i]->waitCompletion() && ok;
+    }
+    _decrypt_scv = last_scv;
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Worker thread of the internal pool for window operations.
+//----------------------------------------------------------------------------
+
+ts::TSScrambling::ScramblingWorker::ScramblingWorker(TSScrambling& parent) :
+    Thread(),
+    scrambling(new TSScrambling(parent)),
+    _mutex(),
+    _work_cond(),
+    _done_cond(),
+    _pkt(nullptr),
+    _count(0),
+    _encrypt(false),
+    _pending(false),
+    _completed(false),
+    _terminate(false),
+    _ok(true)
+{
+}
+
+ts::TSScrambling::ScramblingWorker::~ScramblingWorker()
+{
+    terminate();
+}
+
+void ts::TSScrambling::ScramblingWorker::submit(TSPacket* pkt, size_t count, bool encrypt)
+{
+    GuardCondition lock(_mutex, _work_cond);
+    _pkt = pkt;
+    _count = count;
+    _encrypt = encrypt;
+    _pending = true;
+    _completed = false;
+    lock.signal();
+}
+
+bool ts::TSScrambling::ScramblingWorker::waitCompletion()
+{
+    GuardCondition lock(_mutex, _done_cond);
+    while (!_completed) {
+        lock.waitCondition();
+    }
+    return _ok;
+}
+
+void ts::TSScrambling::ScramblingWorker::terminate()
+{
+    {
+        GuardCondition lock(_mutex, _work_cond);
+        _terminate = true;
+        lock.signal();
+    }
+    waitForTermination();
+}
+
+void ts::TSScrambling::ScramblingWorker::main()
+{
+    for (;;) {
+        TSPacket* pkt = nullptr;
+        size_t count = 0;
+        bool do_encrypt = false;
+        {
+            GuardCondition lock(_mutex, _work_cond);
+            while (!_terminate && !_pending) {
+                lock.waitCondition();
+            }
+            if (_terminate) {
+                return;
+            }
+            pkt = _pkt;
+            count = _count;
+            do_encrypt = _encrypt;
+            _pending = false;
+        }
+
+        // Process the range outside the lock, crypto is the long part.
+        bool ok = true;
+        for (size_t i = 0; i < count; ++i) {
+            ok = (do_encrypt ? scrambling->encrypt(pkt[i]) : scrambling->decrypt(pkt[i])) && ok;
+        }
+
+        // Report completion to the waiting caller.
+        GuardCondition lock(_mutex, _done_cond);
+        _ok = ok;
+        _completed = true;
+        lock.signal();
+    }
+}
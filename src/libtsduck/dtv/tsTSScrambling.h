@@ -44,6 +44,9 @@
 #include "tsCTR.h"
 #include "tsIDSA.h"
 #include "tsMPEG.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
 
 namespace ts {
     //!
@@ -87,6 +90,12 @@ namespace ts {
         //!
         TSScrambling(TSScrambling&& other);
 
+        //!
+        //! Destructor.
+        //! Terminates the worker threads, if any.
+        //!
+        virtual ~TSScrambling();
+
         // Implementation of ArgsSupplierInterface.
         virtual void defineArgs(Args& args) const override;
         virtual bool loadArgs(DuckContext& duck, Args& args) override;
@@ -192,10 +201,91 @@ namespace ts {
         //!
         bool decrypt(TSPacket& pkt);
 
+        //!
+        //! Encrypt a contiguous window of TS packets with the current parity and corresponding CW.
+        //! All packets are encrypted with the same key since the parity can
+        //! only change between calls. Crypto is per-packet independent, so
+        //! workers may en/decrypt disjoint ranges of a window in parallel.
+        //! @param [in,out] pkt Address of the first packet to encrypt.
+        //! @param [in] count Number of packets to encrypt.
+        //! @return True on success, false if at least one packet could not be
+        //! encrypted. All other packets are encrypted anyway.
+        //!
+        bool encrypt(TSPacket* pkt, size_t count);
+
+        //!
+        //! Decrypt a contiguous window of TS packets, each with the CW corresponding to its parity.
+        //! @param [in,out] pkt Address of the first packet to decrypt.
+        //! @param [in] count Number of packets to decrypt.
+        //! @return True on success, false if at least one packet could not be
+        //! decrypted. All other packets are decrypted anyway.
+        //!
+        bool decrypt(TSPacket* pkt, size_t count);
+
+        //!
+        //! Set the number of internal worker threads for window operations.
+        //! With worker threads, encrypt() and decrypt() on a window of packets
+        //! split the window into disjoint ranges which are processed in
+        //! parallel (crypto is per-packet independent once the keys are set).
+        //! Each worker uses a private copy of the ciphers. Single-packet
+        //! operations and windows driven by a list of fixed control words
+        //! (where key switching is sequential) are still processed inline.
+        //! @param [in] count Number of worker threads. Zero (the default)
+        //! processes all windows inline on the caller thread.
+        //!
+        void setWorkerCount(size_t count);
+
     private:
         // List of control words
         typedef std::list<ByteBlock> CWList;
 
+        // Worker thread of the internal pool for window operations. Each
+        // worker owns a private copy of the scrambling context: the ciphers
+        // have internal state and usage counters which cannot be shared
+        // between threads. Work is submitted as a range of packets and the
+        // caller waits for the completion of all ranges.
+        class ScramblingWorker: public Thread
+        {
+            TS_NOBUILD_NOCOPY(ScramblingWorker);
+        public:
+            ScramblingWorker(TSScrambling& parent);
+            virtual ~ScramblingWorker();
+
+            // Submit a range of packets. One range at a time, submit() and
+            // waitCompletion() must alternate.
+            void submit(TSPacket* pkt, size_t count, bool encrypt);
+
+            // Wait for completion of the submitted range, return its status.
+            bool waitCompletion();
+
+            // Request termination of the thread and wait for it.
+            void terminate();
+
+            // Private copy of the parent context (accessible to TSScrambling).
+            SafePtr<TSScrambling, NullMutex> scrambling;
+
+        private:
+            virtual void main() override;
+
+            Mutex     _mutex;
+            Condition _work_cond;  // Signaled when work is submitted or termination requested.
+            Condition _done_cond;  // Signaled when the submitted range is completed.
+            TSPacket* _pkt;        // Submitted range of packets.
+            size_t    _count;
+            bool      _encrypt;    // Encrypt (true) or decrypt (false) the range.
+            bool      _pending;    // A range was submitted and not yet started.
+            bool      _completed;  // The submitted range is completed.
+            bool      _terminate;  // Termination request.
+            bool      _ok;         // Status of the completed range.
+        };
+        typedef SafePtr<ScramblingWorker, NullMutex> ScramblingWorkerPtr;
+
+        // Start the worker threads on first use. Return true if the pool is usable.
+        bool startWorkers();
+
+        // Process a window of packets with the worker pool.
+        bool processWindow(TSPacket* pkt, size_t count, bool encrypt);
+
         Report&          _report;
         uint8_t          _scrambling_type;
         bool             _explicit_type;
@@ -203,6 +293,7 @@ namespace ts {
         std::ofstream    _out_cw_file;
         CWList           _cw_list;
         CWList::iterator _next_cw;
+        int              _prescheduled_parity;  // Parity of the cipher context holding a pre-scheduled fixed CW (-1 if none).
         uint8_t          _encrypt_scv;  // Encryption: key to use (SC_EVEN_KEY or SC_ODD_KEY).
         uint8_t          _decrypt_scv;  // Decryption: previous scrambling_control value.
         DVBCSA2          _dvbcsa[2];    // Index 0 = even key, 1 = odd key.
@@ -211,8 +302,16 @@ namespace ts {
         CBC<AES>         _aescbc[2];
         CTR<AES>         _aesctr[2];
         CipherChaining*  _scrambler[2];
+        size_t           _worker_count;  // Requested number of worker threads.
+        std::vector<ScramblingWorkerPtr> _workers;  // Worker threads, started on first window.
+
+        // Advance the iterator on the list of fixed control words (cyclic).
+        void advanceFixedCW();
 
-        // Set the next fixed control word as scrambling key.
+        // Set the next fixed control word as scrambling key. The key schedule
+        // usually ran in advance: each time a parity becomes active, the
+        // following control word is pre-scheduled in the cipher context of the
+        // other parity so that the next parity switch finds a ready context.
         bool setNextFixedCW(int parity);
 
         // Implementation of BlockCipherAlertInterface.
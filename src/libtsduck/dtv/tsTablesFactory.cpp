@@ -33,6 +33,7 @@
 
 #include "tsTablesFactory.h"
 #include "tsNames.h"
+#include "tsMemory.h"
 TSDUCK_SOURCE;
 
 TS_DEFINE_SINGLETON(ts::TablesFactory);
@@ -54,8 +55,12 @@ ts::TablesFactory::TablesFactory() :
     _descriptorDisplays(),
     _casIdDescriptorDisplays(),
     _xmlModelFiles(),
-    _namesFiles()
+    _namesFiles(),
+    _sectionDisplaysIndex(),
+    _sectionLogsIndex()
 {
+    TS_ZERO(_tableIds);
+    TS_ZERO(_tableStandards);
 }
 
 
@@ -75,14 +80,19 @@ uint32_t ts::TablesFactory::SectionDisplayIndex(TID id, uint16_t cas)
 
 ts::TablesFactory::Register::Register(TID id, TableFactory factory, Standards standards)
 {
-    TablesFactory::Instance()->_tableIds.insert(std::make_pair(id, factory));
+    // Like a map insertion, the first registration of a table id wins.
+    if (TablesFactory::Instance()->_tableIds[id] == nullptr) {
+        TablesFactory::Instance()->_tableIds[id] = factory;
+    }
     TablesFactory::Instance()->_tableStandards[id] |= standards;
 }
 
 ts::TablesFactory::Register::Register(TID minId, TID maxId, TableFactory factory, Standards standards)
 {
     for (TID id = minId; id <= maxId; ++id) {
-        TablesFactory::Instance()->_tableIds.insert(std::make_pair(id, factory));
+        if (TablesFactory::Instance()->_tableIds[id] == nullptr) {
+            TablesFactory::Instance()->_tableIds[id] = factory;
+        }
         TablesFactory::Instance()->_tableStandards[id] |= standards;
     }
 }
@@ -166,14 +176,12 @@ ts::TablesFactory::RegisterNames::RegisterNames(const UString& filename)
 
 ts::TablesFactory::TableFactory ts::TablesFactory::getTableFactory(TID id) const
 {
-    auto it = _tableIds.find(id);
-    return it != _tableIds.end() ? it->second : nullptr;
+    return _tableIds[id];
 }
 
 ts::Standards ts::TablesFactory::getTableStandards(TID id) const
 {
-    auto it = _tableStandards.find(id);
-    return it != _tableStandards.end() ? it->second : STD_NONE;
+    return _tableStandards[id];
 }
 
 ts::TablesFactory::TableFactory ts::TablesFactory::getTableFactory(const UString& node_name) const
@@ -200,28 +208,46 @@ ts::DisplayCADescriptorFunction ts::TablesFactory::getCADescriptorDisplay(uint16
 // Common code for getSectionDisplay and getSectionLog.
 //----------------------------------------------------------------------------
 
+namespace {
+    // Binary search for an exact key in a flat sorted index.
+    template <typename FUNCTION>
+    FUNCTION FindInSectionIndex(const std::vector<std::pair<uint32_t,FUNCTION>>& index, uint32_t key)
+    {
+        const auto it = std::lower_bound(index.begin(), index.end(), key,
+                                         [](const std::pair<uint32_t,FUNCTION>& e, uint32_t k) { return e.first < k; });
+        return it != index.end() && it->first == key ? it->second : nullptr;
+    }
+}
+
 template <typename FUNCTION>
-FUNCTION ts::TablesFactory::getSectionFunction(TID id, uint16_t cas, const std::map<uint32_t,FUNCTION>& funcMap) const
+FUNCTION ts::TablesFactory::getSectionFunction(TID id, uint16_t cas, const std::map<uint32_t,FUNCTION>& funcMap, std::vector<std::pair<uint32_t,FUNCTION>>& index) const
 {
+    // Rebuild the flat sorted index when registrations were added since the
+    // last build. Registrations are only ever added, a size mismatch is a
+    // reliable staleness indicator. The map iteration is already sorted.
+    if (index.size() != funcMap.size()) {
+        index.assign(funcMap.begin(), funcMap.end());
+    }
+
     // Try with current CAS.
-    typename std::map<uint32_t, FUNCTION>::const_iterator it = funcMap.find(SectionDisplayIndex(id, cas));
+    FUNCTION func = FindInSectionIndex(index, SectionDisplayIndex(id, cas));
 
     // Try CAS-independent value if not found.
-    if (cas != CASID_NULL && it == funcMap.end()) {
-        it = funcMap.find(SectionDisplayIndex(id, CASID_NULL));
+    if (func == nullptr && cas != CASID_NULL) {
+        func = FindInSectionIndex(index, SectionDisplayIndex(id, CASID_NULL));
     }
 
-    return it != funcMap.end() ? it->second : nullptr;
+    return func;
 }
 
 ts::DisplaySectionFunction ts::TablesFactory::getSectionDisplay(TID id, uint16_t cas) const
 {
-    return getSectionFunction(id, cas, _sectionDisplays);
+    return getSectionFunction(id, cas, _sectionDisplays, _sectionDisplaysIndex);
 }
 
 ts::LogSectionFunction ts::TablesFactory::getSectionLog(TID id, uint16_t cas) const
 {
-    return getSectionFunction(id, cas, _sectionLogs);
+    return getSectionFunction(id, cas, _sectionLogs, _sectionLogsIndex);
 }
 
 
@@ -313,8 +339,10 @@ ts::DisplayDescriptorFunction ts::TablesFactory::getDescriptorDisplay(const EDID
 void ts::TablesFactory::getRegisteredTableIds(std::vector<TID>& ids) const
 {
     ids.clear();
-    for (std::map<TID,TableFactory>::const_iterator it = _tableIds.begin(); it != _tableIds.end(); ++it) {
-        ids.push_back(it->first);
+    for (size_t id = 0; id < 256; ++id) {
+        if (_tableIds[id] != nullptr) {
+            ids.push_back(TID(id));
+        }
     }
 }
 
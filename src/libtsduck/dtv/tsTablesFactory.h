@@ -353,8 +353,10 @@ namespace ts {
         };
 
     private:
-        std::map<TID, TableFactory>                      _tableIds;
-        std::map<TID, Standards>                         _tableStandards;
+        // Table ids are 8-bit values, the factories and standards are
+        // directly indexed by TID, without any map lookup.
+        TableFactory                                     _tableIds[256];
+        Standards                                        _tableStandards[256];
         std::map<EDID, DescriptorFactory>                _descriptorIds;
         std::map<UString, TableFactory>                  _tableNames;
         std::map<UString, DescriptorFactory>             _descriptorNames;
@@ -366,12 +368,19 @@ namespace ts {
         UStringList                                      _xmlModelFiles;             // Additional XML model files for tables.
         UStringList                                      _namesFiles;                // Additional names files.
 
+        // Flat sorted copies of _sectionDisplays and _sectionLogs for fast
+        // binary search lookup. They are lazily rebuilt on lookup when new
+        // registrations were added since the last build, which is detected
+        // by a size mismatch since registrations are only ever added.
+        mutable std::vector<std::pair<uint32_t, DisplaySectionFunction>> _sectionDisplaysIndex;
+        mutable std::vector<std::pair<uint32_t, LogSectionFunction>>     _sectionLogsIndex;
+
         // Build a key in _sectionDisplays and _sectionLogs.
         static uint32_t SectionDisplayIndex(TID id, uint16_t cas);
 
         // Common code for getSectionDisplay and getSectionLog.
         template <typename FUNCTION>
-        FUNCTION getSectionFunction(TID id, uint16_t cas, const std::map<uint32_t,FUNCTION>& funcMap) const;
+        FUNCTION getSectionFunction(TID id, uint16_t cas, const std::map<uint32_t,FUNCTION>& funcMap, std::vector<std::pair<uint32_t,FUNCTION>>& index) const;
 
         // Common code for getDescriptorFactory and getDescriptorDisplay.
         template <typename FUNCTION>
@@ -40,8 +40,14 @@
 #include "tsDuckProtocol.h"
 #include "tsxmlComment.h"
 #include "tsxmlElement.h"
+#include "tsMemory.h"
+#include "tsFatal.h"
 TSDUCK_SOURCE;
 
+// Size of the fixed header of a record in a binary capture log file:
+// 8-byte timestamp (milliseconds since Unix epoch) and 2-byte PID, in big endian format.
+#define CAPTURE_HEADER_SIZE 10
+
 #if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
 constexpr size_t ts::TablesLogger::DEFAULT_LOG_SIZE;
 #endif
@@ -59,10 +65,12 @@ ts::TablesLogger::TablesLogger(TablesDisplay& display) :
     _use_xml(false),
     _use_binary(false),
     _use_udp(false),
+    _use_capture(false),
     _text_destination(),
     _xml_destination(),
     _bin_destination(),
     _udp_destination(),
+    _cap_destination(),
     _multi_files(false),
     _flush(false),
     _rewrite_xml(false),
@@ -78,6 +86,7 @@ ts::TablesLogger::TablesLogger(TablesDisplay& display) :
     _logger(false),
     _log_size(DEFAULT_LOG_SIZE),
     _no_duplicate(false),
+    _no_dup_across(false),
     _pack_all_sections(false),
     _pack_and_flush(false),
     _fill_eit(false),
@@ -98,9 +107,12 @@ ts::TablesLogger::TablesLogger(TablesDisplay& display) :
     _xmlDoc(_report),
     _xmlOpen(false),
     _binfile(),
+    _capfile(),
+    _capture_time(Time::Epoch),
     _sock(false, _report),
-    _shortSections(),
-    _allSections(),
+    _shortHashes(),
+    _allHashes(),
+    _globalHashes(),
     _sectionsOnce(),
     _section_filters()
 {
@@ -151,6 +163,17 @@ void ts::TablesLogger::defineArgs(Args& args) const
               u"Save sections in the specified binary output file. "
               u"See also option -m, --multiple-files.");
 
+    args.option(u"capture-file", 0, Args::STRING);
+    args.help(u"capture-file", u"filename",
+              u"Spool all filtered sections in the specified binary capture log file. "
+              u"Each section is preceded by a 10-byte header: an 8-byte timestamp "
+              u"(number of milliseconds since 1970-01-01 UTC) and a 2-byte PID, both "
+              u"in big endian format. Unlike the other outputs, the capture log does "
+              u"not interpret or format the sections and can sustain very high section "
+              u"rates, at the cost of a later formatting pass. The most efficient "
+              u"capture uses --all-sections with --capture-file as only output. "
+              u"See option --replay in tstables to format a capture log afterwards.");
+
     args.option(u"fill-eit");
     args.help(u"fill-eit",
               u"Before exiting, add missing empty sections in EIT's and flush them. "
@@ -212,6 +235,12 @@ void ts::TablesLogger::defineArgs(Args& args) const
               u"ECM's only. By default, tables with long sections are reported only when "
               u"a new version is detected but tables with a short section are all reported.");
 
+    args.option(u"no-duplicate-across-pids");
+    args.help(u"no-duplicate-across-pids",
+              u"Implies --no-duplicate. Do not report a section which is identical "
+              u"to a previously reported one, even on another PID. This is useful when "
+              u"the same tables are cross-carried on several PID's or muxes.");
+
     args.option(u"no-encapsulation");
     args.help(u"no-encapsulation",
               u"With --ip-udp, send the tables as raw binary messages in UDP packets. "
@@ -289,7 +318,8 @@ bool ts::TablesLogger::loadArgs(DuckContext& duck, Args& args)
     _use_xml = args.present(u"xml-output");
     _use_binary = args.present(u"binary-output");
     _use_udp = args.present(u"ip-udp");
-    _use_text = args.present(u"output-file") || args.present(u"text-output") || ( !_use_xml && !_use_binary && !_use_udp);
+    _use_capture = args.present(u"capture-file");
+    _use_text = args.present(u"output-file") || args.present(u"text-output") || ( !_use_xml && !_use_binary && !_use_udp && !_use_capture);
 
     // --output-file and --text-output are synonyms.
     if (args.present(u"output-file") && args.present(u"text-output")) {
@@ -300,6 +330,7 @@ bool ts::TablesLogger::loadArgs(DuckContext& duck, Args& args)
     _xml_destination = args.value(u"xml-output");
     _bin_destination = args.value(u"binary-output");
     _udp_destination = args.value(u"ip-udp");
+    _cap_destination = args.value(u"capture-file");
     _text_destination = args.value(u"output-file", args.value(u"text-output").c_str());
 
     // Accept "-" as a specification for standard output (common convention in UNIX world).
@@ -326,7 +357,8 @@ bool ts::TablesLogger::loadArgs(DuckContext& duck, Args& args)
     _packet_index = args.present(u"packet-index");
     _logger = args.present(u"log");
     _log_size = args.intValue<size_t>(u"log-size", DEFAULT_LOG_SIZE);
-    _no_duplicate = args.present(u"no-duplicate");
+    _no_dup_across = args.present(u"no-duplicate-across-pids");
+    _no_duplicate = _no_dup_across || args.present(u"no-duplicate");
     _udp_raw = args.present(u"no-encapsulation");
     _use_current = !args.present(u"exclude-current");
     _use_next = args.present(u"include-next");
@@ -367,13 +399,17 @@ bool ts::TablesLogger::open()
     _xmlOut.close();
     _xmlDoc.clear();
     _xmlOpen = false;
-    _shortSections.clear();
-    _allSections.clear();
+    _shortHashes.clear();
+    _allHashes.clear();
+    _globalHashes.clear();
     _sectionsOnce.clear();
 
     if (_binfile.is_open()) {
         _binfile.close();
     }
+    if (_capfile.is_open()) {
+        _capfile.close();
+    }
     if (_sock.isOpen()) {
         _sock.close(_report);
     }
@@ -416,6 +452,12 @@ bool ts::TablesLogger::open()
         return false;
     }
 
+    // Open/create the binary capture log.
+    if (_use_capture && !createCaptureFile(_cap_destination)) {
+        _abort = true;
+        return false;
+    }
+
     // Initialize UDP output.
     if (_use_udp) {
         // Create UDP socket.
@@ -455,6 +497,9 @@ void ts::TablesLogger::close()
         if (_binfile.is_open()) {
             _binfile.close();
         }
+        if (_capfile.is_open()) {
+            _capfile.close();
+        }
         if (_sock.isOpen()) {
             _sock.close(_report);
         }
@@ -504,15 +549,8 @@ void ts::TablesLogger::handleTable(SectionDemux&, const BinaryTable& table)
     }
 
     // Ignore duplicate tables with a short section.
-    if (_no_duplicate && table.isShortSection()) {
-        if (_shortSections[pid].isNull() || *_shortSections[pid] != *table.sectionAt(0)) {
-            // Not the same section, keep it for next time.
-            _shortSections[pid] = new Section(*table.sectionAt(0), COPY);
-        }
-        else {
-            // Same section as previously, ignore it.
-            return;
-        }
+    if (_no_duplicate && table.isShortSection() && isDuplicate(pid, *table.sectionAt(0), _shortHashes)) {
+        return;
     }
 
     // Filtering done, now save data.
@@ -554,6 +592,13 @@ void ts::TablesLogger::handleTable(SectionDemux&, const BinaryTable& table)
         }
     }
 
+    if (_use_capture) {
+        // Spool each section in the capture log, without interpretation.
+        for (size_t i = 0; i < table.sectionCount(); ++i) {
+            saveCaptureSection(*table.sectionAt(i));
+        }
+    }
+
     if (_use_udp) {
         sendUDP(table);
     }
@@ -617,15 +662,8 @@ void ts::TablesLogger::handleSection(SectionDemux& demux, const Section& sect)
     }
 
     // Ignore duplicate sections.
-    if (_no_duplicate) {
-        if (_allSections[pid].isNull() || *_allSections[pid] != sect) {
-            // Not the same section, keep it for next time.
-            _allSections[pid] = new Section(sect, COPY);
-        }
-        else {
-            // Same section as previously, ignore it.
-            return;
-        }
+    if (_no_duplicate && isDuplicate(pid, sect, _allHashes)) {
+        return;
     }
 
     // Filtering done, now save data.
@@ -655,6 +693,10 @@ void ts::TablesLogger::handleSection(SectionDemux& demux, const Section& sect)
         }
     }
 
+    if (_use_capture) {
+        saveCaptureSection(sect);
+    }
+
     if (_use_udp) {
         sendUDP(sect);
     }
@@ -667,6 +709,19 @@ void ts::TablesLogger::handleSection(SectionDemux& demux, const Section& sect)
 }
 
 
+//----------------------------------------------------------------------------
+// Process one section from a binary capture log file (replay mode).
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::replaySection(const Section& sect, const Time& timestamp)
+{
+    // Use the original capture time in displays instead of the current time.
+    _capture_time = timestamp.UTCToLocal();
+    handleSection(_demux, sect);
+    _capture_time = Time::Epoch;
+}
+
+
 //----------------------------------------------------------------------------
 // Send UDP table and section.
 //----------------------------------------------------------------------------
@@ -689,7 +744,7 @@ void ts::TablesLogger::sendUDP(const ts::BinaryTable& table)
         // Build a TLV message.
         duck::LogTable msg;
         msg.pid = table.sourcePID();
-        msg.timestamp = SimulCryptDate(Time::CurrentLocalTime());
+        msg.timestamp = SimulCryptDate(displayTime());
         for (size_t i = 0; i < table.sectionCount(); ++i) {
             msg.sections.push_back(table.sectionAt(i));
         }
@@ -711,7 +766,7 @@ void ts::TablesLogger::sendUDP(const ts::Section& section)
         // Build a TLV message.
         duck::LogSection msg;
         msg.pid = section.sourcePID();
-        msg.timestamp = SimulCryptDate(Time::CurrentLocalTime());
+        msg.timestamp = SimulCryptDate(displayTime());
         msg.section = new Section(section, SHARE);
 
         // Serialize the message.
@@ -867,6 +922,79 @@ void ts::TablesLogger::saveBinarySection(const Section& sect)
 }
 
 
+//----------------------------------------------------------------------------
+// Create the binary capture log file. On error, set _abort and return false.
+//----------------------------------------------------------------------------
+
+bool ts::TablesLogger::createCaptureFile(const ts::UString& name)
+{
+    _report.verbose(u"creating %s", {name});
+    _capfile.open(name.toUTF8().c_str(), std::ios::out | std::ios::binary);
+
+    if (_capfile) {
+        return true;
+    }
+    else {
+        _report.error(u"error creating %s", {name});
+        _abort = true;
+        return false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Append a section to the binary capture log file.
+//----------------------------------------------------------------------------
+
+void ts::TablesLogger::saveCaptureSection(const Section& sect)
+{
+    // Build the fixed-size record header: timestamp and PID, in big endian format.
+    uint8_t header[CAPTURE_HEADER_SIZE];
+    PutUInt64(header, uint64_t(Time::CurrentUTC() - Time::UnixEpoch));
+    PutUInt16(header + 8, uint16_t(sect.sourcePID()));
+
+    // Write the header and the raw section content. This is a pure data copy,
+    // the section is not interpreted, not formatted, not even CRC-checked again.
+    if (!_capfile.write(reinterpret_cast<const char*>(header), sizeof(header)) || !sect.write(_capfile, _report)) {
+        _abort = true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Static routine to read one record from a binary capture log file.
+//----------------------------------------------------------------------------
+
+bool ts::TablesLogger::GetCaptureRecord(std::istream& strm, SectionPtr& section, Time& timestamp, Report& report)
+{
+    // Clear output parameters.
+    section.clear();
+    timestamp = Time::Epoch;
+
+    // Read the fixed-size record header.
+    uint8_t header[CAPTURE_HEADER_SIZE];
+    if (!strm.read(reinterpret_cast<char*>(header), sizeof(header))) {
+        // Report an error on a truncated header, not on a clean end of file.
+        if (strm.gcount() > 0) {
+            report.error(u"truncated record in capture log file");
+        }
+        return false;
+    }
+    timestamp = Time::UnixEpoch + MilliSecond(GetUInt64(header));
+
+    // Read the section which follows the header.
+    section = new Section();
+    CheckNonNull(section.pointer());
+    section->read(strm, CRC32::CHECK, report);
+    if (!section->isValid()) {
+        section.clear();
+        return false;
+    }
+    section->setSourcePID(PID(GetUInt16(header + 8)));
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Open/write/close XML file.
 //----------------------------------------------------------------------------
@@ -899,7 +1027,7 @@ void ts::TablesLogger::saveXML(const ts::BinaryTable& table)
     // Add an XML comment as first child of the table.
     UString comment(UString::Format(u" PID 0x%X (%d)", {table.sourcePID(), table.sourcePID()}));
     if (_time_stamp) {
-        comment += u", at " + UString(Time::CurrentLocalTime());
+        comment += u", at " + UString(displayTime());
     }
     if (_packet_index) {
         comment += UString::Format(u", first TS packet: %'d, last: %'d", {table.getFirstTSPacketIndex(), table.getLastTSPacketIndex()});
@@ -942,7 +1070,7 @@ void ts::TablesLogger::logSection(const Section& sect)
 
     // Display time stamp if required.
     if (_time_stamp) {
-        header += UString(Time::CurrentLocalTime());
+        header += UString(displayTime());
         header += u": ";
     }
 
@@ -985,6 +1113,43 @@ bool ts::TablesLogger::isFiltered(const Section& sect, uint16_t cas)
 }
 
 
+//----------------------------------------------------------------------------
+//  Check if a section is a duplicate of the last one and record its hash.
+//----------------------------------------------------------------------------
+
+bool ts::TablesLogger::isDuplicate(PID pid, const Section& sect, std::vector<uint64_t>& last_hashes)
+{
+    const uint64_t hash = sect.hash();
+
+    if (_no_dup_across) {
+        // Across PID's: suppress any section which was already reported once,
+        // regardless of the PID which carried it.
+        return !_globalHashes.insert(hash).second;
+    }
+    else {
+        // Per PID: suppress consecutive identical sections only.
+        // The flat table is lazily allocated, only when --no-duplicate is used.
+        if (last_hashes.empty()) {
+            last_hashes.resize(PID_MAX, 0);
+        }
+        const bool duplicate = last_hashes[pid] == hash;
+        last_hashes[pid] = hash;
+        return duplicate;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Time stamp to use in displays and messages.
+//----------------------------------------------------------------------------
+
+ts::Time ts::TablesLogger::displayTime() const
+{
+    // In replay mode, use the original capture time of the section.
+    return _capture_time == Time::Epoch ? Time::CurrentLocalTime() : _capture_time;
+}
+
+
 //----------------------------------------------------------------------------
 //  Display header information, before a table
 //----------------------------------------------------------------------------
@@ -1002,7 +1167,7 @@ void ts::TablesLogger::preDisplay(PacketCounter first, PacketCounter last)
     if ((_time_stamp || _packet_index) && !_logger) {
         strm << "* ";
         if (_time_stamp) {
-            strm << "At " << Time::CurrentLocalTime();
+            strm << "At " << displayTime();
         }
         if (_packet_index && _time_stamp) {
             strm << ", ";
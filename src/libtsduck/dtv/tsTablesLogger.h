@@ -43,6 +43,7 @@
 #include "tsSocketAddress.h"
 #include "tsUDPSocket.h"
 #include "tsCASMapper.h"
+#include "tsTime.h"
 #include "tsxmlTweaks.h"
 #include "tsxmlDocument.h"
 
@@ -137,6 +138,26 @@ namespace ts {
         //!
         static bool AnalyzeUDPMessage(const uint8_t* data, size_t size, bool no_encapsulation, SectionPtrVector& sections, Time& timestamp);
 
+        //!
+        //! Static routine to read one record from a binary capture log file (option --capture-file).
+        //! Each record contains a fixed-size header (timestamp and PID) followed by one raw section.
+        //! @param [in,out] strm Input stream, positioned at the beginning of a record.
+        //! @param [out] section Safe pointer to the section in the record.
+        //! @param [out] timestamp Original UTC time of the collection of the section.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on end of file or invalid record.
+        //!
+        static bool GetCaptureRecord(std::istream& strm, SectionPtr& section, Time& timestamp, Report& report);
+
+        //!
+        //! Process one section from a binary capture log file (replay mode).
+        //! The section goes through the same filters and outputs as a live section
+        //! with option --all-sections, using @a timestamp instead of the current time.
+        //! @param [in] section The section to process.
+        //! @param [in] timestamp Original UTC time of the collection of the section.
+        //!
+        void replaySection(const Section& section, const Time& timestamp);
+
     protected:
         // Implementation of interfaces.
         virtual void handleTable(SectionDemux&, const BinaryTable&) override;
@@ -148,10 +169,12 @@ namespace ts {
         bool                     _use_xml;           // Produce XML tables.
         bool                     _use_binary;        // Save binary sections.
         bool                     _use_udp;           // Send sections using UDP/IP.
+        bool                     _use_capture;       // Spool sections in a binary capture log file.
         UString                  _text_destination;  // Text output file name.
         UString                  _xml_destination;   // XML output file name.
         UString                  _bin_destination;   // Binary output file name.
         UString                  _udp_destination;   // UDP/IP destination address:port.
+        UString                  _cap_destination;   // Binary capture log file name.
         bool                     _multi_files;       // Multiple binary output files (one per section).
         bool                     _flush;             // Flush output file.
         bool                     _rewrite_xml;       // Rewrite a new XML file for each table.
@@ -167,6 +190,7 @@ namespace ts {
         bool                     _logger;            // Table logger.
         size_t                   _log_size;          // Size of table to log.
         bool                     _no_duplicate;      // Exclude duplicated short sections on a PID.
+        bool                     _no_dup_across;     // Suppress duplicated sections across all PID's.
         bool                     _pack_all_sections; // Pack all sections as if they were one table.
         bool                     _pack_and_flush;    // Pack and flush incomplete tables before exiting.
         bool                     _fill_eit;          // Add missing empty sections to incomplete EIT's before exiting.
@@ -189,9 +213,12 @@ namespace ts {
         xml::Document            _xmlDoc;            // XML root document.
         bool                     _xmlOpen;           // The XML root element is open.
         std::ofstream            _binfile;           // Binary output file.
+        std::ofstream            _capfile;           // Binary capture log file.
+        Time                     _capture_time;      // Original section time in replay mode (Epoch when live).
         UDPSocket                _sock;              // Output socket.
-        std::map<PID,SectionPtr> _shortSections;     // Tracking duplicate short sections by PID.
-        std::map<PID,SectionPtr> _allSections;       // Tracking duplicate sections by PID (with --all-sections).
+        std::vector<uint64_t>    _shortHashes;       // Hash of last short section per PID, lazily sized to PID_MAX.
+        std::vector<uint64_t>    _allHashes;         // Hash of last section per PID (with --all-sections).
+        std::set<uint64_t>       _globalHashes;      // Hashes of all reported sections with --no-duplicate-across-pids.
         std::set<uint64_t>       _sectionsOnce;      // Tracking sets of PID/TID/TDIext/secnum/version with --all-once.
         TablesLoggerFilterVector _section_filters;   // All registered section filters.
 
@@ -201,6 +228,15 @@ namespace ts {
         // Save a section in a binary file
         void saveBinarySection(const Section&);
 
+        // Create the binary capture log file. On error, set _abort and return false.
+        bool createCaptureFile(const UString& name);
+
+        // Append a section to the binary capture log file. Pure data copy, no interpretation.
+        void saveCaptureSection(const Section&);
+
+        // Time stamp to use in displays and messages: original capture time in replay mode, current time otherwise.
+        Time displayTime() const;
+
         // Open/write/close XML tables.
         bool createXML(const UString& name);
         void saveXML(const BinaryTable& table);
@@ -217,6 +253,10 @@ namespace ts {
         // Check if a specific section must be filtered and displayed.
         bool isFiltered(const Section& section, uint16_t cas);
 
+        // Check if a section is a duplicate of the last one and record its hash.
+        // O(1) hash comparison, no byte comparison, no stored section copy.
+        bool isDuplicate(PID pid, const Section& section, std::vector<uint64_t>& last_hashes);
+
         // Log a section (option --log).
         void logSection(const Section& section);
     };
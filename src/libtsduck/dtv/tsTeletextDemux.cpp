@@ -99,6 +99,32 @@ namespace {
         0x0f, 0x8f, 0x4f, 0xcf, 0x2f, 0xaf, 0x6f, 0xef, 0x1f, 0x9f, 0x5f, 0xdf, 0x3f, 0xbf, 0x7f, 0xff
     };
 
+    // Partial syndromes for the 24/18 Hamming code, one table per byte of
+    // the encoded triplet, computed on library initialization. The syndrome
+    // of a complete triplet is the XOR of the three table entries, with
+    // tests A-F in bits 0-5 (see ETSI 300 706, section 8.3).
+    struct Unham2418Syndromes
+    {
+        uint8_t table[3][256];
+        Unham2418Syndromes()
+        {
+            for (size_t part = 0; part < 3; ++part) {
+                for (size_t value = 0; value < 256; ++value) {
+                    uint8_t test = 0;
+                    for (size_t bit = 0; bit < 8; ++bit) {
+                        if ((value >> bit) & 0x01) {
+                            const size_t i = 8 * part + bit;
+                            // Bit 23 only participates in the parity test F.
+                            test ^= uint8_t(i == 23 ? 32 : i + 33);
+                        }
+                    }
+                    table[part][value] = test;
+                }
+            }
+        }
+    };
+    const Unham2418Syndromes unham2418;
+
     // Text foreground color codes.
     const ts::UChar* const TELETEXT_COLORS[8] = {
         // 0=black, 1=red,      2=green,    3=yellow,   4=blue,     5=magenta,  6=cyan,     7=white
@@ -119,15 +145,9 @@ uint8_t ts::TeletextDemux::unham_8_4(uint8_t a)
 
 uint32_t ts::TeletextDemux::unham_24_18(uint32_t a)
 {
-    uint8_t test = 0;
-
-    // Tests A-F correspond to bits 0-6 respectively in 'test'.
-    for (uint8_t i = 0; i < 23; i++) {
-        test ^= ((a >> i) & 0x01) * (i + 33);
-    }
-
-    // Only parity bit is tested for bit 24
-    test ^= ((a >> 23) & 0x01) * 32;
+    // Tests A-F correspond to bits 0-5 respectively in 'test'.
+    // The syndrome is computed with one table lookup per byte.
+    const uint8_t test = unham2418.table[0][a & 0xFF] ^ unham2418.table[1][(a >> 8) & 0xFF] ^ unham2418.table[2][(a >> 16) & 0xFF];
 
     if ((test & 0x1F) != 0x1F) {
         // Not all tests A-E correct
@@ -142,6 +162,13 @@ uint32_t ts::TeletextDemux::unham_24_18(uint32_t a)
     return (a & 0x000004) >> 2 | (a & 0x000070) >> 3 | (a & 0x007F00) >> 4 | (a & 0x7F0000) >> 5;
 }
 
+void ts::TeletextDemux::unham_24_18_row(const uint8_t* data, uint32_t* triplets, size_t count)
+{
+    for (size_t i = 0; i < count; ++i, data += 3) {
+        triplets[i] = unham_24_18(uint32_t(data[2]) << 16 | uint32_t(data[1]) << 8 | data[0]);
+    }
+}
+
 
 //-----------------------------------------------------------------------------
 // Convert a page number between binary and BCD.
@@ -166,7 +193,8 @@ ts::TeletextDemux::TeletextDemux(DuckContext& duck, TeletextHandlerInterface* ha
     SuperClass(duck, nullptr, pidFilter),
     _txtHandler(handler),
     _pids(),
-    _addColors(false)
+    _addColors(false),
+    _frame()
 {
 }
 
@@ -362,9 +390,7 @@ void ts::TeletextDemux::processTeletextPacket(PID pid, PIDContext& pc, uint8_t d
         uint32_t x26Col = 0;
 
         uint32_t triplets[13] = { 0 };
-        for (uint8_t i = 1, j = 0; i < 40; i += 3, j++) {
-            triplets[j] = unham_24_18((data[i + 2] << 16) | (data[i + 1] << 8) | data[i]);
-        }
+        unham_24_18_row(data + 1, triplets, 13);
 
         for (uint8_t j = 0; j < 13; j++) {
             if (triplets[j] == 0xffffffff) {
@@ -475,8 +501,8 @@ void ts::TeletextDemux::processTeletextPage(PID pid, PIDContext& pc, int pageNum
         page.hideTimestamp = page.showTimestamp;
     }
 
-    // Prepare the Teletext frame.
-    TeletextFrame frame(pid, pageBcdToBinary(pageNumber), page.frameCount, page.showTimestamp, page.hideTimestamp);
+    // Prepare the Teletext frame, reusing the pooled frame object.
+    _frame.reset(pid, pageBcdToBinary(pageNumber), page.frameCount, page.showTimestamp, page.hideTimestamp);
 
     // Process page data.
     for (int row = 1; row < 25; row++) {
@@ -596,13 +622,13 @@ void ts::TeletextDemux::processTeletextPage(PID pid, PIDContext& pc, int pageNum
         }
 
         // Line is now complete.
-        frame.addLine(line);
+        _frame.addLine(std::move(line));
     }
 
     // Now call the user-specified handler.
     // Note that the super class PESDemux has already placed us in "handler context".
     if (_txtHandler != nullptr) {
-        _txtHandler->handleTeletextMessage(*this, frame);
+        _txtHandler->handleTeletextMessage(*this, _frame);
     }
 }
 
@@ -35,6 +35,7 @@
 #pragma once
 #include "tsPESDemux.h"
 #include "tsTeletextCharset.h"
+#include "tsTeletextFrame.h"
 #include "tsTeletextHandlerInterface.h"
 #if !defined(TS_NOTELETEXT)
 
@@ -205,6 +206,15 @@ namespace ts {
         //!
         static uint32_t unham_24_18(uint32_t a);
 
+        //!
+        //! Remove the 24/18 Hamming code from a row of consecutive triplets.
+        //! @param [in] data Address of the Hamming-encoded triplets, 3 bytes each, least significant byte first.
+        //! @param [out] triplets Address of an array receiving the decoded triplets.
+        //! @param [in] count Number of triplets to decode.
+        //! @see ETSI 300 706, section 8.3.
+        //!
+        static void unham_24_18_row(const uint8_t* data, uint32_t* triplets, size_t count);
+
         //!
         //! Extract Teletext magazine number from Teletext page.
         //! @param [in] page Teletext page.
@@ -245,6 +255,7 @@ namespace ts {
         TeletextHandlerInterface* _txtHandler;    //!< User handler.
         PIDContextMap             _pids;          //!< Map of PID analysis contexts.
         bool                      _addColors;     //!< Add font color tags.
+        TeletextFrame             _frame;         //!< Pooled frame object, reused for each rendered page.
     };
 }
 
@@ -60,11 +60,31 @@ namespace ts {
                       MilliSecond        hideTimestamp = 0,
                       const UStringList& lines         = UStringList());
 
+        //!
+        //! Reinitialize the frame for reuse.
+        //! The text lines are cleared. Reusing the same frame object avoids
+        //! reallocating one frame per rendered page.
+        //! @param [in] pid PID number.
+        //! @param [in] page Teletext page number.
+        //! @param [in] frameCount Frame counter in this page, starting at 1.
+        //! @param [in] showTimestamp Show frame at this timestamp (in ms from start of stream)
+        //! @param [in] hideTimestamp Hide frame at this timestamp (in ms from start of stream)
+        //!
+        void reset(PID pid, int page, int frameCount, MilliSecond showTimestamp, MilliSecond hideTimestamp)
+        {
+            _pid = pid;
+            _page = page;
+            _frameCount = frameCount;
+            _showTimestamp = showTimestamp;
+            _hideTimestamp = hideTimestamp;
+            _lines.clear();
+        }
+
         //!
         //! Get the text lines. May contain embedded HTML tags.
-        //! @return The text lines.
+        //! @return A constant reference to the text lines.
         //!
-        UStringList lines() const
+        const UStringList& lines() const
         {
             return _lines;
         }
@@ -78,6 +98,15 @@ namespace ts {
             _lines.push_back(line);
         }
 
+        //!
+        //! Add a line of text to the frame (moved content).
+        //! @param [in,out] line Text line to add. The content is moved into the frame.
+        //!
+        void addLine(UString&& line)
+        {
+            _lines.push_back(std::move(line));
+        }
+
         //!
         //! Get the PID from which the frame originates.
         //! @return The PID from which the frame originates.
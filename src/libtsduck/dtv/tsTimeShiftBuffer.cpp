@@ -46,6 +46,7 @@ constexpr size_t ts::TimeShiftBuffer::DEFAULT_MEMORY_PACKETS;
 
 ts::TimeShiftBuffer::TimeShiftBuffer(size_t count) :
     _is_open(false),
+    _elide_null(false),
     _cur_packets(0),
     _total_packets(std::max(count, MIN_TOTAL_PACKETS)),
     _mem_packets(DEFAULT_MEMORY_PACKETS),
@@ -57,7 +58,20 @@ ts::TimeShiftBuffer::TimeShiftBuffer(size_t count) :
     _next_write(0),
     _wcache_next(0),
     _rcache_end(0),
-    _rcache_next(0)
+    _rcache_next(0),
+    _flags(),
+    _mem_queue(),
+    _file_read(0),
+    _file_write(0),
+    _file_count(0),
+    _mem_map(false),
+    _map_base(nullptr),
+#if defined(TS_WINDOWS)
+    _map_file(INVALID_HANDLE_VALUE),
+    _map_obj(INVALID_HANDLE_VALUE)
+#else
+    _map_fd(-1)
+#endif
 {
 }
 
@@ -104,6 +118,28 @@ bool ts::TimeShiftBuffer::setBackupDirectory(const UString& directory)
     }
 }
 
+bool ts::TimeShiftBuffer::setNullElision(bool on)
+{
+    if (_is_open) {
+        return false;
+    }
+    else {
+        _elide_null = on;
+        return true;
+    }
+}
+
+bool ts::TimeShiftBuffer::setMemoryMap(bool on)
+{
+    if (_is_open) {
+        return false;
+    }
+    else {
+        _mem_map = on;
+        return true;
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // Open the buffer.
@@ -117,8 +153,10 @@ bool ts::TimeShiftBuffer::open(Report& report)
     }
 
     if (memoryResident()) {
-        // The buffer is entirely memory-resident in _wcache.
-        _wcache.resize(_total_packets);
+        // The buffer is entirely memory-resident. With null packet elision,
+        // the stored packets are kept in _mem_queue which grows on demand,
+        // this is where the memory saving comes from.
+        _wcache.resize(_elide_null ? 0 : _total_packets);
         _rcache.clear();
     }
     else {
@@ -135,21 +173,35 @@ bool ts::TimeShiftBuffer::open(Report& report)
             }
         }
 
-        // Create the backup file. The flag temporary means that it will be deleted on close.
-        if (!_file.open(filename, TSFile::READ | TSFile::WRITE | TSFile::TEMPORARY, report)) {
-            return false;
+        if (_mem_map) {
+            // The backup file is accessed through a read-write memory mapping.
+            // The ring is addressed directly in the mapping, without caches.
+            if (!openMappedFile(filename, report)) {
+                return false;
+            }
+            _wcache.clear();
+            _rcache.clear();
+        }
+        else {
+            // Create the backup file. The flag temporary means that it will be deleted on close.
+            if (!_file.open(filename, TSFile::READ | TSFile::WRITE | TSFile::TEMPORARY, report)) {
+                return false;
+            }
+
+            // The read and write buffers use half of memory quota each.
+            // Since the size of the file is larger than the sum of the two,
+            // the read and write caches neve overlap when the buffer is full.
+            _wcache.resize(_mem_packets / 2);
+            _rcache.resize(_mem_packets / 2);
         }
- 
-        // The read and write buffers use half of memory quota each. 
-        // Since the size of the file is larger than the sum of the two,
-        // the read and write caches neve overlap when the buffer is full.
-        _wcache.resize(_mem_packets / 2);
-        _rcache.resize(_mem_packets / 2);
     }
 
     _cur_packets = 0;
     _next_read = _next_write = 0;
     _wcache_next = _rcache_end = _rcache_next = 0;
+    _flags.clear();
+    _mem_queue.clear();
+    _file_read = _file_write = _file_count = 0;
     _is_open = true;
     return true;
 }
@@ -169,6 +221,9 @@ bool ts::TimeShiftBuffer::close(Report& report)
     _cur_packets = 0;
     _wcache.clear();
     _rcache.clear();
+    _flags.clear();
+    _mem_queue.clear();
+    closeMappedFile();
     return !_file.isOpen() || _file.close(report);
 }
 
@@ -184,6 +239,11 @@ bool ts::TimeShiftBuffer::shift(TSPacket& pkt, Report& report)
         return false;
     }
 
+    // With null packet elision, the storage layout is completely different.
+    if (_elide_null) {
+        return shiftElided(pkt, report);
+    }
+
     TSPacket retpkt;
     const bool was_full = full();
 
@@ -191,20 +251,24 @@ bool ts::TimeShiftBuffer::shift(TSPacket& pkt, Report& report)
     assert(_next_read < _total_packets);
     assert(_next_write < _total_packets);
 
-    if (memoryResident()) {
-        // The buffer is entirely memory-resident in _wcache.
-        assert(_wcache.size() == _total_packets);
+    // With a memory-resident buffer or a memory-mapped backup file, the
+    // complete ring of packets is directly addressable.
+    TSPacket* const ring = memoryResident() ? _wcache.data() : reinterpret_cast<TSPacket*>(_map_base);
+
+    if (ring != nullptr) {
+        // The buffer is entirely addressable, either in _wcache or in the mapping.
+        assert(!memoryResident() || _wcache.size() == _total_packets);
         if (was_full) {
             // Buffer full: return oldest packet.
-            retpkt = _wcache[_next_read];
-            _next_read = (_next_read + 1) % _wcache.size();
+            retpkt = ring[_next_read];
+            _next_read = (_next_read + 1) % _total_packets;
         }
         else {
             // Buffer not full, increase the packet count.
             _cur_packets++;
         }
-        _wcache[_next_write] = pkt;
-        _next_write = (_next_write + 1) % _wcache.size();
+        ring[_next_write] = pkt;
+        _next_write = (_next_write + 1) % _total_packets;
     }
     else {
         // The buffer uses a backup file.
@@ -261,6 +325,221 @@ bool ts::TimeShiftBuffer::shift(TSPacket& pkt, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Push / pull one packet with null packet elision.
+//----------------------------------------------------------------------------
+
+bool ts::TimeShiftBuffer::shiftElided(TSPacket& pkt, Report& report)
+{
+    const bool was_full = full();
+    TSPacket retpkt;
+    bool ret_stored = false;
+
+    assert(_flags.size() == _cur_packets);
+
+    // Store the incoming packet. Null packets are reduced to their flag.
+    const bool is_stored = pkt.getPID() != PID_NULL;
+    _flags.push_back(is_stored ? 1 : 0);
+    if (is_stored) {
+        if (memoryResident()) {
+            _mem_queue.push_back(pkt);
+        }
+        else if (_map_base != nullptr) {
+            // Store directly in the mapped file ring. The write index never
+            // overwrites an unread packet: the number of stored packets
+            // never exceeds the number of buffered ones.
+            reinterpret_cast<TSPacket*>(_map_base)[_file_write] = pkt;
+            _file_write = (_file_write + 1) % _total_packets;
+        }
+        else {
+            // Append to the write cache, flush it to the file when full.
+            if (_wcache_next >= _wcache.size() && !flushWriteCache(report)) {
+                return false;
+            }
+            _wcache[_wcache_next++] = pkt;
+        }
+    }
+
+    if (!was_full) {
+        // Initial filling phase, nothing to pull yet.
+        _cur_packets++;
+    }
+    else {
+        // Pull the oldest packet. Elided null packets are regenerated.
+        ret_stored = _flags.front() != 0;
+        _flags.pop_front();
+        if (ret_stored) {
+            if (memoryResident()) {
+                retpkt = _mem_queue.front();
+                _mem_queue.pop_front();
+            }
+            else if (_map_base != nullptr) {
+                // Read directly from the mapped file ring.
+                retpkt = reinterpret_cast<TSPacket*>(_map_base)[_file_read];
+                _file_read = (_file_read + 1) % _total_packets;
+            }
+            else {
+                if (_rcache_next >= _rcache_end) {
+                    // Read cache is empty. If the oldest stored packet is
+                    // still in the write cache, flush it to the file first.
+                    if ((_file_count == 0 && !flushWriteCache(report)) || !loadReadCache(report)) {
+                        return false;
+                    }
+                }
+                retpkt = _rcache[_rcache_next++];
+            }
+        }
+    }
+
+    pkt = was_full && ret_stored ? retpkt : NullPacket;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// With null packet elision, flush the write cache to the backup file.
+//----------------------------------------------------------------------------
+
+bool ts::TimeShiftBuffer::flushWriteCache(Report& report)
+{
+    // The stored packets form a FIFO ring of at most _total_packets in the
+    // file. The write index never overwrites packets which are not yet read:
+    // the number of stored packets never exceeds the number of buffered ones.
+    size_t done = 0;
+    while (done < _wcache_next) {
+        const size_t count = std::min(_wcache_next - done, _total_packets - _file_write);
+        if (!writeFile(_file_write, &_wcache[done], count, report)) {
+            return false;
+        }
+        _file_write = (_file_write + count) % _total_packets;
+        done += count;
+    }
+    _file_count += _wcache_next;
+    _wcache_next = 0;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// With null packet elision, reload the read cache from the backup file.
+//----------------------------------------------------------------------------
+
+bool ts::TimeShiftBuffer::loadReadCache(Report& report)
+{
+    const size_t count = std::min(std::min(_rcache.size(), _file_count), _total_packets - _file_read);
+    _rcache_next = 0;
+    _rcache_end = count == 0 ? 0 : readFile(_file_read, &_rcache[0], count, report);
+    if (_rcache_end == 0) {
+        report.error(u"error reading time-shift file");
+        return false;
+    }
+    _file_read = (_file_read + _rcache_end) % _total_packets;
+    _file_count -= _rcache_end;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Create the backup file and map it in memory.
+//----------------------------------------------------------------------------
+
+bool ts::TimeShiftBuffer::openMappedFile(const UString& filename, Report& report)
+{
+    const uint64_t size = uint64_t(_total_packets) * PKT_SIZE;
+
+#if defined(TS_WINDOWS)
+
+    // Create a temporary file which is deleted on close.
+    _map_file = ::CreateFile(filename.toUTF8().c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+    if (_map_file == INVALID_HANDLE_VALUE) {
+        report.error(u"cannot create time-shift file %s: %s", {filename, ErrorCodeMessage(LastErrorCode())});
+        return false;
+    }
+
+    // Extend the file to the size of the complete ring.
+    ::LARGE_INTEGER pos;
+    pos.QuadPart = ::LONGLONG(size);
+    if (::SetFilePointerEx(_map_file, pos, NULL, FILE_BEGIN) == 0 || ::SetEndOfFile(_map_file) == 0) {
+        report.error(u"cannot resize time-shift file %s: %s", {filename, ErrorCodeMessage(LastErrorCode())});
+        closeMappedFile();
+        return false;
+    }
+
+    // Map the complete file in read-write mode.
+    _map_obj = ::CreateFileMapping(_map_file, NULL, PAGE_READWRITE, 0, 0, NULL);
+    _map_base = _map_obj == NULL ? nullptr : reinterpret_cast<uint8_t*>(::MapViewOfFile(_map_obj, FILE_MAP_WRITE, 0, 0, 0));
+    if (_map_base == nullptr) {
+        report.error(u"cannot map time-shift file %s in memory: %s", {filename, ErrorCodeMessage(LastErrorCode())});
+        closeMappedFile();
+        return false;
+    }
+
+#else
+
+    // Create the backup file.
+    if ((_map_fd = ::open(filename.toUTF8().c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600)) < 0) {
+        report.error(u"cannot create time-shift file %s: %s", {filename, ErrorCodeMessage(LastErrorCode())});
+        return false;
+    }
+
+    // Immediately delete the file name, the storage is released on close.
+    ::unlink(filename.toUTF8().c_str());
+
+    // Extend the file to the size of the complete ring.
+    if (::ftruncate(_map_fd, off_t(size)) < 0) {
+        report.error(u"cannot resize time-shift file %s: %s", {filename, ErrorCodeMessage(LastErrorCode())});
+        closeMappedFile();
+        return false;
+    }
+
+    // Map the complete file in read-write mode.
+    void* const base = ::mmap(nullptr, size_t(size), PROT_READ | PROT_WRITE, MAP_SHARED, _map_fd, 0);
+    if (base == MAP_FAILED) {
+        report.error(u"cannot map time-shift file %s in memory: %s", {filename, ErrorCodeMessage(LastErrorCode())});
+        closeMappedFile();
+        return false;
+    }
+    _map_base = reinterpret_cast<uint8_t*>(base);
+
+#endif
+
+    report.debug(u"time-shift file %s mapped in memory, %'d bytes", {filename, size});
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Unmap and close the memory-mapped backup file.
+//----------------------------------------------------------------------------
+
+void ts::TimeShiftBuffer::closeMappedFile()
+{
+#if defined(TS_WINDOWS)
+    if (_map_base != nullptr) {
+        ::UnmapViewOfFile(_map_base);
+        _map_base = nullptr;
+    }
+    if (_map_obj != INVALID_HANDLE_VALUE && _map_obj != NULL) {
+        ::CloseHandle(_map_obj);
+    }
+    _map_obj = INVALID_HANDLE_VALUE;
+    if (_map_file != INVALID_HANDLE_VALUE) {
+        ::CloseHandle(_map_file);
+        _map_file = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (_map_base != nullptr) {
+        ::munmap(_map_base, _total_packets * PKT_SIZE);
+        _map_base = nullptr;
+    }
+    if (_map_fd >= 0) {
+        ::close(_map_fd);
+        _map_fd = -1;
+    }
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Seek in the backup file.
 //----------------------------------------------------------------------------
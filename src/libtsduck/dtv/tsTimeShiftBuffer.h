@@ -103,6 +103,34 @@ namespace ts {
         //!
         bool setBackupDirectory(const UString& directory);
 
+        //!
+        //! Elide null packets in the buffer storage.
+        //! Must be called before open().
+        //! Null packets (PID 0x1FFF) are not stored, only their position in
+        //! the stream is remembered (one byte per buffered packet) and they
+        //! are transparently regenerated on output. Since muxes commonly
+        //! contain 30% or more stuffing, this proportionally reduces the
+        //! memory footprint of memory-resident buffers and the disk I/O of
+        //! file-backed ones. The payload of the original null packets is not
+        //! preserved, standard null packets are returned in their place.
+        //! @param [in] on When true, elide null packets in storage.
+        //! @return True on success, false if already open.
+        //!
+        bool setNullElision(bool on);
+
+        //!
+        //! Map the backup file in memory instead of using read/write operations.
+        //! Must be called before open().
+        //! The on-disk ring is accessed directly through a read-write memory
+        //! mapping: each buffered packet is one copy to or from the mapping,
+        //! without any seek, read or write system call, and the kernel pages
+        //! the ring in and out lazily. This has no effect when the buffer is
+        //! entirely memory-resident.
+        //! @param [in] on When true, map the backup file in memory.
+        //! @return True on success, false if already open.
+        //!
+        bool setMemoryMap(bool on);
+
         //!
         //! Open the buffer.
         //! @param [in,out] report Where to report errors.
@@ -167,6 +195,7 @@ namespace ts {
 
     private:
         bool           _is_open;       // Buffer is open.
+        bool           _elide_null;    // Elide null packets in storage.
         size_t         _cur_packets;   // Current number of packets in the buffer.
         size_t         _total_packets; // Total capacity of the buffer.
         size_t         _mem_packets;   // Max packets in memory.
@@ -180,9 +209,39 @@ namespace ts {
         size_t         _rcache_end;    // End index in _rcache (after last loaded packet).
         size_t         _rcache_next;   // Next index to read in _rcache.
 
+        // Null packet elision. One flag per buffered packet, in stream order,
+        // telling if the packet is a stored one or an elided null packet.
+        // Real packets are stored in FIFO order, either in _mem_queue (memory
+        // resident) or through _wcache -> backup file -> _rcache.
+        std::deque<uint8_t>  _flags;      // 1 = stored packet, 0 = elided null packet.
+        std::deque<TSPacket> _mem_queue;  // Stored packets in memory-resident mode.
+        size_t               _file_read;  // Index in file of next stored packet to read.
+        size_t               _file_write; // Index in file of next stored packet to write.
+        size_t               _file_count; // Stored packets in file, not yet read in _rcache.
+
+        // Memory-mapped backup file. When _map_base is not null, the on-disk
+        // ring is accessed through the mapping and the caches are unused.
+        bool     _mem_map;    // Map the backup file on next open.
+        uint8_t* _map_base;   // Base address of the mapping.
+#if defined(TS_WINDOWS)
+        ::HANDLE _map_file;   // Mapped file handle.
+        ::HANDLE _map_obj;    // File mapping object.
+#else
+        int      _map_fd;     // Mapped file descriptor.
+#endif
+
         // Seek, read, write in the backup file.
         bool seekFile(size_t index, Report& report);
         bool writeFile(size_t index, const TSPacket* buffer, size_t count, Report& report);
         size_t readFile(size_t index, TSPacket* buffer, size_t count, Report& report);
+
+        // Null packet elision mode.
+        bool shiftElided(TSPacket& pkt, Report& report);
+        bool flushWriteCache(Report& report);
+        bool loadReadCache(Report& report);
+
+        // Memory-mapped backup file.
+        bool openMappedFile(const UString& filename, Report& report);
+        void closeMappedFile();
     };
 }
@@ -88,7 +88,10 @@ ts::TimeTrackerDemux::TimeTrackerDemux(DuckContext& duck, const PIDSet& pid_filt
     SuperClass(duck, pid_filter),
     _pcrPID(PID_NULL),
     _pcrTime(PCR_SCALE),
-    _pids()
+    _pids(),
+    _packets(0),
+    _indexInterval(0),
+    _timeIndex()
 {
 }
 
@@ -98,6 +101,8 @@ void ts::TimeTrackerDemux::immediateReset()
     _pcrPID = PID_NULL;
     _pcrTime.reset();
     _pids.clear();
+    _packets = 0;
+    _timeIndex.clear();
 }
 
 void ts::TimeTrackerDemux::immediateResetPID(PID pid)
@@ -125,6 +130,14 @@ void ts::TimeTrackerDemux::feedPacket(const TSPacket& pkt)
         }
         if (pid == _pcrPID) {
             _pcrTime.set(pkt.getPCR());
+
+            // Record a time index entry when the stream time progressed enough.
+            if (_indexInterval > 0 && _pcrTime.isValid()) {
+                const MilliSecond now = MilliSecond((_pcrTime.duration() * 1000) / SYSTEM_CLOCK_FREQ);
+                if (_timeIndex.empty() || now >= _timeIndex.back().time + _indexInterval) {
+                    _timeIndex.push_back({now, _packets});
+                }
+            }
         }
     }
 
@@ -132,6 +145,31 @@ void ts::TimeTrackerDemux::feedPacket(const TSPacket& pkt)
     if (_pid_filter[pid] && pkt.hasPTS()) {
         _pids[pid].set(pkt.getPTS());
     }
+
+    // Count packets in the stream.
+    _packets++;
+}
+
+
+//----------------------------------------------------------------------------
+// Sampled time index management.
+//----------------------------------------------------------------------------
+
+void ts::TimeTrackerDemux::enableTimeIndex(MilliSecond interval)
+{
+    _indexInterval = interval;
+    if (interval <= 0) {
+        _timeIndex.clear();
+    }
+}
+
+ts::PacketCounter ts::TimeTrackerDemux::packetAtTime(MilliSecond time) const
+{
+    // Locate the first entry after the target time. The entry preceding it,
+    // if there is one, is the last indexed packet at or before the time.
+    const TimeIndex::const_iterator it = std::upper_bound(_timeIndex.begin(), _timeIndex.end(), time,
+        [](MilliSecond t, const TimeIndexEntry& e) { return t < e.time; });
+    return it == _timeIndex.begin() ? 0 : (it - 1)->packet;
 }
 
 
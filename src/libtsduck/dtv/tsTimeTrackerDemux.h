@@ -69,6 +69,42 @@ namespace ts {
         //!
         MilliSecond pidDuration(PID pid) const;
 
+        //!
+        //! Default interval between two entries of the time index, in milliseconds.
+        //!
+        static const MilliSecond DEFAULT_TIME_INDEX_INTERVAL = 500;
+
+        //!
+        //! Enable the collection of a sampled time index.
+        //!
+        //! When enabled, the demux periodically records the association between
+        //! the PCR time and the index of the current packet in the stream. The
+        //! index can later be searched using packetAtTime(), typically to seek
+        //! into a transport stream file without rescanning it from the start.
+        //! The index grows by one small entry per @a interval of stream time
+        //! and is disabled by default.
+        //! @param [in] interval Minimum stream time between two index entries
+        //! in milliseconds. Zero disables the index.
+        //!
+        void enableTimeIndex(MilliSecond interval = DEFAULT_TIME_INDEX_INTERVAL);
+
+        //!
+        //! Get the index of the packet at or immediately preceding a given time.
+        //! @param [in] time A time from the beginning of the stream in milliseconds,
+        //! based on the PCR's of the stream.
+        //! @return The index in the stream of the last indexed packet at or before
+        //! @a time. Return zero if the time index is disabled, empty or if @a time
+        //! is before the first indexed packet. The result is a safe starting point
+        //! for a forward scan: the packet at the target time is never skipped.
+        //!
+        PacketCounter packetAtTime(MilliSecond time) const;
+
+        //!
+        //! Get the number of entries in the time index.
+        //! @return The number of entries in the time index.
+        //!
+        size_t timeIndexCount() const { return _timeIndex.size(); }
+
         // Inherited methods
         virtual void feedPacket(const TSPacket& pkt) override;
 
@@ -118,8 +154,22 @@ namespace ts {
 
         typedef std::map<PID, TimeTracker> PIDContextMap;
 
-        PID           _pcrPID;    //!< First detected PID with PCR's.
-        TimeTracker   _pcrTime;   //!< PCR time tracker on _pcrPID.
-        PIDContextMap _pids;      //!< PTS time tracker per demuxed PID.
+        //!
+        //! One entry of the sampled time index.
+        //!
+        struct TimeIndexEntry
+        {
+            MilliSecond   time;    //!< PCR time from the beginning of the stream in milliseconds.
+            PacketCounter packet;  //!< Index of the corresponding packet in the stream.
+        };
+
+        typedef std::vector<TimeIndexEntry> TimeIndex;
+
+        PID           _pcrPID;         //!< First detected PID with PCR's.
+        TimeTracker   _pcrTime;        //!< PCR time tracker on _pcrPID.
+        PIDContextMap _pids;           //!< PTS time tracker per demuxed PID.
+        PacketCounter _packets;        //!< Number of packets fed in the demux.
+        MilliSecond   _indexInterval;  //!< Interval between time index entries, zero when disabled.
+        TimeIndex     _timeIndex;      //!< Sampled time index, sorted by time and packet index.
     };
 }
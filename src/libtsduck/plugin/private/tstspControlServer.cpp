@@ -35,6 +35,10 @@
 #include "tsTelnetConnection.h"
 #include "tsGuard.h"
 #include "tsSysUtils.h"
+#include "tsjsonObject.h"
+#include "tsjsonArray.h"
+#include "tsjsonNumber.h"
+#include "tsjsonString.h"
 TSDUCK_SOURCE;
 
 
@@ -58,7 +62,8 @@ ts::tsp::ControlServer::ControlServer(TSProcessorArgs& options, Report& log, Mut
               {TSPControlCommand::CMD_LIST,    &ControlServer::executeList},
               {TSPControlCommand::CMD_SUSPEND, &ControlServer::executeSuspend},
               {TSPControlCommand::CMD_RESUME,  &ControlServer::executeResume},
-              {TSPControlCommand::CMD_RESTART, &ControlServer::executeRestart}}
+              {TSPControlCommand::CMD_RESTART, &ControlServer::executeRestart},
+              {TSPControlCommand::CMD_METRICS, &ControlServer::executeMetrics}}
 {
     // Locate output plugin, count packet processor plugins.
     if (_input != nullptr) {
@@ -163,15 +168,19 @@ void ts::tsp::ControlServer::main()
         else if (conn.setReceiveTimeout(_options.control_timeout, _log) && conn.receiveLine(line, nullptr, _log)) {
             _log.verbose(u"received from %s: %s", {source, line});
 
-            // Reset the severity of the connection before analysing the line.
-            // A previous analysis may have used --verbose or --debug.
-            conn.setMaxSeverity(Severity::Info);
+            // Build the command response in a memory buffer, not directly on
+            // the connection. The command consequently executes without any
+            // network I/O: a slow or stuck client can only delay the final
+            // transmission of its own response, never the execution of a
+            // command while shared pipeline state is accessed. The command
+            // analysis may raise the severity of the response (--verbose).
+            ReportBuffer<NullMutex> response(Severity::Info);
 
-            // Analyze the command, return errors on the client connection.
+            // Analyze the command, return errors in the response buffer.
             TSPControlCommand::ControlCommand cmd = TSPControlCommand::CMD_NONE;
             const Args* args = nullptr;
             CommandHandler handler = nullptr;
-            if (_reference.analyze(line, cmd, args, conn)) {
+            if (_reference.analyze(line, cmd, args, response)) {
                 const auto it = _handlers.find(cmd);
                 if (it != _handlers.end()) {
                     handler = it->second;
@@ -181,10 +190,21 @@ void ts::tsp::ControlServer::main()
             // Execute the handler for this command or return an error message.
             if (handler != nullptr && args != nullptr) {
                 // Execute the command.
-                (this->*handler)(args, conn);
+                (this->*handler)(args, response);
             }
             else {
-                conn.error(u"invalid tsp control command: %s", {line});
+                response.error(u"invalid tsp control command: %s", {line});
+            }
+
+            // Send the buffered response to the client, one line at a time.
+            // The buffered lines have the same format as direct logging on
+            // the connection (severity header followed by the message).
+            if (!response.emptyMessages()) {
+                UStringVector resp_lines;
+                response.getMessages().split(resp_lines, u'\n', false, false);
+                for (size_t i = 0; i < resp_lines.size(); ++i) {
+                    conn.sendLine(resp_lines[i], _log);
+                }
             }
         }
 
@@ -348,11 +368,64 @@ void ts::tsp::ControlServer::executeRestart(const Args* args, Report& response)
         plugin = _output;
     }
 
-    // Restart the plugin.
-    if (same) {
+    // Restart the plugin. With --shadow, the new instance is prepared and
+    // started here, while the plugin keeps processing, and swapped in at a
+    // packet boundary.
+    if (args->present(u"shadow")) {
+        plugin->restartShadow(params, same, response);
+    }
+    else if (same) {
         plugin->restart(response);
     }
     else {
         plugin->restart(params, response);
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Metrics command.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ControlServer::executeMetrics(const Args* args, Report& response)
+{
+    // Collect all plugin executors in chain order.
+    std::vector<PluginExecutor*> execs;
+    execs.push_back(_input);
+    for (size_t i = 0; i < _plugins.size(); ++i) {
+        execs.push_back(_plugins[i]);
+    }
+    execs.push_back(_output);
+
+    if (args->present(u"json")) {
+        // Report all metrics as one JSON object.
+        json::Object root;
+        const json::ValuePtr plugins(new json::Array);
+        for (size_t i = 0; i < execs.size(); ++i) {
+            PluginExecutor* proc = execs[i];
+            const json::ValuePtr obj(new json::Object);
+            obj->add(u"index", json::ValuePtr(new json::Number(int64_t(i))));
+            obj->add(u"plugin", json::ValuePtr(new json::String(proc->pluginName())));
+            obj->add(u"packets", json::ValuePtr(new json::Number(int64_t(proc->pluginPackets()))));
+            obj->add(u"queue-depth", json::ValuePtr(new json::Number(int64_t(proc->metricsQueueDepth()))));
+            obj->add(u"wait-ns", json::ValuePtr(new json::Number(proc->metricsWaitTime())));
+            obj->add(u"processing-ns", json::ValuePtr(new json::Number(proc->metricsProcessingTime())));
+            plugins->set(obj);
+        }
+        root.add(u"plugins", plugins);
+        response.info(root.printed());
+    }
+    else {
+        // Report one text line per plugin. The times are in milliseconds.
+        for (size_t i = 0; i < execs.size(); ++i) {
+            PluginExecutor* proc = execs[i];
+            response.info(u"%2d: %-12s packets: %'d, queue: %'d, wait-ms: %'d, proc-ms: %'d", {
+                          i,
+                          proc->pluginName(),
+                          proc->pluginPackets(),
+                          proc->metricsQueueDepth(),
+                          proc->metricsWaitTime() / NanoSecPerMilliSec,
+                          proc->metricsProcessingTime() / NanoSecPerMilliSec});
+        }
+    }
+}
@@ -28,6 +28,8 @@
 //----------------------------------------------------------------------------
 
 #include "tstspInputExecutor.h"
+#include "tsSyncScan.h"
+#include "tsNullPacketRun.h"
 #include "tsTime.h"
 TSDUCK_SOURCE;
 
@@ -75,7 +77,7 @@ ts::tsp::InputExecutor::InputExecutor(const TSProcessorArgs& options,
 // Initializes the buffer for all plugin executors.
 //----------------------------------------------------------------------------
 
-bool ts::tsp::InputExecutor::initAllBuffers(PacketBuffer* buffer, PacketMetadataBuffer* metadata)
+bool ts::tsp::InputExecutor::initAllBuffers(PacketBuffer* buffer, TSPacketMetadata* metadata)
 {
     // Pre-declare buffer for input plugin.
     initBuffer(buffer, metadata, 0, buffer->count(), false, false, 0);
@@ -171,11 +173,11 @@ void ts::tsp::InputExecutor::handleWatchDogTimeout(WatchDog& watchdog)
 size_t ts::tsp::InputExecutor::receiveNullPackets(size_t index, size_t max_packets)
 {
     TSPacket* const pkt = _buffer->base() + index;
-    TSPacketMetadata* const data = _metadata->base() + index;
+    TSPacketMetadata* const data = _metadata + index;
 
-    // Fill the buffer with null packets.
+    // Fill the buffer with the preformed run of null packets.
+    FillNullPackets(pkt, max_packets);
     for (size_t n = 0; n < max_packets; ++n) {
-        pkt[n] = NullPacket;
         _pcr_analyzer.feedPacket(pkt[n]);
         _dts_analyzer.feedPacket(pkt[n]);
         data[n].reset();
@@ -201,7 +203,7 @@ size_t ts::tsp::InputExecutor::receiveAndValidate(size_t index, size_t max_packe
     }
 
     TSPacket* const pkt = _buffer->base() + index;
-    TSPacketMetadata* const data = _metadata->base() + index;
+    TSPacketMetadata* const data = _metadata + index;
 
     // Reset metadata for new incoming packets.
     for (size_t n = 0; n < max_packets; ++n) {
@@ -217,9 +219,12 @@ size_t ts::tsp::InputExecutor::receiveAndValidate(size_t index, size_t max_packe
         _watchdog.suspend();
     }
 
-    // Validate sync byte (0x47) at beginning of each packet
+    // Validate sync byte (0x47) at beginning of each packet. The vectorized
+    // scan checks the whole block at once; when it passes (the normal case),
+    // the per-packet test is skipped.
+    const bool all_in_sync = count > 0 && CheckSyncCadence(pkt->b, count * PKT_SIZE, PKT_SIZE);
     for (size_t n = 0; n < count; ++n) {
-        if (pkt[n].hasValidSync()) {
+        if (all_in_sync || pkt[n].hasValidSync()) {
             // Count good packets from plugin
             addPluginPackets(1);
 
@@ -268,8 +273,8 @@ size_t ts::tsp::InputExecutor::receiveAndStuff(size_t index, size_t max_packets)
     // If initial stuffing not yet completed, add initial stuffing.
     while (_instuff_start_remain > 0 && pkt_remain > 0) {
         _buffer->base()[index] = NullPacket;
-        _metadata->base()[index].reset();
-        _metadata->base()[index].setInputStuffing(true);
+        _metadata[index].reset();
+        _metadata[index].setInputStuffing(true);
         _instuff_start_remain--;
         index++;
         pkt_remain--;
@@ -340,7 +345,7 @@ void ts::tsp::InputExecutor::main()
 {
     debug(u"input thread started");
 
-    Time current_time(Time::CurrentUTC());
+    Time current_time(Time::CurrentUTCCoarse());
     Time bitrate_due_time(current_time + _options.bitrate_adj);
     PacketCounter bitrate_due_packet = _options.init_bitrate_adj;
     bool plugin_completed = false;
@@ -403,7 +408,7 @@ void ts::tsp::InputExecutor::main()
         // Process periodic bitrate adjustment.
         // In initial phase, as long as the bitrate is unknown, retry every init_bitrate_adj packets.
         // Once the bitrate is known, retry every bitrate_adj milliseconds.
-        if (_options.fixed_bitrate == 0 && ((_tsp_bitrate == 0 && pluginPackets() >= bitrate_due_packet) || (current_time = Time::CurrentUTC()) > bitrate_due_time)) {
+        if (_options.fixed_bitrate == 0 && ((_tsp_bitrate == 0 && pluginPackets() >= bitrate_due_packet) || (current_time = Time::CurrentUTCCoarse()) > bitrate_due_time)) {
 
             // When bitrate is unknown, retry in a fixed amount of packets.
             if (_tsp_bitrate == 0) {
@@ -75,7 +75,7 @@ namespace ts {
             //! @param [out] metadata Address of the packet metadata buffer.
             //! @return True on success, false on error.
             //!
-            bool initAllBuffers(PacketBuffer* buffer, PacketMetadataBuffer* metadata);
+            bool initAllBuffers(PacketBuffer* buffer, TSPacketMetadata* metadata);
 
             //!
             //! Access the shared library API.
@@ -84,6 +84,10 @@ namespace ts {
             //!
             InputPlugin* plugin() {return _input;}
 
+        protected:
+            // Refresh the typed plugin pointer after a shadow restart.
+            virtual void pluginSwapped() override {_input = dynamic_cast<InputPlugin*>(PluginThread::plugin());}
+
         private:
             InputPlugin* _input;                  // Plugin API
             bool         _in_sync_lost;           // Input synchronization lost (no 0x47 at start of packet)
@@ -33,12 +33,12 @@ TSDUCK_SOURCE;
 
 
 //----------------------------------------------------------------------------
-// Static data, access under protection of the global mutex only.
+// Static data, atomics, modified under protection of the global mutex only.
 //----------------------------------------------------------------------------
 
-int ts::tsp::JointTermination::_jt_users = 0;
-int ts::tsp::JointTermination::_jt_remaining = 0;
-ts::PacketCounter ts::tsp::JointTermination::_jt_hightest_pkt = 0;
+std::atomic<int> ts::tsp::JointTermination::_jt_users(0);
+std::atomic<int> ts::tsp::JointTermination::_jt_remaining(0);
+std::atomic<ts::PacketCounter> ts::tsp::JointTermination::_jt_hightest_pkt(0);
 
 
 //----------------------------------------------------------------------------
@@ -88,16 +88,16 @@ void ts::tsp::JointTermination::useJointTermination(bool on)
         Guard lock (_global_mutex);
         _jt_users++;
         _jt_remaining++;
-        debug(u"using \"joint termination\", now %d plugins use it", {_jt_users});
+        debug(u"using \"joint termination\", now %d plugins use it", {_jt_users.load()});
     }
     else if (!on && _use_jt) {
         _use_jt = false;
         Guard lock (_global_mutex);
         _jt_users--;
         _jt_remaining--;
-        assert (_jt_users >= 0);
-        assert (_jt_remaining >= 0);
-        debug(u"no longer using \"joint termination\", now %d plugins use it", {_jt_users});
+        assert (_jt_users.load() >= 0);
+        assert (_jt_remaining.load() >= 0);
+        debug(u"no longer using \"joint termination\", now %d plugins use it", {_jt_users.load()});
     }
 }
 
@@ -113,12 +113,15 @@ void ts::tsp::JointTermination::jointTerminate()
     if (_use_jt && !_jt_completed) {
         _jt_completed = true;
         Guard lock(_global_mutex);
-        _jt_remaining--;
-        assert(_jt_remaining >= 0);
-        if (totalPacketsInThread() > _jt_hightest_pkt) {
-            _jt_hightest_pkt = totalPacketsInThread();
+        // Update the packet limit before decrementing the count of remaining
+        // plugins: a reader which sees _jt_remaining at zero must also see
+        // the final value of _jt_hightest_pkt (release / acquire ordering).
+        if (totalPacketsInThread() > _jt_hightest_pkt.load(std::memory_order_relaxed)) {
+            _jt_hightest_pkt.store(totalPacketsInThread(), std::memory_order_relaxed);
         }
-        debug(u"completed for \"joint termination\", %d plugins remaining, current pkt limit: %'d", {_jt_remaining, _jt_hightest_pkt});
+        const int remaining = _jt_remaining.fetch_sub(1, std::memory_order_release) - 1;
+        assert(remaining >= 0);
+        debug(u"completed for \"joint termination\", %d plugins remaining, current pkt limit: %'d", {remaining, _jt_hightest_pkt.load(std::memory_order_relaxed)});
     }
 }
 
@@ -130,6 +133,10 @@ void ts::tsp::JointTermination::jointTerminate()
 
 ts::PacketCounter ts::tsp::JointTermination::totalPacketsBeforeJointTermination() const
 {
-    Guard lock (_global_mutex);
-    return !_options.ignore_jt && _jt_users > 0 && _jt_remaining <= 0 ? _jt_hightest_pkt : std::numeric_limits<PacketCounter>::max();
+    // Lock-free: this is evaluated on per-packet paths by all plugin executors.
+    // The acquire on _jt_remaining pairs with the release in jointTerminate():
+    // when the last plugin is seen completed, its packet limit is visible too.
+    return !_options.ignore_jt && _jt_users.load(std::memory_order_relaxed) > 0 && _jt_remaining.load(std::memory_order_acquire) <= 0 ?
+        _jt_hightest_pkt.load(std::memory_order_relaxed) :
+        std::numeric_limits<PacketCounter>::max();
 }
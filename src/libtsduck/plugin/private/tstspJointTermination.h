@@ -86,10 +86,13 @@ namespace ts {
             bool _use_jt;        // Use "joint termination"
             bool _jt_completed;  // Completed, for "joint termination"
 
-            // The following static private data must be accessed exclusively under the protection of the global mutex.
-            static int           _jt_users;         // Nb plugins using "joint termination"
-            static int           _jt_remaining;     // Nb pluging using jt but not yet completed
-            static PacketCounter _jt_hightest_pkt;  // Highest pkt# for completed jt plugins
+            // The following static private data are atomics: they are read on
+            // per-packet paths through totalPacketsBeforeJointTermination() and
+            // must not require the global mutex there. The global mutex is only
+            // taken on the rare state transitions to keep them consistent.
+            static std::atomic<int>           _jt_users;         // Nb plugins using "joint termination"
+            static std::atomic<int>           _jt_remaining;     // Nb pluging using jt but not yet completed
+            static std::atomic<PacketCounter> _jt_hightest_pkt;  // Highest pkt# for completed jt plugins
         };
     }
 }
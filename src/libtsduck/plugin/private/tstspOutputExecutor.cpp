@@ -100,7 +100,7 @@ void ts::tsp::OutputExecutor::main()
         // (ie. starting with a zero byte) are in the middle of the buffer.
 
         TSPacket* pkt = _buffer->base() + pkt_first;
-        TSPacketMetadata* data = _metadata->base() + pkt_first;
+        TSPacketMetadata* data = _metadata + pkt_first;
         size_t pkt_remain = pkt_cnt;
 
         while (pkt_remain > 0) {
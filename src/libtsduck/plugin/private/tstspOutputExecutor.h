@@ -67,6 +67,10 @@ namespace ts {
             //!
             OutputPlugin* plugin() {return _output;}
 
+        protected:
+            // Refresh the typed plugin pointer after a shadow restart.
+            virtual void pluginSwapped() override {_output = dynamic_cast<OutputPlugin*>(PluginThread::plugin());}
+
         private:
             OutputPlugin* _output;
 
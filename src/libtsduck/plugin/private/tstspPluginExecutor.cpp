@@ -31,8 +31,19 @@
 #include "tsPluginRepository.h"
 #include "tsGuardCondition.h"
 #include "tsGuard.h"
+#include "tsSysUtils.h"
+#include "tsMonotonic.h"
+#include "tsTracepoint.h"
 TSDUCK_SOURCE;
 
+// With --lock-free, number of busy-spin iterations in waitWork() before
+// falling back to 1-millisecond sleeps when the plugin has nothing to do.
+#define LOCK_FREE_SPIN_COUNT 1000
+
+// With --flush-latency, minimum flush batch size in packets when the
+// adaptive controller shrinks the batches.
+#define MIN_FLUSH_PKT 16
+
 
 //----------------------------------------------------------------------------
 // Constructors and destructors.
@@ -56,7 +67,17 @@ ts::tsp::PluginExecutor::PluginExecutor(const TSProcessorArgs& options,
     _input_end(false),
     _bitrate(0),
     _restart(false),
-    _restart_data()
+    _restart_data(),
+    _lock_free(options.lock_free),
+    _lf_added(0),
+    _lf_removed(0),
+    _lf_bitrate(0),
+    _lf_input_end(false),
+    _wait_ns(0),
+    _work_ns(0),
+    _flush_budget(options.flush_latency * NanoSecPerMilliSec),
+    _flush_size(0),
+    _last_flush(0)
 {
 }
 
@@ -71,7 +92,7 @@ ts::tsp::PluginExecutor::~PluginExecutor()
 //----------------------------------------------------------------------------
 
 void ts::tsp::PluginExecutor::initBuffer(PacketBuffer* buffer,
-                                         PacketMetadataBuffer* metadata,
+                                         TSPacketMetadata* metadata,
                                          size_t        pkt_first,
                                          size_t        pkt_cnt,
                                          bool          input_end,
@@ -86,6 +107,17 @@ void ts::tsp::PluginExecutor::initBuffer(PacketBuffer* buffer,
     _tsp_aborting = aborted;
     _bitrate = bitrate;
     _tsp_bitrate = bitrate;
+
+    // Initial state of the lock-free counters, executed before the threads are started.
+    _lf_added.store(pkt_cnt);
+    _lf_removed.store(0);
+    _lf_bitrate.store(bitrate);
+    _lf_input_end.store(input_end);
+
+    // Initial state of the adaptive flush controller. This is executed after
+    // applyDefaults(), _options.max_flush_pkt now has its final value.
+    _flush_size = _options.max_flush_pkt;
+    _last_flush = Monotonic::NanoClock();
 }
 
 
@@ -100,6 +132,55 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, BitRate bitrate, bool in
 
     log(10, u"passPackets(count = %'d, bitrate = %'d, input_end = %s, aborted = %s)", {count, bitrate, input_end, aborted});
 
+    // Static tracepoint on each window hand-off to the next plugin.
+    TS_TRACEPOINT2(tsp_pass_packets, count, bitrate);
+
+    // Adaptive flush batching: adjust the flush batch size from the observed
+    // delay between two flushes. When the delay exceeds the latency budget,
+    // halve the batch size to flush more often. When the delay stays well
+    // below the budget and the next plugin keeps up, double it again, up to
+    // --max-flushed-packets, to favor throughput.
+    if (_flush_budget > 0) {
+        const NanoSecond now = Monotonic::NanoClock();
+        const NanoSecond elapsed = now - _last_flush;
+        _last_flush = now;
+        if (elapsed > _flush_budget) {
+            _flush_size = std::max<size_t>(_flush_size / 2, MIN_FLUSH_PKT);
+        }
+        else if (elapsed < _flush_budget / 2 && ringNext<PluginExecutor>()->metricsQueueDepth() < _buffer->count() / 2) {
+            _flush_size = std::min(2 * _flush_size, _options.max_flush_pkt);
+        }
+    }
+
+    // Lock-free hand-off: no mutex, publish the packets to the next executor
+    // through the single-producer single-consumer atomic counters.
+    if (_lock_free) {
+        PluginExecutor* next = ringNext<PluginExecutor>();
+
+        // Update our private cursor in the circular buffer.
+        _pkt_first = (_pkt_first + count) % _buffer->count();
+        _pkt_cnt -= count;
+
+        // Publish to the next executor. The release store on _lf_added guarantees
+        // that the packet data are visible before the count is incremented.
+        next->_lf_bitrate.store(bitrate, std::memory_order_relaxed);
+        if (input_end) {
+            next->_lf_input_end.store(true, std::memory_order_relaxed);
+        }
+        _lf_removed.fetch_add(count, std::memory_order_relaxed);
+        next->_lf_added.fetch_add(count, std::memory_order_release);
+
+        // Force to abort our processor when the next one is aborting, except
+        // from output back to input (no propagation of packets on that edge).
+        if (plugin()->type() != OUTPUT_PLUGIN) {
+            aborted = aborted || next->_tsp_aborting;
+        }
+        if (aborted) {
+            _tsp_aborting = true; // volatile bool in TSP superclass, polled by the previous executor
+        }
+        return !input_end && !aborted;
+    }
+
     // We access data under the protection of the global mutex.
     Guard lock(_global_mutex);
 
@@ -137,6 +218,44 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, BitRate bitrate, bool in
 }
 
 
+//----------------------------------------------------------------------------
+// Common implementation of the flag bitmap accessors.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::getFlagBitmap(bool (TSPacketMetadata::*getter)() const, size_t pkt_first, size_t pkt_cnt, std::vector<uint64_t>& bitmap) const
+{
+    const size_t buf_cnt = _buffer->count();
+    const TSPacketMetadata* data = _metadata;
+
+    assert(pkt_first < buf_cnt);
+    assert(pkt_cnt <= buf_cnt);
+
+    bitmap.clear();
+    bitmap.resize((pkt_cnt + 63) / 64, 0);
+    for (size_t i = 0; i < pkt_cnt; ++i) {
+        if ((data[(pkt_first + i) % buf_cnt].*getter)()) {
+            bitmap[i / 64] |= uint64_t(1) << (i % 64);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the number of packets which are currently queued for this plugin.
+//----------------------------------------------------------------------------
+
+size_t ts::tsp::PluginExecutor::metricsQueueDepth() const
+{
+    if (_lock_free) {
+        return _lf_added.load(std::memory_order_relaxed) - _lf_removed.load(std::memory_order_relaxed);
+    }
+    else {
+        // Unsynchronized snapshot, a transient value is acceptable for metrics.
+        return _pkt_cnt;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // This method sets the current processor in an abort state.
 //----------------------------------------------------------------------------
@@ -167,6 +286,49 @@ void ts::tsp::PluginExecutor::waitWork(size_t& pkt_first, size_t& pkt_cnt, BitRa
 {
     log(10, u"waitWork(...)");
 
+    // Time spent in this method is accounted as wait time in the performance metrics.
+    const NanoSecond wait_start = Monotonic::NanoClock();
+
+    // Lock-free hand-off: poll the atomic counters instead of waiting on the
+    // condition variable. Busy-spin for a while, then back off to short sleeps.
+    if (_lock_free) {
+        PluginExecutor* next = ringNext<PluginExecutor>();
+        timeout = false;
+
+        size_t spin = 0;
+        MilliSecond waited = 0;
+        size_t avail = _lf_added.load(std::memory_order_acquire) - _lf_removed.load(std::memory_order_relaxed);
+
+        while (avail == 0 && !_lf_input_end.load(std::memory_order_relaxed) && !timeout && !next->_tsp_aborting) {
+            if (++spin > LOCK_FREE_SPIN_COUNT) {
+                SleepThread(1);
+                // If there is a timeout in the packet reception, call the plugin handler.
+                if (_tsp_timeout != Infinite && ++waited >= _tsp_timeout) {
+                    timeout = !plugin()->handlePacketTimeout();
+                    waited = 0;
+                }
+            }
+            avail = _lf_added.load(std::memory_order_acquire) - _lf_removed.load(std::memory_order_relaxed);
+        }
+
+        // Keep the local mirrors up to date, they are private to this thread in lock-free mode.
+        _pkt_cnt = avail;
+        _bitrate = _lf_bitrate.load(std::memory_order_relaxed);
+        _input_end = _input_end || _lf_input_end.load(std::memory_order_relaxed);
+
+        pkt_first = _pkt_first;
+        pkt_cnt = timeout ? 0 : std::min(avail, _buffer->count() - _pkt_first);
+        bitrate = _bitrate;
+        input_end = _input_end && pkt_cnt == avail;
+        aborted = plugin()->type() != OUTPUT_PLUGIN && next->_tsp_aborting;
+
+        _wait_ns.fetch_add(Monotonic::NanoClock() - wait_start, std::memory_order_relaxed);
+
+        log(10, u"waitWork(pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %s, aborted = %s, timeout = %s)",
+            {pkt_first, pkt_cnt, bitrate, input_end, aborted, timeout});
+        return;
+    }
+
     // We access data under the protection of the global mutex.
     GuardCondition lock(_global_mutex, _to_do);
 
@@ -192,6 +354,8 @@ void ts::tsp::PluginExecutor::waitWork(size_t& pkt_first, size_t& pkt_cnt, BitRa
     // there is no propagation of packets from output back to input.
     aborted = plugin()->type() != OUTPUT_PLUGIN && next->_tsp_aborting;
 
+    _wait_ns.fetch_add(Monotonic::NanoClock() - wait_start, std::memory_order_relaxed);
+
     log(10, u"waitWork(pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %s, aborted = %s, timeout = %s)",
         {pkt_first, pkt_cnt, bitrate, input_end, aborted, timeout});
 }
@@ -205,6 +369,7 @@ ts::tsp::PluginExecutor::RestartData::RestartData(const UStringVector& params, b
     report(rep),
     same_args(same),
     args(params),
+    shadow(nullptr),
     mutex(),
     condition(),
     completed(false)
@@ -226,6 +391,23 @@ void ts::tsp::PluginExecutor::restart(const UStringVector& params, Report& repor
     restart(RestartDataPtr(new RestartData(params, false, report)));
 }
 
+void ts::tsp::PluginExecutor::restartShadow(const UStringVector& params, bool same, Report& report)
+{
+    RestartDataPtr rd(new RestartData(params, same, report));
+
+    // Create and start the replacement instance now, in the context of the
+    // requesting thread, while the current instance keeps processing packets.
+    // This is the potentially long part of the restart.
+    rd->shadow = createShadowPlugin(params, same, report);
+    if (rd->shadow == nullptr) {
+        // Error message already displayed.
+        return;
+    }
+
+    // The plugin thread performs the quick swap at a packet boundary.
+    restart(rd);
+}
+
 void ts::tsp::PluginExecutor::restart(const RestartDataPtr& rd)
 {
     // Acquire the global mutex to modify global data.
@@ -238,6 +420,12 @@ void ts::tsp::PluginExecutor::restart(const RestartDataPtr& rd)
             GuardCondition lock2(_restart_data->mutex, _restart_data->condition);
             _restart_data->completed = true;
             _restart_data->report.error(u"restart interrupted by another concurrent restart");
+            // Discard a prepared shadow instance, it was never swapped in.
+            if (_restart_data->shadow != nullptr) {
+                _restart_data->shadow->stop();
+                delete _restart_data->shadow;
+                _restart_data->shadow = nullptr;
+            }
             // Notify the waiting thread that its restart command is aborted.
             lock2.signal();
         }
@@ -258,6 +446,69 @@ void ts::tsp::PluginExecutor::restart(const RestartDataPtr& rd)
 }
 
 
+//----------------------------------------------------------------------------
+// Create and start a second instance of the plugin for a shadow restart.
+//----------------------------------------------------------------------------
+
+ts::Plugin* ts::tsp::PluginExecutor::createShadowPlugin(const UStringVector& params, bool same, Report& report)
+{
+    // Allocate a second instance of the same plugin.
+    Plugin* shadow = nullptr;
+    switch (plugin()->type()) {
+        case INPUT_PLUGIN: {
+            NewInputProfile allocator = PluginRepository::Instance()->getInput(pluginName(), report);
+            if (allocator != nullptr) {
+                shadow = allocator(this);
+            }
+            break;
+        }
+        case PROCESSOR_PLUGIN: {
+            NewProcessorProfile allocator = PluginRepository::Instance()->getProcessor(pluginName(), report);
+            if (allocator != nullptr) {
+                shadow = allocator(this);
+            }
+            break;
+        }
+        case OUTPUT_PLUGIN: {
+            NewOutputProfile allocator = PluginRepository::Instance()->getOutput(pluginName(), report);
+            if (allocator != nullptr) {
+                shadow = allocator(this);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    if (shadow == nullptr) {
+        report.error(u"cannot create a second instance of plugin %s", {pluginName()});
+        return nullptr;
+    }
+
+    // Command line arguments for the new instance. Read the current arguments
+    // under the global mutex, the plugin thread may be using them.
+    UStringVector args(params);
+    if (same) {
+        Guard lock(_global_mutex);
+        plugin()->getCommandArgs(args);
+    }
+
+    // Analyze the command line and start the new instance. Errors are reported
+    // to the remote tspcontrol, not to the tsp process.
+    shadow->setShell(plugin()->getShell());
+    shadow->setFlags(plugin()->getFlags() | Args::NO_HELP | Args::NO_EXIT_ON_ERROR);
+    Report* const previous_report = shadow->redirectReport(&report);
+    const bool success = shadow->analyze(pluginName(), args, false) && shadow->getOptions() && shadow->start();
+    shadow->redirectReport(previous_report);
+
+    if (!success) {
+        report.error(u"failed to start the new instance of plugin %s", {pluginName()});
+        delete shadow;
+        return nullptr;
+    }
+    return shadow;
+}
+
+
 //----------------------------------------------------------------------------
 // Process a pending restart operation if there is one.
 //----------------------------------------------------------------------------
@@ -276,6 +527,27 @@ bool ts::tsp::PluginExecutor::processPendingRestart()
     // Now lock the content of the restart data.
     GuardCondition lock2(_restart_data->mutex, _restart_data->condition);
 
+    // Shadow restart: the replacement instance is already started, simply
+    // swap the two instances at this packet boundary.
+    if (_restart_data->shadow != nullptr) {
+        verbose(u"swapping in new plugin instance due to remote tspcontrol");
+        _restart_data->report.verbose(u"restarting plugin %s (shadow)", {pluginName()});
+        Plugin* const previous = swapPlugin(_restart_data->shadow);
+        _restart_data->shadow = nullptr;
+        // Let the subclass refresh its typed pointer on the plugin.
+        pluginSwapped();
+        // The old instance is no longer on the packet path, stop it.
+        previous->stop();
+        delete previous;
+        // Notify the calling thread that the restart is completed.
+        _restart_data->completed = true;
+        lock2.signal();
+        _restart = false;
+        _restart_data.clear();
+        debug(u"restarted plugin %s with shadow instance", {pluginName()});
+        return true;
+    }
+
     // Verbose message in the current tsp process and back to the remote tspcontrol.
     verbose(u"restarting due to remote tspcontrol");
     _restart_data->report.verbose(u"restarting plugin %s", {pluginName()});
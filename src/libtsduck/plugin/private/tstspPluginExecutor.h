@@ -38,6 +38,7 @@
 #include "tsPlugin.h"
 #include "tsUserInterrupt.h"
 #include "tsRingNode.h"
+#include "tsMonotonic.h"
 #include "tsCondition.h"
 #include "tsMutex.h"
 #include "tsThread.h"
@@ -77,7 +78,8 @@ namespace ts {
             //! Set the initial state of the buffer for this plugin.
             //! Must be executed in synchronous environment, before starting all executor threads.
             //! @param [in] buffer Address of the packet buffer.
-            //! @param [in] metadata Address of the packet metadata buffer.
+            //! @param [in] metadata Address of the packet metadata array, one
+            //! entry per packet in @a buffer, at the same index.
             //! @param [in] pkt_first Starting index of packets area for this plugin.
             //! @param [in] pkt_cnt Size of packets area for this plugin.
             //! @param [in] input_end If true, there is no more packet after current ones.
@@ -85,7 +87,7 @@ namespace ts {
             //! @param [in] bitrate Input bitrate (set by previous packet processor).
             //!
             void initBuffer(PacketBuffer* buffer,
-                            PacketMetadataBuffer* metadata,
+                            TSPacketMetadata* metadata,
                             size_t        pkt_first,
                             size_t        pkt_cnt,
                             bool          input_end,
@@ -143,9 +145,46 @@ namespace ts {
             //!
             void restart(Report& report);
 
+            //!
+            //! Restart the plugin using a shadow instance.
+            //! A second instance of the plugin is created, analyzed and started by
+            //! the calling thread while the current instance keeps processing
+            //! packets. The plugin thread then swaps the two instances at a packet
+            //! boundary, without interrupting the stream. The plugin must support
+            //! two concurrent instances (do not use on plugins which access an
+            //! exclusive device).
+            //! This method is called from another thread, not the plugin thread.
+            //! @param [in] params New command line parameters.
+            //! @param [in] same When true, ignore @a params and reuse the current parameters.
+            //! @param [in,out] report Where to report errors.
+            //!
+            void restartShadow(const UStringVector& params, bool same, Report& report);
+
+            //!
+            //! Get the cumulated time this plugin thread spent in waitWork(),
+            //! waiting for packets or buffer space.
+            //! Part of the performance instrumentation, may be read from another thread.
+            //! @return Cumulated wait time in nanoseconds.
+            //!
+            NanoSecond metricsWaitTime() const { return _wait_ns.load(std::memory_order_relaxed); }
+
+            //!
+            //! Get the cumulated time this plugin spent processing packets.
+            //! Measured per window of packets by the subclasses which support it.
+            //! @return Cumulated processing time in nanoseconds.
+            //!
+            NanoSecond metricsProcessingTime() const { return _work_ns.load(std::memory_order_relaxed); }
+
+            //!
+            //! Get the number of packets which are currently queued for this plugin.
+            //! This is a raw snapshot, not synchronized with the plugin thread.
+            //! @return Number of packets currently owned by this plugin.
+            //!
+            size_t metricsQueueDepth() const;
+
         protected:
             PacketBuffer*         _buffer;    //!< Description of shared packet buffer.
-            PacketMetadataBuffer* _metadata;  //!< Description of shared packet metadata buffer.
+            TSPacketMetadata*     _metadata;  //!< Shared packet metadata array, same indexes as the packet buffer.
             volatile bool         _suspended; //!< The plugin is suspended / resumed.
 
             //!
@@ -190,6 +229,48 @@ namespace ts {
             //!
             void waitWork(size_t& pkt_first, size_t& pkt_cnt, BitRate& bitrate, bool& input_end, bool& aborted, bool &timeout);
 
+            //!
+            //! Collect the "input stuffing" flag of a range of packets as a compact bitmap.
+            //! This is a structure-of-arrays view of the metadata buffer: bit @a i of word
+            //! <code>i / 64</code> in @a bitmap corresponds to packet @a pkt_first + @a i.
+            //! Flag-only scans then test one bit per packet instead of reading one full
+            //! metadata object per packet.
+            //! @param [in] pkt_first Index of the first packet in the buffer.
+            //! @param [in] pkt_cnt Number of packets. The area may wrap up at the end of the buffer.
+            //! @param [out] bitmap Receives the flag bits, one per packet, 64 packets per word.
+            //!
+            void getInputStuffingBitmap(size_t pkt_first, size_t pkt_cnt, std::vector<uint64_t>& bitmap) const
+            {
+                getFlagBitmap(&TSPacketMetadata::getInputStuffing, pkt_first, pkt_cnt, bitmap);
+            }
+
+            //!
+            //! Collect the "nullified" flag of a range of packets as a compact bitmap.
+            //! @param [in] pkt_first Index of the first packet in the buffer.
+            //! @param [in] pkt_cnt Number of packets. The area may wrap up at the end of the buffer.
+            //! @param [out] bitmap Receives the flag bits, one per packet, 64 packets per word.
+            //! @see getInputStuffingBitmap()
+            //!
+            void getNullifiedBitmap(size_t pkt_first, size_t pkt_cnt, std::vector<uint64_t>& bitmap) const
+            {
+                getFlagBitmap(&TSPacketMetadata::getNullified, pkt_first, pkt_cnt, bitmap);
+            }
+
+            //!
+            //! Cumulate packet processing time, invoked by subclasses per window of packets.
+            //! @param [in] ns Processing duration to add, in nanoseconds.
+            //!
+            void addProcessingTime(NanoSecond ns) { _work_ns.fetch_add(ns, std::memory_order_relaxed); }
+
+            //!
+            //! Get the number of packets to process between two flushes to the next plugin.
+            //! Without --flush-latency, this is the fixed --max-flushed-packets value.
+            //! With --flush-latency, the value is adjusted by passPackets() to stay
+            //! within the latency budget while batching as much as possible.
+            //! @return Current flush batch size in packets.
+            //!
+            size_t flushSize() const { return _flush_budget > 0 ? _flush_size : _options.max_flush_pkt; }
+
             //!
             //! Process a pending restart operation if there is one.
             //! @return True in case of success (no pending restart or successfully restarted)
@@ -197,6 +278,14 @@ namespace ts {
             //!
             bool processPendingRestart();
 
+            //!
+            //! Notify the subclass that the plugin instance was replaced.
+            //! Invoked in the context of the plugin thread, after swapping in the
+            //! shadow instance of a shadow restart. Subclasses which keep a typed
+            //! pointer on the plugin shall refresh it here.
+            //!
+            virtual void pluginSwapped() {}
+
         private:
             // A structure which is used to handle a restart of the plugin.
             class RestartData;
@@ -212,6 +301,30 @@ namespace ts {
             bool           _restart;       // Restart the plugni asap using _restart_data
             RestartDataPtr _restart_data;  // How to restart the plugin
 
+            // Lock-free mode (option --lock-free). Each adjacent pair of executors in the
+            // ring communicates through single-producer single-consumer atomic counters.
+            // _lf_added is incremented by the previous executor only, _lf_removed by this
+            // executor only. The number of packets to process is _lf_added - _lf_removed
+            // and _pkt_first is then private to this executor's thread. The global mutex
+            // is no longer taken on the packet hand-off path, only for rare control
+            // operations such as plugin restart.
+            const bool           _lock_free;    // Use the lock-free hand-off path.
+            std::atomic<size_t>  _lf_added;     // Count of packets passed to this plugin (written by previous).
+            std::atomic<size_t>  _lf_removed;   // Count of packets passed to next plugin (written by this one).
+            std::atomic<BitRate> _lf_bitrate;   // Bitrate from previous plugin.
+            std::atomic<bool>    _lf_input_end; // Previous plugin will no longer produce packets.
+
+            // Performance instrumentation, read by the control server thread.
+            std::atomic<NanoSecond> _wait_ns;   // Cumulated time in waitWork().
+            std::atomic<NanoSecond> _work_ns;   // Cumulated packet processing time.
+
+            // Adaptive flush batching (option --flush-latency). The batch size is
+            // adjusted in passPackets() from the observed flush-to-flush delay.
+            // These fields are private to this executor's thread.
+            const NanoSecond _flush_budget;     // Latency budget between two flushes (0: fixed batches).
+            size_t           _flush_size;       // Current flush batch size in packets.
+            NanoSecond       _last_flush;       // NanoClock() value at the previous call to passPackets().
+
             // Description of a restart operation.
             class RestartData
             {
@@ -223,6 +336,7 @@ namespace ts {
                 Report&       report;      // Report progress and error messages.
                 bool          same_args;   // Use same args as previously.
                 UStringVector args;        // New command line parameters for the plugin (read-only).
+                Plugin*       shadow;      // Replacement instance, already started (shadow restart).
                 Mutex         mutex;       // Mutex to protect the following fields.
                 Condition     condition;   // Condition to report the end of restart (for the requesting thread).
                 bool          completed;   // End of operation, restarted or aborted.
@@ -230,6 +344,14 @@ namespace ts {
 
             // Restart this plugin.
             void restart(const RestartDataPtr&);
+
+            // Create and start a second instance of the plugin for a shadow restart.
+            // Executed in the context of the requesting thread. Return the new
+            // instance or a null pointer on error.
+            Plugin* createShadowPlugin(const UStringVector& params, bool same, Report& report);
+
+            // Common implementation of the flag bitmap accessors.
+            void getFlagBitmap(bool (TSPacketMetadata::*getter)() const, size_t pkt_first, size_t pkt_cnt, std::vector<uint64_t>& bitmap) const;
         };
     }
 }
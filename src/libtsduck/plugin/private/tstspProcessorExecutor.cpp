@@ -28,8 +28,15 @@
 //----------------------------------------------------------------------------
 
 #include "tstspProcessorExecutor.h"
+#include "tsGuardCondition.h"
+#include "tsGuard.h"
+#include "tsMonotonic.h"
+#include "tsFatal.h"
 TSDUCK_SOURCE;
 
+// Marker in a status vector for packets which were not submitted to the plugin.
+#define NOT_SUBMITTED int8_t(-1)
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -42,8 +49,198 @@ ts::tsp::ProcessorExecutor::ProcessorExecutor(const TSProcessorArgs& options,
                                               Report* report) :
 
     PluginExecutor(options, PROCESSOR_PLUGIN, pl_options, attributes, global_mutex, report),
-    _processor(dynamic_cast<ProcessorPlugin*>(PluginThread::plugin()))
+    _processor(dynamic_cast<ProcessorPlugin*>(PluginThread::plugin())),
+    _shards()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// PID-sharding worker thread.
+//----------------------------------------------------------------------------
+
+ts::tsp::ProcessorExecutor::ShardWorker::ShardWorker(ProcessorExecutor& executor) :
+    Thread(),
+    _executor(executor),
+    _mutex(),
+    _wakeup(),
+    _completed(),
+    _busy(false),
+    _terminate(false),
+    _packets(),
+    _pkt_first(0),
+    _status(nullptr)
+{
+}
+
+void ts::tsp::ProcessorExecutor::ShardWorker::dispatch(const std::vector<size_t>& packets, size_t pkt_first, std::vector<int8_t>& status)
 {
+    GuardCondition lock(_mutex, _wakeup);
+    _packets = packets;
+    _pkt_first = pkt_first;
+    _status = &status;
+    _busy = true;
+    lock.signal();
+}
+
+void ts::tsp::ProcessorExecutor::ShardWorker::waitDispatch()
+{
+    GuardCondition lock(_mutex, _completed);
+    while (_busy) {
+        lock.waitCondition();
+    }
+}
+
+void ts::tsp::ProcessorExecutor::ShardWorker::terminate()
+{
+    {
+        GuardCondition lock(_mutex, _wakeup);
+        _terminate = true;
+        lock.signal();
+    }
+    waitForTermination();
+}
+
+void ts::tsp::ProcessorExecutor::ShardWorker::main()
+{
+    for (;;) {
+        // Wait for a dispatch or a termination request.
+        {
+            GuardCondition lock(_mutex, _wakeup);
+            while (!_busy && !_terminate) {
+                lock.waitCondition();
+            }
+            if (!_busy && _terminate) {
+                return;
+            }
+        }
+
+        // Process the packets of this shard, in stream order within the shard.
+        // The dispatching thread does not touch the lists until we signal
+        // completion, no lock is needed here.
+        ProcessorPlugin* const plugin = _executor._processor;
+        TSPacket* const pkt = _executor._buffer->base();
+        TSPacketMetadata* const pkt_data = _executor._metadata;
+        for (auto it = _packets.begin(); it != _packets.end(); ++it) {
+            (*_status)[*it - _pkt_first] = int8_t(plugin->processPacket(pkt[*it], pkt_data[*it]));
+        }
+
+        // Signal the completion of the dispatch.
+        GuardCondition lock(_mutex, _completed);
+        _busy = false;
+        lock.signal();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Process one window of packets by PID-sharding it among the workers.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorExecutor::processShardedWindow(size_t pkt_first, size_t pkt_cnt,
+                                                      const TSPacketMetadata::LabelSet& only_labels,
+                                                      BitRate& output_bitrate, bool& bitrate_never_modified,
+                                                      PacketCounter& passed_packets, PacketCounter& dropped_packets,
+                                                      PacketCounter& nullified_packets,
+                                                      bool& input_end, bool& aborted)
+{
+    const size_t nshards = _shards.size();
+    std::vector<std::vector<size_t>> assign(nshards);
+    std::vector<int8_t> status(pkt_cnt, NOT_SUBMITTED);
+    std::vector<bool> was_null(pkt_cnt, false);
+    size_t submitted = 0;
+
+    // Distribute the packets of the window among the workers, by PID.
+    for (size_t i = 0; i < pkt_cnt; ++i) {
+        TSPacket* const pkt = _buffer->base() + pkt_first + i;
+        TSPacketMetadata* const pkt_data = _metadata + pkt_first + i;
+        if (pkt->b[0] != 0) {
+            was_null[i] = pkt->getPID() == PID_NULL;
+            pkt_data->setFlush(false);
+            pkt_data->setBitrateChanged(false);
+            if (!_suspended && (only_labels.none() || pkt_data->hasAnyLabel(only_labels))) {
+                assign[pkt->getPID() % nshards].push_back(pkt_first + i);
+                submitted++;
+            }
+        }
+    }
+
+    // Run the workers on their shards and wait for all of them.
+    for (size_t s = 0; s < nshards; ++s) {
+        if (!assign[s].empty()) {
+            _shards[s]->dispatch(assign[s], pkt_first, status);
+        }
+    }
+    for (size_t s = 0; s < nshards; ++s) {
+        if (!assign[s].empty()) {
+            _shards[s]->waitDispatch();
+        }
+    }
+    addPluginPackets(submitted);
+    addNonPluginPackets(pkt_cnt - submitted);
+
+    // Rejoin the processing statuses in stream order.
+    size_t pkt_done = 0;
+    size_t pkt_flush = 0;
+
+    while (pkt_done < pkt_cnt && !aborted) {
+
+        const size_t wi = pkt_done;
+        TSPacket* const pkt = _buffer->base() + pkt_first + wi;
+        TSPacketMetadata* const pkt_data = _metadata + pkt_first + wi;
+        const int8_t st = status[wi];
+
+        pkt_done++;
+        pkt_flush++;
+
+        if (pkt->b[0] != 0 && st != NOT_SUBMITTED) {
+            // Use the status returned by the plugin for this packet.
+            switch (ProcessorPlugin::Status(st)) {
+                case ProcessorPlugin::TSP_OK:
+                    passed_packets++;
+                    break;
+                case ProcessorPlugin::TSP_NULL:
+                    *pkt = NullPacket;
+                    break;
+                case ProcessorPlugin::TSP_DROP:
+                    pkt->b[0] = 0;
+                    dropped_packets++;
+                    break;
+                case ProcessorPlugin::TSP_END:
+                    // Signal end of input to successors and abort to predecessors.
+                    // The following packets of the window were already submitted to
+                    // the plugin but they are not passed to the next plugin.
+                    input_end = aborted = true;
+                    pkt_done--;
+                    pkt_flush--;
+                    pkt_cnt = pkt_done;
+                    break;
+                default:
+                    error(u"invalid packet processing status %d", {st});
+                    break;
+            }
+
+            // Detect if the packet was nullified by the plugin.
+            if (!was_null[wi] && pkt->getPID() == PID_NULL) {
+                pkt_data->setNullified(true);
+                nullified_packets++;
+            }
+
+            // If the packet processor has signaled a new bitrate, get it.
+            if (pkt_data->getBitrateChanged()) {
+                const BitRate new_bitrate = _processor->getBitrate();
+                if (new_bitrate != 0) {
+                    bitrate_never_modified = false;
+                    output_bitrate = new_bitrate;
+                }
+            }
+        }
+
+        if (pkt_data->getFlush() || pkt_done == pkt_cnt || (flushSize() > 0 && pkt_flush >= flushSize())) {
+            aborted = !passPackets(pkt_flush, output_bitrate, pkt_done == pkt_cnt && input_end, aborted);
+            pkt_flush = 0;
+        }
+    }
 }
 
 
@@ -56,6 +253,19 @@ void ts::tsp::ProcessorExecutor::main()
     debug(u"packet processing thread started");
 
     const TSPacketMetadata::LabelSet only_labels(_processor->getOnlyLabelOption());
+    const bool read_only = _processor->isReadOnlyObserver();
+
+    // With --shard-threads, create the PID-sharding worker threads for
+    // plugins which declare themselves stateless.
+    if (_options.shard_threads > 1 && !read_only && _processor->isStateless()) {
+        _shards.resize(_options.shard_threads, nullptr);
+        for (size_t i = 0; i < _shards.size(); ++i) {
+            _shards[i] = new ShardWorker(*this);
+            CheckNonNull(_shards[i]);
+            _shards[i]->start();
+        }
+        verbose(u"processing packets with %d worker threads, sharded by PID", {_shards.size()});
+    }
     PacketCounter passed_packets = 0;
     PacketCounter dropped_packets = 0;
     PacketCounter nullified_packets = 0;
@@ -105,95 +315,159 @@ void ts::tsp::ProcessorExecutor::main()
         }
 
         // Now process the packets.
+        // The time spent on the window is accounted as processing time in the
+        // performance metrics (including periodic flushes to the next plugin).
+        const NanoSecond work_start = Monotonic::NanoClock();
         size_t pkt_done = 0;
         size_t pkt_flush = 0;
 
-        while (pkt_done < pkt_cnt && !aborted) {
+        if (!_shards.empty()) {
+            // Stateless plugin with worker threads: fan the window out by PID.
+            processShardedWindow(pkt_first, pkt_cnt, only_labels,
+                                 output_bitrate, bitrate_never_modified,
+                                 passed_packets, dropped_packets, nullified_packets,
+                                 input_end, aborted);
+        }
+        else if (read_only) {
+            // Fast path for read-only observer plugins. The plugin never modifies
+            // the packets or their metadata, so skip the per-packet modification
+            // bookkeeping (drop, nullify, flush, bitrate change) and release the
+            // window to the next plugin in large batches only.
+            while (pkt_done < pkt_cnt && !aborted) {
 
-            TSPacket* const pkt = _buffer->base() + pkt_first + pkt_done;
-            TSPacketMetadata* const pkt_data = _metadata->base() + pkt_first + pkt_done;
+                TSPacket* const pkt = _buffer->base() + pkt_first + pkt_done;
+                TSPacketMetadata* const pkt_data = _metadata + pkt_first + pkt_done;
 
-            pkt_done++;
-            pkt_flush++;
+                pkt_done++;
+                pkt_flush++;
 
-            if (pkt->b[0] == 0) {
-                // The packet has already been dropped by a previous packet processor.
-                addNonPluginPackets(1);
-            }
-            else {
-                // Apply the processing routine to the packet
-                const bool was_null = pkt->getPID() == PID_NULL;
-                pkt_data->setFlush(false);
-                pkt_data->setBitrateChanged(false);
-                ProcessorPlugin::Status status = ProcessorPlugin::TSP_OK;
-                if (!_suspended && (only_labels.none() || pkt_data->hasAnyLabel(only_labels))) {
-                    // Either no --only-label option or the packet has a specified label => process it.
-                    status = _processor->processPacket(*pkt, *pkt_data);
-                    addPluginPackets(1);
-                }
-                else {
-                    // The plugin is suspended or some --only-label was specified but the packet does
-                    // not have any required label. Pass the packet without submitting it to the plugin.
+                if (pkt->b[0] == 0) {
+                    // The packet has already been dropped by a previous packet processor.
                     addNonPluginPackets(1);
                 }
-
-                // Use the returned status
-                switch (status) {
-                    case ProcessorPlugin::TSP_OK:
-                        // Normal case, pass packet
-                        passed_packets++;
-                        break;
-                    case ProcessorPlugin::TSP_NULL:
-                        // Replace the packet with a complete null packet
-                        *pkt = NullPacket;
-                        break;
-                    case ProcessorPlugin::TSP_DROP:
-                        // Drop this packet.
-                        pkt->b[0] = 0;
-                        dropped_packets++;
-                        break;
-                    case ProcessorPlugin::TSP_END:
-                        // Signal end of input to successors and abort
-                        // to predecessors
+                else if (!_suspended && (only_labels.none() || pkt_data->hasAnyLabel(only_labels))) {
+                    if (_processor->processPacket(*pkt, *pkt_data) == ProcessorPlugin::TSP_END) {
+                        // Signal end of input to successors and abort to predecessors.
                         input_end = aborted = true;
                         pkt_done--;
                         pkt_flush--;
                         pkt_cnt = pkt_done;
-                        break;
-                    default:
-                        // Invalid status, report error and accept packet.
-                        error(u"invalid packet processing status %d", {status});
-                        break;
+                    }
+                    else {
+                        // A read-only observer shall only return TSP_OK or TSP_END,
+                        // any other status is handled as TSP_OK.
+                        passed_packets++;
+                    }
+                    addPluginPackets(1);
+                }
+                else {
+                    // Suspended or no required label, do not submit to the plugin.
+                    addNonPluginPackets(1);
                 }
 
-                // Detect if the packet was nullified by the plugin, either by returning TSP_NULL or by overwriting the packet.
-                if (!was_null && pkt->getPID() == PID_NULL) {
-                    pkt_data->setNullified(true);
-                    nullified_packets++;
+                if (pkt_done == pkt_cnt || (flushSize() > 0 && pkt_flush >= flushSize())) {
+                    aborted = !passPackets(pkt_flush, output_bitrate, pkt_done == pkt_cnt && input_end, aborted);
+                    pkt_flush = 0;
                 }
+            }
+        }
+        else {
+            while (pkt_done < pkt_cnt && !aborted) {
+
+                TSPacket* const pkt = _buffer->base() + pkt_first + pkt_done;
+                TSPacketMetadata* const pkt_data = _metadata + pkt_first + pkt_done;
 
-                // If the packet processor has signaled a new bitrate, get it.
-                if (pkt_data->getBitrateChanged()) {
-                    const BitRate new_bitrate = _processor->getBitrate();
-                    if (new_bitrate != 0) {
-                        bitrate_never_modified = false;
-                        output_bitrate = new_bitrate;
+                pkt_done++;
+                pkt_flush++;
+
+                if (pkt->b[0] == 0) {
+                    // The packet has already been dropped by a previous packet processor.
+                    addNonPluginPackets(1);
+                }
+                else {
+                    // Apply the processing routine to the packet
+                    const bool was_null = pkt->getPID() == PID_NULL;
+                    pkt_data->setFlush(false);
+                    pkt_data->setBitrateChanged(false);
+                    ProcessorPlugin::Status status = ProcessorPlugin::TSP_OK;
+                    if (!_suspended && (only_labels.none() || pkt_data->hasAnyLabel(only_labels))) {
+                        // Either no --only-label option or the packet has a specified label => process it.
+                        status = _processor->processPacket(*pkt, *pkt_data);
+                        addPluginPackets(1);
+                    }
+                    else {
+                        // The plugin is suspended or some --only-label was specified but the packet does
+                        // not have any required label. Pass the packet without submitting it to the plugin.
+                        addNonPluginPackets(1);
+                    }
+
+                    // Use the returned status
+                    switch (status) {
+                        case ProcessorPlugin::TSP_OK:
+                            // Normal case, pass packet
+                            passed_packets++;
+                            break;
+                        case ProcessorPlugin::TSP_NULL:
+                            // Replace the packet with a complete null packet
+                            *pkt = NullPacket;
+                            break;
+                        case ProcessorPlugin::TSP_DROP:
+                            // Drop this packet.
+                            pkt->b[0] = 0;
+                            dropped_packets++;
+                            break;
+                        case ProcessorPlugin::TSP_END:
+                            // Signal end of input to successors and abort
+                            // to predecessors
+                            input_end = aborted = true;
+                            pkt_done--;
+                            pkt_flush--;
+                            pkt_cnt = pkt_done;
+                            break;
+                        default:
+                            // Invalid status, report error and accept packet.
+                            error(u"invalid packet processing status %d", {status});
+                            break;
+                    }
+
+                    // Detect if the packet was nullified by the plugin, either by returning TSP_NULL or by overwriting the packet.
+                    if (!was_null && pkt->getPID() == PID_NULL) {
+                        pkt_data->setNullified(true);
+                        nullified_packets++;
+                    }
+
+                    // If the packet processor has signaled a new bitrate, get it.
+                    if (pkt_data->getBitrateChanged()) {
+                        const BitRate new_bitrate = _processor->getBitrate();
+                        if (new_bitrate != 0) {
+                            bitrate_never_modified = false;
+                            output_bitrate = new_bitrate;
+                        }
                     }
                 }
-            }
 
-            // Do not wait to process pkt_cnt packets before notifying
-            // the next processor. Perform periodic flush to avoid waiting
-            // too long before two output operations.
+                // Do not wait to process pkt_cnt packets before notifying
+                // the next processor. Perform periodic flush to avoid waiting
+                // too long before two output operations.
 
-            if (pkt_data->getFlush() || pkt_done == pkt_cnt || (_options.max_flush_pkt > 0 && pkt_flush % _options.max_flush_pkt == 0)) {
-                aborted = !passPackets(pkt_flush, output_bitrate, pkt_done == pkt_cnt && input_end, aborted);
-                pkt_flush = 0;
+                if (pkt_data->getFlush() || pkt_done == pkt_cnt || (flushSize() > 0 && pkt_flush >= flushSize())) {
+                    aborted = !passPackets(pkt_flush, output_bitrate, pkt_done == pkt_cnt && input_end, aborted);
+                    pkt_flush = 0;
+                }
             }
         }
 
+        addProcessingTime(Monotonic::NanoClock() - work_start);
+
     } while (!input_end && !aborted);
 
+    // Terminate the PID-sharding worker threads.
+    for (size_t i = 0; i < _shards.size(); ++i) {
+        _shards[i]->terminate();
+        delete _shards[i];
+    }
+    _shards.clear();
+
     // Close the packet processor
     _processor->stop();
 
@@ -67,9 +67,61 @@ namespace ts {
             //!
             ProcessorPlugin* plugin() {return _processor;}
 
+        protected:
+            // Refresh the typed plugin pointer after a shadow restart.
+            virtual void pluginSwapped() override {_processor = dynamic_cast<ProcessorPlugin*>(PluginThread::plugin());}
+
         private:
             ProcessorPlugin* _processor;
 
+            // With --shard-threads, packets of a window are distributed by PID
+            // among worker threads for plugins which declare themselves stateless.
+            // Each worker processes the packets of its own PID's, in stream order
+            // within each PID, and posts the processing status of each packet.
+            // The plugin thread then rejoins the statuses in stream order.
+            class ShardWorker: public Thread
+            {
+                TS_NOBUILD_NOCOPY(ShardWorker);
+            public:
+                // Constructor.
+                ShardWorker(ProcessorExecutor& executor);
+
+                // Ask the worker to process the listed packets (buffer indexes).
+                // The status of packet i is posted at index i - pkt_first in status.
+                void dispatch(const std::vector<size_t>& packets, size_t pkt_first, std::vector<int8_t>& status);
+
+                // Wait for completion of the current dispatch.
+                void waitDispatch();
+
+                // Ask the worker thread to terminate and wait for it.
+                void terminate();
+
+            private:
+                ProcessorExecutor&   _executor;
+                Mutex                _mutex;      // Protect the following fields.
+                Condition            _wakeup;     // Signal a new dispatch or termination.
+                Condition            _completed;  // Signal the end of a dispatch.
+                bool                 _busy;       // A dispatch is in progress.
+                bool                 _terminate;  // Terminate the worker thread.
+                std::vector<size_t>  _packets;    // Buffer indexes of the packets to process.
+                size_t               _pkt_first;  // Buffer index of the first packet of the window.
+                std::vector<int8_t>* _status;     // Where to post the processing statuses.
+
+                // Inherited from Thread.
+                virtual void main() override;
+            };
+
+            // Process one window of packets by PID-sharding it among the workers.
+            // Same interface and semantics as the sequential processing loop.
+            void processShardedWindow(size_t pkt_first, size_t pkt_cnt,
+                                      const TSPacketMetadata::LabelSet& only_labels,
+                                      BitRate& output_bitrate, bool& bitrate_never_modified,
+                                      PacketCounter& passed_packets, PacketCounter& dropped_packets,
+                                      PacketCounter& nullified_packets,
+                                      bool& input_end, bool& aborted);
+
+            std::vector<ShardWorker*> _shards;  // Worker threads, empty without --shard-threads.
+
             // Inherited from Thread
             virtual void main() override;
         };
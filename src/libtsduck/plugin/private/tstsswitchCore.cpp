@@ -102,33 +102,42 @@ bool ts::tsswitch::Core::start()
     assert(_opt.firstInput < _inputs.size());
     _curPlugin = _opt.firstInput;
 
-    // Start all input threads (but do not open the input "devices").
+    // The input threads are created on demand, only for the inputs which are
+    // actually used. With many declared inputs and the default switch mode,
+    // this avoids one idle thread (and its stack) per unused input.
     bool success = true;
-    for (size_t i = 0; success && i < _inputs.size(); ++i) {
-        // Here, start() means start the thread, not start input plugin.
-        success = _inputs[i]->start();
-    }
-
-    if (!success) {
-        // If one input thread could not start, abort all started threads.
-        stop(false);
-    }
-    else if (_opt.fastSwitch) {
+    if (_opt.fastSwitch) {
         // Option --fast-switch, start all plugins, they continue to receive in parallel.
-        for (size_t i = 0; i < _inputs.size(); ++i) {
-            _inputs[i]->startInput(i == _curPlugin);
+        for (size_t i = 0; success && i < _inputs.size(); ++i) {
+            // Here, startThread() means start the thread, not start input plugin.
+            success = _inputs[i]->startThread();
+        }
+        if (success) {
+            for (size_t i = 0; i < _inputs.size(); ++i) {
+                _inputs[i]->startInput(i == _curPlugin);
+            }
         }
     }
     else {
         // Start the first plugin only.
-        _inputs[_curPlugin]->startInput(true);
+        success = _inputs[_curPlugin]->startThread();
+        if (success) {
+            _inputs[_curPlugin]->startInput(true);
+        }
 
         // If there is a primary input which is not the first one, start it as well.
-        if (_opt.primaryInput < _inputs.size() && _opt.primaryInput != _curPlugin) {
-            _inputs[_opt.primaryInput]->startInput(false);
+        if (success && _opt.primaryInput < _inputs.size() && _opt.primaryInput != _curPlugin) {
+            success = _inputs[_opt.primaryInput]->startThread();
+            if (success) {
+                _inputs[_opt.primaryInput]->startInput(false);
+            }
         }
     }
 
+    if (!success) {
+        // If one input thread could not start, abort all started threads.
+        stop(false);
+    }
     return success;
 }
 
@@ -368,7 +377,10 @@ void ts::tsswitch::Core::execute(const Action& event)
                 break;
             }
             case START: {
-                _inputs[action.index]->startInput(action.flag);
+                // Create the input thread on first use of this input.
+                if (_inputs[action.index]->startThread()) {
+                    _inputs[action.index]->startInput(action.flag);
+                }
                 break;
             }
             case STOP: {
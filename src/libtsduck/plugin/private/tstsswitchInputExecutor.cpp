@@ -49,7 +49,9 @@ ts::tsswitch::InputExecutor::InputExecutor(size_t index, Core& core, const Input
     _metadata(opt.bufferedPackets),
     _mutex(),
     _todo(),
+    _threadStarted(false),
     _isCurrent(false),
+    _alignPending(false),
     _outputInUse(false),
     _startRequest(false),
     _stopRequest(false),
@@ -91,6 +93,25 @@ bool ts::tsswitch::InputExecutor::thisJointTerminated() const
 }
 
 
+//----------------------------------------------------------------------------
+// Start the input executor thread, if not already done.
+//----------------------------------------------------------------------------
+
+bool ts::tsswitch::InputExecutor::startThread()
+{
+    // The thread is created on demand, the first time the input is used.
+    // With many declared inputs and the default switch mode, only the
+    // current and primary inputs ever get a thread.
+    if (!_threadStarted) {
+        _threadStarted = start();
+        if (!_threadStarted) {
+            error(u"cannot start input thread");
+        }
+    }
+    return _threadStarted;
+}
+
+
 //----------------------------------------------------------------------------
 // Start input.
 //----------------------------------------------------------------------------
@@ -101,6 +122,7 @@ void ts::tsswitch::InputExecutor::startInput(bool isCurrent)
 
     GuardCondition lock(_mutex, _todo);
     _isCurrent = isCurrent;
+    _alignPending = isCurrent && _opt.seamlessSwitch;
     _startRequest = true;
     _stopRequest = false;
     lock.signal();
@@ -129,6 +151,14 @@ void ts::tsswitch::InputExecutor::stopInput()
 void ts::tsswitch::InputExecutor::setCurrent(bool isCurrent)
 {
     Guard lock(_mutex);
+    // With --seamless-switch, when this plugin becomes the current one, the
+    // output shall start on a PCR boundary of this input stream.
+    if (isCurrent && !_isCurrent) {
+        _alignPending = _opt.seamlessSwitch;
+    }
+    else if (!isCurrent) {
+        _alignPending = false;
+    }
     _isCurrent = isCurrent;
 }
 
@@ -152,12 +182,31 @@ void ts::tsswitch::InputExecutor::terminateInput()
 
 void ts::tsswitch::InputExecutor::getOutputArea(ts::TSPacket*& first, TSPacketMetadata*& data, size_t& count)
 {
+    // The returned area points directly into the input buffer: the output
+    // plugin sends the packets from there, without intermediate copy. The
+    // window is limited to the contiguous part of the circular buffer and
+    // remains reserved until freeOutput(). Reserving the window does not
+    // unblock the input thread, there is no need to signal the condition.
     GuardCondition lock(_mutex, _todo);
+
+    // With --seamless-switch, after this input became the current one, drop
+    // buffered packets until the first one which holds a PCR, so that the
+    // output resumes on a clean clock reference. The scan is done once, at
+    // the switch instant only.
+    if (_alignPending) {
+        while (_outCount > 0 && !_buffer[_outFirst].hasPCR()) {
+            _outFirst = (_outFirst + 1) % _buffer.size();
+            _outCount--;
+        }
+        _alignPending = _outCount == 0;
+        // Dropping packets may unblock the input thread when the buffer was full.
+        lock.signal();
+    }
+
     first = &_buffer[_outFirst];
     data = &_metadata[_outFirst];
     count = std::min(_outCount, _buffer.size() - _outFirst);
     _outputInUse = count > 0;
-    lock.signal();
 }
 
 
@@ -275,11 +324,21 @@ void ts::tsswitch::InputExecutor::main()
             addPluginPackets(inCount);
 
             // Signal the presence of received packets.
+            bool notify = true;
             {
                 Guard lock(_mutex);
                 _outCount += inCount;
+                // The core needs to know about received packets on the current
+                // input (to wake up the output plugin), on the primary input
+                // (automatic switch back) and on all inputs with --delayed-switch
+                // (waiting for packets on the next input). With --fast-switch,
+                // do not wake up the core for the other idle inputs, this would
+                // only hammer the global mutex from all input threads.
+                notify = _isCurrent || _opt.delayedSwitch || _pluginIndex == _opt.primaryInput;
+            }
+            if (notify) {
+                _core.inputReceived(_pluginIndex);
             }
-            _core.inputReceived(_pluginIndex);
         }
 
         // At end of session, make sure that the output buffer is not in use by the output plugin.
@@ -78,6 +78,14 @@ namespace ts {
                 return _input;
             }
 
+            //!
+            //! Start the input executor thread, if not already done.
+            //! The thread is created on demand, the first time the input is used,
+            //! so that unused inputs in large configurations do not consume a thread.
+            //! @return True on success, false on error.
+            //!
+            bool startThread();
+
             //!
             //! Tell the input executor thread to start an input session.
             //! @param [in] isCurrent True if the plugin immediately becomes the current one.
@@ -136,7 +144,9 @@ namespace ts {
             TSPacketMetadataVector _metadata; // Packet metadata.
             Mutex          _mutex;            // Mutex to protect all subsequent fields.
             Condition      _todo;             // Condition to signal something to do.
+            bool           _threadStarted;    // The executor thread was started.
             bool           _isCurrent;        // This plugin is the current input one.
+            bool           _alignPending;     // With --seamless-switch, drop packets until the next PCR.
             bool           _outputInUse;      // The output part of the buffer is currently in use by the output plugin.
             bool           _startRequest;     // Start input requested.
             bool           _stopRequest;      // Stop input requested.
@@ -49,6 +49,7 @@ ts::AbstractDatagramInputPlugin::AbstractDatagramInputPlugin(TSP* tsp_, size_t b
     _packets_1(0),
     _inbuf_count(0),
     _inbuf_next(0),
+    _inbuf_time(-1),
     _inbuf(buffer_size)
 {
     option(u"display-interval", 'd', POSITIVE);
@@ -116,7 +117,7 @@ ts::BitRate ts::AbstractDatagramInputPlugin::getBitrate()
     else {
         // Evaluate bitrate since start of previous evaluation period.
         // The current period may be too short for correct evaluation.
-        const MilliSecond ms = Time::CurrentUTC() - _start_0;
+        const MilliSecond ms = Time::CurrentUTCCoarse() - _start_0;
         return ms == 0 ? 0 : BitRate((_packets_0 * PKT_SIZE * 8 * MilliSecPerSec) / ms);
     }
 }
@@ -131,13 +132,43 @@ size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetada
     // Check if we receive new packets or process remain of previous buffer.
     bool new_packets = false;
 
+    // Number of packets which were received directly into the caller's buffer.
+    size_t direct_count = 0;
+
     // If there is no remaining packet in the input buffer, wait for a datagram message.
     // Loop until we get some TS packets.
     while (_inbuf_count == 0) {
 
-        // Wait for a datagram message
+        // Wait for a datagram message.
         size_t insize = 0;
-        if (!receiveDatagram(_inbuf.data(), _inbuf.size(), insize)) {
+        _inbuf_time = -1;
+        if (max_packets * PKT_SIZE >= _inbuf.size()) {
+            // The caller's buffer is large enough for the largest datagram.
+            // Receive the payload directly into it, avoiding the intermediate
+            // copy when the payload is a plain sequence of TS packets (the
+            // common case with UDP and SRT transport streams).
+            if (!receiveDatagram(buffer, max_packets * PKT_SIZE, insize, _inbuf_time)) {
+                return 0;
+            }
+            if (insize > 0 && insize % PKT_SIZE == 0) {
+                direct_count = insize / PKT_SIZE;
+                for (size_t i = 0; i < direct_count; ++i) {
+                    if (buffer[i].b[0] != SYNC_BYTE) {
+                        // Not aligned on TS packets, use the generic method.
+                        direct_count = 0;
+                        break;
+                    }
+                }
+            }
+            if (direct_count > 0) {
+                new_packets = true;
+                break;
+            }
+            // The payload is not a plain sequence of TS packets (extra headers,
+            // trailing garbage). Look for packets with the generic method.
+            ::memcpy(_inbuf.data(), buffer, insize);  // Flawfinder: ignore
+        }
+        else if (!receiveDatagram(_inbuf.data(), _inbuf.size(), insize, _inbuf_time)) {
             return 0;
         }
 
@@ -152,10 +183,13 @@ size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetada
         tsp->debug(u"no TS packet in message, %s bytes", {insize});
     }
 
+    // Number of packets from the last received datagram.
+    const size_t received = direct_count > 0 ? direct_count : _inbuf_count;
+
     // If new packets were received, we may need to re-evaluate the real-time input bitrate.
     if (new_packets && _eval_time > 0) {
 
-        const Time now(Time::CurrentUTC());
+        const Time now(Time::CurrentUTCCoarse());
 
         // Detect start time
         if (_packets == 0) {
@@ -166,9 +200,9 @@ size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetada
         }
 
         // Count packets
-        _packets += _inbuf_count;
-        _packets_0 += _inbuf_count;
-        _packets_1 += _inbuf_count;
+        _packets += received;
+        _packets_0 += received;
+        _packets_1 += received;
 
         // Detect new evaluation period
         if (now >= _start_1 + _eval_time) {
@@ -182,8 +216,8 @@ size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetada
         // Check if evaluated bitrate should be displayed
         if (_display_time > 0 && now >= _next_display) {
             _next_display += _display_time;
-            const MilliSecond ms_current = Time::CurrentUTC() - _start_0;
-            const MilliSecond ms_total = Time::CurrentUTC() - _start;
+            const MilliSecond ms_current = Time::CurrentUTCCoarse() - _start_0;
+            const MilliSecond ms_total = Time::CurrentUTCCoarse() - _start;
             const BitRate br_current = ms_current == 0 ? 0 : BitRate((_packets_0 * PKT_SIZE * 8 * MilliSecPerSec) / ms_current);
             const BitRate br_average = ms_total == 0 ? 0 : BitRate((_packets * PKT_SIZE * 8 * MilliSecPerSec) / ms_total);
             tsp->info(u"input bitrate: %s, average: %s", {
@@ -192,9 +226,25 @@ size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetada
         }
     }
 
+    // Packets which were received directly in the caller's buffer are already in place.
+    if (direct_count > 0) {
+        if (pkt_data != nullptr && _inbuf_time >= 0) {
+            for (size_t i = 0; i < direct_count; ++i) {
+                pkt_data[i].setInputTimeStamp(_inbuf_time);
+            }
+        }
+        return direct_count;
+    }
+
     // Return packets from the input buffer
     size_t pkt_cnt = std::min(_inbuf_count, max_packets);
     TSPacket::Copy(buffer, _inbuf.data() + _inbuf_next, pkt_cnt);
+    if (pkt_data != nullptr && _inbuf_time >= 0) {
+        // All packets come from the same datagram, they share its reception time.
+        for (size_t i = 0; i < pkt_cnt; ++i) {
+            pkt_data[i].setInputTimeStamp(_inbuf_time);
+        }
+    }
     _inbuf_count -= pkt_cnt;
     _inbuf_next += pkt_cnt * PKT_SIZE;
 
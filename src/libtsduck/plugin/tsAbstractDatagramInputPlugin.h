@@ -72,9 +72,12 @@ namespace ts {
         //! @param [out] buffer Address of the buffer for the received message.
         //! @param [in] buffer_size Size in bytes of the reception buffer.
         //! @param [out] ret_size Size in bytes of the received message. Will never be larger than @a buffer_size.
+        //! @param [out] timestamp Reception time of the datagram in microseconds since the Unix
+        //! epoch, -1 when the transport does not report it. When set, it is copied in the
+        //! metadata of all TS packets of the datagram (see TSPacketMetadata::getInputTimeStamp()).
         //! @return True on success, false on error.
         //!
-        virtual bool receiveDatagram(void* buffer, size_t buffer_size, size_t& ret_size) = 0;
+        virtual bool receiveDatagram(void* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp) = 0;
 
     private:
         MilliSecond   _eval_time;          // Bitrate evaluation interval in milli-seconds
@@ -88,6 +91,7 @@ namespace ts {
         PacketCounter _packets_1;          // Number of received packets since _start_1
         size_t        _inbuf_count;        // Remaining TS packets in inbuf
         size_t        _inbuf_next;         // Index in inbuf of next TS packet to return
+        MicroSecond   _inbuf_time;         // Reception time of the last datagram, -1 when unknown
         ByteBlock     _inbuf;              // Input buffer
     };
 }
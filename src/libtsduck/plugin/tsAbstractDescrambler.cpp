@@ -149,6 +149,7 @@ ts::AbstractDescrambler::ECMStream::ECMStream(AbstractDescrambler* parent) :
     cw_valid(false),
     new_cw_even(false),
     new_cw_odd(false),
+    last_scv(SC_CLEAR),
     new_ecm(false),
     ecm(),
     cw_even(),
@@ -439,6 +440,26 @@ void ts::AbstractDescrambler::processECM(ECMStream& estream)
             estream.new_cw_odd = true;
             estream.cw_odd = cw_odd;
         }
+
+        // Pre-compute the key schedules, ahead of the crypto-period boundary.
+        // A new CW normally belongs to the next crypto-period: its parity is not
+        // the one of the packets being currently descrambled and its cipher
+        // context is idle, so it can be keyed right now, from this thread. The
+        // parity switch in the packet path then has nothing left to do. If the
+        // CW of the current parity changed (first ECM, abnormal mid-period
+        // update), leave it to the packet path, as before, to avoid re-keying
+        // a cipher context which is possibly in use.
+        if (estream.new_cw_even && estream.last_scv != SC_EVEN_KEY) {
+            estream.scrambling.setScramblingType(estream.cw_even.scrambling, false);
+            estream.scrambling.setCW(estream.cw_even.cw, SC_EVEN_KEY);
+            estream.new_cw_even = false;
+        }
+        if (estream.new_cw_odd && estream.last_scv != SC_ODD_KEY) {
+            estream.scrambling.setScramblingType(estream.cw_odd.scrambling, false);
+            estream.scrambling.setCW(estream.cw_odd.cw, SC_ODD_KEY);
+            estream.new_cw_odd = false;
+        }
+
         estream.cw_valid = ok;
     }
 }
@@ -564,6 +585,10 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
         return TSP_OK;
     }
 
+    // Remember the parity of the packets being descrambled. The ECM processing
+    // thread uses it to pre-compute the key schedules of the other parity.
+    pecm->last_scv = scv;
+
     // We found a valid CW, check if new CW were deciphered and store them in the descrambler.
     // Flags new_cw_even/odd are "write-protected, read-volatile", no mutex needed.
     if ((scv == SC_EVEN_KEY && pecm->new_cw_even) || (scv == SC_ODD_KEY && pecm->new_cw_odd)) {
@@ -221,6 +221,7 @@ namespace ts {
             volatile bool cw_valid;     // CW's are valid
             volatile bool new_cw_even;  // New CW available (even)
             volatile bool new_cw_odd;   // New CW available (odd)
+            volatile uint8_t last_scv;  // Scrambling control value of last descrambled packet.
             // -- start of protected area --
             bool          new_ecm;      // New ECM available
             Section       ecm;          // Last received ECM
@@ -28,7 +28,6 @@
 //----------------------------------------------------------------------------
 
 #include "tsAbstractHTTPInputPlugin.h"
-#include "tsWebRequest.h"
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
 
@@ -38,9 +37,12 @@ TSDUCK_SOURCE;
 //----------------------------------------------------------------------------
 
 ts::AbstractHTTPInputPlugin::AbstractHTTPInputPlugin(TSP* tsp_, const UString& description, const UString& syntax) :
-    PushInputPlugin(tsp_, description, syntax),
+    InputPlugin(tsp_, description, syntax),
+    _request(*tsp_),
     _partial(),
-    _partial_size(0),
+    _partialSize(0),
+    _previousSuccess(true),
+    _startOfTransfer(false),
     _autoSaveDir(),
     _outSave()
 {
@@ -53,119 +55,169 @@ ts::AbstractHTTPInputPlugin::AbstractHTTPInputPlugin(TSP* tsp_, const UString& d
 
 bool ts::AbstractHTTPInputPlugin::start()
 {
-    _partial_size = 0;
+    _partialSize = 0;
+    _previousSuccess = true;
+    _startOfTransfer = false;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Stop method
+//----------------------------------------------------------------------------
+
+bool ts::AbstractHTTPInputPlugin::stop()
+{
+    // Terminate a transfer which may still be in progress.
+    if (_request.transferOpen()) {
+        _request.closeTransfer();
+    }
+
+    // Close auto save file if one was open.
+    if (_outSave.isOpen()) {
+        _outSave.close(*tsp);
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Open the URL of the next transfer and start it.
+//----------------------------------------------------------------------------
 
-    // Invoke superclass.
-    return PushInputPlugin::start();
+bool ts::AbstractHTTPInputPlugin::startTransfer()
+{
+    // Let the subclass select the next URL to download. Retry as long as
+    // starting the transfer fails and the subclass provides another URL.
+    for (;;) {
+        if (tsp->aborting() || !openURL(_request)) {
+            return false;
+        }
+        if (_request.startTransfer()) {
+            _startOfTransfer = true;
+            return true;
+        }
+        _previousSuccess = false;
+    }
 }
 
 
 //----------------------------------------------------------------------------
-// This hook is invoked at the beginning of the transfer.
+// Report the characteristics of the current transfer.
+// Invoked when the first data of a transfer arrive.
 //----------------------------------------------------------------------------
 
-bool ts::AbstractHTTPInputPlugin::handleWebStart(const WebRequest& request, size_t size)
+void ts::AbstractHTTPInputPlugin::processTransferStart()
 {
+    _startOfTransfer = false;
+
     // Get complete MIME type.
-    const UString mime(request.mimeType());
+    const UString mime(_request.mimeType());
+    const size_t size = _request.announcedContentSize();
 
     // Print a message.
-    tsp->verbose(u"downloading from %s", {request.finalURL()});
+    tsp->verbose(u"downloading from %s", {_request.finalURL()});
     tsp->verbose(u"MIME type: %s, expected size: %s", {mime.empty() ? u"unknown" : mime, size == 0 ? u"unknown" : UString::Format(u"%d bytes", {size})});
     if (!mime.empty() && !mime.similar(u"video/mp2t")) {
-        tsp->warning(u"MIME type is %d, maybe not a valid transport stream", {mime});
+        tsp->warning(u"MIME type is %s, maybe not a valid transport stream", {mime});
     }
 
     // Create the auto-save file when necessary.
-    const UString url(request.finalURL());
+    const UString url(_request.finalURL());
     if (!_autoSaveDir.empty() && !url.empty()) {
         const UString name(_autoSaveDir + PathSeparator + BaseName(url));
         tsp->verbose(u"saving input TS to %s", {name});
         // Display errors but do not fail, this is just auto save.
         _outSave.open(name, TSFile::WRITE | TSFile::SHARED, *tsp);
     }
-
-    // Reinitialize partial packet if some bytes were left from a previous iteration.
-    _partial_size = 0;
-    return true;
 }
 
 
 //----------------------------------------------------------------------------
-// This hook is invoked at the end of the transfer.
+// Terminate the current transfer.
 //----------------------------------------------------------------------------
 
-bool ts::AbstractHTTPInputPlugin::handleWebStop(const WebRequest& request)
+void ts::AbstractHTTPInputPlugin::closeTransfer(bool success)
 {
+    _request.closeTransfer();
+    _previousSuccess = success;
+    _startOfTransfer = false;
+
     // Close auto save file if one was open.
     if (_outSave.isOpen()) {
         _outSave.close(*tsp);
     }
-    return true;
 }
 
 
 //----------------------------------------------------------------------------
-// Push packet to the tsp chain.
+// Input method
 //----------------------------------------------------------------------------
 
-bool ts::AbstractHTTPInputPlugin::pushPackets(const TSPacket* buffer, size_t count)
+size_t ts::AbstractHTTPInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
 {
-    // If an intermediate save file was specified, save the packets.
-    // Display errors but do not fail, this is just auto save.
-    if (_outSave.isOpen() && !_outSave.write(buffer, count, *tsp)) {
-        _outSave.close(*tsp);
+    uint8_t* const data = buffer->b;
+    const size_t max_bytes = max_packets * PKT_SIZE;
+    size_t bytes = 0;
+
+    // Restore the incomplete packet which was left over by the previous call.
+    if (_partialSize > 0) {
+        assert(_partialSize < PKT_SIZE);
+        ::memcpy(data, _partial.b, _partialSize);  // Flawfinder: ignore
+        bytes = _partialSize;
+        _partialSize = 0;
     }
 
-    // Invoke superclass to actually push the packets.
-    return PushInputPlugin::pushPackets(buffer, count);
-}
-
+    // Receive the Web content directly into the caller's packet buffer,
+    // until at least one complete packet is present.
+    while (bytes < PKT_SIZE) {
 
-//----------------------------------------------------------------------------
-// This hook is invoked when a data chunk is available.
-//----------------------------------------------------------------------------
+        // Make sure that a transfer is in progress.
+        if (!_request.transferOpen() && !startTransfer()) {
+            // No more content, drop a possible trailing incomplete packet.
+            if (bytes > 0) {
+                tsp->debug(u"dropping %d trailing bytes", {bytes});
+            }
+            return 0;
+        }
 
-bool ts::AbstractHTTPInputPlugin::handleWebData(const WebRequest& request, const void* addr, size_t size)
-{
-    const uint8_t* data = reinterpret_cast<const uint8_t*>(addr);
-
-    // If a partial packet is present, try to fill it.
-    if (_partial_size > 0) {
-        // Copy more data into partial packet.
-        assert(_partial_size <= PKT_SIZE);
-        const size_t more = std::min(size, PKT_SIZE - _partial_size);
-        ::memcpy(_partial.b + _partial_size, data, more);
-
-        data += more;
-        size -= more;
-        _partial_size += more;
-
-        // If the partial packet is full, push it.
-        if (_partial_size == PKT_SIZE) {
-            if (!pushPackets(&_partial, 1)) {
-                tsp->debug(u"error pushing packets");
-                return false;
+        // Receive some data from the current transfer.
+        size_t got = 0;
+        if (!_request.receive(data + bytes, max_bytes - bytes, got)) {
+            // Transfer error. Let the subclass decide in openURL() whether
+            // the input continues with another transfer or terminates.
+            closeTransfer(false);
+            // Each transfer starts on a packet boundary, drop a possible
+            // incomplete packet at the end of the failed one.
+            bytes -= bytes % PKT_SIZE;
+        }
+        else if (got == 0) {
+            // End of transfer, move to the next one, if there is one.
+            closeTransfer(true);
+            bytes -= bytes % PKT_SIZE;
+        }
+        else {
+            if (_startOfTransfer) {
+                // The response headers are guaranteed to be present when the
+                // first data of the transfer arrive.
+                processTransferStart();
             }
-            _partial_size = 0;
+            bytes += got;
         }
     }
 
-    // Compute number of complete packets to push.
-    const size_t residue = size % PKT_SIZE;
-    const size_t count = (size - residue) / PKT_SIZE;
-
-    // Push complete packets.
-    if (count > 0 && !pushPackets(reinterpret_cast<const TSPacket*>(data), count)) {
-        tsp->debug(u"error pushing packets");
-        return false;
+    // Save the trailing incomplete packet for the next call.
+    const size_t count = bytes / PKT_SIZE;
+    _partialSize = bytes % PKT_SIZE;
+    if (_partialSize > 0) {
+        ::memcpy(_partial.b, data + bytes - _partialSize, _partialSize);  // Flawfinder: ignore
     }
 
-    // Save residue in partial packet.
-    if (residue > 0) {
-        ::memcpy(_partial.b, data + size - residue, residue);
-        _partial_size = residue;
+    // If an intermediate save file was specified, save the packets.
+    // Display errors but do not fail, this is just auto save.
+    if (_outSave.isOpen() && !_outSave.write(buffer, count, *tsp)) {
+        _outSave.close(*tsp);
     }
 
-    return true;
+    return count;
 }
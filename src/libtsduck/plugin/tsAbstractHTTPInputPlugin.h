@@ -33,8 +33,8 @@
 //----------------------------------------------------------------------------
 
 #pragma once
-#include "tsPushInputPlugin.h"
-#include "tsWebRequestHandlerInterface.h"
+#include "tsPlugin.h"
+#include "tsWebRequest.h"
 #include "tsTSFile.h"
 
 namespace ts {
@@ -42,16 +42,27 @@ namespace ts {
     //! Abstract base class for HTTP-based input plugins.
     //! @ingroup plugin
     //!
-    class TSDUCKDLL AbstractHTTPInputPlugin: public PushInputPlugin, protected WebRequestHandlerInterface
+    //! The class works in pull mode: the Web content is received directly
+    //! into the transport stream packet buffers which are provided by @c tsp,
+    //! without intermediate copy. A possible incomplete packet at the end of
+    //! a chunk of data is kept aside until the next chunk.
+    //!
+    //! Subclasses shall implement openURL() to setup the Web request for the
+    //! next transfer. The method is invoked before the first transfer and
+    //! after the completion of each transfer, to fetch a possible next URL
+    //! (replay, next media segment, etc.)
+    //!
+    class TSDUCKDLL AbstractHTTPInputPlugin: public InputPlugin
     {
         TS_NOBUILD_NOCOPY(AbstractHTTPInputPlugin);
     public:
         // Implementation of Plugin interface.
-        // If overridden by descrambler subclass, superclass must be explicitly invoked.
+        // If overridden by subclass, superclass must be explicitly invoked.
         virtual bool start() override;
+        virtual bool stop() override;
 
-        // Inherited from PushInputPluginÒ.
-        virtual bool pushPackets(const TSPacket* buffer, size_t count) override;
+        // Implementation of InputPlugin interface.
+        virtual size_t receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets) override;
 
         //!
         //! Set a directory name where all loaded files are automatically saved.
@@ -68,15 +79,42 @@ namespace ts {
         //!
         AbstractHTTPInputPlugin(TSP* tsp, const UString& description, const UString& syntax);
 
-        // Implementation of WebRequestHandlerInterface
-        virtual bool handleWebStart(const WebRequest& request, size_t size) override;
-        virtual bool handleWebData(const WebRequest& request, const void* data, size_t size) override;
-        virtual bool handleWebStop(const WebRequest& request) override;
+        //!
+        //! Open the URL of the next transfer.
+        //! Must be implemented by subclasses.
+        //! The subclass shall set the URL and options of @a request.
+        //! @param [in,out] request The Web request to setup.
+        //! @return True when @a request describes the next transfer to
+        //! perform, false when there is no more content to receive and the
+        //! input shall terminate.
+        //!
+        virtual bool openURL(WebRequest& request) = 0;
+
+        //!
+        //! Check if the previous transfer completed without error.
+        //! Can be used by subclasses in openURL() to decide to continue or not.
+        //! @return True before the first transfer and after a successful
+        //! transfer, false after a transfer error.
+        //!
+        bool previousTransferSuccess() const { return _previousSuccess; }
 
     private:
-        TSPacket     _partial;       // Buffer for incomplete packets.
-        size_t       _partial_size;  // Number of bytes in partial.
-        UString      _autoSaveDir;   // If not empty, automatically save loaded files to this directory.
-        TSFile       _outSave;       // TS file where to store the loaded file.
+        WebRequest _request;          // The Web request for all transfers.
+        TSPacket   _partial;          // Buffer for incomplete packets.
+        size_t     _partialSize;      // Number of bytes in partial.
+        bool       _previousSuccess;  // Previous transfer completed without error.
+        bool       _startOfTransfer;  // No data received yet in current transfer.
+        UString    _autoSaveDir;      // If not empty, automatically save loaded files to this directory.
+        TSFile     _outSave;          // TS file where to store the loaded file.
+
+        // Open the URL of the next transfer and start it.
+        bool startTransfer();
+
+        // Report the characteristics of the current transfer and create the
+        // auto-save file. Invoked when the first data of a transfer arrive.
+        void processTransferStart();
+
+        // Terminate the current transfer.
+        void closeTransfer(bool success);
     };
 }
@@ -36,6 +36,7 @@
 #include "tsSysUtils.h"
 #include "tsFatal.h"
 #include "tsLNB.h"
+#include "tsTime.h"
 TSDUCK_SOURCE;
 
 
@@ -72,6 +73,8 @@ public:
     Polarization        polarity;     // Polarity.
     bool                high_band;    // Use LNB high frequency band.
     bool                lnb_setup;    // Need LNB setup.
+    MilliSecond         fifo_report;  // Interval between FIFO load reports (0: none).
+    Time                next_fifo_report;  // Deadline of next FIFO load report.
 };
 
 ts::DektecInputPlugin::Guts::Guts() :
@@ -90,7 +93,9 @@ ts::DektecInputPlugin::Guts::Guts() :
     sat_number(0),
     polarity(POL_VERTICAL),
     high_band(false),
-    lnb_setup(false)
+    lnb_setup(false),
+    fifo_report(0),
+    next_fifo_report()
 {
 }
 
@@ -199,6 +204,12 @@ ts::DektecInputPlugin::DektecInputPlugin(TSP* tsp_) :
          u"DVB-T/T2 demodulators: indicate the bandwidth in MHz. The default is 8 MHz. "
          u"The bandwidth values 1.7, 5 and 10 MHz are valid for DVB-T2 only.");
 
+    option(u"fifo-report", 0, POSITIVE);
+    help(u"fifo-report", u"seconds",
+         u"Report the load of the input FIFO at the specified interval in seconds. "
+         u"This is a way to monitor how close the hardware buffer gets to an "
+         u"overflow. By default, the FIFO load is not reported.");
+
     option(u"frequency", 'f', POSITIVE);
     help(u"frequency",
          u"All demodulators: indicate the frequency, in Hz, of the input carrier. There is no default. "
@@ -428,6 +439,7 @@ bool ts::DektecInputPlugin::getOptions()
     _guts->dev_index = intValue<int>(u"device", -1);
     _guts->chan_index = intValue<int>(u"channel", -1);
     _guts->timeout_ms = intValue<int>(u"receive-timeout", _guts->timeout_ms); // preserve previous value
+    _guts->fifo_report = 1000 * intValue<MilliSecond>(u"fifo-report", 0);
     _guts->sat_number = intValue<int>(u"satellite-number", 0);
     _guts->polarity = enumValue<Polarization>(u"polarity", POL_VERTICAL);
     _guts->high_band = false;
@@ -708,6 +720,7 @@ bool ts::DektecInputPlugin::start()
     // fifo is observed here, ignore it. Later, a full fifo indicates potential
     // packet loss.
     _guts->init_cnt = 5;
+    _guts->next_fifo_report = Time::CurrentUTC() + _guts->fifo_report;
     _guts->is_started = true;
     return true;
 }
@@ -878,6 +891,14 @@ size_t ts::DektecInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_da
             // Input overflow.
             tsp->warning(u"input fifo full, possible packet loss");
         }
+        // Periodically report the FIFO load with --fifo-report.
+        if (_guts->fifo_report > 0 && status == DTAPI_OK) {
+            const Time now(Time::CurrentUTC());
+            if (now >= _guts->next_fifo_report) {
+                tsp->info(u"input fifo load: %'d bytes (%d%% of %'d bytes)", {fifo_load, int((100 * uint64_t(fifo_load)) / DTA_FIFO_SIZE), size_t(DTA_FIFO_SIZE)});
+                _guts->next_fifo_report = now + _guts->fifo_report;
+            }
+        }
     }
 
     // Do not read more than what a DTA device accepts
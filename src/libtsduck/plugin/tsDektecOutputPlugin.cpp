@@ -36,6 +36,8 @@
 #include "tsModulation.h"
 #include "tsIntegerUtils.h"
 #include "tsSysUtils.h"
+#include "tsByteBlock.h"
+#include "tsTime.h"
 TSDUCK_SOURCE;
 
 #define DEFAULT_PRELOAD_FIFO_PERCENTAGE 80
@@ -76,6 +78,10 @@ public:
     uint64_t             preload_fifo_delay; // Preload FIFO such that it starts transmission after specified delay in ms
     bool                 maintain_preload;   // Roughly maintain the buffer size if the FIFO is preloaded prior to starting transmission
     int                  power_mode;         // Power mode to set on DTU-315
+    size_t               stage_size;         // Staged transfer size in bytes (0: write directly)
+    ByteBlock            stage;              // Staging buffer for large FIFO transfers
+    MilliSecond          fifo_report;        // Interval between FIFO load reports (0: none)
+    Time                 next_fifo_report;   // Deadline of next FIFO load report
 };
 
 ts::DektecOutputPlugin::Guts::Guts() :
@@ -96,7 +102,11 @@ ts::DektecOutputPlugin::Guts::Guts() :
     preload_fifo_size(0),
     preload_fifo_delay(0),
     maintain_preload(false),
-    power_mode(-1)
+    power_mode(-1),
+    stage_size(0),
+    stage(),
+    fifo_report(0),
+    next_fifo_report()
 {
 }
 
@@ -332,6 +342,12 @@ ts::DektecOutputPlugin::DektecOutputPlugin(TSP* tsp_) :
     help(u"fft-mode",
          u"DVB-T2 modulators: indicate the FFT mode. The default is 32K.");
 
+    option(u"fifo-report", 0, POSITIVE);
+    help(u"fifo-report", u"seconds",
+         u"Report the load of the output FIFO at the specified interval in seconds. "
+         u"This is a way to monitor how close the hardware buffer gets to an "
+         u"underflow. By default, the FIFO load is not reported.");
+
     option(u"fifo-size", 0, INTEGER, 0, 1, 1024, UNLIMITED_VALUE);
     help(u"fifo-size",
          u"Set the FIFO size in bytes of the output channel in the Dektec device. The "
@@ -721,6 +737,16 @@ ts::DektecOutputPlugin::DektecOutputPlugin(TSP* tsp_) :
          u"DVB-T/H modulators: indicate that at least one elementary stream uses "
          u"time slicing (DVB-H signalling).");
 
+    option(u"transfer-size", 0, INTEGER, 0, 1, int64_t(PKT_SIZE), UNLIMITED_VALUE);
+    help(u"transfer-size", u"bytes",
+         u"Accumulate packets and transfer them to the output FIFO in chunks of "
+         u"the specified size in bytes (rounded down to a multiple of 188), "
+         u"instead of one transfer per buffer of packets received from tsp. "
+         u"Large DMA-friendly transfers reduce the per-transfer overhead. The "
+         u"accumulated packets are transferred immediately when the FIFO load "
+         u"gets lower than the transfer size, to avoid underflows. By default, "
+         u"the packets are not accumulated.");
+
     option(u"transmission-mode", 't', Enumeration({
         {u"2K", DTAPI_MOD_DVBT_2K},
         {u"4K", DTAPI_MOD_DVBT_4K},
@@ -830,6 +856,10 @@ bool ts::DektecOutputPlugin::start()
     _guts->preload_fifo = present(u"preload-fifo");
     _guts->maintain_preload = present(u"maintain-preload");
     _guts->power_mode = intValue(u"power-mode", -1);
+    _guts->stage_size = RoundDown(intValue<size_t>(u"transfer-size", 0), PKT_SIZE);
+    _guts->stage.clear();
+    _guts->fifo_report = 1000 * intValue<MilliSecond>(u"fifo-report", 0);
+    _guts->next_fifo_report = Time::CurrentUTC() + _guts->fifo_report;
 
     // Get initial bitrate
     _guts->cur_bitrate = _guts->opt_bitrate != 0 ? _guts->opt_bitrate : tsp->bitrate();
@@ -1500,6 +1530,12 @@ bool ts::DektecOutputPlugin::stop()
     if (_guts->is_started) {
         tsp->verbose(u"terminating %s output", {_guts->device.model});
 
+        // Flush the staging buffer of --transfer-size.
+        if (!_guts->stage.empty()) {
+            writeFifo(reinterpret_cast<const char*>(_guts->stage.data()), int(_guts->stage.size()));
+            _guts->stage.clear();
+        }
+
         // Mute output signal for modulators which support this
         if (_guts->mute_on_stop) {
             Dtapi::DTAPI_RESULT status = _guts->chan.SetRfMode(DTAPI_UPCONV_MUTE);
@@ -1547,8 +1583,6 @@ bool ts::DektecOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata
         return false;
     }
 
-    char* data = reinterpret_cast<char*>(const_cast<TSPacket*>(buffer));
-    int remain = int(packet_count * PKT_SIZE);
     Dtapi::DTAPI_RESULT status;
 
     // If no bitrate was specified on the command line, adjust the bitrate
@@ -1569,6 +1603,40 @@ bool ts::DektecOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata
         }
     }
 
+    // Periodically report the FIFO load with --fifo-report.
+    reportFifoLevel();
+
+    // Without --transfer-size, write the packets directly.
+    if (_guts->stage_size == 0) {
+        return writeFifo(reinterpret_cast<const char*>(buffer), int(packet_count * PKT_SIZE));
+    }
+
+    // With --transfer-size, accumulate the packets in the staging buffer.
+    _guts->stage.append(buffer, packet_count * PKT_SIZE);
+    if (_guts->stage.size() < _guts->stage_size && !_guts->starting) {
+        // The chunk is not complete. Keep accumulating only when the FIFO
+        // holds enough data to sustain the output in the meantime.
+        int fifo_load = 0;
+        if (_guts->chan.GetFifoLoad(fifo_load) == DTAPI_OK && fifo_load >= int(_guts->stage_size)) {
+            return true;
+        }
+    }
+    const bool success = writeFifo(reinterpret_cast<const char*>(_guts->stage.data()), int(_guts->stage.size()));
+    _guts->stage.clear();
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Write raw data to the output FIFO, with load pacing.
+//----------------------------------------------------------------------------
+
+bool ts::DektecOutputPlugin::writeFifo(const char* buffer, int buffer_size)
+{
+    char* data = const_cast<char*>(buffer);
+    int remain = buffer_size;
+    Dtapi::DTAPI_RESULT status;
+
     // Loop on write until everything is gone.
     while (remain > 0) {
 
@@ -1684,6 +1752,25 @@ bool ts::DektecOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata
     return true;
 }
 
+
+//----------------------------------------------------------------------------
+// Periodically report the FIFO load with --fifo-report.
+//----------------------------------------------------------------------------
+
+void ts::DektecOutputPlugin::reportFifoLevel()
+{
+    if (_guts->fifo_report > 0) {
+        const Time now(Time::CurrentUTC());
+        if (now >= _guts->next_fifo_report) {
+            int fifo_load = 0;
+            if (_guts->chan.GetFifoLoad(fifo_load) == DTAPI_OK && _guts->fifo_size > 0) {
+                tsp->info(u"output fifo load: %'d bytes (%d%% of %'d bytes)", {fifo_load, (100 * fifo_load) / _guts->fifo_size, _guts->fifo_size});
+            }
+            _guts->next_fifo_report = now + _guts->fifo_report;
+        }
+    }
+}
+
 //----------------------------------------------------------------------------
 // Set preload FIFO size based on delay, if requested, in ms
 // Returns true if preload FIFO size altered, false otherwise
@@ -84,6 +84,12 @@ namespace ts {
         // Set preload FIFO size based on a delay, if requested, in ms. Returns true if preload FIFO size is altered,
         // false otherwise.
         bool setPreloadFIFOSizeBasedOnDelay();
+
+        // Write raw data to the output FIFO, with load pacing. Return true on success, false on error.
+        bool writeFifo(const char* buffer, int buffer_size);
+
+        // Report the FIFO load at regular intervals when --fifo-report is used.
+        void reportFifoLevel();
 #endif
     };
 }
@@ -33,17 +33,14 @@
 TSDUCK_SOURCE;
 
 // Define the singleton.
+// The extensions are loaded in the constructor, on the first call to Instance().
+// There is intentionally no static initialization forcing the creation of the
+// singleton when the TSDuck library is loaded: scanning directories and loading
+// shared libraries before main() is a measurable startup cost for the many
+// short-lived tool invocations which never need extensions. The points of use
+// (DuckContext, PluginRepository, tsversion) call Instance() on first need.
 TS_DEFINE_SINGLETON(ts::DuckExtensionRepository);
 
-// Force the creation of the singleton when the TSDuck library is loaded.
-// This is the point where the extensions are loaded.
-// Make it a exportable symbol to make sure that no compiler will optimize it away.
-TS_PUSH_WARNING()
-TS_LLVM_NOWARNING(missing-variable-declarations)
-const ts::DuckExtensionRepository* TSDuckExtensionRepository = ts::DuckExtensionRepository::Instance();
-TS_POP_WARNING()
-
-
 
 //----------------------------------------------------------------------------
 // Constructors
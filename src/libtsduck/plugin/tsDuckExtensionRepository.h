@@ -44,12 +44,14 @@ namespace ts {
     //!
     //! This class is a singleton. Use static Instance() method to access the single instance.
     //!
-    //! The extensions repository is responsible for statically loading all available extensions.
+    //! The extensions repository is responsible for loading all available extensions.
     //! The extension shared libraries are all shared libraries named "tslibext_*", using the
     //! same search rules as tsp plugins.
     //!
-    //! Since this operation occurs before entering the main code of any executable using the
-    //! TSDuck library, the application has no control over the loading of extensions.
+    //! The extensions are loaded on the first call to Instance(). This is a lazy
+    //! initialization: applications which never use extensions (or never reach code
+    //! which may be provided by an extension) do not pay the price of the directory
+    //! scan and shared library loading at startup.
     //! The following environment variables can be defined to alter the loading of extensions:
     //!
     //! - TSLIBEXT_DEBUG : If defined and not empty, display debug messages on the standard error.
@@ -30,6 +30,11 @@
 #include "tsFileInputPlugin.h"
 TSDUCK_SOURCE;
 
+// With --async-io, default size in packets of the inter-thread queue (~4.6 MB)
+// and minimum size in packets of one read operation of the reader thread.
+#define DEFAULT_ASYNC_QUEUE_SIZE 25600
+#define MIN_ASYNC_READ_SIZE        512
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -46,6 +51,13 @@ ts::FileInputPlugin::FileInputPlugin(TSP* tsp_) :
     _current_file(0),
     _repeat_count(1),
     _start_offset(0),
+    _direct_io(false),
+    _mmap_io(false),
+    _async_io(false),
+    _async_started(false),
+    _async_queue_size(DEFAULT_ASYNC_QUEUE_SIZE),
+    _reader(this),
+    _queue(),
     _base_label(0),
     _filenames(),
     _eof(),
@@ -57,11 +69,36 @@ ts::FileInputPlugin::FileInputPlugin(TSP* tsp_) :
          u"When several files are specified, use '-' as file name to specify the standard input. "
          u"The files are read in sequence, unless --interleave is specified.");
 
+    option(u"async-io", 0, INTEGER, 0, 1, MIN_ASYNC_READ_SIZE, UNLIMITED_VALUE, true);
+    help(u"async-io",
+         u"Read the files from a separate thread which keeps large read operations "
+         u"in flight ahead of the packet processing. This prevents fast storage "
+         u"(such as NVMe arrays) from being underused because of the synchronous "
+         u"read-then-process loop. The optional value is the size in packets of "
+         u"the intermediate buffer (default: " + UString::Decimal(DEFAULT_ASYNC_QUEUE_SIZE) +
+         u"). This option is incompatible with --interleave and --label-base.");
+
     option(u"byte-offset", 'b', UNSIGNED);
     help(u"byte-offset",
          u"Start reading each file at the specified byte offset (default: 0). "
          u"This option is allowed only if all input files are regular files.");
 
+    option(u"direct-io", 'd');
+    help(u"direct-io",
+         u"Read the files using direct I/O, bypassing the system file cache. "
+         u"When linearly reading very large files, this avoids evicting the "
+         u"cached data of other applications. "
+         u"This option is allowed only if all input files are regular files. "
+         u"The --byte-offset and --packet-offset values must be multiples of 4096 bytes.");
+
+    option(u"memory-map", 'm');
+    help(u"memory-map",
+         u"Read the files through a memory map instead of read operations. "
+         u"When the same large file is processed several times, the file data "
+         u"remain in the system cache and subsequent passes avoid all disk reads. "
+         u"This option is allowed only if all input files are regular files. "
+         u"It is incompatible with --direct-io.");
+
     option(u"first-terminate", 'f');
     help(u"first-terminate",
          u"With --interleave, terminate when any file reaches the end of file. "
@@ -111,6 +148,10 @@ bool ts::FileInputPlugin::getOptions()
     getValues(_filenames);
     _repeat_count = present(u"infinite") ? 0 : intValue<size_t>(u"repeat", 1);
     _start_offset = intValue<uint64_t>(u"byte-offset", intValue<uint64_t>(u"packet-offset", 0) * PKT_SIZE);
+    _direct_io = present(u"direct-io");
+    _mmap_io = present(u"memory-map");
+    _async_io = present(u"async-io");
+    _async_queue_size = intValue<size_t>(u"async-io", DEFAULT_ASYNC_QUEUE_SIZE);
     _interleave = present(u"interleave");
     _interleave_chunk = intValue<size_t>(u"interleave", 1);
     _first_terminate = present(u"first-terminate");
@@ -133,11 +174,71 @@ bool ts::FileInputPlugin::getOptions()
         tsp->error(u"specifying --infinite is meaningless with more than one file");
         return false;
     }
+    if (_direct_io && _mmap_io) {
+        tsp->error(u"--direct-io and --memory-map are mutually exclusive");
+        return false;
+    }
+    if (_async_io && _interleave) {
+        tsp->error(u"--async-io and --interleave are mutually exclusive");
+        return false;
+    }
+    if (_async_io && _base_label <= TSPacketMetadata::LABEL_MAX) {
+        tsp->error(u"--async-io and --label-base are mutually exclusive");
+        return false;
+    }
 
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Internal reader thread with --async-io.
+//----------------------------------------------------------------------------
+
+ts::FileInputPlugin::Reader::Reader(FileInputPlugin* plugin) :
+    _plugin(plugin)
+{
+}
+
+ts::FileInputPlugin::Reader::~Reader()
+{
+    waitForTermination();
+}
+
+void ts::FileInputPlugin::Reader::main()
+{
+    _plugin->tsp->debug(u"async reader thread started");
+
+    // The first file was open in start(). Without --interleave (enforced in
+    // getOptions), there is only one TSFile and the files are read in sequence.
+    size_t name_index = 0;
+    bool more = true;
+
+    while (more) {
+        // Wait for free space in the queue and read directly into it.
+        TSPacket* buffer = nullptr;
+        size_t buffer_size = 0;
+        if (!_plugin->_queue.lockWriteBuffer(buffer, buffer_size, MIN_ASYNC_READ_SIZE)) {
+            break;  // the tsp input thread requested a stop
+        }
+        size_t count = 0;
+        if (buffer_size > 0) {
+            count = _plugin->_files[0].read(buffer, buffer_size, *_plugin->tsp);
+        }
+        if (count == 0) {
+            // End of current file, move to the next one if there is one.
+            _plugin->_files[0].close(*_plugin->tsp);
+            more = ++name_index < _plugin->_filenames.size() && _plugin->openFile(name_index, 0);
+        }
+        _plugin->_queue.releaseWriteBuffer(count);
+    }
+
+    // Report the end of input to the tsp input thread.
+    _plugin->_queue.setEOF();
+    _plugin->tsp->debug(u"async reader thread completed");
+}
+
+
 //----------------------------------------------------------------------------
 // Open one input file.
 //----------------------------------------------------------------------------
@@ -155,6 +256,8 @@ bool ts::FileInputPlugin::openFile(size_t name_index, size_t file_index)
     }
 
     // Actually open the file.
+    _files[file_index].setDirectIO(_direct_io);
+    _files[file_index].setMemoryMap(_mmap_io);
     return _files[file_index].openRead(name, _repeat_count, _start_offset, *tsp);
 }
 
@@ -207,6 +310,16 @@ bool ts::FileInputPlugin::start()
     _aborted = false;
     _eof.clear();
 
+    // With --async-io, start the reader thread after opening the first file.
+    if (ok && _async_io) {
+        _queue.reset(_async_queue_size);
+        ok = _async_started = _reader.start();
+        if (!ok) {
+            tsp->error(u"cannot start the async reader thread");
+            closeAllFiles();
+        }
+    }
+
     return ok;
 }
 
@@ -217,6 +330,12 @@ bool ts::FileInputPlugin::start()
 
 bool ts::FileInputPlugin::stop()
 {
+    // Terminate the reader thread first, it uses the files.
+    if (_async_started) {
+        _queue.stop();
+        _reader.waitForTermination();
+        _async_started = false;
+    }
     return closeAllFiles();
 }
 
@@ -230,6 +349,11 @@ bool ts::FileInputPlugin::abortInput()
     // Set volatile boolean first.
     _aborted = true;
 
+    // Wake up the reader thread if it is waiting for free space in the queue.
+    if (_async_io) {
+        _queue.stop();
+    }
+
     // Abort current operations on all files.
     for (auto it = _files.begin(); it != _files.end(); ++it) {
         it->abort();
@@ -247,6 +371,15 @@ size_t ts::FileInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data
 {
     size_t read_count = 0;
 
+    // With --async-io, simply wait for packets from the reader thread.
+    if (_async_io) {
+        BitRate bitrate = 0;
+        if (_aborted || !_queue.waitPackets(buffer, max_packets, read_count, bitrate)) {
+            read_count = 0;
+        }
+        return read_count;
+    }
+
     // Loop until got max number of packets or all files have reached end-of-file.
     while (!_aborted && read_count < max_packets && _eof.size() < _filenames.size()) {
 
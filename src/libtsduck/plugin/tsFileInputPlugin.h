@@ -35,6 +35,8 @@
 #pragma once
 #include "tsPlugin.h"
 #include "tsTSFile.h"
+#include "tsTSPacketQueue.h"
+#include "tsThread.h"
 
 namespace ts {
     //!
@@ -59,6 +61,18 @@ namespace ts {
         virtual bool abortInput() override;
 
     private:
+        // Internal thread which reads ahead of the tsp input thread with --async-io.
+        class Reader: public Thread
+        {
+            TS_NOBUILD_NOCOPY(Reader);
+        public:
+            Reader(FileInputPlugin* plugin);
+            virtual ~Reader();
+            virtual void main() override;
+        private:
+            FileInputPlugin* _plugin;
+        };
+
         volatile bool _aborted;            // Set when abortInput() is set.
         bool          _interleave;         // Read all files simultaneously with interleaving.
         bool          _first_terminate;    // With _interleave, terminate when the first file terminates.
@@ -68,6 +82,13 @@ namespace ts {
         size_t        _current_file;       // Current file index in _files. Depends on _interleave.
         size_t        _repeat_count;
         uint64_t      _start_offset;
+        bool          _direct_io;          // Read the files using direct I/O.
+        bool          _mmap_io;            // Read the files through a memory map.
+        bool          _async_io;           // Read ahead of the tsp input thread.
+        bool          _async_started;      // The reader thread is started.
+        size_t        _async_queue_size;   // Size in packets of the inter-thread queue.
+        Reader        _reader;             // Reader thread with --async-io.
+        TSPacketQueue _queue;              // Inter-thread packet queue with --async-io.
         size_t        _base_label;
         UStringVector _filenames;
         std::set<size_t>    _eof;          // Set of file indexes having reached end of file.
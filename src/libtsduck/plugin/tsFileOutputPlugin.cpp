@@ -30,6 +30,16 @@
 #include "tsFileOutputPlugin.h"
 TSDUCK_SOURCE;
 
+// With --async-io, default size in packets of the inter-thread queue (~4.6 MB)
+// and maximum size in packets of one write operation of the writer thread.
+#define DEFAULT_ASYNC_QUEUE_SIZE 25600
+#define MAX_ASYNC_WRITE_SIZE      8192
+
+// With --split, default size in packets of each accumulation buffer
+// and default maximum buffering delay in milliseconds.
+#define DEFAULT_SPLIT_BUFFER  512
+#define DEFAULT_SPLIT_DELAY  1000
+
 
 //----------------------------------------------------------------------------
 // Constructor
@@ -39,7 +49,18 @@ ts::FileOutputPlugin::FileOutputPlugin(TSP* tsp_) :
     OutputPlugin(tsp_, u"Write packets to a file", u"[options] [file-name]"),
     _name(),
     _flags(TSFile::NONE),
-    _file()
+    _file(),
+    _async_io(false),
+    _async_started(false),
+    _write_error(false),
+    _async_queue_size(DEFAULT_ASYNC_QUEUE_SIZE),
+    _writer(this),
+    _queue(),
+    _split(false),
+    _split_buf_packets(DEFAULT_SPLIT_BUFFER),
+    _split_max_delay(DEFAULT_SPLIT_DELAY),
+    _split_files(),
+    _split_map()
 {
     option(u"", 0, STRING, 0, 1);
     help(u"", u"Name of the created output file. Use standard output by default.");
@@ -47,8 +68,69 @@ ts::FileOutputPlugin::FileOutputPlugin(TSP* tsp_) :
     option(u"append", 'a');
     help(u"append", u"If the file already exists, append to the end of the file. By default, existing files are overwritten.");
 
+    option(u"async-io", 0, INTEGER, 0, 1, MAX_ASYNC_WRITE_SIZE, UNLIMITED_VALUE, true);
+    help(u"async-io",
+         u"Write the file from a separate thread, so that the packet processing "
+         u"never waits for a disk write to complete. The optional value is the "
+         u"size in packets of the intermediate buffer (default: " +
+         UString::Decimal(DEFAULT_ASYNC_QUEUE_SIZE) + u").");
+
+    option(u"direct-io", 'd');
+    help(u"direct-io",
+         u"Write the file using direct I/O, bypassing the system file cache. "
+         u"When archiving a high bitrate stream on disk, this avoids evicting "
+         u"the cached data of other applications. A named regular file is required.");
+
+    option(u"elided-format");
+    help(u"elided-format",
+         u"Write the file in the TSDuck elided capture format. Runs of null "
+         u"packets are stored as a 4-byte run-length record instead of 188 "
+         u"bytes each, proportionally reducing the size of archived captures "
+         u"with a significant stuffing ratio. The format is transparently "
+         u"detected when the file is read back with the file input plugin or "
+         u"any tool using the TSDuck file classes. "
+         u"Incompatible with --append and --direct-io.");
+
     option(u"keep", 'k');
     help(u"keep", u"Keep existing file (abort if the specified file already exists). By default, existing files are overwritten.");
+
+    option(u"split", 0, STRING, 0, UNLIMITED_COUNT);
+    help(u"split", u"pid[-pid]=filename",
+         u"Route the specified PID or range of PID's to the specified file instead "
+         u"of the main output file. Several --split options may be specified and "
+         u"the same file name may appear in several of them, the file then receives "
+         u"all corresponding PID's. Packets which do not match any --split option "
+         u"are written to the main output file as usual. The packets of each "
+         u"destination file are accumulated in a per-file buffer which is written "
+         u"in one operation when full (see --split-buffer-packets) or after "
+         u"--split-max-delay. One tsp instance can thereby archive many services "
+         u"into distinct files with a fraction of the system calls of one tsp "
+         u"instance per file.");
+
+    option(u"split-buffer-packets", 0, POSITIVE);
+    help(u"split-buffer-packets",
+         u"With --split, specify the size in packets of each per-file accumulation "
+         u"buffer (default: " TS_STRINGIFY(DEFAULT_SPLIT_BUFFER) u" packets).");
+
+    option(u"split-max-delay", 0, POSITIVE);
+    help(u"split-max-delay", u"milliseconds",
+         u"With --split, specify the maximum time in milliseconds to keep packets "
+         u"in an accumulation buffer before writing it to its file, even when the "
+         u"buffer is not full (default: " TS_STRINGIFY(DEFAULT_SPLIT_DELAY) u" ms).");
+}
+
+
+//----------------------------------------------------------------------------
+// Constructor of one --split destination file.
+//----------------------------------------------------------------------------
+
+ts::FileOutputPlugin::SplitFile::SplitFile() :
+    name(),
+    file(),
+    buffer(),
+    count(0),
+    due()
+{
 }
 
 
@@ -59,27 +141,247 @@ ts::FileOutputPlugin::FileOutputPlugin(TSP* tsp_) :
 bool ts::FileOutputPlugin::getOptions()
 {
     getValue(_name);
+    _async_io = present(u"async-io");
+    _async_queue_size = intValue<size_t>(u"async-io", DEFAULT_ASYNC_QUEUE_SIZE);
     _flags = TSFile::WRITE | TSFile::SHARED;
     if (present(u"append")) {
         _flags |= TSFile::APPEND;
     }
+    if (present(u"direct-io")) {
+        _flags |= TSFile::DIRECT;
+    }
+    if (present(u"elided-format")) {
+        _flags |= TSFile::ELIDED;
+    }
     if (present(u"keep")) {
         _flags |= TSFile::KEEP;
     }
+
+    // Decode the --split options.
+    _split_files.clear();
+    for (size_t i = 0; i < PID_MAX; ++i) {
+        _split_map[i] = NPOS;
+    }
+    const size_t split_count = count(u"split");
+    _split = split_count > 0;
+    _split_buf_packets = intValue<size_t>(u"split-buffer-packets", DEFAULT_SPLIT_BUFFER);
+    _split_max_delay = intValue<MilliSecond>(u"split-max-delay", DEFAULT_SPLIT_DELAY);
+
+    for (size_t i = 0; i < split_count; ++i) {
+        const UString spec(value(u"split", u"", i));
+        const size_t eq = spec.find(u'=');
+        PID pid1 = PID_NULL;
+        PID pid2 = PID_NULL;
+        bool valid = eq != NPOS && eq + 1 < spec.length();
+        if (valid) {
+            const UString pids(spec.substr(0, eq));
+            if (!pids.scan(u"%d-%d", {&pid1, &pid2})) {
+                valid = pids.scan(u"%d", {&pid1});
+                pid2 = pid1;
+            }
+            valid = valid && pid1 < PID_MAX && pid2 < PID_MAX && pid1 <= pid2;
+        }
+        if (!valid) {
+            tsp->error(u"invalid --split specification \"%s\", use pid[-pid]=filename", {spec});
+            return false;
+        }
+        // Reuse the destination file when the same name was already specified.
+        const UString fname(spec.substr(eq + 1));
+        size_t index = 0;
+        while (index < _split_files.size() && _split_files[index]->name != fname) {
+            index++;
+        }
+        if (index == _split_files.size()) {
+            const SplitFilePtr sf(new SplitFile);
+            sf->name = fname;
+            _split_files.push_back(sf);
+        }
+        for (PID pid = pid1; pid <= pid2; ++pid) {
+            _split_map[pid] = index;
+        }
+    }
+
     return true;
 }
 
 bool ts::FileOutputPlugin::start()
 {
-    return _file.open(_name, _flags, *tsp);
+    if (!_file.open(_name, _flags, *tsp)) {
+        return false;
+    }
+    // With --split, open all destination files and allocate their buffers.
+    const Time due(Time::CurrentUTC() + _split_max_delay);
+    for (size_t n = 0; n < _split_files.size(); ++n) {
+        SplitFile& sf(*_split_files[n]);
+        if (!sf.file.open(sf.name, _flags, *tsp)) {
+            // Close all previously opened files.
+            for (size_t p = 0; p < n; ++p) {
+                _split_files[p]->file.close(*tsp);
+            }
+            _file.close(*tsp);
+            return false;
+        }
+        sf.buffer.resize(_split_buf_packets);
+        sf.count = 0;
+        sf.due = due;
+    }
+    // With --async-io, start the writer thread.
+    if (_async_io) {
+        _queue.reset(_async_queue_size);
+        _write_error = false;
+        _async_started = _writer.start();
+        if (!_async_started) {
+            tsp->error(u"cannot start the async writer thread");
+            _file.close(*tsp);
+            return false;
+        }
+    }
+    return true;
 }
 
 bool ts::FileOutputPlugin::stop()
 {
-    return _file.close(*tsp);
+    // Flush and close the --split destination files.
+    bool ok = true;
+    for (size_t n = 0; n < _split_files.size(); ++n) {
+        SplitFile& sf(*_split_files[n]);
+        ok = flushSplitFile(sf) && ok;
+        ok = sf.file.close(*tsp) && ok;
+    }
+
+    // Let the writer thread drain the queue, then terminate.
+    if (_async_started) {
+        _queue.setEOF();
+        _writer.waitForTermination();
+        _async_started = false;
+    }
+    return _file.close(*tsp) && !_write_error && ok;
 }
 
 bool ts::FileOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count)
 {
-    return _file.write(buffer, packet_count, *tsp);
+    // Without --split, all packets go to the main output file.
+    if (!_split) {
+        return writeMain(buffer, packet_count);
+    }
+
+    bool ok = true;
+
+    // Demultiplex the packets. Consecutive packets for the main file are
+    // forwarded as one run, packets for destination files are accumulated
+    // in the per-file buffers.
+    size_t main_start = 0;
+    for (size_t i = 0; ok && i < packet_count; ++i) {
+        const size_t index = _split_map[buffer[i].getPID()];
+        if (index == NPOS) {
+            // Packet for the main file, part of the current run.
+            continue;
+        }
+        // Forward the pending run for the main file.
+        if (i > main_start) {
+            ok = writeMain(buffer + main_start, i - main_start);
+        }
+        main_start = i + 1;
+        // Accumulate the packet, write the buffer in one operation when full.
+        SplitFile& sf(*_split_files[index]);
+        sf.buffer[sf.count++] = buffer[i];
+        if (ok && sf.count >= sf.buffer.size()) {
+            ok = flushSplitFile(sf);
+        }
+    }
+    if (ok && packet_count > main_start) {
+        ok = writeMain(buffer + main_start, packet_count - main_start);
+    }
+
+    // Flush the buffers which have been pending for too long.
+    const Time now(Time::CurrentUTC());
+    for (size_t n = 0; ok && n < _split_files.size(); ++n) {
+        SplitFile& sf(*_split_files[n]);
+        if (sf.count > 0 && now >= sf.due) {
+            ok = flushSplitFile(sf);
+        }
+    }
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Write packets to the main output file.
+//----------------------------------------------------------------------------
+
+bool ts::FileOutputPlugin::writeMain(const TSPacket* buffer, size_t packet_count)
+{
+    // Without --async-io, write synchronously.
+    if (!_async_io) {
+        return _file.write(buffer, packet_count, *tsp);
+    }
+
+    // With --async-io, enqueue the packets for the writer thread.
+    while (packet_count > 0) {
+        if (_write_error) {
+            return false;
+        }
+        TSPacket* out = nullptr;
+        size_t out_size = 0;
+        if (!_queue.lockWriteBuffer(out, out_size, packet_count) || out_size == 0) {
+            return false;
+        }
+        const size_t count = std::min(packet_count, out_size);
+        TSPacket::Copy(out, buffer, count);
+        _queue.releaseWriteBuffer(count);
+        buffer += count;
+        packet_count -= count;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Flush the accumulation buffer of one destination file.
+//----------------------------------------------------------------------------
+
+bool ts::FileOutputPlugin::flushSplitFile(SplitFile& sf)
+{
+    bool ok = true;
+    if (sf.count > 0) {
+        ok = sf.file.write(sf.buffer.data(), sf.count, *tsp);
+        sf.count = 0;
+    }
+    sf.due = Time::CurrentUTC() + _split_max_delay;
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Internal writer thread with --async-io.
+//----------------------------------------------------------------------------
+
+ts::FileOutputPlugin::Writer::Writer(FileOutputPlugin* plugin) :
+    _plugin(plugin)
+{
+}
+
+ts::FileOutputPlugin::Writer::~Writer()
+{
+    waitForTermination();
+}
+
+void ts::FileOutputPlugin::Writer::main()
+{
+    _plugin->tsp->debug(u"async writer thread started");
+
+    TSPacketVector buffer(MAX_ASYNC_WRITE_SIZE);
+    size_t count = 0;
+    BitRate bitrate = 0;
+
+    // Loop on packets from the queue until end of stream or stop.
+    while (_plugin->_queue.waitPackets(buffer.data(), buffer.size(), count, bitrate)) {
+        if (!_plugin->_write_error && !_plugin->_file.write(buffer.data(), count, *_plugin->tsp)) {
+            // Remember the error and keep draining the queue so that the
+            // tsp output thread never blocks on a dead file.
+            _plugin->_write_error = true;
+        }
+    }
+
+    _plugin->tsp->debug(u"async writer thread completed");
 }
@@ -35,6 +35,10 @@
 #pragma once
 #include "tsPlugin.h"
 #include "tsTSFile.h"
+#include "tsTSPacketQueue.h"
+#include "tsThread.h"
+#include "tsSafePtr.h"
+#include "tsTime.h"
 
 namespace ts {
     //!
@@ -58,8 +62,51 @@ namespace ts {
         virtual bool send(const TSPacket*, const TSPacketMetadata*, size_t) override;
 
     private:
+        // Internal thread which writes behind the tsp output thread with --async-io.
+        class Writer: public Thread
+        {
+            TS_NOBUILD_NOCOPY(Writer);
+        public:
+            Writer(FileOutputPlugin* plugin);
+            virtual ~Writer();
+            virtual void main() override;
+        private:
+            FileOutputPlugin* _plugin;
+        };
+
+        // One destination file with its accumulation buffer with --split.
+        class SplitFile
+        {
+            TS_NOCOPY(SplitFile);
+        public:
+            SplitFile();
+            UString        name;    // Destination file name.
+            TSFile         file;    // Destination file.
+            TSPacketVector buffer;  // Accumulation buffer.
+            size_t         count;   // Number of packets in the buffer.
+            Time           due;     // Deadline to flush the buffer, even when not full.
+        };
+        typedef SafePtr<SplitFile, NullMutex> SplitFilePtr;
+
         UString           _name;
         TSFile::OpenFlags _flags;
         TSFile            _file;
+        bool              _async_io;         // Write from a separate thread.
+        bool              _async_started;    // The writer thread is started.
+        volatile bool     _write_error;      // The writer thread reported a write error.
+        size_t            _async_queue_size; // Size in packets of the inter-thread queue.
+        Writer            _writer;           // Writer thread with --async-io.
+        TSPacketQueue     _queue;            // Inter-thread packet queue with --async-io.
+        bool              _split;            // Option --split: demultiplex PID's into several files.
+        size_t            _split_buf_packets;  // Size in packets of each accumulation buffer.
+        MilliSecond       _split_max_delay;  // Maximum buffering delay of a non-full buffer.
+        std::vector<SplitFilePtr> _split_files;  // All --split destination files.
+        size_t            _split_map[PID_MAX];   // Index in _split_files, per PID, NPOS for the main file.
+
+        // Write packets to the main output file (directly or through the async writer).
+        bool writeMain(const TSPacket* buffer, size_t packet_count);
+
+        // Flush the accumulation buffer of one destination file and rearm its deadline.
+        bool flushSplitFile(SplitFile& sf);
     };
 }
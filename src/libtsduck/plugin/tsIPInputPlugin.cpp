@@ -33,16 +33,48 @@
 TSDUCK_SOURCE;
 
 
+// Number of datagrams which are received in one batch. Each datagram needs
+// a reception buffer of IP_MAX_PACKET_SIZE bytes, do not make this too large.
+#define RECEIVE_BATCH_SIZE 32
+
+
 //----------------------------------------------------------------------------
 // Input constructor
 //----------------------------------------------------------------------------
 
 ts::IPInputPlugin::IPInputPlugin(TSP* tsp_) :
     AbstractDatagramInputPlugin(tsp_, IP_MAX_PACKET_SIZE, u"Receive TS packets from UDP/IP, multicast or unicast", u"[options] [address:]port"),
-    _sock(*tsp_)
+    _sock(*tsp_),
+    _batch_buffer(),
+    _datagrams(),
+    _dgram_count(0),
+    _dgram_next(0),
+    _use_ring(false)
+#if defined(TS_LINUX)
+    ,
+    _ring_fd(-1),
+    _ring_base(nullptr),
+    _ring_size(0),
+    _block_size(0),
+    _block_count(0),
+    _block_next(0),
+    _frame_next(nullptr),
+    _frame_remain(0)
+#endif
 {
     // Add UDP receiver common options.
     _sock.defineArgs(*this);
+
+    option(u"packet-ring");
+    help(u"packet-ring",
+         u"Capture the UDP datagrams through a memory-mapped kernel receive ring "
+         u"instead of reading the UDP socket (Linux only, requires the CAP_NET_RAW "
+         u"capability, typically root). The kernel delivers the raw frames in "
+         u"batches directly into a shared memory area, without one system call "
+         u"and one buffer copy per datagram. Datagrams are filtered on the "
+         u"specified destination address and port only, the source filtering "
+         u"options are ignored in this mode. When the ring cannot be created, "
+         u"the plugin falls back to the regular UDP socket.");
 }
 
 
@@ -52,6 +84,21 @@ ts::IPInputPlugin::IPInputPlugin(TSP* tsp_) :
 
 bool ts::IPInputPlugin::getOptions()
 {
+    _use_ring = present(u"packet-ring");
+#if !defined(TS_LINUX)
+    if (_use_ring) {
+        tsp->error(u"--packet-ring is only supported on Linux");
+        return false;
+    }
+#endif
+
+    // The kernel receive ring bypasses the UDP socket and cannot reorder or
+    // merge redundant streams.
+    if (_use_ring && (present(u"rtp-reorder") || present(u"redundant"))) {
+        tsp->error(u"--packet-ring is incompatible with --rtp-reorder and --redundant");
+        return false;
+    }
+
     // Get command line arguments for superclass and socket.
     return AbstractDatagramInputPlugin::getOptions() && _sock.loadArgs(duck, *this);
 }
@@ -63,8 +110,30 @@ bool ts::IPInputPlugin::getOptions()
 
 bool ts::IPInputPlugin::start()
 {
-    // Initialize superclass and UDP socket.
-    return AbstractDatagramInputPlugin::start() && _sock.open(*tsp);
+    // Initialize the datagram batch, one reception buffer per datagram.
+    _batch_buffer.resize(RECEIVE_BATCH_SIZE * IP_MAX_PACKET_SIZE);
+    _datagrams.resize(RECEIVE_BATCH_SIZE);
+    for (size_t i = 0; i < _datagrams.size(); ++i) {
+        _datagrams[i] = UDPSocket::Datagram(_batch_buffer.data() + i * IP_MAX_PACKET_SIZE, IP_MAX_PACKET_SIZE);
+    }
+    _dgram_count = _dgram_next = 0;
+
+    // Initialize superclass and UDP socket. The UDP socket is always open,
+    // even with --packet-ring: it carries the multicast memberships which
+    // make the network interface accept the multicast traffic.
+    if (!AbstractDatagramInputPlugin::start() || !_sock.open(*tsp)) {
+        return false;
+    }
+
+#if defined(TS_LINUX)
+    // Create the kernel receive ring on request. On failure (typically a
+    // permission problem), keep using the regular UDP socket.
+    if (_use_ring && !openRing()) {
+        tsp->warning(u"cannot create the packet receive ring, using the regular UDP socket");
+    }
+#endif
+
+    return true;
 }
 
 
@@ -74,6 +143,9 @@ bool ts::IPInputPlugin::start()
 
 bool ts::IPInputPlugin::stop()
 {
+#if defined(TS_LINUX)
+    closeRing();
+#endif
     _sock.close(*tsp);
     return AbstractDatagramInputPlugin::stop();
 }
@@ -107,9 +179,200 @@ bool ts::IPInputPlugin::setReceiveTimeout(MilliSecond timeout)
 // Datagram reception method.
 //----------------------------------------------------------------------------
 
-bool ts::IPInputPlugin::receiveDatagram(void* buffer, size_t buffer_size, size_t& ret_size)
+bool ts::IPInputPlugin::receiveDatagram(void* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp)
+{
+#if defined(TS_LINUX)
+    // Use the kernel receive ring when it was successfully created.
+    if (_ring_base != nullptr) {
+        return receiveFromRing(buffer, buffer_size, ret_size, timestamp);
+    }
+#endif
+
+    // When the previous batch of datagrams is exhausted, receive a new one.
+    // All datagrams which are queued in the kernel buffer are grabbed in one
+    // single system call when the system supports it.
+    if (_dgram_next >= _dgram_count) {
+        _dgram_next = 0;
+        if (!_sock.receiveBatch(_datagrams.data(), _datagrams.size(), _dgram_count, tsp, *tsp)) {
+            _dgram_count = 0;
+            return false;
+        }
+    }
+
+    // Return the next datagram of the batch.
+    const UDPSocket::Datagram& dgram(_datagrams[_dgram_next++]);
+    ret_size = std::min(dgram.ret_size, buffer_size);
+    ::memcpy(buffer, dgram.data, ret_size);  // Flawfinder: ignore
+    timestamp = dgram.timestamp_us;
+    return true;
+}
+
+
+#if defined(TS_LINUX)
+//----------------------------------------------------------------------------
+// Create the memory-mapped kernel receive ring (Linux only).
+//----------------------------------------------------------------------------
+
+bool ts::IPInputPlugin::openRing()
 {
-    SocketAddress sender;
-    SocketAddress destination;
-    return _sock.receive(buffer, buffer_size, ret_size, sender, destination, tsp, *tsp);
+    // Create a raw packet socket. With SOCK_DGRAM, the kernel removes the
+    // link-level header from the captured frames, the data start at the IP
+    // header. This requires the CAP_NET_RAW capability.
+    _ring_fd = ::socket(AF_PACKET, SOCK_DGRAM, htons(ETH_P_IP));
+    if (_ring_fd < 0) {
+        tsp->warning(u"cannot create packet capture socket: %s", {ErrorCodeMessage(LastErrorCode())});
+        return false;
+    }
+
+    // Use version 3 of the kernel ring interface: the frames are grouped in
+    // blocks and one poll() wakeup delivers a full block of frames.
+    int version = TPACKET_V3;
+    if (::setsockopt(_ring_fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0) {
+        tsp->warning(u"error setting packet ring version: %s", {ErrorCodeMessage(LastErrorCode())});
+        closeRing();
+        return false;
+    }
+
+    // Size the ring: 64 blocks of 512 kB. A block is handed over to user
+    // space when it is full or after the retire timeout, whichever comes
+    // first, so small blocks of traffic are not delayed.
+    ::tpacket_req3 req;
+    TS_ZERO(req);
+    req.tp_block_size = 512 * 1024;
+    req.tp_block_nr = 64;
+    req.tp_frame_size = 2048;
+    req.tp_frame_nr = (req.tp_block_size / req.tp_frame_size) * req.tp_block_nr;
+    req.tp_retire_blk_tov = 10; // milliseconds
+    if (::setsockopt(_ring_fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) != 0) {
+        tsp->warning(u"error creating packet receive ring: %s", {ErrorCodeMessage(LastErrorCode())});
+        closeRing();
+        return false;
+    }
+
+    // Map the ring in the process address space.
+    _block_size = size_t(req.tp_block_size);
+    _block_count = size_t(req.tp_block_nr);
+    _ring_size = _block_size * _block_count;
+    void* const base = ::mmap(nullptr, _ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, _ring_fd, 0);
+    if (base == MAP_FAILED) {
+        tsp->warning(u"error mapping packet receive ring: %s", {ErrorCodeMessage(LastErrorCode())});
+        closeRing();
+        return false;
+    }
+    _ring_base = reinterpret_cast<uint8_t*>(base);
+
+    // Capture IP traffic from all interfaces.
+    ::sockaddr_ll sll;
+    TS_ZERO(sll);
+    sll.sll_family = AF_PACKET;
+    sll.sll_protocol = htons(ETH_P_IP);
+    if (::bind(_ring_fd, reinterpret_cast<::sockaddr*>(&sll), sizeof(sll)) != 0) {
+        tsp->warning(u"error binding packet capture socket: %s", {ErrorCodeMessage(LastErrorCode())});
+        closeRing();
+        return false;
+    }
+
+    _block_next = 0;
+    _frame_next = nullptr;
+    _frame_remain = 0;
+    tsp->verbose(u"using kernel packet receive ring, %'d blocks of %'d bytes", {_block_count, _block_size});
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Close the memory-mapped kernel receive ring (Linux only).
+//----------------------------------------------------------------------------
+
+void ts::IPInputPlugin::closeRing()
+{
+    if (_ring_base != nullptr) {
+        ::munmap(_ring_base, _ring_size);
+        _ring_base = nullptr;
+    }
+    if (_ring_fd >= 0) {
+        ::close(_ring_fd);
+        _ring_fd = -1;
+    }
+    _ring_size = _block_size = _block_count = _block_next = _frame_remain = 0;
+    _frame_next = nullptr;
+}
+
+
+//----------------------------------------------------------------------------
+// Receive the payload of the next matching datagram from the ring.
+//----------------------------------------------------------------------------
+
+bool ts::IPInputPlugin::receiveFromRing(void* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp)
+{
+    const SocketAddress dest(_sock.destination());
+
+    for (;;) {
+
+        // Wait for a block of frames when the current one is exhausted.
+        while (_frame_remain == 0) {
+            ::tpacket_block_desc* const block = reinterpret_cast<::tpacket_block_desc*>(_ring_base + _block_next * _block_size);
+            if ((block->hdr.bh1.block_status & TP_STATUS_USER) == 0) {
+                // The block is still owned by the kernel, wait for frames.
+                ::pollfd pfd;
+                TS_ZERO(pfd);
+                pfd.fd = _ring_fd;
+                pfd.events = POLLIN;
+                ::poll(&pfd, 1, 1000);
+                if (tsp->aborting()) {
+                    return false;
+                }
+            }
+            else if (block->hdr.bh1.num_pkts == 0) {
+                // Empty block, hand it back to the kernel immediately.
+                block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+                _block_next = (_block_next + 1) % _block_count;
+            }
+            else {
+                _frame_next = reinterpret_cast<uint8_t*>(block) + block->hdr.bh1.offset_to_first_pkt;
+                _frame_remain = size_t(block->hdr.bh1.num_pkts);
+            }
+        }
+
+        // Locate the next frame and move past it in the block.
+        const ::tpacket3_hdr* const frame = reinterpret_cast<const ::tpacket3_hdr*>(_frame_next);
+        const uint8_t* const net = _frame_next + frame->tp_net;
+        const uint8_t* const end = net + frame->tp_snaplen;
+        if (--_frame_remain == 0) {
+            // Last frame of the block, hand the block back to the kernel.
+            ::tpacket_block_desc* const block = reinterpret_cast<::tpacket_block_desc*>(_ring_base + _block_next * _block_size);
+            block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+            _block_next = (_block_next + 1) % _block_count;
+            _frame_next = nullptr;
+        }
+        else {
+            _frame_next += frame->tp_next_offset;
+        }
+
+        // Filter the frame: complete IPv4 header, UDP, not a fragment,
+        // expected destination address and port.
+        if (end < net + 28 || (net[0] >> 4) != 4 || net[9] != IPPROTO_UDP || (GetUInt16(net + 6) & 0x3FFF) != 0) {
+            continue;
+        }
+        const size_t ip_header = size_t(net[0] & 0x0F) * 4;
+        const uint8_t* const udp = net + ip_header;
+        if (udp + 8 > end || GetUInt16(udp + 2) != dest.port()) {
+            continue;
+        }
+        if (dest.hasAddress() && IPAddress(GetUInt32(net + 16)) != dest) {
+            continue;
+        }
+
+        // Return the UDP payload of the datagram. The ring frames carry the
+        // capture time of each frame (the NIC hardware time when the driver
+        // provides it, a kernel software time stamp otherwise).
+        const size_t udp_length = GetUInt16(udp + 4);
+        ret_size = udp_length >= 8 ? udp_length - 8 : 0;
+        ret_size = std::min<size_t>(ret_size, end - udp - 8);
+        ret_size = std::min(ret_size, buffer_size);
+        ::memcpy(buffer, udp + 8, ret_size);  // Flawfinder: ignore
+        timestamp = MicroSecond(frame->tp_sec) * MicroSecPerSec + MicroSecond(frame->tp_nsec / NanoSecPerMicroSec);
+        return true;
+    }
 }
+#endif // TS_LINUX
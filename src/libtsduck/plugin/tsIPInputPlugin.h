@@ -60,9 +60,29 @@ namespace ts {
 
     protected:
         // Implementation of AbstractDatagramInputPlugin.
-        virtual bool receiveDatagram(void* buffer, size_t buffer_size, size_t& ret_size) override;
+        virtual bool receiveDatagram(void* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp) override;
 
     private:
-        UDPReceiver _sock; // Incoming socket with associated command line options.
+        UDPReceiver _sock;         // Incoming socket with associated command line options.
+        ByteBlock   _batch_buffer; // Reception buffers of all datagrams of a batch.
+        std::vector<UDPSocket::Datagram> _datagrams; // Datagrams of the last batch.
+        size_t      _dgram_count;  // Number of datagrams in the last batch.
+        size_t      _dgram_next;   // Index of next datagram to return.
+        bool        _use_ring;     // Option --packet-ring.
+#if defined(TS_LINUX)
+        int         _ring_fd;      // AF_PACKET socket with a mapped receive ring.
+        uint8_t*    _ring_base;    // Mapped ring area.
+        size_t      _ring_size;    // Total size of the mapped ring area.
+        size_t      _block_size;   // Size of one block of the ring.
+        size_t      _block_count;  // Number of blocks in the ring.
+        size_t      _block_next;   // Index of the block being processed.
+        uint8_t*    _frame_next;   // Next frame in the current block.
+        size_t      _frame_remain; // Remaining frames in the current block.
+
+        // Manage the memory-mapped kernel receive ring (option --packet-ring).
+        bool openRing();
+        void closeRing();
+        bool receiveFromRing(void* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp);
+#endif
     };
 }
@@ -276,14 +276,33 @@ bool ts::IPOutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pkt_d
     }
 
     // Send subsequent packets from the global buffer.
-    while (packet_count > min_burst) {
-        size_t count = std::min(packet_count, _pkt_burst);
-        if (!sendDatagram(pkt, count)) {
+    if (!_use_rtp && packet_count > min_burst) {
+        // Without RTP, all datagrams are plain slices of the contiguous packet
+        // buffer. Send them all in one batched operation (see UDPSocket) instead
+        // of one system call per burst. With --enforce-burst, exclude the last
+        // incomplete burst, it is kept in the output buffer below.
+        size_t count = packet_count;
+        if (_enforce_burst) {
+            count -= packet_count % _pkt_burst;
+        }
+        if (!_sock.sendSegments(pkt, count * PKT_SIZE, _pkt_burst * PKT_SIZE, *tsp)) {
             return false;
         }
+        _pkt_count += count;
         pkt += count;
         packet_count -= count;
     }
+    else {
+        // With RTP, each datagram has its own header and timestamp, send them one by one.
+        while (packet_count > min_burst) {
+            size_t count = std::min(packet_count, _pkt_burst);
+            if (!sendDatagram(pkt, count)) {
+                return false;
+            }
+            pkt += count;
+            packet_count -= count;
+        }
+    }
 
     // If remaining packets are present, save them in output buffer.
     if (packet_count > 0) {
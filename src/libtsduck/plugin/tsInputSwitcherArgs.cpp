@@ -50,6 +50,7 @@ ts::InputSwitcherArgs::InputSwitcherArgs() :
     appName(),
     fastSwitch(false),
     delayedSwitch(false),
+    seamlessSwitch(false),
     terminate(false),
     monitor(false),
     reusePort(false),
@@ -72,6 +73,7 @@ ts::InputSwitcherArgs::InputSwitcherArgs(const InputSwitcherArgs& other) :
     appName(other.appName),
     fastSwitch(other.fastSwitch),
     delayedSwitch(other.delayedSwitch),
+    seamlessSwitch(other.seamlessSwitch),
     terminate(other.terminate),
     monitor(other.monitor),
     reusePort(other.reusePort),
@@ -195,6 +197,17 @@ void ts::InputSwitcherArgs::defineArgs(Args& args) const
               u"If an optional address is specified, it must be a local IP address of the system. "
               u"By default, there is no remote control.");
 
+    args.option(u"seamless-switch");
+    args.help(u"seamless-switch",
+              u"Align the switch on a clean boundary of the new input stream. "
+              u"When switching to another input plugin, packets from the new input "
+              u"are dropped until the first packet holding a PCR, giving the "
+              u"downstream decoders a clean clock reference at the cutover point. "
+              u"This option is most effective with --fast-switch where the other "
+              u"inputs continuously receive packets: the alignment point is then "
+              u"searched in the packets which are already buffered and the switch "
+              u"adds no latency.");
+
     args.option(u"terminate", 't');
     args.help(u"terminate", u"Terminate execution when the current input plugin terminates.");
 
@@ -213,6 +226,7 @@ bool ts::InputSwitcherArgs::loadArgs(DuckContext& duck, Args& args)
     appName = args.appName();
     fastSwitch = args.present(u"fast-switch");
     delayedSwitch = args.present(u"delayed-switch");
+    seamlessSwitch = args.present(u"seamless-switch");
     terminate = args.present(u"terminate");
     cycleCount = args.intValue<size_t>(u"cycle", args.present(u"infinite") ? 0 : 1);
     monitor = args.present(u"monitor");
@@ -48,6 +48,7 @@ namespace ts {
         UString             appName;           //!< Application name, for help messages.
         bool                fastSwitch;        //!< Fast switch between input plugins.
         bool                delayedSwitch;     //!< Delayed switch between input plugins.
+        bool                seamlessSwitch;    //!< Align the switch on a PCR boundary of the new input.
         bool                terminate;         //!< Terminate when one input plugin completes.
         bool                monitor;           //!< Run a resource monitoring thread.
         bool                reusePort;         //!< Reuse-port socket option.
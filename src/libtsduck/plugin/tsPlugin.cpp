@@ -110,6 +110,21 @@ ts::TSPacketMetadata::LabelSet ts::ProcessorPlugin::getOnlyLabelOption() const
 }
 
 
+//----------------------------------------------------------------------------
+// Tell if the plugin is a read-only observer (packet processing plugins).
+//----------------------------------------------------------------------------
+
+bool ts::ProcessorPlugin::isReadOnlyObserver()
+{
+    return false;
+}
+
+bool ts::ProcessorPlugin::isStateless()
+{
+    return false;
+}
+
+
 //----------------------------------------------------------------------------
 // Default implementations of virtual methods.
 //----------------------------------------------------------------------------
@@ -526,6 +526,40 @@ namespace ts {
         //!
         virtual Status processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data) = 0;
 
+        //!
+        //! Tell if the plugin is a read-only observer.
+        //!
+        //! A read-only observer never modifies the packets or their metadata,
+        //! it only monitors the stream (analysis, statistics, logging). When a
+        //! plugin declares itself as a read-only observer, tsp runs it on a
+        //! snapshot view of the packet window, without the per-packet
+        //! modification bookkeeping (drop, nullify, flush, bitrate change),
+        //! and releases the window to the next plugin in larger batches.
+        //!
+        //! A read-only observer shall only return TSP_OK or TSP_END from
+        //! processPacket(). The default implementation returns false.
+        //!
+        //! @return True if the plugin never modifies packets or metadata.
+        //!
+        virtual bool isReadOnlyObserver();
+
+        //!
+        //! Tell if the plugin is stateless across PID's.
+        //!
+        //! A stateless plugin keeps no processing state which is shared between
+        //! packets of distinct PID's. With tsp option --shard-threads, such a
+        //! plugin may be invoked concurrently from several worker threads, each
+        //! thread submitting the packets of a disjoint set of PID's, in stream
+        //! order within each PID.
+        //!
+        //! Plugins which use a demux, a packetizer or any structure which is
+        //! fed with packets from several PID's shall not declare themselves
+        //! stateless. The default implementation returns false.
+        //!
+        //! @return True if the plugin may process packets of distinct PID's concurrently.
+        //!
+        virtual bool isStateless();
+
         //!
         //! Get the content of the --only-label options.
         //! The value of the option is fetched each time this method is called.
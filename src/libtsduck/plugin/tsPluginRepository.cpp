@@ -30,6 +30,7 @@
 #include "tsPluginRepository.h"
 #include "tsApplicationSharedLibrary.h"
 #include "tsPluginSharedLibrary.h"
+#include "tsDuckExtensionRepository.h"
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
 
@@ -52,11 +53,106 @@ ts::PluginRepository::PluginRepository() :
     _sharedLibraryAllowed(true),
     _inputPlugins(),
     _processorPlugins(),
-    _outputPlugins()
+    _outputPlugins(),
+    _pathCacheLoaded(false),
+    _pathCache()
 {
 }
 
 
+//----------------------------------------------------------------------------
+// Persistent on-disk cache of plugin names to shared library paths.
+//----------------------------------------------------------------------------
+
+// The cache is a text file in the user's home directory. It starts with one
+// "dir" line per directory of the plugin search path, with the modification
+// time of the directory, followed by one "plugin" line per plugin. The cache
+// is discarded and rebuilt when the search path or a directory has changed.
+// The file is automatically regenerated and is safe to delete.
+
+namespace {
+    ts::UString PathCacheFile()
+    {
+        return ts::UserHomeDirectory() + ts::PathSeparator + u".tsduck.plugins";
+    }
+}
+
+void ts::PluginRepository::loadPathCache(Report& report)
+{
+    // Load the cache only once per process.
+    if (_pathCacheLoaded) {
+        return;
+    }
+    _pathCacheLoaded = true;
+
+    // Build the signature of the current plugin search path: one line per
+    // directory with its modification time.
+    UStringList dirs;
+    ApplicationSharedLibrary::GetSearchPath(dirs, TS_PLUGINS_PATH);
+    UStringList signature;
+    for (UStringList::const_iterator it = dirs.begin(); it != dirs.end(); ++it) {
+        const Time mtime(GetFileModificationTimeUTC(*it));
+        signature.push_back(UString::Format(u"dir %d %s", {mtime - Time::Epoch, *it}));
+    }
+
+    // Load the cache file and check that its signature matches the search path.
+    UStringList lines;
+    if (UString::Load(lines, PathCacheFile())) {
+        UStringList::const_iterator sig = signature.begin();
+        bool valid = true;
+        for (UStringList::const_iterator it = lines.begin(); valid && it != lines.end(); ++it) {
+            if (it->startWith(u"dir ")) {
+                // All "dir" lines must match the current signature, in order.
+                valid = sig != signature.end() && *it == *sig++;
+            }
+            else if (it->startWith(u"plugin ")) {
+                // Format: "plugin <name> <path>", the path may contain spaces.
+                const size_t sep = it->find(u' ', 7);
+                if (sep != NPOS) {
+                    _pathCache[it->substr(7, sep - 7)] = it->substr(sep + 1);
+                }
+            }
+        }
+        if (valid && sig == signature.end()) {
+            report.debug(u"plugin path cache is valid, %d plugins", {_pathCache.size()});
+            return;
+        }
+    }
+
+    // The cache is missing or stale. Rebuild it from the file names in the
+    // search path. No shared library is loaded, the plugin name is derived
+    // from the file name. The first directory in the path wins.
+    _pathCache.clear();
+    UStringVector files;
+    ApplicationSharedLibrary::GetPluginList(files, u"tsplugin_", TS_PLUGINS_PATH);
+    for (size_t i = 0; i < files.size(); ++i) {
+        const UString name(PathPrefix(BaseName(files[i])).substr(8)); // skip "tsplugin_"
+        if (_pathCache.find(name) == _pathCache.end()) {
+            _pathCache[name] = files[i];
+        }
+    }
+
+    // Save the new cache. Failure to save is not an error, simply no cache.
+    lines.clear();
+    lines.push_back(u"# TSDuck plugin path cache, automatically regenerated, safe to delete.");
+    lines.insert(lines.end(), signature.begin(), signature.end());
+    for (NameToPathMap::const_iterator it = _pathCache.begin(); it != _pathCache.end(); ++it) {
+        lines.push_back(UString::Format(u"plugin %s %s", {it->first, it->second}));
+    }
+    UString::Save(lines, PathCacheFile());
+    report.debug(u"plugin path cache rebuilt, %d plugins", {_pathCache.size()});
+}
+
+ts::UString ts::PluginRepository::cachedLibraryPath(const UString& name, Report& report)
+{
+    loadPathCache(report);
+    const NameToPathMap::const_iterator it = _pathCache.find(name);
+    // Ignore a cached path when the library file has disappeared since the
+    // cache was built, the normal search path lookup is then used.
+    return it != _pathCache.end() && FileExists(it->second) ? it->second : UString();
+}
+
+
 //----------------------------------------------------------------------------
 // Plugin registration.
 //----------------------------------------------------------------------------
@@ -104,6 +200,9 @@ ts::PluginRepository::Register::Register(const char* name, NewOutputProfile allo
 
 ts::NewInputProfile ts::PluginRepository::getInput(const UString& name, Report& report)
 {
+    // Extensions may statically register plugins, make sure they are loaded (lazy, done once).
+    DuckExtensionRepository::Instance();
+
     // Search plugin in current cache.
     const InputMap::const_iterator it = _inputPlugins.find(name);
     if (it != _inputPlugins.end()) {
@@ -117,8 +216,10 @@ ts::NewInputProfile ts::PluginRepository::getInput(const UString& name, Report&
         return nullptr;
     }
 
-    // Try to load a shareable library.
-    PluginSharedLibrary shlib(name, report);
+    // Try to load a shareable library. The path cache locates the library
+    // file directly, the search path is only probed on a cache miss.
+    const UString path(cachedLibraryPath(name, report));
+    PluginSharedLibrary shlib(path.empty() ? name : path, report);
     if (!shlib.isLoaded()) {
         // Error message already displayed.
         return nullptr;
@@ -135,6 +236,9 @@ ts::NewInputProfile ts::PluginRepository::getInput(const UString& name, Report&
 
 ts::NewProcessorProfile ts::PluginRepository::getProcessor(const UString& name, Report& report)
 {
+    // Extensions may statically register plugins, make sure they are loaded (lazy, done once).
+    DuckExtensionRepository::Instance();
+
     // Search plugin in current cache.
     const ProcessorMap::const_iterator it = _processorPlugins.find(name);
     if (it != _processorPlugins.end()) {
@@ -148,8 +252,10 @@ ts::NewProcessorProfile ts::PluginRepository::getProcessor(const UString& name,
         return nullptr;
     }
 
-    // Try to load a shareable library.
-    PluginSharedLibrary shlib(name, report);
+    // Try to load a shareable library. The path cache locates the library
+    // file directly, the search path is only probed on a cache miss.
+    const UString path(cachedLibraryPath(name, report));
+    PluginSharedLibrary shlib(path.empty() ? name : path, report);
     if (!shlib.isLoaded()) {
         // Error message already displayed.
         return nullptr;
@@ -166,6 +272,9 @@ ts::NewProcessorProfile ts::PluginRepository::getProcessor(const UString& name,
 
 ts::NewOutputProfile ts::PluginRepository::getOutput(const UString& name, Report& report)
 {
+    // Extensions may statically register plugins, make sure they are loaded (lazy, done once).
+    DuckExtensionRepository::Instance();
+
     // Search plugin in current cache.
     const OutputMap::const_iterator it = _outputPlugins.find(name);
     if (it != _outputPlugins.end()) {
@@ -179,8 +288,10 @@ ts::NewOutputProfile ts::PluginRepository::getOutput(const UString& name, Report
         return nullptr;
     }
 
-    // Try to load a shareable library.
-    PluginSharedLibrary shlib(name, report);
+    // Try to load a shareable library. The path cache locates the library
+    // file directly, the search path is only probed on a cache miss.
+    const UString path(cachedLibraryPath(name, report));
+    PluginSharedLibrary shlib(path.empty() ? name : path, report);
     if (!shlib.isLoaded()) {
         // Error message already displayed.
         return nullptr;
@@ -202,18 +313,21 @@ ts::NewOutputProfile ts::PluginRepository::getOutput(const UString& name, Report
 
 void ts::PluginRepository::loadAllPlugins(Report& report)
 {
+    // Extensions may statically register plugins, make sure they are loaded (lazy, done once).
+    DuckExtensionRepository::Instance();
+
     // Do nothing if loading dynamic libraries is disallowed.
     if (!_sharedLibraryAllowed) {
         return;
     }
 
-    // Get list of shared library files
-    UStringVector files;
-    ApplicationSharedLibrary::GetPluginList(files, u"tsplugin_", TS_PLUGINS_PATH);
+    // The path cache holds the plugin files of the whole search path,
+    // rebuilt from a directory scan when stale.
+    loadPathCache(report);
 
     // Load all plugins and register allocator functions (when not zero).
-    for (size_t i = 0; i < files.size(); ++i) {
-        PluginSharedLibrary shlib(files[i], report);
+    for (NameToPathMap::const_iterator it = _pathCache.begin(); it != _pathCache.end(); ++it) {
+        PluginSharedLibrary shlib(it->second, report);
         if (shlib.isLoaded()) {
             const UString name(shlib.moduleName());
             registerInput(name, shlib.new_input);
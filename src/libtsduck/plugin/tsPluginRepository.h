@@ -193,11 +193,21 @@ namespace ts {
         typedef std::map<UString, NewInputProfile>     InputMap;
         typedef std::map<UString, NewProcessorProfile> ProcessorMap;
         typedef std::map<UString, NewOutputProfile>    OutputMap;
+        typedef std::map<UString, UString>             NameToPathMap;
 
-        bool         _sharedLibraryAllowed;
-        InputMap     _inputPlugins;
-        ProcessorMap _processorPlugins;
-        OutputMap    _outputPlugins;
+        bool          _sharedLibraryAllowed;
+        InputMap      _inputPlugins;
+        ProcessorMap  _processorPlugins;
+        OutputMap     _outputPlugins;
+        bool          _pathCacheLoaded;
+        NameToPathMap _pathCache;
+
+        // Load the persistent on-disk cache of plugin names to shared library paths.
+        // The cache is rebuilt and saved when the plugin search path has changed.
+        void loadPathCache(Report& report);
+
+        // Get the cached shared library path of a plugin, empty string when unknown.
+        UString cachedLibraryPath(const UString& name, Report& report);
 
         // List one plugin.
         static void ListOnePlugin(UString& out, const UString& name, Plugin* plugin, size_t name_width, int flags);
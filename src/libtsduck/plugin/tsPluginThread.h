@@ -89,6 +89,21 @@ namespace ts {
             return _shlib;
         }
 
+        //!
+        //! Replace the plugin instance.
+        //! Used to swap in a new instance of the same plugin which was created
+        //! and started concurrently (shadow restart). The caller becomes
+        //! responsible for stopping and deallocating the previous instance.
+        //! @param [in] shlib Address of the new plugin interface.
+        //! @return Address of the previous plugin interface.
+        //!
+        Plugin* swapPlugin(Plugin* shlib)
+        {
+            Plugin* const previous = _shlib;
+            _shlib = shlib;
+            return previous;
+        }
+
         //!
         //! Get the plugin name.
         //! @return The plugin name.
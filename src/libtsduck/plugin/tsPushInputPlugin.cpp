@@ -148,7 +148,7 @@ size_t ts::PushInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data
     BitRate bitrate = 0;
 
     // Wait for some packets from the receiver thread.
-    if (!_queue.waitPackets(buffer, max_packets, count, bitrate)) {
+    if (!_queue.waitPackets(buffer, pkt_data, max_packets, count, bitrate)) {
         // End of input.
         count = 0;
     }
@@ -163,13 +163,22 @@ size_t ts::PushInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data
 //----------------------------------------------------------------------------
 
 bool ts::PushInputPlugin::pushPackets(const TSPacket* buffer, size_t count)
+{
+    return pushPackets(buffer, nullptr, count);
+}
+
+bool ts::PushInputPlugin::pushPackets(const TSPacket* buffer, const TSPacketMetadata* mdata, size_t count)
 {
     // We are executing in the context of the receiver thread.
     // Send packets by chunks, loop until everything is pushed.
     while (count > 0) {
 
-        TSPacket* out_buffer = nullptr;
-        size_t out_count = 0;
+        TSPacket* out_buffer1 = nullptr;
+        TSPacket* out_buffer2 = nullptr;
+        TSPacketMetadata* out_mdata1 = nullptr;
+        TSPacketMetadata* out_mdata2 = nullptr;
+        size_t out_count1 = 0;
+        size_t out_count2 = 0;
 
         // Abort now if the application is terminating.
         if (tsp->aborting() || _queue.stopped()) {
@@ -177,24 +186,50 @@ bool ts::PushInputPlugin::pushPackets(const TSPacket* buffer, size_t count)
             return false;
         }
 
-        // Wait for space in the queue buffer.
-        if (!_queue.lockWriteBuffer(out_buffer, out_count, count)) {
+        // Wait for space in the queue buffer. Use the two-region reserve so
+        // that a complete batch is pushed with one single reserve / commit
+        // sequence, even when the free space wraps up in the circular buffer.
+        if (!_queue.lockWriteBuffer(out_buffer1, out_mdata1, out_count1, out_buffer2, out_mdata2, out_count2, count)) {
             return false;
         }
 
-        assert(out_buffer != nullptr);
-        assert(out_count > 0);
+        assert(out_buffer1 != nullptr);
+        assert(out_count1 > 0);
+
+        // Move packets into the two regions of the queue.
+        out_count1 = std::min(out_count1, count);
+        out_count2 = std::min(out_count2, count - out_count1);
+        TSPacket::Copy(out_buffer1, buffer, out_count1);
+        if (out_count2 > 0) {
+            TSPacket::Copy(out_buffer2, buffer + out_count1, out_count2);
+        }
+
+        // Move or reset the packet metadata.
+        for (size_t i = 0; i < out_count1; ++i) {
+            if (mdata != nullptr) {
+                out_mdata1[i] = mdata[i];
+            }
+            else {
+                out_mdata1[i].reset();
+            }
+        }
+        for (size_t i = 0; i < out_count2; ++i) {
+            if (mdata != nullptr) {
+                out_mdata2[i] = mdata[out_count1 + i];
+            }
+            else {
+                out_mdata2[i].reset();
+            }
+        }
 
-        // Move packets into the queue.
-        if (out_count > count) {
-            out_count = count;
+        buffer += out_count1 + out_count2;
+        if (mdata != nullptr) {
+            mdata += out_count1 + out_count2;
         }
-        TSPacket::Copy(out_buffer, buffer, out_count);
-        buffer += out_count;
-        count -= out_count;
+        count -= out_count1 + out_count2;
 
-        // Signal the new packets in the queue.
-        _queue.releaseWriteBuffer(out_count);
+        // Signal the new packets in the queue, one notification for the whole batch.
+        _queue.releaseWriteBuffer(out_count1 + out_count2);
     }
 
     return true;
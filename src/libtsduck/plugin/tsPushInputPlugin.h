@@ -102,6 +102,18 @@ namespace ts {
         //!
         virtual bool pushPackets(const TSPacket* buffer, size_t count);
 
+        //!
+        //! Push packets and their metadata to the @c tsp chain.
+        //! This method must be called from the processInput() method in the superclass.
+        //! @param [in] buffer Address of the buffer containing incoming packets.
+        //! @param [in] mdata Address of the metadata for the incoming packets, same
+        //! number of elements as @a buffer. Can be a null pointer when the subclass
+        //! has no metadata, in which case default metadata are transmitted.
+        //! @param [in] count Size of @a buffer in number of packets.
+        //! @return True on success, false on error or requested termination.
+        //!
+        virtual bool pushPackets(const TSPacket* buffer, const TSPacketMetadata* mdata, size_t count);
+
         //!
         //! Constructor.
         //!
@@ -31,6 +31,8 @@
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
 
+#define DEFAULT_RECONNECT_DELAY 100  // Default delay between reconnection attempts, in milliseconds.
+
 
 //----------------------------------------------------------------------------
 // Input constructor
@@ -41,7 +43,9 @@ ts::SRTInputPlugin::SRTInputPlugin(TSP* tsp_) :
     _sock(),
     _mode(SRTSocketMode::CALLER),
     _local_addr(),
-    _remote_addr()
+    _remote_addr(),
+    _reconnect(false),
+    _reconnect_delay(0)
 {
     _sock.defineArgs(*this);
 
@@ -54,6 +58,13 @@ ts::SRTInputPlugin::SRTInputPlugin(TSP* tsp_) :
 
     option(u"rendezvous", 0, ts::Args::STRING);
     help(u"rendezvous", u"address:port", u"Specify local address and port for rendez-vous mode.");
+
+    option(u"reconnect", 0, ts::Args::POSITIVE, 0, 1, 0, 0, true);
+    help(u"reconnect", u"milliseconds",
+         u"Automatically reconnect to the peer when the SRT connection is broken. "
+         u"The optional value is the delay in milliseconds between two connection "
+         u"attempts (default: " TS_STRINGIFY(DEFAULT_RECONNECT_DELAY) u" ms). "
+         u"By default, a broken connection terminates the input.");
 }
 
 
@@ -81,6 +92,9 @@ bool ts::SRTInputPlugin::getOptions()
         }
     }
 
+    _reconnect = present(u"reconnect");
+    _reconnect_delay = intValue<MilliSecond>(u"reconnect", DEFAULT_RECONNECT_DELAY);
+
     // Get command line arguments for superclass and socket.
     return AbstractDatagramInputPlugin::getOptions() && _sock.loadArgs(duck, *this);
 }
@@ -123,7 +137,20 @@ bool ts::SRTInputPlugin::abortInput()
 // Datagram reception method.
 //----------------------------------------------------------------------------
 
-bool ts::SRTInputPlugin::receiveDatagram(void* buffer, size_t buffer_size, size_t& ret_size)
+bool ts::SRTInputPlugin::receiveDatagram(void* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp)
 {
-    return _sock.receive(buffer, buffer_size, ret_size, *tsp);
+    // The SRT library does not report the reception time of the datagrams.
+    timestamp = -1;
+
+    while (!_sock.receive(buffer, buffer_size, ret_size, *tsp)) {
+        // Reception failed, typically because the connection was broken.
+        if (!_reconnect || tsp->aborting()) {
+            return false;
+        }
+        tsp->warning(u"SRT connection lost, reconnecting");
+        _sock.close(*tsp);
+        SleepThread(_reconnect_delay);
+        _sock.open(_mode, _local_addr, _remote_addr, *tsp);
+    }
+    return true;
 }
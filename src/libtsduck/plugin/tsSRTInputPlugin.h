@@ -59,12 +59,14 @@ namespace ts {
 
     protected:
         // Implementation of AbstractDatagramInputPlugin.
-        virtual bool receiveDatagram(void* buffer, size_t buffer_size, size_t& ret_size) override;
+        virtual bool receiveDatagram(void* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp) override;
 
     private:
         SRTSocket     _sock;
         SRTSocketMode _mode;
         SocketAddress _local_addr;
         SocketAddress _remote_addr;
+        bool          _reconnect;        // Option --reconnect: reopen the connection when it is broken.
+        MilliSecond   _reconnect_delay;  // Delay between two reconnection attempts.
     };
 }
@@ -28,9 +28,11 @@
 //----------------------------------------------------------------------------
 
 #include "tsSRTOutputPlugin.h"
+#include "tsSysUtils.h"
 TSDUCK_SOURCE;
 
 #define MAX_PKT_MESSAGE_MODE 7
+#define DEFAULT_RECONNECT_DELAY 100  // Default delay between reconnection attempts, in milliseconds.
 
 
 //----------------------------------------------------------------------------
@@ -43,7 +45,9 @@ ts::SRTOutputPlugin::SRTOutputPlugin(TSP* tsp_) :
     _remote_addr(),
     _pkt_count(0),
     _sock(),
-    _mode(SRTSocketMode::LISTENER)
+    _mode(SRTSocketMode::LISTENER),
+    _reconnect(false),
+    _reconnect_delay(0)
 {
     _sock.defineArgs(*this);
 
@@ -52,6 +56,14 @@ ts::SRTOutputPlugin::SRTOutputPlugin(TSP* tsp_) :
 
     option(u"rendezvous", 0, ts::Args::STRING);
     help(u"rendezvous", u"address:port", u"Specify remote address and port for rendez-vous mode.");
+
+    option(u"reconnect", 0, ts::Args::POSITIVE, 0, 1, 0, 0, true);
+    help(u"reconnect", u"milliseconds",
+         u"Automatically reestablish the connection when it is broken: wait for a "
+         u"new caller in listener mode, reconnect to the peer in rendez-vous mode. "
+         u"The optional value is the delay in milliseconds between two attempts "
+         u"(default: " TS_STRINGIFY(DEFAULT_RECONNECT_DELAY) u" ms). "
+         u"By default, a broken connection terminates the output.");
 }
 
 
@@ -79,6 +91,9 @@ bool ts::SRTOutputPlugin::getOptions(void)
         }
     }
 
+    _reconnect = present(u"reconnect");
+    _reconnect_delay = intValue<MilliSecond>(u"reconnect", DEFAULT_RECONNECT_DELAY);
+
     return _sock.loadArgs(duck, *this);
 }
 
@@ -125,7 +140,15 @@ bool ts::SRTOutputPlugin::send(const ts::TSPacket* pkt, const ts::TSPacketMetada
         const size_t to_send = (_sock.getMessageApi() && tmp > MAX_PKT_MESSAGE_MODE) ? MAX_PKT_MESSAGE_MODE : tmp;
         status = _sock.send(tmp_pkt, to_send * PKT_SIZE, *tsp);
         if (!status) {
-            break;
+            // Send failed, typically because the connection was broken.
+            if (!_reconnect || tsp->aborting()) {
+                break;
+            }
+            tsp->warning(u"SRT connection lost, reconnecting");
+            _sock.close(*tsp);
+            SleepThread(_reconnect_delay);
+            _sock.open(_mode, _local_addr, _remote_addr, *tsp);
+            continue;  // retry the same chunk on the new connection
         }
         tmp -= to_send;
         tmp_pkt += to_send;
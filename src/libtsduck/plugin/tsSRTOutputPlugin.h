@@ -59,10 +59,12 @@ namespace ts {
         virtual bool send(const TSPacket*, const TSPacketMetadata*, size_t) override;
 
     private:
-        SocketAddress _local_addr;  // Local address.
-        SocketAddress _remote_addr; // Remote address.
-        PacketCounter _pkt_count;   // Total packet counter for output packets
+        SocketAddress _local_addr;       // Local address.
+        SocketAddress _remote_addr;      // Remote address.
+        PacketCounter _pkt_count;        // Total packet counter for output packets
         SRTSocket     _sock;
         SRTSocketMode _mode;
+        bool          _reconnect;        // Option --reconnect: reopen the connection when it is broken.
+        MilliSecond   _reconnect_delay;  // Delay between two reconnection attempts.
     };
 }
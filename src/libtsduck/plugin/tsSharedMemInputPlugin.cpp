@@ -0,0 +1,121 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedMemInputPlugin.h"
+#include "tsSysUtils.h"
+TSDUCK_SOURCE;
+
+#define DEFAULT_OPEN_TIMEOUT 5000  // Default timeout waiting for the segment, in milliseconds.
+#define POLL_INTERVAL           1  // Polling interval on an empty ring, in milliseconds.
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+ts::SharedMemInputPlugin::SharedMemInputPlugin(TSP* tsp_) :
+    InputPlugin(tsp_, u"Receive TS packets from another process through shared memory", u"[options] name"),
+    _name(),
+    _open_timeout(0),
+    _ring()
+{
+    option(u"", 0, STRING, 1, 1);
+    help(u"",
+         u"Name of the shared memory segment. The sending process must use the "
+         u"shm output plugin with the same name.");
+
+    option(u"timeout", 't', POSITIVE);
+    help(u"timeout", u"milliseconds",
+         u"Maximum time to wait for the creation of the shared memory segment by "
+         u"the sending process, in milliseconds. "
+         u"The default is " TS_STRINGIFY(DEFAULT_OPEN_TIMEOUT) u" ms.");
+}
+
+
+//----------------------------------------------------------------------------
+// Command line options method
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemInputPlugin::getOptions()
+{
+    _name = value(u"");
+    _open_timeout = intValue<MilliSecond>(u"timeout", DEFAULT_OPEN_TIMEOUT);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Start method
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemInputPlugin::start()
+{
+    // Wait for the creation of the segment by the sending process.
+    MilliSecond remain = _open_timeout;
+    while (!_ring.open(_name, *tsp)) {
+        if (remain <= 0 || tsp->aborting()) {
+            tsp->error(u"shared memory segment %s not found", {_name});
+            return false;
+        }
+        SleepThread(std::min<MilliSecond>(remain, 100));
+        remain -= 100;
+    }
+    tsp->verbose(u"connected to shared memory ring %s, %'d packets", {_name, _ring.ringSize()});
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Stop method
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemInputPlugin::stop()
+{
+    return _ring.close(*tsp);
+}
+
+
+//----------------------------------------------------------------------------
+// Input method
+//----------------------------------------------------------------------------
+
+size_t ts::SharedMemInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+{
+    // Poll the ring until packets are available or the producer terminates.
+    for (;;) {
+        const size_t count = _ring.readPackets(buffer, max_packets);
+        if (count > 0) {
+            return count;
+        }
+        if (_ring.endOfStream() || tsp->aborting()) {
+            return 0;
+        }
+        SleepThread(POLL_INTERVAL);
+    }
+}
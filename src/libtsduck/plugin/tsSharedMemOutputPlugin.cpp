@@ -0,0 +1,132 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedMemOutputPlugin.h"
+#include "tsSysUtils.h"
+TSDUCK_SOURCE;
+
+#define DEFAULT_RING_PACKETS 2048  // Default size of the ring in packets.
+#define POLL_INTERVAL           1  // Polling interval on a full ring, in milliseconds.
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+ts::SharedMemOutputPlugin::SharedMemOutputPlugin(TSP* tsp_) :
+    OutputPlugin(tsp_, u"Send TS packets to another process through shared memory", u"[options] name"),
+    _name(),
+    _ring_packets(0),
+    _drop_on_full(false),
+    _dropped(0),
+    _ring()
+{
+    option(u"", 0, STRING, 1, 1);
+    help(u"",
+         u"Name of the shared memory segment. The receiving process must use the "
+         u"shm input plugin with the same name.");
+
+    option(u"packets", 'p', POSITIVE);
+    help(u"packets",
+         u"Size of the shared memory ring in TS packets. "
+         u"The default is " TS_STRINGIFY(DEFAULT_RING_PACKETS) u" packets.");
+
+    option(u"drop");
+    help(u"drop",
+         u"Drop packets when the ring is full, typically when the receiving "
+         u"process is too slow or not yet started. By default, wait until "
+         u"space is available in the ring, applying back-pressure on the "
+         u"stream.");
+}
+
+
+//----------------------------------------------------------------------------
+// Command line options method
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemOutputPlugin::getOptions()
+{
+    _name = value(u"");
+    _ring_packets = intValue<size_t>(u"packets", DEFAULT_RING_PACKETS);
+    _drop_on_full = present(u"drop");
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Start method
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemOutputPlugin::start()
+{
+    _dropped = 0;
+    return _ring.create(_name, _ring_packets, *tsp);
+}
+
+
+//----------------------------------------------------------------------------
+// Stop method
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemOutputPlugin::stop()
+{
+    // Signal the end of stream and give the receiving process a chance to
+    // drain the ring before the segment is removed.
+    _ring.setEndOfStream();
+    if (_dropped > 0) {
+        tsp->warning(u"dropped %'d packets on full shared memory ring", {_dropped});
+    }
+    return _ring.close(*tsp);
+}
+
+
+//----------------------------------------------------------------------------
+// Output method
+//----------------------------------------------------------------------------
+
+bool ts::SharedMemOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count)
+{
+    while (packet_count > 0) {
+        const size_t count = _ring.writePackets(buffer, packet_count);
+        buffer += count;
+        packet_count -= count;
+        if (packet_count > 0) {
+            // The ring is full.
+            if (_drop_on_full) {
+                _dropped += packet_count;
+                break;
+            }
+            if (tsp->aborting()) {
+                return false;
+            }
+            SleepThread(POLL_INTERVAL);
+        }
+    }
+    return true;
+}
@@ -38,6 +38,7 @@ const ts::Enumeration ts::TSPControlCommand::ControlCommandEnum({
     {u"suspend", ts::TSPControlCommand::ControlCommand::CMD_SUSPEND},
     {u"resume",  ts::TSPControlCommand::ControlCommand::CMD_RESUME},
     {u"restart", ts::TSPControlCommand::ControlCommand::CMD_RESTART},
+    {u"metrics", ts::TSPControlCommand::ControlCommand::CMD_METRICS},
 });
 
 
@@ -79,6 +80,14 @@ ts::TSPControlCommand::TSPControlCommand() :
     arg->option(u"", 0, Args::UNSIGNED);
     arg->help(u"", u"Index of the plugin to resume.");
 
+    arg = newCommand(CMD_METRICS, u"Report performance metrics on plugin execution", u"[options]");
+    arg->setIntro(u"Report, for each plugin, the number of processed packets, the current "
+                  u"queue depth, the cumulated time waiting for packets and the cumulated "
+                  u"packet processing time. Use these counters to locate the bottleneck "
+                  u"stage of a processing chain.");
+    arg->option(u"json", 'j');
+    arg->help(u"json", u"Report the metrics as one JSON object instead of text lines.");
+
     arg = newCommand(CMD_RESTART, u"Restart plugin with different parameters", u"[options] plugin-index [plugin-options ...]", Args::GATHER_PARAMETERS);
     arg->option(u"", 0, Args::STRING, 1, Args::UNLIMITED_COUNT);
     arg->help(u"",
@@ -87,6 +96,13 @@ ts::TSPControlCommand::TSPControlCommand() :
     arg->help(u"same",
               u"Restart the plugin with the same options and parameters. "
               u"By default, when no plugin options are specified, restart with no option at all.");
+    arg->option(u"shadow");
+    arg->help(u"shadow",
+              u"Prepare and start the new plugin instance concurrently, while the "
+              u"current instance keeps processing packets, then swap the two "
+              u"instances at a packet boundary. The stream is not interrupted "
+              u"during the restart. The plugin must support two concurrent "
+              u"instances: do not use on plugins which access an exclusive device.");
 }
 
 
@@ -63,6 +63,7 @@ namespace ts {
             CMD_SUSPEND,  //!< Suspend a plugin.
             CMD_RESUME,   //!< Resume a suspended plugin.
             CMD_RESTART,  //!< Restart a plugin with different parameters.
+            CMD_METRICS,  //!< Report performance metrics on plugin execution.
         };
 
         //!
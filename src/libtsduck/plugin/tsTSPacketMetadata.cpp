@@ -39,11 +39,9 @@ const ts::TSPacketMetadata::LabelSet ts::TSPacketMetadata::AllLabels(~NoLabel);
 //----------------------------------------------------------------------------
 
 ts::TSPacketMetadata::TSPacketMetadata() :
-    _labels(),
-    _flush(false),
-    _bitrate_changed(false),
-    _input_stuffing(false),
-    _nullified(false)
+    _input_time(-1),
+    _labels(0),
+    _flags(0)
 {
 }
 
@@ -54,11 +52,9 @@ ts::TSPacketMetadata::TSPacketMetadata() :
 
 void ts::TSPacketMetadata::reset()
 {
-    _labels.reset();
-    _flush = false;
-    _bitrate_changed = false;
-    _input_stuffing = false;
-    _nullified = false;
+    _input_time = -1;
+    _labels = 0;
+    _flags = 0;
 }
 
 
@@ -68,25 +64,26 @@ void ts::TSPacketMetadata::reset()
 
 bool ts::TSPacketMetadata::hasLabel(size_t label) const
 {
-    return label < _labels.size() && _labels.test(label);
+    return label < LABEL_COUNT && (_labels & (uint32_t(1) << label)) != 0;
 }
 
 bool ts::TSPacketMetadata::hasAnyLabel(const LabelSet& mask) const
 {
-    return (_labels & mask).any();
+    return (_labels & uint32_t(mask.to_ulong())) != 0;
 }
 
 bool ts::TSPacketMetadata::hasAllLabels(const LabelSet& mask) const
 {
-    return (_labels & mask) == mask;
+    const uint32_t m = uint32_t(mask.to_ulong());
+    return (_labels & m) == m;
 }
 
 void ts::TSPacketMetadata::setLabels(const LabelSet& mask)
 {
-    _labels |= mask;
+    _labels |= uint32_t(mask.to_ulong());
 }
 
 void ts::TSPacketMetadata::clearLabels(const LabelSet& mask)
 {
-    _labels &= ~mask;
+    _labels &= ~uint32_t(mask.to_ulong());
 }
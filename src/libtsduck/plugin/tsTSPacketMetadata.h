@@ -89,25 +89,25 @@ namespace ts {
         //! Specify if the packet was artificially inserted as input stuffing.
         //! @param [in] on When true, the packet was artificially inserted as input stuffing.
         //!
-        void setInputStuffing(bool on) { _input_stuffing = on; }
+        void setInputStuffing(bool on) { setFlag(FLAG_INPUT_STUFFING, on); }
 
         //!
         //! Check if the packet was artificially inserted as input stuffing.
         //! @return True when the packet was artificially inserted as input stuffing.
         //!
-        bool getInputStuffing() const { return _input_stuffing; }
+        bool getInputStuffing() const { return (_flags & FLAG_INPUT_STUFFING) != 0; }
 
         //!
         //! Specify if the packet was explicitly turned into a null packet by a plugin.
         //! @param [in] on When true, the packet was explicitly turned into a null packet by a plugin.
         //!
-        void setNullified(bool on) { _nullified = on; }
+        void setNullified(bool on) { setFlag(FLAG_NULLIFIED, on); }
 
         //!
         //! Check if the packet was explicitly turned into a null packet by a plugin.
         //! @return True when the packet was explicitly turned into a null packet by a plugin.
         //!
-        bool getNullified() const { return _nullified; }
+        bool getNullified() const { return (_flags & FLAG_NULLIFIED) != 0; }
 
         //!
         //! Specify if the packet chain shall be flushed by tsp as soon as possible.
@@ -115,14 +115,14 @@ namespace ts {
         //! @param [in] on When set to true by a packet processing plugin, the packet and all previously
         //! processed and buffered packets should be passed to the next processor as soon as possible.
         //!
-        void setFlush(bool on) { _flush = on; }
+        void setFlush(bool on) { setFlag(FLAG_FLUSH, on); }
 
         //!
         //! Check if the packet chain shall be flushed by tsp as soon as possible.
         //! @return True when the packet and all previously processed and buffered packets should be
         //! passed to the next processor as soon as possible
         //!
-        bool getFlush() const { return _flush; }
+        bool getFlush() const { return (_flags & FLAG_FLUSH) != 0; }
 
         //!
         //! Specify if the plugin has changed the transport stream bitrate.
@@ -130,13 +130,41 @@ namespace ts {
         //! @param [in] on When set to true by a packet processing plugin, tsp should call its
         //! getBitrate() callback as soon as possible.
         //!
-        void setBitrateChanged(bool on) { _bitrate_changed = on; }
+        void setBitrateChanged(bool on) { setFlag(FLAG_BITRATE_CHANGED, on); }
 
         //!
         //! Check if the plugin has changed the transport stream bitrate.
         //! @return True when tsp should call the getBitrate() callback of the plugin as soon as possible.
         //!
-        bool getBitrateChanged() const { return _bitrate_changed; }
+        bool getBitrateChanged() const { return (_flags & FLAG_BITRATE_CHANGED) != 0; }
+
+        //!
+        //! Set the input time stamp of the TS packet.
+        //! The input time stamp is set by the input plugin, when the capture
+        //! time of the packet is known with a better precision than the
+        //! wall-clock time of the input thread (typically the kernel or NIC
+        //! hardware reception time of the datagram carrying the packet).
+        //! @param [in] time Input time stamp in microseconds since the Unix epoch.
+        //!
+        void setInputTimeStamp(MicroSecond time) { _input_time = time; }
+
+        //!
+        //! Get the input time stamp of the TS packet.
+        //! @return The input time stamp in microseconds since the Unix epoch
+        //! or -1 when there is no input time stamp.
+        //!
+        MicroSecond getInputTimeStamp() const { return _input_time; }
+
+        //!
+        //! Check if the TS packet has an input time stamp.
+        //! @return True when the TS packet has an input time stamp.
+        //!
+        bool hasInputTimeStamp() const { return _input_time >= 0; }
+
+        //!
+        //! Clear the input time stamp of the TS packet.
+        //!
+        void clearInputTimeStamp() { _input_time = -1; }
 
         //!
         //! Check if the TS packet has a specific label set.
@@ -149,7 +177,7 @@ namespace ts {
         //! Check if the TS packet has any label set.
         //! @return True if the TS packet has any label.
         //!
-        bool hasAnyLabel() const { return _labels.any(); }
+        bool hasAnyLabel() const { return _labels != 0; }
 
         //!
         //! Check if the TS packet has any label set from a set of labels.
@@ -169,7 +197,7 @@ namespace ts {
         //! Set a specific label for the TS packet.
         //! @param [in] label The label to set.
         //!
-        void setLabel(size_t label) { _labels.set(label); }
+        void setLabel(size_t label) { if (label < LABEL_COUNT) { _labels |= uint32_t(1) << label; } }
 
         //!
         //! Set a specific set of labels for the TS packet.
@@ -181,7 +209,7 @@ namespace ts {
         //! Clear a specific label for the TS packet.
         //! @param [in] label The label to clear.
         //!
-        void clearLabel(size_t label) { _labels.reset(label); }
+        void clearLabel(size_t label) { if (label < LABEL_COUNT) { _labels &= ~(uint32_t(1) << label); } }
 
         //!
         //! Clear a specific set of labels for the TS packet.
@@ -192,14 +220,32 @@ namespace ts {
         //!
         //! Clear all labels for the TS packet.
         //!
-        void clearAllLabels() { _labels.reset(); }
+        void clearAllLabels() { _labels = 0; }
 
     private:
-        LabelSet _labels;           // Bit mask of labels.
-        bool     _flush;            // Flush the packet buffer asap.
-        bool     _bitrate_changed;  // Call getBitrate() callback as soon as possible.
-        bool     _input_stuffing;   // Packet was artificially inserted as input stuffing.
-        bool     _nullified;        // Packet was explicitly turned into a null packet by a plugin.
+        // The labels and the boolean flags are bit-packed so that the whole
+        // metadata of a packet is a few bytes instead of a full object with
+        // one word per flag. Plugins which scan one flag or label over large
+        // packet windows drag much less data through the caches this way.
+        MicroSecond _input_time;  // Input time stamp, -1 when unset.
+        uint32_t    _labels;      // Bit mask of labels.
+        uint8_t     _flags;       // Bit mask of FLAG_* values.
+
+        static constexpr uint8_t FLAG_FLUSH = 0x01;            // Flush the packet buffer asap.
+        static constexpr uint8_t FLAG_BITRATE_CHANGED = 0x02;  // Call getBitrate() callback asap.
+        static constexpr uint8_t FLAG_INPUT_STUFFING = 0x04;   // Artificially inserted as input stuffing.
+        static constexpr uint8_t FLAG_NULLIFIED = 0x08;        // Explicitly turned into a null packet.
+
+        // Set or clear a set of flags.
+        void setFlag(uint8_t mask, bool on)
+        {
+            if (on) {
+                _flags |= mask;
+            }
+            else {
+                _flags &= ~mask;
+            }
+        }
     };
 
     //!
@@ -36,6 +36,10 @@
 #include "tsGuard.h"
 TSDUCK_SOURCE;
 
+#if defined(TS_LINUX)
+#include <sys/resource.h>
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructor and destructor.
@@ -51,7 +55,7 @@ ts::TSProcessor::TSProcessor(Report& report) :
     _monitor(nullptr),
     _control(nullptr),
     _packet_buffer(nullptr),
-    _metadata_buffer(nullptr)
+    _metadata_base(nullptr)
 {
 }
 
@@ -62,12 +66,41 @@ ts::TSProcessor::~TSProcessor()
 }
 
 
+//----------------------------------------------------------------------------
+// Implementation of SystemMonitor::MetricsProvider.
+//----------------------------------------------------------------------------
+
+void ts::TSProcessor::getMetrics(std::vector<int64_t>& values)
+{
+    // Three counters per plugin executor, in chain order. The ring of
+    // executors is fixed once the processing is started and the monitor
+    // thread is terminated before the executors are deallocated, the
+    // iteration is safe without the global mutex.
+    tsp::PluginExecutor* proc = _input;
+    if (proc != nullptr) {
+        do {
+            values.push_back(int64_t(proc->metricsQueueDepth()));
+            values.push_back(proc->metricsWaitTime());
+            values.push_back(proc->metricsProcessingTime());
+        } while ((proc = proc->ringNext<tsp::PluginExecutor>()) != _input);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Deallocate and cleanup internal resources.
 //----------------------------------------------------------------------------
 
 void ts::TSProcessor::cleanupInternal()
 {
+    // Terminate the monitor thread first: it samples the plugin executors
+    // for the exported metrics and they are deallocated below.
+    if (_monitor != nullptr) {
+        // Deleting the object terminates the monitor thread.
+        delete _monitor;
+        _monitor = nullptr;
+    }
+
     // Abort and wait for threads to terminate
     tsp::PluginExecutor* proc = _input;
     do {
@@ -90,19 +123,10 @@ void ts::TSProcessor::cleanupInternal()
     _output = nullptr;
 
     if (_packet_buffer != nullptr) {
+        // The metadata array lives in the extra area of the packet buffer.
         delete _packet_buffer;
         _packet_buffer = nullptr;
-    }
-
-    if (_metadata_buffer != nullptr) {
-        delete _metadata_buffer;
-        _metadata_buffer = nullptr;
-    }
-
-    if (_monitor != nullptr) {
-        // Deleting the object terminates the monitor thread.
-        delete _monitor;
-        _monitor = nullptr;
+        _metadata_base = nullptr;
     }
 
     if (_control != nullptr) {
@@ -135,6 +159,16 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         // Check or adjust a few parameters.
         _args.ts_buffer_size = std::max(_args.ts_buffer_size, TSProcessorArgs::MIN_BUFFER_SIZE);
 
+        // Without any packet processor plugin, tsp is a pure protocol converter:
+        // the ring of executors degenerates to the input and output threads which
+        // share the packet buffer with one single hand-off. In that topology, use
+        // the lock-free hand-off by default, the global mutex round trip per
+        // window of packets is pure overhead between two threads.
+        if (_args.plugins.empty() && !_args.lock_free) {
+            _args.lock_free = true;
+            _report.debug(u"tsp: no packet processor plugin, using direct lock-free input to output hand-off");
+        }
+
         // Clear errors on the report, used to check further initialisation errors.
         _report.resetErrors();
 
@@ -145,10 +179,48 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         // plugin has a hight priority to make room in the buffer, but not as
         // high as the input which must remain the top-most priority?
 
-        _input = new tsp::InputExecutor(_args, _args.input, ThreadAttributes().setPriority(ts::ThreadAttributes::GetMaximumPriority()), _mutex, &_report);
+        // CPU affinity of the plugin threads (--thread-affinity), in chain order:
+        // input thread first, then packet processors, then output thread.
+        ThreadAttributes input_attrs;
+        ThreadAttributes output_attrs;
+        input_attrs.setPriority(ts::ThreadAttributes::GetMaximumPriority());
+        output_attrs.setPriority(ts::ThreadAttributes::GetHighPriority());
+        if (!_args.thread_cpus.empty()) {
+            input_attrs.addCPU(_args.thread_cpus.front());
+        }
+        if (_args.thread_cpus.size() > _args.plugins.size() + 1) {
+            output_attrs.addCPU(_args.thread_cpus[_args.plugins.size() + 1]);
+        }
+
+        // Real-time scheduling of the input and output threads (--rt-scheduling).
+        // The input thread runs one priority level above the output thread, the
+        // same ordering as the time-sharing priorities above. The priorities are
+        // clamped and gracefully degraded by ts::Thread when the operating
+        // system denies the real-time policy.
+        if (_args.rt_sched) {
+            const int rt_prio = std::max(1, _args.rt_priority);
+            input_attrs.setRealTime().setRealTimePriority(rt_prio + 1);
+            output_attrs.setRealTime().setRealTimePriority(rt_prio);
+#if defined(TS_LINUX)
+            ::rlimit rl;
+            if (::geteuid() != 0 && ::getrlimit(RLIMIT_RTPRIO, &rl) == 0 && rl.rlim_cur == 0) {
+                _report.verbose(u"tsp: no real-time privilege (RLIMIT_RTPRIO is 0), using standard scheduling policy");
+            }
+#endif
+#if defined(TS_UNIX)
+            // Lock all process memory into RAM. Page faults in the real-time
+            // path would otherwise defeat the real-time priorities.
+            if (::mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+                const ts::ErrorCode err = ts::LastErrorCode();
+                _report.verbose(u"tsp: cannot lock process memory (%d: %s), risk of real-time issue", {err, ts::ErrorCodeMessage(err)});
+            }
+#endif
+        }
+
+        _input = new tsp::InputExecutor(_args, _args.input, input_attrs, _mutex, &_report);
         CheckNonNull(_input);
 
-        _output = new tsp::OutputExecutor(_args, _args.output, ThreadAttributes().setPriority(ts::ThreadAttributes::GetHighPriority()), _mutex, &_report);
+        _output = new tsp::OutputExecutor(_args, _args.output, output_attrs, _mutex, &_report);
         CheckNonNull(_output);
 
         _output->ringInsertAfter(_input);
@@ -156,8 +228,13 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         // Check if at least one plugin prefers real-time defaults.
         bool realtime = _args.realtime == ts::TRUE || _input->isRealTime() || _output->isRealTime();
 
+        size_t plugin_index = 0;
         for (auto it = _args.plugins.begin(); it != _args.plugins.end(); ++it) {
-            tsp::PluginExecutor* p = new tsp::ProcessorExecutor(_args, *it, ThreadAttributes(), _mutex, &_report);
+            ThreadAttributes attrs;
+            if (++plugin_index < _args.thread_cpus.size()) {
+                attrs.addCPU(_args.thread_cpus[plugin_index]);
+            }
+            tsp::PluginExecutor* p = new tsp::ProcessorExecutor(_args, *it, attrs, _mutex, &_report);
             CheckNonNull(p);
             p->ringInsertBefore(_output);
             realtime = realtime || p->isRealTime();
@@ -190,8 +267,36 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
             }
         } while ((proc = proc->ringNext<ts::tsp::PluginExecutor>()) != _input);
 
-        // Allocate a memory-resident buffer of TS packets
-        _packet_buffer = new PacketBuffer(_args.ts_buffer_size / ts::PKT_SIZE);
+        // Allocate a memory-resident buffer of TS packets.
+#if defined(TS_LINUX)
+        // On NUMA systems, when the input thread is pinned on a CPU, temporarily
+        // move the current thread on the same CPU during the allocation. The
+        // buffer pages are faulted in and locked here and the first-touch policy
+        // places them on the memory node of the input thread.
+        ::cpu_set_t saved_cpus;
+        CPU_ZERO(&saved_cpus);
+        const bool place_buffer = !_args.thread_cpus.empty() && ::sched_getaffinity(0, sizeof(saved_cpus), &saved_cpus) == 0;
+        if (place_buffer) {
+            ::cpu_set_t input_cpu;
+            CPU_ZERO(&input_cpu);
+            CPU_SET(int(_args.thread_cpus.front()), &input_cpu);
+            ::sched_setaffinity(0, sizeof(input_cpu), &input_cpu);
+        }
+#endif
+        // The packet metadata array is allocated in the same resident region,
+        // right after the packets: one allocation, one locked area, and the
+        // metadata get the same huge-page backing and NUMA placement as the
+        // packets instead of a separate remote allocation.
+        const size_t buffer_pkt_count = _args.ts_buffer_size / ts::PKT_SIZE;
+        _packet_buffer = new PacketBuffer(buffer_pkt_count, _args.huge_pages, buffer_pkt_count * sizeof(TSPacketMetadata));
+#if defined(TS_LINUX)
+        if (place_buffer) {
+            ::sched_setaffinity(0, sizeof(saved_cpus), &saved_cpus);
+        }
+#endif
+        if (_args.huge_pages && !_packet_buffer->isHugePageBacked()) {
+            _report.verbose(u"tsp: buffer could not be allocated from explicit huge pages, using normal pages");
+        }
         CheckNonNull(_packet_buffer);
         if (!_packet_buffer->isLocked()) {
             _report.verbose(u"tsp: buffer failed to lock into physical memory (%d: %s), risk of real-time issue",
@@ -199,10 +304,10 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         }
         _report.debug(u"tsp: buffer size: %'d TS packets, %'d bytes", {_packet_buffer->count(), _packet_buffer->count() * ts::PKT_SIZE});
 
-        // Buffer for the packet metadata.
-        // A packet and its metadata have the same index in their respective buffer.
-        _metadata_buffer = new PacketMetadataBuffer(_packet_buffer->count());
-        CheckNonNull(_metadata_buffer);
+        // Construct the packet metadata in the extra area of the packet buffer.
+        // A packet and its metadata have the same index.
+        _metadata_base = new (_packet_buffer->extraBase()) TSPacketMetadata[_packet_buffer->count()];
+        CheckNonNull(_metadata_base);
 
         // Start all processors, except output, in reverse order (input last).
         // Exit application in case of error.
@@ -215,7 +320,7 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
 
         // Initialize packet buffer in the ring of executors.
         // Exit application in case of error.
-        if (!_input->initAllBuffers(_packet_buffer, _metadata_buffer)) {
+        if (!_input->initAllBuffers(_packet_buffer, _metadata_base)) {
             cleanupInternal();
             return false;
         }
@@ -227,10 +332,16 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
             return false;
         }
 
-        // Create a monitoring thread if required.
+        // Create a monitoring thread if required. The monitor also exports
+        // binary metrics samples when --metrics-export is used, with the
+        // textual resource log only when --monitor is also present.
         _monitor = new SystemMonitor(&_report);
         CheckNonNull(_monitor);
-        if (_args.monitor) {
+        if (!_args.metrics_export.empty()) {
+            _monitor->setMetricsExport(_args.metrics_export, this);
+            _monitor->setResourceLogging(_args.monitor);
+        }
+        if (_args.monitor || !_args.metrics_export.empty()) {
             _monitor->start();
         }
 
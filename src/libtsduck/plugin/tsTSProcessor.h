@@ -55,7 +55,7 @@ namespace ts {
     //! It can also be used in other applications to run a chain of plugins.
     //! @ingroup plugin
     //!
-    class TSDUCKDLL TSProcessor
+    class TSDUCKDLL TSProcessor: private SystemMonitor::MetricsProvider
     {
         TS_NOBUILD_NOCOPY(TSProcessor);
     public:
@@ -112,7 +112,11 @@ namespace ts {
         SystemMonitor*        _monitor;          // System monitor thread.
         tsp::ControlServer*   _control;          // TSP control command server thread.
         PacketBuffer*         _packet_buffer;    // Global TS packet buffer.
-        PacketMetadataBuffer* _metadata_buffer;  // Global packet metabata buffer.
+        TSPacketMetadata*     _metadata_base;    // Global packet metadata array, in the extra area of _packet_buffer.
+
+        // Implementation of SystemMonitor::MetricsProvider: the counters of
+        // all plugin executors, three per plugin, in chain order.
+        virtual void getMetrics(std::vector<int64_t>& values) override;
 
         // Deallocate and cleanup internal resources.
         void cleanupInternal();
@@ -53,9 +53,17 @@ constexpr size_t ts::TSProcessorArgs::MIN_BUFFER_SIZE;
 ts::TSProcessorArgs::TSProcessorArgs() :
     app_name(),
     monitor(false),
+    metrics_export(),
     ignore_jt(false),
+    lock_free(false),
+    rt_sched(false),
+    rt_priority(0),
+    thread_cpus(),
     ts_buffer_size(DEFAULT_BUFFER_SIZE),
+    huge_pages(false),
     max_flush_pkt(0),
+    flush_latency(0),
+    shard_threads(0),
     max_input_pkt(0),
     instuff_nullpkt(0),
     instuff_inpkt(0),
@@ -152,6 +160,26 @@ void ts::TSProcessorArgs::defineArgs(Args& args) const
               u"Specify the reception timeout in milliseconds for control commands. "
               u"The default timeout is " TS_STRINGIFY(DEF_CONTROL_TIMEOUT) u" ms.");
 
+    args.option(u"huge-pages");
+    args.help(u"huge-pages",
+              u"Allocate the global TS packet buffer from explicit huge pages "
+              u"(Linux only). With very large buffers, huge pages significantly "
+              u"reduce the TLB miss rate. Huge pages must have been reserved by "
+              u"the system administrator (see /proc/sys/vm/nr_hugepages). When "
+              u"no huge page can be allocated, silently fall back to transparent "
+              u"huge pages and then to normal pages.");
+
+    args.option(u"flush-latency", 0, Args::POSITIVE);
+    args.help(u"flush-latency", u"milliseconds",
+              u"Enable adaptive flush batching with the specified latency budget in "
+              u"milliseconds. Each plugin starts from the --max-flushed-packets batch "
+              u"size, halves it when the delay between two flushes exceeds the budget "
+              u"and doubles it again, up to --max-flushed-packets, when the next "
+              u"plugin keeps up. This provides low latency on lightly loaded streams "
+              u"and full batching throughput under load, without selecting a fixed "
+              u"trade-off at startup. By default, the batch size is the fixed "
+              u"--max-flushed-packets value.");
+
     args.option(u"ignore-joint-termination", 'i');
     args.help(u"ignore-joint-termination",
               u"Ignore all --joint-termination options in plugins. "
@@ -165,6 +193,30 @@ void ts::TSProcessorArgs::defineArgs(Args& args) const
               u"--ignore-joint-termination disables the termination of tsp when all "
               u"plugins have reached their joint termination condition.");
 
+    args.option(u"lock-free");
+    args.help(u"lock-free",
+              u"Use a lock-free hand-off of packets between plugin threads. "
+              u"Each pair of adjacent plugins communicates through single-producer "
+              u"single-consumer atomic indexes on the packet buffer instead of the "
+              u"global mutex. This reduces contention in long plugin chains at very "
+              u"high bitrates, at the expense of some CPU when plugins are idle. "
+              u"This is the default when there is no packet processor plugin "
+              u"(pure input to output conversion).");
+
+    args.option(u"rt-scheduling", 0, Args::POSITIVE, 0, 1, 0, 0, true);
+    args.help(u"rt-scheduling", u"priority",
+              u"Run the input and output plugin threads under the real-time FIFO "
+              u"scheduling policy and lock the process memory into RAM (UNIX only). "
+              u"This eliminates scheduler-induced gaps in real-time playout chains, "
+              u"at the expense of CPU fairness with other processes. The optional "
+              u"value is the real-time priority of the output thread; the input "
+              u"thread runs one level above it. By default, the lowest real-time "
+              u"priority is used, which is already above all time-sharing processes. "
+              u"Real-time scheduling usually requires privileges (root or a non-zero "
+              u"RLIMIT_RTPRIO limit on Linux); without them, the threads fall back "
+              u"to the standard scheduling policy. Not to be confused with --realtime "
+              u"which only selects default values for other options.");
+
     args.option(u"receive-timeout", 0, Args::POSITIVE);
     args.help(u"receive-timeout", u"milliseconds",
               u"Specify a timeout in milliseconds for all input operations. "
@@ -186,6 +238,39 @@ void ts::TSProcessorArgs::defineArgs(Args& args) const
               u"as it can, depending on the free space in the buffer. In real-time mode, "
               u"the default is " + UString::Decimal(DEF_MAX_INPUT_PKT_RT) + u" packets.");
 
+    args.option(u"shard-threads", 0, Args::POSITIVE);
+    args.help(u"shard-threads",
+              u"Specify a number of worker threads for packet processor plugins "
+              u"which declare themselves stateless. The packets of a processing "
+              u"window are distributed by PID among the worker threads and rejoined "
+              u"in stream order afterwards. Plugins which do not declare themselves "
+              u"stateless are not affected. By default, each plugin executes on a "
+              u"single thread.");
+
+    args.option(u"thread-affinity", 0, Args::STRING);
+    args.help(u"thread-affinity", u"cpu[,cpu...]",
+              u"Specify the CPU's on which the plugin threads execute. The CPU indexes "
+              u"are assigned to the plugin threads in chain order: the first index is "
+              u"for the input plugin thread, the following ones for the packet "
+              u"processor threads and the last one for the output plugin thread. "
+              u"When fewer CPU's than plugin threads are specified, the remaining "
+              u"threads are not pinned. On NUMA systems, the global packet buffer is "
+              u"allocated on the node of the CPU of the input thread (first touch). "
+              u"By default, threads may execute on any CPU.");
+
+    args.option(u"metrics-export", 0, Args::STRING);
+    args.help(u"metrics-export", u"filename",
+              u"Continuously export monitoring metrics to the specified file in a "
+              u"compact binary format (UNIX only). The file is memory-mapped and "
+              u"rewritten in place every second with one sample: process memory "
+              u"and CPU usage, followed by three counters per plugin in chain "
+              u"order (queued packets, cumulated wait time and cumulated "
+              u"processing time in nanoseconds). A telemetry collector maps the "
+              u"same file and reads the current sample at any time, without log "
+              u"parsing and without waking up tsp. Place the file in a memory "
+              u"file system such as /dev/shm to avoid any disk activity. "
+              u"Unlike --monitor, this option does not log any text.");
+
     args.option(u"monitor", 'm');
     args.help(u"monitor",
               u"Continuously monitor the system resources which are used by tsp. "
@@ -212,14 +297,21 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
 {
     app_name = args.appName();
     monitor = args.present(u"monitor");
+    metrics_export = args.value(u"metrics-export");
     ts_buffer_size = args.intValue<size_t>(u"buffer-size-mb", DEFAULT_BUFFER_SIZE);
+    huge_pages = args.present(u"huge-pages");
     fixed_bitrate = args.intValue<BitRate>(u"bitrate", 0);
     bitrate_adj = MilliSecPerSec * args.intValue(u"bitrate-adjust-interval", DEF_BITRATE_INTERVAL);
     max_flush_pkt = args.intValue<size_t>(u"max-flushed-packets", 0);
+    flush_latency = args.intValue<MilliSecond>(u"flush-latency", 0);
+    shard_threads = args.intValue<size_t>(u"shard-threads", 0);
     max_input_pkt = args.intValue<size_t>(u"max-input-packets", 0);
     instuff_start = args.intValue<size_t>(u"add-start-stuffing", 0);
     instuff_stop = args.intValue<size_t>(u"add-stop-stuffing", 0);
     ignore_jt = args.present(u"ignore-joint-termination");
+    lock_free = args.present(u"lock-free");
+    rt_sched = args.present(u"rt-scheduling");
+    rt_priority = args.intValue<int>(u"rt-scheduling", 0);
     realtime = args.tristateValue(u"realtime");
     receive_timeout = args.intValue<MilliSecond>(u"receive-timeout", 0);
     control_port = args.intValue<uint16_t>(u"control-port", 0);
@@ -252,6 +344,22 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
         }
     }
 
+    // Decode --thread-affinity cpu[,cpu...].
+    thread_cpus.clear();
+    if (args.present(u"thread-affinity")) {
+        UStringVector cpus;
+        args.value(u"thread-affinity").split(cpus, u',', true);
+        for (size_t i = 0; i < cpus.size(); ++i) {
+            size_t cpu = 0;
+            if (cpus[i].toInteger(cpu)) {
+                thread_cpus.push_back(cpu);
+            }
+            else {
+                args.error(u"invalid CPU index '%s' in --thread-affinity", {cpus[i]});
+            }
+        }
+    }
+
     // Decode --add-input-stuffing nullpkt/inpkt.
     instuff_nullpkt = instuff_inpkt = 0;
     if (args.present(u"add-input-stuffing") && !args.value(u"add-input-stuffing").scan(u"%d/%d", {&instuff_nullpkt, &instuff_inpkt})) {
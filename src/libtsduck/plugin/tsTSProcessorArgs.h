@@ -47,9 +47,17 @@ namespace ts {
     public:
         UString         app_name;         //!< Application name, for help messages.
         bool            monitor;          //!< Run a resource monitoring thread.
+        UString         metrics_export;   //!< When not empty, continuously export binary metrics samples to this memory-mapped file.
         bool            ignore_jt;        //!< Ignore "joint termination" options in plugins.
+        bool            lock_free;        //!< Use lock-free packet hand-off between plugin threads.
+        bool            rt_sched;         //!< Use real-time FIFO scheduling for input and output threads, lock process memory.
+        int             rt_priority;      //!< Real-time priority of the output thread (0: lowest real-time priority).
+        std::vector<size_t> thread_cpus;  //!< CPU indexes for plugin threads, in chain order (input first, output last).
         size_t          ts_buffer_size;   //!< Size in bytes of the global TS packet buffer.
+        bool            huge_pages;       //!< Allocate the global TS packet buffer from explicit huge pages.
         size_t          max_flush_pkt;    //!< Max processed packets before flush.
+        MilliSecond     flush_latency;    //!< Latency budget for adaptive flush batching (0: fixed batches).
+        size_t          shard_threads;    //!< Worker threads per stateless plugin, sharded by PID (0: disabled).
         size_t          max_input_pkt;    //!< Max packets per input operation.
         size_t          instuff_nullpkt;  //!< Add input stuffing: add @a instuff_nullpkt null packets every @a instuff_inpkt input packets.
         size_t          instuff_inpkt;    //!< Add input stuffing: add @a instuff_nullpkt null packets every @a instuff_inpkt input packets.
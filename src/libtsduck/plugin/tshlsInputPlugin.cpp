@@ -28,10 +28,11 @@
 //----------------------------------------------------------------------------
 
 #include "tshlsInputPlugin.h"
+#include "tsGuardCondition.h"
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
 
-#define DEFAULT_MAX_QUEUED_PACKETS  1000    // Default size in packet of the inter-thread queue.
+#define DEFAULT_PREFETCH_SEGMENTS  2    // Default number of media segments to download ahead of playout.
 
 
 //----------------------------------------------------------------------------
@@ -54,8 +55,18 @@ ts::hls::InputPlugin::InputPlugin(TSP* tsp_) :
     _lowestRes(false),
     _highestRes(false),
     _maxSegmentCount(0),
+    _segmentCount(0),
+    _prefetchCount(0),
+    _saveDirectory(),
     _webArgs(),
-    _playlist()
+    _playlist(),
+    _prefetcher(this),
+    _mutex(),
+    _event(),
+    _segQueue(),
+    _playOffset(0),
+    _endOfStream(false),
+    _terminate(false)
 {
     _webArgs.defineArgs(*this);
 
@@ -120,8 +131,16 @@ ts::hls::InputPlugin::InputPlugin(TSP* tsp_) :
 
     option(u"max-queue", 0, POSITIVE);
     help(u"max-queue",
-         u"Specify the maximum number of queued TS packets before their insertion into the stream. "
-         u"The default is " + UString::Decimal(DEFAULT_MAX_QUEUED_PACKETS) + u".");
+         u"Obsolete option, no longer used. The media segments are now received directly "
+         u"into the transport stream buffers, without intermediate queue. "
+         u"The option is accepted for compatibility only.");
+
+    option(u"prefetch-segments", 0, UNSIGNED);
+    help(u"prefetch-segments",
+         u"Specify the maximum number of media segments to download ahead of the playout, "
+         u"in a separate thread, to avoid stalls on segment boundaries. "
+         u"The default is " + UString::Decimal(DEFAULT_PREFETCH_SEGMENTS) + u" segments. "
+         u"Specify 0 to disable prefetching and download each segment on demand.");
 
     option(u"save-files", 0, STRING);
     help(u"save-files", u"directory-name",
@@ -179,6 +198,7 @@ bool ts::hls::InputPlugin::getOptions()
     getIntValue(_minHeight, u"min-height");
     getIntValue(_maxHeight, u"max-height");
     getIntValue(_startSegment, u"start-segment");
+    _prefetchCount = intValue<size_t>(u"prefetch-segments", DEFAULT_PREFETCH_SEGMENTS);
     _lowestRate = present(u"lowest-bitrate");
     _highestRate = present(u"highest-bitrate");
     _lowestRes = present(u"lowest-resolution");
@@ -216,10 +236,8 @@ bool ts::hls::InputPlugin::getOptions()
         return false;
     }
 
-    // Resize the inter-thread packet queue.
-    setQueueSize(intValue<size_t>(u"max-queue", DEFAULT_MAX_QUEUED_PACKETS));
-
     // Automatically save media segments and playlists.
+    _saveDirectory = saveDirectory;
     setAutoSaveDirectory(saveDirectory);
     _playlist.setAutoSaveDirectory(saveDirectory);
 
@@ -246,6 +264,8 @@ bool ts::hls::InputPlugin::setReceiveTimeout(MilliSecond timeout)
 
 bool ts::hls::InputPlugin::start()
 {
+    _segmentCount = 0;
+
     // Load the HLS playlist, can be a master playlist or a media playlist.
     _playlist.clear();
     if (!_playlist.loadURL(_url.toString(), false, _webArgs, hls::UNKNOWN_PLAYLIST, *tsp)) {
@@ -351,7 +371,22 @@ bool ts::hls::InputPlugin::start()
     }
 
     // Invoke superclass.
-    return AbstractHTTPInputPlugin::start();
+    if (!AbstractHTTPInputPlugin::start()) {
+        return false;
+    }
+
+    // Start the segment prefetch thread.
+    if (_prefetchCount > 0) {
+        _terminate = false;
+        _endOfStream = false;
+        _playOffset = 0;
+        _segQueue.clear();
+        if (!_prefetcher.start()) {
+            tsp->error(u"error starting segment prefetch thread");
+            return false;
+        }
+    }
+    return true;
 }
 
 
@@ -361,6 +396,17 @@ bool ts::hls::InputPlugin::start()
 
 bool ts::hls::InputPlugin::stop()
 {
+    // Terminate the segment prefetch thread.
+    if (_prefetchCount > 0) {
+        {
+            GuardCondition lock(_mutex, _event);
+            _terminate = true;
+            lock.signal();
+        }
+        _prefetcher.waitForTermination();
+        _segQueue.clear();
+    }
+
     // Invoke superclass.
     bool ok = AbstractHTTPInputPlugin::stop();
 
@@ -378,51 +424,202 @@ bool ts::hls::InputPlugin::stop()
 
 
 //----------------------------------------------------------------------------
-// Input method. Executed in a separate thread.
+// Open the URL of the next media segment.
 //----------------------------------------------------------------------------
 
-void ts::hls::InputPlugin::processInput()
+bool ts::hls::InputPlugin::openURL(WebRequest& request)
 {
-    // Loop on all segments in the media playlists.
-    for (size_t count = 0; _playlist.segmentCount() > 0 && (_maxSegmentCount == 0 || count < _maxSegmentCount) && !tsp->aborting() && !isInterrupted(); ++count) {
-
-        // Remove first segment from the playlist.
-        hls::MediaSegment seg;
-        _playlist.popFirstSegment(seg);
-
-        // Create a Web request to download the content.
-        WebRequest request(*tsp);
-        const UString url(_playlist.buildURL(seg.uri));
-        request.setURL(url);
-        request.setAutoRedirect(true);
-        request.setArgs(_webArgs);
-        request.enableCookies(_webArgs.cookiesFile);
-
-        // Perform the download of the current segment.
+    // If there is only one or zero remaining segment, try to reload the playlist.
+    if (_playlist.segmentCount() < 2 && _playlist.updatable() && !tsp->aborting()) {
+
         // Ignore errors, continue to play next segments.
-        tsp->debug(u"downloading segment %s", {url});
-        request.downloadToApplication(this);
-
-        // If there is only one or zero remaining segment, try to reload the playlist.
-        if (_playlist.segmentCount() < 2 && _playlist.updatable() && !tsp->aborting()) {
-
-            // Ignore errors, continue to play next segments.
-            _playlist.reload(false, _webArgs, *tsp);
-
-            // If the playout is still empty, this means that we have read all segments before the server
-            // could produce new segments. For live streams, this is possible because new segments
-            // can be produced as late as the estimated end time of the previous playlist. So, we retry
-            // at regular intervals until we get new segments.
-
-            while (_playlist.segmentCount() == 0 && Time::CurrentUTC() <= _playlist.terminationUTC() && !tsp->aborting()) {
-                // The wait between two retries is half the target duration of a segment, with a minimum of 2 seconds.
-                SleepThread(std::max<MilliSecond>(2000, (MilliSecPerSec * _playlist.targetDuration()) / 2));
-                // This time, we stop on error.
-                if (!_playlist.reload(false, _webArgs, *tsp)) {
-                    break;
+        _playlist.reload(false, _webArgs, *tsp);
+
+        // If the playout is still empty, this means that we have read all segments before the server
+        // could produce new segments. For live streams, this is possible because new segments
+        // can be produced as late as the estimated end time of the previous playlist. So, we retry
+        // at regular intervals until we get new segments.
+
+        while (_playlist.segmentCount() == 0 && Time::CurrentUTC() <= _playlist.terminationUTC() && !tsp->aborting()) {
+            // The wait between two retries is half the target duration of a segment, with a minimum of 2 seconds.
+            SleepThread(std::max<MilliSecond>(2000, (MilliSecPerSec * _playlist.targetDuration()) / 2));
+            // This time, we stop on error.
+            if (!_playlist.reload(false, _webArgs, *tsp)) {
+                break;
+            }
+        }
+    }
+
+    // Check if the end of the playout is reached.
+    if (_playlist.segmentCount() == 0 || (_maxSegmentCount > 0 && _segmentCount >= _maxSegmentCount)) {
+        tsp->verbose(u"HLS playlist completed");
+        return false;
+    }
+    _segmentCount++;
+
+    // Remove first segment from the playlist.
+    hls::MediaSegment seg;
+    _playlist.popFirstSegment(seg);
+
+    // Setup the Web request to download the segment.
+    // Errors on one segment are ignored, continue to play next segments.
+    const UString url(_playlist.buildURL(seg.uri));
+    request.setURL(url);
+    request.setAutoRedirect(true);
+    request.setArgs(_webArgs);
+    request.enableCookies(_webArgs.cookiesFile);
+    tsp->debug(u"downloading segment %s", {url});
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Internal thread which downloads media segments ahead of the playout.
+//----------------------------------------------------------------------------
+
+ts::hls::InputPlugin::Prefetcher::Prefetcher(InputPlugin* plugin) :
+    _plugin(plugin),
+    _segment()
+{
+}
+
+ts::hls::InputPlugin::Prefetcher::~Prefetcher()
+{
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked by the Web request when a chunk of segment data is available.
+//----------------------------------------------------------------------------
+
+bool ts::hls::InputPlugin::Prefetcher::handleWebData(const WebRequest& request, const void* data, size_t size)
+{
+    _segment->append(data, size);
+
+    // Interrupt the download when the plugin stops or aborts.
+    return !_plugin->_terminate && !_plugin->tsp->aborting();
+}
+
+
+//----------------------------------------------------------------------------
+// Prefetch thread main code.
+//----------------------------------------------------------------------------
+
+void ts::hls::InputPlugin::Prefetcher::main()
+{
+    _plugin->tsp->debug(u"segment prefetch thread started");
+
+    bool more = true;
+    while (more) {
+
+        // Wait for free room in the prefetch queue.
+        {
+            GuardCondition lock(_plugin->_mutex, _plugin->_event);
+            while (!_plugin->_terminate && _plugin->_segQueue.size() >= _plugin->_prefetchCount) {
+                lock.waitCondition();
+            }
+            if (_plugin->_terminate) {
+                break;
+            }
+        }
+
+        // Select the next media segment. This may reload the playlist and
+        // wait for new segments, overlapped with the current playout.
+        WebRequest request(*_plugin->tsp);
+        if (!_plugin->openURL(request)) {
+            more = false;
+        }
+        else {
+            // Download the complete segment in memory.
+            _segment = new ByteBlock;
+            if (!request.downloadToApplication(this)) {
+                // Ignore errors, continue to play next segments.
+                // A partially downloaded segment is still played out.
+                _plugin->tsp->warning(u"error downloading segment %s", {request.originalURL()});
+            }
+
+            // Automatically save the segment when required. Errors are not fatal.
+            if (!_plugin->_saveDirectory.empty() && !_segment->empty()) {
+                const UString name(_plugin->_saveDirectory + PathSeparator + BaseName(request.finalURL()));
+                _plugin->tsp->verbose(u"saving media segment to %s", {name});
+                std::ofstream out(name.toUTF8().c_str(), std::ios::out | std::ios::binary);
+                out.write(reinterpret_cast<const char*>(_segment->data()), std::streamsize(_segment->size()));
+                if (!out) {
+                    _plugin->tsp->error(u"error saving media segment %s", {name});
                 }
             }
+
+            // Queue the downloaded segment for the playout thread.
+            if (!_segment->empty()) {
+                GuardCondition lock(_plugin->_mutex, _plugin->_event);
+                _plugin->_segQueue.push_back(_segment);
+                lock.signal();
+            }
+            _segment.clear();
         }
     }
-    tsp->verbose(u"HLS playlist completed");
+
+    // Report the end of the stream to the playout thread.
+    {
+        GuardCondition lock(_plugin->_mutex, _plugin->_event);
+        _plugin->_endOfStream = true;
+        lock.signal();
+    }
+    _plugin->tsp->debug(u"segment prefetch thread completed");
+}
+
+
+//----------------------------------------------------------------------------
+// Input method
+//----------------------------------------------------------------------------
+
+size_t ts::hls::InputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+{
+    // Without prefetching, download each segment on demand, directly into
+    // the packet buffer, using the superclass.
+    if (_prefetchCount == 0) {
+        return AbstractHTTPInputPlugin::receive(buffer, pkt_data, max_packets);
+    }
+
+    // Deliver packets from the prefetched media segments.
+    uint8_t* const data = buffer->b;
+    const size_t max_bytes = max_packets * PKT_SIZE;
+    size_t bytes = 0;
+
+    GuardCondition lock(_mutex, _event);
+    for (;;) {
+
+        // Copy as many complete packets as available from the queued segments.
+        while (bytes < max_bytes && !_segQueue.empty()) {
+            const ByteBlock& seg(*_segQueue.front());
+            const size_t remain = seg.size() - _playOffset;
+            if (remain < PKT_SIZE) {
+                // End of segment, drop a possible incomplete trailing packet.
+                if (remain > 0) {
+                    tsp->debug(u"dropping %d trailing bytes in media segment", {remain});
+                }
+                _segQueue.pop_front();
+                _playOffset = 0;
+                // There is free room in the queue, wake up the prefetch thread.
+                lock.signal();
+            }
+            else {
+                const size_t chunk = std::min(max_bytes - bytes, remain - remain % PKT_SIZE);
+                ::memcpy(data + bytes, seg.data() + _playOffset, chunk);  // Flawfinder: ignore
+                bytes += chunk;
+                _playOffset += chunk;
+            }
+        }
+
+        // Return as soon as at least one packet was delivered.
+        if (bytes > 0 || _endOfStream || tsp->aborting()) {
+            break;
+        }
+
+        // Wait for the prefetch thread, with a timeout to check for abort.
+        lock.waitCondition(1000); // milliseconds
+    }
+
+    return bytes / PKT_SIZE;
 }
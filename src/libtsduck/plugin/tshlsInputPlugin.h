@@ -38,6 +38,9 @@
 #include "tsURL.h"
 #include "tsWebRequest.h"
 #include "tsWebRequestArgs.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
 
 namespace ts {
     namespace hls {
@@ -63,10 +66,31 @@ namespace ts {
             virtual bool start() override;
             virtual bool stop() override;
             virtual bool isRealTime() override;
-            virtual void processInput() override;
             virtual bool setReceiveTimeout(MilliSecond timeout) override;
+            virtual size_t receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets) override;
+
+        protected:
+            // Implementation of AbstractHTTPInputPlugin
+            virtual bool openURL(WebRequest& request) override;
 
         private:
+            // Internal thread which downloads media segments ahead of the playout.
+            class Prefetcher: public Thread, private WebRequestHandlerInterface
+            {
+                TS_NOBUILD_NOCOPY(Prefetcher);
+            public:
+                // Constructor & destructor.
+                Prefetcher(InputPlugin* plugin);
+                virtual ~Prefetcher();
+                virtual void main() override;
+            private:
+                InputPlugin*   _plugin;
+                ByteBlockPtrMT _segment;  // Media segment being downloaded.
+
+                // Implementation of WebRequestHandlerInterface.
+                virtual bool handleWebData(const WebRequest& request, const void* data, size_t size) override;
+            };
+
             URL            _url;
             BitRate        _minRate;
             BitRate        _maxRate;
@@ -81,8 +105,18 @@ namespace ts {
             bool           _lowestRes;
             bool           _highestRes;
             size_t         _maxSegmentCount;
+            size_t         _segmentCount;
+            size_t         _prefetchCount;   // Max number of segments to download ahead of playout.
+            UString        _saveDirectory;
             WebRequestArgs _webArgs;
             PlayList       _playlist;
+            Prefetcher     _prefetcher;      // Segment download thread.
+            Mutex          _mutex;           // Protect the shared fields below.
+            Condition      _event;           // Signalled when the prefetch queue or state changes.
+            std::list<ByteBlockPtrMT> _segQueue;  // Downloaded media segments, in playout order.
+            size_t         _playOffset;      // Offset of next byte to deliver in first queued segment.
+            bool           _endOfStream;     // No more segments will be queued.
+            volatile bool  _terminate;       // Ask the prefetch thread to terminate.
         };
     }
 }
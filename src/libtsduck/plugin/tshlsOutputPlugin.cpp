@@ -37,6 +37,7 @@ TSDUCK_SOURCE;
 #define DEFAULT_OUT_DURATION      10  // Default segment target duration for output streams.
 #define DEFAULT_OUT_LIVE_DURATION  5  // Default segment target duration for output live streams.
 #define DEFAULT_OUT_NUM_WIDTH      6  // Default size of number field in output segment files.
+#define DEFAULT_ASYNC_QUEUE      128  // Default maximum number of queued commands with --async-write.
 
 
 //----------------------------------------------------------------------------
@@ -67,8 +68,28 @@ ts::hls::OutputPlugin::OutputPlugin(TSP* tsp_) :
     _pcrAnalyzer(1, 4),  // Minimum required: 1 PID, 4 PCR
     _previousBitrate(0),
     _ccFixer(NoPID, tsp),
-    _close_labels()
+    _close_labels(),
+    _asyncWrite(false),
+    _asyncQueueSize(DEFAULT_ASYNC_QUEUE),
+    _segName(),
+    _segPackets(0),
+    _writeError(false),
+    _stalled(false),
+    _pendingData(),
+    _queue()
 {
+    option(u"async-write", 0, POSITIVE, 0, 1, 0, 0, true);
+    help(u"async-write", u"queue-size",
+         u"Write the media segments and the playlist from a separate thread. "
+         u"The output packets are passed to a writer thread through a bounded queue "
+         u"so that a slow file system (a NFS-backed packager for instance) no longer "
+         u"stalls the transport stream processing at each segment boundary. "
+         u"The playlist is updated by writing a temporary file which is then atomically "
+         u"renamed, clients never observe a partially written playlist. "
+         u"The optional value is the maximum number of buffered write operations "
+         u"(default: " TS_STRINGIFY(DEFAULT_ASYNC_QUEUE) u"). "
+         u"When the queue is full, the output thread waits and the back-pressure is reported.");
+
     option(u"", 0, STRING, 1, 1);
     help(u"",
          u"Specify the name template of the output media segment files. "
@@ -148,6 +169,8 @@ bool ts::hls::OutputPlugin::getOptions()
     _fixedSegmentSize = intValue<PacketCounter>(u"fixed-segment-size") / PKT_SIZE;
     _initialMediaSeq = intValue<size_t>(u"start-media-sequence", 0);
     getIntValues(_close_labels, u"label-close");
+    _asyncWrite = present(u"async-write");
+    _asyncQueueSize = intValue<size_t>(u"async-write", DEFAULT_ASYNC_QUEUE);
 
     if (_fixedSegmentSize > 0 && _close_labels.any()) {
         tsp->error(u"options --fixed-segment-size and --label-close are incompatible");
@@ -205,6 +228,11 @@ bool ts::hls::OutputPlugin::start()
     // Initialize the segment and playlist files.
     _liveSegmentFiles.clear();
     _segClosePending = false;
+    _segName.clear();
+    _segPackets = 0;
+    _pendingData.clear();
+    _writeError = false;
+    _stalled = false;
     if (_segmentFile.isOpen()) {
         _segmentFile.close(*tsp);
     }
@@ -215,6 +243,16 @@ bool ts::hls::OutputPlugin::start()
         _playlist.setMediaSequence(_initialMediaSeq, *tsp);
     }
 
+    // Start the asynchronous writer thread. The segment file is then
+    // exclusively accessed from that thread.
+    if (_asyncWrite) {
+        _queue.setMaxMessages(_asyncQueueSize);
+        if (!Thread::start()) {
+            tsp->error(u"cannot start the segment writer thread");
+            return false;
+        }
+    }
+
     // Create the first segment file.
     return createNextSegment();
 }
@@ -226,8 +264,18 @@ bool ts::hls::OutputPlugin::start()
 
 bool ts::hls::OutputPlugin::stop()
 {
-    // Simply close the current segmetn (and generate the corresponding playlist).
-    return closeCurrentSegment(true);
+    // Close the current segment (and generate the corresponding playlist).
+    bool ok = closeCurrentSegment(true);
+
+    // Terminate the writer thread. The termination command is forced into the
+    // queue, regardless of its size, so that the thread always terminates.
+    if (_asyncWrite) {
+        WriterQueue::MessagePtr msg(new WriterCommand(WriterCommand::TERMINATE));
+        _queue.forceEnqueue(msg);
+        waitForTermination();
+        ok = ok && !_writeError;
+    }
+    return ok;
 }
 
 
@@ -245,11 +293,20 @@ bool ts::hls::OutputPlugin::createNextSegment()
     // Generate a new segment file name.
     const UString fileName(UString::Format(u"%s%0*d%s", {_segmentTemplateHead, _segmentNumWidth, _segmentNextFile, _segmentTemplateTail}));
 
-    // Create the segment file.
+    // Create the segment file, directly or in the writer thread.
     tsp->verbose(u"creating media segment %s", {fileName});
-    if (!_segmentFile.open(fileName, TSFile::WRITE | TSFile::SHARED, *tsp)) {
+    if (_asyncWrite) {
+        WriterCommand* cmd = new WriterCommand(WriterCommand::OPEN);
+        cmd->name = fileName;
+        if (!enqueueCommand(cmd)) {
+            return false;
+        }
+    }
+    else if (!_segmentFile.open(fileName, TSFile::WRITE | TSFile::SHARED, *tsp)) {
         return false;
     }
+    _segName = fileName;
+    _segPackets = 0;
 
     // Increment index for next segment name.
     _segmentNextFile++;
@@ -273,18 +330,25 @@ bool ts::hls::OutputPlugin::createNextSegment()
 bool ts::hls::OutputPlugin::closeCurrentSegment(bool endOfStream)
 {
     // If no segment file is open, there is nothing to do.
-    if (!_segmentFile.isOpen()) {
+    if (_segName.empty()) {
         return true;
     }
 
     // Get the segment file name and size (to be inserted in the playlist).
-    const UString segName(_segmentFile.getFileName());
-    const PacketCounter segPackets = _segmentFile.getWriteCount();
+    const UString segName(_segName);
+    const PacketCounter segPackets = _segPackets;
 
-    // Close the TS file.
-    if (!_segmentFile.close(*tsp)) {
+    // Close the TS file, directly or in the writer thread.
+    if (_asyncWrite) {
+        if (!flushPendingData() || !enqueueCommand(new WriterCommand(WriterCommand::CLOSE))) {
+            return false;
+        }
+    }
+    else if (!_segmentFile.close(*tsp)) {
         return false;
     }
+    _segName.clear();
+    _segPackets = 0;
 
     // On live streams, we need to maintain a list of active segments.
     if (_liveDepth > 0) {
@@ -328,7 +392,7 @@ bool ts::hls::OutputPlugin::closeCurrentSegment(bool endOfStream)
         }
 
         // Write the playlist file.
-        if (!_playlist.saveFile(UString(), *tsp)) {
+        if (!savePlaylist()) {
             return false;
         }
 
@@ -338,6 +402,8 @@ bool ts::hls::OutputPlugin::closeCurrentSegment(bool endOfStream)
         //   keep a list of failed deletions to retry these deletions later. On Unix systems,
         //   we should not have the problem since the deletion succeeds even if the file
         //   is already open (the file actually disappears when the file is closed).
+        //   With --async-write, the playlist is written in a temporary file which is then
+        //   renamed, the rename may fail on Windows for the same reason.
     }
 
     // On live streams, purge obsolete segment files.
@@ -348,10 +414,7 @@ bool ts::hls::OutputPlugin::closeCurrentSegment(bool endOfStream)
         _liveSegmentFiles.pop_front();
 
         // Delete the segment file.
-        tsp->verbose(u"deleting obsolete segment file %s", {name});
-        if (DeleteFile(name) != SYS_SUCCESS) {
-            tsp->verbose(u"error deleting obsolete segment file %s", {name});
-        }
+        deleteSegmentFile(name);
 
         // WARNING: several improvements are possible here.
         // - It could be better to delay the purge of obsolete segments. Clients may have loaded
@@ -450,22 +513,180 @@ bool ts::hls::OutputPlugin::writePackets(const TSPacket* pkt, size_t packetCount
             p = &tmp;
         }
 
-        // Write the packet in the segment file.
-        if (!_segmentFile.write(p, 1, *tsp)) {
+        // Write the packet in the segment file. With --async-write, the data
+        // are accumulated and flushed to the writer thread in larger chunks.
+        if (_asyncWrite) {
+            _pendingData.append(p->b, PKT_SIZE);
+        }
+        else if (!_segmentFile.write(p, 1, *tsp)) {
             return false;
         }
+        _segPackets++;
     }
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Send one command to the writer thread (--async-write).
+//----------------------------------------------------------------------------
+
+bool ts::hls::OutputPlugin::enqueueCommand(WriterCommand* cmd)
+{
+    // Report an error from the writer thread where the synchronous mode
+    // would have reported it.
+    WriterQueue::MessagePtr msg(cmd);
+    if (_writeError) {
+        return false;
+    }
+
+    // First, try to enqueue the command without waiting. When the queue is
+    // full, the writer thread does not keep up with the stream: report the
+    // back-pressure once and wait for some space in the queue.
+    if (_queue.enqueue(msg, 0)) {
+        _stalled = false;
+        return true;
+    }
+    if (!_stalled) {
+        _stalled = true;
+        tsp->warning(u"segment writer thread too slow, output thread stalled (slow file system?)");
+    }
+    return _queue.enqueue(msg);
+}
+
+
+//----------------------------------------------------------------------------
+// Pass the accumulated packet data to the writer thread (--async-write).
+//----------------------------------------------------------------------------
+
+bool ts::hls::OutputPlugin::flushPendingData()
+{
+    if (_pendingData.empty()) {
+        return true;
+    }
+    WriterCommand* cmd = new WriterCommand(WriterCommand::WRITE);
+    cmd->data.swap(_pendingData);
+    return enqueueCommand(cmd);
+}
+
+
+//----------------------------------------------------------------------------
+// Save the playlist file, in place or through the writer thread.
+//----------------------------------------------------------------------------
+
+bool ts::hls::OutputPlugin::savePlaylist()
+{
+    if (_asyncWrite) {
+        // Generate the playlist text on this thread (the playlist object is
+        // not thread-safe), write the file in the writer thread.
+        WriterCommand* cmd = new WriterCommand(WriterCommand::SAVE_PLAYLIST);
+        cmd->name = _playlistFile;
+        cmd->text = _playlist.textContent(*tsp);
+        if (cmd->text.empty()) {
+            delete cmd;
+            return false;
+        }
+        return enqueueCommand(cmd);
+    }
+    else {
+        return _playlist.saveFile(UString(), *tsp);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Delete an obsolete segment file, in place or through the writer thread.
+//----------------------------------------------------------------------------
+
+void ts::hls::OutputPlugin::deleteSegmentFile(const UString& name)
+{
+    tsp->verbose(u"deleting obsolete segment file %s", {name});
+    if (_asyncWrite) {
+        WriterCommand* cmd = new WriterCommand(WriterCommand::DELETE_FILE);
+        cmd->name = name;
+        enqueueCommand(cmd);
+    }
+    else if (DeleteFile(name) != SYS_SUCCESS) {
+        tsp->verbose(u"error deleting obsolete segment file %s", {name});
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Implementation of Thread: the asynchronous writer thread (--async-write).
+//----------------------------------------------------------------------------
+
+void ts::hls::OutputPlugin::main()
+{
+    tsp->debug(u"segment writer thread started");
+
+    for (;;) {
+        // Wait for the next command.
+        WriterQueue::MessagePtr cmd;
+        if (!_queue.dequeue(cmd) || cmd.isNull() || cmd->type == WriterCommand::TERMINATE) {
+            break;
+        }
+
+        // After a write error, simply drain the queue until termination.
+        // The output thread fails on its next command.
+        if (_writeError) {
+            continue;
+        }
+
+        switch (cmd->type) {
+            case WriterCommand::OPEN: {
+                _writeError = !_segmentFile.open(cmd->name, TSFile::WRITE | TSFile::SHARED, *tsp);
+                break;
+            }
+            case WriterCommand::WRITE: {
+                assert(cmd->data.size() % PKT_SIZE == 0);
+                const TSPacket* const pkt = reinterpret_cast<const TSPacket*>(cmd->data.data());
+                _writeError = _segmentFile.isOpen() && !_segmentFile.write(pkt, cmd->data.size() / PKT_SIZE, *tsp);
+                break;
+            }
+            case WriterCommand::CLOSE: {
+                _writeError = _segmentFile.isOpen() && !_segmentFile.close(*tsp);
+                break;
+            }
+            case WriterCommand::SAVE_PLAYLIST: {
+                // Write a temporary file in the same directory, then rename it.
+                // The rename is atomic on Unix systems, HTTP clients never get
+                // a truncated playlist.
+                const UString tmpName(cmd->name + u".tmp");
+                if (!cmd->text.save(tmpName, false, true) || RenameFile(tmpName, cmd->name) != SYS_SUCCESS) {
+                    tsp->error(u"error saving playlist file %s", {cmd->name});
+                    _writeError = true;
+                }
+                break;
+            }
+            case WriterCommand::DELETE_FILE: {
+                if (DeleteFile(cmd->name) != SYS_SUCCESS) {
+                    tsp->verbose(u"error deleting obsolete segment file %s", {cmd->name});
+                }
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+
+    // Make sure the segment file is closed in case of early termination.
+    if (_segmentFile.isOpen()) {
+        _segmentFile.close(*tsp);
+    }
+    tsp->debug(u"segment writer thread completed");
+}
+
+
 //----------------------------------------------------------------------------
 // Output method
 //----------------------------------------------------------------------------
 
 bool ts::hls::OutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pkt_data, size_t packetCount)
 {
-    bool ok = true;
+    // Check if a write error was reported by the writer thread.
+    bool ok = !_writeError;
 
     // Process packets one by one.
     for (size_t i = 0; ok && i < packetCount; ++i) {
@@ -480,7 +701,7 @@ bool ts::hls::OutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pk
         bool renew = false;
         if (_fixedSegmentSize > 0) {
             // Each segment shall have a fixed size.
-            renew = _segmentFile.getWriteCount() >= _fixedSegmentSize;
+            renew = _segPackets >= _fixedSegmentSize;
         }
         else if (!_segClosePending) {
             if (pkt_data[i].hasAnyLabel(_close_labels)) {
@@ -489,7 +710,7 @@ bool ts::hls::OutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pk
             }
             else if (_pcrAnalyzer.bitrateIsValid()) {
                 // The segment file shall be closed when the estimated duration exceeds the target duration.
-                _segClosePending = PacketInterval(_pcrAnalyzer.bitrate188(), _segmentFile.getWriteCount()) >= _targetDuration * MilliSecPerSec;
+                _segClosePending = PacketInterval(_pcrAnalyzer.bitrate188(), _segPackets) >= _targetDuration * MilliSecPerSec;
             }
         }
 
@@ -500,5 +721,10 @@ bool ts::hls::OutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pk
         // Finally write the packet.
         ok = (!renew || createNextSegment()) && writePackets(pkt + i, 1);
     }
+
+    // With --async-write, pass all packets of this burst to the writer thread at once.
+    if (ok && _asyncWrite) {
+        ok = flushPendingData();
+    }
     return ok;
 }
@@ -39,6 +39,8 @@
 #include "tsPCRAnalyzer.h"
 #include "tsContinuityAnalyzer.h"
 #include "tshlsPlayList.h"
+#include "tsMessageQueue.h"
+#include "tsThread.h"
 
 namespace ts {
     namespace hls {
@@ -51,7 +53,7 @@ namespace ts {
         //! playlists. To setup a complete HLS server, it is necessary to setup an
         //! external HTTP server such as Apache which simply serves these files.
         //!
-        class TSDUCKDLL OutputPlugin: public ts::OutputPlugin, private TableHandlerInterface
+        class TSDUCKDLL OutputPlugin: public ts::OutputPlugin, private TableHandlerInterface, private Thread
         {
             TS_NOBUILD_NOCOPY(OutputPlugin);
         public:
@@ -69,6 +71,19 @@ namespace ts {
             virtual bool send(const TSPacket*, const TSPacketMetadata* pkt_data, size_t) override;
 
         private:
+            // One command for the asynchronous writer thread (--async-write).
+            class WriterCommand
+            {
+            public:
+                enum Type {OPEN, WRITE, CLOSE, SAVE_PLAYLIST, DELETE_FILE, TERMINATE};
+                Type      type;  // Command type.
+                UString   name;  // File name (OPEN, SAVE_PLAYLIST, DELETE_FILE).
+                UString   text;  // Playlist text content (SAVE_PLAYLIST).
+                ByteBlock data;  // TS packets to write (WRITE).
+                WriterCommand(Type t) : type(t), name(), text(), data() {}
+            };
+            typedef MessageQueue<WriterCommand, Mutex> WriterQueue;
+
             UString            _segmentTemplate;       // Command line segment file names template.
             UString            _segmentTemplateHead;   // Head of segment file names.
             UString            _segmentTemplateTail;   // Tail of segment file names.
@@ -92,6 +107,14 @@ namespace ts {
             BitRate            _previousBitrate;       // Bitrate of previous segment.
             ContinuityAnalyzer _ccFixer;               // To fix continuity counters in PAT and PMT PID's.
             TSPacketMetadata::LabelSet _close_labels;  // Close segment on packets with any of these labels.
+            bool               _asyncWrite;            // Option --async-write: write files from a separate thread.
+            size_t             _asyncQueueSize;        // Maximum number of queued writer commands.
+            UString            _segName;               // Name of the current segment file.
+            PacketCounter      _segPackets;            // Number of packets written in the current segment.
+            volatile bool      _writeError;            // A write error occurred in the writer thread.
+            bool               _stalled;               // The output thread is currently stalled on a full writer queue.
+            ByteBlock          _pendingData;           // Packets to pass to the writer thread, accumulated per send() call.
+            WriterQueue        _queue;                 // Communication queue with the writer thread.
 
             // Create the next segment file (also close the previous one if necessary).
             bool createNextSegment();
@@ -104,6 +127,22 @@ namespace ts {
 
             // Write packets into the current segment file, adjust CC in PAT and PMT PID.
             bool writePackets(const TSPacket*, size_t);
+
+            // Send one command to the writer thread. Wait when the queue is
+            // full and report the back-pressure. Delete the command on error.
+            bool enqueueCommand(WriterCommand* cmd);
+
+            // Pass the accumulated packet data to the writer thread.
+            bool flushPendingData();
+
+            // Save the playlist file, in place or through the writer thread.
+            bool savePlaylist();
+
+            // Delete an obsolete segment file, in place or through the writer thread.
+            void deleteSegmentFile(const UString& name);
+
+            // Implementation of Thread: the asynchronous writer thread.
+            virtual void main() override;
         };
     }
 }
@@ -122,6 +122,7 @@
 #include "tsChannelFile.h"
 #include "tsCIAncillaryDataDescriptor.h"
 #include "tsCipherChaining.h"
+#include "tsCodeProfiler.h"
 #include "tsCOM.h"
 #include "tsComponentDescriptor.h"
 #include "tsComponentNameDescriptor.h"
@@ -408,6 +409,7 @@
 #include "tsSHA256.h"
 #include "tsSHA512.h"
 #include "tsSharedLibrary.h"
+#include "tsSharedTSAnalyzer.h"
 #include "tsSHDeliverySystemDescriptor.h"
 #include "tsShortEventDescriptor.h"
 #include "tsShortSmoothingBufferDescriptor.h"
@@ -577,6 +579,7 @@
 #include "tsxmlDocument.h"
 #include "tsxmlElement.h"
 #include "tsxmlNode.h"
+#include "tsxmlPullParser.h"
 #include "tsxmlText.h"
 #include "tsxmlTweaks.h"
 #include "tsxmlUnknown.h"
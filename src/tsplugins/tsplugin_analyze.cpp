@@ -35,7 +35,9 @@
 #include "tsPlugin.h"
 #include "tsPluginRepository.h"
 #include "tsTSAnalyzerReport.h"
+#include "tsSharedTSAnalyzer.h"
 #include "tsTSSpeedMetrics.h"
+#include "tsGuard.h"
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
 
@@ -55,10 +57,12 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual bool isReadOnlyObserver() override {return true;}
 
     private:
         // Command line options:
         UString           _output_name;
+        UString           _session_name;
         NanoSecond        _output_interval;
         bool              _multiple_output;
         TSAnalyzerOptions _analyzer_options;
@@ -69,6 +73,7 @@ namespace ts {
         TSSpeedMetrics    _metrics;
         NanoSecond        _next_report;
         TSAnalyzerReport  _analyzer;
+        SharedTSAnalyzerPtr _session;
 
         bool openOutput();
         void closeOutput();
@@ -87,6 +92,7 @@ TSPLUGIN_DECLARE_PROCESSOR(analyze, ts::AnalyzePlugin)
 ts::AnalyzePlugin::AnalyzePlugin(TSP* tsp_) :
     ProcessorPlugin(tsp_, u"Analyze the structure of a transport stream", u"[options]"),
     _output_name(),
+    _session_name(),
     _output_interval(0),
     _multiple_output(false),
     _analyzer_options(),
@@ -94,7 +100,8 @@ ts::AnalyzePlugin::AnalyzePlugin(TSP* tsp_) :
     _output(),
     _metrics(),
     _next_report(0),
-    _analyzer(duck)
+    _analyzer(duck),
+    _session()
 {
     // Define all standard analysis options.
     duck.defineArgsForStandards(*this);
@@ -119,6 +126,14 @@ ts::AnalyzePlugin::AnalyzePlugin(TSP* tsp_) :
     help(u"output-file", u"filename",
          u"Specify the output text file for the analysis result. "
          u"By default, use the standard output.");
+
+    option(u"shared-session", 0, STRING);
+    help(u"shared-session", u"name",
+         u"Use a shared analysis session with the specified name. "
+         u"All plugins of the same chain which use the same session name share "
+         u"one single analyzer and each packet is analyzed only once, regardless "
+         u"of the number of subscribers. "
+         u"By default, use a private analyzer.");
 }
 
 
@@ -131,6 +146,7 @@ bool ts::AnalyzePlugin::getOptions()
     duck.loadArgs(*this);
     _analyzer_options.loadArgs(duck, *this);
     _output_name = value(u"output-file");
+    _session_name = value(u"shared-session");
     _output_interval = NanoSecPerSec * intValue<Second>(u"interval", 0);
     _multiple_output = present(u"multiple-files");
     return true;
@@ -144,7 +160,17 @@ bool ts::AnalyzePlugin::getOptions()
 bool ts::AnalyzePlugin::start()
 {
     _output = _output_name.empty() ? &std::cout : &_output_stream;
-    _analyzer.setAnalysisOptions(_analyzer_options);
+
+    // With --shared-session, use a process-wide analyzer instead of the private one.
+    if (_session_name.empty()) {
+        _session.clear();
+        _analyzer.setAnalysisOptions(_analyzer_options);
+    }
+    else {
+        _session = SharedTSAnalyzer::Acquire(_session_name, duck);
+        Guard lock(_session->mutex());
+        _session->analyzer().setAnalysisOptions(_analyzer_options);
+    }
 
     // For production of multiple reports at regular intervals.
     _metrics.start();
@@ -215,7 +241,7 @@ bool ts::AnalyzePlugin::produceReport()
     if (!openOutput()) {
         return false;
     }
-    else {
+    else if (_session.isNull()) {
         // Set last known input bitrate as hint
         _analyzer.setBitrateHint(tsp->bitrate());
 
@@ -224,6 +250,14 @@ bool ts::AnalyzePlugin::produceReport()
         closeOutput();
         return true;
     }
+    else {
+        // Same, from the shared analyzer, under the session mutex.
+        Guard lock(_session->mutex());
+        _session->analyzer().setBitrateHint(tsp->bitrate());
+        _session->analyzer().report(*_output, _analyzer_options);
+        closeOutput();
+        return true;
+    }
 }
 
 
@@ -244,8 +278,14 @@ bool ts::AnalyzePlugin::stop()
 
 ts::ProcessorPlugin::Status ts::AnalyzePlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
 {
-    // Feed the analyzer with one packet
-    _analyzer.feedPacket (pkt);
+    // Feed the analyzer with one packet. With a shared session, the packet
+    // is analyzed only if no other subscriber already fed this position.
+    if (_session.isNull()) {
+        _analyzer.feedPacket (pkt);
+    }
+    else {
+        _session->feedPacket(tsp->pluginPackets(), pkt);
+    }
 
     // With --interval, check if it is time to produce a report
     if (_output_interval > 0 && _metrics.processedPacket() && _metrics.sessionNanoSeconds() >= _next_report) {
@@ -254,7 +294,13 @@ ts::ProcessorPlugin::Status ts::AnalyzePlugin::processPacket(TSPacket& pkt, TSPa
             return TSP_END;
         }
         // Reset analysis context.
-        _analyzer.reset();
+        if (_session.isNull()) {
+            _analyzer.reset();
+        }
+        else {
+            Guard lock(_session->mutex());
+            _session->analyzer().reset();
+        }
         // Compute next report time.
         _next_report += _output_interval;
     }
@@ -62,6 +62,11 @@ namespace ts {
         static constexpr BitRate DEFAULT_BITRATE_MAX = 0xFFFFFFFF;
         static constexpr size_t  DEFAULT_TIME_WINDOW_SIZE = 5;
 
+        // Number of buckets in the histogram of bitrate values.
+        // Bucket n counts the bitrate values in the range [2^n, 2^n+1) b/s,
+        // the last bucket also counts all larger values.
+        static constexpr size_t BITRATE_BUCKETS = 36;
+
         // Type indicating status of current bitrate, regarding allowed range.
         enum RangeStatus {LOWER, IN_RANGE, GREATER};
 
@@ -79,7 +84,10 @@ namespace ts {
         size_t      _window_size;          // Size (in seconds) of the time window, used to compute bitrate.
         bool        _startup;              // Measurement in progress.
         size_t      _pkt_count_index;      // Index for packet number array.
+        PacketCounter _pkt_count_total;    // Running sum of the packet number array.
         std::vector<PacketCounter> _pkt_count;        // Number of packets received during last time window, second per second.
+        std::vector<uint64_t> _bitrate_histo;         // Histogram of computed bitrate values, in power-of-two buckets.
+        uint64_t    _bitrate_samples;      // Total number of samples in the bitrate histogram.
         TSPacketMetadata::LabelSet _labels_below;     // Set these labels on all packets when bitrate is below normal.
         TSPacketMetadata::LabelSet _labels_normal;    // Set these labels on all packets when bitrate is normal.
         TSPacketMetadata::LabelSet _labels_above;     // Set these labels on all packets when bitrate is above normal.
@@ -91,6 +99,10 @@ namespace ts {
         // Compute bitrate. Report any alarm.
         void computeBitrate();
 
+        // Get a percentile of the observed bitrate values from the histogram.
+        // The returned value is the lower bound of the matching bucket.
+        BitRate bitratePercentile(int percent) const;
+
         // Check time and compute bitrate when necessary.
         void checkTime();
     };
@@ -103,6 +115,7 @@ TSPLUGIN_DECLARE_PROCESSOR(bitrate_monitor, ts::BitrateMonitorPlugin)
 constexpr ts::BitRate ts::BitrateMonitorPlugin::DEFAULT_BITRATE_MIN;
 constexpr ts::BitRate ts::BitrateMonitorPlugin::DEFAULT_BITRATE_MAX;
 constexpr size_t ts::BitrateMonitorPlugin::DEFAULT_TIME_WINDOW_SIZE;
+constexpr size_t ts::BitrateMonitorPlugin::BITRATE_BUCKETS;
 #endif
 
 
@@ -126,7 +139,10 @@ ts::BitrateMonitorPlugin::BitrateMonitorPlugin(TSP* tsp_) :
     _window_size(0),
     _startup(false),
     _pkt_count_index(0),
+    _pkt_count_total(0),
     _pkt_count(),
+    _bitrate_histo(),
+    _bitrate_samples(0),
     _labels_below(),
     _labels_normal(),
     _labels_above(),
@@ -273,11 +289,17 @@ bool ts::BitrateMonitorPlugin::start()
     // Initialize array with packets count.
     _pkt_count.resize(_window_size);
     _pkt_count_index = 0;
+    _pkt_count_total = 0;
 
     for (uint16_t i = 0; i < _pkt_count.size(); i++) {
         _pkt_count[i] = 0;
     }
 
+    // Initialize the histogram of bitrate values.
+    _bitrate_histo.clear();
+    _bitrate_histo.resize(BITRATE_BUCKETS);
+    _bitrate_samples = 0;
+
     _labels_next.reset();
     _periodic_countdown = _periodic_bitrate;
     _last_bitrate_status = IN_RANGE;
@@ -299,18 +321,26 @@ void ts::BitrateMonitorPlugin::computeBitrate()
 {
     // Bitrate is computed with the following formula :
     // (Sum of packets received during the last time window) * (packet size) / (time window)
+    // The sum is maintained incrementally, see checkTime() and processPacket().
 
-    PacketCounter total_pkt_count = 0;
-    for (uint16_t i = 0; i < _pkt_count.size(); i++) {
-        total_pkt_count  += _pkt_count[i];
-    }
+    const BitRate bitrate = BitRate(_pkt_count_total * PKT_SIZE * 8 / _pkt_count.size());
 
-    const BitRate bitrate = BitRate(total_pkt_count * PKT_SIZE * 8 / _pkt_count.size());
+    // Accumulate the bitrate value in the histogram. The bucket index is
+    // the number of significant bits, ie. floor(log2(bitrate)), capped to
+    // the last bucket.
+    size_t bucket = 0;
+    for (BitRate b = bitrate >> 1; b != 0 && bucket < BITRATE_BUCKETS - 1; b >>= 1) {
+        bucket++;
+    }
+    _bitrate_histo[bucket]++;
+    _bitrate_samples++;
 
     // Periodic bitrate display.
     if (_periodic_bitrate > 0 && --_periodic_countdown <= 0) {
         _periodic_countdown = _periodic_bitrate;
-        tsp->info(u"%s, %s bitrate: %'d bits/s", {Time::CurrentLocalTime().format(Time::DATE | Time::TIME), _alarm_prefix, bitrate});
+        tsp->info(u"%s, %s bitrate: %'d bits/s, median: %'d bits/s, 95th percentile: %'d bits/s",
+                  {Time::CurrentLocalTime().format(Time::DATE | Time::TIME), _alarm_prefix, bitrate,
+                   bitratePercentile(50), bitratePercentile(95)});
     }
 
     // Check the bitrate value, regarding the allowed range.
@@ -360,6 +390,26 @@ void ts::BitrateMonitorPlugin::computeBitrate()
 }
 
 
+//----------------------------------------------------------------------------
+// Get a percentile of the observed bitrate values from the histogram.
+//----------------------------------------------------------------------------
+
+ts::BitRate ts::BitrateMonitorPlugin::bitratePercentile(int percent) const
+{
+    // Find the bucket where the cumulated count reaches the requested
+    // fraction of the samples and return its lower bound.
+    const uint64_t target = (_bitrate_samples * uint64_t(percent) + 99) / 100;
+    uint64_t cumul = 0;
+    for (size_t i = 0; i < BITRATE_BUCKETS; ++i) {
+        cumul += _bitrate_histo[i];
+        if (cumul >= target) {
+            return i == 0 ? 0 : BitRate(uint64_t(1) << i);
+        }
+    }
+    return 0; // no sample yet
+}
+
+
 //----------------------------------------------------------------------------
 // Check time and compute bitrate when necessary.
 //----------------------------------------------------------------------------
@@ -380,8 +430,9 @@ void ts::BitrateMonitorPlugin::checkTime()
             computeBitrate();
         }
 
-        // update index, and reset packet count.
+        // Update index and reset packet count, keeping the running sum consistent.
         _pkt_count_index = (_pkt_count_index + 1) % _pkt_count.size();
+        _pkt_count_total -= _pkt_count[_pkt_count_index];
         _pkt_count[_pkt_count_index] = 0;
 
         // We are no more at startup if the index cycles.
@@ -420,6 +471,7 @@ ts::ProcessorPlugin::Status ts::BitrateMonitorPlugin::processPacket(TSPacket& pk
     // If packet's PID matches, increment the number of packets received during the current second.
     if (_full_ts || pkt.getPID() == _pid) {
         _pkt_count[_pkt_count_index]++;
+        _pkt_count_total++;
     }
 
     // Set labels according to trigger.
@@ -51,6 +51,7 @@ namespace ts {
         virtual bool getOptions() override;
         virtual bool start() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual bool isStateless() override {return true;}
 
     private:
         // Command line options:
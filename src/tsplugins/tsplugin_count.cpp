@@ -54,6 +54,7 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual bool isReadOnlyObserver() override {return true;}
 
     private:
         // This structure is used at each --interval.
@@ -56,11 +56,12 @@ namespace ts {
         virtual bool setReceiveTimeout(MilliSecond timeout) override;
 
     private:
-        uint8_t       _initCC;      // continuity_counter
-        bool          _constantCC;  // Do not increment continuity counter
-        PacketCounter _maxCount;    // Number of packets to generate
-        PacketCounter _limit;       // Current max number of packets
-        TSPacket      _packet;      // Template of packet to generate
+        uint8_t       _initCC;       // continuity_counter
+        bool          _constantCC;   // Do not increment continuity counter
+        PacketCounter _maxCount;     // Number of packets to generate
+        PacketCounter _limit;        // Current max number of packets
+        TSPacket      _packet;       // Template of packet to generate
+        bool          _incrementCC;  // Precomputed: increment CC after each packet
     };
 }
 
@@ -116,6 +117,18 @@ namespace ts {
         bool      _clearSpliceCountdown;
         uint8_t   _newSpliceCountdown;
 
+        // Precomputed patches, built once in getOptions(). All header bit
+        // operations (error, priority, PUSI, PID, scrambling, CC) are folded
+        // into AND/OR masks on the 4-byte packet header, applied in one pass
+        // instead of a chain of per-option tests. The payload pattern is
+        // expanded once to the packet size and applied with a single copy.
+        uint8_t   _headerAnd[4];    // AND mask on the packet header.
+        uint8_t   _headerOr[4];     // OR mask on the packet header.
+        ByteBlock _patternImage;    // Payload pattern repeated to packet size.
+
+        // Build the precomputed patches from the options.
+        void buildPatches();
+
         // Perform --pack-pes-header on a packet.
         void packPESHeader(TSPacket&);
     };
@@ -141,7 +154,8 @@ ts::CraftInput::CraftInput(TSP* tsp_) :
     _constantCC(false),
     _maxCount(0),
     _limit(0),
-    _packet(NullPacket)
+    _packet(NullPacket),
+    _incrementCC(false)
 {
     option(u"constant-cc");
     help(u"constant-cc",
@@ -387,6 +401,8 @@ bool ts::CraftInput::start()
 {
     _packet.setCC(_initCC);
     _limit = _maxCount;
+    // The template never changes, decide once if the CC must be incremented.
+    _incrementCC = !_constantCC && _packet.hasPayload();
     return true;
 }
 
@@ -428,7 +444,7 @@ size_t ts::CraftInput::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, siz
     for (n = 0; n < maxPackets && previousCount + n < _limit; n++) {
         buffer[n] = _packet;
         // Increment the continuity counter for the next packet when necessary.
-        if (!_constantCC && _packet.hasPayload()) {
+        if (_incrementCC) {
             _packet.setCC((_packet.getCC() + 1) & CC_MASK);
         }
     }
@@ -475,7 +491,10 @@ ts::CraftPlugin::CraftPlugin(TSP* tsp_) :
     _newCC(0),
     _setSpliceCountdown(false),
     _clearSpliceCountdown(false),
-    _newSpliceCountdown(0)
+    _newSpliceCountdown(0),
+    _headerAnd(),
+    _headerOr(),
+    _patternImage()
 {
     setIntro(u"This plugin modifies precise fields in all TS packets. "
              u"Some operations may need space in the adaptation field. "
@@ -651,44 +670,79 @@ bool ts::CraftPlugin::getOptions()
         return false;
     }
 
+    // Build the precomputed patches from the decoded options.
+    buildPatches();
+
     return true;
 }
 
 
 //----------------------------------------------------------------------------
-// Packet processing method
+// Build the precomputed patches from the options.
 //----------------------------------------------------------------------------
 
-ts::ProcessorPlugin::Status ts::CraftPlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
+void ts::CraftPlugin::buildPatches()
 {
-    // Hack the packet header. Just overwrite a few bits in place, nothing to move.
+    // Start with identity masks, the sync byte is never modified.
+    for (size_t i = 0; i < 4; ++i) {
+        _headerAnd[i] = 0xFF;
+        _headerOr[i] = 0x00;
+    }
+
+    // When an option both clears and sets a field, set wins, as in the
+    // previous sequential implementation.
     if (_clearTransportError) {
-        pkt.clearTEI();
+        _headerAnd[1] &= ~0x80;
     }
     if (_setTransportError) {
-        pkt.setTEI();
-    }
-    if (_clearTransportPriority) {
-        pkt.clearPriority();
-    }
-    if (_setTransportPriority) {
-        pkt.setPriority();
+        _headerOr[1] |= 0x80;
     }
     if (_clearPUSI) {
-        pkt.clearPUSI();
+        _headerAnd[1] &= ~0x40;
     }
     if (_setPUSI) {
-        pkt.setPUSI();
+        _headerOr[1] |= 0x40;
+    }
+    if (_clearTransportPriority) {
+        _headerAnd[1] &= ~0x20;
+    }
+    if (_setTransportPriority) {
+        _headerOr[1] |= 0x20;
     }
     if (_setPID) {
-        pkt.setPID(_newPID);
+        _headerAnd[1] &= ~0x1F;
+        _headerOr[1] |= uint8_t(_newPID >> 8) & 0x1F;
+        _headerAnd[2] = 0x00;
+        _headerOr[2] = uint8_t(_newPID);
     }
     if (_setScrambling) {
-        pkt.setScrambling(_newScrambling);
+        _headerAnd[3] &= ~0xC0;
+        _headerOr[3] |= uint8_t((_newScrambling & 0x03) << 6);
     }
     if (_setCC) {
-        pkt.setCC(_newCC);
+        _headerAnd[3] &= ~0x0F;
+        _headerOr[3] |= _newCC & 0x0F;
+    }
+
+    // Expand the payload pattern to one full packet.
+    _patternImage.clear();
+    while (!_payloadPattern.empty() && _patternImage.size() < PKT_SIZE) {
+        _patternImage.append(_payloadPattern.data(), std::min(_payloadPattern.size(), PKT_SIZE - _patternImage.size()));
     }
+}
+
+
+//----------------------------------------------------------------------------
+// Packet processing method
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Status ts::CraftPlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
+{
+    // Hack the packet header. All header bit operations were precomputed
+    // into AND/OR masks, just overwrite the bits in place, nothing to move.
+    pkt.b[1] = (pkt.b[1] & _headerAnd[1]) | _headerOr[1];
+    pkt.b[2] = (pkt.b[2] & _headerAnd[2]) | _headerOr[2];
+    pkt.b[3] = (pkt.b[3] & _headerAnd[3]) | _headerOr[3];
 
     // Remove fields or clear bits in the adaptation field.
     // These operations always succeed and do not change the size of the AF,
@@ -759,13 +813,11 @@ ts::ProcessorPlugin::Status ts::CraftPlugin::processPacket(TSPacket& pkt, TSPack
         tsp->warning(u"packet %'d: adaptation field too short to set private data", {tsp->pluginPackets()});
     }
 
-    // Fill payload with pattern.
-    if (mayUpdatePayload && !_payloadPattern.empty()) {
+    // Fill payload with the precomputed pattern image, in one copy.
+    if (mayUpdatePayload && !_patternImage.empty()) {
         uint8_t* data = pkt.getPayload() + payloadBase + _offsetPattern;
-        while (data < pkt.b + PKT_SIZE) {
-            const size_t size = std::min<size_t>(_payloadPattern.size(), pkt.b + PKT_SIZE - data);
-            ::memcpy(data, _payloadPattern.data(), size);
-            data += size;
+        if (data < pkt.b + PKT_SIZE) {
+            ::memcpy(data, _patternImage.data(), pkt.b + PKT_SIZE - data);
         }
     }
 
@@ -51,6 +51,7 @@ namespace ts {
         DecapPlugin(TSP*);
         virtual bool getOptions() override;
         virtual bool start() override;
+        virtual bool stop() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
@@ -108,6 +109,18 @@ bool ts::DecapPlugin::start()
 }
 
 
+//----------------------------------------------------------------------------
+// Stop method
+//----------------------------------------------------------------------------
+
+bool ts::DecapPlugin::stop()
+{
+    tsp->verbose(u"decapsulated %'d packets from %'d input packets, %'d synchronization losses, %'d bytes discarded",
+                 {_decap.outputPacketCount(), _decap.inputPacketCount(), _decap.syncLossCount(), _decap.discardedByteCount()});
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
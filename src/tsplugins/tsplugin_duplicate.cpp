@@ -34,7 +34,6 @@
 
 #include "tsAbstractDuplicateRemapPlugin.h"
 #include "tsPluginRepository.h"
-#include "tsSafePtr.h"
 TSDUCK_SOURCE;
 
 #define DEF_MAX_BUFFERED 1024
@@ -56,12 +55,12 @@ namespace ts {
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
-        typedef SafePtr<TSPacket> TSPacketPtr;
-        typedef std::deque<TSPacketPtr> TSPacketPtrQueue;
-
-        bool             _silentDrop;       // Silently drop packets on overflow.
-        size_t           _maxBuffered;      // Max buffered packets.
-        TSPacketPtrQueue _queue;            // Buffered packets, waiting for null packets to replace.
+        bool           _silentDrop;   // Silently drop packets on overflow.
+        size_t         _maxBuffered;  // Max buffered packets.
+        TSPacketVector _buffer;       // Preallocated circular buffer of packets, waiting for null packets to replace.
+        size_t         _head;         // Index of the oldest buffered packet.
+        size_t         _count;        // Number of buffered packets.
+        PID            _dupTable[PID_MAX];  // Flat table: duplicated PID per slot, identity when not duplicated.
     };
 }
 
@@ -77,7 +76,10 @@ ts::DuplicatePlugin::DuplicatePlugin(TSP* tsp_) :
     AbstractDuplicateRemapPlugin(false, tsp_, u"Duplicate PID's, reusing null packets", u"[options] [pid[-pid]=newpid ...]"),
     _silentDrop(false),
     _maxBuffered(0),
-    _queue()
+    _buffer(),
+    _head(0),
+    _count(0),
+    _dupTable()
 {
     option(u"drop-overflow", 'd');
     help(u"drop-overflow",
@@ -115,7 +117,22 @@ bool ts::DuplicatePlugin::getOptions()
 
 bool ts::DuplicatePlugin::start()
 {
-    _queue.clear();
+    // Preallocate the circular packet buffer once. Buffering a packet is
+    // then a single 188-byte copy, without dynamic allocation.
+    _buffer.resize(_maxBuffered);
+    _head = 0;
+    _count = 0;
+
+    // Build the flat duplication table: identity for all PID's, then apply
+    // the duplication rules. One indexed load replaces a map lookup on each
+    // packet of the stream.
+    for (size_t pid = 0; pid < PID_MAX; ++pid) {
+        _dupTable[pid] = PID(pid);
+    }
+    for (PIDMap::const_iterator it = _pidMap.begin(); it != _pidMap.end(); ++it) {
+        _dupTable[it->first] = it->second;
+    }
+
     tsp->verbose(u"%d PID's duplicated", {_pidMap.size()});
     return true;
 }
@@ -129,9 +146,8 @@ ts::ProcessorPlugin::Status ts::DuplicatePlugin::processPacket(TSPacket& pkt, TS
 {
     // Get old and new PID.
     const PID pid = pkt.getPID();
-    const PIDMap::const_iterator it = _pidMap.find(pid);
-    const bool duplicate = it != _pidMap.end();
-    const PID newpid = duplicate ? it->second : pid;
+    const PID newpid = _dupTable[pid];
+    const bool duplicate = newpid != pid;
 
     // Check PID conflicts.
     if (!_unchecked && !duplicate && _newPIDs.test(pid)) {
@@ -140,29 +156,31 @@ ts::ProcessorPlugin::Status ts::DuplicatePlugin::processPacket(TSPacket& pkt, TS
     }
 
     // Process insertion of buffered packet when input is a null packet.
-    if (pid == PID_NULL && !_queue.empty()) {
-        // Copy the packet in front of the list.
-        pkt = *_queue.front();
-        // And remove it from the list.
-        _queue.pop_front();
+    if (pid == PID_NULL && _count > 0) {
+        // Copy the oldest buffered packet and remove it from the buffer.
+        pkt = _buffer[_head];
+        _head = (_head + 1) % _buffer.size();
+        _count--;
         // Apply labels on duplicated packets.
         pkt_data.setLabels(_setLabels);
         pkt_data.clearLabels(_resetLabels);
     }
 
     // Copy packets to duplicate in the buffer.
-    if (duplicate) {
-        if (_queue.size() >= _maxBuffered) {
+    if (duplicate && !_buffer.empty()) {
+        if (_count >= _buffer.size()) {
             // Buffer overflow, drop the oldest packet.
-            _queue.pop_front();
+            _head = (_head + 1) % _buffer.size();
+            _count--;
             if (!_silentDrop) {
                 tsp->warning(u"buffer overflow, dropping packet");
             }
         }
         // Copy the packet in the buffer with the new PID.
-        const TSPacketPtr newpkt(new TSPacket(pkt));
-        newpkt->setPID(newpid);
-        _queue.push_back(newpkt);
+        TSPacket& dup(_buffer[(_head + _count) % _buffer.size()]);
+        dup = pkt;
+        dup.setPID(newpid);
+        _count++;
     }
 
     return TSP_OK;
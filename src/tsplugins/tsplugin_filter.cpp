@@ -93,6 +93,41 @@ namespace ts {
         TSPacketMetadata::LabelSet _reset_labels;      // Labels to reset on filtered packets
         TSPacketMetadata::LabelSet _set_perm_labels;   // Labels to set on all packets after getting one packet
         TSPacketMetadata::LabelSet _reset_perm_labels; // Labels to reset on all packets after getting one packet
+
+        // Compiled evaluation plan. Each selection criterion is a small
+        // function. At start, only the active criteria are compiled into a
+        // flat array which is evaluated with an early exit on the first
+        // match. Inactive criteria cost nothing per packet and the common
+        // case (PID filter only, bitmap miss) is a single indirect call.
+        typedef bool (*Predicate)(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        std::vector<Predicate> _plan;  // Active criteria only, in evaluation order.
+
+        // Compile the evaluation plan from the active criteria.
+        void compilePlan();
+
+        // One static function per selection criterion.
+        static bool testPid(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testPayload(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testAF(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testUnitStart(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testNullified(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testInputStuffing(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testValid(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testScrambling(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testPCR(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testHasSplice(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testSplice(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testMinSplice(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testMaxSplice(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testMinPayload(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testMaxPayload(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testMinAF(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testMaxAF(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testLabels(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testEvery(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testPES(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testPattern(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
+        static bool testRanges(const FilterPlugin&, const TSPacket&, const TSPacketMetadata&);
     };
 }
 
@@ -138,7 +173,8 @@ ts::FilterPlugin::FilterPlugin(TSP* tsp_) :
     _set_labels(),
     _reset_labels(),
     _set_perm_labels(),
-    _reset_perm_labels()
+    _reset_perm_labels(),
+    _plan()
 {
     option(u"adaptation-field");
     help(u"adaptation-field", u"Select packets with an adaptation field.");
@@ -394,6 +430,215 @@ bool ts::FilterPlugin::getOptions()
 }
 
 
+//----------------------------------------------------------------------------
+// Selection criteria, one function per criterion.
+//----------------------------------------------------------------------------
+
+bool ts::FilterPlugin::testPid(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return p._pid[pkt.getPID()];
+}
+
+bool ts::FilterPlugin::testPayload(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return pkt.hasPayload();
+}
+
+bool ts::FilterPlugin::testAF(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return pkt.hasAF();
+}
+
+bool ts::FilterPlugin::testUnitStart(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return pkt.getPUSI();
+}
+
+bool ts::FilterPlugin::testNullified(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return data.getNullified();
+}
+
+bool ts::FilterPlugin::testInputStuffing(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return data.getInputStuffing();
+}
+
+bool ts::FilterPlugin::testValid(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return pkt.hasValidSync() && !pkt.getTEI();
+}
+
+bool ts::FilterPlugin::testScrambling(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return p._scrambling_ctrl == pkt.getScrambling();
+}
+
+bool ts::FilterPlugin::testPCR(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return pkt.hasPCR() || pkt.hasOPCR();
+}
+
+bool ts::FilterPlugin::testHasSplice(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return pkt.hasSpliceCountdown();
+}
+
+bool ts::FilterPlugin::testSplice(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return pkt.hasSpliceCountdown() && pkt.getSpliceCountdown() == p._splice;
+}
+
+bool ts::FilterPlugin::testMinSplice(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return pkt.hasSpliceCountdown() && pkt.getSpliceCountdown() >= p._min_splice;
+}
+
+bool ts::FilterPlugin::testMaxSplice(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return pkt.hasSpliceCountdown() && pkt.getSpliceCountdown() <= p._max_splice;
+}
+
+bool ts::FilterPlugin::testMinPayload(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return int(pkt.getPayloadSize()) >= p._min_payload;
+}
+
+bool ts::FilterPlugin::testMaxPayload(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return int(pkt.getPayloadSize()) <= p._max_payload;
+}
+
+bool ts::FilterPlugin::testMinAF(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return int(pkt.getAFSize()) >= p._min_af;
+}
+
+bool ts::FilterPlugin::testMaxAF(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return int(pkt.getAFSize()) <= p._max_af;
+}
+
+bool ts::FilterPlugin::testLabels(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return data.hasAnyLabel(p._labels);
+}
+
+bool ts::FilterPlugin::testEvery(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return (p.tsp->pluginPackets() - p._after_packets) % p._every_packets == 0;
+}
+
+bool ts::FilterPlugin::testPES(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    return pkt.startPES();
+}
+
+bool ts::FilterPlugin::testPattern(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    const size_t start = p._search_payload ? pkt.getHeaderSize() : 0;
+    if (start + p._search_offset + p._pattern.size() > PKT_SIZE) {
+        return false;
+    }
+    else if (p._use_search_offset) {
+        return ::memcmp(pkt.b + start + p._search_offset, p._pattern.data(), p._pattern.size()) == 0;
+    }
+    else {
+        return LocatePattern(pkt.b + start, PKT_SIZE - start, p._pattern.data(), p._pattern.size()) != nullptr;
+    }
+}
+
+bool ts::FilterPlugin::testRanges(const FilterPlugin& p, const TSPacket& pkt, const TSPacketMetadata& data)
+{
+    const PacketCounter packetIndex = p.tsp->pluginPackets();
+    for (auto it = p._ranges.begin(); it != p._ranges.end(); ++it) {
+        if (packetIndex >= it->first && packetIndex <= it->second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Compile the evaluation plan from the active criteria.
+//----------------------------------------------------------------------------
+
+void ts::FilterPlugin::compilePlan()
+{
+    _plan.clear();
+
+    // The PID bitmap test comes first: in the most common usage, it is the
+    // only criterion and most packets are decided by this single test.
+    if (_pid.any()) {
+        _plan.push_back(testPid);
+    }
+    if (_with_payload) {
+        _plan.push_back(testPayload);
+    }
+    if (_with_af) {
+        _plan.push_back(testAF);
+    }
+    if (_unit_start) {
+        _plan.push_back(testUnitStart);
+    }
+    if (_nullified) {
+        _plan.push_back(testNullified);
+    }
+    if (_input_stuffing) {
+        _plan.push_back(testInputStuffing);
+    }
+    if (_valid) {
+        _plan.push_back(testValid);
+    }
+    if (_scrambling_ctrl >= 0) {
+        _plan.push_back(testScrambling);
+    }
+    if (_with_pcr) {
+        _plan.push_back(testPCR);
+    }
+    if (_with_splice) {
+        _plan.push_back(testHasSplice);
+    }
+    if (_splice >= -128) {
+        _plan.push_back(testSplice);
+    }
+    if (_min_splice >= -128) {
+        _plan.push_back(testMinSplice);
+    }
+    if (_max_splice >= -128) {
+        _plan.push_back(testMaxSplice);
+    }
+    if (_min_payload >= 0) {
+        _plan.push_back(testMinPayload);
+    }
+    if (_max_payload >= 0) {
+        _plan.push_back(testMaxPayload);
+    }
+    if (_min_af >= 0) {
+        _plan.push_back(testMinAF);
+    }
+    if (_max_af >= 0) {
+        _plan.push_back(testMaxAF);
+    }
+    if (_labels.any()) {
+        _plan.push_back(testLabels);
+    }
+    if (_every_packets > 0) {
+        _plan.push_back(testEvery);
+    }
+    if (_with_pes) {
+        _plan.push_back(testPES);
+    }
+    if (!_pattern.empty()) {
+        _plan.push_back(testPattern);
+    }
+    if (!_ranges.empty()) {
+        _plan.push_back(testRanges);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Start method.
 //----------------------------------------------------------------------------
@@ -401,6 +646,7 @@ bool ts::FilterPlugin::getOptions()
 bool ts::FilterPlugin::start()
 {
     _filtered_packets = 0;
+    compilePlan();
     return true;
 }
 
@@ -429,43 +675,10 @@ ts::ProcessorPlugin::Status ts::FilterPlugin::processPacket(TSPacket& pkt, TSPac
     }
 
     // Check if the packet matches one of the selected criteria.
-    bool ok = _pid[pkt.getPID()] ||
-        (_with_payload && pkt.hasPayload()) ||
-        (_with_af && pkt.hasAF()) ||
-        (_unit_start && pkt.getPUSI()) ||
-        (_nullified && pkt_data.getNullified()) ||
-        (_input_stuffing && pkt_data.getInputStuffing()) ||
-        (_valid && pkt.hasValidSync() && !pkt.getTEI()) ||
-        (_scrambling_ctrl == pkt.getScrambling()) ||
-        (_with_pcr && (pkt.hasPCR() || pkt.hasOPCR())) ||
-        (_with_splice && pkt.hasSpliceCountdown()) ||
-        (_splice >= -128 && pkt.hasSpliceCountdown() && pkt.getSpliceCountdown() == _splice) ||
-        (_min_splice >= -128 && pkt.hasSpliceCountdown() && pkt.getSpliceCountdown() >= _min_splice) ||
-        (_max_splice >= -128 && pkt.hasSpliceCountdown() && pkt.getSpliceCountdown() <= _max_splice) ||
-        (_min_payload >= 0 && int(pkt.getPayloadSize()) >= _min_payload) ||
-        (int(pkt.getPayloadSize()) <= _max_payload) ||
-        (_min_af >= 0 && int(pkt.getAFSize()) >= _min_af) ||
-        (int(pkt.getAFSize()) <= _max_af) ||
-        pkt_data.hasAnyLabel(_labels) ||
-        (_every_packets > 0 && (tsp->pluginPackets() - _after_packets) % _every_packets == 0) ||
-        (_with_pes && pkt.startPES());
-
-    // Search binary patterns in packets.
-    if (!ok && !_pattern.empty()) {
-        const size_t start = _search_payload ? pkt.getHeaderSize() : 0;
-        if (start + _search_offset + _pattern.size() <= PKT_SIZE) {
-            if (_use_search_offset) {
-                ok = ::memcmp(pkt.b + start + _search_offset, _pattern.data(), _pattern.size()) == 0;
-            }
-            else {
-                ok = LocatePattern(pkt.b + start, PKT_SIZE - start, _pattern.data(), _pattern.size()) != nullptr;
-            }
-        }
-    }
-
-    // Search if packet is in one selected range.
-    for (auto it = _ranges.begin(); !ok && it != _ranges.end(); ++it) {
-        ok = packetIndex >= it->first && packetIndex <= it->second;
+    // Evaluate the compiled plan, stop on the first matching criterion.
+    bool ok = false;
+    for (size_t i = 0; !ok && i < _plan.size(); ++i) {
+        ok = _plan[i](*this, pkt, pkt_data);
     }
 
     // Reverse selection criteria with --negate.
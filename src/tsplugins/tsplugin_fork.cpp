@@ -127,7 +127,7 @@ ts::ForkInput::ForkInput(TSP* tsp_) :
     help(u"", u"Specifies the command line to execute in the created process.");
 
     option(u"buffered-packets", 'b', POSITIVE);
-    help(u"buffered-packets", u"Windows only: Specifies the pipe buffer size in number of TS packets.");
+    help(u"buffered-packets", u"Windows and Linux: Specifies the pipe buffer size in number of TS packets.");
 
     option(u"nowait", 'n');
     help(u"nowait", u"Do not wait for child process termination at end of its output.");
@@ -149,7 +149,7 @@ ts::ForkOutput::ForkOutput(TSP* tsp_) :
     help(u"", u"Specifies the command line to execute in the created process.");
 
     option(u"buffered-packets", 'b', POSITIVE);
-    help(u"buffered-packets", u"Windows only: Specifies the pipe buffer size in number of TS packets.");
+    help(u"buffered-packets", u"Windows and Linux: Specifies the pipe buffer size in number of TS packets.");
 
     option(u"nowait", 'n');
     help(u"nowait", u"Do not wait for child process termination at end of input.");
@@ -208,7 +208,7 @@ bool ts::ForkInput::start()
     // Create pipe & process.
     return _pipe.open(_command,
                       _nowait ? ForkPipe::ASYNCHRONOUS : ForkPipe::SYNCHRONOUS,
-                      PKT_SIZE * _buffer_size,  // Pipe buffer size (Windows only, zero meaning default).
+                      PKT_SIZE * _buffer_size,  // Pipe buffer size (Windows, Linux), zero meaning default.
                       *tsp,                     // Error reporting.
                       ForkPipe::STDOUT_PIPE,    // Output: send stdout to pipe, keep same stderr as tsp.
                       ForkPipe::STDIN_NONE);    // Input: null device (do not use the same stdin as tsp).
@@ -255,7 +255,7 @@ bool ts::ForkOutput::start()
     // Create pipe & process.
     return _pipe.open(_command,
                       _nowait ? ForkPipe::ASYNCHRONOUS : ForkPipe::SYNCHRONOUS,
-                      PKT_SIZE * _buffer_size,  // Pipe buffer size (Windows only), same as internal buffer size.
+                      PKT_SIZE * _buffer_size,  // Pipe buffer size (Windows, Linux), same as internal buffer size.
                       *tsp,                     // Error reporting.
                       ForkPipe::KEEP_BOTH,      // Output: same stdout and stderr as tsp process.
                       ForkPipe::STDIN_PIPE);    // Input: use the pipe.
@@ -301,7 +301,7 @@ bool ts::ForkPlugin::start()
     // Create pipe & process.
     return _pipe.open(_command,
                       _nowait ? ForkPipe::ASYNCHRONOUS : ForkPipe::SYNCHRONOUS,
-                      PKT_SIZE * _buffer_size,  // Pipe buffer size (Windows only), same as internal buffer size.
+                      PKT_SIZE * _buffer_size,  // Pipe buffer size (Windows, Linux), same as internal buffer size.
                       *tsp,                     // Error reporting.
                       ForkPipe::KEEP_BOTH,      // Output: same stdout and stderr as tsp process.
                       ForkPipe::STDIN_PIPE);    // Input: use the pipe.
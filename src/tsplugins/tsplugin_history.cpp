@@ -38,19 +38,26 @@
 #include "tsNames.h"
 #include "tsVariable.h"
 #include "tsTime.h"
+#include "tsThread.h"
+#include "tsSysUtils.h"
+#include "tsMemory.h"
 #include "tsPAT.h"
 #include "tsPMT.h"
 #include "tsTOT.h"
 #include "tsTDT.h"
 TSDUCK_SOURCE;
 
+#define DEFAULT_EVENT_BUFFER_SIZE 1024  // Default number of slots in the event ring.
+#define EVENT_POLL_INTERVAL         20  // Polling interval of the formatter thread, in milliseconds.
+#define BINARY_RECORD_SIZE          24  // Size of one packed binary event record.
+
 
 //----------------------------------------------------------------------------
 // Plugin definition
 //----------------------------------------------------------------------------
 
 namespace ts {
-    class HistoryPlugin: public ProcessorPlugin, private TableHandlerInterface
+    class HistoryPlugin: public ProcessorPlugin, private TableHandlerInterface, private Thread
     {
         TS_NOBUILD_NOCOPY(HistoryPlugin);
     public:
@@ -59,6 +66,7 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual bool isReadOnlyObserver() override {return true;}
 
     private:
         // Description of one PID
@@ -74,8 +82,41 @@ namespace ts {
             Variable<uint8_t> pes_strid;    // PES stream id
         };
 
+        // Type of a history event. Events which are detected on the packet
+        // path are stored as binary records, without string formatting, and
+        // formatted later by the background thread. Events coming from the
+        // section demux are infrequent and keep a preformatted text.
+        enum EventType {
+            EV_TEXT,             // Preformatted text line (slow path only).
+            EV_FIRST_PKT,        // First packet in a PID.
+            EV_SUSPEND_RESTART,  // PID suspended, then restarted.
+            EV_CLEAR_TO_SCRAMB,  // Clear to scrambled transition.
+            EV_SCRAMB_TO_CLEAR,  // Scrambled to clear transition.
+            EV_CRYPTO_PERIOD,    // New crypto-period.
+            EV_PES_FIRST_ID,     // First PES stream id in a PID.
+            EV_PES_ID_CHANGE,    // PES stream id modified in a PID.
+        };
+
+        // One history event, a fixed binary record. The packet thread fills
+        // the numerical fields only, all formatting is deferred.
+        struct Event
+        {
+            Event();                  // Constructor
+            PacketCounter pkt;        // Packet number of the event.
+            PacketCounter pkt2;       // Packet number of the suspension (EV_SUSPEND_RESTART).
+            uint8_t       type;       // Event type, one of EV_*.
+            uint8_t       scrambling; // Current scrambling control value.
+            uint8_t       old_scr;    // Previous scrambling control value (EV_SUSPEND_RESTART).
+            uint8_t       stream_id;  // Current PES stream id.
+            uint8_t       old_strid;  // Previous PES stream id (EV_PES_ID_CHANGE).
+            PID           pid;        // PID of the event.
+            uint16_t      service_id; // Service the PID belongs to.
+            UString       text;       // Preformatted text (EV_TEXT only).
+        };
+
         // Private members
         std::ofstream _outfile;           // User-specified output file
+        std::ofstream _binfile;           // User-specified binary log file
         PacketCounter _current_pkt;       // Current TS packet number
         bool          _report_eit;        // Report EIT
         bool          _report_cas;        // Report CAS events
@@ -89,6 +130,18 @@ namespace ts {
         SectionDemux  _demux;             // Section filter
         PIDContext    _cpids[PID_MAX];    // Description of each PID
 
+        // The event ring buffer. The packet thread is the only producer and
+        // the formatter thread the only consumer, the indexes are free
+        // running and reduced modulo the buffer size on access.
+        std::vector<Event>  _events;      // Preallocated ring of events
+        std::atomic<size_t> _ev_in;       // Index of next event to enqueue
+        std::atomic<size_t> _ev_out;      // Index of next event to format
+        std::atomic<bool>   _ev_stop;     // Request the formatter thread to terminate
+        PacketCounter       _ev_dropped;  // Number of events lost on ring overflow
+
+        // Implementation of the formatter thread.
+        virtual void main() override;
+
         // Invoked by the demux when a complete table is available.
         virtual void handleTable(SectionDemux&, const BinaryTable&) override;
 
@@ -98,6 +151,16 @@ namespace ts {
         // Report a history line
         void report(const UChar* fmt, const std::initializer_list<ArgMixIn> args);
         void report(PacketCounter, const UChar* fmt, const std::initializer_list<ArgMixIn> args);
+
+        // Enqueue one event in the ring. With wait, block until a slot is
+        // free instead of dropping the event (used outside the packet path).
+        void enqueueEvent(const Event& ev, bool wait = false);
+
+        // Format and output one event (formatter thread only).
+        void emitEvent(const Event& ev);
+
+        // Output one formatted history line (formatter thread only).
+        void emitLine(PacketCounter pkt, const UString& line);
     };
 }
 
@@ -111,7 +174,9 @@ TSPLUGIN_DECLARE_PROCESSOR(history, ts::HistoryPlugin)
 
 ts::HistoryPlugin::HistoryPlugin(TSP* tsp_) :
     ProcessorPlugin(tsp_, u"Report a history of major events on the transport stream", u"[options]"),
+    Thread(),
     _outfile(),
+    _binfile(),
     _current_pkt(0),
     _report_eit(false),
     _report_cas(false),
@@ -123,11 +188,33 @@ ts::HistoryPlugin::HistoryPlugin(TSP* tsp_) :
     _last_tdt_pkt(0),
     _last_tdt_reported(false),
     _demux(duck, this),
-    _cpids()
+    _cpids(),
+    _events(),
+    _ev_in(0),
+    _ev_out(0),
+    _ev_stop(false),
+    _ev_dropped(0)
 {
+    option(u"binary-log", 0, STRING);
+    help(u"binary-log", u"filename",
+         u"Log events as packed binary records in the specified file, for "
+         u"offline formatting. Each record is 24 bytes long: packet number "
+         u"(8 bytes), secondary packet number (8 bytes), event type (1 byte), "
+         u"PID (2 bytes), service id (2 bytes), scrambling control (1 byte), "
+         u"previous scrambling control (1 byte), PES stream id (1 byte), "
+         u"previous PES stream id (1 byte). All integers are in big endian "
+         u"order. Events from PSI/SI tables are still reported as text lines.");
+
     option(u"cas", 'c');
     help(u"cas", u"Report all CAS events (ECM, crypto-periods).");
 
+    option(u"event-buffer-size", 0, POSITIVE);
+    help(u"event-buffer-size",
+         u"Specify the number of events which can be buffered between the "
+         u"packet processing thread and the background formatter thread. "
+         u"When the buffer is full, additional events are dropped and counted. "
+         u"The default is " TS_USTRINGIFY(DEFAULT_EVENT_BUFFER_SIZE) u" events.");
+
     option(u"eit", 'e');
     help(u"eit", u"Report all EIT. By default, EIT are not reported.");
 
@@ -182,6 +269,25 @@ ts::HistoryPlugin::PIDContext::PIDContext() :
 }
 
 
+//----------------------------------------------------------------------------
+// Description of one event : Constructor.
+//----------------------------------------------------------------------------
+
+ts::HistoryPlugin::Event::Event() :
+    pkt(0),
+    pkt2(0),
+    type(EV_TEXT),
+    scrambling(0),
+    old_scr(0),
+    stream_id(0),
+    old_strid(0),
+    pid(PID_NULL),
+    service_id(0),
+    text()
+{
+}
+
+
 //----------------------------------------------------------------------------
 // Start method
 //----------------------------------------------------------------------------
@@ -207,6 +313,29 @@ bool ts::HistoryPlugin::start()
         }
     }
 
+    // Create binary log file
+    if (present(u"binary-log")) {
+        const UString name(value(u"binary-log"));
+        tsp->verbose(u"creating %s", {name});
+        _binfile.open(name.toUTF8().c_str(), std::ios::out | std::ios::binary);
+        if (!_binfile) {
+            tsp->error(u"cannot create %s", {name});
+            return false;
+        }
+    }
+
+    // Preallocate the event ring and start the formatter thread.
+    _events.clear();
+    _events.resize(intValue<size_t>(u"event-buffer-size", DEFAULT_EVENT_BUFFER_SIZE));
+    _ev_in = 0;
+    _ev_out = 0;
+    _ev_stop = false;
+    _ev_dropped = 0;
+    if (!Thread::start()) {
+        tsp->error(u"cannot start the event formatter thread");
+        return false;
+    }
+
     // Reinitialize state
     _current_pkt = 0;
     _last_tdt_pkt = 0;
@@ -243,17 +372,32 @@ bool ts::HistoryPlugin::start()
 
 bool ts::HistoryPlugin::stop()
 {
-    // Report last packet of each PID
+    // Report last packet of each PID. We are no longer on the packet path,
+    // block on ring overflow instead of dropping events.
     for (PIDContext* p = _cpids; p < _cpids + PID_MAX; ++p) {
         if (p->pkt_count > 0) {
-            report(p->last_pkt, u"PID %d (0x%04X) last packet, %s", {p - _cpids, p - _cpids, p->scrambling ? u"scrambled" : u"clear"});
+            Event ev;
+            ev.pkt = p->last_pkt;
+            ev.type = EV_TEXT;
+            ev.text.format(u"PID %d (0x%04X) last packet, %s", {p - _cpids, p - _cpids, p->scrambling ? u"scrambled" : u"clear"});
+            enqueueEvent(ev, true);
         }
     }
 
-    // Close output file
+    // Let the formatter thread drain the ring and terminate.
+    _ev_stop = true;
+    waitForTermination();
+    if (_ev_dropped > 0) {
+        tsp->warning(u"%'d history events lost, use --event-buffer-size to enlarge the event buffer", {_ev_dropped});
+    }
+
+    // Close output files
     if (_outfile.is_open()) {
         _outfile.close();
     }
+    if (_binfile.is_open()) {
+        _binfile.close();
+    }
 
     return true;
 }
@@ -468,37 +612,56 @@ ts::ProcessorPlugin::Status ts::HistoryPlugin::processPacket(TSPacket& pkt, TSPa
     // immediately followed by clear-to-scrambled transistions.
     const bool ignore_scrambling = !pkt.hasPayload() || pkt.getPayloadSize() < 8;
 
+    // Build a binary record for the potential event on this packet.
+    // No string is formatted here, this is deferred to the formatter thread.
+    Event ev;
+    ev.pkt = _current_pkt;
+    ev.pid = pid;
+    ev.service_id = cpid->service_id;
+    ev.scrambling = scrambling;
+    ev.old_scr = cpid->scrambling;
+
     if (cpid->pkt_count == 0) {
         // First packet in a PID
         cpid->first_pkt = _current_pkt;
-        report(u"PID %d (0x%X) first packet, %s", {pid, pid, scrambling ? u"scrambled" : u"clear"});
+        ev.type = EV_FIRST_PKT;
+        enqueueEvent(ev);
     }
     else if (cpid->last_pkt + _suspend_after < _current_pkt) {
         // Last packet in the PID is so old that we consider the PID as suspended, and now restarted
-        report(cpid->last_pkt, u"PID %d (0x%X) suspended, %s, service 0x%X", {pid, pid, cpid->scrambling ? u"scrambled" : u"clear", _cpids[pid].service_id});
-        report(u"PID %d (0x%X) restarted, %s, service 0x%04X", {pid, pid, scrambling ? u"scrambled" : u"clear", _cpids[pid].service_id});
+        ev.type = EV_SUSPEND_RESTART;
+        ev.pkt2 = cpid->last_pkt;
+        enqueueEvent(ev);
     }
     else if (!ignore_scrambling && cpid->scrambling == 0 && scrambling != 0) {
         // Clear to scrambled transition
-        report(u"PID %d (0x%X), clear to scrambled transition, %s key, service 0x%X", {pid, pid, names::ScramblingControl(scrambling), _cpids[pid].service_id});
+        ev.type = EV_CLEAR_TO_SCRAMB;
+        enqueueEvent(ev);
     }
     else if (!ignore_scrambling && cpid->scrambling != 0 && scrambling == 0) {
         // Scrambled to clear transition
-        report(u"PID %d (0x%X), scrambled to clear transition, service 0x%X", {pid, pid, _cpids[pid].service_id});
+        ev.type = EV_SCRAMB_TO_CLEAR;
+        enqueueEvent(ev);
     }
     else if (!ignore_scrambling && _report_cas && cpid->scrambling != scrambling) {
         // New crypto-period
-        report(u"PID %d (0x%X), new crypto-period, %s key, service 0x%X", {pid, pid, names::ScramblingControl(scrambling), _cpids[pid].service_id});
+        ev.type = EV_CRYPTO_PERIOD;
+        enqueueEvent(ev);
     }
 
     if (has_pes_start) {
         if (!cpid->pes_strid.set()) {
             // Found first PES stream id in the PID.
-            report(u"PID %d (0x%X), PES stream_id is %s", {pid, pid, names::StreamId(pes_stream_id, names::FIRST)});
+            ev.type = EV_PES_FIRST_ID;
+            ev.stream_id = pes_stream_id;
+            enqueueEvent(ev);
         }
         else if (cpid->pes_strid != pes_stream_id && !_ignore_stream_id) {
             // PES stream id has changed in the PID.
-            report(u"PID %d (0x%X), PES stream_id modified from 0x%X to %s", {pid, pid, cpid->pes_strid.value(), names::StreamId(pes_stream_id, names::FIRST)});
+            ev.type = EV_PES_ID_CHANGE;
+            ev.stream_id = pes_stream_id;
+            ev.old_strid = cpid->pes_strid.value();
+            enqueueEvent(ev);
         }
         cpid->pes_strid = pes_stream_id;
     }
@@ -530,12 +693,143 @@ void ts::HistoryPlugin::report(const UChar* fmt, const std::initializer_list<Arg
 
 void ts::HistoryPlugin::report(PacketCounter pkt, const UChar* fmt, const std::initializer_list<ArgMixIn> args)
 {
-    // Reports the last TDT if required
+    Event ev;
+    ev.pkt = pkt;
+    ev.type = EV_TEXT;
+    ev.text.format(fmt, args);
+    enqueueEvent(ev);
+}
+
+
+//----------------------------------------------------------------------------
+// Enqueue one event in the ring.
+//----------------------------------------------------------------------------
+
+void ts::HistoryPlugin::enqueueEvent(const Event& ev, bool wait)
+{
+    // Reports the last TDT before the next event if required. The flag is
+    // set first to avoid an infinite recursion (one level only).
     if (!_time_all && _last_tdt.isValid() && !_last_tdt_reported) {
         _last_tdt_reported = true;
-        report(_last_tdt_pkt, u"TDT: %s UTC", {_last_tdt.utc_time.format(Time::DATE | Time::TIME)});
+        Event tdt;
+        tdt.pkt = _last_tdt_pkt;
+        tdt.type = EV_TEXT;
+        tdt.text.format(u"TDT: %s UTC", {_last_tdt.utc_time.format(Time::DATE | Time::TIME)});
+        enqueueEvent(tdt, wait);
     }
 
+    // Store the event in the ring. The indexes are free running, the
+    // difference is the number of queued events.
+    size_t in = _ev_in.load(std::memory_order_relaxed);
+    while (in - _ev_out.load(std::memory_order_acquire) >= _events.size()) {
+        if (!wait) {
+            // Ring full on the packet path, drop the event.
+            _ev_dropped++;
+            return;
+        }
+        SleepThread(EVENT_POLL_INTERVAL);
+    }
+    _events[in % _events.size()] = ev;
+    _ev_in.store(in + 1, std::memory_order_release);
+}
+
+
+//----------------------------------------------------------------------------
+// Implementation of the formatter thread.
+//----------------------------------------------------------------------------
+
+void ts::HistoryPlugin::main()
+{
+    for (;;) {
+        const size_t out = _ev_out.load(std::memory_order_relaxed);
+        if (out != _ev_in.load(std::memory_order_acquire)) {
+            // One event is available, format and release its slot.
+            Event& ev(_events[out % _events.size()]);
+            emitEvent(ev);
+            ev.text.clear();
+            _ev_out.store(out + 1, std::memory_order_release);
+        }
+        else if (_ev_stop.load(std::memory_order_acquire)) {
+            // The ring is empty and the plugin is stopping.
+            break;
+        }
+        else {
+            // The ring is empty, wait for more events.
+            SleepThread(EVENT_POLL_INTERVAL);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Format and output one event (formatter thread only).
+//----------------------------------------------------------------------------
+
+void ts::HistoryPlugin::emitEvent(const Event& ev)
+{
+    // Binary events are logged as packed records when a binary log is open.
+    if (_binfile.is_open() && ev.type != EV_TEXT) {
+        uint8_t rec[BINARY_RECORD_SIZE];
+        PutUInt64(rec, ev.pkt);
+        PutUInt64(rec + 8, ev.pkt2);
+        PutUInt8(rec + 16, ev.type);
+        PutUInt16(rec + 17, ev.pid);
+        PutUInt16(rec + 19, ev.service_id);
+        PutUInt8(rec + 21, ev.scrambling);
+        PutUInt8(rec + 22, ev.old_scr);
+        // Report the previous stream id only on a change, the current one otherwise.
+        PutUInt8(rec + 23, ev.type == EV_PES_ID_CHANGE ? ev.old_strid : ev.stream_id);
+        _binfile.write(reinterpret_cast<const char*>(rec), BINARY_RECORD_SIZE);
+        return;
+    }
+
+    switch (ev.type) {
+        case EV_TEXT: {
+            emitLine(ev.pkt, ev.text);
+            break;
+        }
+        case EV_FIRST_PKT: {
+            emitLine(ev.pkt, UString::Format(u"PID %d (0x%X) first packet, %s", {ev.pid, ev.pid, ev.scrambling ? u"scrambled" : u"clear"}));
+            break;
+        }
+        case EV_SUSPEND_RESTART: {
+            emitLine(ev.pkt2, UString::Format(u"PID %d (0x%X) suspended, %s, service 0x%X", {ev.pid, ev.pid, ev.old_scr ? u"scrambled" : u"clear", ev.service_id}));
+            emitLine(ev.pkt, UString::Format(u"PID %d (0x%X) restarted, %s, service 0x%04X", {ev.pid, ev.pid, ev.scrambling ? u"scrambled" : u"clear", ev.service_id}));
+            break;
+        }
+        case EV_CLEAR_TO_SCRAMB: {
+            emitLine(ev.pkt, UString::Format(u"PID %d (0x%X), clear to scrambled transition, %s key, service 0x%X", {ev.pid, ev.pid, names::ScramblingControl(ev.scrambling), ev.service_id}));
+            break;
+        }
+        case EV_SCRAMB_TO_CLEAR: {
+            emitLine(ev.pkt, UString::Format(u"PID %d (0x%X), scrambled to clear transition, service 0x%X", {ev.pid, ev.pid, ev.service_id}));
+            break;
+        }
+        case EV_CRYPTO_PERIOD: {
+            emitLine(ev.pkt, UString::Format(u"PID %d (0x%X), new crypto-period, %s key, service 0x%X", {ev.pid, ev.pid, names::ScramblingControl(ev.scrambling), ev.service_id}));
+            break;
+        }
+        case EV_PES_FIRST_ID: {
+            emitLine(ev.pkt, UString::Format(u"PID %d (0x%X), PES stream_id is %s", {ev.pid, ev.pid, names::StreamId(ev.stream_id, names::FIRST)}));
+            break;
+        }
+        case EV_PES_ID_CHANGE: {
+            emitLine(ev.pkt, UString::Format(u"PID %d (0x%X), PES stream_id modified from 0x%X to %s", {ev.pid, ev.pid, ev.old_strid, names::StreamId(ev.stream_id, names::FIRST)}));
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Output one formatted history line (formatter thread only).
+//----------------------------------------------------------------------------
+
+void ts::HistoryPlugin::emitLine(PacketCounter pkt, const UString& line)
+{
     // Convert pkt number in playback time when necessary.
     if (_use_milliseconds) {
         pkt = PacketInterval(tsp->bitrate(), pkt);
@@ -543,9 +837,9 @@ void ts::HistoryPlugin::report(PacketCounter pkt, const UChar* fmt, const std::i
 
     // Then report the message.
     if (_outfile.is_open()) {
-        _outfile << UString::Format(u"%d: ", {pkt}) << UString::Format(fmt, args) << std::endl;
+        _outfile << UString::Format(u"%d: ", {pkt}) << line << std::endl;
     }
     else {
-        tsp->info(u"%d: %s", {pkt, UString::Format(fmt, args)});
+        tsp->info(u"%d: %s", {pkt, line});
     }
 }
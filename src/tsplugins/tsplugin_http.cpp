@@ -39,8 +39,6 @@
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
 
-#define DEFAULT_MAX_QUEUED_PACKETS  1000    // Default size in packet of the inter-thread queue.
-
 
 //----------------------------------------------------------------------------
 // Plugin definition
@@ -54,15 +52,20 @@ namespace ts {
         // Implementation of plugin API
         HttpInput(TSP*);
         virtual bool getOptions() override;
-        virtual void processInput() override;
+        virtual bool start() override;
         virtual bool setReceiveTimeout(MilliSecond timeout) override;
 
+    protected:
+        // Implementation of AbstractHTTPInputPlugin
+        virtual bool openURL(WebRequest& request) override;
+
     private:
         size_t         _repeat_count;
         bool           _ignore_errors;
         MilliSecond    _reconnect_delay;
         UString        _url;
         WebRequestArgs _web_args;
+        size_t         _transfer_count;
     };
 }
 
@@ -80,7 +83,8 @@ ts::HttpInput::HttpInput(TSP* tsp_) :
     _ignore_errors(false),
     _reconnect_delay(0),
     _url(),
-    _web_args()
+    _web_args(),
+    _transfer_count(0)
 {
     _web_args.defineArgs(*this);
 
@@ -100,9 +104,9 @@ ts::HttpInput::HttpInput(TSP* tsp_) :
 
     option(u"max-queue", 0, POSITIVE);
     help(u"max-queue",
-         u"Specify the maximum number of queued TS packets before their "
-         u"insertion into the stream. The default is " +
-         UString::Decimal(DEFAULT_MAX_QUEUED_PACKETS) + u".");
+         u"Obsolete option, no longer used. The content is now received "
+         u"directly into the transport stream buffers, without intermediate "
+         u"queue. The option is accepted for compatibility only.");
 
     option(u"reconnect-delay", 0, UNSIGNED);
     help(u"reconnect-delay",
@@ -130,13 +134,23 @@ bool ts::HttpInput::getOptions()
     _ignore_errors = present(u"ignore-errors");
     _web_args.loadArgs(duck, *this);
 
-    // Resize the inter-thread packet queue.
-    setQueueSize(intValue<size_t>(u"max-queue", DEFAULT_MAX_QUEUED_PACKETS));
-
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Start method
+//----------------------------------------------------------------------------
+
+bool ts::HttpInput::start()
+{
+    _transfer_count = 0;
+
+    // Invoke superclass.
+    return AbstractHTTPInputPlugin::start();
+}
+
+
 //----------------------------------------------------------------------------
 // Set receive timeout from tsp.
 //----------------------------------------------------------------------------
@@ -151,26 +165,25 @@ bool ts::HttpInput::setReceiveTimeout(MilliSecond timeout)
 
 
 //----------------------------------------------------------------------------
-// Input method. Executed in a separate thread.
+// Open the URL of the next transfer.
 //----------------------------------------------------------------------------
 
-void ts::HttpInput::processInput()
+bool ts::HttpInput::openURL(WebRequest& request)
 {
-    bool ok = true;
+    // Check max number of transfers and error on the previous one.
+    if (_transfer_count >= _repeat_count || (!previousTransferSuccess() && !_ignore_errors)) {
+        return false;
+    }
+
+    // Wait between reconnections.
+    if (_transfer_count > 0 && _reconnect_delay > 0) {
+        SleepThread(_reconnect_delay);
+    }
+    _transfer_count++;
 
-    // Create a Web request to download the content.
-    WebRequest request(*tsp);
+    // The URL is re-opened each time and the content may be different.
     request.setURL(_url);
     request.setAutoRedirect(true);
     request.setArgs(_web_args);
-
-    // Loop on request count.
-    for (size_t count = 0; count < _repeat_count && (ok || _ignore_errors) && !tsp->aborting(); count++) {
-        // Wait between reconnections.
-        if (count > 0 && _reconnect_delay > 0) {
-            SleepThread(_reconnect_delay);
-        }
-        // Perform one download.
-        ok = request.downloadToApplication(this);
-    }
+    return true;
 }
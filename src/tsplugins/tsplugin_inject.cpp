@@ -456,7 +456,7 @@ ts::ProcessorPlugin::Status ts::InjectPlugin::processPacket(TSPacket& pkt, TSPac
         }
         else {
             _pzer.setBitRate(_pid_bitrate);
-            tsp->debug(u"transport bitrate: %'d b/s, new PID bitrate: %'d b/s", {ts_bitrate, _pid_bitrate});
+            TS_DEBUG(*tsp, u"transport bitrate: %'d b/s, new PID bitrate: %'d b/s", {ts_bitrate, _pid_bitrate});
         }
         _pid_packet_count = 0;
         _packet_count = 0;
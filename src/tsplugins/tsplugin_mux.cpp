@@ -39,6 +39,8 @@
 #include "tsMemory.h"
 TSDUCK_SOURCE;
 
+#define DEFAULT_MAX_BURST 16  // Default maximum number of packets per insertion burst.
+
 
 //----------------------------------------------------------------------------
 // Plugin definition
@@ -64,6 +66,10 @@ namespace ts {
         bool          _force_pid;             // PID value to force
         PID           _force_pid_value;       // PID value to force
         BitRate       _bitrate;               // Target bitrate for inserted packets
+        BitRate       _ts_bitrate;            // Transport stream bitrate, sampled on first packet
+        uint64_t      _credit;                // Deficit counter for --bitrate, in bits
+        uint64_t      _max_credit;            // Maximum accumulated credit (bounds insertion bursts)
+        PacketCounter _max_burst;             // Maximum number of packets per insertion burst
         PacketCounter _inter_pkt;             // # TS packets between 2 new PID packets
         PacketCounter _pid_next_pkt;          // Next time to insert a packet
         PacketCounter _packet_count;          // TS packet counter
@@ -100,6 +106,10 @@ ts::MuxPlugin::MuxPlugin(TSP* tsp_) :
     _force_pid(false),
     _force_pid_value(PID_NULL),
     _bitrate(0),
+    _ts_bitrate(0),
+    _credit(0),
+    _max_credit(0),
+    _max_burst(0),
     _inter_pkt(0),
     _pid_next_pkt(0),
     _packet_count(0),
@@ -122,6 +132,8 @@ ts::MuxPlugin::MuxPlugin(TSP* tsp_) :
     option(u"bitrate", 'b', UINT32);
     help(u"bitrate",
          u"Specifies the bitrate for the inserted packets, in bits/second. "
+         u"The insertion is scheduled with a deficit counter so that the "
+         u"target bitrate is met exactly over time, without drift. "
          u"By default, all stuffing packets are replaced which means that "
          u"the bitrate is neither constant nor guaranteed.");
 
@@ -150,6 +162,12 @@ ts::MuxPlugin::MuxPlugin(TSP* tsp_) :
          u"Perform a \"joint termination\" when the file insertion is complete. "
          u"See \"tsp --help\" for more details on \"joint termination\".");
 
+    option(u"max-burst", 0, POSITIVE);
+    help(u"max-burst",
+         u"With --bitrate, specify the maximum number of packets which can be "
+         u"inserted in a burst to catch up with the target bitrate after a period "
+         u"without stuffing. The default is " TS_USTRINGIFY(DEFAULT_MAX_BURST) u" packets.");
+
     option(u"max-insert-count", 0, UNSIGNED);
     help(u"max-insert-count",
          u"Stop inserting packets after this number of packets was inserted.");
@@ -225,6 +243,7 @@ bool ts::MuxPlugin::start()
     _force_pid = present(u"pid");
     _force_pid_value = intValue<PID>(u"pid");
     _bitrate = intValue<BitRate>(u"bitrate", 0);
+    _max_burst = intValue<PacketCounter>(u"max-burst", DEFAULT_MAX_BURST);
     _inter_pkt = intValue<PacketCounter>(u"inter-packet", 0);
     _inter_time = intValue<uint64_t>(u"inter-time", 0);
     _min_pts = intValue<uint64_t>(u"min-pts", 0);
@@ -233,6 +252,9 @@ bool ts::MuxPlugin::start()
     _max_insert_count = intValue<uint64_t>(u"max-insert-count", 0);
     _packet_count = 0;
     _pid_next_pkt = 0;
+    _ts_bitrate = 0;
+    _credit = 0;
+    _max_credit = 0;
     _ts_pids.reset();
     _youngest_pts = 0;
     _pts_last_inserted = 0;
@@ -289,14 +311,14 @@ ts::ProcessorPlugin::Status ts::MuxPlugin::processPacket(TSPacket& pkt, TSPacket
 {
     // Initialization sequences (executed only once).
     if (_packet_count == 0 && _bitrate != 0) {
-        // Compute the inter-packet interval based on the TS bitrate
-        BitRate ts_bitrate = tsp->bitrate();
-        if (ts_bitrate < _bitrate) {
+        // Sample the TS bitrate for the deficit counter.
+        _ts_bitrate = tsp->bitrate();
+        if (_ts_bitrate < _bitrate) {
             tsp->error(u"input bitrate unknown or too low, specify --inter-packet instead of --bitrate");
             return TSP_END;
         }
-        _inter_pkt = ts_bitrate / _bitrate;
-        tsp->verbose(u"transport bitrate: %'d b/s, packet interval: %'d", {ts_bitrate, _inter_pkt});
+        _max_credit = uint64_t(_max_burst) * uint64_t(_ts_bitrate);
+        tsp->verbose(u"transport bitrate: %'d b/s, insertion bitrate: %'d b/s", {_ts_bitrate, _bitrate});
     }
 
     // Count TS
@@ -304,6 +326,16 @@ ts::ProcessorPlugin::Status ts::MuxPlugin::processPacket(TSPacket& pkt, TSPacket
     PID pid = pkt.getPID();
     uint64_t currentpts = 0;
 
+    // With --bitrate, accumulate the insertion credit on each TS packet slot.
+    // Each packet slot earns _bitrate units of credit and one insertion costs
+    // _ts_bitrate units, so the target bitrate is met exactly over time,
+    // without per-packet division. The credit is capped so that, after a
+    // period without stuffing, at most --max-burst packets are inserted
+    // back-to-back instead of flooding all available stuffing.
+    if (_bitrate != 0) {
+        _credit = std::min(_credit + _bitrate, _max_credit);
+    }
+
     // Get time stamp from current packet.
     if (pid == _pts_pid && pkt.hasPTS()) {
         currentpts = pkt.getPTS();
@@ -354,7 +386,13 @@ ts::ProcessorPlugin::Status ts::MuxPlugin::processPacket(TSPacket& pkt, TSPacket
     }
 
     // If not yet time to insert a packet, transmit stuffing
-    if (_packet_count < _pid_next_pkt) {
+    if (_bitrate != 0) {
+        // Deficit counter scheduling: one insertion costs _ts_bitrate units.
+        if (_credit < _ts_bitrate) {
+            return TSP_OK;
+        }
+    }
+    else if (_packet_count < _pid_next_pkt) {
         return TSP_OK;
     }
 
@@ -401,6 +439,9 @@ ts::ProcessorPlugin::Status ts::MuxPlugin::processPacket(TSPacket& pkt, TSPacket
     }
 
     // Next insertion point
+    if (_bitrate != 0) {
+        _credit -= _ts_bitrate;
+    }
     _pid_next_pkt += _inter_pkt;
 
     // Apply labels on muxed packets.
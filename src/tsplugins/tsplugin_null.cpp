@@ -34,6 +34,7 @@
 
 #include "tsPlugin.h"
 #include "tsPluginRepository.h"
+#include "tsNullPacketRun.h"
 TSDUCK_SOURCE;
 
 
@@ -69,23 +70,27 @@ TSPLUGIN_DECLARE_INPUT(null, ts::NullInput)
 // Constructor
 //----------------------------------------------------------------------------
 
+// Command line options, built once at compile time.
+namespace {
+    const ts::Args::OptionDeclaration NullInputOptions[] = {
+        {u"", 0, ts::Args::UNSIGNED, 0, 1, 0, 0, false, 0, nullptr,
+         u"Specify the number of null packets to generate. After the last packet, "
+         u"an end-of-file condition is generated. By default, if count is not "
+         u"specified, null packets are generated endlessly."},
+        {u"joint-termination", u'j', ts::Args::NONE, 0, 0, 0, 0, false, 0, nullptr,
+         u"When the number of null packets is specified, perform a \"joint "
+         u"termination\" when completed instead of unconditional termination. "
+         u"See \"tsp --help\" for more details on \"joint termination\"."},
+    };
+}
+
 ts::NullInput::NullInput(TSP* tsp_) :
     InputPlugin(tsp_, u"Generate null packets", u"[options] [count]"),
     _max_count(0),
     _count(0),
     _limit(0)
 {
-    option(u"", 0, UNSIGNED, 0, 1);
-    help(u"",
-         u"Specify the number of null packets to generate. After the last packet, "
-         u"an end-of-file condition is generated. By default, if count is not "
-         u"specified, null packets are generated endlessly.");
-
-    option(u"joint-termination", 'j');
-    help(u"joint-termination",
-         u"When the number of null packets is specified, perform a \"joint "
-         u"termination\" when completed instead of unconditional termination. "
-         u"See \"tsp --help\" for more details on \"joint termination\".");
+    options(NullInputOptions);
 }
 
 
@@ -142,8 +147,15 @@ size_t ts::NullInput::receive (TSPacket* buffer, TSPacketMetadata* pkt_data, siz
         _limit = std::numeric_limits<PacketCounter>::max();
     }
 
-    // Fill buffer
-    size_t n;
-    for (n = 0; n < max_packets && _count++ < _limit; buffer[n++] = NullPacket) {}
+    // Fill buffer with the preformed run of null packets.
+    size_t n = max_packets;
+    if (_count >= _limit) {
+        n = 0;
+    }
+    else if (_limit - _count < n) {
+        n = size_t(_limit - _count);
+    }
+    FillNullPackets(buffer, n);
+    _count += n;
     return n;
 }
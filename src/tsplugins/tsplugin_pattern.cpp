@@ -51,11 +51,13 @@ namespace ts {
         PatternPlugin(TSP*);
         virtual bool start() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual bool isStateless() override {return true;}
 
     private:
         uint8_t   _offset_pusi;      // Start offset in packets with PUSI
         uint8_t   _offset_non_pusi;  // Start offset in packets without PUSI
         ByteBlock _pattern;          // Binary pattern to apply
+        ByteBlock _patternImage;     // Pattern, repeated to one packet size
         PIDSet    _pid_list;         // Array of pid values to filter
     };
 }
@@ -73,6 +75,7 @@ ts::PatternPlugin::PatternPlugin(TSP* tsp_) :
     _offset_pusi(0),
     _offset_non_pusi(0),
     _pattern(),
+    _patternImage(),
     _pid_list()
 {
     option(u"", 0, STRING, 1, 1);
@@ -125,6 +128,13 @@ bool ts::PatternPlugin::start()
         return false;
     }
 
+    // Precompute the pattern, repeated over one packet size, so that the
+    // payload replacement is one single memcpy per packet.
+    _patternImage.clear();
+    while (_patternImage.size() < PKT_SIZE) {
+        _patternImage.append(_pattern.data(), std::min(_pattern.size(), PKT_SIZE - _patternImage.size()));
+    }
+
     return true;
 }
 
@@ -146,12 +156,9 @@ ts::ProcessorPlugin::Status ts::PatternPlugin::processPacket(TSPacket& pkt, TSPa
     // Compute remaining size to replace (maybe negative if starting offset is beyond the end of the packet).
     int remain = int(pkt.b + PKT_SIZE - pl);
 
-    // Replace the payload with the pattern
-    while (remain > 0) {
-        int cursize = std::min(remain, int(_pattern.size()));
-        ::memcpy(pl, _pattern.data(), cursize);  // Flawfinder: ignore: memcpy()
-        pl += cursize;
-        remain -= cursize;
+    // Replace the payload with the precomputed pattern image
+    if (remain > 0) {
+        ::memcpy(pl, _patternImage.data(), remain);  // Flawfinder: ignore: memcpy()
     }
 
     return TSP_OK;
@@ -96,15 +96,43 @@ namespace ts {
         typedef SafePtr<PIDContext> PIDContextPtr;
         typedef std::map<PID, PIDContextPtr> PIDContextMap;
 
+        // Rate correction engine. The division of PCR extrapolation by the
+        // bitrate is precomputed as a multiply-shift fixed-point factor, once
+        // per bitrate value. All PCR, PTS and DTS computations of all packets
+        // of a window with a stable bitrate then share the same factor and
+        // avoid per-packet 64-bit divisions.
+        class RateCorrection
+        {
+        public:
+            // Constructor.
+            RateCorrection();
+
+            // Precompute the correction factor when the bitrate changes.
+            void setBitrate(BitRate bitrate);
+
+            // Get the bitrate of the current window (zero if unknown).
+            BitRate bitrate() const { return _bitrate; }
+
+            // Compute the PCR of a packet at some distance of a packet with a known PCR.
+            // Same semantics as ts::NextPCR(), without the division in the common case.
+            uint64_t extrapolatePCR(uint64_t last_pcr, PacketCounter distance) const;
+
+        private:
+            BitRate       _bitrate;       // Bitrate of the current window.
+            uint64_t      _factor;        // PCR ticks per packet, fixed point.
+            PacketCounter _max_distance;  // Max distance without overflow in the multiplication.
+        };
+
         // PCRAdjustPlugin private members
-        BitRate       _user_bitrate;      // User-specified bitrate.
-        PIDSet        _pids;              // User-specified list of PIDs.
-        bool          _ignore_dts;        // Do not modify DTS values.
-        bool          _ignore_pts;        // Do not modify PTS values.
-        bool          _ignore_scrambled;  // Do not modify scrambled PID's.
-        uint64_t      _min_pcr_interval;  // Minimum interval between two PCR's. Ignored if zero.
-        SectionDemux  _demux;             // Section demux to get service descriptions.
-        PIDContextMap _pid_contexts;      // Map of all PID contexts.
+        BitRate        _user_bitrate;      // User-specified bitrate.
+        PIDSet         _pids;              // User-specified list of PIDs.
+        bool           _ignore_dts;        // Do not modify DTS values.
+        bool           _ignore_pts;        // Do not modify PTS values.
+        bool           _ignore_scrambled;  // Do not modify scrambled PID's.
+        uint64_t       _min_pcr_interval;  // Minimum interval between two PCR's. Ignored if zero.
+        SectionDemux   _demux;             // Section demux to get service descriptions.
+        PIDContextMap  _pid_contexts;      // Map of all PID contexts.
+        RateCorrection _rate;              // Shared rate correction for the current window.
 
         // TableHandlerInterface implementation.
         virtual void handleTable(SectionDemux&, const BinaryTable&) override;
@@ -135,10 +163,10 @@ namespace ts {
             uint64_t lastPCR() const;
 
             // Compute the theoretical updated PCR at the given packet index. INVALID_PCR if unknown.
-            uint64_t updatedPCR(PacketCounter packet_index, BitRate bitrate) const;
+            uint64_t updatedPCR(PacketCounter packet_index, const RateCorrection& rate) const;
 
             // Compute an updated PTS or DTS at the given packet index. Unchanged if unknown.
-            uint64_t updatedPDTS(PacketCounter packet_index, BitRate bitrate, uint64_t original_pdts);
+            uint64_t updatedPDTS(PacketCounter packet_index, const RateCorrection& rate, uint64_t original_pdts);
         };
     };
 }
@@ -160,7 +188,8 @@ ts::PCRAdjustPlugin::PCRAdjustPlugin(TSP* tsp_) :
     _ignore_scrambled(false),
     _min_pcr_interval(0),
     _demux(duck, this),
-    _pid_contexts()
+    _pid_contexts(),
+    _rate()
 {
     option(u"bitrate", 'b', POSITIVE);
     help(u"bitrate",
@@ -229,6 +258,57 @@ bool ts::PCRAdjustPlugin::start()
 }
 
 
+//----------------------------------------------------------------------------
+// Rate correction engine.
+//----------------------------------------------------------------------------
+
+// Number of fractional bits in the fixed-point factor. The accumulated error
+// of an extrapolation over N packets is less than N / 2^20 PCR ticks, less
+// than one 27 MHz tick over a million packets.
+#define PCR_FACTOR_SHIFT 20
+
+ts::PCRAdjustPlugin::RateCorrection::RateCorrection() :
+    _bitrate(0),
+    _factor(0),
+    _max_distance(0)
+{
+}
+
+void ts::PCRAdjustPlugin::RateCorrection::setBitrate(BitRate bitrate)
+{
+    if (bitrate != _bitrate) {
+        _bitrate = bitrate;
+        if (bitrate == 0) {
+            _factor = 0;
+            _max_distance = 0;
+        }
+        else {
+            // PCR ticks per packet, with PCR_FACTOR_SHIFT fractional bits.
+            _factor = ((TS_UCONST64(8) * PKT_SIZE * SYSTEM_CLOCK_FREQ) << PCR_FACTOR_SHIFT) / bitrate;
+            _max_distance = std::numeric_limits<uint64_t>::max() / _factor;
+        }
+    }
+}
+
+uint64_t ts::PCRAdjustPlugin::RateCorrection::extrapolatePCR(uint64_t last_pcr, PacketCounter distance) const
+{
+    if (last_pcr == INVALID_PCR || _factor == 0) {
+        return INVALID_PCR;
+    }
+    else if (distance > _max_distance) {
+        // The multiplication would overflow (huge distance), use the exact division.
+        return NextPCR(last_pcr, distance, _bitrate);
+    }
+    else {
+        uint64_t next_pcr = last_pcr + ((distance * _factor) >> PCR_FACTOR_SHIFT);
+        if (next_pcr >= PCR_SCALE) {
+            next_pcr -= PCR_SCALE;
+        }
+        return next_pcr;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Description of one PID.
 //----------------------------------------------------------------------------
@@ -273,15 +353,15 @@ uint64_t ts::PCRAdjustPlugin::PIDContext::lastPCR() const
 // Compute the theoretical updated PCR at the given packet index.
 //----------------------------------------------------------------------------
 
-uint64_t ts::PCRAdjustPlugin::PIDContext::updatedPCR(PacketCounter packet_index, BitRate bitrate) const
+uint64_t ts::PCRAdjustPlugin::PIDContext::updatedPCR(PacketCounter packet_index, const RateCorrection& rate) const
 {
     if (last_updated_pcr != INVALID_PCR && (last_created_pcr == INVALID_PCR || last_created_packet < last_pcr_packet)) {
         // The most recent is an original packet with a previous PCR.
-        return NextPCR(last_updated_pcr, packet_index - last_pcr_packet, bitrate);
+        return rate.extrapolatePCR(last_updated_pcr, packet_index - last_pcr_packet);
     }
     else if (last_created_pcr != INVALID_PCR && (last_updated_pcr == INVALID_PCR || last_pcr_packet < last_created_packet)) {
         // The most recent is a PCR we created in a null packet.
-        return NextPCR(last_created_pcr, packet_index - last_created_packet, bitrate);
+        return rate.extrapolatePCR(last_created_pcr, packet_index - last_created_packet);
     }
     else {
         // No previous PCR was found, no reference.
@@ -294,7 +374,7 @@ uint64_t ts::PCRAdjustPlugin::PIDContext::updatedPCR(PacketCounter packet_index,
 // Compute an updated PTS or DTS at the given packet index.
 //----------------------------------------------------------------------------
 
-uint64_t ts::PCRAdjustPlugin::PIDContext::updatedPDTS(PacketCounter packet_index, BitRate bitrate, uint64_t original_pdts)
+uint64_t ts::PCRAdjustPlugin::PIDContext::updatedPDTS(PacketCounter packet_index, const RateCorrection& rate, uint64_t original_pdts)
 {
     // If the PCR PID is unknown, we cannot compute anything and keep the original PTS/DTS.
     if (pcr_ctx.isNull()) {
@@ -302,7 +382,7 @@ uint64_t ts::PCRAdjustPlugin::PIDContext::updatedPDTS(PacketCounter packet_index
     }
 
     // Estimated updated PCR for the current packet:
-    const uint64_t updated_pcr = pcr_ctx->updatedPCR(packet_index, bitrate);
+    const uint64_t updated_pcr = pcr_ctx->updatedPCR(packet_index, rate);
     if (updated_pcr == INVALID_PCR) {
         // There is no PCR found yet in the PCR PID, cannot compute a new PTS/DTS.
         return original_pdts;
@@ -325,7 +405,7 @@ uint64_t ts::PCRAdjustPlugin::PIDContext::updatedPDTS(PacketCounter packet_index
     else {
         // The difference between the PTS/DTS and the PCR is too high, update the PTS/DTS.
         // First, compute the original PCR for this packet:
-        const uint64_t original_pcr = NextPCR(pcr_ctx->last_original_pcr, packet_index - pcr_ctx->last_pcr_packet, bitrate);
+        const uint64_t original_pcr = rate.extrapolatePCR(pcr_ctx->last_original_pcr, packet_index - pcr_ctx->last_pcr_packet);
 
         // Compute the difference between the original PTS and the original PCR.
         const int64_t diff = int64_t(original_pdts) - int64_t(original_pcr / SYSTEM_CLOCK_SUBFACTOR);
@@ -407,7 +487,9 @@ ts::ProcessorPlugin::Status ts::PCRAdjustPlugin::processPacket(TSPacket& pkt, TS
     ctx->last_cc = pkt.getCC();
 
     // Get reference bitrate value (cannot do anything if zero).
+    // The rate correction factor is recomputed only when the bitrate changes.
     const BitRate bitrate = _user_bitrate != 0 ? _user_bitrate : tsp->bitrate();
+    _rate.setBitrate(bitrate);
 
     // Only process packets from selected PID's (all by default).
     if (bitrate != 0 && _pids.test(pid) && (!ctx->scrambled || !_ignore_scrambled)) {
@@ -425,7 +507,7 @@ ts::ProcessorPlugin::Status ts::PCRAdjustPlugin::processPacket(TSPacket& pkt, TS
             }
             else {
                 // A previous PCR value was known in the PID. Compute the new PCR from the previous one.
-                const uint64_t pcr = ctx->updatedPCR(current_packet, bitrate);
+                const uint64_t pcr = ctx->updatedPCR(current_packet, _rate);
                 pkt.setPCR(pcr);
                 ctx->last_updated_pcr = pcr;
             }
@@ -434,12 +516,12 @@ ts::ProcessorPlugin::Status ts::PCRAdjustPlugin::processPacket(TSPacket& pkt, TS
 
         // Process PTS.
         if (!_ignore_pts && pkt.hasPTS()) {
-            pkt.setPTS(ctx->updatedPDTS(current_packet, bitrate, pkt.getPTS()));
+            pkt.setPTS(ctx->updatedPDTS(current_packet, _rate, pkt.getPTS()));
         }
 
         // Process DTS.
         if (!_ignore_dts && pkt.hasDTS()) {
-            pkt.setDTS(ctx->updatedPDTS(current_packet, bitrate, pkt.getDTS()));
+            pkt.setDTS(ctx->updatedPDTS(current_packet, _rate, pkt.getDTS()));
         }
     }
 
@@ -456,7 +538,7 @@ ts::ProcessorPlugin::Status ts::PCRAdjustPlugin::processPacket(TSPacket& pkt, TS
             // Consider only PID's which contain PCR, ie. which are their own PCR reference.
             if (!cur_ctx.isNull() && !cur_ctx->pcr_ctx.isNull() && cur_ctx->pid == cur_ctx->pcr_ctx->pid) {
                 const uint64_t last_pcr = cur_ctx->lastPCR();
-                const uint64_t updated_pcr = cur_ctx->updatedPCR(current_packet, bitrate);
+                const uint64_t updated_pcr = cur_ctx->updatedPCR(current_packet, _rate);
                 if (last_pcr != INVALID_PCR && updated_pcr != INVALID_PCR && updated_pcr > last_pcr) {
                     const uint64_t delay = updated_pcr - last_pcr;
                     if (delay > _min_pcr_interval && delay > pcr_delay) {
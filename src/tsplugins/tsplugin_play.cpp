@@ -39,7 +39,7 @@
 #include "tsRegistry.h"
 TSDUCK_SOURCE;
 
-// Pipe buffer size is used on Windows only.
+// Pipe buffer size is used on Windows and Linux only.
 #define PIPE_BUFFER_SIZE 65536
 
 
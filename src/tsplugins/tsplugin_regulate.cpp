@@ -99,10 +99,27 @@ ts::RegulatePlugin::RegulatePlugin(TSP* tsp_) :
          u"With --pcr-synchronous, specify the reference PID for PCR's. By default, "
          u"use the first PID containing PCR's.");
 
+    option(u"precise");
+    help(u"precise",
+         u"Use a precise output timing: request a finer timer precision from the "
+         u"operating system, emit smaller bursts and absorb the residual wake-up "
+         u"jitter with a short spin, bounded by the timer precision. This reduces "
+         u"the emission jitter at high bitrates at the expense of some CPU load. "
+         u"Cannot be used with --pcr-synchronous.");
+
     option(u"wait-min", 'w', POSITIVE);
     help(u"wait-min",
          u"With --pcr-synchronous, specify the minimum wait time in milli-seconds. "
          u"The default is " + UString::Decimal(PCRRegulator::DEFAULT_MIN_WAIT_NS / NanoSecPerMilliSec) + u" ms.");
+
+    option(u"wakeup-grid", 0, POSITIVE);
+    help(u"wakeup-grid",
+         u"With --pcr-synchronous, align the wait deadlines on a process-wide time "
+         u"grid with the specified quantum in milli-seconds. All regulated streams "
+         u"of the same process using the same quantum wake up on common ticks and "
+         u"release their packets in batches per tick, consolidating timer wake-ups "
+         u"at the expense of up to one quantum of release jitter. By default, each "
+         u"stream wakes up on its own schedule.");
 }
 
 
@@ -119,6 +136,8 @@ bool ts::RegulatePlugin::start()
     const PID pid = intValue<PID>(u"pid-pcr", PID_NULL);
     const PacketCounter burst = intValue<PacketCounter>(u"packet-burst", DEF_PACKET_BURST);
     const MilliSecond wait_min = intValue<MilliSecond>(u"wait-min", PCRRegulator::DEFAULT_MIN_WAIT_NS / NanoSecPerMilliSec);
+    const bool precise = present(u"precise");
+    const MilliSecond wakeup_grid = intValue<MilliSecond>(u"wakeup-grid", 0);
 
     if (has_bitrate && _pcr_synchronous) {
         tsp->error(u"--bitrate cannot be used with --pcr-synchronous");
@@ -128,6 +147,14 @@ bool ts::RegulatePlugin::start()
         tsp->error(u"--pid-pcr cannot be used without --pcr-synchronous");
         return false;
     }
+    if (precise && _pcr_synchronous) {
+        tsp->error(u"--precise cannot be used with --pcr-synchronous");
+        return false;
+    }
+    if (wakeup_grid > 0 && !_pcr_synchronous) {
+        tsp->error(u"--wakeup-grid cannot be used without --pcr-synchronous");
+        return false;
+    }
 
     // Initialize the appropriate regulator.
     if (_pcr_synchronous) {
@@ -135,10 +162,12 @@ bool ts::RegulatePlugin::start()
         _pcr_regulator.setBurstPacketCount(burst);
         _pcr_regulator.setReferencePID(pid);
         _pcr_regulator.setMinimimWait(wait_min * NanoSecPerMilliSec);
+        _pcr_regulator.setWakeupGrid(wakeup_grid * NanoSecPerMilliSec);
     }
     else {
         _bitrate_regulator.setBurstPacketCount(burst);
         _bitrate_regulator.setFixedBitRate(bitrate);
+        _bitrate_regulator.setPreciseMode(precise);
         _bitrate_regulator.start();
     }
     return true;
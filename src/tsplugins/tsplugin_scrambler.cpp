@@ -37,6 +37,7 @@
 #include "tsServiceDiscovery.h"
 #include "tsTSScrambling.h"
 #include "tsByteBlock.h"
+#include "tsSafePtr.h"
 #include "tsCyclingPacketizer.h"
 #include "tsOneShotPacketizer.h"
 #include "tsECMGClient.h"
@@ -91,11 +92,19 @@ TSDUCK_SOURCE;
 // is negative, we immediately perform an ECM transition and we recompute the
 // time for the next CW transition. If delay_start is positive, we immediately
 // perform a CW transition and we recompute the time for the next ECM transition.
+//
+// Notes on multiple services:
+//
+// Several services can be scrambled in the same tsp instance. Each service
+// is handled by a ServiceContext object with its own scrambling engine, its
+// own ECMG session, its own ECM stream and its own crypto-period scheduling.
+// The services share no crypto state and their crypto-periods drift
+// independently. Since each ECMG session receives its responses in its own
+// handler thread, ECM generation for the various services naturally runs in
+// parallel with the packet processing.
 
 namespace ts {
-    class ScramblerPlugin:
-        public ProcessorPlugin,
-        private SignalizationHandlerInterface
+    class ScramblerPlugin: public ProcessorPlugin
     {
         TS_NOBUILD_NOCOPY(ScramblerPlugin);
     public:
@@ -107,8 +116,11 @@ namespace ts {
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
+        // Each scrambled service is described by a ServiceContext (see below).
+        class ServiceContext;
+
         // Description of a crypto-period.
-        // Each CryptoPeriod object points to its ScramblerPlugin parent object.
+        // Each CryptoPeriod object points to its ServiceContext parent object.
         // In case of error in a CryptoPeriod object, the _abort volatile flag
         // is set in ScramblerPlugin.
         class CryptoPeriod: private ECMGClientHandlerInterface
@@ -121,7 +133,7 @@ namespace ts {
             // Initialize first crypto period.
             // Generate two randow CW and corresponding ECM.
             // ECM generation may complete asynchronously.
-            void initCycle(ScramblerPlugin*, uint16_t cp_number);
+            void initCycle(ServiceContext*, uint16_t cp_number);
 
             // Initialize crypto period following specified one.
             // ECM generation may complete asynchronously.
@@ -138,6 +150,7 @@ namespace ts {
 
         private:
             ScramblerPlugin* _plugin;         // Reference to scrambler plugin
+            ServiceContext*  _ctx;            // Reference to the service context
             uint16_t         _cp_number;      // Crypto-period number
             volatile bool    _ecm_ok;         // _ecm field is valid
             TSPacketVector   _ecm;            // Packetized ECM
@@ -154,67 +167,93 @@ namespace ts {
             virtual void handleECM(const ecmgscs::ECMResponse&) override;
         };
 
+        // Description of one scrambled service. When several services are
+        // scrambled in the same tsp instance, each service gets independent
+        // scrambling engine, ECMG session and crypto-period scheduling. The
+        // same structure is used for a fixed list of PID's (without service).
+        // The fields are accessed from the plugin and from CryptoPeriod, they
+        // are public inside this private class.
+        class ServiceContext: private SignalizationHandlerInterface
+        {
+            TS_NOBUILD_NOCOPY(ServiceContext);
+        public:
+            // Constructor.
+            ServiceContext(ScramblerPlugin* plugin);
+
+            // Start / stop the scrambling of this service (from plugin start/stop).
+            bool start();
+            void stop();
+
+            ScramblerPlugin* const _plugin;     // Reference to scrambler plugin
+            ServiceDiscovery  _service;         // Service description
+            bool              _degraded_mode;   // In degraded mode (see comments above)
+            bool              _update_pmt;      // Update PMT.
+            MilliSecond       _delay_start;     // Delay between CP start and ECM start (can be negative)
+            PID               _ecm_pid;         // PID for ECM
+            uint8_t           _ecm_cc;          // Continuity counter in ECM PID.
+            PacketCounter     _scrambled_count; // Scrambled packets in this service
+            PacketCounter     _partial_clear;   // How many clear packets to keep clear
+            PacketCounter     _pkt_insert_ecm;  // Insertion point for next ECM packet.
+            PacketCounter     _pkt_change_cw;   // Transition point for next CW change
+            PacketCounter     _pkt_change_ecm;  // Transition point for next ECM change
+            PIDSet            _scrambled_pids;  // List of pids to scramble
+            PIDSet            _conflict_pids;   // List of pids to scramble with scrambled input packets
+            ecmgscs::ChannelStatus _channel_status; // Initial response to ECMG channel_setup
+            ecmgscs::StreamStatus  _stream_status;  // Initial response to ECMG stream_setup
+            ECMGClient        _ecmg;            // Connection with the ECMG
+            CryptoPeriod      _cp[2];           // Previous/current or current/next crypto-periods
+            size_t            _current_cw;      // Index to current CW (current crypto period)
+            size_t            _current_ecm;     // Index to current ECM (ECM being broadcast)
+            TSScrambling      _scrambling;      // Scrambler of this service
+            CyclingPacketizer _pzer_pmt;        // Packetizer for modified PMT
+
+            // Return current/next CryptoPeriod for CW or ECM
+            CryptoPeriod& currentCW()  { return _cp[_current_cw]; }
+            CryptoPeriod& nextCW()     { return _cp[(_current_cw + 1) & 0x01]; }
+            CryptoPeriod& currentECM() { return _cp[_current_ecm]; }
+            CryptoPeriod& nextECM()    { return _cp[(_current_ecm + 1) & 0x01]; }
+
+            // Perform CW and ECM transition
+            bool changeCW();
+            void changeECM();
+
+            // Check if we are in degraded mode or if we enter degraded mode
+            bool inDegradedMode();
+
+            // Try to exit from degraded mode
+            bool tryExitDegradedMode();
+
+        private:
+            // Invoked when the PMT of the service is available.
+            virtual void handlePMT(const PMT&, PID) override;
+        };
+
+        // Safe pointer to a service context (not thread-safe).
+        typedef SafePtr<ServiceContext> ServiceContextPtr;
+
         // ScramblerPlugin parameters, remain constant after start()
-        ServiceDiscovery  _service;             // Service description
-        bool              _use_service;         // Scramble a service (ie. not a specific list of PID's).
+        bool              _use_service;         // Scramble services (ie. not a specific list of PID's).
         bool              _component_level;     // Insert CA_descriptors at component level
         bool              _scramble_audio;      // Scramble all audio components
         bool              _scramble_video;      // Scramble all video components
         bool              _scramble_subtitles;  // Scramble all subtitles components
         bool              _synchronous_ecmg;    // Synchronous ECM generation
         bool              _ignore_scrambled;    // Ignore packets which are already scrambled
-        bool              _update_pmt;          // Update PMT.
         bool              _need_cp;             // Need to manage crypto-periods (ie. not one single fixed CW).
         bool              _need_ecm;            // Need to manage ECM insertion (ie. not fixed CW's).
-        MilliSecond       _delay_start;         // Delay between CP start and ECM start (can be negative)
         ByteBlock         _ca_desc_private;     // Private data to insert in CA_descriptor
         BitRate           _ecm_bitrate;         // ECM PID's bitrate
-        PID               _ecm_pid;             // PID for ECM
         PacketCounter     _partial_scrambling;  // Do not scramble all packets if > 1
         ECMGClientArgs    _ecmg_args;           // Parameters for ECMG client
         tlv::Logger       _logger;              // Message logger for ECMG <=> SCS protocol
-        ecmgscs::ChannelStatus _channel_status; // Initial response to ECMG channel_setup
-        ecmgscs::StreamStatus  _stream_status;  // Initial response to ECMG stream_setup
+        TSScrambling      _scrambling;          // Used for command line analysis only
 
         // ScramblerPlugin state
         volatile bool     _abort;               // Error (service not found, etc)
-        bool              _degraded_mode;       // In degraded mode (see comments above)
         PacketCounter     _packet_count;        // Complete TS packet counter
-        PacketCounter     _scrambled_count;     // Summary of scrambled packets
-        PacketCounter     _partial_clear;       // How many clear packets to keep clear
-        PacketCounter     _pkt_insert_ecm;      // Insertion point for next ECM packet.
-        PacketCounter     _pkt_change_cw;       // Transition point for next CW change
-        PacketCounter     _pkt_change_ecm;      // Transition point for next ECM change
         BitRate           _ts_bitrate;          // Saved TS bitrate
-        ECMGClient        _ecmg;                // Connection with the ECMG
-        uint8_t           _ecm_cc;              // Continuity counter in ECM PID.
-        PIDSet            _scrambled_pids;      // List of pids to scramble
-        PIDSet            _conflict_pids;       // List of pids to scramble with scrambled input packets
         PIDSet            _input_pids;          // List of input pids
-        CryptoPeriod      _cp[2];               // Previous/current or current/next crypto-periods
-        size_t            _current_cw;          // Index to current CW (current crypto period)
-        size_t            _current_ecm;         // Index to current ECM (ECM being broadcast)
-        TSScrambling      _scrambling;          // Scrambler
-        CyclingPacketizer _pzer_pmt;            // Packetizer for modified PMT
-
-        // Return current/next CryptoPeriod for CW or ECM
-        CryptoPeriod& currentCW()  { return _cp[_current_cw]; }
-        CryptoPeriod& nextCW()     { return _cp[(_current_cw + 1) & 0x01]; }
-        CryptoPeriod& currentECM() { return _cp[_current_ecm]; }
-        CryptoPeriod& nextECM()    { return _cp[(_current_ecm + 1) & 0x01]; }
-
-        // Perform CW and ECM transition
-        bool changeCW();
-        void changeECM();
-
-        // Check if we are in degraded mode or if we enter degraded mode
-        bool inDegradedMode();
-
-        // Try to exit from degraded mode
-        bool tryExitDegradedMode();
-
-        // Invoked when the PMT of the service is available.
-        virtual void handlePMT(const PMT&, PID) override;
+        std::vector<ServiceContextPtr> _contexts; // One context per service to scramble
     };
 }
 
@@ -227,8 +266,7 @@ TSPLUGIN_DECLARE_PROCESSOR(scrambler, ts::ScramblerPlugin)
 //----------------------------------------------------------------------------
 
 ts::ScramblerPlugin::ScramblerPlugin(TSP* tsp_) :
-    ProcessorPlugin(tsp_, u"DVB scrambler", u"[options] [service]"),
-    _service(duck, this),
+    ProcessorPlugin(tsp_, u"DVB scrambler", u"[options] [service ...]"),
     _use_service(false),
     _component_level(false),
     _scramble_audio(false),
@@ -236,47 +274,32 @@ ts::ScramblerPlugin::ScramblerPlugin(TSP* tsp_) :
     _scramble_subtitles(false),
     _synchronous_ecmg(false),
     _ignore_scrambled(false),
-    _update_pmt(false),
     _need_cp(false),
     _need_ecm(false),
-    _delay_start(0),
     _ca_desc_private(),
     _ecm_bitrate(0),
-    _ecm_pid(PID_NULL),
     _partial_scrambling(0),
     _ecmg_args(),
     _logger(Severity::Debug, tsp_),
-    _channel_status(),
-    _stream_status(),
+    _scrambling(*tsp),
     _abort(false),
-    _degraded_mode(false),
     _packet_count(0),
-    _scrambled_count(0),
-    _partial_clear(0),
-    _pkt_insert_ecm(0),
-    _pkt_change_cw(0),
-    _pkt_change_ecm(0),
     _ts_bitrate(0),
-    _ecmg(ASYNC_HANDLER_EXTRA_STACK_SIZE),
-    _ecm_cc(0),
-    _scrambled_pids(),
-    _conflict_pids(),
     _input_pids(),
-    _cp(),
-    _current_cw(0),
-    _current_ecm(0),
-    _scrambling(*tsp),
-    _pzer_pmt()
+    _contexts()
 {
-    option(u"", 0, STRING, 0, 1);
+    option(u"", 0, STRING, 0, UNLIMITED_COUNT);
     help(u"",
-         u"Specifies the optional service to scramble. If no service is specified, a "
+         u"Specifies the optional services to scramble. If no service is specified, a "
          u"list of PID's to scramble must be provided using --pid options. When PID's "
          u"are provided, fixed control words must be specified as well.\n\n"
          u"If no fixed CW is specified, a random CW is generated for each crypto-period "
          u"and ECM's containing the current and next CW's are created and inserted in "
-         u"the stream. ECM's can be created only when a service is specified.\n\n"
-         u"If the argument is an integer value (either decimal or hexadecimal), it is "
+         u"the stream. ECM's can be created only when services are specified.\n\n"
+         u"Several services can be specified. In that case, each service is scrambled "
+         u"independently with its own control words, its own ECM stream and its own "
+         u"session with the ECMG.\n\n"
+         u"If an argument is an integer value (either decimal or hexadecimal), it is "
          u"interpreted as a service id. Otherwise, it is interpreted as a service name, "
          u"as specified in the SDT. The name is not case sensitive and blanks are "
          u"ignored. If the input TS does not contain an SDT, use service ids only.");
@@ -299,12 +322,12 @@ ts::ScramblerPlugin::ScramblerPlugin(TSP* tsp_) :
 
     option(u"no-audio");
     help(u"no-audio",
-         u"Do not scramble audio components in the selected service. By default, "
+         u"Do not scramble audio components in the selected services. By default, "
          u"all audio components are scrambled.");
 
     option(u"no-video");
     help(u"no-video",
-         u"Do not scramble video components in the selected service. By default, "
+         u"Do not scramble video components in the selected services. By default, "
          u"all video components are scrambled.");
 
     option(u"partial-scrambling", 0, POSITIVE);
@@ -317,14 +340,15 @@ ts::ScramblerPlugin::ScramblerPlugin(TSP* tsp_) :
     option(u"pid", 'p', PIDVAL, 0, UNLIMITED_COUNT);
     help(u"pid", u"pid1[-pid2]",
          u"Scramble packets with these PID values. Several -p or --pid options may be "
-         u"specified. By default, scramble the specified service.");
+         u"specified. By default, scramble the specified services.");
 
     option(u"pid-ecm", 0, PIDVAL);
     help(u"pid-ecm",
          u"Specifies the new ECM PID for the service. By defaut, use the first "
          u"unused PID immediately following the PMT PID. Using the default, there "
          u"is a risk to later discover that this PID is already used. In that case, "
-         u"specify --pid-ecm with a notoriously unused PID value.");
+         u"specify --pid-ecm with a notoriously unused PID value. This option can "
+         u"be used only when one single service is scrambled.");
 
     option(u"private-data", 0, STRING);
     help(u"private-data",
@@ -333,7 +357,7 @@ ts::ScramblerPlugin::ScramblerPlugin(TSP* tsp_) :
 
     option(u"subtitles");
     help(u"subtitles",
-         u"Scramble subtitles components in the selected service. By default, the "
+         u"Scramble subtitles components in the selected services. By default, the "
          u"subtitles components are not scrambled.");
 
     option(u"synchronous");
@@ -355,9 +379,11 @@ ts::ScramblerPlugin::ScramblerPlugin(TSP* tsp_) :
 bool ts::ScramblerPlugin::getOptions()
 {
     // Plugin parameters.
-    _use_service = present(u"");
-    _service.set(value(u""));
-    getIntValues(_scrambled_pids, u"pid");
+    UStringVector services;
+    getValues(services, u"");
+    _use_service = !services.empty();
+    PIDSet scrambled_pids;
+    getIntValues(scrambled_pids, u"pid");
     _synchronous_ecmg = present(u"synchronous") || !tsp->realtime();
     _component_level = present(u"component-level");
     _scramble_audio = !present(u"no-audio");
@@ -365,7 +391,7 @@ bool ts::ScramblerPlugin::getOptions()
     _scramble_subtitles = present(u"subtitles");
     _partial_scrambling = intValue<PacketCounter>(u"partial-scrambling", 1);
     _ignore_scrambled = present(u"ignore-scrambled");
-    _ecm_pid = intValue<PID>(u"pid-ecm", PID_NULL);
+    const PID ecm_pid = intValue<PID>(u"pid-ecm", PID_NULL);
     _ecm_bitrate = intValue<BitRate>(u"bitrate-ecm", DEFAULT_ECM_BITRATE);
 
     // Decode hexa data.
@@ -384,22 +410,51 @@ bool ts::ScramblerPlugin::getOptions()
     _logger.setSeverity(ecmgscs::Tags::CW_provision, _ecmg_args.log_data);
     _logger.setSeverity(ecmgscs::Tags::ECM_response, _ecmg_args.log_data);
 
-    // Scramble either a service or a list of PID's, not a mixture of them.
-    if ((_use_service + _scrambled_pids.any()) != 1) {
-        tsp->error(u"specify either a service or a list of PID's");
+    // Scramble either services or a list of PID's, not a mixture of them.
+    if ((_use_service + scrambled_pids.any()) != 1) {
+        tsp->error(u"specify either one or more services or a list of PID's");
         return false;
     }
 
     // To scramble a fixed list of PID's, we need fixed control words, otherwise the random CW's are lost.
-    if (_scrambled_pids.any() && !_scrambling.hasFixedCW()) {
+    if (scrambled_pids.any() && !_scrambling.hasFixedCW()) {
         tsp->error(u"specify control words to scramble an explicit list of PID's");
         return false;
     }
 
+    // With several services, each service needs its own automatically allocated ECM PID.
+    if (ecm_pid != PID_NULL && services.size() > 1) {
+        tsp->error(u"--pid-ecm cannot be used when several services are scrambled");
+        return false;
+    }
+
     // Do we need to manage crypto-periods and ECM insertion?
     _need_cp = _scrambling.fixedCWCount() != 1;
     _need_ecm = _use_service && !_scrambling.hasFixedCW();
 
+    // Create one scrambling context per service. Without service, use one
+    // single context for the fixed list of PID's.
+    _contexts.clear();
+    if (_use_service) {
+        for (size_t i = 0; i < services.size(); ++i) {
+            const ServiceContextPtr ctx(new ServiceContext(this));
+            ctx->_service.set(services[i]);
+            ctx->_ecm_pid = ecm_pid;
+            if (!ctx->_scrambling.loadArgs(duck, *this)) {
+                return false;
+            }
+            _contexts.push_back(ctx);
+        }
+    }
+    else {
+        const ServiceContextPtr ctx(new ServiceContext(this));
+        ctx->_scrambled_pids = scrambled_pids;
+        if (!ctx->_scrambling.loadArgs(duck, *this)) {
+            return false;
+        }
+        _contexts.push_back(ctx);
+    }
+
     // Specify which ECMG <=> SCS version to use.
     ecmgscs::Protocol::Instance()->setVersion(_ecmg_args.dvbsim_version);
     return true;
@@ -413,28 +468,11 @@ bool ts::ScramblerPlugin::getOptions()
 bool ts::ScramblerPlugin::start()
 {
     // Reset states
-    _conflict_pids.reset();
     _packet_count = 0;
-    _scrambled_count = 0;
-    _ecm_cc = 0;
     _abort = false;
-    _degraded_mode = false;
     _ts_bitrate = 0;
-    _pkt_insert_ecm = 0;
-    _pkt_change_cw = 0;
-    _pkt_change_ecm = 0;
-    _partial_clear = 0;
-    _update_pmt = false;
-    _delay_start = 0;
-    _current_cw = 0;
-    _current_ecm = 0;
-
-    // Initialize the scrambling engine.
-    if (!_scrambling.start()) {
-        return false;
-    }
 
-    // Initialize ECMG.
+    // Common sanity checks before connecting the per-service ECMG sessions.
     if (_need_ecm) {
         if (!_ecmg_args.ecmg_address.hasAddress()) {
             // Without fixed control word and ECMG, we cannot do anything.
@@ -445,34 +483,15 @@ bool ts::ScramblerPlugin::start()
             tsp->error(u"--super-cas-id is required with --ecmg");
             return false;
         }
-        else if (!_ecmg.connect(_ecmg_args, _channel_status, _stream_status, tsp, _logger)) {
-            // Error connecting to ECMG, error message already reported
-            return false;
-        }
-        else {
-            // Now correctly connected to ECMG.
-            // Validate delay start (limit to half the crypto-period).
-            _delay_start = MilliSecond(_channel_status.delay_start);
-            if (_delay_start > _ecmg_args.cp_duration / 2 || _delay_start < -_ecmg_args.cp_duration / 2) {
-                tsp->error(u"crypto-period too short for this CAS, must be at least %'d ms.", {2 * std::abs(_delay_start)});
-                return false;
-            }
-            tsp->debug(u"crypto-period duration: %'d ms, delay start: %'d ms", {_ecmg_args.cp_duration, _delay_start});
+    }
 
-            // Create first and second crypto-periods
-            _cp[0].initCycle(this, 0);
-            if (!_cp[0].initScramblerKey()) {
-                return false;
-            }
-            _cp[1].initNext(_cp[0]);
+    // Start all service contexts, each one connects its own ECMG session.
+    for (size_t i = 0; i < _contexts.size(); ++i) {
+        if (!_contexts[i]->start()) {
+            return false;
         }
     }
 
-    // The PMT will be modified, initialize the PMT packetizer.
-    // Note that even without ECMG we may need to add a scrambling_descriptor in the PMT.
-    _pzer_pmt.reset();
-    _pzer_pmt.setStuffingPolicy(CyclingPacketizer::ALWAYS);
-
     // Initialize the list of used pids. Preset reserved PIDs.
     _input_pids.reset();
     _input_pids.set(PID_NULL);
@@ -489,6 +508,99 @@ bool ts::ScramblerPlugin::start()
 //----------------------------------------------------------------------------
 
 bool ts::ScramblerPlugin::stop()
+{
+    // Stop all service contexts, disconnect from the ECMG's.
+    for (size_t i = 0; i < _contexts.size(); ++i) {
+        _contexts[i]->stop();
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Constructor, start and stop of one service context.
+//----------------------------------------------------------------------------
+
+ts::ScramblerPlugin::ServiceContext::ServiceContext(ScramblerPlugin* plugin) :
+    _plugin(plugin),
+    _service(plugin->duck, this),
+    _degraded_mode(false),
+    _update_pmt(false),
+    _delay_start(0),
+    _ecm_pid(PID_NULL),
+    _ecm_cc(0),
+    _scrambled_count(0),
+    _partial_clear(0),
+    _pkt_insert_ecm(0),
+    _pkt_change_cw(0),
+    _pkt_change_ecm(0),
+    _scrambled_pids(),
+    _conflict_pids(),
+    _channel_status(),
+    _stream_status(),
+    _ecmg(ASYNC_HANDLER_EXTRA_STACK_SIZE),
+    _cp(),
+    _current_cw(0),
+    _current_ecm(0),
+    _scrambling(*plugin->tsp),
+    _pzer_pmt()
+{
+}
+
+bool ts::ScramblerPlugin::ServiceContext::start()
+{
+    // Reset states
+    _conflict_pids.reset();
+    _scrambled_count = 0;
+    _ecm_cc = 0;
+    _degraded_mode = false;
+    _pkt_insert_ecm = 0;
+    _pkt_change_cw = 0;
+    _pkt_change_ecm = 0;
+    _partial_clear = 0;
+    _update_pmt = false;
+    _delay_start = 0;
+    _current_cw = 0;
+    _current_ecm = 0;
+
+    // Initialize the scrambling engine of this service.
+    if (!_scrambling.start()) {
+        return false;
+    }
+
+    // Initialize the ECMG session of this service.
+    if (_plugin->_need_ecm) {
+        if (!_ecmg.connect(_plugin->_ecmg_args, _channel_status, _stream_status, _plugin->tsp, _plugin->_logger)) {
+            // Error connecting to ECMG, error message already reported
+            return false;
+        }
+
+        // Now correctly connected to ECMG.
+        // Validate delay start (limit to half the crypto-period).
+        _delay_start = MilliSecond(_channel_status.delay_start);
+        if (_delay_start > _plugin->_ecmg_args.cp_duration / 2 || _delay_start < -_plugin->_ecmg_args.cp_duration / 2) {
+            _plugin->tsp->error(u"crypto-period too short for this CAS, must be at least %'d ms.", {2 * std::abs(_delay_start)});
+            return false;
+        }
+        _plugin->tsp->debug(u"crypto-period duration: %'d ms, delay start: %'d ms", {_plugin->_ecmg_args.cp_duration, _delay_start});
+
+        // Create first and second crypto-periods
+        _cp[0].initCycle(this, 0);
+        if (!_cp[0].initScramblerKey()) {
+            return false;
+        }
+        _cp[1].initNext(_cp[0]);
+    }
+
+    // The PMT will be modified, initialize the PMT packetizer.
+    // Note that even without ECMG we may need to add a scrambling_descriptor in the PMT.
+    _pzer_pmt.reset();
+    _pzer_pmt.setStuffingPolicy(CyclingPacketizer::ALWAYS);
+
+    return true;
+}
+
+void ts::ScramblerPlugin::ServiceContext::stop()
 {
     // Disconnect from ECMG
     if (_ecmg.isConnected()) {
@@ -498,23 +610,22 @@ bool ts::ScramblerPlugin::stop()
     // Terminate the scrambling engine.
     _scrambling.stop();
 
-    tsp->debug(u"scrambled %'d packets in %'d PID's", {_scrambled_count, _scrambled_pids.count()});
-    return true;
+    _plugin->tsp->debug(u"scrambled %'d packets in %'d PID's", {_scrambled_count, _scrambled_pids.count()});
 }
 
 
 //----------------------------------------------------------------------------
-//  This method processes the PMT of the service.
+//  This method processes the PMT of one service.
 //----------------------------------------------------------------------------
 
-void ts::ScramblerPlugin::handlePMT(const PMT& table, PID)
+void ts::ScramblerPlugin::ServiceContext::handlePMT(const PMT& table, PID)
 {
-    assert(_use_service);
+    assert(_plugin->_use_service);
 
     // We need to know the bitrate in order to schedule crypto-periods or ECM insertion.
-    if (_ts_bitrate == 0 && (_need_cp || _need_ecm)) {
-        tsp->error(u"unknown bitrate, cannot schedule crypto-periods");
-        _abort = true;
+    if (_plugin->_ts_bitrate == 0 && (_plugin->_need_cp || _plugin->_need_ecm)) {
+        _plugin->tsp->error(u"unknown bitrate, cannot schedule crypto-periods");
+        _plugin->_abort = true;
         return;
     }
 
@@ -526,59 +637,61 @@ void ts::ScramblerPlugin::handlePMT(const PMT& table, PID)
     for (PMT::StreamMap::const_iterator it = pmt.streams.begin(); it != pmt.streams.end(); ++it) {
         const PID pid = it->first;
         const PMT::Stream& stream(it->second);
-        _input_pids.set(pid);
-        if ((_scramble_audio && stream.isAudio()) || (_scramble_video && stream.isVideo()) || (_scramble_subtitles && stream.isSubtitles())) {
+        _plugin->_input_pids.set(pid);
+        if ((_plugin->_scramble_audio && stream.isAudio()) || (_plugin->_scramble_video && stream.isVideo()) || (_plugin->_scramble_subtitles && stream.isSubtitles())) {
             _scrambled_pids.set(pid);
-            tsp->verbose(u"starting scrambling PID 0x%X", {pid});
+            _plugin->tsp->verbose(u"starting scrambling PID 0x%X", {pid});
         }
     }
 
     // Check that we have somethng to scramble.
     if (_scrambled_pids.none()) {
-        tsp->error(u"no PID to scramble in service");
-        _abort = true;
+        _plugin->tsp->error(u"no PID to scramble in service");
+        _plugin->_abort = true;
         return;
     }
 
     // Allocate a PID value for ECM if necessary
-    if (_need_ecm && _ecm_pid == PID_NULL) {
+    if (_plugin->_need_ecm && _ecm_pid == PID_NULL) {
         // Start at service PMT PID, then look for an unused one.
-        for (_ecm_pid = _service.getPMTPID() + 1; _ecm_pid < PID_NULL && _input_pids.test(_ecm_pid); _ecm_pid++) {}
+        for (_ecm_pid = _service.getPMTPID() + 1; _ecm_pid < PID_NULL && _plugin->_input_pids.test(_ecm_pid); _ecm_pid++) {}
         if (_ecm_pid >= PID_NULL) {
-            tsp->error(u"cannot find an unused PID for ECM, try --pid-ecm");
-            _abort = true;
+            _plugin->tsp->error(u"cannot find an unused PID for ECM, try --pid-ecm");
+            _plugin->_abort = true;
         }
         else {
-            tsp->verbose(u"using PID %d (0x%X) for ECM", {_ecm_pid, _ecm_pid});
+            // Reserve the PID so that the other scrambled services do not allocate it.
+            _plugin->_input_pids.set(_ecm_pid);
+            _plugin->tsp->verbose(u"using PID %d (0x%X) for ECM", {_ecm_pid, _ecm_pid});
         }
     }
 
     // Add a scrambling_descriptor in the PMT for scrambling other than DVB-CSA2.
     if (_scrambling.scramblingType() != SCRAMBLING_DVB_CSA2) {
         _update_pmt = true;
-        pmt.descs.add(duck, ScramblingDescriptor(_scrambling.scramblingType()));
+        pmt.descs.add(_plugin->duck, ScramblingDescriptor(_scrambling.scramblingType()));
     }
 
     // With ECM generation, modify the PMT
-    if (_need_ecm) {
+    if (_plugin->_need_ecm) {
         _update_pmt = true;
 
         // Create a CA_descriptor
-        CADescriptor ca_desc((_ecmg_args.super_cas_id >> 16) & 0xFFFF, _ecm_pid);
-        ca_desc.private_data = _ca_desc_private;
+        CADescriptor ca_desc((_plugin->_ecmg_args.super_cas_id >> 16) & 0xFFFF, _ecm_pid);
+        ca_desc.private_data = _plugin->_ca_desc_private;
 
         // Add the CA_descriptor at program level or component level
-        if (_component_level) {
+        if (_plugin->_component_level) {
             // Add a CA_descriptor in each scrambled component
             for (PMT::StreamMap::iterator it = pmt.streams.begin(); it != pmt.streams.end(); ++it) {
                 if (_scrambled_pids.test(it->first)) {
-                    it->second.descs.add(duck, ca_desc);
+                    it->second.descs.add(_plugin->duck, ca_desc);
                 }
             }
         }
         else {
             // Add one single CA_descriptor at program level
-            pmt.descs.add(duck, ca_desc);
+            pmt.descs.add(_plugin->duck, ca_desc);
         }
     }
 
@@ -586,24 +699,24 @@ void ts::ScramblerPlugin::handlePMT(const PMT& table, PID)
     if (_update_pmt) {
         _pzer_pmt.removeSections(TID_PMT, pmt.service_id);
         _pzer_pmt.setPID(_service.getPMTPID());
-        _pzer_pmt.addTable(duck, pmt);
+        _pzer_pmt.addTable(_plugin->duck, pmt);
     }
 
     // Next crypto-period.
-    if (_need_cp) {
-        _pkt_change_cw = _packet_count + PacketDistance(_ts_bitrate, _ecmg_args.cp_duration);
+    if (_plugin->_need_cp) {
+        _pkt_change_cw = _plugin->_packet_count + PacketDistance(_plugin->_ts_bitrate, _plugin->_ecmg_args.cp_duration);
     }
 
     // Initialize ECM insertion.
-    if (_need_ecm) {
+    if (_plugin->_need_ecm) {
 
         // Insert current ECM packets as soon as possible.
-        _pkt_insert_ecm = _packet_count;
+        _pkt_insert_ecm = _plugin->_packet_count;
 
         // Next ECM may start before or after next crypto-period
         _pkt_change_ecm = _delay_start > 0 ?
-            _pkt_change_cw + PacketDistance(_ts_bitrate, _delay_start) :
-            _pkt_change_cw - PacketDistance(_ts_bitrate, _delay_start);
+            _pkt_change_cw + PacketDistance(_plugin->_ts_bitrate, _delay_start) :
+            _pkt_change_cw - PacketDistance(_plugin->_ts_bitrate, _delay_start);
     }
 }
 
@@ -612,9 +725,9 @@ void ts::ScramblerPlugin::handlePMT(const PMT& table, PID)
 // Check if we are in degraded mode or if we enter degraded mode
 //----------------------------------------------------------------------------
 
-bool ts::ScramblerPlugin::inDegradedMode()
+bool ts::ScramblerPlugin::ServiceContext::inDegradedMode()
 {
-    if (!_need_ecm) {
+    if (!_plugin->_need_ecm) {
         // No ECM, no degraded mode.
         return false;
     }
@@ -628,7 +741,7 @@ bool ts::ScramblerPlugin::inDegradedMode()
     }
     else {
         // Entering degraded mode
-        tsp->warning(u"Next ECM not ready, entering degraded mode");
+        _plugin->tsp->warning(u"Next ECM not ready, entering degraded mode");
         return _degraded_mode = true;
     }
 }
@@ -638,13 +751,13 @@ bool ts::ScramblerPlugin::inDegradedMode()
 // Try to exit from degraded mode
 //----------------------------------------------------------------------------
 
-bool ts::ScramblerPlugin::tryExitDegradedMode()
+bool ts::ScramblerPlugin::ServiceContext::tryExitDegradedMode()
 {
     // If not in degraded mode, nothing to do
     if (!_degraded_mode) {
         return true;
     }
-    assert(_need_ecm);
+    assert(_plugin->_need_ecm);
 
     // We are in degraded mode. If next ECM not yet ready, stay degraded
     if (!nextECM().ecmReady()) {
@@ -652,7 +765,7 @@ bool ts::ScramblerPlugin::tryExitDegradedMode()
     }
 
     // Next ECM is ready, at last. Exit degraded mode.
-    tsp->info(u"Next ECM ready, exiting from degraded mode");
+    _plugin->tsp->info(u"Next ECM ready, exiting from degraded mode");
     _degraded_mode = false;
 
     // Compute next CW and ECM change.
@@ -660,7 +773,7 @@ bool ts::ScramblerPlugin::tryExitDegradedMode()
         // Start broadcasting ECM before beginning of crypto-period, ie. now
         changeECM();
         // Postpone CW change
-        _pkt_change_cw = _packet_count + PacketDistance(_ts_bitrate, _delay_start);
+        _pkt_change_cw = _plugin->_packet_count + PacketDistance(_plugin->_ts_bitrate, _delay_start);
     }
     else {
         // Change CW now.
@@ -668,7 +781,7 @@ bool ts::ScramblerPlugin::tryExitDegradedMode()
             return false;
         }
         // Start broadcasting ECM after beginning of crypto-period
-        _pkt_change_ecm = _packet_count + PacketDistance(_ts_bitrate, _delay_start);
+        _pkt_change_ecm = _plugin->_packet_count + PacketDistance(_plugin->_ts_bitrate, _delay_start);
     }
 
     return true;
@@ -679,7 +792,7 @@ bool ts::ScramblerPlugin::tryExitDegradedMode()
 // Perform crypto-period transition, for CW or ECM
 //----------------------------------------------------------------------------
 
-bool ts::ScramblerPlugin::changeCW()
+bool ts::ScramblerPlugin::ServiceContext::changeCW()
 {
     if (_scrambling.hasFixedCW()) {
         // A list of fixed CW was loaded from a file.
@@ -688,8 +801,8 @@ bool ts::ScramblerPlugin::changeCW()
         _current_cw = (_current_cw + 1) & 0x01;
 
         // Determine new transition point.
-        if (_need_cp) {
-            _pkt_change_cw = _packet_count + PacketDistance(_ts_bitrate, _ecmg_args.cp_duration);
+        if (_plugin->_need_cp) {
+            _pkt_change_cw = _plugin->_packet_count + PacketDistance(_plugin->_ts_bitrate, _plugin->_ecmg_args.cp_duration);
         }
 
         // Set next crypto-period key.
@@ -708,28 +821,28 @@ bool ts::ScramblerPlugin::changeCW()
         }
 
         // Determine new transition point.
-        if (_need_cp) {
-            _pkt_change_cw = _packet_count + PacketDistance(_ts_bitrate, _ecmg_args.cp_duration);
+        if (_plugin->_need_cp) {
+            _pkt_change_cw = _plugin->_packet_count + PacketDistance(_plugin->_ts_bitrate, _plugin->_ecmg_args.cp_duration);
         }
 
         // Generate (or start generating) next ECM when using ECM(N) in cp(N)
-        if (_need_ecm && _current_ecm == _current_cw) {
+        if (_plugin->_need_ecm && _current_ecm == _current_cw) {
             nextCW().initNext(currentCW());
         }
     }
     return true;
 }
 
-void ts::ScramblerPlugin::changeECM()
+void ts::ScramblerPlugin::ServiceContext::changeECM()
 {
     // Allowed to change CW only if not in degraded mode
-    if (_need_ecm && !inDegradedMode()) {
+    if (_plugin->_need_ecm && !inDegradedMode()) {
 
         // Point to next crypto-period
         _current_ecm = (_current_ecm + 1) & 0x01;
 
         // Determine new transition point
-        _pkt_change_ecm = _packet_count + PacketDistance(_ts_bitrate, _ecmg_args.cp_duration);
+        _pkt_change_ecm = _plugin->_packet_count + PacketDistance(_plugin->_ts_bitrate, _plugin->_ecmg_args.cp_duration);
 
         // Generate (or start generating) next ECM when using ECM(N) in cp(N)
         if (_current_ecm == _current_cw) {
@@ -758,99 +871,128 @@ ts::ProcessorPlugin::Status ts::ScramblerPlugin::processPacket(TSPacket& pkt, TS
         _ts_bitrate = br;
     }
 
-    // Filter interesting sections to discover the service.
-    if (_use_service) {
-        _service.feedPacket(pkt);
-    }
-
-    // If the service is definitely unknown or a fatal error occured during PMT analysis, give up.
-    if (_abort || _service.nonExistentService()) {
-        return TSP_END;
-    }
-
-    // Abort if allocated PID for ECM is already present in TS.
-    if (_ecm_pid != PID_NULL && pid == _ecm_pid) {
-        tsp->error(u"ECM PID allocation conflict, used 0x%X, now found as input PID, try another --pid-ecm", {pid});
-        return TSP_END;
+    // Filter interesting sections to discover the services.
+    // Also check if all services are identified with their PID's to scramble.
+    bool all_ready = true;
+    for (size_t i = 0; i < _contexts.size(); ++i) {
+        ServiceContext& ctx(*_contexts[i]);
+        if (_use_service) {
+            ctx._service.feedPacket(pkt);
+            // If a service is definitely unknown or a fatal error occured during PMT analysis, give up.
+            if (_abort || ctx._service.nonExistentService()) {
+                return TSP_END;
+            }
+        }
+        // Abort if an allocated PID for ECM is already present in TS.
+        if (ctx._ecm_pid != PID_NULL && pid == ctx._ecm_pid) {
+            tsp->error(u"ECM PID allocation conflict, used 0x%X, now found as input PID, try another --pid-ecm", {pid});
+            return TSP_END;
+        }
+        all_ready = all_ready && ctx._scrambled_pids.any();
     }
 
-    // As long as we do not know which PID's to scramble, nullify all packets.
-    // Let predefined PID pass however since we do not need to modify the PAT, SDT, etc.
-    // The only modified PSI/SI is the PMT of the service, not in this PID range.
-    if (_scrambled_pids.none()) {
+    // As long as we do not know which PID's to scramble in all services, nullify
+    // all packets. Let predefined PID pass however since we do not need to modify
+    // the PAT, SDT, etc. The only modified PSI/SI are the PMT's of the services,
+    // not in this PID range.
+    if (!all_ready) {
         return pid <= PID_DVB_LAST ? TSP_OK : TSP_NULL;
     }
 
-    // Packetize modified PMT when needed.
-    if (_update_pmt && pid == _pzer_pmt.getPID()) {
-        _pzer_pmt.getNextPacket(pkt);
-        return TSP_OK;
+    // Packetize the modified PMT's when needed.
+    for (size_t i = 0; i < _contexts.size(); ++i) {
+        ServiceContext& ctx(*_contexts[i]);
+        if (ctx._update_pmt && pid == ctx._pzer_pmt.getPID()) {
+            ctx._pzer_pmt.getNextPacket(pkt);
+            return TSP_OK;
+        }
     }
 
-    // Is it time to apply the next control word ?
-    if (_need_cp && _packet_count >= _pkt_change_cw && !changeCW()) {
-        return TSP_END;
-    }
+    // Perform CW and ECM transitions in each service when time to do so.
+    // The crypto-periods of the various services drift independently.
+    for (size_t i = 0; i < _contexts.size(); ++i) {
+        ServiceContext& ctx(*_contexts[i]);
 
-    // Is it time to start broadcasting the next ECM ?
-    if (_need_ecm && _packet_count >= _pkt_change_ecm) {
-        changeECM();
-    }
+        // Is it time to apply the next control word ?
+        if (_need_cp && _packet_count >= ctx._pkt_change_cw && !ctx.changeCW()) {
+            return TSP_END;
+        }
 
-    // Insert an ECM packet (replace a null packet) when time to do so
-    if (_need_ecm && pid == PID_NULL && _packet_count >= _pkt_insert_ecm) {
+        // Is it time to start broadcasting the next ECM ?
+        if (_need_ecm && _packet_count >= ctx._pkt_change_ecm) {
+            ctx.changeECM();
+        }
+    }
 
-        // Compute next insertion point (approximate)
-        assert(_ecm_bitrate != 0);
-        _pkt_insert_ecm += BitRate(_ts_bitrate / _ecm_bitrate);
+    // Insert an ECM packet (replace a null packet) when time to do so.
+    // Each null packet is used by at most one service, the first due one.
+    if (_need_ecm && pid == PID_NULL) {
+        for (size_t i = 0; i < _contexts.size(); ++i) {
+            ServiceContext& ctx(*_contexts[i]);
+            if (_packet_count >= ctx._pkt_insert_ecm) {
+
+                // Compute next insertion point (approximate)
+                assert(_ecm_bitrate != 0);
+                ctx._pkt_insert_ecm += BitRate(_ts_bitrate / _ecm_bitrate);
+
+                // Try to exit from degraded mode, if we were in.
+                // Note that return false means unrecoverable error here.
+                if (!ctx.tryExitDegradedMode()) {
+                    return TSP_END;
+                }
 
-        // Try to exit from degraded mode, if we were in.
-        // Note that return false means unrecoverable error here.
-        if (!tryExitDegradedMode()) {
-            return TSP_END;
+                // Replace current null packet with an ECM packet
+                ctx.currentECM().getNextECMPacket(pkt);
+                return TSP_OK;
+            }
         }
-
-        // Replace current null packet with an ECM packet
-        currentECM().getNextECMPacket(pkt);
-        return TSP_OK;
     }
 
-    // If the packet has no payload or its PID is not to be scrambled, there is nothing to do.
-    if (!pkt.hasPayload() || !_scrambled_pids.test(pid)) {
+    // If the packet has no payload, there is nothing to scramble.
+    if (!pkt.hasPayload()) {
         return TSP_OK;
     }
 
-    // If packet is already scrambled, error or ignore (do not modify packet)
-    if (pkt.isScrambled()) {
-        if (_ignore_scrambled) {
-            if (!_conflict_pids.test(pid)) {
-                tsp->verbose(u"found input scrambled packets in PID %d (0x%X), ignored", {pid, pid});
-                _conflict_pids.set(pid);
+    // Find the service which scrambles this PID, if any.
+    for (size_t i = 0; i < _contexts.size(); ++i) {
+        ServiceContext& ctx(*_contexts[i]);
+        if (!ctx._scrambled_pids.test(pid)) {
+            continue;
+        }
+
+        // If packet is already scrambled, error or ignore (do not modify packet)
+        if (pkt.isScrambled()) {
+            if (_ignore_scrambled) {
+                if (!ctx._conflict_pids.test(pid)) {
+                    tsp->verbose(u"found input scrambled packets in PID %d (0x%X), ignored", {pid, pid});
+                    ctx._conflict_pids.set(pid);
+                }
+                return TSP_OK;
+            }
+            else {
+                tsp->error(u"packet already scrambled in PID %d (0x%X)", {pid, pid});
+                return TSP_END;
             }
+        }
+
+        // Manage partial scrambling
+        if (ctx._partial_clear > 0) {
+            // Do not scramble this packet
+            ctx._partial_clear--;
             return TSP_OK;
         }
         else {
-            tsp->error(u"packet already scrambled in PID %d (0x%X)", {pid, pid});
-            return TSP_END;
+            // Scramble this packet and reinit subsequent number of packets to keep clear
+            ctx._partial_clear = _partial_scrambling - 1;
         }
-    }
 
-    // Manage partial scrambling
-    if (_partial_clear > 0) {
-        // Do not scramble this packet
-        _partial_clear--;
+        // Scramble the packet payload with the scrambler of this service.
+        if (!ctx._scrambling.encrypt(pkt)) {
+            return TSP_END;
+        }
+        ctx._scrambled_count++;
         return TSP_OK;
     }
-    else {
-        // Scramble this packet and reinit subsequent number of packets to keep clear
-        _partial_clear = _partial_scrambling - 1;
-    }
-
-    // Scramble the packet payload.
-    if (!_scrambling.encrypt(pkt)) {
-        return TSP_END;
-    }
-    _scrambled_count++;
 
     return TSP_OK;
 }
@@ -862,6 +1004,7 @@ ts::ProcessorPlugin::Status ts::ScramblerPlugin::processPacket(TSPacket& pkt, TS
 
 ts::ScramblerPlugin::CryptoPeriod::CryptoPeriod() :
     _plugin(nullptr),
+    _ctx(nullptr),
     _cp_number(0),
     _ecm_ok(false),
     _ecm(),
@@ -876,14 +1019,15 @@ ts::ScramblerPlugin::CryptoPeriod::CryptoPeriod() :
 // Initialize first crypto period.
 //----------------------------------------------------------------------------
 
-void ts::ScramblerPlugin::CryptoPeriod::initCycle(ScramblerPlugin* scrambler, uint16_t cp_number)
+void ts::ScramblerPlugin::CryptoPeriod::initCycle(ServiceContext* ctx, uint16_t cp_number)
 {
-    _plugin = scrambler;
+    _ctx = ctx;
+    _plugin = ctx->_plugin;
     _cp_number = cp_number;
 
     if (_plugin->_need_ecm) {
-        BetterSystemRandomGenerator::Instance()->readByteBlock(_cw_current, _plugin->_scrambling.cwSize());
-        BetterSystemRandomGenerator::Instance()->readByteBlock(_cw_next,_plugin->_scrambling.cwSize());
+        BetterSystemRandomGenerator::Instance()->readByteBlock(_cw_current, _ctx->_scrambling.cwSize());
+        BetterSystemRandomGenerator::Instance()->readByteBlock(_cw_next, _ctx->_scrambling.cwSize());
         generateECM();
     }
 }
@@ -895,12 +1039,13 @@ void ts::ScramblerPlugin::CryptoPeriod::initCycle(ScramblerPlugin* scrambler, ui
 
 void ts::ScramblerPlugin::CryptoPeriod::initNext(const CryptoPeriod& previous)
 {
+    _ctx = previous._ctx;
     _plugin = previous._plugin;
     _cp_number = previous._cp_number + 1;
 
     if (_plugin->_need_ecm) {
         _cw_current = previous._cw_next;
-        BetterSystemRandomGenerator::Instance()->readByteBlock(_cw_next, _plugin->_scrambling.cwSize());
+        BetterSystemRandomGenerator::Instance()->readByteBlock(_cw_next, _ctx->_scrambling.cwSize());
         generateECM();
     }
 }
@@ -914,8 +1059,8 @@ bool ts::ScramblerPlugin::CryptoPeriod::initScramblerKey() const
 {
     // Change the parity of the scrambled packets.
     // Set our random current control word if no fixed CW.
-    return _plugin->_scrambling.setEncryptParity(_cp_number) &&
-        (!_plugin->_need_ecm || _plugin->_scrambling.setCW(_cw_current, _cp_number));
+    return _ctx->_scrambling.setEncryptParity(_cp_number) &&
+        (!_plugin->_need_ecm || _ctx->_scrambling.setCW(_cw_current, _cp_number));
 }
 
 
@@ -930,12 +1075,12 @@ void ts::ScramblerPlugin::CryptoPeriod::generateECM()
     if (_plugin->_synchronous_ecmg) {
         // Synchronous ECM generation
         ecmgscs::ECMResponse response;
-        if (!_plugin->_ecmg.generateECM(_cp_number,
-                                        _cw_current,
-                                        _cw_next,
-                                        _plugin->_ecmg_args.access_criteria,
-                                        uint16_t(_plugin->_ecmg_args.cp_duration / 100),
-                                        response))
+        if (!_ctx->_ecmg.generateECM(_cp_number,
+                                     _cw_current,
+                                     _cw_next,
+                                     _plugin->_ecmg_args.access_criteria,
+                                     uint16_t(_plugin->_ecmg_args.cp_duration / 100),
+                                     response))
         {
             // Error, message already reported
             _plugin->_abort = true;
@@ -946,12 +1091,12 @@ void ts::ScramblerPlugin::CryptoPeriod::generateECM()
     }
     else {
         // Asynchronous ECM generation
-        if (!_plugin->_ecmg.submitECM(_cp_number,
-                                      _cw_current,
-                                      _cw_next,
-                                      _plugin->_ecmg_args.access_criteria,
-                                      uint16_t(_plugin->_ecmg_args.cp_duration / 100),
-                                      this))
+        if (!_ctx->_ecmg.submitECM(_cp_number,
+                                   _cw_current,
+                                   _cw_next,
+                                   _plugin->_ecmg_args.access_criteria,
+                                   uint16_t(_plugin->_ecmg_args.cp_duration / 100),
+                                   this))
         {
             // Error, message already reported
             _plugin->_abort = true;
@@ -966,7 +1111,7 @@ void ts::ScramblerPlugin::CryptoPeriod::generateECM()
 
 void ts::ScramblerPlugin::CryptoPeriod::handleECM(const ecmgscs::ECMResponse& response)
 {
-    if (_plugin->_channel_status.section_TSpkt_flag == 0) {
+    if (_ctx->_channel_status.section_TSpkt_flag == 0) {
         // ECMG returns ECM in section format
         SectionPtr sp(new Section(response.ECM_datagram));
         if (!sp->isValid()) {
@@ -975,7 +1120,7 @@ void ts::ScramblerPlugin::CryptoPeriod::handleECM(const ecmgscs::ECMResponse& re
             return;
         }
         // Packetize the section
-        OneShotPacketizer pzer(_plugin->_ecm_pid, true);
+        OneShotPacketizer pzer(_ctx->_ecm_pid, true);
         pzer.addSection(sp);
         pzer.getPackets(_ecm);
 
@@ -1020,8 +1165,8 @@ void ts::ScramblerPlugin::CryptoPeriod::getNextECMPacket(TSPacket& pkt)
             _ecm_pkt_index = 0;
         }
         // Adjust PID and continuity counter in TS packet
-        pkt.setPID(_plugin->_ecm_pid);
-        pkt.setCC(_plugin->_ecm_cc);
-        _plugin->_ecm_cc = (_plugin->_ecm_cc + 1) & 0x0F;
+        pkt.setPID(_ctx->_ecm_pid);
+        pkt.setCC(_ctx->_ecm_cc);
+        _ctx->_ecm_cc = (_ctx->_ecm_cc + 1) & 0x0F;
     }
 }
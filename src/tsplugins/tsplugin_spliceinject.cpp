@@ -130,6 +130,15 @@ namespace ts {
         // Message queues enqueue smart pointers to the message type.
         typedef CommandQueue::MessagePtr CommandPtr;
 
+        // Deadline-ordered injection index, used on the plugin thread only.
+        // Commands are moved from the inter-thread queue into this index and
+        // the next due command is always at the beginning. Looking for a due
+        // command is one comparison, without locking the inter-thread queue.
+        struct CommandPtrLess {
+            bool operator()(const CommandPtr& a, const CommandPtr& b) const { return *a < *b; }
+        };
+        typedef std::multiset<CommandPtr, CommandPtrLess> CommandIndex;
+
         // --------------------
         // File listener thread
         // --------------------
@@ -203,6 +212,8 @@ namespace ts {
         FileListener     _file_listener;    // TCP listener thread.
         UDPListener      _udp_listener;     // UDP listener thread.
         CommandQueue     _queue;            // Queue for splice commands.
+        CommandIndex     _pending;          // Deadline-ordered commands (plugin thread only).
+        std::atomic<size_t> _queued_count;  // Number of commands recently enqueued in _queue.
         Packetizer       _packetizer;       // Packetizer for Splice Information sections.
         uint64_t         _last_pts;         // Last PTS value from a clock reference.
 
@@ -256,6 +267,8 @@ ts::SpliceInjectPlugin::SpliceInjectPlugin(TSP* tsp_) :
     _file_listener(this),
     _udp_listener(this),
     _queue(),
+    _pending(),
+    _queued_count(0),
     _packetizer(PID_NULL, this),
     _last_pts(INVALID_PTS),
     _wait_first_batch(false),
@@ -431,6 +444,8 @@ bool ts::SpliceInjectPlugin::start()
 
     // Tune the section queue.
     _queue.setMaxMessages(_queue_size);
+    _pending.clear();
+    _queued_count = 0;
 
     // Clear the "first message received" flag.
     _wfb_received = false;
@@ -591,25 +606,31 @@ void ts::SpliceInjectPlugin::provideSection(SectionCounter counter, SectionPtr&
         return;
     }
 
-    // Loop on queued splice commands.
-    for (;;) {
-
-        // Get next splice command from the queue.
-        CommandPtr cmd(_queue.peek());
-        if (cmd.isNull()) {
-            // No splice command available, nothing to do.
-            break;
+    // Move commands which were recently received by the listener threads
+    // into the local injection index. The atomic counter avoids locking the
+    // inter-thread queue when nothing was enqueued, the most common case.
+    // The counter is incremented after enqueue, so a non-zero value always
+    // means that at least one command is actually in the queue. A spurious
+    // leftover value simply triggers one empty drain, which is harmless.
+    if (_queued_count.exchange(0, std::memory_order_acquire) != 0) {
+        CommandPtr cmd;
+        while (_queue.dequeue(cmd, 0)) {
+            assert(cmd->sit.isValid());
+            _pending.insert(cmd);
         }
-        assert(cmd->sit.isValid());
+    }
+
+    // Loop on pending splice commands, the next due one first.
+    while (!_pending.empty()) {
+
+        // Get next splice command from the index.
+        const CommandPtr cmd(*_pending.begin());
 
         // If the command has a termination PTS and this PTS is in the past,
-        // drop the command and loop on next command from the queue.
+        // drop the command and loop on next command from the index.
         if (cmd->last_pts != INVALID_PTS && SequencedPTS(cmd->last_pts, _last_pts)) {
-            CommandPtr cmd2;
-            const bool dequeued = _queue.dequeue(cmd2, 0);
-            assert(dequeued);
-            assert(cmd2 == cmd);
-            tsp->verbose(u"dropping %s, obsolete, current PTS: 0x%09X", {*cmd2, _last_pts});
+            _pending.erase(_pending.begin());
+            tsp->verbose(u"dropping %s, obsolete, current PTS: 0x%09X", {*cmd, _last_pts});
         }
         else {
             // Give up if the command is not immediate and not yet ready to start.
@@ -617,11 +638,8 @@ void ts::SpliceInjectPlugin::provideSection(SectionCounter counter, SectionPtr&
                 break;
             }
 
-            // We must process this command, remove it from the queue.
-            CommandPtr cmd2;
-            const bool dequeued = _queue.dequeue(cmd2, 0);
-            assert(dequeued);
-            assert(cmd2 == cmd);
+            // We must process this command, remove it from the index.
+            _pending.erase(_pending.begin());
 
             // Now we have a section to send.
             section = cmd->section;
@@ -634,7 +652,7 @@ void ts::SpliceInjectPlugin::provideSection(SectionCounter counter, SectionPtr&
                 if (SequencedPTS(cmd->next_pts, cmd->last_pts)) {
                     // The next PTS is still in range, requeue at the next position.
                     tsp->verbose(u"requeueing %s", {*cmd});
-                    _queue.forceEnqueue(cmd);
+                    _pending.insert(cmd);
                 }
             }
             break;
@@ -725,7 +743,11 @@ void ts::SpliceInjectPlugin::processSectionMessage(const uint8_t* addr, size_t s
                 }
                 else {
                     tsp->verbose(u"enqueuing %s", {*cmd});
-                    if (!_queue.enqueue(cmd, 0)) {
+                    if (_queue.enqueue(cmd, 0)) {
+                        // Signal the plugin thread that the queue needs draining.
+                        _queued_count.fetch_add(1, std::memory_order_release);
+                    }
+                    else {
                         tsp->warning(u"queue overflow, dropped one section");
                     }
                 }
@@ -87,11 +87,27 @@ ts::TimeShiftPlugin::TimeShiftPlugin (TSP* tsp_) :
          u"Specifying another location can be useful to redirect very large buffers to another disk. "
          u"If the reserved memory area is large enough to hold the buffer, no file is created.");
 
+    option(u"elide-null");
+    help(u"elide-null",
+         u"Do not store null packets in the time-shift buffer, only remember their "
+         u"positions and regenerate them on output. On typical muxes with a "
+         u"significant stuffing ratio, this proportionally reduces the memory "
+         u"footprint of the buffer or the disk I/O on the temporary file. "
+         u"The payload of the original null packets is not preserved.");
+
     option(u"drop-initial", 'd');
     help(u"drop-initial",
          u"Drop output packets during the initial phase, while the time-shift buffer is filling. "
          u"By default, initial packets are replaced by null packets.");
 
+    option(u"memory-map");
+    help(u"memory-map",
+         u"Map the temporary buffer file in memory instead of using read and "
+         u"write operations. Each buffered packet is directly copied to or from "
+         u"the mapping, without seek, read or write system call, and the "
+         u"operating system pages the file in and out lazily. "
+         u"This has no effect when the buffer is entirely memory-resident.");
+
     option(u"memory-packets", 'm', UNSIGNED);
     help(u"memory-packets",
          u"Specify the number of packets which are cached in memory. "
@@ -124,6 +140,8 @@ bool ts::TimeShiftPlugin::getOptions()
     _time_shift_ms = intValue<MilliSecond>(u"time", 0);
     const size_t packets = intValue<size_t>(u"packets", 0);
     _buffer.setBackupDirectory(value(u"directory"));
+    _buffer.setNullElision(present(u"elide-null"));
+    _buffer.setMemoryMap(present(u"memory-map"));
     _buffer.setMemoryPackets(intValue<size_t>(u"memory-packets", TimeShiftBuffer::DEFAULT_MEMORY_PACKETS));
 
     if ((packets > 0 && _time_shift_ms > 0) || (packets == 0 && _time_shift_ms == 0)) {
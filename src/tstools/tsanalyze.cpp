@@ -34,11 +34,16 @@
 #include "tsMain.h"
 #include "tsTSAnalyzerReport.h"
 #include "tsTSAnalyzerOptions.h"
+#include "tsTSPacketQueue.h"
 #include "tsInputRedirector.h"
 #include "tsPagerArgs.h"
+#include "tsThread.h"
 TSDUCK_SOURCE;
 TS_MAIN(MainCode);
 
+#define READ_QUEUE_PACKETS 1024  // Size of the inter-thread packet queue.
+#define READ_CHUNK_PACKETS  256  // Maximum number of packets per bulk read or analysis chunk.
+
 
 //----------------------------------------------------------------------------
 //  Command line options
@@ -99,6 +104,60 @@ Options::~Options()
 }
 
 
+//----------------------------------------------------------------------------
+//  Input reader thread: reads the capture file in bulk into a packet queue.
+//----------------------------------------------------------------------------
+
+class ReaderThread: public ts::Thread
+{
+    TS_NOBUILD_NOCOPY(ReaderThread);
+public:
+    ReaderThread(ts::TSPacketQueue& queue, ts::Report& report);
+private:
+    ts::TSPacketQueue& _queue;
+    ts::Report&        _report;
+
+    // Implementation of Thread.
+    virtual void main() override;
+};
+
+ReaderThread::ReaderThread(ts::TSPacketQueue& queue, ts::Report& report) :
+    _queue(queue),
+    _report(report)
+{
+}
+
+void ReaderThread::main()
+{
+    for (;;) {
+        // Wait for free space in the queue.
+        ts::TSPacket* buffer = nullptr;
+        size_t buffer_size = 0;
+        if (!_queue.lockWriteBuffer(buffer, buffer_size)) {
+            // Stop condition from the analyzer thread.
+            break;
+        }
+
+        // Bulk read of packets from standard input, many packets per call.
+        buffer_size = std::min<size_t>(buffer_size, READ_CHUNK_PACKETS);
+        std::cin.read(reinterpret_cast<char*>(buffer), std::streamsize(buffer_size * ts::PKT_SIZE));
+        const size_t in_bytes = size_t(std::cin.gcount());
+        const size_t in_packets = in_bytes / ts::PKT_SIZE;
+        _queue.releaseWriteBuffer(in_packets);
+
+        // A short read means end of input file (std::istream::read blocks
+        // until the requested size is fully read or the end of file).
+        if (in_packets < buffer_size) {
+            if (in_bytes % ts::PKT_SIZE != 0) {
+                _report.error(u"truncated packet at end of file");
+            }
+            _queue.setEOF();
+            break;
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 //  Program entry point
 //----------------------------------------------------------------------------
@@ -108,14 +167,29 @@ int MainCode(int argc, char *argv[])
     Options opt(argc, argv);
     ts::TSAnalyzerReport analyzer(opt.duck, opt.bitrate);
     ts::InputRedirector input(opt.infile, opt);
-    ts::TSPacket pkt;
 
     analyzer.setAnalysisOptions(opt.analysis);
 
-    // Read input file and perform analysis.
-    while (pkt.read(std::cin, true, opt)) {
-        analyzer.feedPacket(pkt);
+    // The input file is read by a separate thread which feeds a packet queue.
+    // File input and analysis proceed in parallel, on distinct cores when
+    // available, and packets are moved in bulk, not one syscall per packet.
+    ts::TSPacketQueue queue(READ_QUEUE_PACKETS);
+    ReaderThread reader(queue, opt);
+    if (!reader.start()) {
+        opt.error(u"cannot start the input thread");
+        return EXIT_FAILURE;
+    }
+
+    // Extract packets from the queue and analyze them.
+    ts::TSPacketVector buffer(READ_CHUNK_PACKETS);
+    size_t count = 0;
+    ts::BitRate bitrate = 0;
+    while (queue.waitPackets(buffer.data(), buffer.size(), count, bitrate)) {
+        for (size_t i = 0; i < count; ++i) {
+            analyzer.feedPacket(buffer[i]);
+        }
     }
+    reader.waitForTermination();
 
     // Report analysis.
     analyzer.report(opt.pager.output(opt), opt.analysis);
@@ -183,6 +183,101 @@ Options::~Options()
 }
 
 
+//----------------------------------------------------------------------------
+//  Chunked file reader
+//----------------------------------------------------------------------------
+
+// Each file is read through an intermediate chunk of packets. The main loop
+// first consumes the leading byte-identical packets of both chunks with one
+// memcmp() per packet. Byte-identical packets are equal under all comparison
+// options, so the field-level comparator only runs on differing packets.
+// The underlying files use background read-ahead, overlapping the I/O on
+// both files with the comparison itself.
+
+#define CHUNK_PACKETS 1000
+
+class ChunkedFile
+{
+    TS_NOBUILD_NOCOPY(ChunkedFile);
+public:
+    // Constructor.
+    ChunkedFile(size_t buffer_size) :
+        _file(buffer_size),
+        _chunk(CHUNK_PACKETS),
+        _next(0),
+        _count(0)
+    {
+        _file.setReadAhead(true);
+    }
+
+    // Open / close the file.
+    bool openRead(const ts::UString& filename, uint64_t start_offset, ts::Report& report)
+    {
+        return _file.openRead(filename, 1, start_offset, report);
+    }
+    bool close(ts::Report& report)
+    {
+        return _file.close(report);
+    }
+
+    // Get the file name, as given by the underlying file.
+    ts::UString getFileName() const
+    {
+        return _file.getFileName();
+    }
+
+    // Number of packets which were read (ie. consumed from the chunk).
+    ts::PacketCounter getReadCount() const
+    {
+        return _file.getReadCount() - (_count - _next);
+    }
+
+    // Read one packet. Return the number of read packets, 0 on end of file.
+    size_t read(ts::TSPacket* pkt, ts::Report& report)
+    {
+        if (_next >= _count && !refill(report)) {
+            return 0;
+        }
+        *pkt = _chunk[_next++];
+        return 1;
+    }
+
+    // Number of packets which are available in the chunk, refilling it
+    // when empty. Zero means end of file.
+    size_t available(ts::Report& report)
+    {
+        if (_next >= _count) {
+            refill(report);
+        }
+        return _count - _next;
+    }
+
+    // Access the next unread packet and consume it.
+    const ts::TSPacket& current() const
+    {
+        return _chunk[_next];
+    }
+    void advance()
+    {
+        ++_next;
+    }
+
+private:
+    ts::TSFileInputBuffered _file;   // Underlying file, with background read-ahead.
+    ts::TSPacketVector      _chunk;  // Intermediate chunk of packets.
+    size_t                  _next;   // Index of next unread packet in the chunk.
+    size_t                  _count;  // Number of valid packets in the chunk.
+
+    // Refill the chunk. Return false on end of file.
+    bool refill(ts::Report& report)
+    {
+        _next = 0;
+        _count = _file.read(_chunk.data(), _chunk.size(), report);
+        return _count > 0;
+    }
+};
+
+
 //----------------------------------------------------------------------------
 //  Packet comparator class
 //----------------------------------------------------------------------------
@@ -303,12 +398,12 @@ bool Comparator::compare(const ts::TSPacket& pkt1, const ts::TSPacket& pkt2, Opt
 int MainCode(int argc, char *argv[])
 {
     Options opt (argc, argv);
-    ts::TSFileInputBuffered file1(opt.buffered_packets);
-    ts::TSFileInputBuffered file2(opt.buffered_packets);
+    ChunkedFile file1(opt.buffered_packets);
+    ChunkedFile file2(opt.buffered_packets);
 
     // Open files
-    file1.openRead(opt.filename1, 1, opt.byte_offset, opt);
-    file2.openRead(opt.filename2, 1, opt.byte_offset, opt);
+    file1.openRead(opt.filename1, opt.byte_offset, opt);
+    file2.openRead(opt.filename2, opt.byte_offset, opt);
     opt.exitOnError();
 
     // Display headers
@@ -342,14 +437,28 @@ int MainCode(int argc, char *argv[])
 
     for (;;) {
 
+        // Fast path: consume the leading byte-identical packets of both
+        // chunks. Byte-identical packets are equal under all comparison
+        // options, only their per-PID counters need to be updated.
+        if (subset_skipped == 0) {
+            size_t same = std::min(file1.available(opt), file2.available(opt));
+            while (same > 0 && ::memcmp(file1.current().b, file2.current().b, ts::PKT_SIZE) == 0) {
+                count1[file1.current().getPID()]++;
+                count2[file2.current().getPID()]++;
+                file1.advance();
+                file2.advance();
+                same--;
+            }
+        }
+
         // Read one packet in file1
-        size_t read1 = file1.read (&pkt1, 1, opt);
+        size_t read1 = file1.read (&pkt1, opt);
         ts::PID pid1 = pkt1.getPID();
         count1[pid1]++;
 
         // If currently not skipping packets, read one packet in file2
         if (subset_skipped == 0) {
-            read2 = file2.read (&pkt2, 1, opt);
+            read2 = file2.read (&pkt2, opt);
             pid2 = pkt2.getPID();
             count2[pid2]++;
         }
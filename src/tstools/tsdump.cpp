@@ -37,9 +37,18 @@
 #include "tsPagerArgs.h"
 #include "tsDuckContext.h"
 #include "tsArgs.h"
+#include "tsMemory.h"
+#include "tsSafePtr.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+#include "tsGuardCondition.h"
 TSDUCK_SOURCE;
 TS_MAIN(MainCode);
 
+#define DUMP_CHUNK_PACKETS 256  // Packets per formatting chunk with --parallel-format.
+#define DUMP_WINDOW_CHUNKS 16   // Maximum number of in-flight chunks with --parallel-format.
+
 
 //----------------------------------------------------------------------------
 //  Command line options
@@ -61,6 +70,8 @@ public:
     ts::PacketCounter max_packets; // Maximum number of packets to dump per file
     ts::UStringVector infiles;     // Input file names
     ts::PagerArgs     pager;       // Output paging options.
+    size_t            format_threads; // Number of formatter threads (0: no pipeline)
+    ts::UString       index_file;  // Binary index file name.
 };
 
 Options::Options(int argc, char *argv[]) :
@@ -73,7 +84,9 @@ Options::Options(int argc, char *argv[]) :
     pids(),
     max_packets(0),
     infiles(),
-    pager(true, true)
+    pager(true, true),
+    format_threads(0),
+    index_file()
 {
     pager.defineArgs(*this);
 
@@ -92,6 +105,15 @@ Options::Options(int argc, char *argv[]) :
     option(u"headers-only", 'h');
     help(u"headers-only", u"Dump packet headers only, not payload.");
 
+    option(u"index-file", 0, STRING);
+    help(u"index-file", u"filename",
+         u"Create a binary index file. For each dumped packet (after --pid "
+         u"filtering), write the byte offset of the packet in the input file "
+         u"as an 8-byte big-endian value. The index can be used later to fetch "
+         u"the interesting packets directly from the original file. With "
+         u"several input files, the offsets restart at zero in each file. "
+         u"Incompatible with --raw-file.");
+
     option(u"log", 'l');
     help(u"log", u"Display a short one-line log of each packet instead of full dump.");
 
@@ -112,6 +134,13 @@ Options::Options(int argc, char *argv[]) :
     option(u"offset", 'o');
     help(u"offset", u"Include offset from start of packet with hexadecimal dump.");
 
+    option(u"parallel-format", 0, POSITIVE);
+    help(u"parallel-format", u"count",
+         u"Format the packet dumps in the specified number of parallel threads. "
+         u"The packets are read and written in their original order, only the "
+         u"formatting itself is parallelized. Useful to dump large regions of "
+         u"big capture files. Incompatible with --raw-file.");
+
     option(u"payload");
     help(u"payload", u"Hexadecimal dump of TS payload only, skip TS header.");
 
@@ -134,6 +163,8 @@ Options::Options(int argc, char *argv[]) :
     max_packets = intValue<ts::PacketCounter>(u"max-packets", std::numeric_limits<ts::PacketCounter>::max());
     log_size = intValue<size_t>(u"log-size", ts::PKT_SIZE);
     getIntValues(pids, u"pid", true);
+    format_threads = intValue<size_t>(u"parallel-format", 0);
+    getValue(index_file, u"index-file");
 
     dump_flags =
         ts::TSPacket::DUMP_TS_HEADER |    // Format TS headers
@@ -175,6 +206,9 @@ Options::Options(int argc, char *argv[]) :
     if (raw_file && (log || present(u"max-packets") || present(u"pid") || present(u"headers-only") || present(u"no-headers") || present(u"payload"))) {
         error(u"--raw-file is incompatible with TS-specific options --pid --log --max-packets --headers-only --no-header --payload");
     }
+    if (raw_file && (format_threads > 0 || !index_file.empty())) {
+        error(u"--raw-file is incompatible with --parallel-format and --index-file");
+    }
 
     exitOnError();
 }
@@ -184,12 +218,238 @@ Options::~Options()
 }
 
 
+//----------------------------------------------------------------------------
+// Common formatting and indexing primitives.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // Write one entry in the binary index file: the byte offset of a dumped packet.
+    void WriteIndexEntry(std::ofstream& index, ts::PacketCounter packet_index)
+    {
+        uint8_t data[8];
+        ts::PutUInt64(data, uint64_t(packet_index) * ts::PKT_SIZE);
+        index.write(reinterpret_cast<const char*>(data), sizeof(data));
+    }
+
+    // Format the dump of one packet.
+    void FormatPacket(Options& opt, std::ostream& out, const ts::TSPacket& pkt, ts::PacketCounter packet_index)
+    {
+        if (!opt.log) {
+            out << std::endl << "* Packet " << ts::UString::Decimal(packet_index) << std::endl;
+        }
+        pkt.display(out, opt.dump_flags, opt.log ? 0 : 2, opt.log_size);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Pipelined dump with --parallel-format.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // One chunk of packets, formatted as a whole by one formatter thread.
+    class Chunk
+    {
+    public:
+        enum State {WAITING, FORMATTING, READY};
+        State              state;        // State of the chunk in the pipeline.
+        ts::PacketCounter  first_index;  // Index of first packet in the file.
+        ts::TSPacketVector packets;      // Packets to format.
+        std::string        text;         // Formatted text, valid when state == READY.
+
+        Chunk() : state(WAITING), first_index(0), packets(), text() {}
+    };
+
+    // Chunks are shared between the main thread and the formatter threads.
+    typedef ts::SafePtr<Chunk, ts::Mutex> ChunkPtr;
+
+    // Pipelined packet dump. The main thread reads the packets, writes the
+    // index file and outputs the formatted chunks in their original order.
+    // The formatter threads do the actual formatting, one chunk at a time.
+    class ParallelDumper
+    {
+        TS_NOBUILD_NOCOPY(ParallelDumper);
+    public:
+        // Constructor.
+        ParallelDumper(Options& opt, std::ostream& out, std::ofstream* index) :
+            _opt(opt),
+            _out(out),
+            _index(index),
+            _mutex(),
+            _got_work(),
+            _got_ready(),
+            _window(),
+            _eof(false)
+        {
+        }
+
+        // Perform the dump on one input file.
+        void dumpFile(std::istream& in);
+
+    private:
+        // The formatter threads.
+        class Formatter: public ts::Thread
+        {
+            TS_NOBUILD_NOCOPY(Formatter);
+        public:
+            Formatter(ParallelDumper& parent) : _parent(parent) {}
+            virtual ~Formatter() { waitForTermination(); }
+            virtual void main() override { _parent.formatterMain(); }
+        private:
+            ParallelDumper& _parent;
+        };
+
+        Options&             _opt;        // Command line options.
+        std::ostream&        _out;        // Formatted output.
+        std::ofstream*       _index;      // Optional binary index file.
+        ts::Mutex            _mutex;      // Protect the chunk window.
+        ts::Condition        _got_work;   // Signaled when a chunk is queued or at end of file.
+        ts::Condition        _got_ready;  // Signaled when a chunk is formatted.
+        std::deque<ChunkPtr> _window;     // In-flight chunks, in file order.
+        bool                 _eof;        // No more chunk will be queued.
+
+        // Formatter thread main code.
+        void formatterMain();
+
+        // Write and pop the front chunk if it is formatted, waiting for it when
+        // wait is true. Return false when nothing was written.
+        bool writeNextChunk(bool wait);
+    };
+
+    // Formatter thread main code.
+    void ParallelDumper::formatterMain()
+    {
+        for (;;) {
+            // Wait for a chunk to format.
+            ChunkPtr chunk;
+            {
+                ts::GuardCondition lock(_mutex, _got_work);
+                for (;;) {
+                    for (std::deque<ChunkPtr>::iterator it = _window.begin(); chunk.isNull() && it != _window.end(); ++it) {
+                        if ((*it)->state == Chunk::WAITING) {
+                            chunk = *it;
+                        }
+                    }
+                    if (!chunk.isNull() || _eof) {
+                        break;
+                    }
+                    lock.waitCondition();
+                }
+                if (chunk.isNull()) {
+                    // End of file and nothing left to format. Pass the signal on to the other formatters.
+                    lock.signal();
+                    return;
+                }
+                chunk->state = Chunk::FORMATTING;
+            }
+
+            // Format the chunk outside the lock.
+            std::ostringstream text;
+            ts::PacketCounter packet_index = chunk->first_index;
+            for (ts::TSPacketVector::const_iterator it = chunk->packets.begin(); it != chunk->packets.end(); ++it) {
+                if (_opt.pids.test(it->getPID())) {
+                    FormatPacket(_opt, text, *it, packet_index);
+                }
+                packet_index++;
+            }
+
+            // Publish the result.
+            ts::GuardCondition lock(_mutex, _got_ready);
+            chunk->state = Chunk::READY;
+            chunk->text = text.str();
+            lock.signal();
+        }
+    }
+
+    // Write and pop the front chunk if it is formatted.
+    bool ParallelDumper::writeNextChunk(bool wait)
+    {
+        ChunkPtr chunk;
+        {
+            ts::GuardCondition lock(_mutex, _got_ready);
+            while (wait && !_window.empty() && _window.front()->state != Chunk::READY) {
+                lock.waitCondition();
+            }
+            if (_window.empty() || _window.front()->state != Chunk::READY) {
+                return false;
+            }
+            chunk = _window.front();
+            _window.pop_front();
+        }
+        _out << chunk->text;
+        return true;
+    }
+
+    // Perform the dump on one input file.
+    void ParallelDumper::dumpFile(std::istream& in)
+    {
+        // Start the formatter threads.
+        _eof = false;
+        _window.clear();
+        std::list<ts::SafePtr<Formatter>> threads;
+        for (size_t i = 0; i < _opt.format_threads; ++i) {
+            threads.push_back(ts::SafePtr<Formatter>(new Formatter(*this)));
+            threads.back()->start();
+        }
+
+        // Read the packets, chunk by chunk.
+        ts::TSPacket pkt;
+        ts::PacketCounter packet_index = 0;
+        bool more = true;
+        while (more && packet_index < _opt.max_packets) {
+            ChunkPtr chunk(new Chunk);
+            chunk->first_index = packet_index;
+            while (more && packet_index < _opt.max_packets && chunk->packets.size() < DUMP_CHUNK_PACKETS) {
+                more = bool(pkt.read(in, true, _opt));
+                if (more) {
+                    if (_index != nullptr && _opt.pids.test(pkt.getPID())) {
+                        WriteIndexEntry(*_index, packet_index);
+                    }
+                    chunk->packets.push_back(pkt);
+                    packet_index++;
+                }
+            }
+            if (!chunk->packets.empty()) {
+                bool full = false;
+                {
+                    ts::GuardCondition lock(_mutex, _got_work);
+                    _window.push_back(chunk);
+                    full = _window.size() >= DUMP_WINDOW_CHUNKS;
+                    lock.signal();
+                }
+                // Drain the in-order formatted chunks, waiting for one when the window is full.
+                while (writeNextChunk(full)) {
+                    full = false;
+                }
+            }
+        }
+
+        // Notify the end of file, drain the window and terminate the formatters.
+        {
+            ts::GuardCondition lock(_mutex, _got_work);
+            _eof = true;
+            lock.signal();
+        }
+        while (writeNextChunk(true)) {
+        }
+        for (std::list<ts::SafePtr<Formatter>>::iterator it = threads.begin(); it != threads.end(); ++it) {
+            (*it)->waitForTermination();
+        }
+        if (!_opt.log) {
+            _out << std::endl;
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Perform the dump on one input file.
 //----------------------------------------------------------------------------
 
 namespace {
-    void DumpFile(Options& opt, std::istream& in, std::ostream & out)
+    void DumpFile(Options& opt, std::istream& in, std::ostream& out, std::ofstream* index)
     {
         if (opt.raw_file) {
             // Raw dump of file
@@ -213,10 +473,10 @@ namespace {
             ts::TSPacket pkt;
             for (ts::PacketCounter packet_index = 0; packet_index < opt.max_packets && pkt.read(in, true, opt); packet_index++) {
                 if (opt.pids.test(pkt.getPID())) {
-                    if (!opt.log) {
-                        out << std::endl << "* Packet " << ts::UString::Decimal(packet_index) << std::endl;
+                    if (index != nullptr) {
+                        WriteIndexEntry(*index, packet_index);
                     }
-                    pkt.display(out, opt.dump_flags, opt.log ? 0 : 2, opt.log_size);
+                    FormatPacket(opt, out, pkt, packet_index);
                 }
             }
             if (!opt.log) {
@@ -237,11 +497,31 @@ int MainCode(int argc, char *argv[])
     Options opt(argc, argv);
     std::ostream& out(opt.pager.output(opt));
 
+    // Create the optional binary index file.
+    std::ofstream index_stream;
+    std::ofstream* index = nullptr;
+    if (!opt.index_file.empty()) {
+        index_stream.open(opt.index_file.toUTF8().c_str(), std::ios::binary);
+        if (!index_stream) {
+            opt.error(u"cannot create index file %s", {opt.index_file});
+            return EXIT_FAILURE;
+        }
+        index = &index_stream;
+    }
+
+    // The pipelined dump, when requested, is created once and reused for all files.
+    ParallelDumper dumper(opt, out, index);
+
     if (opt.infiles.empty()) {
         // Try to put standard input in binary mode
         SetBinaryModeStdin(opt);
         // Dump standard input.
-        DumpFile(opt, std::cin, out);
+        if (opt.format_threads > 0) {
+            dumper.dumpFile(std::cin);
+        }
+        else {
+            DumpFile(opt, std::cin, out, index);
+        }
     }
     else {
         // Dump named files.
@@ -252,7 +532,12 @@ int MainCode(int argc, char *argv[])
                 if (opt.infiles.size() > 1 && !opt.raw_file && !opt.log) {
                     out << "* File " << opt.infiles[i] << std::endl;
                 }
-                DumpFile(opt, file, out);
+                if (opt.format_threads > 0) {
+                    dumper.dumpFile(file);
+                }
+                else {
+                    DumpFile(opt, file, out, index);
+                }
             }
             else {
                 opt.error(u"cannot open file %s", {opt.infiles[i]});
@@ -35,6 +35,8 @@
 #include "tsAsyncReport.h"
 #include "tsFatal.h"
 #include "tsMutex.h"
+#include "tsCondition.h"
+#include "tsGuardCondition.h"
 #include "tsThread.h"
 #include "tsSysUtils.h"
 #include "tsECMGSCS.h"
@@ -61,6 +63,9 @@ namespace {
     // Instantiation of a TCP connection in a multi-thread context for TLV messages.
     typedef ts::tlv::Connection<ts::Mutex> ECMGConnection;
     typedef ts::SafePtr<ECMGConnection, ts::Mutex> ECMGConnectionPtr;
+
+    // An ECM response message, shared between a session thread and a worker thread.
+    typedef ts::SafePtr<ts::ecmgscs::ECMResponse, ts::Mutex> ECMResponsePtr;
 }
 
 
@@ -79,6 +84,7 @@ public:
     int                        log_data;       // Log level for CW/ECM data messages.
     bool                       once;           // Accept only one client.
     bool                       reusePort;      // Socket option.
+    size_t                     ecmThreads;     // Number of ECM computation threads (0: synchronous).
     ts::MilliSecond            ecmCompTime;    // ECM computation time.
     ts::SocketAddress          serverAddress;  // TCP server local address.
     ts::ecmgscs::ChannelStatus channelStatus;  // Standard parameters required by this ECMG.
@@ -95,6 +101,7 @@ ECMGOptions::ECMGOptions(int argc, char *argv[]) :
     log_data(ts::Severity::Debug),
     once(false),
     reusePort(false),
+    ecmThreads(0),
     ecmCompTime(0),
     serverAddress(),
     channelStatus(),
@@ -134,6 +141,17 @@ ECMGOptions::ECMGOptions(int argc, char *argv[]) :
          u"This option sets the DVB SimulCrypt option 'delay_stop', in milliseconds. "
          u"Default: " + ts::UString::Decimal(DEFAULT_DELAY_STOP, 0, true, u"") + u" ms.");
 
+    option(u"ecm-threads", 0, POSITIVE);
+    help(u"ecm-threads",
+         u"Specify the number of threads which compute and send the ECM "
+         u"responses. By default, each ECM response is computed and sent "
+         u"synchronously in the session thread, where the emulated computation "
+         u"time (--comp-time) delays all subsequent messages of the session. "
+         u"With a thread pool, the session threads keep receiving and "
+         u"answering control messages while the ECM's are computed. Each "
+         u"channel is assigned to one worker thread, preserving the order of "
+         u"the ECM responses inside a channel.");
+
     option(u"ecmg-scs-version", 0, INTEGER, 0, 1, 2, 3);
     help(u"ecmg-scs-version",
          u"Specify the version of the ECMG <=> SCS DVB SimulCrypt protocol. "
@@ -192,6 +210,7 @@ ECMGOptions::ECMGOptions(int argc, char *argv[]) :
     serverAddress.setPort(intValue<uint16_t>(u"port", DEFAULT_SERVER_PORT));
     once = present(u"once");
     reusePort = !present(u"no-reuse-port");
+    ecmThreads = intValue<size_t>(u"ecm-threads", 0);
     ecmCompTime = intValue<ts::MilliSecond>(u"comp-time", 0);
     log_protocol = present(u"log-protocol") ? intValue<int>(u"log-protocol", ts::Severity::Info) : ts::Severity::Debug;
     log_data = present(u"log-data") ? intValue<int>(u"log-data", ts::Severity::Info) : log_protocol;
@@ -235,8 +254,9 @@ class ECMGSharedData
 {
     TS_NOBUILD_NOCOPY(ECMGSharedData);
 public:
-    // Constructor.
+    // Constructor and destructor.
     ECMGSharedData(const ECMGOptions& opt);
+    ~ECMGSharedData();
 
     // Declare a new ECM_channel_id. Return false if already active.
     bool openChannel(uint16_t id);
@@ -244,6 +264,11 @@ public:
     // Release a ECM_channel_id. Return false if not active.
     bool closeChannel(uint16_t id);
 
+    // Queue an ECM response for asynchronous computation and transmission
+    // by the worker pool. Return false when there is no worker pool, in
+    // which case the caller must process the response synchronously.
+    bool queueResponse(uint16_t channel_id, const ECMGConnectionPtr& conn, const ECMResponsePtr& resp);
+
     // Get the shared asynchronous report facility.
     ts::Report& report() { return _report; }
 
@@ -251,10 +276,49 @@ public:
     ts::tlv::Logger& logger() { return _logger; }
 
 private:
-    ts::AsyncReport    _report;    // Asynchronous message report.
-    ts::tlv::Logger    _logger;    // Protocol message logger.
-    ts::Mutex          _mutex;     // Protect shared data.
-    std::set<uint16_t> _channels;  // Active channels.
+    // A worker thread which emulates the ECM computation time and sends
+    // the queued responses. A worker serves a fixed subset of the channels,
+    // so that the responses of one channel are sent in their request order.
+    class ECMWorker: public ts::Thread
+    {
+        TS_NOBUILD_NOCOPY(ECMWorker);
+    public:
+        // Constructor.
+        ECMWorker(const ECMGOptions& opt, ECMGSharedData* shared);
+
+        // Queue one response for this worker.
+        void queue(const ECMGConnectionPtr& conn, const ECMResponsePtr& resp);
+
+        // Ask the thread to terminate after draining its queue.
+        void stop();
+
+        // Main code of the thread.
+        virtual void main() override;
+
+    private:
+        // One queued ECM response.
+        class Job
+        {
+        public:
+            ECMGConnectionPtr conn;  // Where to send the response.
+            ECMResponsePtr    resp;  // The response to send.
+            Job(const ECMGConnectionPtr& c = ECMGConnectionPtr(), const ECMResponsePtr& r = ECMResponsePtr()) : conn(c), resp(r) {}
+        };
+
+        const ECMGOptions& _opt;       // Command line options.
+        ECMGSharedData*    _shared;    // Shared data (for the logger).
+        ts::Mutex          _mutex;     // Protect the job queue.
+        ts::Condition      _got_jobs;  // Signaled when jobs are queued or at stop.
+        std::list<Job>     _jobs;      // Queued responses, in request order.
+        bool               _stop;      // Terminate after draining the queue.
+    };
+    typedef ts::SafePtr<ECMWorker> ECMWorkerPtr;
+
+    ts::AsyncReport           _report;    // Asynchronous message report.
+    ts::tlv::Logger           _logger;    // Protocol message logger.
+    ts::Mutex                 _mutex;     // Protect shared data.
+    std::set<uint16_t>        _channels;  // Active channels.
+    std::vector<ECMWorkerPtr> _workers;   // ECM computation pool (empty: synchronous mode).
 };
 
 
@@ -267,11 +331,104 @@ ECMGSharedData::ECMGSharedData(const ECMGOptions& opt) :
     _report(opt.maxSeverity()),
     _logger(opt.log_protocol, &_report),
     _mutex(),
-    _channels()
+    _channels(),
+    _workers()
 {
     // The CW/ECM data messages have a distinct log level.
     _logger.setSeverity(ts::ecmgscs::Tags::CW_provision, opt.log_data);
     _logger.setSeverity(ts::ecmgscs::Tags::ECM_response, opt.log_data);
+
+    // Start the ECM computation pool when requested.
+    for (size_t i = 0; i < opt.ecmThreads; ++i) {
+        _workers.push_back(ECMWorkerPtr(new ECMWorker(opt, this)));
+        ts::CheckNonNull(_workers.back().pointer());
+        _workers.back()->start();
+    }
+}
+
+// Destructor.
+ECMGSharedData::~ECMGSharedData()
+{
+    // Terminate the workers after draining their queues.
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        _workers[i]->stop();
+    }
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        _workers[i]->waitForTermination();
+    }
+}
+
+// Queue an ECM response for the worker pool.
+bool ECMGSharedData::queueResponse(uint16_t channel_id, const ECMGConnectionPtr& conn, const ECMResponsePtr& resp)
+{
+    if (_workers.empty()) {
+        return false;
+    }
+    // A channel is always served by the same worker, preserving the
+    // order of the ECM responses inside the channel.
+    _workers[channel_id % _workers.size()]->queue(conn, resp);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Implementation of the ECM computation worker thread.
+//----------------------------------------------------------------------------
+
+// Constructor.
+ECMGSharedData::ECMWorker::ECMWorker(const ECMGOptions& opt, ECMGSharedData* shared) :
+    ts::Thread(),
+    _opt(opt),
+    _shared(shared),
+    _mutex(),
+    _got_jobs(),
+    _jobs(),
+    _stop(false)
+{
+}
+
+// Queue one response for this worker.
+void ECMGSharedData::ECMWorker::queue(const ECMGConnectionPtr& conn, const ECMResponsePtr& resp)
+{
+    ts::GuardCondition lock(_mutex, _got_jobs);
+    _jobs.push_back(Job(conn, resp));
+    lock.signal();
+}
+
+// Ask the thread to terminate after draining its queue.
+void ECMGSharedData::ECMWorker::stop()
+{
+    ts::GuardCondition lock(_mutex, _got_jobs);
+    _stop = true;
+    lock.signal();
+}
+
+// Main code of the worker thread.
+void ECMGSharedData::ECMWorker::main()
+{
+    for (;;) {
+        // Wait for a batch of jobs, grab all queued jobs at once.
+        std::list<Job> batch;
+        {
+            ts::GuardCondition lock(_mutex, _got_jobs);
+            while (_jobs.empty() && !_stop) {
+                lock.waitCondition();
+            }
+            if (_jobs.empty()) {
+                return;
+            }
+            batch.swap(_jobs);
+        }
+
+        // Process the batch, the responses are sent back-to-back.
+        for (std::list<Job>::iterator it = batch.begin(); it != batch.end(); ++it) {
+            // Emulate the computation time of a real ECMG.
+            if (_opt.ecmCompTime > 0) {
+                ts::SleepThread(_opt.ecmCompTime);
+            }
+            it->conn->send(*(it->resp), _shared->logger());
+        }
+    }
 }
 
 // Declare a new ECM_channel_id. Return false if already active.
@@ -612,10 +769,11 @@ bool ECMGClientHandler::handleCWProvision(ts::ecmgscs::CWProvision* msg)
     }
     else {
         // Start to build the response.
-        ts::ecmgscs::ECMResponse resp;
-        resp.channel_id = msg->channel_id;
-        resp.stream_id = msg->stream_id;
-        resp.CP_number = msg->CP_number;
+        ECMResponsePtr resp(new ts::ecmgscs::ECMResponse);
+        ts::CheckNonNull(resp.pointer());
+        resp->channel_id = msg->channel_id;
+        resp->stream_id = msg->stream_id;
+        resp->CP_number = msg->CP_number;
 
         // Add all CW's in the ECM (in the clear, yeah, but that's a fake/test ECMG).
         ts::duck::ClearECM ecm;
@@ -662,20 +820,28 @@ bool ECMGClientHandler::handleCWProvision(ts::ecmgscs::CWProvision* msg)
             zer.addSection(ecmSection);
             zer.getPackets(ecmPackets);
             if (!ecmPackets.empty()) {
-                resp.ECM_datagram.copy(ecmPackets[0].b, ecmPackets.size() * ts::PKT_SIZE);
+                resp->ECM_datagram.copy(ecmPackets[0].b, ecmPackets.size() * ts::PKT_SIZE);
             }
         }
         else {
             // Send ECM as a section.
-            resp.ECM_datagram.copy(ecmSection->content(), ecmSection->size());
+            resp->ECM_datagram.copy(ecmSection->content(), ecmSection->size());
         }
 
-        // Emulate the computation time of a real ECMG.
+        // Hand the response over to the worker pool when there is one. The
+        // emulated computation time and the transmission are then performed
+        // by a worker thread and this session thread keeps processing the
+        // incoming messages.
+        if (_shared->queueResponse(msg->channel_id, _conn, resp)) {
+            return true;
+        }
+
+        // Synchronous mode: emulate the computation time of a real ECMG.
         if (_opt.ecmCompTime > 0) {
             ts::SleepThread(_opt.ecmCompTime);
         }
 
-        return send(&resp);
+        return send(resp.pointer());
     }
 }
 
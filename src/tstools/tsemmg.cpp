@@ -33,6 +33,7 @@
 
 #include "tsMain.h"
 #include "tsIntegerUtils.h"
+#include "tsFatal.h"
 #include "tsEMMGClient.h"
 #include "tsUDPSocket.h"
 #include "tsPacketizer.h"
@@ -93,6 +94,7 @@ public:
     ts::TID              emmMinTableId;       // Minimum table id of generated EMM's.
     ts::TID              emmMaxTableId;       // Maximum table id of generated EMM's.
     uint64_t             maxBytes;            // Stop after injecting that number of bytes.
+    uint64_t             maxBurst;            // Maximum number of bytes per burst (token bucket depth).
     ts::BitRate          dataBitrate;         // Actual data bitrate.
     size_t               bytesPerSend;        // Approximate size of each send.
     ts::NanoSecond       sendInterval;        // Interval between two send operations.
@@ -128,6 +130,7 @@ EMMGOptions::EMMGOptions(int argc, char *argv[]) :
     emmMinTableId(0),
     emmMaxTableId(0),
     maxBytes(0),
+    maxBurst(0),
     dataBitrate(0),
     bytesPerSend(0),
     sendInterval(0)
@@ -211,6 +214,14 @@ EMMGOptions::EMMGOptions(int argc, char *argv[]) :
          u"If the option is present without value, the messages are logged at info "
          u"level. A level can be a numerical debug level or a name.");
 
+    option(u"max-burst", 0, UNSIGNED);
+    help(u"max-burst",
+         u"Specify the maximum number of bytes which can be sent in one burst. "
+         u"The pacing works as a token bucket: when the tool falls behind the "
+         u"target bandwidth, it accumulates a credit of bytes to send and this "
+         u"option bounds that credit, the excess is discarded. By default, the "
+         u"credit is unbounded and the tool catches up at line rate after a stall.");
+
     option(u"max-bytes", 0, UNSIGNED);
     help(u"max-bytes",
          u"Stop after sending the specified number of bytes. By default, send data "
@@ -273,6 +284,7 @@ EMMGOptions::EMMGOptions(int argc, char *argv[]) :
     emmMinTableId = intValue<ts::TID>(u"emm-min-table-id", DEFAULT_EMM_MIN_TID);
     emmMaxTableId = intValue<ts::TID>(u"emm-max-table-id", DEFAULT_EMM_MAX_TID);
     maxBytes = intValue<uint64_t>(u"max-bytes", std::numeric_limits<uint64_t>::max());
+    maxBurst = intValue<uint64_t>(u"max-burst", std::numeric_limits<uint64_t>::max());
     bytesPerSend = intValue<size_t>(u"bytes-per-send", DEFAULT_BYTES_PER_SEND);
     const ts::tlv::VERSION protocolVersion = intValue<ts::tlv::VERSION>(u"emmg-mux-version", 2);
 
@@ -511,6 +523,9 @@ int MainCode(int argc, char *argv[])
     // This clock will be our reference.
     ts::Monotonic currentTime(startTime);
 
+    // Number of token bucket credits which were discarded because of --max-burst.
+    uint64_t discardedBytes = 0;
+
     // Send data as long as the maximum is not reached.
     bool ok = true;
     while (ok && client.totalBytes() < opt.maxBytes) {
@@ -525,56 +540,68 @@ int MainCode(int argc, char *argv[])
         else {
             // Compute the theoretical number of bytes we should have sent up to now.
             const uint64_t allBytes = (opt.dataBitrate * duration) / (8 * ts::NanoSecPerSec);
-            // We need to send the difference.
-            if (allBytes > client.totalBytes()) {
-                targetBytes = allBytes - client.totalBytes();
+            // The token bucket credit is the difference with what was actually
+            // sent, plus what was previously discarded. Tokens overflowing the
+            // bucket (--max-burst) are discarded.
+            const uint64_t doneBytes = client.totalBytes() + discardedBytes;
+            if (allBytes > doneBytes) {
+                targetBytes = allBytes - doneBytes;
+                if (targetBytes > opt.maxBurst) {
+                    discardedBytes += targetBytes - opt.maxBurst;
+                    targetBytes = opt.maxBurst;
+                }
             }
         }
 
-        // Send the data we need to send now. Split in several send operations if needed.
-        while (ok && targetBytes > 0 && client.totalBytes() < opt.maxBytes) {
+        // Build the data_provision messages of this burst. They are all sent
+        // in one single batch: one buffer build and one TCP write.
+        std::vector<ts::ByteBlockPtr> chunks;
+        uint64_t burstSize = 0;
+        while (ok && targetBytes > 0 && client.totalBytes() + burstSize < opt.maxBytes) {
 
-            // Size of this send operation.
+            // Size of this data_provision message.
             const uint64_t targetSendSize = std::min<uint64_t>(opt.bytesPerSend, targetBytes);
-            uint64_t sendSize = 0;
+            ts::ByteBlockPtr chunk(new ts::ByteBlock);
+            ts::CheckNonNull(chunk.pointer());
 
             // Build a set of data to send.
             if (opt.sectionMode) {
                 // Get complete sections from the section provider.
-                ts::SectionPtrVector sections;
-                while (ok && sendSize < targetSendSize) {
+                while (ok && chunk->size() < targetSendSize) {
                     // Get one section.
                     ts::SectionPtr sec;
                     sectionProvider.provideSection(0, sec);
                     // Getting a null pointer means end of input.
                     ok = !sec.isNull();
                     if (ok) {
-                        sections.push_back(sec);
-                        sendSize += sec->size();
+                        chunk->append(sec->content(), sec->size());
                     }
                 }
-
-                // Send the sections.
-                ok = client.dataProvision(sections) && ok;
             }
             else {
                 // Get TS packets from the packetizer.
-                sendSize = ts::RoundUp<uint64_t>(targetSendSize, ts::PKT_SIZE);
-                ts::TSPacketVector packets(size_t(sendSize / ts::PKT_SIZE));
-                for (size_t i = 0; ok && i < packets.size(); ++i) {
-                    ok = packetizer.getNextPacket(packets[i]);
-                    if (!ok) {
-                        // No more packet, shrink the packet buffer.
-                        packets.resize(i);
+                const size_t pktCount = size_t(ts::RoundUp<uint64_t>(targetSendSize, ts::PKT_SIZE) / ts::PKT_SIZE);
+                ts::TSPacket pkt;
+                for (size_t i = 0; ok && i < pktCount; ++i) {
+                    ok = packetizer.getNextPacket(pkt);
+                    if (ok) {
+                        chunk->append(pkt.b, ts::PKT_SIZE);
                     }
                 }
+            }
 
-                // Send the packets.
-                ok = client.dataProvision(packets.data(), packets.size() * ts::PKT_SIZE) && ok;
+            if (!chunk->empty()) {
+                burstSize += chunk->size();
+                chunks.push_back(chunk);
             }
 
-            // Any data left for another send operation?
-            targetBytes = sendSize > targetBytes ? 0 : targetBytes - sendSize;
+            // Any data left for another data_provision message?
+            targetBytes = chunk->size() > targetBytes ? 0 : targetBytes - chunk->size();
+        }
+
+        // Send the whole burst in one batch.
+        if (!chunks.empty()) {
+            ok = client.dataProvisionBatch(chunks) && ok;
         }
 
         // Wait for the next send operation.
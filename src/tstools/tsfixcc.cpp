@@ -103,6 +103,69 @@ bool Options::fileError(const ts::UChar* message)
 }
 
 
+//----------------------------------------------------------------------------
+//  Fix the file in place through a read-write memory mapping (UNIX only).
+//  The packet headers are patched directly in the mapping and only the pages
+//  which actually contain a modified packet are written back by the kernel,
+//  instead of a seek / read / rewrite cycle on every packet. Return false
+//  when the file cannot be mapped, the caller then falls back to the stdio
+//  implementation. I/O and content errors are reported through opt.
+//----------------------------------------------------------------------------
+
+#if defined(TS_UNIX)
+namespace {
+    bool FixWithMap(Options& opt, ts::ContinuityAnalyzer& fixer)
+    {
+        // Open the file, read-only in test mode.
+        const int fd = ::open(opt.filename.toUTF8().c_str(), opt.test ? O_RDONLY : O_RDWR);  // Flawfinder: ignore
+        if (fd < 0) {
+            return false;
+        }
+
+        // Only a non-empty regular file can be mapped.
+        struct stat st;
+        if (::fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+            ::close(fd);
+            return false;
+        }
+        const size_t size = size_t(st.st_size) - size_t(st.st_size) % ts::PKT_SIZE;
+        if (size == 0) {
+            ::close(fd);
+            return false;
+        }
+
+        // Map all complete packets of the file. In test mode, a private
+        // read-only mapping is sufficient.
+        void* const base = ::mmap(nullptr, size, opt.test ? PROT_READ : (PROT_READ | PROT_WRITE), opt.test ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        ::posix_madvise(base, size, POSIX_MADV_SEQUENTIAL);
+
+        // Scan and patch the packets directly in the mapping.
+        ts::TSPacket* const packets = reinterpret_cast<ts::TSPacket*>(base);
+        const size_t count = size / ts::PKT_SIZE;
+        for (size_t i = 0; i < count; ++i) {
+            if (packets[i].b[0] != ts::SYNC_BYTE) {
+                opt.error(u"packet index %'d: missing sync byte, not a valid TS file", {i});
+                break;
+            }
+            fixer.feedPacket(packets[i]);
+        }
+
+        // Let the kernel schedule the writeback of the dirty pages.
+        if (!opt.test) {
+            ::msync(base, size, MS_ASYNC);
+        }
+        ::munmap(base, size);
+        ::close(fd);
+        return true;
+    }
+}
+#endif
+
+
 //----------------------------------------------------------------------------
 //  Program entry point
 //----------------------------------------------------------------------------
@@ -117,52 +180,62 @@ int MainCode(int argc, char *argv[])
     fixer.setFix(!opt.test);
     fixer.setMessageSeverity(opt.test ? ts::Severity::Info : ts::Severity::Verbose);
 
-    // Open file in read/write mode (CC are overwritten)
-    std::ios::openmode mode = std::ios::in | std::ios::binary;
-    if (!opt.test) {
-        mode |= std::ios::out;
-    }
-
-    opt.file.open(opt.filename.toUTF8().c_str(), mode);
-
-    if (!opt.file) {
-        opt.error(u"cannot open file %s", {opt.filename});
-        return EXIT_FAILURE;
-    }
-
-    // Process all packets in the file
-    ts::TSPacket pkt;
+    // On UNIX systems, first try to patch the file in place through a memory
+    // mapping. Fall back to the stdio implementation when the file cannot be
+    // mapped (special file, mapping failure, etc.)
+    bool done = false;
+#if defined(TS_UNIX)
+    done = FixWithMap(opt, fixer);
+#endif
+
+    if (!done) {
+        // Open file in read/write mode (CC are overwritten)
+        std::ios::openmode mode = std::ios::in | std::ios::binary;
+        if (!opt.test) {
+            mode |= std::ios::out;
+        }
 
-    for (;;) {
+        opt.file.open(opt.filename.toUTF8().c_str(), mode);
 
-        // Save position of current packet
-        const std::ios::pos_type pos = opt.file.tellg();
-        if (opt.fileError(u"error getting file position")) {
-            break;
+        if (!opt.file) {
+            opt.error(u"cannot open file %s", {opt.filename});
+            return EXIT_FAILURE;
         }
 
-        // Read a TS packet
-        if (!pkt.read(opt.file, true, opt)) {
-            break; // end of file
-        }
+        // Process all packets in the file
+        ts::TSPacket pkt;
 
-        // Process packet
-        if (!fixer.feedPacket(pkt) && !opt.test) {
-            // Packet was modified, need to rewrite it.
-            // Rewind to beginning of current packet
-            opt.file.seekp(pos);
-            if (opt.fileError(u"error setting file position")) {
+        for (;;) {
+
+            // Save position of current packet
+            const std::ios::pos_type pos = opt.file.tellg();
+            if (opt.fileError(u"error getting file position")) {
                 break;
             }
-            // Rewrite the packet
-            pkt.write(opt.file, opt);
-            if (opt.fileError(u"error rewriting packet")) {
-                break;
+
+            // Read a TS packet
+            if (!pkt.read(opt.file, true, opt)) {
+                break; // end of file
             }
-            // Make sure the get position is ok
-            opt.file.seekg(opt.file.tellp());
-            if (opt.fileError(u"error setting file position")) {
-                break;
+
+            // Process packet
+            if (!fixer.feedPacket(pkt) && !opt.test) {
+                // Packet was modified, need to rewrite it.
+                // Rewind to beginning of current packet
+                opt.file.seekp(pos);
+                if (opt.fileError(u"error setting file position")) {
+                    break;
+                }
+                // Rewrite the packet
+                pkt.write(opt.file, opt);
+                if (opt.fileError(u"error rewriting packet")) {
+                    break;
+                }
+                // Make sure the get position is ok
+                opt.file.seekg(opt.file.tellp());
+                if (opt.fileError(u"error setting file position")) {
+                    break;
+                }
             }
         }
     }
@@ -172,8 +245,17 @@ int MainCode(int argc, char *argv[])
     // Append empty packet to ensure circular continuity
     if (opt.circular && opt.valid()) {
 
+        // The file stream is not open when the fix was done through the mapping.
+        if (!opt.test && !opt.file.is_open()) {
+            opt.file.open(opt.filename.toUTF8().c_str(), std::ios::out | std::ios::binary | std::ios::app);
+            if (!opt.file) {
+                opt.error(u"cannot reopen file %s", {opt.filename});
+                return EXIT_FAILURE;
+            }
+        }
+
         // Create an empty packet (no payload, 184-byte adaptation field)
-        pkt = ts::NullPacket;
+        ts::TSPacket pkt(ts::NullPacket);
         pkt.b[3] = 0x20;    // adaptation field, no payload
         pkt.b[4] = 183;     // adaptation field length
         pkt.b[5] = 0x00;    // nothing in adaptation field
@@ -37,9 +37,12 @@
 #include "tsOutputRedirector.h"
 #include "tsCyclingPacketizer.h"
 #include "tsSysUtils.h"
+#include "tsTime.h"
 TSDUCK_SOURCE;
 TS_MAIN(MainCode);
 
+#define DEFAULT_POLL_INTERVAL 1000 // ms
+
 
 //----------------------------------------------------------------------------
 //  Command line options
@@ -54,6 +57,8 @@ public:
 
     ts::DuckContext           duck;
     bool                      continuous; // Continuous packetization
+    bool                      poll_files; // Reload modified input files on the fly
+    ts::MilliSecond           poll_interval; // Interval between two file polls
     ts::CyclingPacketizer::StuffingPolicy stuffing_policy;
     ts::CRC32::Validation     crc_op;     // Validate/recompute CRC32
     ts::PID                   pid;        // Target PID
@@ -71,6 +76,8 @@ Options::Options(int argc, char *argv[]) :
     Args(u"Packetize PSI/SI sections in a transport stream PID", u"[options] [input-file[=rate] ...]"),
     duck(this),
     continuous(false),
+    poll_files(false),
+    poll_interval(0),
     stuffing_policy(ts::CyclingPacketizer::NEVER),
     crc_op(ts::CRC32::COMPUTE),
     pid(ts::PID_NULL),
@@ -111,6 +118,19 @@ Options::Options(int argc, char *argv[]) :
     option(u"output", 'o', STRING);
     help(u"output", u"Output file name for TS packets. By default, use standard output.");
 
+    option(u"poll-files");
+    help(u"poll-files",
+         u"With --continuous, poll the input files at regular intervals. When an "
+         u"input file is modified, it is reloaded and its tables replace the "
+         u"previous ones from the same file in the cycling schedule, without "
+         u"interrupting the packetization of the other tables. Tables from "
+         u"unmodified files are not reloaded.");
+
+    option(u"poll-interval", 0, POSITIVE);
+    help(u"poll-interval", u"milliseconds",
+         u"With --poll-files, specifies the interval in milliseconds between two "
+         u"poll operations. The default is " + ts::UString::Decimal(DEFAULT_POLL_INTERVAL) + u" ms.");
+
     option(u"pid", 'p', PIDVAL, 1, 1);
     help(u"pid", u"PID of the output TS packets. This is a required parameter, there is no default value.");
 
@@ -127,6 +147,8 @@ Options::Options(int argc, char *argv[]) :
     analyze(argc, argv);
 
     continuous = present(u"continuous");
+    poll_files = present(u"poll-files");
+    poll_interval = intValue<ts::MilliSecond>(u"poll-interval", DEFAULT_POLL_INTERVAL);
     if (present(u"stuffing")) {
         stuffing_policy = ts::CyclingPacketizer::ALWAYS;
     }
@@ -157,10 +179,74 @@ Options::Options(int argc, char *argv[]) :
         }
     }
 
+    // File polling makes sense only for a long-running packetization of real files.
+    if (poll_files && !continuous) {
+        error(u"--poll-files requires --continuous");
+    }
+    if (poll_files && infiles.empty()) {
+        error(u"--poll-files cannot be used with standard input");
+    }
+
     exitOnError();
 }
 
 
+//----------------------------------------------------------------------------
+//  Incremental reload support with --poll-files
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // Identification of the tables which were contributed by one input file:
+    // table id and, for long sections, table id extension. Short sections
+    // are marked with a value above all possible table id extensions.
+    const uint32_t SHORT_SECTION_MARK = 0x10000;
+    typedef std::set<std::pair<ts::TID, uint32_t>> TableIdSet;
+
+    // Load one input file and replace its previous tables in the packetizer.
+    // The tables from the other files are left untouched in the cycle.
+    bool LoadFile(Options& opt, ts::CyclingPacketizer& pzer, const ts::FileNameRate& infile, TableIdSet& tids)
+    {
+        // Load and recompile the section file.
+        ts::SectionFile file(opt.duck);
+        file.setCRCValidation(opt.crc_op);
+        if (!file.load(infile.file_name, opt, opt.inType)) {
+            // On reload error, keep the previous content of this file in the cycle.
+            return false;
+        }
+
+        // Remove the previous tables of this file from the cycling schedule.
+        for (TableIdSet::const_iterator it = tids.begin(); it != tids.end(); ++it) {
+            if (it->second == SHORT_SECTION_MARK) {
+                pzer.removeSections(it->first);
+            }
+            else {
+                pzer.removeSections(it->first, uint16_t(it->second));
+            }
+        }
+
+        // Record the tables of the new content and add them in the schedule.
+        tids.clear();
+        for (ts::SectionPtrVector::const_iterator it = file.sections().begin(); it != file.sections().end(); ++it) {
+            if (!it->isNull()) {
+                const ts::Section& sec(**it);
+                tids.insert(std::make_pair(sec.tableId(), sec.isLongSection() ? uint32_t(sec.tableIdExtension()) : SHORT_SECTION_MARK));
+            }
+        }
+        pzer.addSections(file.sections(), infile.repetition);
+
+        if (opt.verbose()) {
+            std::cerr << "* Loaded " << file.sections().size() << " sections from " << infile.file_name;
+            if (infile.repetition > 0) {
+                std::cerr << ", repetition rate: " << ts::UString::Decimal(infile.repetition) << " ms";
+            }
+            std::cerr << std::endl;
+        }
+        return true;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 //  Program entry point
 //----------------------------------------------------------------------------
@@ -170,13 +256,16 @@ int MainCode(int argc, char *argv[])
     Options opt(argc, argv);
     ts::OutputRedirector output(opt.outfile, opt);
     ts::CyclingPacketizer pzer(opt.pid, opt.stuffing_policy, opt.bitrate);
-    ts::SectionFile file(opt.duck);
-    file.setCRCValidation(opt.crc_op);
+
+    // Tables contributed by each input file, for incremental replacement.
+    std::map<ts::UString, TableIdSet> file_tids;
 
     // Load sections
 
     if (opt.infiles.size() == 0) {
         // Read sections from standard input.
+        ts::SectionFile file(opt.duck);
+        file.setCRCValidation(opt.crc_op);
         if (opt.inType != ts::SectionFile::XML) {
             // Default type for standard input is binary.
             SetBinaryModeStdin(opt);
@@ -191,18 +280,12 @@ int MainCode(int argc, char *argv[])
         }
     }
     else {
-        for (ts::FileNameRateList::const_iterator it = opt.infiles.begin(); it != opt.infiles.end(); ++it) {
-            if (!file.load(it->file_name, opt, opt.inType)) {
+        for (ts::FileNameRateList::iterator it = opt.infiles.begin(); it != opt.infiles.end(); ++it) {
+            if (!LoadFile(opt, pzer, *it, file_tids[it->file_name])) {
                 return EXIT_FAILURE;
             }
-            pzer.addSections(file.sections(), it->repetition);
-            if (opt.verbose()) {
-                std::cerr << "* Loaded " << file.sections().size() << " sections from " << it->file_name;
-                if (it->repetition > 0) {
-                    std::cerr << ", repetition rate: " << ts::UString::Decimal(it->repetition) << " ms";
-                }
-                std::cerr << std::endl;
-            }
+            // Record the initial modification date of the file.
+            it->scanFile();
         }
     }
 
@@ -215,11 +298,24 @@ int MainCode(int argc, char *argv[])
 
     ts::TSPacket pkt;
     ts::PacketCounter count = 0;
+    ts::Time next_poll(ts::Time::CurrentUTC() + opt.poll_interval);
 
     do {
         pzer.getNextPacket(pkt);
         pkt.write(std::cout, opt);
         count++;
+
+        // With --poll-files, reload the modified input files at regular
+        // intervals, between two sections only, and swap their tables in
+        // the cycling schedule without restarting the output stream.
+        if (opt.poll_files && pzer.atSectionBoundary() && ts::Time::CurrentUTC() >= next_poll) {
+            for (ts::FileNameRateList::iterator it = opt.infiles.begin(); it != opt.infiles.end(); ++it) {
+                if (it->scanFile(1, opt) && ts::FileExists(it->file_name)) {
+                    LoadFile(opt, pzer, *it, file_tids[it->file_name]);
+                }
+            }
+            next_poll = ts::Time::CurrentUTC() + opt.poll_interval;
+        }
     } while (opt.valid() && (opt.continuous || !pzer.atCycleBoundary()));
 
 
@@ -37,6 +37,7 @@
 #include "tsByteBlock.h"
 #include "tsFatal.h"
 #include "tsMPEG.h"
+#include "tsSyncScan.h"
 TSDUCK_SOURCE;
 TS_MAIN(MainCode);
 
@@ -317,30 +318,36 @@ int MainCode(int argc, char *argv[])
 
         // Look for a range of packets for at least --min-contiguous bytes
         size_t const search_size = std::min(opt.contig_size, sync_size);
-        uint8_t* const end_search = sync_end - search_size + 1;
-
-        // Search a range of valid packets. Try all expected packet sizes.
-        const uint8_t* start;
-        for (start = sync_buf; start < end_search; start++) {
-            if (opt.packet_size > 0) {
-                if (resync.checkSync(start, search_size, opt.packet_size, opt.header_size)) {
-                    // Found user-specified encapsulation of TS packets
-                    break;
-                }
+
+        // Search a range of valid packets using the vectorized cadence scan.
+        // Try all expected packet sizes, keep the earliest synchronization.
+        const uint8_t* start = sync_buf;
+        if (opt.packet_size > 0) {
+            // User-specified encapsulation of TS packets.
+            const size_t index = ts::FindPacketCadence(sync_buf, sync_size, search_size, opt.packet_size, opt.header_size);
+            if (index != ts::NPOS) {
+                start = sync_buf + index;
+                resync.checkSync(start, search_size, opt.packet_size, opt.header_size);
             }
-            else {
-                if (resync.checkSync(start, search_size, ts::PKT_SIZE, 0)) {
-                    // Found standard TS packets
-                    break;
-                }
-                if (resync.checkSync(start, search_size, ts::PKT_RS_SIZE, 0)) {
-                    // Found TS packets with trailing Reed-Solomon outer FEC
-                    break;
-                }
-                if (resync.checkSync(start, search_size, ts::PKT_M2TS_SIZE, ts::M2TS_HEADER_SIZE)) {
-                    // Found TS packets with leading 4-byte timestamp (M2TS format, blu-ray discs)
-                    break;
-                }
+        }
+        else {
+            // Standard TS packets.
+            const size_t i_ts = ts::FindPacketCadence(sync_buf, sync_size, search_size, ts::PKT_SIZE, 0);
+            // TS packets with trailing Reed-Solomon outer FEC.
+            const size_t i_rs = ts::FindPacketCadence(sync_buf, sync_size, search_size, ts::PKT_RS_SIZE, 0);
+            // TS packets with leading 4-byte timestamp (M2TS format, blu-ray discs).
+            const size_t i_m2 = ts::FindPacketCadence(sync_buf, sync_size, search_size, ts::PKT_M2TS_SIZE, ts::M2TS_HEADER_SIZE);
+            if (i_ts != ts::NPOS && (i_rs == ts::NPOS || i_ts <= i_rs) && (i_m2 == ts::NPOS || i_ts <= i_m2)) {
+                start = sync_buf + i_ts;
+                resync.checkSync(start, search_size, ts::PKT_SIZE, 0);
+            }
+            else if (i_rs != ts::NPOS && (i_m2 == ts::NPOS || i_rs <= i_m2)) {
+                start = sync_buf + i_rs;
+                resync.checkSync(start, search_size, ts::PKT_RS_SIZE, 0);
+            }
+            else if (i_m2 != ts::NPOS) {
+                start = sync_buf + i_m2;
+                resync.checkSync(start, search_size, ts::PKT_M2TS_SIZE, ts::M2TS_HEADER_SIZE);
             }
         }
         if (resync.inputPacketSize() == 0) {
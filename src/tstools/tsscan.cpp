@@ -45,6 +45,10 @@
 #include "tsTime.h"
 #include "tsSysUtils.h"
 #include "tsNullReport.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsGuard.h"
+#include "tsFatal.h"
 TSDUCK_SOURCE;
 TS_MAIN(MainCode);
 
@@ -83,6 +87,7 @@ public:
     bool              list_services;
     bool              global_services;
     ts::MilliSecond   psi_timeout;
+    size_t            parallel;
     const ts::HFBand* hfband;
     ts::UString       channel_file;
     bool              update_channel_file;
@@ -113,6 +118,7 @@ ScanOptions::ScanOptions(int argc, char *argv[]) :
     list_services(false),
     global_services(false),
     psi_timeout(0),
+    parallel(1),
     hfband(),
     channel_file(),
     update_channel_file(false),
@@ -182,6 +188,15 @@ ScanOptions::ScanOptions(int argc, char *argv[]) :
          u"With this option, tsscan checks all offsets and reports that the signal is at offset +1. "
          u"By default, tsscan reports that the signal is found at the central frequency of the channel (offset zero).");
 
+    option(u"parallel-tuners", 0, POSITIVE);
+    help(u"parallel-tuners", u"count",
+         u"For UHF/VHF-band scanning, drive the specified number of tuner devices "
+         u"in parallel. The channels to scan are distributed over all tuners, "
+         u"which overlaps the signal lock waits, the slowest part of a band scan. "
+         u"The additional tuners are picked in device enumeration order. The "
+         u"PSI/SI analysis of the found transport streams remains serialized. "
+         u"The default is 1, no parallel scanning.");
+
     option(u"psi-timeout", 0, UNSIGNED);
     help(u"psi-timeout", u"milliseconds",
          u"Specifies the timeout, in milli-seconds, for PSI/SI table collection. "
@@ -260,6 +275,12 @@ ScanOptions::ScanOptions(int argc, char *argv[]) :
     list_services     = present(u"service-list");
     global_services   = present(u"global-service-list");
     psi_timeout       = intValue<ts::MilliSecond>(u"psi-timeout", DEFAULT_PSI_TIMEOUT);
+    parallel          = intValue<size_t>(u"parallel-tuners", 1);
+
+    if (nit_scan && parallel > 1) {
+        warning(u"--parallel-tuners is ignored with NIT-based scanning");
+        parallel = 1;
+    }
 
     const bool save_channel_file = present(u"save-channels");
     update_channel_file = present(u"update-channels");
@@ -497,14 +518,20 @@ public:
     // tsscan main code.
     void main();
 
+    // Scan channels from the shared work queue using one tuner.
+    // Invoked concurrently by the scan worker threads in parallel mode.
+    void hfBandScanWorker(ts::Tuner& tuner);
+
 private:
     ScanOptions&    _opt;
     ts::Tuner       _tuner;
     ts::ServiceList _services;
     ts::ChannelFile _channels;
+    ts::Mutex       _mutex;         // Protects reporting, services and channels in parallel mode.
+    std::atomic<uint32_t> _next_channel;  // Next channel to scan in the band.
 
     // Analyze a TS and generate relevant info.
-    void scanTS(std::ostream& strm, const ts::UString& margin, ts::ModulationArgs& tparams);
+    void scanTS(std::ostream& strm, const ts::UString& margin, ts::ModulationArgs& tparams, ts::Tuner& tuner);
 
     // UHF/VHF-band scanning
     void hfBandScan();
@@ -518,7 +545,9 @@ ScanContext::ScanContext(ScanOptions& opt) :
     _opt(opt),
     _tuner(_opt.duck),
     _services(),
-    _channels()
+    _channels(),
+    _mutex(),
+    _next_channel(0)
 {
 }
 
@@ -527,13 +556,13 @@ ScanContext::ScanContext(ScanOptions& opt) :
 // Analyze a TS and generate relevant info.
 //----------------------------------------------------------------------------
 
-void ScanContext::scanTS(std::ostream& strm, const ts::UString& margin, ts::ModulationArgs& tparams)
+void ScanContext::scanTS(std::ostream& strm, const ts::UString& margin, ts::ModulationArgs& tparams, ts::Tuner& tuner)
 {
     const bool get_services = _opt.list_services || _opt.global_services;
 
     // Collect info from the TS.
     // Use "PAT only" when we do not need the services or channels file.
-    ts::TSScanner info(_opt.duck, _tuner, _opt.psi_timeout, !get_services && _opt.channel_file.empty());
+    ts::TSScanner info(_opt.duck, tuner, _opt.psi_timeout, !get_services && _opt.channel_file.empty());
 
     if (!tparams.hasModulationArgs()) {
         info.getTunerParameters(tparams);
@@ -597,30 +626,108 @@ void ScanContext::scanTS(std::ostream& strm, const ts::UString& margin, ts::Modu
 }
 
 
+//----------------------------------------------------------------------------
+// Scan worker thread, one per additional tuner in parallel mode.
+//----------------------------------------------------------------------------
+
+class ScanWorker: public ts::Thread
+{
+    TS_NOBUILD_NOCOPY(ScanWorker);
+public:
+    ScanWorker(ScanContext& ctx, ts::Tuner& tuner) : _ctx(ctx), _tuner(tuner) {}
+
+private:
+    ScanContext& _ctx;
+    ts::Tuner&   _tuner;
+
+    // Implementation of Thread.
+    virtual void main() override { _ctx.hfBandScanWorker(_tuner); }
+};
+
+
 //----------------------------------------------------------------------------
 // UHF/VHF-band scanning
 //----------------------------------------------------------------------------
 
-void ScanContext::hfBandScan()
+void ScanContext::hfBandScanWorker(ts::Tuner& tuner)
 {
-    // Loop on all selected UHF channels
-    for (uint32_t chan = _opt.first_channel; chan <= _opt.last_channel; ++chan) {
+    // Loop on channels from the shared work queue until the band is done.
+    for (;;) {
+        const uint32_t chan = _next_channel.fetch_add(1);
+        if (chan > _opt.last_channel) {
+            break;
+        }
 
         // Scan all offsets surrounding the channel.
-        OffsetScanner offscan(_opt, _tuner, chan);
+        OffsetScanner offscan(_opt, tuner, chan);
         if (offscan.signalFound()) {
 
+            // Reporting and PSI/SI analysis are serialized: they use the
+            // shared execution context, service list and channels file.
+            ts::Guard lock(_mutex);
+
             // A channel was found, report its characteristics.
-            std::cout << "* " << _opt.hfband->description(chan, offscan.bestOffset(), _tuner.signalStrength(_opt), _tuner.signalQuality(_opt)) << std::endl;
+            std::cout << "* " << _opt.hfband->description(chan, offscan.bestOffset(), tuner.signalStrength(_opt), tuner.signalQuality(_opt)) << std::endl;
 
             // Analyze PSI/SI if required.
             ts::ModulationArgs tparams;
             offscan.getTunerParameters(tparams);
-            scanTS(std::cout, u"  ", tparams);
+            scanTS(std::cout, u"  ", tparams, tuner);
         }
     }
 }
 
+void ScanContext::hfBandScan()
+{
+    // The work queue is the sequence of channels in the band.
+    _next_channel = _opt.first_channel;
+
+    // With one single tuner, scan from the main thread only.
+    if (_opt.parallel <= 1) {
+        hfBandScanWorker(_tuner);
+        return;
+    }
+
+    // Locate and open additional tuner devices, skipping the main one.
+    std::list<ts::TunerPtr> extra;
+    ts::TunerPtrVector all;
+    ts::Tuner::GetAllTuners(_opt.duck, all, _opt);
+    for (auto it = all.begin(); it != all.end() && extra.size() + 1 < _opt.parallel; ++it) {
+        const ts::UString name((*it)->deviceName());
+        if (name != _tuner.deviceName()) {
+            ts::TunerPtr tuner(new ts::Tuner(_opt.duck));
+            ts::CheckNonNull(tuner.pointer());
+            tuner->setSignalTimeoutSilent(true);
+            if (tuner->open(name, false, _opt)) {
+                extra.push_back(tuner);
+            }
+        }
+    }
+    if (extra.size() + 1 < _opt.parallel) {
+        _opt.warning(u"only %d tuners available for --parallel-tuners %d", {extra.size() + 1, _opt.parallel});
+    }
+
+    // Start one worker thread per additional tuner.
+    std::list<ts::SafePtr<ScanWorker>> workers;
+    for (auto it = extra.begin(); it != extra.end(); ++it) {
+        ts::SafePtr<ScanWorker> worker(new ScanWorker(*this, **it));
+        ts::CheckNonNull(worker.pointer());
+        worker->start();
+        workers.push_back(worker);
+    }
+
+    // The main tuner scans from this thread, like in serial mode.
+    hfBandScanWorker(_tuner);
+
+    // Wait for all workers and release their tuners.
+    for (auto it = workers.begin(); it != workers.end(); ++it) {
+        (*it)->waitForTermination();
+    }
+    for (auto it = extra.begin(); it != extra.end(); ++it) {
+        (*it)->close(_opt);
+    }
+}
+
 
 //----------------------------------------------------------------------------
 // NIT-based scanning
@@ -661,7 +768,7 @@ void ScanContext::nitScan()
                     // Report channel characteristics
                     std::cout << "* Frequency: " << params.shortDescription(_opt.duck, _tuner.signalStrength(_opt), _tuner.signalQuality(_opt)) << std::endl;
                     // Analyze PSI/SI if required
-                    scanTS(std::cout, u"  ", params);
+                    scanTS(std::cout, u"  ", params, _tuner);
                 }
             }
         }
@@ -33,6 +33,7 @@
 
 #include "tsMain.h"
 #include "tsTSFileInputBuffered.h"
+#include "tsNullPacketRun.h"
 #include "tsVariable.h"
 TSDUCK_SOURCE;
 TS_MAIN(MainCode);
@@ -241,7 +242,12 @@ private:
 
 Stuffer::Stuffer(Options& opt) :
     _opt(opt),
-    _input(opt.buffer_size / ts::PKT_SIZE),
+    // The input file is read in one single pass, with background read-ahead.
+    // In that mode, only half of the buffer is guaranteed backward-seekable.
+    // Allocate twice the requested size so that --buffer-size keeps its
+    // documented meaning: the size of the window which must contain two
+    // time stamps in the reference PID.
+    _input(2 * (opt.buffer_size / ts::PKT_SIZE)),
     _output(),
     _tstamp1(),
     _tstamp2(),
@@ -296,11 +302,13 @@ bool Stuffer::getTimeStamp(const ts::TSPacket& pkt, uint64_t& tstamp) const
 
 void Stuffer::writeStuffing(uint64_t count)
 {
+    // Write ranges of the preformed run of null packets.
     while (count > 0) {
-        if (!_output.write(&ts::NullPacket, 1, _opt)) {
+        const size_t chunk = size_t(std::min<uint64_t>(count, ts::NULL_PACKET_RUN_SIZE));
+        if (!_output.write(ts::NullPacketRun(), chunk, _opt)) {
             fatalError();
         }
-        count--;
+        count -= chunk;
     }
 }
 
@@ -441,7 +449,11 @@ void Stuffer::evaluateNextStuffing()
 
 void Stuffer::stuff()
 {
-    // Open input file
+    // Open input file. A background thread keeps the lookahead window topped
+    // up while we alternately scan it for time stamps and copy it to the
+    // output. The input is thus traversed in one single streaming pass and
+    // can be a pipe or a file larger than memory.
+    _input.setReadAhead(true);
     if (!_input.openRead(_opt.input_file, 1, 0, _opt)) {
         fatalError();
     }
@@ -40,6 +40,9 @@
 #include "tsReportWithPrefix.h"
 #include "tsInputRedirector.h"
 #include "tsOutputRedirector.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsGuard.h"
 TSDUCK_SOURCE;
 TS_MAIN(MainCode);
 
@@ -70,6 +73,8 @@ public:
     bool                  packAndFlush;    // Pack and flush incomplete tables before exiting.
     bool                  xmlModel;        // Display XML model instead of compilation.
     bool                  withExtensions;  // XML model with extensions.
+    bool                  incremental;     // Skip input files with up-to-date output files.
+    size_t                maxParallel;     // Maximum number of files to process in parallel.
     ts::xml::Tweaks       xmlTweaks;       // XML formatting options.
     const ts::DVBCharset* defaultCharset;  // Default DVB character set to interpret strings.
 };
@@ -89,6 +94,8 @@ Options::Options(int argc, char *argv[]) :
     packAndFlush(false),
     xmlModel(false),
     withExtensions(false),
+    incremental(false),
+    maxParallel(1),
     xmlTweaks(),
     defaultCharset(nullptr)
 {
@@ -116,6 +123,12 @@ Options::Options(int argc, char *argv[]) :
     help(u"extensions",
          u"With --xml-model, include the content of the available extensions.");
 
+    option(u"incremental", 'i');
+    help(u"incremental",
+         u"Skip input files for which the output file already exists and is more "
+         u"recent than the input file. This is useful to rebuild only the modified "
+         u"files of a large configuration.");
+
     option(u"pack-and-flush");
     help(u"pack-and-flush",
          u"When loading a binary file for decompilation, pack incomplete tables, "
@@ -130,6 +143,13 @@ Options::Options(int argc, char *argv[]) :
          u"directory and default file name. If more than one input file is specified, "
          u"the output path, if present, must be a directory name.");
 
+    option(u"parallel", 'p', POSITIVE);
+    help(u"parallel",
+         u"Process up to the specified number of input files in parallel, using a "
+         u"pool of worker threads. The default is 1, sequential processing. The "
+         u"input files are independent from each other, use as many workers as "
+         u"there are processor cores for large configurations.");
+
     option(u"xml-model", 'x');
     help(u"xml-model",
          u"Display the XML model of the table files. This model is not a full "
@@ -149,6 +169,8 @@ Options::Options(int argc, char *argv[]) :
     packAndFlush = present(u"pack-and-flush");
     xmlModel = present(u"xml-model");
     withExtensions = present(u"extensions");
+    incremental = present(u"incremental");
+    maxParallel = intValue<size_t>(u"parallel", 1);
     outdir = !outfile.empty() && ts::IsDirectory(outfile);
 
     if (!infiles.empty() && xmlModel) {
@@ -229,7 +251,7 @@ namespace {
 //----------------------------------------------------------------------------
 
 namespace {
-    bool ProcessFile(Options& opt, const ts::UString& infile)
+    bool ProcessFile(Options& opt, ts::DuckContext& duck, const ts::UString& infile)
     {
         const ts::SectionFile::FileType inType = ts::SectionFile::GetFileType(infile);
         const bool compile = opt.compile || inType == ts::SectionFile::XML;
@@ -245,7 +267,17 @@ namespace {
             outname += ts::PathSeparator + ts::SectionFile::BuildFileName(ts::BaseName(infile), outType);
         }
 
-        ts::SectionFile file(opt.duck);
+        // In incremental mode, skip the file when the output is up to date.
+        if (opt.incremental) {
+            const ts::Time inTime(ts::GetFileModificationTimeUTC(infile));
+            const ts::Time outTime(ts::GetFileModificationTimeUTC(outname));
+            if (inTime != ts::Time::Epoch && outTime != ts::Time::Epoch && inTime <= outTime) {
+                opt.verbose(u"%s is up to date", {outname});
+                return true;
+            }
+        }
+
+        ts::SectionFile file(duck);
         file.setTweaks(opt.xmlTweaks);
         file.setCRCValidation(ts::CRC32::CHECK);
 
@@ -287,6 +319,61 @@ namespace {
 }
 
 
+//----------------------------------------------------------------------------
+//  Worker thread for parallel file processing.
+//----------------------------------------------------------------------------
+
+namespace {
+    class CompilerThread : public ts::Thread
+    {
+        TS_NOBUILD_NOCOPY(CompilerThread);
+    public:
+        // Constructor. Must be invoked in the main thread, before start(),
+        // because loading the context from the command line is not thread-safe.
+        CompilerThread(Options& opt, ts::Mutex& mutex, size_t& next_file) :
+            _opt(opt),
+            _duck(&opt),
+            _mutex(mutex),
+            _next_file(next_file),
+            _success(true)
+        {
+            _duck.loadArgs(opt);
+        }
+
+        // Overall success of the files which were processed by this thread.
+        bool success() const
+        {
+            return _success;
+        }
+
+        // Thread code: grab input files until the list is exhausted.
+        virtual void main() override
+        {
+            for (;;) {
+                size_t index = 0;
+                {
+                    ts::Guard lock(_mutex);
+                    if (_next_file >= _opt.infiles.size()) {
+                        return;
+                    }
+                    index = _next_file++;
+                }
+                if (!_opt.infiles[index].empty() && !ProcessFile(_opt, _duck, _opt.infiles[index])) {
+                    _success = false;
+                }
+            }
+        }
+
+    private:
+        Options&        _opt;        // Common command line options.
+        ts::DuckContext _duck;       // Private execution context of this worker.
+        ts::Mutex&      _mutex;      // Protect access to the shared file index.
+        size_t&         _next_file;  // Index of next input file to process.
+        bool            _success;    // False when one file failed in this thread.
+    };
+}
+
+
 //----------------------------------------------------------------------------
 //  Program entry point
 //----------------------------------------------------------------------------
@@ -298,10 +385,28 @@ int MainCode(int argc, char *argv[])
     if (opt.xmlModel) {
         ok = DisplayModel(opt);
     }
+    else if (opt.maxParallel > 1 && opt.infiles.size() > 1) {
+        // Parallel processing: a pool of worker threads shares the list of
+        // input files, each file being processed by exactly one worker.
+        ts::Mutex mutex;
+        size_t next_file = 0;
+        std::list<CompilerThread> pool;
+        const size_t count = std::min(opt.maxParallel, opt.infiles.size());
+        for (size_t i = 0; i < count; ++i) {
+            pool.emplace_back(opt, mutex, next_file);
+        }
+        for (auto it = pool.begin(); it != pool.end(); ++it) {
+            it->start();
+        }
+        for (auto it = pool.begin(); it != pool.end(); ++it) {
+            it->waitForTermination();
+            ok = it->success() && ok;
+        }
+    }
     else {
         for (size_t i = 0; i < opt.infiles.size(); ++i) {
             if (!opt.infiles[i].empty()) {
-                ok = ProcessFile(opt, opt.infiles[i]) && ok;
+                ok = ProcessFile(opt, opt.duck, opt.infiles[i]) && ok;
             }
         }
     }
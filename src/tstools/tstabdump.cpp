@@ -218,26 +218,29 @@ namespace {
             opt.pager.output(opt) << "* File: " << file_name << std::endl << std::endl;
         }
 
-        // Load all sections
-        bool ok = false;
-        ts::SectionFile file(opt.duck);
+        // Read the sections one at a time, without loading the whole file,
+        // so that arbitrarily large section dumps can be processed.
+        bool ok = true;
+        ts::SectionFile::BinaryReader reader;
 
         if (file_name.empty()) {
             // no input file specified, use standard input
             SetBinaryModeStdin(opt);
-            ok = file.loadBinary(std::cin, opt);
+            reader.open(std::cin);
         }
         else {
-            ok = file.loadBinary(file_name, opt);
+            ok = reader.open(file_name, opt);
         }
 
         if (ok) {
             // Display all sections.
             opt.duck.setOutput(&opt.pager.output(opt), false);
-            for (ts::SectionPtrVector::const_iterator it = file.sections().begin(); opt.max_tables > 0 && it != file.sections().end(); ++it) {
-                opt.display.displaySection(**it) << std::endl;
+            ts::SectionPtr section;
+            while (opt.max_tables > 0 && reader.readSection(section, opt)) {
+                opt.display.displaySection(*section) << std::endl;
                 opt.max_tables--;
             }
+            ok = reader.success();
         }
 
         return ok;
@@ -62,6 +62,7 @@ public:
     ts::TablesLogger  logger;   // Table logging.
     ts::PagerArgs     pager;    // Output paging options.
     ts::UString       infile;   // Input file name.
+    bool              replay;   // Input file is a binary capture log, not a transport stream.
 };
 
 // Destructor.
@@ -74,7 +75,8 @@ Options::Options(int argc, char *argv[]) :
     display(duck),
     logger(display),
     pager(true, true),
-    infile()
+    infile(),
+    replay(false)
 {
     duck.defineArgsForCAS(*this);
     duck.defineArgsForPDS(*this);
@@ -87,6 +89,13 @@ Options::Options(int argc, char *argv[]) :
     option(u"", 0, STRING, 0, 1);
     help(u"", u"Input MPEG capture file (standard input if omitted).");
 
+    option(u"replay");
+    help(u"replay",
+         u"The input file is a binary capture log file, as created by --capture-file, "
+         u"not a transport stream. The sections are formatted using the other output "
+         u"options, with their original capture time stamps. The sections are processed "
+         u"individually, as with --all-sections.");
+
     analyze(argc, argv);
 
     duck.loadArgs(*this);
@@ -95,6 +104,7 @@ Options::Options(int argc, char *argv[]) :
     display.loadArgs(duck, *this);
 
     infile = value(u"");
+    replay = present(u"replay");
 
     exitOnError();
 }
@@ -113,12 +123,22 @@ int MainCode(int argc, char *argv[])
     // Redirect display on pager process or stdout only.
     opt.duck.setOutput(&opt.pager.output(opt), false);
 
-    // Read all packets in the file and pass them to the logger
     if (!opt.logger.open()) {
         return EXIT_FAILURE;
     }
-    while (!opt.logger.completed() && pkt.read(std::cin, true, opt)) {
-        opt.logger.feedPacket(pkt);
+    if (opt.replay) {
+        // The input file is a binary capture log, replay the sections it contains.
+        ts::SectionPtr section;
+        ts::Time timestamp;
+        while (!opt.logger.completed() && ts::TablesLogger::GetCaptureRecord(std::cin, section, timestamp, opt)) {
+            opt.logger.replaySection(*section, timestamp);
+        }
+    }
+    else {
+        // Read all packets in the file and pass them to the logger.
+        while (!opt.logger.completed() && pkt.read(std::cin, true, opt)) {
+            opt.logger.feedPacket(pkt);
+        }
     }
     opt.logger.close();
 
@@ -0,0 +1,357 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Throughput benchmarks for the core hot paths of the library.
+//
+//  Description:
+//    This program is not part of the unitary tests (the tests in utest*
+//    files check correctness, this one measures speed). It times the
+//    packet buffer hand-off, the section demux, the packetizer, the
+//    CRC32 computation, UDP loopback I/O and UString formatting. Each
+//    benchmark is repeated several times and the minimum, median and
+//    standard deviation of the observed rates are reported, so that two
+//    builds or two compilers can be compared without being fooled by a
+//    single noisy run. Build and run it with "make bench" in this
+//    directory.
+//
+//    The results can be reported as a JSON object using --json, for
+//    trend tracking across versions of the library.
+//
+//----------------------------------------------------------------------------
+
+#include "tsArgs.h"
+#include "tsByteBlock.h"
+#include "tsMonotonic.h"
+#include "tsCRC32.h"
+#include "tsTSPacket.h"
+#include "tsSectionDemux.h"
+#include "tsCyclingPacketizer.h"
+#include "tsPAT.h"
+#include "tsDuckContext.h"
+#include "tsUDPSocket.h"
+#include "tsNullReport.h"
+#include "tsjsonObject.h"
+#include "tsjsonArray.h"
+#include "tsjsonNumber.h"
+#include "tsjsonString.h"
+#include <cmath>
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Command line options.
+//----------------------------------------------------------------------------
+
+namespace {
+    class BenchOptions: public ts::Args
+    {
+        TS_NOBUILD_NOCOPY(BenchOptions);
+    public:
+        BenchOptions(int argc, char *argv[]);
+
+        bool            json;      // Report results in JSON format.
+        ts::MilliSecond min_time;  // Minimum measurement time per repetition.
+        size_t          repeat;    // Number of repetitions per benchmark.
+    };
+}
+
+BenchOptions::BenchOptions(int argc, char *argv[]) :
+    Args(u"Measure the throughput of the core hot paths of the library", u"[options]"),
+    json(false),
+    min_time(0),
+    repeat(0)
+{
+    option(u"json", 'j');
+    help(u"json", u"Report the results as one JSON object on the standard output.");
+
+    option(u"time", 't', POSITIVE);
+    help(u"time", u"milliseconds",
+         u"Minimum measurement time for each repetition in milliseconds. "
+         u"The default is 200 ms.");
+
+    option(u"repeat", 'r', POSITIVE);
+    help(u"repeat", u"count",
+         u"Number of repetitions of each benchmark. The reported values "
+         u"are computed over all repetitions. The default is 7.");
+
+    analyze(argc, argv);
+
+    json = present(u"json");
+    min_time = intValue<ts::MilliSecond>(u"time", 200);
+    repeat = intValue<size_t>(u"repeat", 7);
+
+    exitOnError();
+}
+
+
+//----------------------------------------------------------------------------
+// Benchmark infrastructure.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // One benchmark result, with the statistics over all repetitions.
+    struct Result
+    {
+        ts::UString name;    // Benchmark name.
+        ts::UString unit;    // Unit of the rates ("mb/s" or "op/s").
+        int64_t     minimum; // Minimum observed rate, -1 on error.
+        int64_t     median;  // Median of the observed rates.
+        int64_t     stddev;  // Standard deviation of the observed rates.
+    };
+
+    // Fill a buffer with a deterministic pattern.
+    void fillPattern(ts::ByteBlock& data)
+    {
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = uint8_t(i * 7 + 13);
+        }
+    }
+
+    // Repeat one operation during at least min_time.
+    // Return the observed rate in units per second or -1 on error.
+    template <typename OP>
+    int64_t measureOnce(OP op, uint64_t units_per_op, ts::MilliSecond min_time)
+    {
+        const ts::NanoSecond min_ns = min_time * ts::NanoSecPerMilliSec;
+        const ts::NanoSecond start = ts::Monotonic::NanoClock();
+        uint64_t total = 0;
+        ts::NanoSecond elapsed = 0;
+        do {
+            // Amortize the clock reads over small batches of operations.
+            for (size_t i = 0; i < 32; ++i) {
+                if (!op()) {
+                    return -1;
+                }
+            }
+            total += 32 * units_per_op;
+            elapsed = ts::Monotonic::NanoClock() - start;
+        } while (elapsed < min_ns);
+        // units / (ns / 10^9) == units * 10^9 / ns
+        return elapsed <= 0 ? -1 : int64_t((total * uint64_t(ts::NanoSecPerSec / ts::NanoSecPerMilliSec) * uint64_t(ts::MilliSecPerSec)) / uint64_t(elapsed));
+    }
+
+    // Run all repetitions of one benchmark and compute the statistics.
+    // The scale divides the raw rate in units per second (1000000 to
+    // convert bytes per second into MB/s, 1 to keep operations per second).
+    template <typename OP>
+    void bench(std::vector<Result>& results,
+               const ts::UString& name,
+               const ts::UString& unit,
+               OP op,
+               uint64_t units_per_op,
+               uint64_t scale,
+               const BenchOptions& opt)
+    {
+        Result res{name, unit, -1, -1, -1};
+        std::vector<int64_t> rates;
+        for (size_t i = 0; i < opt.repeat; ++i) {
+            const int64_t rate = measureOnce(op, units_per_op, opt.min_time);
+            if (rate < 0) {
+                results.push_back(res);
+                return;
+            }
+            rates.push_back(rate / int64_t(scale));
+        }
+        std::sort(rates.begin(), rates.end());
+        res.minimum = rates.front();
+        res.median = rates[rates.size() / 2];
+        double sum = 0.0;
+        for (size_t i = 0; i < rates.size(); ++i) {
+            sum += double(rates[i]);
+        }
+        const double mean = sum / double(rates.size());
+        double var = 0.0;
+        for (size_t i = 0; i < rates.size(); ++i) {
+            var += (double(rates[i]) - mean) * (double(rates[i]) - mean);
+        }
+        res.stddev = int64_t(std::sqrt(var / double(rates.size())));
+        results.push_back(res);
+    }
+
+    // A section handler which only counts sections, to force the complete
+    // section path in the demux without the cost of a real application.
+    class SectionCounter: public ts::SectionHandlerInterface
+    {
+    public:
+        SectionCounter() : count(0) {}
+        size_t count;
+        virtual void handleSection(ts::SectionDemux& demux, const ts::Section& section) override
+        {
+            count++;
+        }
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Program entry point.
+//----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    BenchOptions opt(argc, argv);
+    std::vector<Result> results;
+    ts::DuckContext duck;
+
+    // Packet buffer hand-off: copy a window of packets between two buffers,
+    // the elementary operation behind every buffered packet exchange.
+    {
+        const size_t WINDOW = 1024;
+        std::vector<ts::TSPacket> src(WINDOW, ts::NullPacket);
+        std::vector<ts::TSPacket> dst(WINDOW);
+        bench(results, u"packet-window-copy", u"mb/s", [&]() {
+            ts::TSPacket::Copy(dst.data(), src.data(), WINDOW);
+            return true;
+        }, WINDOW * ts::PKT_SIZE, 1000000, opt);
+    }
+
+    // A PAT with a handful of services, the payload of the demux and
+    // packetizer benchmarks.
+    ts::PAT pat(1, true, 0x1234);
+    for (uint16_t srv = 1; srv <= 10; ++srv) {
+        pat.pmts[srv] = ts::PID(0x100 + srv);
+    }
+
+    // Packetizer output: cycle the PAT forever and time packet generation.
+    {
+        ts::CyclingPacketizer pzer(ts::PID_PAT, ts::CyclingPacketizer::ALWAYS);
+        pzer.addTable(duck, pat);
+        ts::TSPacket pkt;
+        bench(results, u"packetizer", u"mb/s", [&]() {
+            return pzer.getNextPacket(pkt);
+        }, ts::PKT_SIZE, 1000000, opt);
+    }
+
+    // Section demux feed: replay a pre-packetized PAT cycle and time the
+    // section reassembly, including the section handler invocation.
+    {
+        ts::CyclingPacketizer pzer(ts::PID_PAT, ts::CyclingPacketizer::ALWAYS);
+        pzer.addTable(duck, pat);
+        std::vector<ts::TSPacket> cycle(64);
+        for (size_t i = 0; i < cycle.size(); ++i) {
+            pzer.getNextPacket(cycle[i]);
+        }
+        SectionCounter counter;
+        ts::SectionDemux demux(duck, nullptr, &counter);
+        demux.addPID(ts::PID_PAT);
+        bench(results, u"section-demux", u"mb/s", [&]() {
+            demux.feedPackets(cycle.data(), cycle.size());
+            return true;
+        }, cycle.size() * ts::PKT_SIZE, 1000000, opt);
+    }
+
+    // CRC32 over a typical 7-packet UDP payload.
+    {
+        ts::ByteBlock data(7 * ts::PKT_SIZE);
+        fillPattern(data);
+        bench(results, u"crc32", u"mb/s", [&]() {
+            ts::CRC32 crc;
+            crc.add(data.data(), data.size());
+            volatile uint32_t value = crc.value();
+            (void)value;
+            return true;
+        }, data.size(), 1000000, opt);
+    }
+
+    // UDP loopback: send and receive back 7-packet datagrams on localhost.
+    // The benchmark is skipped (reported as failed) when the local network
+    // stack is not usable, for instance in a restricted build sandbox.
+    {
+        ts::UDPSocket receiver;
+        ts::UDPSocket sender;
+        const ts::SocketAddress addr(ts::IPAddress::LocalHost, 0);
+        ts::ByteBlock data(7 * ts::PKT_SIZE);
+        fillPattern(data);
+        bool ready =
+            receiver.open(NULLREP) &&
+            receiver.bind(addr, NULLREP) &&
+            sender.open(NULLREP);
+        ts::SocketAddress dest;
+        if (ready) {
+            ready = receiver.getLocalAddress(dest, NULLREP);
+        }
+        if (ready) {
+            ts::ByteBlock buf(data.size());
+            bench(results, u"udp-loopback", u"mb/s", [&]() {
+                size_t ret_size = 0;
+                ts::SocketAddress sender_addr;
+                ts::SocketAddress dest_addr;
+                return sender.send(data.data(), data.size(), dest, NULLREP) &&
+                       receiver.receive(buf.data(), buf.size(), ret_size, sender_addr, dest_addr, nullptr, NULLREP) &&
+                       ret_size == data.size();
+            }, data.size(), 1000000, opt);
+        }
+        else {
+            results.push_back(Result{u"udp-loopback", u"mb/s", -1, -1, -1});
+        }
+    }
+
+    // UString formatting: a typical log or report line.
+    {
+        uint64_t seq = 0;
+        bench(results, u"ustring-format", u"op/s", [&]() {
+            const ts::UString s(ts::UString::Format(u"PID 0x%X (%d), packet %'d, %s", {seq & 0x1FFF, seq & 0x1FFF, seq, u"discontinuity"}));
+            seq++;
+            return !s.empty();
+        }, 1, 1, opt);
+    }
+
+    // Report the results.
+    bool success = true;
+    if (opt.json) {
+        ts::json::Object root;
+        ts::json::ValuePtr bench_array(new ts::json::Array);
+        for (size_t i = 0; i < results.size(); ++i) {
+            ts::json::ValuePtr obj(new ts::json::Object);
+            obj->add(u"name", ts::json::ValuePtr(new ts::json::String(results[i].name)));
+            obj->add(u"unit", ts::json::ValuePtr(new ts::json::String(results[i].unit)));
+            obj->add(u"min", ts::json::ValuePtr(new ts::json::Number(results[i].minimum)));
+            obj->add(u"median", ts::json::ValuePtr(new ts::json::Number(results[i].median)));
+            obj->add(u"stddev", ts::json::ValuePtr(new ts::json::Number(results[i].stddev)));
+            bench_array->set(obj);
+            success = success && results[i].minimum >= 0;
+        }
+        root.add(u"benchmarks", bench_array);
+        std::cout << root.printed() << std::endl;
+    }
+    else {
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& res(results[i]);
+            if (res.minimum < 0) {
+                std::cout << ts::UString::Format(u"%-20s failed", {res.name}) << std::endl;
+                success = false;
+            }
+            else {
+                std::cout << ts::UString::Format(u"%-20s median: %'12d %s, min: %'12d, stddev: %'d", {res.name, res.median, res.unit, res.minimum, res.stddev}) << std::endl;
+            }
+        }
+    }
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
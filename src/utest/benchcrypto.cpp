@@ -0,0 +1,272 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  Micro-benchmarks for the cryptographic classes.
+//
+//  Description:
+//    This program is not part of the unitary tests (the tests in utest*
+//    files check correctness, this one measures speed). It times the
+//    scramblers, hashes and checksums over representative TS payload
+//    sizes and reports the throughput of each algorithm in MB/s.
+//    Build and run it with "make bench" in this directory.
+//
+//    The results can be reported as a JSON object using --json, for
+//    trend tracking across versions of the library.
+//
+//----------------------------------------------------------------------------
+
+#include "tsArgs.h"
+#include "tsByteBlock.h"
+#include "tsMonotonic.h"
+#include "tsAES.h"
+#include "tsDVBCSA2.h"
+#include "tsDVBCISSA.h"
+#include "tsIDSA.h"
+#include "tsSHA1.h"
+#include "tsSHA256.h"
+#include "tsSHA512.h"
+#include "tsCRC32.h"
+#include "tsjsonObject.h"
+#include "tsjsonArray.h"
+#include "tsjsonNumber.h"
+#include "tsjsonString.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Command line options.
+//----------------------------------------------------------------------------
+
+namespace {
+    class BenchOptions: public ts::Args
+    {
+        TS_NOBUILD_NOCOPY(BenchOptions);
+    public:
+        BenchOptions(int argc, char *argv[]);
+
+        bool            json;      // Report results in JSON format.
+        ts::MilliSecond min_time;  // Minimum measurement time per benchmark.
+    };
+}
+
+BenchOptions::BenchOptions(int argc, char *argv[]) :
+    Args(u"Measure the throughput of the cryptographic classes", u"[options]"),
+    json(false),
+    min_time(0)
+{
+    option(u"json", 'j');
+    help(u"json", u"Report the results as one JSON object on the standard output.");
+
+    option(u"time", 't', POSITIVE);
+    help(u"time", u"milliseconds",
+         u"Minimum measurement time for each benchmark in milliseconds. "
+         u"The default is 500 ms.");
+
+    analyze(argc, argv);
+
+    json = present(u"json");
+    min_time = intValue<ts::MilliSecond>(u"time", 500);
+
+    exitOnError();
+}
+
+
+//----------------------------------------------------------------------------
+// Benchmark infrastructure.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // One benchmark result.
+    struct Result
+    {
+        ts::UString algo;  // Algorithm name.
+        size_t      size;  // Data size per operation in bytes.
+        int64_t     mbps;  // Throughput in MB/s, -1 on error.
+    };
+
+    // Fill a buffer with a deterministic pattern.
+    void fillPattern(ts::ByteBlock& data)
+    {
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = uint8_t(i * 7 + 13);
+        }
+    }
+
+    // Repeat one operation during at least min_time.
+    // Return the observed throughput in MB/s or -1 on error.
+    template <typename OP>
+    int64_t throughput(OP op, size_t bytes_per_op, ts::MilliSecond min_time)
+    {
+        const ts::NanoSecond min_ns = min_time * ts::NanoSecPerMilliSec;
+        ts::Monotonic start(true);
+        ts::Monotonic now(start);
+        uint64_t total = 0;
+        ts::NanoSecond elapsed = 0;
+        do {
+            // Amortize the clock reads over small batches of operations.
+            for (size_t i = 0; i < 64; ++i) {
+                if (!op()) {
+                    return -1;
+                }
+            }
+            total += 64 * uint64_t(bytes_per_op);
+            now.getSystemTime();
+            elapsed = now - start;
+        } while (elapsed < min_ns);
+        // bytes / (ns / 10^9) / 10^6 == bytes * 1000 / ns
+        return elapsed <= 0 ? -1 : int64_t((total * 1000) / uint64_t(elapsed));
+    }
+
+    // Benchmark a scrambler / block cipher, ciphering separate input and
+    // output buffers (the native entry point of the chaining modes).
+    void benchCipher(std::vector<Result>& results, ts::BlockCipher& algo, const ts::ByteBlock& key, size_t size, ts::MilliSecond min_time)
+    {
+        ts::ByteBlock src(size);
+        ts::ByteBlock dst(size);
+        fillPattern(src);
+        Result res{algo.name(), size, -1};
+        if (algo.setKey(key.data(), key.size())) {
+            res.mbps = throughput([&]() { return algo.encrypt(src.data(), src.size(), dst.data(), dst.size()); }, size, min_time);
+        }
+        results.push_back(res);
+    }
+
+    // Benchmark a scrambler which natively ciphers its data in place.
+    void benchCipherInPlace(std::vector<Result>& results, ts::BlockCipher& algo, const ts::ByteBlock& key, size_t size, ts::MilliSecond min_time)
+    {
+        ts::ByteBlock data(size);
+        fillPattern(data);
+        Result res{algo.name(), size, -1};
+        if (algo.setKey(key.data(), key.size())) {
+            res.mbps = throughput([&]() { return algo.encryptInPlace(data.data(), data.size()); }, size, min_time);
+        }
+        results.push_back(res);
+    }
+
+    // Benchmark a hash function.
+    void benchHash(std::vector<Result>& results, ts::Hash& algo, size_t size, ts::MilliSecond min_time)
+    {
+        ts::ByteBlock data(size);
+        uint8_t digest[64];  // large enough for all hashes
+        fillPattern(data);
+        Result res{algo.name(), size, -1};
+        res.mbps = throughput([&]() { return algo.hash(data.data(), data.size(), digest, sizeof(digest)); }, size, min_time);
+        results.push_back(res);
+    }
+
+    // Benchmark the CRC32 class.
+    void benchCRC32(std::vector<Result>& results, size_t size, ts::MilliSecond min_time)
+    {
+        ts::ByteBlock data(size);
+        fillPattern(data);
+        Result res{u"CRC32", size, -1};
+        res.mbps = throughput([&]() {
+            ts::CRC32 crc;
+            crc.add(data.data(), data.size());
+            volatile uint32_t value = crc.value();
+            (void)value;
+            return true;
+        }, size, min_time);
+        results.push_back(res);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Program entry point.
+//----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    BenchOptions opt(argc, argv);
+    std::vector<Result> results;
+
+    // Deterministic keys, the key value does not matter for timing.
+    ts::ByteBlock key8(8);
+    ts::ByteBlock key16(16);
+    fillPattern(key8);
+    fillPattern(key16);
+
+    // TS scramblers over one maximum TS payload (DVB-CISSA ciphers
+    // whole AES blocks only, the residue is left clear).
+    ts::DVBCSA2 csa2;
+    benchCipherInPlace(results, csa2, key8, 184, opt.min_time);
+    ts::DVBCISSA cissa;
+    benchCipher(results, cissa, key16, 176, opt.min_time);
+    ts::IDSA idsa;
+    benchCipher(results, idsa, key16, 184, opt.min_time);
+
+    // Raw AES, from a single block to bulk sizes.
+    ts::AES aes;
+    benchCipher(results, aes, key16, 16, opt.min_time);
+    benchCipher(results, aes, key16, 4096, opt.min_time);
+    benchCipher(results, aes, key16, 65536, opt.min_time);
+
+    // Hashes and checksums over a TS payload, a PES-like chunk and a bulk size.
+    static const size_t hash_sizes[] = {184, 1316, 65536};
+    for (size_t i = 0; i < sizeof(hash_sizes) / sizeof(hash_sizes[0]); ++i) {
+        ts::SHA1 sha1;
+        benchHash(results, sha1, hash_sizes[i], opt.min_time);
+        ts::SHA256 sha256;
+        benchHash(results, sha256, hash_sizes[i], opt.min_time);
+        ts::SHA512 sha512;
+        benchHash(results, sha512, hash_sizes[i], opt.min_time);
+        benchCRC32(results, hash_sizes[i], opt.min_time);
+    }
+
+    // Report the results.
+    bool success = true;
+    if (opt.json) {
+        ts::json::Object root;
+        ts::json::ValuePtr bench(new ts::json::Array);
+        for (size_t i = 0; i < results.size(); ++i) {
+            ts::json::ValuePtr obj(new ts::json::Object);
+            obj->add(u"algorithm", ts::json::ValuePtr(new ts::json::String(results[i].algo)));
+            obj->add(u"data-size", ts::json::ValuePtr(new ts::json::Number(int64_t(results[i].size))));
+            obj->add(u"mb-per-sec", ts::json::ValuePtr(new ts::json::Number(results[i].mbps)));
+            bench->set(obj);
+            success = success && results[i].mbps >= 0;
+        }
+        root.add(u"benchmarks", bench);
+        std::cout << root.printed() << std::endl;
+    }
+    else {
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (results[i].mbps < 0) {
+                std::cout << ts::UString::Format(u"%-12s %7d bytes: error", {results[i].algo, results[i].size}) << std::endl;
+                success = false;
+            }
+            else {
+                std::cout << ts::UString::Format(u"%-12s %7d bytes: %'8d MB/s", {results[i].algo, results[i].size, results[i].mbps}) << std::endl;
+            }
+        }
+    }
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -51,10 +51,12 @@ public:
 
     void testAppend();
     void testFile();
+    void testRecycle();
 
     TSUNIT_TEST_BEGIN(ByteBlockTest);
     TSUNIT_TEST(testAppend);
     TSUNIT_TEST(testFile);
+    TSUNIT_TEST(testRecycle);
     TSUNIT_TEST_END();
 
 private:
@@ -245,3 +247,33 @@ void ByteBlockTest::testFile()
     TSUNIT_EQUAL(999, bb1.size());
     TSUNIT_ASSERT(bb1 == bb);
 }
+
+void ByteBlockTest::testRecycle()
+{
+    // Dynamically allocated ByteBlock objects go through the class-specific
+    // operator new / delete which recycle fixed-size object nodes in a
+    // thread-local free list.
+    ts::ByteBlock* bb1 = new ts::ByteBlock(256);
+    TSUNIT_ASSERT(bb1 != nullptr);
+    bb1->appendUInt32(0x01020304);
+    TSUNIT_EQUAL(260, bb1->size());
+    delete bb1;
+
+#if !defined(TS_NO_BYTEBLOCK_RECYCLE)
+    // The next allocation on the same thread shall reuse the recycled node.
+    ts::ByteBlock* bb2 = new ts::ByteBlock();
+    TSUNIT_ASSERT(bb2 == bb1);
+    TSUNIT_ASSERT(bb2->empty());
+    delete bb2;
+#endif
+
+    // Stress the recycling path, check content integrity.
+    for (size_t i = 0; i < 1000; ++i) {
+        ts::ByteBlockPtr bp(new ts::ByteBlock(i % 256, uint8_t(i)));
+        TSUNIT_EQUAL(i % 256, bp->size());
+        if (!bp->empty()) {
+            TSUNIT_EQUAL(uint8_t(i), bp->at(0));
+            TSUNIT_EQUAL(uint8_t(i), bp->at(bp->size() - 1));
+        }
+    }
+}
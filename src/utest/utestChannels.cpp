@@ -33,6 +33,7 @@
 
 #include "tsChannelFile.h"
 #include "tsNullReport.h"
+#include "tsSysUtils.h"
 #include "tsunit.h"
 TSDUCK_SOURCE;
 
@@ -48,9 +49,11 @@ public:
     virtual void afterTest() override;
 
     void testText();
+    void testBinaryCache();
 
     TSUNIT_TEST_BEGIN(ChannelsTest);
     TSUNIT_TEST(testText);
+    TSUNIT_TEST(testBinaryCache);
     TSUNIT_TEST_END();
 };
 
@@ -232,3 +235,47 @@ void ChannelsTest::testText()
 
     TSUNIT_EQUAL(document, channels.toXML());
 }
+
+void ChannelsTest::testBinaryCache()
+{
+    static const ts::UChar* const document =
+        u"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        u"<tsduck>\n"
+        u"  <network id=\"0x7883\" type=\"DVB-C\">\n"
+        u"    <ts id=\"0x7890\" onid=\"0x7412\">\n"
+        u"      <dvbc frequency=\"789,654,123\" symbolrate=\"6,900,000\" modulation=\"64-QAM\"/>\n"
+        u"      <service id=\"0x0056\" name=\"Foo Channel\" provider=\"Foo Provider\" LCN=\"23\" PMTPID=\"0x0789\" type=\"0x12\" cas=\"true\"/>\n"
+        u"      <service id=\"0x0879\"/>\n"
+        u"    </ts>\n"
+        u"  </network>\n"
+        u"</tsduck>\n"
+        u"";
+
+    const ts::UString xmlName(ts::TempFile(u".xml"));
+    const ts::UString cacheName(ts::ChannelFile::BinaryCacheName(xmlName));
+
+    // Create the XML file.
+    ts::ChannelFile channels;
+    TSUNIT_ASSERT(channels.parse(document));
+    TSUNIT_ASSERT(channels.save(xmlName));
+
+    // The first load parses the XML file and regenerates the cache.
+    ts::ChannelFile file1;
+    TSUNIT_ASSERT(file1.load(xmlName));
+    TSUNIT_ASSERT(ts::FileExists(cacheName));
+    TSUNIT_EQUAL(document, file1.toXML());
+
+    // The second load uses the cache and gives the same content.
+    ts::ChannelFile file2;
+    TSUNIT_ASSERT(file2.load(xmlName));
+    TSUNIT_EQUAL(document, file2.toXML());
+
+    // Same content again with the cache disabled.
+    ts::ChannelFile file3;
+    file3.setBinaryCache(false);
+    TSUNIT_ASSERT(file3.load(xmlName));
+    TSUNIT_EQUAL(document, file3.toXML());
+
+    ts::DeleteFile(xmlName);
+    ts::DeleteFile(cacheName);
+}
@@ -49,10 +49,12 @@ public:
 
     void testSection();
     void testBuild();
+    void testReference();
 
     TSUNIT_TEST_BEGIN(MPEPacketTest);
     TSUNIT_TEST(testSection);
     TSUNIT_TEST(testBuild);
+    TSUNIT_TEST(testReference);
     TSUNIT_TEST_END();
 };
 
@@ -142,3 +144,39 @@ void MPEPacketTest::testBuild()
     TSUNIT_ASSERT(mpe2.udpMessage() != nullptr);
     TSUNIT_EQUAL(0, ::memcmp(mpe2.udpMessage(), ref, mpe2.udpMessageSize()));
 }
+
+void MPEPacketTest::testReference()
+{
+    const ts::PID pid = 1234;
+    ts::Section sec(psi_mpe_sections, sizeof(psi_mpe_sections), pid, ts::CRC32::CHECK);
+    TSUNIT_ASSERT(sec.isValid());
+
+    // A view does not copy the datagram, it points into the section payload.
+    ts::MPEPacket mpe;
+    mpe.reference(sec);
+    TSUNIT_ASSERT(mpe.isValid());
+    TSUNIT_EQUAL(pid, mpe.sourcePID());
+    TSUNIT_ASSERT(mpe.datagram() == sec.content() + 12);
+    TSUNIT_EQUAL(sec.size() - 16, mpe.datagramSize());
+    TSUNIT_ASSERT(mpe.destinationIPAddress() == ts::IPAddress(224, 20, 20, 2));
+    TSUNIT_ASSERT(mpe.sourceIPAddress() == ts::IPAddress(192, 168, 135, 190));
+    TSUNIT_EQUAL(6000, mpe.sourceUDPPort());
+    TSUNIT_EQUAL(6000, mpe.destinationUDPPort());
+    TSUNIT_EQUAL(1468, mpe.udpMessageSize());
+
+    // The section buffer is shared, the view survives the section object.
+    ts::MPEPacket mpe2(mpe, ts::SHARE);
+    sec.clear();
+    TSUNIT_ASSERT(mpe2.isValid());
+    TSUNIT_EQUAL(1468, mpe2.udpMessageSize());
+    TSUNIT_ASSERT(mpe2.destinationIPAddress() == ts::IPAddress(224, 20, 20, 2));
+
+    // Modifying a view first duplicates the datagram into a private buffer.
+    const uint8_t* const viewData = mpe2.datagram();
+    mpe2.setDestinationUDPPort(4001);
+    TSUNIT_ASSERT(mpe2.isValid());
+    TSUNIT_ASSERT(mpe2.datagram() != viewData);
+    TSUNIT_EQUAL(4001, mpe2.destinationUDPPort());
+    TSUNIT_EQUAL(6000, mpe2.sourceUDPPort());
+    TSUNIT_EQUAL(1468, mpe2.udpMessageSize());
+}
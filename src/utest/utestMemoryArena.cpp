@@ -0,0 +1,213 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for classes ts::MemoryArena and ts::MemoryPool
+//
+//----------------------------------------------------------------------------
+
+#include "tsMemoryArena.h"
+#include "tsMemoryPool.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class MemoryArenaTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testArena();
+    void testArenaScope();
+    void testArenaAllocator();
+    void testPool();
+    void testPoolAllocator();
+
+    TSUNIT_TEST_BEGIN(MemoryArenaTest);
+    TSUNIT_TEST(testArena);
+    TSUNIT_TEST(testArenaScope);
+    TSUNIT_TEST(testArenaAllocator);
+    TSUNIT_TEST(testPool);
+    TSUNIT_TEST(testPoolAllocator);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(MemoryArenaTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void MemoryArenaTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void MemoryArenaTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+// Test case: basic arena allocations, alignment, reset.
+void MemoryArenaTest::testArena()
+{
+    ts::MemoryArena arena(1024);
+    TSUNIT_EQUAL(size_t(0), arena.allocatedBytes());
+
+    // Basic allocations, all distinct, all writable.
+    uint8_t* p1 = reinterpret_cast<uint8_t*>(arena.allocate(100));
+    uint8_t* p2 = reinterpret_cast<uint8_t*>(arena.allocate(100));
+    TSUNIT_ASSERT(p1 != nullptr);
+    TSUNIT_ASSERT(p2 != nullptr);
+    TSUNIT_ASSERT(p1 != p2);
+    ::memset(p1, 0xAA, 100);
+    ::memset(p2, 0xBB, 100);
+    TSUNIT_EQUAL(0xAA, p1[99]);
+    TSUNIT_EQUAL(0xBB, p2[0]);
+    TSUNIT_ASSERT(arena.allocatedBytes() >= 200);
+
+    // Alignment is honored.
+    void* p3 = arena.allocate(10, 64);
+    TSUNIT_ASSERT(p3 != nullptr);
+    TSUNIT_EQUAL(size_t(0), size_t(reinterpret_cast<uintptr_t>(p3) % 64));
+
+    // Allocations larger than the chunk size work too.
+    void* p4 = arena.allocate(10000);
+    TSUNIT_ASSERT(p4 != nullptr);
+    ::memset(p4, 0xCC, 10000);
+
+    // Reset releases everything at once.
+    arena.reset();
+    TSUNIT_EQUAL(size_t(0), arena.allocatedBytes());
+    TSUNIT_ASSERT(arena.allocate(100) != nullptr);
+}
+
+// Test case: scope-based reset.
+void MemoryArenaTest::testArenaScope()
+{
+    ts::MemoryArena arena(1024);
+    uint8_t* outer = reinterpret_cast<uint8_t*>(arena.allocate(16));
+    ::memset(outer, 0x11, 16);
+    const size_t before = arena.allocatedBytes();
+    {
+        ts::MemoryArena::Scope scope(arena);
+        // Enough to overflow into additional chunks.
+        for (int i = 0; i < 100; ++i) {
+            TSUNIT_ASSERT(arena.allocate(100) != nullptr);
+        }
+        TSUNIT_ASSERT(arena.allocatedBytes() > before);
+    }
+    // The scope was left, its allocations are gone, the outer one remains.
+    TSUNIT_EQUAL(before, arena.allocatedBytes());
+    TSUNIT_EQUAL(0x11, outer[15]);
+}
+
+// Test case: standard containers over an arena.
+void MemoryArenaTest::testArenaAllocator()
+{
+    ts::MemoryArena arena;
+    {
+        std::vector<int, ts::ArenaAllocator<int>> vec((ts::ArenaAllocator<int>(arena)));
+        std::list<int, ts::ArenaAllocator<int>> lst((ts::ArenaAllocator<int>(arena)));
+        for (int i = 0; i < 1000; ++i) {
+            vec.push_back(i);
+            lst.push_back(i);
+        }
+        TSUNIT_EQUAL(size_t(1000), vec.size());
+        TSUNIT_EQUAL(size_t(1000), lst.size());
+        TSUNIT_EQUAL(999, vec.back());
+        TSUNIT_EQUAL(999, lst.back());
+        TSUNIT_ASSERT(arena.allocatedBytes() >= 1000 * sizeof(int));
+        // The containers are destructed before the arena, then reset is safe.
+    }
+    arena.reset();
+}
+
+// Test case: fixed-size block pool.
+void MemoryArenaTest::testPool()
+{
+    ts::MemoryPool pool(48, 16);
+    TSUNIT_ASSERT(pool.blockSize() >= 48);
+
+    // Allocate more blocks than one chunk holds.
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < 50; ++i) {
+        void* p = pool.allocate();
+        TSUNIT_ASSERT(p != nullptr);
+        ::memset(p, int(i), 48);
+        blocks.push_back(p);
+    }
+
+    // All blocks are distinct.
+    for (size_t i = 1; i < blocks.size(); ++i) {
+        TSUNIT_ASSERT(blocks[i] != blocks[i-1]);
+    }
+
+    // Released blocks are served again.
+    pool.release(blocks.back());
+    void* p = pool.allocate();
+    TSUNIT_ASSERT(p == blocks.back());
+
+    // Releasing a null pointer is ignored.
+    pool.release(nullptr);
+}
+
+// Test case: node-based standard containers over a pool.
+void MemoryArenaTest::testPoolAllocator()
+{
+    // Block size large enough for the list node of an int on common platforms.
+    ts::MemoryPool pool(64);
+    std::list<int, ts::PoolAllocator<int>> lst((ts::PoolAllocator<int>(pool)));
+    for (int i = 0; i < 1000; ++i) {
+        lst.push_back(i);
+    }
+    TSUNIT_EQUAL(size_t(1000), lst.size());
+    TSUNIT_EQUAL(0, lst.front());
+    TSUNIT_EQUAL(999, lst.back());
+    lst.clear();
+
+    // Oversized allocations fall back to the heap: a vector with the same
+    // allocator works even though its buffers exceed the block size.
+    std::vector<int, ts::PoolAllocator<int>> vec((ts::PoolAllocator<int>(pool)));
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(i);
+    }
+    TSUNIT_EQUAL(size_t(1000), vec.size());
+    TSUNIT_EQUAL(999, vec.back());
+}
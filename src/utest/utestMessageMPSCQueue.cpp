@@ -0,0 +1,213 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::MessageMPSCQueue
+//
+//----------------------------------------------------------------------------
+
+#include "tsMessageMPSCQueue.h"
+#include "tsSysUtils.h"
+#include "tsunit.h"
+#include "utestTSUnitThread.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class MessageMPSCQueueTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testConstructor();
+    void testSingleThread();
+    void testMultiProducers();
+
+    TSUNIT_TEST_BEGIN(MessageMPSCQueueTest);
+    TSUNIT_TEST(testConstructor);
+    TSUNIT_TEST(testSingleThread);
+    TSUNIT_TEST(testMultiProducers);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(MessageMPSCQueueTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void MessageMPSCQueueTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void MessageMPSCQueueTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+typedef ts::MessageMPSCQueue<int> TestQueue;
+
+// Test case: Constructor
+void MessageMPSCQueueTest::testConstructor()
+{
+    TestQueue queue1;
+    TestQueue queue2(10);
+
+    TSUNIT_ASSERT(queue1.getMaxMessages() == 0);
+    TSUNIT_ASSERT(queue2.getMaxMessages() == 10);
+
+    queue1.setMaxMessages(27);
+    TSUNIT_ASSERT(queue1.getMaxMessages() == 27);
+}
+
+// Test case: FIFO order, capacity and timeouts, without concurrency.
+void MessageMPSCQueueTest::testSingleThread()
+{
+    TestQueue queue(4);
+    TestQueue::MessagePtr msg;
+
+    // Empty queue, dequeue with zero timeout fails immediately.
+    TSUNIT_ASSERT(!queue.dequeue(msg, 0));
+    TSUNIT_ASSERT(queue.peek().isNull());
+
+    // Fill the queue.
+    TSUNIT_ASSERT(queue.enqueue(new int(1), 0));
+    TSUNIT_ASSERT(queue.enqueue(new int(2), 0));
+    TSUNIT_ASSERT(queue.enqueue(new int(3), 0));
+    TSUNIT_ASSERT(queue.enqueue(new int(4), 0));
+
+    // Queue full, enqueue with a short timeout fails.
+    TSUNIT_ASSERT(!queue.enqueue(new int(5), 20));
+
+    // But a forced enqueue always succeeds.
+    queue.forceEnqueue(new int(6));
+
+    // Messages come back in FIFO order.
+    msg = queue.peek();
+    TSUNIT_ASSERT(!msg.isNull());
+    TSUNIT_EQUAL(1, *msg);
+
+    for (int expected = 1; expected <= 4; expected++) {
+        TSUNIT_ASSERT(queue.dequeue(msg, 0));
+        TSUNIT_ASSERT(!msg.isNull());
+        TSUNIT_EQUAL(expected, *msg);
+    }
+    TSUNIT_ASSERT(queue.dequeue(msg, 0));
+    TSUNIT_ASSERT(!msg.isNull());
+    TSUNIT_EQUAL(6, *msg);
+
+    // Queue empty again.
+    TSUNIT_ASSERT(!queue.dequeue(msg, 0));
+
+    // Clear a non-empty queue.
+    TSUNIT_ASSERT(queue.enqueue(new int(7), 0));
+    TSUNIT_ASSERT(queue.enqueue(new int(8), 0));
+    queue.clear();
+    TSUNIT_ASSERT(!queue.dequeue(msg, 0));
+}
+
+// Producer thread for testMultiProducers(): enqueue a range of values.
+namespace {
+
+    constexpr size_t PRODUCERS_COUNT = 4;
+    constexpr int MESSAGES_PER_PRODUCER = 1000;
+
+    class MPSCProducerThread: public utest::TSUnitThread
+    {
+    private:
+        TestQueue& _queue;
+        const int  _first;
+    public:
+        MPSCProducerThread(TestQueue& queue, int first) :
+            utest::TSUnitThread(),
+            _queue(queue),
+            _first(first)
+        {
+        }
+
+        ~MPSCProducerThread()
+        {
+            waitForTermination();
+        }
+
+        virtual void test() override
+        {
+            for (int i = 0; i < MESSAGES_PER_PRODUCER; i++) {
+                TSUNIT_ASSERT(_queue.enqueue(new int(_first + i), 10000));
+            }
+        }
+    };
+}
+
+// Test case: several producers, one consumer, bounded queue.
+void MessageMPSCQueueTest::testMultiProducers()
+{
+    TestQueue queue(16);
+
+    // Start all producers. Each one enqueues values in its own range.
+    MPSCProducerThread* producers[PRODUCERS_COUNT];
+    for (size_t p = 0; p < PRODUCERS_COUNT; p++) {
+        producers[p] = new MPSCProducerThread(queue, int(p) * MESSAGES_PER_PRODUCER);
+        TSUNIT_ASSERT(producers[p]->start());
+    }
+
+    // Dequeue all messages. Per producer, values must arrive in order.
+    int next[PRODUCERS_COUNT];
+    for (size_t p = 0; p < PRODUCERS_COUNT; p++) {
+        next[p] = int(p) * MESSAGES_PER_PRODUCER;
+    }
+    for (size_t count = 0; count < PRODUCERS_COUNT * MESSAGES_PER_PRODUCER; count++) {
+        TestQueue::MessagePtr msg;
+        TSUNIT_ASSERT(queue.dequeue(msg, 10000));
+        TSUNIT_ASSERT(!msg.isNull());
+        const size_t p = size_t(*msg) / MESSAGES_PER_PRODUCER;
+        TSUNIT_ASSERT(p < PRODUCERS_COUNT);
+        TSUNIT_EQUAL(next[p], *msg);
+        next[p]++;
+    }
+
+    // The queue must be empty now.
+    TestQueue::MessagePtr msg;
+    TSUNIT_ASSERT(!queue.dequeue(msg, 0));
+
+    // Producer destructors wait for thread completion.
+    for (size_t p = 0; p < PRODUCERS_COUNT; p++) {
+        delete producers[p];
+    }
+}
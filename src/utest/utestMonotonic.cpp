@@ -53,11 +53,15 @@ public:
     void testArithmetic();
     void testSysWait();
     void testWait();
+    void testCoarseClock();
+    void testNanoClock();
 
     TSUNIT_TEST_BEGIN(MonotonicTest);
     TSUNIT_TEST(testArithmetic);
     TSUNIT_TEST(testSysWait);
     TSUNIT_TEST(testWait);
+    TSUNIT_TEST(testCoarseClock);
+    TSUNIT_TEST(testNanoClock);
     TSUNIT_TEST_END();
 private:
     ts::NanoSecond  _nsPrecision;
@@ -153,3 +157,29 @@ void MonotonicTest::testWait()
     TSUNIT_ASSERT(end >= start + 100 - _msPrecision);
     TSUNIT_ASSUME(end < start + 150);
 }
+
+void MonotonicTest::testCoarseClock()
+{
+    // The coarse clock shares the epoch of the standard clock. The
+    // difference between the two reads must stay within the coarse
+    // resolution (kernel tick), use a generous margin of one second.
+    ts::Monotonic fine(true);
+    ts::Monotonic coarse;
+    coarse.getSystemTimeCoarse();
+    const ts::NanoSecond diff = fine - coarse;
+    debug() << "MonotonicTest: fine - coarse = " << ts::UString::Decimal(diff) << " ns" << std::endl;
+    TSUNIT_ASSERT(diff < ts::NanoSecPerSec);
+    TSUNIT_ASSERT(diff > -ts::NanoSecPerSec);
+}
+
+void MonotonicTest::testNanoClock()
+{
+    // The nano clock must not go backward and must measure a sleep
+    // with a reasonable accuracy.
+    const ts::NanoSecond start = ts::Monotonic::NanoClock();
+    ts::SleepThread(100); // milliseconds
+    const ts::NanoSecond duration = ts::Monotonic::NanoClock() - start;
+    debug() << "MonotonicTest: NanoClock duration = " << ts::UString::Decimal(duration) << " ns" << std::endl;
+    TSUNIT_ASSERT(duration >= 100 * ts::NanoSecPerMilliSec - _nsPrecision);
+    TSUNIT_ASSERT(duration < 10 * ts::NanoSecPerSec);
+}
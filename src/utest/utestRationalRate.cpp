@@ -0,0 +1,161 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::RationalRate
+//
+//----------------------------------------------------------------------------
+
+#include "tsRationalRate.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class RationalRateTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testDefault();
+    void testInvalid();
+    void testPowerOfTwo();
+    void testExactness();
+    void testToInt();
+
+    TSUNIT_TEST_BEGIN(RationalRateTest);
+    TSUNIT_TEST(testDefault);
+    TSUNIT_TEST(testInvalid);
+    TSUNIT_TEST(testPowerOfTwo);
+    TSUNIT_TEST(testExactness);
+    TSUNIT_TEST(testToInt);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(RationalRateTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void RationalRateTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void RationalRateTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void RationalRateTest::testDefault()
+{
+    ts::RationalRate rate;
+    TSUNIT_EQUAL(0, rate.numerator());
+    TSUNIT_EQUAL(0, rate.denominator());
+    TSUNIT_EQUAL(0, rate.scale(0));
+    TSUNIT_EQUAL(0, rate.scale(12345));
+    TSUNIT_EQUAL(0, rate.toInt());
+}
+
+void RationalRateTest::testInvalid()
+{
+    ts::RationalRate rate(100, 0);
+    TSUNIT_EQUAL(0, rate.scale(50));
+
+    rate.set(-1, 10);
+    TSUNIT_EQUAL(0, rate.scale(50));
+
+    rate.set(100, -3);
+    TSUNIT_EQUAL(0, rate.scale(50));
+
+    // And back to a valid rate.
+    rate.set(100, 3);
+    TSUNIT_EQUAL(100, rate.numerator());
+    TSUNIT_EQUAL(3, rate.denominator());
+    TSUNIT_EQUAL(1666, rate.scale(50));
+
+    rate.clear();
+    TSUNIT_EQUAL(0, rate.scale(50));
+}
+
+void RationalRateTest::testPowerOfTwo()
+{
+    ts::RationalRate rate(7, 1);
+    TSUNIT_EQUAL(7000, rate.scale(1000));
+
+    rate.set(7, 8);
+    TSUNIT_EQUAL(875, rate.scale(1000));
+    TSUNIT_EQUAL(0, rate.scale(1));
+
+    rate.set(1, TS_CONST64(1) << 62);
+    TSUNIT_EQUAL(0, rate.scale(1000));
+    rate.set(TS_CONST64(1) << 62, TS_CONST64(1) << 62);
+    TSUNIT_EQUAL(1, rate.scale(1));
+}
+
+void RationalRateTest::testExactness()
+{
+    // Check that scale() is exactly identical to the integer division on
+    // a sample of typical and pathological fractions.
+    static const int64_t nums[] = {0, 1, 3, 188, 1504000, 38014705, TS_CONST64(1504000000000)};
+    static const int64_t dens[] = {1, 2, 3, 7, 1000, 1021, 1504000, 38014705, TS_CONST64(1504000000000), (TS_CONST64(1) << 62) - 1};
+    static const int64_t counts[] = {0, 1, 2, 999, 123456789, TS_CONST64(4611686018427387903)};
+
+    ts::RationalRate rate;
+    for (size_t n = 0; n < sizeof(nums) / sizeof(nums[0]); ++n) {
+        for (size_t d = 0; d < sizeof(dens) / sizeof(dens[0]); ++d) {
+            rate.set(nums[n], dens[d]);
+            for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+                // Skip combinations where count * num overflows an int64_t.
+                if (nums[n] == 0 || counts[c] <= std::numeric_limits<int64_t>::max() / nums[n]) {
+                    TSUNIT_EQUAL((counts[c] * nums[n]) / dens[d], rate.scale(counts[c]));
+                }
+            }
+        }
+    }
+}
+
+void RationalRateTest::testToInt()
+{
+    ts::RationalRate rate(38014705, 7);
+    TSUNIT_EQUAL(5430672, rate.toInt());
+
+    rate.set(10, 3);
+    TSUNIT_EQUAL(3, rate.toInt());
+}
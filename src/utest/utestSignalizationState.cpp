@@ -0,0 +1,229 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::SignalizationState
+//
+//----------------------------------------------------------------------------
+
+#include "tsSignalizationState.h"
+#include "tsCASMapper.h"
+#include "tsCADescriptor.h"
+#include "tsCyclingPacketizer.h"
+#include "tsDuckContext.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class SignalizationStateTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testSnapshot();
+    void testSubscribers();
+    void testCASMapper();
+
+    TSUNIT_TEST_BEGIN(SignalizationStateTest);
+    TSUNIT_TEST(testSnapshot);
+    TSUNIT_TEST(testSubscribers);
+    TSUNIT_TEST(testCASMapper);
+    TSUNIT_TEST_END();
+
+private:
+    // Feed a state with a PSI: one PAT (one service), its PMT and a CAT.
+    static void feedPSI(ts::DuckContext& duck, ts::SignalizationState& state);
+};
+
+TSUNIT_REGISTER(SignalizationStateTest);
+
+#define SERVICE_ID   0x0012
+#define PMT_PID      ts::PID(0x0100)
+#define PCR_PID      ts::PID(0x0101)
+#define ECM_PID      ts::PID(0x0200)
+#define EMM_PID      ts::PID(0x0300)
+#define CAS_ID       uint16_t(0x4ADC)
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void SignalizationStateTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void SignalizationStateTest::afterTest()
+{
+}
+
+// Build the PSI and feed the state with the corresponding packets.
+void SignalizationStateTest::feedPSI(ts::DuckContext& duck, ts::SignalizationState& state)
+{
+    ts::PAT pat(1, true, 0x1234);
+    pat.pmts[SERVICE_ID] = PMT_PID;
+
+    ts::PMT pmt(1, true, SERVICE_ID, PCR_PID);
+    pmt.descs.add(duck, ts::CADescriptor(CAS_ID, ECM_PID));
+
+    ts::CAT cat;
+    cat.descs.add(duck, ts::CADescriptor(CAS_ID, EMM_PID));
+
+    // Feed the PAT first so that the PMT PID filter is in place, then
+    // cycle all three tables a few times.
+    ts::TSPacket pkt;
+    ts::CyclingPacketizer pat_pzer(ts::PID_PAT, ts::CyclingPacketizer::ALWAYS);
+    pat_pzer.addTable(duck, pat);
+    pat_pzer.getNextPacket(pkt);
+    state.feedPacket(pkt);
+
+    ts::CyclingPacketizer pmt_pzer(PMT_PID, ts::CyclingPacketizer::ALWAYS);
+    pmt_pzer.addTable(duck, pmt);
+    ts::CyclingPacketizer cat_pzer(ts::PID_CAT, ts::CyclingPacketizer::ALWAYS);
+    cat_pzer.addTable(duck, cat);
+    for (size_t i = 0; i < 8; ++i) {
+        pmt_pzer.getNextPacket(pkt);
+        state.feedPacket(pkt);
+        cat_pzer.getNextPacket(pkt);
+        state.feedPacket(pkt);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void SignalizationStateTest::testSnapshot()
+{
+    ts::DuckContext duck;
+    ts::SignalizationState state(duck);
+
+    TSUNIT_ASSERT(!state.hasPAT());
+    TSUNIT_ASSERT(!state.hasCAT());
+    TSUNIT_ASSERT(!state.hasSDT());
+    const uint64_t gen0 = state.generation();
+
+    feedPSI(duck, state);
+
+    TSUNIT_ASSERT(state.hasPAT());
+    TSUNIT_ASSERT(state.hasCAT());
+    TSUNIT_ASSERT(state.generation() > gen0);
+    TSUNIT_EQUAL(0x1234, state.lastPAT().ts_id);
+    TSUNIT_EQUAL(1, state.lastPAT().pmts.size());
+
+    ts::PMT pmt;
+    TSUNIT_ASSERT(state.getPMT(SERVICE_ID, pmt));
+    TSUNIT_EQUAL(SERVICE_ID, pmt.service_id);
+    TSUNIT_EQUAL(PCR_PID, pmt.pcr_pid);
+    TSUNIT_ASSERT(!state.getPMT(SERVICE_ID + 1, pmt));
+
+    std::set<uint16_t> service_ids;
+    state.getServiceIds(service_ids);
+    TSUNIT_EQUAL(1, service_ids.size());
+    TSUNIT_ASSERT(service_ids.find(SERVICE_ID) != service_ids.end());
+
+    // Feeding the same tables again does not change the snapshot generation
+    // (the demux reports a table once per version).
+    const uint64_t gen1 = state.generation();
+    feedPSI(duck, state);
+    TSUNIT_EQUAL(gen1, state.generation());
+
+    // A reset clears the snapshot.
+    state.reset();
+    TSUNIT_ASSERT(!state.hasPAT());
+    TSUNIT_ASSERT(!state.hasCAT());
+}
+
+void SignalizationStateTest::testSubscribers()
+{
+    // A subscriber which counts tables.
+    class Counter: public ts::SignalizationHandlerInterface
+    {
+    public:
+        size_t pat_count = 0;
+        size_t cat_count = 0;
+        size_t pmt_count = 0;
+        virtual void handlePAT(const ts::PAT&, ts::PID) override { pat_count++; }
+        virtual void handleCAT(const ts::CAT&, ts::PID) override { cat_count++; }
+        virtual void handlePMT(const ts::PMT&, ts::PID) override { pmt_count++; }
+    };
+
+    ts::DuckContext duck;
+    ts::SignalizationState state(duck);
+    Counter sub1;
+    Counter sub2;
+    state.subscribe(&sub1);
+    state.subscribe(&sub2);
+    state.subscribe(&sub1); // duplicate, ignored
+
+    feedPSI(duck, state);
+
+    TSUNIT_EQUAL(1, sub1.pat_count);
+    TSUNIT_EQUAL(1, sub1.cat_count);
+    TSUNIT_EQUAL(1, sub1.pmt_count);
+    TSUNIT_EQUAL(1, sub2.pat_count);
+    TSUNIT_EQUAL(1, sub2.cat_count);
+    TSUNIT_EQUAL(1, sub2.pmt_count);
+
+    // An unsubscribed handler is no longer notified.
+    state.unsubscribe(&sub2);
+    state.reset();
+    feedPSI(duck, state);
+    TSUNIT_EQUAL(2, sub1.pat_count);
+    TSUNIT_EQUAL(1, sub2.pat_count);
+}
+
+void SignalizationStateTest::testCASMapper()
+{
+    ts::DuckContext duck;
+    ts::SignalizationState state(duck);
+
+    // One mapper attached before the tables, one attached after.
+    ts::CASMapper before(duck, state);
+    feedPSI(duck, state);
+    ts::CASMapper after(duck, state);
+
+    TSUNIT_ASSERT(before.isECM(ECM_PID));
+    TSUNIT_ASSERT(before.isEMM(EMM_PID));
+    TSUNIT_EQUAL(CAS_ID, before.casId(ECM_PID));
+    TSUNIT_EQUAL(CAS_ID, before.casId(EMM_PID));
+    TSUNIT_ASSERT(!before.knownPID(PCR_PID));
+
+    // The late mapper got the tables from the snapshot.
+    TSUNIT_ASSERT(after.isECM(ECM_PID));
+    TSUNIT_ASSERT(after.isEMM(EMM_PID));
+    TSUNIT_EQUAL(CAS_ID, after.casId(ECM_PID));
+}
@@ -55,6 +55,7 @@ public:
     void testSetPayloadSize();
     void testFlags();
     void testPrivateData();
+    void testParseHeader();
 
     TSUNIT_TEST_BEGIN(TSPacketTest);
     TSUNIT_TEST(testPacket);
@@ -64,7 +65,12 @@ public:
     TSUNIT_TEST(testSetPayloadSize);
     TSUNIT_TEST(testFlags);
     TSUNIT_TEST(testPrivateData);
+    TSUNIT_TEST(testParseHeader);
     TSUNIT_TEST_END();
+
+private:
+    // Check that parseHeader() agrees with the individual accessors.
+    void checkParseHeader(const ts::TSPacket& pkt);
 };
 
 TSUNIT_REGISTER(TSPacketTest);
@@ -495,3 +501,58 @@ void TSPacketTest::testPrivateData()
     pkt.getPrivateData(data);
     TSUNIT_ASSERT(data.empty());
 }
+
+void TSPacketTest::checkParseHeader(const ts::TSPacket& pkt)
+{
+    ts::TSPacket::Header h;
+    pkt.parseHeader(h);
+    TSUNIT_EQUAL(pkt.getPID(), h.pid);
+    TSUNIT_EQUAL(pkt.getCC(), h.cc);
+    TSUNIT_EQUAL(pkt.getHeaderSize(), size_t(h.header_size));
+    TSUNIT_EQUAL(pkt.getPayloadSize(), size_t(h.payload_size));
+    TSUNIT_EQUAL(pkt.hasPayload(), h.payload);
+    TSUNIT_EQUAL(pkt.getPUSI(), h.pusi);
+    TSUNIT_EQUAL(pkt.isScrambled(), h.scrambled);
+    TSUNIT_EQUAL(pkt.getPCR(), h.pcr);
+    TSUNIT_EQUAL(pkt.hasPCR(), (h.af_flags & 0x10) != 0);
+    TSUNIT_EQUAL(pkt.getDiscontinuityIndicator(), (h.af_flags & 0x80) != 0);
+    TSUNIT_EQUAL(pkt.getAFSize() > 1 ? pkt.b[5] : 0, h.af_flags);
+}
+
+void TSPacketTest::testParseHeader()
+{
+    // Packet without adaptation field.
+    ts::TSPacket pkt;
+    pkt.init(0x1ABC, 7, 0x35);
+    checkParseHeader(pkt);
+
+    // With PUSI and scrambling control.
+    pkt.setPUSI();
+    pkt.setScrambling(ts::SC_EVEN_KEY);
+    checkParseHeader(pkt);
+
+    // Adaptation field without PCR.
+    TSUNIT_ASSERT(pkt.setDiscontinuityIndicator(true));
+    TSUNIT_ASSERT(pkt.hasAF());
+    checkParseHeader(pkt);
+
+    // Adaptation field with a PCR.
+    TSUNIT_ASSERT(pkt.setPCR(TS_UCONST64(0x000000126789ABCD), true));
+    TSUNIT_ASSERT(pkt.hasPCR());
+    checkParseHeader(pkt);
+
+    // Adaptation field filling the packet, no payload.
+    TSUNIT_ASSERT(pkt.setPayloadSize(0, true));
+    TSUNIT_EQUAL(0, pkt.getPayloadSize());
+    checkParseHeader(pkt);
+
+    // Payload flag set but adaptation field extending over the whole packet.
+    pkt.init(0x100);
+    pkt.b[3] |= 0x20;  // AF present
+    pkt.b[4] = 0xFF;   // invalid AF size, larger than the packet
+    pkt.b[5] = 0x10;   // PCR flag, but no room for a PCR
+    checkParseHeader(pkt);
+
+    // The null packet.
+    checkParseHeader(ts::NullPacket);
+}
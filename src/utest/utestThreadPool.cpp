@@ -0,0 +1,162 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::ThreadPool
+//
+//----------------------------------------------------------------------------
+
+#include "tsThreadPool.h"
+#include "tsGuard.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class ThreadPoolTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testDefaultThreadCount();
+    void testEnqueue();
+    void testParallelFor();
+
+    TSUNIT_TEST_BEGIN(ThreadPoolTest);
+    TSUNIT_TEST(testDefaultThreadCount);
+    TSUNIT_TEST(testEnqueue);
+    TSUNIT_TEST(testParallelFor);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(ThreadPoolTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void ThreadPoolTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void ThreadPoolTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+// Test case: default thread count.
+void ThreadPoolTest::testDefaultThreadCount()
+{
+    const size_t count = ts::ThreadPool::DefaultThreadCount();
+    debug() << "ThreadPoolTest: default thread count = " << count << std::endl;
+    TSUNIT_ASSERT(count >= 1);
+    TSUNIT_ASSERT(ts::ThreadPool::Instance()->threadCount() >= 1);
+}
+
+// A simple task for testEnqueue(): signal its completion.
+namespace {
+    class SignalTask: public ts::ThreadPoolTaskInterface
+    {
+        TS_NOBUILD_NOCOPY(SignalTask);
+    private:
+        ts::Mutex&     _mutex;
+        ts::Condition& _condition;
+        bool&          _done;
+    public:
+        SignalTask(ts::Mutex& mutex, ts::Condition& condition, bool& done) :
+            _mutex(mutex),
+            _condition(condition),
+            _done(done)
+        {
+        }
+        virtual void run() override
+        {
+            ts::Guard lock(_mutex);
+            _done = true;
+            _condition.signal();
+        }
+    };
+}
+
+// Test case: asynchronous execution of one task.
+void ThreadPoolTest::testEnqueue()
+{
+    ts::Mutex mutex;
+    ts::Condition condition;
+    bool done = false;
+    SignalTask task(mutex, condition, done);
+
+    TSUNIT_ASSERT(ts::ThreadPool::Instance()->enqueue(&task));
+
+    // Wait for the task to execute, at most 10 seconds.
+    ts::GuardCondition lock(mutex, condition);
+    while (!done) {
+        TSUNIT_ASSERT(lock.waitCondition(10000));
+    }
+    TSUNIT_ASSERT(done);
+}
+
+// Test case: parallel loop over a large range.
+void ThreadPoolTest::testParallelFor()
+{
+    constexpr size_t SIZE = 100000;
+    std::vector<uint32_t> values(SIZE, 0);
+
+    // Fill in parallel, each index exactly once.
+    ts::ThreadPool::Instance()->parallelFor(0, SIZE, 0, [&values](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            values[i] += uint32_t(i);
+        }
+    });
+
+    // Each element must have been processed exactly once.
+    for (size_t i = 0; i < SIZE; ++i) {
+        TSUNIT_EQUAL(uint32_t(i), values[i]);
+    }
+
+    // An empty range does nothing and an explicit chunk size works too.
+    ts::ThreadPool::Instance()->parallelFor(10, 10, 0, [](size_t, size_t) {
+        TSUNIT_FAIL("body invoked on empty range");
+    });
+    std::atomic<size_t> total(0);
+    ts::ThreadPool::Instance()->parallelFor(0, 1000, 64, [&total](size_t begin, size_t end) {
+        total += end - begin;
+    });
+    TSUNIT_EQUAL(size_t(1000), size_t(total));
+}
@@ -59,6 +59,7 @@ public:
     void testUnixTime();
     void testDaylightSavingTime();
     void testCAS();
+    void testCurrentUTCCoarse();
 
     TSUNIT_TEST_BEGIN(TimeTest);
     TSUNIT_TEST(testTime);
@@ -73,6 +74,7 @@ public:
     TSUNIT_TEST(testUnixTime);
     TSUNIT_TEST(testDaylightSavingTime);
     TSUNIT_TEST(testCAS);
+    TSUNIT_TEST(testCurrentUTCCoarse);
     TSUNIT_TEST_END();
 };
 
@@ -433,3 +435,15 @@ void TimeTest::testCAS()
     md.invalidate();
     TSUNIT_ASSERT(!md.isValid());
 }
+
+void TimeTest::testCurrentUTCCoarse()
+{
+    // The coarse time must stay close to the precise time,
+    // within the kernel tick resolution, use a one second margin.
+    const ts::Time fine(ts::Time::CurrentUTC());
+    const ts::Time coarse(ts::Time::CurrentUTCCoarse());
+    const ts::MilliSecond diff = fine - coarse;
+    debug() << "TimeTest: CurrentUTC - CurrentUTCCoarse = " << diff << " ms" << std::endl;
+    TSUNIT_ASSERT(diff < ts::MilliSecPerSec);
+    TSUNIT_ASSERT(diff > -ts::MilliSecPerSec);
+}
@@ -0,0 +1,122 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2020, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for tsVersionInfo.h and lazy library initialization.
+//
+//----------------------------------------------------------------------------
+
+#include "tsVersionInfo.h"
+#include "tsDuckExtensionRepository.h"
+#include "tsTime.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class VersionInfoTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testVersionFormats();
+    void testCompareVersions();
+    void testStartupBudget();
+
+    TSUNIT_TEST_BEGIN(VersionInfoTest);
+    TSUNIT_TEST(testVersionFormats);
+    TSUNIT_TEST(testCompareVersions);
+    TSUNIT_TEST(testStartupBudget);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(VersionInfoTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void VersionInfoTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void VersionInfoTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void VersionInfoTest::testVersionFormats()
+{
+    TSUNIT_ASSERT(!ts::GetVersion(ts::VERSION_SHORT).empty());
+    TSUNIT_ASSERT(ts::GetVersion(ts::VERSION_LONG).contain(u"TSDuck"));
+    TSUNIT_ASSERT(ts::GetVersion(ts::VERSION_SHORT) != ts::GetVersion(ts::VERSION_LONG));
+
+    int64_t version = 0;
+    TSUNIT_ASSERT(ts::GetVersion(ts::VERSION_INTEGER).toInteger(version, u","));
+    TSUNIT_ASSERT(version > 0);
+}
+
+void VersionInfoTest::testCompareVersions()
+{
+    TSUNIT_EQUAL(0,  ts::CompareVersions(u"3.20-1520", u"3.20-1520"));
+    TSUNIT_EQUAL(-1, ts::CompareVersions(u"3.20-1520", u"3.20-1521"));
+    TSUNIT_EQUAL(1,  ts::CompareVersions(u"3.21-1520", u"3.20-1620"));
+    TSUNIT_EQUAL(-1, ts::CompareVersions(u"3.20", u"3.20-1520"));
+}
+
+void VersionInfoTest::testStartupBudget()
+{
+    // The extension repository is no longer initialized before main(). The first
+    // call to Instance() performs the directory scan and loads the extension
+    // shared libraries. TSDuck tools are often executed in large batches of very
+    // short runs, so this initialization must remain within a sane time budget.
+    // The budget is deliberately loose to accommodate slow or loaded test machines.
+    const ts::Time start(ts::Time::CurrentUTC());
+    TSUNIT_ASSERT(ts::DuckExtensionRepository::Instance() != nullptr);
+    const ts::MilliSecond elapsed = ts::Time::CurrentUTC() - start;
+
+    debug() << "VersionInfoTest: extension repository initialization: " << elapsed << " ms" << std::endl;
+    TSUNIT_ASSERT(elapsed < 2000);
+
+    // Subsequent calls must be essentially free (no rescan).
+    const ts::Time start2(ts::Time::CurrentUTC());
+    TSUNIT_ASSERT(ts::DuckExtensionRepository::Instance() != nullptr);
+    const ts::MilliSecond elapsed2 = ts::Time::CurrentUTC() - start2;
+    TSUNIT_ASSERT(elapsed2 < 1000);
+}